@@ -0,0 +1,541 @@
+// Keyframe reduction & quantized animation curves
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <string.h>
+
+#include "AnimationCompression.h"
+
+using namespace	FBXImporter;
+
+namespace
+{
+	const int	MAX_FRAMES_COUNT = 65536;
+	const int	SUBFRAMES_COUNT = 4;		// The fit is also checked at 3 points within each frame so the error bound holds between the samples
+	const float	FRAME_SNAP = 0.01f;			// Times within a hundredth of a frame of a key are considered on the key (so steps happen exactly on their key)
+
+	inline float	Abs( float _Value )		{ return _Value < 0.0f ? -_Value : _Value; }
+
+	inline unsigned short	QuantizeUnsigned( float _Value, float _Min, float _InvScale )
+	{
+		float	Q = (_Value - _Min) * _InvScale + 0.5f;
+		return	(unsigned short) (Q < 0.0f ? 0.0f : (Q > 65535.0f ? 65535.0f : Q));
+	}
+
+	inline short			QuantizeSigned( float _Value, float _InvScale )
+	{
+		float	Q = _Value * _InvScale;
+		Q = Q < -32767.0f ? -32767.0f : (Q > 32767.0f ? 32767.0f : Q);
+		return	(short) (Q < 0.0f ? Q - 0.5f : Q + 0.5f);
+	}
+
+	// Evaluates a Hermite segment from its extremities' values and slopes expressed in normalized time
+	inline float	Hermite( float _V0, float _M0, float _V1, float _M1, float u )
+	{
+		float	A = 2.0f * _V0 - 2.0f * _V1 + _M0 + _M1;
+		float	B = -3.0f * _V0 + 3.0f * _V1 - 2.0f * _M0 - _M1;
+		return	((A * u + B) * u + _M0) * u + _V0;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// QuantizedAnimationCurve
+//
+QuantizedAnimationCurve::QuantizedAnimationCurve( const AnimationCurveKey* _pKeys, int _KeysCount, float _StartTime, float _FrameDuration ) : m_KeysCount( _KeysCount ), m_StartTime( _StartTime ), m_FrameDuration( _FrameDuration )
+{
+	// Compute value & slope ranges
+	float	Min = _pKeys[0].Value, Max = Min, MaxSlope = 0.0f;
+	for ( int KeyIndex=0; KeyIndex < _KeysCount; KeyIndex++ )
+	{
+		const AnimationCurveKey&	K = _pKeys[KeyIndex];
+		Min = K.Value < Min ? K.Value : Min;
+		Max = K.Value > Max ? K.Value : Max;
+		MaxSlope = Abs( K.RightSlope ) > MaxSlope ? Abs( K.RightSlope ) : MaxSlope;
+		MaxSlope = Abs( K.NextLeftSlope ) > MaxSlope ? Abs( K.NextLeftSlope ) : MaxSlope;
+	}
+
+	m_ValueMin = Min;
+	m_ValueScale = (Max - Min) / 65535.0f;
+	m_SlopeScale = MaxSlope / 32767.0f;
+
+	float	InvValueScale = m_ValueScale > 0.0f ? 1.0f / m_ValueScale : 0.0f;
+	float	InvSlopeScale = m_SlopeScale > 0.0f ? 1.0f / m_SlopeScale : 0.0f;
+	float	InvFrameDuration = 1.0f / _FrameDuration;
+
+	m_pKeys = new QuantizedAnimationKey[_KeysCount];
+	for ( int KeyIndex=0; KeyIndex < _KeysCount; KeyIndex++ )
+	{
+		const AnimationCurveKey&	K = _pKeys[KeyIndex];
+		QuantizedAnimationKey&		Q = m_pKeys[KeyIndex];
+
+		int	Frame = (int) ((K.Time - _StartTime) * InvFrameDuration + 0.5f);
+		Q.Frame = (unsigned short) (Frame < 0 ? 0 : (Frame >= MAX_FRAMES_COUNT ? MAX_FRAMES_COUNT-1 : Frame));
+		Q.Value = QuantizeUnsigned( K.Value, Min, InvValueScale );
+		Q.RightSlope = QuantizeSigned( K.RightSlope, InvSlopeScale );
+		Q.LeftSlope = KeyIndex > 0 ? QuantizeSigned( _pKeys[KeyIndex-1].NextLeftSlope, InvSlopeScale ) : Q.RightSlope;
+		if ( K.Type == AnimationCurveKey::KEY_CONSTANT && KeyIndex < _KeysCount-1 )
+			Q.RightSlope = QuantizedAnimationKey::STEPPED_SLOPE;
+	}
+}
+
+QuantizedAnimationCurve::QuantizedAnimationCurve( const QuantizedAnimationCurve& _Source )
+{
+	m_KeysCount = _Source.m_KeysCount;
+	m_StartTime = _Source.m_StartTime;
+	m_FrameDuration = _Source.m_FrameDuration;
+	m_ValueMin = _Source.m_ValueMin;
+	m_ValueScale = _Source.m_ValueScale;
+	m_SlopeScale = _Source.m_SlopeScale;
+	m_pKeys = new QuantizedAnimationKey[m_KeysCount];
+	memcpy( m_pKeys, _Source.m_pKeys, m_KeysCount * sizeof(QuantizedAnimationKey) );
+}
+
+QuantizedAnimationCurve::~QuantizedAnimationCurve()
+{
+	delete[] m_pKeys;
+}
+
+int		QuantizedAnimationCurve::FindSegment( float _Frame, int _Cursor ) const
+{
+	int	SegmentsCount = m_KeysCount - 1;
+	if ( _Cursor < 0 || _Cursor >= SegmentsCount )
+		_Cursor = 0;
+
+	// Try a few segments around the cursor first
+	if ( _Frame >= m_pKeys[_Cursor].Frame )
+	{
+		for ( int Step=0; Step < 4 && _Cursor < SegmentsCount; Step++, _Cursor++ )
+			if ( _Frame < m_pKeys[_Cursor+1].Frame )
+				return	_Cursor;
+	}
+	else
+	{
+		for ( int Step=0; Step < 4 && _Cursor > 0; Step++ )
+			if ( _Frame >= m_pKeys[--_Cursor].Frame )
+				return	_Cursor;
+	}
+
+	// Fall back to a binary search
+	int	Min = 0, Max = SegmentsCount;
+	while ( Max - Min > 1 )
+	{
+		int	Mid = (Min + Max) >> 1;
+		if ( _Frame < m_pKeys[Mid].Frame )
+			Max = Mid;
+		else
+			Min = Mid;
+	}
+
+	return	Min;
+}
+
+float	QuantizedAnimationCurve::Evaluate( float _Time, int& _Cursor ) const
+{
+	if ( _Time <= m_StartTime )
+	{
+		_Cursor = 0;
+		return	GetKeyValue( 0 );
+	}
+
+	// Work in frames to compare against the integer frames directly
+	float	Frame = (_Time - m_StartTime) / m_FrameDuration + FRAME_SNAP;
+	if ( Frame >= m_pKeys[m_KeysCount-1].Frame )
+	{
+		_Cursor = m_KeysCount - 2;
+		return	GetKeyValue( m_KeysCount-1 );
+	}
+
+	int	Segment = _Cursor = FindSegment( Frame, _Cursor );
+
+	const QuantizedAnimationKey&	K0 = m_pKeys[Segment];
+	const QuantizedAnimationKey&	K1 = m_pKeys[Segment+1];
+	if ( K0.RightSlope == QuantizedAnimationKey::STEPPED_SLOPE )
+		return	GetKeyValue( Segment );
+
+	float	T0 = m_StartTime + K0.Frame * m_FrameDuration;
+	float	Duration = (K1.Frame - K0.Frame) * m_FrameDuration;
+	float	u = (_Time - T0) / Duration;
+			u = u > 0.0f ? u : 0.0f;
+	float	SlopeFactor = m_SlopeScale * Duration;
+
+	return	Hermite( m_ValueMin + K0.Value * m_ValueScale, K0.RightSlope * SlopeFactor, m_ValueMin + K1.Value * m_ValueScale, K1.LeftSlope * SlopeFactor, u );
+}
+
+void	QuantizedAnimationCurve::DecodeKeys( AnimationCurveKey* _pKeys ) const
+{
+	for ( int KeyIndex=0; KeyIndex < m_KeysCount; KeyIndex++ )
+	{
+		const QuantizedAnimationKey&	Q = m_pKeys[KeyIndex];
+		AnimationCurveKey&				K = _pKeys[KeyIndex];
+
+		memset( &K, 0, sizeof(AnimationCurveKey) );
+		K.Time = GetKeyTime( KeyIndex );
+		K.Value = GetKeyValue( KeyIndex );
+		if ( Q.RightSlope == QuantizedAnimationKey::STEPPED_SLOPE )
+		{
+			K.Type = AnimationCurveKey::KEY_CONSTANT;
+			continue;
+		}
+
+		K.Type = AnimationCurveKey::KEY_CUBIC;
+		K.CubicType = AnimationCurveKey::CUBIC_CUSTOM;
+		K.RightSlope = Q.RightSlope * m_SlopeScale;
+		K.NextLeftSlope = KeyIndex < m_KeysCount-1 ? m_pKeys[KeyIndex+1].LeftSlope * m_SlopeScale : K.RightSlope;
+		K.RightWeight = K.NextLeftWeight = 1.0f / 3.0f;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// AnimationCurveCompressor
+//
+AnimationCurveCompressor::AnimationCurveCompressor( float _SampleRate, float _Tolerance ) : m_SampleRate( _SampleRate ), m_Tolerance( _Tolerance )
+{
+	m_MaxSamplesCount = 0;
+	m_pSamples = NULL;
+	m_pSubSamples = NULL;
+	m_pDerivatives = NULL;
+	m_pLeftDerivatives = NULL;
+	m_pStepEnds = NULL;
+	m_pNextSteps = NULL;
+}
+
+AnimationCurveCompressor::~AnimationCurveCompressor()
+{
+	delete[] m_pSamples;
+	delete[] m_pSubSamples;
+	delete[] m_pDerivatives;
+	delete[] m_pLeftDerivatives;
+	delete[] m_pStepEnds;
+	delete[] m_pNextSteps;
+}
+
+void	AnimationCurveCompressor::AllocateSamples( int _SamplesCount )
+{
+	if ( _SamplesCount <= m_MaxSamplesCount )
+		return;
+
+	delete[] m_pSamples;
+	delete[] m_pSubSamples;
+	delete[] m_pDerivatives;
+	delete[] m_pLeftDerivatives;
+	delete[] m_pStepEnds;
+	delete[] m_pNextSteps;
+	m_MaxSamplesCount = _SamplesCount;
+	m_pSamples = new float[_SamplesCount];
+	m_pSubSamples = new float[_SamplesCount * (SUBFRAMES_COUNT-1)];
+	m_pDerivatives = new float[_SamplesCount];
+	m_pLeftDerivatives = new float[_SamplesCount];
+	m_pStepEnds = new int[_SamplesCount];
+	m_pNextSteps = new int[_SamplesCount];
+}
+
+bool	AnimationCurveCompressor::SampleKeys( const AnimationCurve& _Source, int _FramesCount, float _FrameDuration )
+{
+	for ( int FrameIndex=0; FrameIndex <= _FramesCount; FrameIndex++ )
+	{
+		m_pLeftDerivatives[FrameIndex] = m_pDerivatives[FrameIndex];
+		m_pStepEnds[FrameIndex] = -1;
+	}
+
+	const float*	pTimes = _Source.GetTimes();
+	float			StartTime = _Source.GetStartTime();
+	int				SegmentsCount = _Source.GetKeysCount() - 1;
+	int				PreviousFrame = -1;
+	for ( int KeyIndex=0; KeyIndex <= SegmentsCount; KeyIndex++ )
+	{
+		float	KeyFrame = (pTimes[KeyIndex] - StartTime) / _FrameDuration;
+		int		Frame = (int) floor( KeyFrame + 0.5f );
+		bool	bOnFrame = Abs( KeyFrame - Frame ) <= FRAME_SNAP;
+		bool	bStepped = KeyIndex < SegmentsCount && _Source.IsSegmentStepped( KeyIndex );
+		if ( bStepped && !bOnFrame )
+			return	false;	// Both keys of a stepped segment must lie on frames for the step to happen exactly on its key
+		if ( KeyIndex > 0 && _Source.IsSegmentStepped( KeyIndex-1 ) && (!bOnFrame || Frame <= PreviousFrame) )
+			return	false;
+
+		PreviousFrame = Frame;
+		if ( !bOnFrame )
+			continue;
+
+		// The time of the frame may round to either side of the key, and the derivatives may differ on both sides of the key,
+		//	so the keys lying on frames are sampled exactly
+		m_pSamples[Frame] = _Source.GetKeyValue( KeyIndex );
+		if ( KeyIndex > 0 )
+			m_pLeftDerivatives[Frame] = _Source.GetSegmentDerivative( KeyIndex-1, true );
+		if ( KeyIndex < SegmentsCount )
+			m_pDerivatives[Frame] = _Source.GetSegmentDerivative( KeyIndex, false );
+		if ( bStepped )
+			m_pStepEnds[Frame] = (int) floor( (pTimes[KeyIndex+1] - StartTime) / _FrameDuration + 0.5f );
+	}
+
+	int	NextStep = _FramesCount;
+	for ( int FrameIndex=_FramesCount; FrameIndex >= 0; FrameIndex-- )
+	{
+		m_pNextSteps[FrameIndex] = NextStep;
+		if ( m_pStepEnds[FrameIndex] != -1 )
+			NextStep = FrameIndex;
+	}
+
+	return	true;
+}
+
+void	AnimationCurveCompressor::Compress( const AnimationCurve& _Source, AnimationCompressionResult& _Result )
+{
+	_Result.pCurve = NULL;
+	_Result.ConstantValue = _Source.GetKeysCount() > 0 ? _Source.Evaluate( _Source.GetStartTime() ) : _Source.GetDefaultValue();
+	_Result.SourceKeysCount = _Source.GetKeysCount();
+	_Result.SamplesCount = 0;
+	_Result.MaxError = 0.0f;
+	_Result.RMSError = 0.0f;
+	_Result.bRejected = false;
+
+	float	StartTime = _Source.GetStartTime();
+	float	Duration = _Source.GetEndTime() - StartTime;
+	if ( _Source.GetKeysCount() < 2 || Duration <= 0.0f )
+		return;	// Constant
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Resample the curve so that the first and last samples fall on the extremities
+	int		FramesCount = (int) ceil( Duration * m_SampleRate - 1e-3f );
+	FramesCount = FramesCount < 1 ? 1 : FramesCount;
+	if ( FramesCount >= MAX_FRAMES_COUNT )
+	{	// Frames are stored on 16 bits and resampling the take more coarsely would break the tolerance between samples
+		_Result.bRejected = true;
+		return;
+	}
+	int		SamplesCount = FramesCount + 1;
+	float	FrameDuration = Duration / FramesCount;
+
+	AllocateSamples( SamplesCount );
+	_Result.SamplesCount = SamplesCount;
+
+	float	Min = +1e30f, Max = -1e30f;
+	int		Cursor = 0, DerivativeCursor = 0;
+	for ( int SampleIndex=0; SampleIndex < SamplesCount; SampleIndex++ )
+	{
+		float	Time = SampleIndex < FramesCount ? StartTime + SampleIndex * FrameDuration : _Source.GetEndTime();
+		float	Value = m_pSamples[SampleIndex] = _Source.Evaluate( Time, Cursor );
+		m_pDerivatives[SampleIndex] = _Source.EvaluateDerivative( Time, DerivativeCursor );
+		Min = Value < Min ? Value : Min;
+		Max = Value > Max ? Value : Max;
+		if ( SampleIndex == FramesCount )
+			break;
+
+		// Also sample within the frame so the fit is checked between samples
+		float*	pSubSamples = m_pSubSamples + SampleIndex * (SUBFRAMES_COUNT-1);
+		for ( int SubFrameIndex=1; SubFrameIndex < SUBFRAMES_COUNT; SubFrameIndex++ )
+		{
+			Value = pSubSamples[SubFrameIndex-1] = _Source.Evaluate( Time + SubFrameIndex * FrameDuration / SUBFRAMES_COUNT, Cursor );
+			Min = Value < Min ? Value : Min;
+			Max = Value > Max ? Value : Max;
+		}
+	}
+
+	if ( !SampleKeys( _Source, FramesCount, FrameDuration ) )
+	{	// A step between 2 frames can't be stored exactly
+		_Result.bRejected = true;
+		return;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Check for constant curves
+	if ( Max - Min <= 2.0f * m_Tolerance )
+	{
+		_Result.ConstantValue = 0.5f * (Min + Max);
+		_Result.MaxError = 0.5f * (Max - Min);
+		_Result.RMSError = _Result.MaxError;
+		return;
+	}
+
+	// Keep some of the tolerance for the value quantization error
+	float	QuantizationError = 0.5f * (Max - Min) / 65535.0f;
+	float	FitTolerance = m_Tolerance - QuantizationError;
+	FitTolerance = FitTolerance > 0.5f * m_Tolerance ? FitTolerance : 0.5f * m_Tolerance;
+
+	// Slopes quantization may still push the error slightly over the tolerance, in which case we fit again more tightly
+	for ( int AttemptIndex=0; AttemptIndex < 4; AttemptIndex++, FitTolerance *= 0.75f )
+	{
+		delete _Result.pCurve;
+		_Result.pCurve = Fit( StartTime, FramesCount, FrameDuration, FitTolerance );
+		MeasureError( _Result );
+		if ( _Result.MaxError <= m_Tolerance )
+			return;
+	}
+
+	// Still over the tolerance: don't hand out a curve that breaks the error bound
+	delete _Result.pCurve;
+	_Result.pCurve = NULL;
+	_Result.bRejected = true;
+}
+
+QuantizedAnimationCurve*	AnimationCurveCompressor::Fit( float _StartTime, int _FramesCount, float _FrameDuration, float _Tolerance ) const
+{
+	AnimationCurveKey*	pKeys = new AnimationCurveKey[_FramesCount+1];
+	int					KeysCount = 0;
+
+	// Greedily extend each segment as far as a linear or cubic fit holds
+	int	Start = 0;
+	while ( Start < _FramesCount )
+	{
+		if ( m_pStepEnds[Start] != -1 )
+		{	// Stepped segments are kept as is
+			AnimationCurveKey&	K = pKeys[KeysCount++];
+			memset( &K, 0, sizeof(AnimationCurveKey) );
+			K.Type = AnimationCurveKey::KEY_CONSTANT;
+			K.Time = _StartTime + Start * _FrameDuration;
+			K.Value = m_pSamples[Start];
+
+			Start = m_pStepEnds[Start];
+			continue;
+		}
+
+		// Continuous segments can't extend past the start of the next stepped segment
+		int	Limit = m_pNextSteps[Start];
+
+		// Grow the segment exponentially
+		int	LastGood = Start + 1;
+		int	LastGoodType = FitSegment( Start, LastGood, _FrameDuration, _Tolerance );
+		int	FirstBad = -1;
+		if ( LastGoodType == FIT_NONE )
+		{	// Not even a single frame fits: keep the source derivatives and let MeasureError() report the error
+			LastGoodType = FIT_CUBIC;
+			FirstBad = LastGood;
+		}
+		for ( int Step=2; FirstBad == -1 && LastGood < Limit; Step <<= 1 )
+		{
+			int	End = Start + Step < Limit ? Start + Step : Limit;
+			int	Type = FitSegment( Start, End, _FrameDuration, _Tolerance );
+			if ( Type == FIT_NONE )
+			{
+				FirstBad = End;
+				break;
+			}
+			LastGood = End;
+			LastGoodType = Type;
+		}
+
+		// Refine the end of the segment with a binary search
+		while ( FirstBad != -1 && FirstBad - LastGood > 1 )
+		{
+			int	Mid = (LastGood + FirstBad) >> 1;
+			int	Type = FitSegment( Start, Mid, _FrameDuration, _Tolerance );
+			if ( Type == FIT_NONE )
+				FirstBad = Mid;
+			else
+			{
+				LastGood = Mid;
+				LastGoodType = Type;
+			}
+		}
+
+		// Emit the key starting the segment
+		float	SegmentDuration = (LastGood - Start) * _FrameDuration;
+		AnimationCurveKey&	K = pKeys[KeysCount++];
+		memset( &K, 0, sizeof(AnimationCurveKey) );
+		K.Time = _StartTime + Start * _FrameDuration;
+		K.Value = m_pSamples[Start];
+		K.RightWeight = K.NextLeftWeight = 1.0f / 3.0f;
+		if ( LastGoodType == FIT_LINEAR )
+		{
+			K.Type = AnimationCurveKey::KEY_LINEAR;
+			K.RightSlope = K.NextLeftSlope = (m_pSamples[LastGood] - m_pSamples[Start]) / SegmentDuration;
+		}
+		else
+		{
+			K.Type = AnimationCurveKey::KEY_CUBIC;
+			K.CubicType = AnimationCurveKey::CUBIC_CUSTOM;
+			K.RightSlope = m_pDerivatives[Start];
+			K.NextLeftSlope = m_pLeftDerivatives[LastGood];
+		}
+
+		Start = LastGood;
+	}
+
+	// Last key
+	AnimationCurveKey&	LastKey = pKeys[KeysCount++];
+	memset( &LastKey, 0, sizeof(AnimationCurveKey) );
+	LastKey.Type = AnimationCurveKey::KEY_CONSTANT;
+	LastKey.Time = _StartTime + _FramesCount * _FrameDuration;
+	LastKey.Value = m_pSamples[_FramesCount];
+	LastKey.RightSlope = LastKey.NextLeftSlope = pKeys[KeysCount-2].NextLeftSlope;
+
+	QuantizedAnimationCurve*	pResult = new QuantizedAnimationCurve( pKeys, KeysCount, _StartTime, _FrameDuration );
+	delete[] pKeys;
+
+	return	pResult;
+}
+
+void	AnimationCurveCompressor::MeasureError( AnimationCompressionResult& _Result ) const
+{
+	const QuantizedAnimationCurve*	pCurve = _Result.pCurve;
+	float	FrameDuration = (pCurve->GetEndTime() - pCurve->GetStartTime()) / (_Result.SamplesCount - 1);
+
+	double	SumSqError = 0.0;
+	int		ErrorsCount = 0;
+	int		Cursor = 0;
+	_Result.MaxError = 0.0f;
+	for ( int SampleIndex=0; SampleIndex < _Result.SamplesCount; SampleIndex++ )
+	{
+		float	Time = pCurve->GetStartTime() + SampleIndex * FrameDuration;
+		float	Error = Abs( pCurve->Evaluate( Time, Cursor ) - m_pSamples[SampleIndex] );
+		_Result.MaxError = Error > _Result.MaxError ? Error : _Result.MaxError;
+		SumSqError += Error * Error;
+		ErrorsCount++;
+		if ( SampleIndex == _Result.SamplesCount-1 )
+			break;
+
+		if ( m_pStepEnds[SampleIndex] != -1 )
+		{	// Stepped segments are only compared at their keys
+			SampleIndex = m_pStepEnds[SampleIndex] - 1;
+			continue;
+		}
+
+		const float*	pSubSamples = m_pSubSamples + SampleIndex * (SUBFRAMES_COUNT-1);
+		for ( int SubFrameIndex=1; SubFrameIndex < SUBFRAMES_COUNT; SubFrameIndex++ )
+		{
+			Error = Abs( pCurve->Evaluate( Time + SubFrameIndex * FrameDuration / SUBFRAMES_COUNT, Cursor ) - pSubSamples[SubFrameIndex-1] );
+			_Result.MaxError = Error > _Result.MaxError ? Error : _Result.MaxError;
+			SumSqError += Error * Error;
+			ErrorsCount++;
+		}
+	}
+	_Result.RMSError = (float) sqrt( SumSqError / ErrorsCount );
+}
+
+int		AnimationCurveCompressor::FitSegment( int _Start, int _End, float _FrameDuration, float _Tolerance ) const
+{
+	float	V0 = m_pSamples[_Start];
+	float	V1 = m_pSamples[_End];
+
+	// Try a cubic segment with the source derivatives first as it follows smooth curves between the samples
+	float	Duration = (_End - _Start) * _FrameDuration;
+	if ( CheckSegment( _Start, _End, V0, m_pDerivatives[_Start] * Duration, V1, m_pLeftDerivatives[_End] * Duration, _Tolerance ) )
+		return	FIT_CUBIC;
+
+	// Fall back to a linear segment (i.e. a Hermite segment whose slopes are both the chord), for kinks the derivatives don't represent
+	if ( CheckSegment( _Start, _End, V0, V1 - V0, V1, V1 - V0, _Tolerance ) )
+		return	FIT_LINEAR;
+
+	return	FIT_NONE;
+}
+
+bool	AnimationCurveCompressor::CheckSegment( int _Start, int _End, float _V0, float _M0, float _V1, float _M1, float _Tolerance ) const
+{
+	float	InvCount = 1.0f / (_End - _Start);
+	float	SubFrameStep = InvCount / SUBFRAMES_COUNT;
+	for ( int FrameIndex=_Start; FrameIndex < _End; FrameIndex++ )
+	{
+		float	u = (FrameIndex - _Start) * InvCount;
+		if ( FrameIndex > _Start && Abs( Hermite( _V0, _M0, _V1, _M1, u ) - m_pSamples[FrameIndex] ) > _Tolerance )
+			return	false;
+
+		const float*	pSubSamples = m_pSubSamples + FrameIndex * (SUBFRAMES_COUNT-1);
+		for ( int SubFrameIndex=1; SubFrameIndex < SUBFRAMES_COUNT; SubFrameIndex++ )
+			if ( Abs( Hermite( _V0, _M0, _V1, _M1, u + SubFrameIndex * SubFrameStep ) - pSubSamples[SubFrameIndex-1] ) > _Tolerance )
+				return	false;
+	}
+
+	return	true;
+}
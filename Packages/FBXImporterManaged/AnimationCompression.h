@@ -0,0 +1,159 @@
+// Contains the keyframe reduction and the quantized storage of animation curves
+//
+#pragma once
+
+#include "AnimationCurves.h"
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A quantized key (8 bytes)
+	// Slopes are stored for both sides of the key so linear and cubic segments are both evaluated as Hermite segments.
+	// A stepped segment, holding the value of its first key, is marked by a right slope of STEPPED_SLOPE (never produced by the quantization).
+	//
+	struct	QuantizedAnimationKey
+	{
+		unsigned short	Frame;			// Frame index from the start of the curve
+		unsigned short	Value;			// Value in [Min,Max]
+		short			LeftSlope;		// Incoming slope in [-MaxSlope,+MaxSlope]
+		short			RightSlope;		// Outgoing slope in [-MaxSlope,+MaxSlope]
+
+		static const short	STEPPED_SLOPE = -32768;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A quantized animation curve
+	// Times are stored as 16-bit frame indices, values and slopes as 16-bit integers within the range of the curve.
+	// Keys are interleaved so that evaluating a segment only touches 2 consecutive keys.
+	//
+	class	QuantizedAnimationCurve
+	{
+	protected:	// FIELDS
+
+		int						m_KeysCount;
+		float					m_StartTime;
+		float					m_FrameDuration;
+		float					m_ValueMin;
+		float					m_ValueScale;		// Range / 65535
+		float					m_SlopeScale;		// MaxSlope / 32767
+		QuantizedAnimationKey*	m_pKeys;
+
+	public:		// PROPERTIES
+
+		int		GetKeysCount() const		{ return m_KeysCount; }
+		float	GetStartTime() const		{ return m_StartTime; }
+		float	GetEndTime() const			{ return GetKeyTime( m_KeysCount-1 ); }
+		int		GetMemorySize() const		{ return sizeof(QuantizedAnimationCurve) + m_KeysCount * sizeof(QuantizedAnimationKey); }
+
+		float	GetKeyTime( int _KeyIndex ) const	{ return m_StartTime + m_pKeys[_KeyIndex].Frame * m_FrameDuration; }
+		float	GetKeyValue( int _KeyIndex ) const	{ return m_ValueMin + m_pKeys[_KeyIndex].Value * m_ValueScale; }
+
+	public:		// METHODS
+
+		// Quantizes a set of CONSTANT (i.e. stepped), LINEAR or CUSTOM CUBIC keys whose times lie on frames of the given duration (at least 2 keys)
+		QuantizedAnimationCurve( const AnimationCurveKey* _pKeys, int _KeysCount, float _StartTime, float _FrameDuration );
+		QuantizedAnimationCurve( const QuantizedAnimationCurve& _Source );
+		~QuantizedAnimationCurve();
+
+		// Evaluates the curve at the given time (the cursor caches the last evaluated segment, as for AnimationCurve)
+		float	Evaluate( float _Time, int& _Cursor ) const;
+
+		// Decodes the keys as CUSTOM CUBIC keys, or CONSTANT keys for stepped segments (the array must contain KeysCount keys)
+		void	DecodeKeys( AnimationCurveKey* _pKeys ) const;
+
+		// Adds a value to all the keys
+		void	Offset( float _Value )		{ m_ValueMin += _Value; }
+
+		// Scales all the keys and slopes
+		void	Scale( float _Factor )		{ m_ValueMin *= _Factor; m_ValueScale *= _Factor; m_SlopeScale *= _Factor; }
+
+	protected:
+
+		int		FindSegment( float _Frame, int _Cursor ) const;
+
+	private:
+		QuantizedAnimationCurve&	operator=( const QuantizedAnimationCurve& );
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// The result of the compression of a single curve
+	//
+	struct	AnimationCompressionResult
+	{
+		QuantizedAnimationCurve*	pCurve;			// The compressed curve (NULL if the curve is constant)
+		float						ConstantValue;	// The value of a constant curve
+		int							SourceKeysCount;
+		int							SamplesCount;
+		float						MaxError;		// The maximum absolute error measured on the samples & sub-frame samples, after quantization
+		float						RMSError;		// The root mean square error measured on the samples & sub-frame samples, after quantization
+		bool						bRejected;		// The curve couldn't be compressed within the tolerance (pCurve is NULL) and the source keys must be kept
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Error-bounded keyframe reduction
+	// The source curve is resampled at a fixed rate then fitted with the least keys we can find so that every sample,
+	//	as well as a few points within every frame, is reproduced within the tolerance. Each segment is tried as a cubic Hermite
+	//	segment using the source derivatives at its extremities first, then as a linear segment, and is extended as far as the fit holds.
+	// Stepped segments of the source (i.e. holding a value then jumping to the next key) are kept as stepped keys and are only compared
+	//	at their keys, as they can't be fitted by continuous segments. The segments in between are fitted separately.
+	// Curves whose samples all lie within the tolerance of a single value are reported as constant.
+	// Curves longer than 65535 frames, with stepped keys off the frames, or whose fit still breaks the tolerance after quantization, are rejected.
+	//
+	class	AnimationCurveCompressor
+	{
+	protected:	// FIELDS
+
+		float	m_SampleRate;
+		float	m_Tolerance;
+
+		// Working buffers
+		int		m_MaxSamplesCount;
+		float*	m_pSamples;
+		float*	m_pSubSamples;		// The values at regular points within each frame (excluding the frame itself)
+		float*	m_pDerivatives;		// The derivatives at the samples (on the right side of the keys lying on frames)
+		float*	m_pLeftDerivatives;	// The derivatives at the samples on the left side of the keys lying on frames
+		int*	m_pStepEnds;		// For each frame, the frame ending the stepped segment starting on that frame (or -1)
+		int*	m_pNextSteps;		// For each frame, the first frame after it starting a stepped segment (or the frames count)
+
+	public:		// METHODS
+
+		AnimationCurveCompressor( float _SampleRate, float _Tolerance );
+		~AnimationCurveCompressor();
+
+		void	SetTolerance( float _Tolerance )	{ m_Tolerance = _Tolerance; }
+
+		// Compresses the curve (the caller owns the returned quantized curve)
+		void	Compress( const AnimationCurve& _Source, AnimationCompressionResult& _Result );
+
+	protected:
+
+		enum	FIT_TYPE
+		{
+			FIT_NONE = -1,
+			FIT_LINEAR,
+			FIT_CUBIC,
+		};
+
+		// Fits the samples with the least keys within the tolerance and quantizes the result
+		QuantizedAnimationCurve*	Fit( float _StartTime, int _FramesCount, float _FrameDuration, float _Tolerance ) const;
+
+		// Measures the error of the quantized curve against the samples
+		void	MeasureError( AnimationCompressionResult& _Result ) const;
+
+		// Finds a segment type reproducing samples [_Start,_End] and the sub-frame samples in between within the tolerance
+		int		FitSegment( int _Start, int _End, float _FrameDuration, float _Tolerance ) const;
+
+		// Checks a Hermite segment (slopes in normalized time) against samples ]_Start,_End[ and the sub-frame samples in between
+		bool	CheckSegment( int _Start, int _End, float _V0, float _M0, float _V1, float _M1, float _Tolerance ) const;
+
+		void	AllocateSamples( int _SamplesCount );
+
+		// Samples the source keys lying on frames exactly and finds the stepped segments
+		// Returns false if a key of a stepped segment doesn't lie on a frame (or shares its frame with another key)
+		bool	SampleKeys( const AnimationCurve& _Source, int _FramesCount, float _FrameDuration );
+
+	private:
+		AnimationCurveCompressor( const AnimationCurveCompressor& );
+		AnimationCurveCompressor&	operator=( const AnimationCurveCompressor& );
+	};
+}
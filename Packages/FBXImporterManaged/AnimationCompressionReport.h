@@ -0,0 +1,121 @@
+// Contains the report of the animation compression stage
+//
+#pragma managed
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Reports the error and the compression ratio achieved for each compressed animation track
+	//
+	public ref class	AnimationCompressionReport
+	{
+	public:		// NESTED TYPES
+
+		[System::Diagnostics::DebuggerDisplayAttribute( "{NodeName}.{Channel} Keys={SourceKeysCount}->{KeysCount} MaxError={MaxError}" )]
+		ref class	TrackEntry
+		{
+		public:
+
+			String^		NodeName;
+			String^		Channel;			// "P.x", "R.y", "S.z", etc.
+			float		Tolerance;
+
+			int			SourceKeysCount;
+			int			KeysCount;			// 0 for constant tracks
+			int			SourceBytes;		// Estimated memory used by the source keys
+			int			Bytes;				// Memory used by the quantized keys
+			float		MaxError;			// Maximum absolute error, measured on the resampled track
+			float		RMSError;			// Root mean square error, measured on the resampled track
+			bool		Rejected;			// The compressed track would break the tolerance so the source keys were kept
+
+			property bool	IsConstant
+			{
+				bool	get()	{ return KeysCount == 0; }
+			}
+		};
+
+	protected:	// FIELDS
+
+		List<TrackEntry^>^	m_Entries;
+
+	public:		// PROPERTIES
+
+		property cli::array<TrackEntry^>^	Entries
+		{
+			cli::array<TrackEntry^>^	get()	{ return m_Entries->ToArray(); }
+		}
+
+		property int		SourceKeysCount
+		{
+			int		get()	{ int Result = 0; for each ( TrackEntry^ E in m_Entries ) Result += E->SourceKeysCount; return Result; }
+		}
+
+		property int		KeysCount
+		{
+			int		get()	{ int Result = 0; for each ( TrackEntry^ E in m_Entries ) Result += E->KeysCount; return Result; }
+		}
+
+		property int		ConstantTracksCount
+		{
+			int		get()	{ int Result = 0; for each ( TrackEntry^ E in m_Entries ) Result += E->IsConstant ? 1 : 0; return Result; }
+		}
+
+		// Gets the amount of tracks whose source keys were kept because compressing them would break the tolerance
+		property int		RejectedTracksCount
+		{
+			int		get()	{ int Result = 0; for each ( TrackEntry^ E in m_Entries ) Result += E->Rejected ? 1 : 0; return Result; }
+		}
+
+		property int		SourceBytes
+		{
+			int		get()	{ int Result = 0; for each ( TrackEntry^ E in m_Entries ) Result += E->SourceBytes; return Result; }
+		}
+
+		property int		Bytes
+		{
+			int		get()	{ int Result = 0; for each ( TrackEntry^ E in m_Entries ) Result += E->Bytes; return Result; }
+		}
+
+		// Gets the ratio of the source memory over the compressed memory
+		property float		CompressionRatio
+		{
+			float	get()	{ return Bytes > 0 ? (float) SourceBytes / Bytes : 0.0f; }
+		}
+
+		// Gets the maximum error relative to each track's tolerance (<= 1 when all the tracks are within tolerance)
+		property float		MaxRelativeError
+		{
+			float	get()	{ float Result = 0.0f; for each ( TrackEntry^ E in m_Entries ) Result = Math::Max( Result, E->Tolerance > 0.0f ? E->MaxError / E->Tolerance : 0.0f ); return Result; }
+		}
+
+	public:		// METHODS
+
+		AnimationCompressionReport()
+		{
+			m_Entries = gcnew List<TrackEntry^>();
+		}
+
+		[System::ComponentModel::BrowsableAttribute( false )]
+		void	AddEntry( TrackEntry^ _Entry )
+		{
+			m_Entries->Add( _Entry );
+		}
+
+		virtual String^	ToString() override
+		{
+			System::Text::StringBuilder^	Result = gcnew System::Text::StringBuilder();
+			Result->AppendFormat( "{0} tracks ({1} constant, {2} rejected), {3} keys -> {4} keys, {5} bytes -> {6} bytes (ratio {7:G4}:1), max error {8:G4} x tolerance\n",
+				m_Entries->Count, ConstantTracksCount, RejectedTracksCount, SourceKeysCount, KeysCount, SourceBytes, Bytes, CompressionRatio, MaxRelativeError );
+
+			for each ( TrackEntry^ E in m_Entries )
+				Result->AppendFormat( "  {0}.{1}\tkeys {2} -> {3}\tbytes {4} -> {5}\tmax error {6:G4}\trms error {7:G4}\ttolerance {8:G4}{9}\n",
+					E->NodeName, E->Channel, E->SourceKeysCount, E->KeysCount, E->SourceBytes, E->Bytes, E->MaxError, E->RMSError, E->Tolerance, E->Rejected ? "\trejected" : "" );
+
+			return	Result->ToString();
+		}
+	};
+}
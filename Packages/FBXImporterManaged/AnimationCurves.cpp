@@ -0,0 +1,274 @@
+// Native animation curves
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include "AnimationCurves.h"
+
+using namespace	FBXImporter;
+
+//////////////////////////////////////////////////////////////////////////
+// AnimationCurve
+//
+AnimationCurve::AnimationCurve( const AnimationCurveKey* _pKeys, int _KeysCount, float _DefaultValue ) : m_KeysCount( _KeysCount ), m_DefaultValue( _DefaultValue )
+{
+	m_pTimes = NULL;
+	m_pInvDurations = m_pA = m_pB = m_pC = m_pD = NULL;
+	m_LastValue = _KeysCount > 0 ? _pKeys[_KeysCount-1].Value : _DefaultValue;
+	if ( _KeysCount == 0 )
+		return;
+
+	// Allocate all the arrays at once
+	int	SegmentsCount = _KeysCount - 1;
+	m_pTimes = new float[_KeysCount + 5 * SegmentsCount];
+	m_pInvDurations = m_pTimes + _KeysCount;
+	m_pA = m_pInvDurations + SegmentsCount;
+	m_pB = m_pA + SegmentsCount;
+	m_pC = m_pB + SegmentsCount;
+	m_pD = m_pC + SegmentsCount;
+
+	for ( int KeyIndex=0; KeyIndex < _KeysCount; KeyIndex++ )
+		m_pTimes[KeyIndex] = _pKeys[KeyIndex].Time;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Build the polynomial of each segment
+	for ( int SegmentIndex=0; SegmentIndex < SegmentsCount; SegmentIndex++ )
+	{
+		const AnimationCurveKey&	K0 = _pKeys[SegmentIndex];
+		const AnimationCurveKey&	K1 = _pKeys[SegmentIndex+1];
+
+		float	Duration = K1.Time - K0.Time;
+		m_pInvDurations[SegmentIndex] = Duration > 0.0f ? 1.0f / Duration : 0.0f;
+
+		float	V0 = K0.Value;
+		float	V1 = K1.Value;
+
+		switch ( K0.Type )
+		{
+		case AnimationCurveKey::KEY_CONSTANT:
+			m_pA[SegmentIndex] = m_pB[SegmentIndex] = m_pC[SegmentIndex] = 0.0f;
+			m_pD[SegmentIndex] = V0;
+			break;
+
+		case AnimationCurveKey::KEY_LINEAR:
+			m_pA[SegmentIndex] = m_pB[SegmentIndex] = 0.0f;
+			m_pC[SegmentIndex] = V1 - V0;
+			m_pD[SegmentIndex] = V0;
+			break;
+
+		default:
+			{	// Cubic Hermite segment with tangents expressed in normalized time
+				float	LeftSlope0, RightSlope0, LeftSlope1, RightSlope1;
+				ComputeSlopes( _pKeys, _KeysCount, SegmentIndex, LeftSlope0, RightSlope0 );
+				ComputeSlopes( _pKeys, _KeysCount, SegmentIndex+1, LeftSlope1, RightSlope1 );
+
+				if ( K0.CubicType == AnimationCurveKey::CUBIC_CUSTOM )
+					LeftSlope1 = K0.NextLeftSlope;	// The incoming slope of the next key is stored by the previous key
+
+				float	M0 = RightSlope0 * Duration;
+				float	M1 = LeftSlope1 * Duration;
+
+				m_pA[SegmentIndex] = 2.0f * V0 - 2.0f * V1 + M0 + M1;
+				m_pB[SegmentIndex] = -3.0f * V0 + 3.0f * V1 - 2.0f * M0 - M1;
+				m_pC[SegmentIndex] = M0;
+				m_pD[SegmentIndex] = V0;
+				break;
+			}
+		}
+	}
+}
+
+AnimationCurve::~AnimationCurve()
+{
+	delete[] m_pTimes;
+}
+
+void	AnimationCurve::ComputeSlopes( const AnimationCurveKey* _pKeys, int _KeysCount, int _KeyIndex, float& _LeftSlope, float& _RightSlope )
+{
+	const AnimationCurveKey&	K = _pKeys[_KeyIndex];
+
+	// Slopes of the segments surrounding the key (one-sided at the extremities)
+	float	PrevSlope = 0.0f, NextSlope = 0.0f;
+	bool	bHasPrev = _KeyIndex > 0 && K.Time > _pKeys[_KeyIndex-1].Time;
+	bool	bHasNext = _KeyIndex < _KeysCount-1 && _pKeys[_KeyIndex+1].Time > K.Time;
+	if ( bHasPrev )
+		PrevSlope = (K.Value - _pKeys[_KeyIndex-1].Value) / (K.Time - _pKeys[_KeyIndex-1].Time);
+	if ( bHasNext )
+		NextSlope = (_pKeys[_KeyIndex+1].Value - K.Value) / (_pKeys[_KeyIndex+1].Time - K.Time);
+	if ( !bHasPrev )
+		PrevSlope = NextSlope;
+	if ( !bHasNext )
+		NextSlope = PrevSlope;
+
+	switch ( K.Type == AnimationCurveKey::KEY_CUBIC ? K.CubicType : AnimationCurveKey::CUBIC_CARDINAL )
+	{
+	case AnimationCurveKey::CUBIC_CUSTOM:
+		{	// The incoming slope is stored by the previous key, when it has custom slopes too
+			const AnimationCurveKey*	pPrev = _KeyIndex > 0 ? &_pKeys[_KeyIndex-1] : NULL;
+			bool	bPrevIsCustom = pPrev != NULL && pPrev->Type == AnimationCurveKey::KEY_CUBIC && pPrev->CubicType == AnimationCurveKey::CUBIC_CUSTOM;
+			_LeftSlope = bPrevIsCustom ? pPrev->NextLeftSlope : K.RightSlope;
+		}
+		_RightSlope = K.RightSlope;
+		break;
+
+	case AnimationCurveKey::CUBIC_TCB:
+		{	// Kochanek-Bartels tangents, expressed with the slopes of the surrounding segments
+			float	T = K.Tension, C = K.Continuity, B = K.Bias;
+			_RightSlope = 0.5f * (1.0f - T) * ((1.0f + C) * (1.0f + B) * PrevSlope + (1.0f - C) * (1.0f - B) * NextSlope);
+			_LeftSlope = 0.5f * (1.0f - T) * ((1.0f - C) * (1.0f + B) * PrevSlope + (1.0f + C) * (1.0f - B) * NextSlope);
+			break;
+		}
+
+	default:
+		// Cardinal (Catmull-Rom like) spline
+		_LeftSlope = _RightSlope = 0.5f * (PrevSlope + NextSlope);
+		break;
+	}
+}
+
+int		AnimationCurve::FindSegment( float _Time, int _Cursor ) const
+{
+	int	SegmentsCount = m_KeysCount - 1;
+	if ( _Cursor < 0 || _Cursor >= SegmentsCount )
+		_Cursor = 0;
+
+	// Try a few segments around the cursor (coherent playback usually stays in the same segment or moves to the next one)
+	if ( _Time >= m_pTimes[_Cursor] )
+	{
+		for ( int Step=0; Step < 4 && _Cursor < SegmentsCount; Step++, _Cursor++ )
+			if ( _Time < m_pTimes[_Cursor+1] )
+				return	_Cursor;
+	}
+	else
+	{
+		for ( int Step=0; Step < 4 && _Cursor > 0; Step++ )
+			if ( _Time >= m_pTimes[--_Cursor] )
+				return	_Cursor;
+	}
+
+	// Fall back to a binary search
+	int	Min = 0, Max = SegmentsCount;	// Segment is in [Min,Max[
+	while ( Max - Min > 1 )
+	{
+		int	Mid = (Min + Max) >> 1;
+		if ( _Time < m_pTimes[Mid] )
+			Max = Mid;
+		else
+			Min = Mid;
+	}
+
+	return	Min;
+}
+
+float	AnimationCurve::Evaluate( float _Time, int& _Cursor ) const
+{
+	if ( m_KeysCount == 0 )
+		return	m_DefaultValue;
+	if ( _Time <= m_pTimes[0] )
+	{
+		_Cursor = 0;
+		return	m_KeysCount > 1 ? m_pD[0] : m_LastValue;
+	}
+	if ( _Time >= m_pTimes[m_KeysCount-1] )
+	{
+		_Cursor = m_KeysCount > 1 ? m_KeysCount - 2 : 0;
+		return	m_LastValue;
+	}
+
+	int		Segment = _Cursor = FindSegment( _Time, _Cursor );
+	float	u = (_Time - m_pTimes[Segment]) * m_pInvDurations[Segment];
+
+	return	((m_pA[Segment] * u + m_pB[Segment]) * u + m_pC[Segment]) * u + m_pD[Segment];
+}
+
+float	AnimationCurve::EvaluateDerivative( float _Time, int& _Cursor ) const
+{
+	if ( m_KeysCount < 2 || _Time < m_pTimes[0] || _Time > m_pTimes[m_KeysCount-1] )
+		return	0.0f;
+
+	int		Segment = _Cursor = FindSegment( _Time < m_pTimes[m_KeysCount-1] ? _Time : m_pTimes[m_KeysCount-2], _Cursor );
+	float	u = (_Time - m_pTimes[Segment]) * m_pInvDurations[Segment];
+
+	return	((3.0f * m_pA[Segment] * u + 2.0f * m_pB[Segment]) * u + m_pC[Segment]) * m_pInvDurations[Segment];
+}
+
+float	AnimationCurve::GetSegmentDerivative( int _SegmentIndex, bool _bEnd ) const
+{
+	float	u = _bEnd ? 1.0f : 0.0f;
+	return	((3.0f * m_pA[_SegmentIndex] * u + 2.0f * m_pB[_SegmentIndex]) * u + m_pC[_SegmentIndex]) * m_pInvDurations[_SegmentIndex];
+}
+
+bool	AnimationCurve::IsSegmentStepped( int _SegmentIndex ) const
+{
+	if ( m_pA[_SegmentIndex] != 0.0f || m_pB[_SegmentIndex] != 0.0f || m_pC[_SegmentIndex] != 0.0f )
+		return	false;	// Not constant
+
+	return	GetKeyValue( _SegmentIndex+1 ) != m_pD[_SegmentIndex];	// A constant segment without a jump is simply flat
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// AnimationCurveSet
+//
+AnimationCurveSet::AnimationCurveSet( int _MaxCurvesCount ) : m_CurvesCount( 0 ), m_MaxCurvesCount( _MaxCurvesCount )
+{
+	m_ppCurves = new AnimationCurve*[_MaxCurvesCount];
+	m_pDefaultValues = new float[_MaxCurvesCount];
+	m_pCursors = new int[_MaxCurvesCount];
+}
+
+AnimationCurveSet::~AnimationCurveSet()
+{
+	for ( int CurveIndex=0; CurveIndex < m_CurvesCount; CurveIndex++ )
+		delete m_ppCurves[CurveIndex];
+
+	delete[] m_ppCurves;
+	delete[] m_pDefaultValues;
+	delete[] m_pCursors;
+}
+
+int		AnimationCurveSet::AddCurve( AnimationCurve* _pCurve, float _DefaultValue )
+{
+	if ( m_CurvesCount >= m_MaxCurvesCount )
+	{	// Grow the arrays
+		int					NewMaxCount = 2 * m_MaxCurvesCount + 9;
+		AnimationCurve**	ppCurves = new AnimationCurve*[NewMaxCount];
+		float*				pDefaultValues = new float[NewMaxCount];
+		int*				pCursors = new int[NewMaxCount];
+		for ( int CurveIndex=0; CurveIndex < m_CurvesCount; CurveIndex++ )
+		{
+			ppCurves[CurveIndex] = m_ppCurves[CurveIndex];
+			pDefaultValues[CurveIndex] = m_pDefaultValues[CurveIndex];
+			pCursors[CurveIndex] = m_pCursors[CurveIndex];
+		}
+		delete[] m_ppCurves;
+		delete[] m_pDefaultValues;
+		delete[] m_pCursors;
+		m_ppCurves = ppCurves;
+		m_pDefaultValues = pDefaultValues;
+		m_pCursors = pCursors;
+		m_MaxCurvesCount = NewMaxCount;
+	}
+
+	m_ppCurves[m_CurvesCount] = _pCurve;
+	m_pDefaultValues[m_CurvesCount] = _DefaultValue;
+	m_pCursors[m_CurvesCount] = 0;
+
+	return	m_CurvesCount++;
+}
+
+void	AnimationCurveSet::Evaluate( float _Time, float* _pResults )
+{
+	for ( int CurveIndex=0; CurveIndex < m_CurvesCount; CurveIndex++ )
+	{
+		const AnimationCurve*	pCurve = m_ppCurves[CurveIndex];
+		_pResults[CurveIndex] = pCurve != NULL ? pCurve->Evaluate( _Time, m_pCursors[CurveIndex] ) : m_pDefaultValues[CurveIndex];
+	}
+}
+
+void	AnimationCurveSet::ResetCursors()
+{
+	for ( int CurveIndex=0; CurveIndex < m_CurvesCount; CurveIndex++ )
+		m_pCursors[CurveIndex] = 0;
+}
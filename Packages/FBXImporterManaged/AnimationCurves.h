@@ -0,0 +1,151 @@
+// Contains the native animation curves used to evaluate animation tracks without the FBX SDK
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Native description of an animation key, as extracted from the FBX curves
+	// (mirrors the managed AnimationTrack::AnimationKey)
+	//
+	struct	AnimationCurveKey
+	{
+		enum	KEY_TYPE
+		{
+			KEY_CONSTANT,
+			KEY_LINEAR,
+			KEY_CUBIC,
+		};
+
+		enum	CUBIC_TYPE
+		{
+			CUBIC_CARDINAL,
+			CUBIC_TCB,
+			CUBIC_CUSTOM,
+		};
+
+		int		Type;
+		float	Time;
+		float	Value;
+
+		int		CubicType;
+
+		// CUSTOM cubic interpolation
+		float	RightSlope;
+		float	NextLeftSlope;
+		float	RightWeight;
+		float	NextLeftWeight;
+
+		// TCB cubic interpolation
+		float	Tension;
+		float	Continuity;
+		float	Bias;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A native animation curve
+	// Every segment between 2 keys is converted into a cubic polynomial of the normalized time u in [0,1] :
+	//	Value(u) = ((A*u + B)*u + C)*u + D
+	//
+	// Constant, linear and cubic (cardinal, TCB & custom slopes) segments are all evaluated the same way.
+	// Keys are stored as separate arrays (SoA) so that searching for a segment only touches the times.
+	//
+	// NOTE: Tangent weights are not supported, custom slopes are evaluated as if weights were the default 1/3.
+	//
+	class	AnimationCurve
+	{
+	protected:	// FIELDS
+
+		int		m_KeysCount;
+		float	m_DefaultValue;		// Value returned when there are no keys
+
+		float*	m_pTimes;			// KeysCount key times
+		float*	m_pInvDurations;	// KeysCount-1 segment 1/duration
+		float*	m_pA;				// KeysCount-1 segment polynomial coefficients
+		float*	m_pB;
+		float*	m_pC;
+		float*	m_pD;
+		float	m_LastValue;		// Value of the last key
+
+	public:		// PROPERTIES
+
+		int				GetKeysCount() const		{ return m_KeysCount; }
+		float			GetDefaultValue() const		{ return m_DefaultValue; }
+		const float*	GetTimes() const			{ return m_pTimes; }
+		float			GetStartTime() const		{ return m_KeysCount > 0 ? m_pTimes[0] : 0.0f; }
+		float			GetEndTime() const			{ return m_KeysCount > 0 ? m_pTimes[m_KeysCount-1] : 0.0f; }
+		float			GetKeyValue( int _KeyIndex ) const	{ return _KeyIndex < m_KeysCount-1 ? m_pD[_KeyIndex] : m_LastValue; }
+
+	public:		// METHODS
+
+		AnimationCurve( const AnimationCurveKey* _pKeys, int _KeysCount, float _DefaultValue );
+		~AnimationCurve();
+
+		// Evaluates the curve at the given time
+		// The cursor is the index of the last evaluated segment and is updated by the call.
+		// For coherent playback, the segment is found in constant time instead of a binary search.
+		float	Evaluate( float _Time, int& _Cursor ) const;
+
+		// Evaluates the curve at the given time without any cursor
+		float	Evaluate( float _Time ) const	{ int Cursor = 0; return Evaluate( _Time, Cursor ); }
+
+		// Evaluates the derivative of the curve (in value per second) at the given time
+		float	EvaluateDerivative( float _Time, int& _Cursor ) const;
+
+		// Gets the derivative of a segment (in value per second) at its start or at its end
+		float	GetSegmentDerivative( int _SegmentIndex, bool _bEnd ) const;
+
+		// Tells if the segment holds the value of its first key then jumps to the value of the next key (i.e. a stepped segment)
+		bool	IsSegmentStepped( int _SegmentIndex ) const;
+
+	protected:
+
+		// Finds the segment containing the given time (time must be within the curve's time range)
+		int		FindSegment( float _Time, int _Cursor ) const;
+
+		// Computes the incoming & outgoing slopes (in value per second) of a key
+		static void	ComputeSlopes( const AnimationCurveKey* _pKeys, int _KeysCount, int _KeyIndex, float& _LeftSlope, float& _RightSlope );
+
+	private:
+		AnimationCurve( const AnimationCurve& );
+		AnimationCurve&	operator=( const AnimationCurve& );
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A set of curves evaluated all at once, each with its own cursor
+	// This is typically used to evaluate the 9 P, R and S tracks of all the animated nodes of a scene in a single call.
+	//
+	class	AnimationCurveSet
+	{
+	protected:	// FIELDS
+
+		int					m_CurvesCount;
+		int					m_MaxCurvesCount;
+		AnimationCurve**	m_ppCurves;			// Curves are owned by the set (NULL curves evaluate to their default value)
+		float*				m_pDefaultValues;
+		int*				m_pCursors;
+
+	public:		// PROPERTIES
+
+		int						GetCurvesCount() const				{ return m_CurvesCount; }
+		const AnimationCurve*	GetCurve( int _CurveIndex ) const	{ return m_ppCurves[_CurveIndex]; }
+
+	public:		// METHODS
+
+		AnimationCurveSet( int _MaxCurvesCount );
+		~AnimationCurveSet();
+
+		// Adds a curve to the set (the set takes ownership of the curve, which may be NULL for a constant value)
+		int		AddCurve( AnimationCurve* _pCurve, float _DefaultValue );
+
+		// Evaluates all the curves at the given time and writes one value per curve in the results array
+		void	Evaluate( float _Time, float* _pResults );
+
+		// Resets all the cursors (e.g. when jumping to a distant time)
+		void	ResetCursors();
+
+	private:
+		AnimationCurveSet( const AnimationCurveSet& );
+		AnimationCurveSet&	operator=( const AnimationCurveSet& );
+	};
+}
@@ -0,0 +1,77 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "AnimationEvaluator.h"
+#include "AnimationTrack.h"
+#include "Scene.h"
+
+using namespace	FBXImporter;
+
+AnimationEvaluator::AnimationEvaluator( Scene^ _Scene )
+{
+	Build( _Scene->Nodes );
+}
+
+AnimationEvaluator::AnimationEvaluator( cli::array<Node^>^ _Nodes )
+{
+	Build( _Nodes );
+}
+
+AnimationEvaluator::~AnimationEvaluator()
+{
+	this->!AnimationEvaluator();
+}
+
+AnimationEvaluator::!AnimationEvaluator()
+{
+	delete m_pCurves;
+	m_pCurves = NULL;
+}
+
+void	AnimationEvaluator::Build( cli::array<Node^>^ _Nodes )
+{
+	m_Nodes = gcnew List<Node^>();
+	for ( int NodeIndex=0; NodeIndex < _Nodes->Length; NodeIndex++ )
+		if ( _Nodes[NodeIndex]->IsPRSAnimated )
+			m_Nodes->Add( _Nodes[NodeIndex] );
+
+	m_pCurves = new AnimationCurveSet( VALUES_PER_NODE * m_Nodes->Count );
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		Node^	N = m_Nodes[NodeIndex];
+		AddTracks( N->AnimationTracksPosition, 0.0f );
+		AddTracks( N->AnimationTracksRotation, 0.0f );
+		AddTracks( N->AnimationTracksScale, 1.0f );
+	}
+}
+
+void	AnimationEvaluator::AddTracks( cli::array<AnimationTrack^>^ _Tracks, float _DefaultValue )
+{
+	for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+	{
+		AnimationCurve*	pCurve = _Tracks != nullptr ? _Tracks[ComponentIndex]->CreateNativeCurve() : NULL;
+		m_pCurves->AddCurve( pCurve, _DefaultValue );
+	}
+}
+
+void	AnimationEvaluator::Evaluate( float _Time, cli::array<float>^ _Results )
+{
+	if ( _Results == nullptr || _Results->Length < ValuesCount )
+		throw gcnew Exception( "Results array must contain at least " + ValuesCount + " values !" );
+	if ( ValuesCount == 0 )
+		return;
+
+	pin_ptr<float>	pResults = &_Results[0];
+	m_pCurves->Evaluate( _Time, pResults );
+}
+
+void	AnimationEvaluator::Evaluate( float _Time, float* _pResults )
+{
+	m_pCurves->Evaluate( _Time, _pResults );
+}
+
+void	AnimationEvaluator::ResetCursors()
+{
+	m_pCurves->ResetCursors();
+}
@@ -0,0 +1,75 @@
+// Contains the batched animation evaluator
+//
+#pragma managed
+#pragma once
+
+#include "Helpers.h"
+#include "AnimationCurves.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+
+namespace FBXImporter
+{
+	ref class	Scene;
+	ref class	Node;
+	ref class	AnimationTrack;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Evaluates the P, R & S animation tracks of all the animated nodes of a scene in a single call
+	// Evaluation only relies on the native curves built from the animation keys, the FBX scene is not needed anymore.
+	// Each track keeps its own cursor so coherent playback never needs to search for the current key.
+	//
+	// Results are written as 9 floats per node, in the order of the Nodes array :
+	//	Px, Py, Pz, Rx, Ry, Rz, Sx, Sy, Sz
+	// Missing tracks evaluate to 0 for position & rotation and to 1 for scale.
+	//
+	public ref class	AnimationEvaluator
+	{
+	public:		// CONSTANTS
+
+		literal int		VALUES_PER_NODE = 9;
+
+	protected:	// FIELDS
+
+		List<Node^>^		m_Nodes;
+		AnimationCurveSet*	m_pCurves;
+
+	public:		// PROPERTIES
+
+		// Gets the animated nodes, in the order their values are written to the results
+		property cli::array<Node^>^	Nodes
+		{
+			cli::array<Node^>^	get()	{ return m_Nodes->ToArray(); }
+		}
+
+		// Gets the amount of floats written by Evaluate()
+		property int				ValuesCount
+		{
+			int					get()	{ return VALUES_PER_NODE * m_Nodes->Count; }
+		}
+
+	public:		// METHODS
+
+		AnimationEvaluator( Scene^ _Scene );
+		AnimationEvaluator( cli::array<Node^>^ _Nodes );
+		~AnimationEvaluator();
+		!AnimationEvaluator();
+
+		// Evaluates all the tracks at the given time (the results array must contain at least ValuesCount floats)
+		void	Evaluate( float _Time, cli::array<float>^ _Results );
+
+		// Evaluates all the tracks at the given time into a native array of at least ValuesCount floats
+		[System::ComponentModel::BrowsableAttribute( false )]
+		void	Evaluate( float _Time, float* _pResults );
+
+		// Resets the tracks' cursors (useful when jumping to a distant time, though not mandatory)
+		void	ResetCursors();
+
+	protected:
+
+		void	Build( cli::array<Node^>^ _Nodes );
+		void	AddTracks( cli::array<AnimationTrack^>^ _Tracks, float _DefaultValue );
+	};
+}
@@ -9,7 +9,7 @@
 using namespace	FBXImporter;
 
 AnimationTrack::AnimationTrack( AnimationTrack^ _ParentTrack, ObjectProperty^ _Owner, Node^ _ParentNode, KFCurveNode* _pCurveNode, EFbxType _PropertyType ) :
-m_ParentTrack( _ParentTrack ), m_Owner( _Owner ), m_ParentNode( _ParentNode ), m_pCurveNode( _pCurveNode )
+m_ParentTrack( _ParentTrack ), m_Owner( _Owner ), m_ParentNode( _ParentNode ), m_pCurveNode( _pCurveNode ), m_pCurve( NULL ), m_Cursor( 0 ), m_bCompressed( false ), m_pQuantizedCurve( NULL )
 {
 	// Get the track's name
  	m_Name = Helpers::GetString( m_pCurveNode->GetName() );
@@ -127,7 +127,7 @@ m_ParentTrack( _ParentTrack ), m_Owner( _Owner ), m_ParentNode( _ParentNode ), m
 	m_ChildTracks = ChildTracks->ToArray();
 }
 
-AnimationTrack::AnimationTrack( AnimationTrack^ _Source )
+AnimationTrack::AnimationTrack( AnimationTrack^ _Source ) : m_pCurve( NULL ), m_Cursor( 0 ), m_bCompressed( false ), m_pQuantizedCurve( NULL )
 {
 	m_Owner = _Source->m_Owner;
 	m_ParentNode = _Source->m_ParentNode;
@@ -142,6 +142,12 @@ AnimationTrack::AnimationTrack( AnimationTrack^ _Source )
 	m_pCurveNode = _Source->m_pCurveNode;
 	m_Defaultvalue = _Source->m_Defaultvalue;
 
+	m_bCompressed = _Source->m_bCompressed;
+	if ( _Source->m_pQuantizedCurve != NULL )
+		m_pQuantizedCurve = new QuantizedAnimationCurve( *_Source->m_pQuantizedCurve );
+	if ( _Source->m_Keys == nullptr )
+		return;	// Compressed keys
+
 	m_Keys = gcnew cli::array<AnimationKey^>( _Source->m_Keys->Length );
 	for ( int KeyIndex=0; KeyIndex < m_Keys->Length; KeyIndex++ )
 	{
@@ -168,12 +174,158 @@ AnimationTrack::AnimationTrack( AnimationTrack^ _Source )
 	}
 }
 
+AnimationTrack::~AnimationTrack()
+{
+	this->!AnimationTrack();
+}
+
+AnimationTrack::!AnimationTrack()
+{
+	delete m_pCurve;
+	m_pCurve = NULL;
+	delete m_pQuantizedCurve;
+	m_pQuantizedCurve = NULL;
+}
+
+cli::array<AnimationTrack::AnimationKey^>^	AnimationTrack::Keys::get()
+{
+	if ( m_Keys != nullptr )
+		return	m_Keys;
+
+	// Decode the quantized keys
+	int					KeysCount = m_pQuantizedCurve->GetKeysCount();
+	AnimationCurveKey*	pKeys = new AnimationCurveKey[KeysCount];
+	m_pQuantizedCurve->DecodeKeys( pKeys );
+
+	cli::array<AnimationKey^>^	Result = gcnew cli::array<AnimationKey^>( KeysCount );
+	for ( int KeyIndex=0; KeyIndex < KeysCount; KeyIndex++ )
+	{
+		const AnimationCurveKey&	SK = pKeys[KeyIndex];
+		AnimationKey^	K = Result[KeyIndex] = gcnew AnimationKey();
+
+		K->Previous = KeyIndex > 0 ? Result[KeyIndex-1] : nullptr;
+		if ( KeyIndex > 0 )
+			Result[KeyIndex-1]->Next = K;
+		K->Type = (AnimationKey::KEY_TYPE) SK.Type;
+		K->Time = SK.Time;
+		K->Value = SK.Value;
+		K->CubicType = (AnimationKey::CUBIC_INTERPOLATION_TYPE) SK.CubicType;
+		K->RightSlope = SK.RightSlope;
+		K->NextLeftSlope = SK.NextLeftSlope;
+		K->RightWeight = SK.RightWeight;
+		K->NextLeftWeight = SK.NextLeftWeight;
+	}
+	delete[] pKeys;
+
+	return	Result;
+}
+
 float	AnimationTrack::Evaluate( float _Time )
 {
-	KFCurve*	pCurve = m_pCurveNode->FCurveGet();
+	int		Cursor = m_Cursor;
+	if ( m_pQuantizedCurve != NULL )
+	{	// Evaluate the quantized keys directly
+		float	Result = m_pQuantizedCurve->Evaluate( _Time, Cursor );
+		m_Cursor = Cursor;
+		return	Result;
+	}
+
+	if ( m_pCurve == NULL )
+		m_pCurve = CreateNativeCurve();
+
+	float	Result = m_pCurve->Evaluate( _Time, Cursor );
+	m_Cursor = Cursor;
 
-	KTime	T;
-			T.SetSecondDouble( _Time );
+	return	Result;
+}
+
+void	AnimationTrack::ReleaseSDKCurve()
+{
+	m_pCurveNode = NULL;
+
+	// Keys were read at construction, only build the curve evaluation will need
+	if ( m_pQuantizedCurve == NULL && m_pCurve == NULL && m_Keys != nullptr )
+		m_pCurve = CreateNativeCurve();
+
+	for ( int ChildIndex=0; ChildIndex < m_ChildTracks->Length; ChildIndex++ )
+		m_ChildTracks[ChildIndex]->ReleaseSDKCurve();
+}
+
+AnimationCurve*	AnimationTrack::CreateNativeCurve()
+{
+	if ( m_pQuantizedCurve != NULL )
+	{	// Decode the quantized keys
+		AnimationCurveKey*	pKeys = new AnimationCurveKey[m_pQuantizedCurve->GetKeysCount()];
+		m_pQuantizedCurve->DecodeKeys( pKeys );
+
+		AnimationCurve*	pResult = new AnimationCurve( pKeys, m_pQuantizedCurve->GetKeysCount(), m_Defaultvalue );
+		delete[] pKeys;
+
+		return	pResult;
+	}
+
+	int					KeysCount = m_Keys->Length;
+	AnimationCurveKey*	pKeys = new AnimationCurveKey[KeysCount > 0 ? KeysCount : 1];
+	for ( int KeyIndex=0; KeyIndex < KeysCount; KeyIndex++ )
+	{
+		AnimationKey^		SK = m_Keys[KeyIndex];
+		AnimationCurveKey&	K = pKeys[KeyIndex];
+
+		K.Type = (int) SK->Type;
+		K.Time = SK->Time;
+		K.Value = SK->Value;
+		K.CubicType = (int) SK->CubicType;
+		K.RightSlope = SK->RightSlope;
+		K.NextLeftSlope = SK->NextLeftSlope;
+		K.RightWeight = SK->RightWeight;
+		K.NextLeftWeight = SK->NextLeftWeight;
+		K.Tension = SK->Tension;
+		K.Continuity = SK->Continuity;
+		K.Bias = SK->Bias;
+	}
+
+	AnimationCurve*	pResult = new AnimationCurve( pKeys, KeysCount, m_Defaultvalue );
+	delete[] pKeys;
+
+	return	pResult;
+}
+
+AnimationCompressionReport::TrackEntry^	AnimationTrack::Compress( float _SampleRate, float _Tolerance )
+{
+	AnimationCompressionReport::TrackEntry^	Entry = gcnew AnimationCompressionReport::TrackEntry();
+	Entry->Tolerance = _Tolerance;
+	Entry->SourceKeysCount = Keys->Length;
+
+	// Estimate the memory used by the managed keys (object header, 2 links, 11 fields & the array slot)
+	Entry->SourceBytes = Entry->SourceKeysCount * (4 * IntPtr::Size + 11 * sizeof(float));
+
+	AnimationCurve*				pSource = CreateNativeCurve();
+	AnimationCurveCompressor	Compressor( _SampleRate, _Tolerance );
+	AnimationCompressionResult	Result;
+	Compressor.Compress( *pSource, Result );
+	delete pSource;
+
+	if ( Result.bRejected )
+	{	// The compressed curve would break the tolerance: keep the source keys
+		Entry->Rejected = true;
+		Entry->KeysCount = Entry->SourceKeysCount;
+		Entry->Bytes = Entry->SourceBytes;
+		return	Entry;
+	}
 
-	return	pCurve->Evaluate( T );
+	// Replace the keys by their compressed version
+	InvalidateCurve();
+	delete m_pQuantizedCurve;
+	m_pQuantizedCurve = Result.pCurve;
+	m_bCompressed = true;
+	m_Keys = m_pQuantizedCurve != NULL ? nullptr : gcnew cli::array<AnimationKey^>( 0 );
+	if ( m_pQuantizedCurve == NULL )
+		m_Defaultvalue = Result.ConstantValue;
+
+	Entry->KeysCount = m_pQuantizedCurve != NULL ? m_pQuantizedCurve->GetKeysCount() : 0;
+	Entry->Bytes = m_pQuantizedCurve != NULL ? m_pQuantizedCurve->GetMemorySize() : 0;
+	Entry->MaxError = Result.MaxError;
+	Entry->RMSError = Result.RMSError;
+
+	return	Entry;
 }
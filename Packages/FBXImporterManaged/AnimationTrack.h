@@ -4,6 +4,9 @@
 #pragma once
 
 #include "Helpers.h"
+#include "AnimationCurves.h"
+#include "AnimationCompression.h"
+#include "AnimationCompressionReport.h"
 
 using namespace System;
 using namespace System::Collections::Generic;
@@ -84,6 +87,14 @@ namespace FBXImporter
 		float			m_Defaultvalue;
 		cli::array<AnimationKey^>^	m_Keys;
 
+		// Native curve built from the keys, used for evaluation without the FBX SDK
+		AnimationCurve*	m_pCurve;
+		int				m_Cursor;		// The last evaluated segment, for coherent playback
+
+		// Compressed storage (once compressed, the keys are only kept in quantized form and decoded on demand)
+		bool						m_bCompressed;
+		QuantizedAnimationCurve*	m_pQuantizedCurve;	// NULL for constant tracks
+
 
 	public:		// PROPERTIES
 
@@ -107,9 +118,16 @@ namespace FBXImporter
 			cli::array<AnimationTrack^>^	get()	{ return m_ChildTracks; }
 		}
 
+		// NOTE: The keys of a compressed track are decoded from the quantized storage on each call
 		property cli::array<AnimationKey^>^	Keys
 		{
-			cli::array<AnimationKey^>^	get()	{ return m_Keys; }
+			cli::array<AnimationKey^>^	get();
+		}
+
+		// Tells if the track was compressed by Compress()
+		property bool			IsCompressed
+		{
+			bool		get()	{ return m_bCompressed; }
 		}
 
 
@@ -117,25 +135,58 @@ namespace FBXImporter
 
 		AnimationTrack( AnimationTrack^ _ParentTrack, ObjectProperty^ _Owner, Node^ _ParentNode, KFCurveNode* _pCurveNode, EFbxType _PropertyType );
 		AnimationTrack( AnimationTrack^ _Source );
+		~AnimationTrack();
+		!AnimationTrack();
 
+		// Evaluates the track at the given time using the native curve built from the keys
 		float	Evaluate( float _Time );
 
+		// Creates a new native curve from the keys (the caller owns the returned curve)
+		[System::ComponentModel::BrowsableAttribute( false )]
+		AnimationCurve*	CreateNativeCurve();
+
+		// Reduces the keys to the least keys reproducing the track within the given tolerance then stores them quantized
+		// The managed keys are released and the track is evaluated from its quantized keys from then on, unless the compressed
+		//	curve would break the tolerance (e.g. takes longer than 65535 frames, or steps between frames) in which case the source keys are kept.
+		AnimationCompressionReport::TrackEntry^	Compress( float _SampleRate, float _Tolerance );
+
 		// Adds a value to all keys
 		//
 		void	AddValue( float _Value )
 		{
+			if ( m_bCompressed )
+			{
+				if ( m_pQuantizedCurve != NULL )
+					m_pQuantizedCurve->Offset( _Value );
+				else
+					m_Defaultvalue += _Value;
+				InvalidateCurve();
+				return;
+			}
+
 			for ( int KeyIndex=0; KeyIndex < m_Keys->Length; KeyIndex++ )
 			{
 				AnimationKey^	Key = m_Keys[KeyIndex];
 
 				Key->Value += _Value;
 			}
+			InvalidateCurve();
 		}
 
 		// Applies the provided factor to every keys & their slopes
 		//
 		void	ApplyFactor( float _Factor )
 		{
+			if ( m_bCompressed )
+			{
+				if ( m_pQuantizedCurve != NULL )
+					m_pQuantizedCurve->Scale( _Factor );
+				else
+					m_Defaultvalue *= _Factor;
+				InvalidateCurve();
+				return;
+			}
+
 			for ( int KeyIndex=0; KeyIndex < m_Keys->Length; KeyIndex++ )
 			{
 				AnimationKey^	Key = m_Keys[KeyIndex];
@@ -144,6 +195,22 @@ namespace FBXImporter
 				Key->RightSlope *= _Factor;
 				Key->NextLeftSlope *= _Factor;
 			}
+			InvalidateCurve();
+		}
+
+	internal:
+
+		// Builds the native curve ahead of time and forgets about the SDK curve node (recursively)
+		void	ReleaseSDKCurve();
+
+	protected:
+
+		// Releases the native curve so it gets rebuilt from the modified keys
+		void	InvalidateCurve()
+		{
+			delete m_pCurve;
+			m_pCurve = NULL;
+			m_Cursor = 0;
 		}
 	};
 }
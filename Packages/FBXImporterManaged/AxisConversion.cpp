@@ -0,0 +1,162 @@
+// Native axis system conversion
+// Remaps & negates the axes of vectors, matrices & animation frames, 4 vectors at a time with SSE
+//
+#ifdef _MANAGED
+#pragma unmanaged
+#endif
+
+#include <xmmintrin.h>
+
+#include "AxisConversion.h"
+
+using namespace	FBXImporter;
+
+const AxisConversion::AxisSystem	AxisConversion::Z_UP_RIGHT_HANDED = { AxisConversion::AXIS_Z, +1, AxisConversion::AXIS_Y, -1, true };
+const AxisConversion::AxisSystem	AxisConversion::Y_UP_RIGHT_HANDED = { AxisConversion::AXIS_Y, +1, AxisConversion::AXIS_Z, +1, true };
+const AxisConversion::AxisSystem	AxisConversion::Y_UP_LEFT_HANDED = { AxisConversion::AXIS_Y, +1, AxisConversion::AXIS_Z, +1, false };
+
+AxisConversion::AxisConversion() : m_Determinant( 1.0f ), m_bIdentity( true )
+{
+	for ( int AxisIndex=0; AxisIndex < 3; AxisIndex++ )
+	{
+		m_pSourceAxes[AxisIndex] = AxisIndex;
+		m_pSigns[AxisIndex] = 1.0f;
+	}
+}
+
+AxisConversion::AxisConversion( const AxisSystem& _Source, const AxisSystem& _Target )
+{
+	int	pSourceAxes[3], pSourceSigns[3];
+	int	pTargetAxes[3], pTargetSigns[3];
+	GetBasis( _Source, pSourceAxes, pSourceSigns );
+	GetBasis( _Target, pTargetAxes, pTargetSigns );
+
+	// Each direction (third, up & front) of the source must end up along the same direction of the target
+	m_bIdentity = true;
+	for ( int DirectionIndex=0; DirectionIndex < 3; DirectionIndex++ )
+	{
+		int	TargetAxis = pTargetAxes[DirectionIndex];
+		m_pSourceAxes[TargetAxis] = pSourceAxes[DirectionIndex];
+		m_pSigns[TargetAxis] = (float) (pTargetSigns[DirectionIndex] * pSourceSigns[DirectionIndex]);
+		m_bIdentity &= pSourceAxes[DirectionIndex] == TargetAxis && pTargetSigns[DirectionIndex] == pSourceSigns[DirectionIndex];
+	}
+
+	// The determinant of a signed permutation is the product of the signs & of the permutation's parity
+	bool	bEvenPermutation = (m_pSourceAxes[0] + 1) % 3 == m_pSourceAxes[1];
+	m_Determinant = m_pSigns[0] * m_pSigns[1] * m_pSigns[2] * (bEvenPermutation ? 1.0f : -1.0f);
+}
+
+bool	AxisConversion::IsValid( const AxisSystem& _AxisSystem )
+{
+	return	_AxisSystem.Up != _AxisSystem.Front
+		&&	(_AxisSystem.UpSign == 1 || _AxisSystem.UpSign == -1)
+		&&	(_AxisSystem.FrontSign == 1 || _AxisSystem.FrontSign == -1);
+}
+
+void	AxisConversion::GetBasis( const AxisSystem& _AxisSystem, int* _pAxes, int* _pSigns )
+{
+	int	Up = _AxisSystem.Up;
+	int	Front = _AxisSystem.Front;
+	int	Third = 3 - Up - Front;
+
+	// e_Up x e_Front = +e_Third when (Up, Front, Third) is a cyclic order of (X, Y, Z)
+	int	CrossSign = (Up + 1) % 3 == Front ? 1 : -1;
+
+	_pAxes[0] = Third;
+	_pSigns[0] = _AxisSystem.UpSign * _AxisSystem.FrontSign * CrossSign * (_AxisSystem.bRightHanded ? 1 : -1);
+	_pAxes[1] = Up;
+	_pSigns[1] = _AxisSystem.UpSign;
+	_pAxes[2] = Front;
+	_pSigns[2] = _AxisSystem.FrontSign;
+}
+
+void	AxisConversion::TransformVectors( float* _pVectors, int _Count ) const
+{
+	if ( m_bIdentity )
+		return;
+
+	int	A0 = m_pSourceAxes[0], A1 = m_pSourceAxes[1], A2 = m_pSourceAxes[2];
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] 4 vectors at a time: transpose the 12 floats into X, Y & Z registers, pick & negate the components then transpose back
+	__m128	pSignMasks[3];
+	for ( int AxisIndex=0; AxisIndex < 3; AxisIndex++ )
+		pSignMasks[AxisIndex] = _mm_set1_ps( m_pSigns[AxisIndex] < 0.0f ? -0.0f : 0.0f );
+
+	float*	pVector = _pVectors;
+	int		VectorIndex = 0;
+	for ( ; VectorIndex+4 <= _Count; VectorIndex+=4, pVector+=12 )
+	{
+		__m128	A = _mm_loadu_ps( pVector+0 );	// x0 y0 z0 x1
+		__m128	B = _mm_loadu_ps( pVector+4 );	// y1 z1 x2 y2
+		__m128	C = _mm_loadu_ps( pVector+8 );	// z2 x3 y3 z3
+
+		__m128	pSource[3];
+		pSource[0] = _mm_shuffle_ps( _mm_shuffle_ps( A, B, _MM_SHUFFLE( 0, 0, 3, 0 ) ), _mm_shuffle_ps( B, C, _MM_SHUFFLE( 0, 1, 0, 2 ) ), _MM_SHUFFLE( 2, 0, 1, 0 ) );
+		pSource[1] = _mm_shuffle_ps( _mm_shuffle_ps( A, B, _MM_SHUFFLE( 3, 0, 0, 1 ) ), _mm_shuffle_ps( B, C, _MM_SHUFFLE( 0, 2, 3, 0 ) ), _MM_SHUFFLE( 2, 1, 2, 0 ) );
+		pSource[2] = _mm_shuffle_ps( _mm_shuffle_ps( A, B, _MM_SHUFFLE( 0, 1, 0, 2 ) ), _mm_shuffle_ps( C, C, _MM_SHUFFLE( 3, 0, 0, 0 ) ), _MM_SHUFFLE( 3, 0, 2, 0 ) );
+
+		__m128	X = _mm_xor_ps( pSource[A0], pSignMasks[0] );
+		__m128	Y = _mm_xor_ps( pSource[A1], pSignMasks[1] );
+		__m128	Z = _mm_xor_ps( pSource[A2], pSignMasks[2] );
+
+		_mm_storeu_ps( pVector+0, _mm_shuffle_ps( _mm_shuffle_ps( X, Y, _MM_SHUFFLE( 0, 0, 0, 0 ) ), _mm_shuffle_ps( Z, X, _MM_SHUFFLE( 1, 1, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+		_mm_storeu_ps( pVector+4, _mm_shuffle_ps( _mm_shuffle_ps( Y, Z, _MM_SHUFFLE( 1, 1, 1, 1 ) ), _mm_shuffle_ps( X, Y, _MM_SHUFFLE( 2, 2, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+		_mm_storeu_ps( pVector+8, _mm_shuffle_ps( _mm_shuffle_ps( Z, X, _MM_SHUFFLE( 3, 3, 2, 2 ) ), _mm_shuffle_ps( Y, Z, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Remaining vectors
+	for ( ; VectorIndex < _Count; VectorIndex++, pVector+=3 )
+	{
+		float	x = pVector[A0], y = pVector[A1], z = pVector[A2];
+		pVector[0] = m_pSigns[0] * x;
+		pVector[1] = m_pSigns[1] * y;
+		pVector[2] = m_pSigns[2] * z;
+	}
+}
+
+void	AxisConversion::TransformMatrix( float* _pMatrix ) const
+{
+	if ( m_bIdentity )
+		return;
+
+	// With C the conversion applied to row vectors, the converted transform is C^T * M * C
+	float	pSource[16];
+	for ( int Index=0; Index < 16; Index++ )
+		pSource[Index] = _pMatrix[Index];
+
+	for ( int Row=0; Row < 4; Row++ )
+	{
+		int		SourceRow = Row < 3 ? m_pSourceAxes[Row] : 3;
+		float	RowSign = Row < 3 ? m_pSigns[Row] : 1.0f;
+		for ( int Column=0; Column < 4; Column++ )
+		{
+			int		SourceColumn = Column < 3 ? m_pSourceAxes[Column] : 3;
+			float	ColumnSign = Column < 3 ? m_pSigns[Column] : 1.0f;
+			_pMatrix[4*Row+Column] = RowSign * ColumnSign * pSource[4*SourceRow+SourceColumn];
+		}
+	}
+}
+
+void	AxisConversion::TransformFrames( float* _pFrames, int _FramesCount ) const
+{
+	if ( m_bIdentity )
+		return;
+
+	for ( int FrameIndex=0; FrameIndex < _FramesCount; FrameIndex++, _pFrames+=9 )
+	{
+		float	pFrame[9];
+		for ( int Index=0; Index < 9; Index++ )
+			pFrame[Index] = _pFrames[Index];
+
+		// Rotating about a negated axis is rotating the other way, and reflections reverse all rotations
+		for ( int AxisIndex=0; AxisIndex < 3; AxisIndex++ )
+		{
+			int	SourceAxis = m_pSourceAxes[AxisIndex];
+			_pFrames[0+AxisIndex] = m_pSigns[AxisIndex] * pFrame[0+SourceAxis];
+			_pFrames[3+AxisIndex] = m_Determinant * m_pSigns[AxisIndex] * pFrame[3+SourceAxis];
+			_pFrames[6+AxisIndex] = pFrame[6+SourceAxis];
+		}
+	}
+}
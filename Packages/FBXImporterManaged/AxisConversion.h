@@ -0,0 +1,81 @@
+// Contains the native conversion of geometry, transforms & animations between coordinate systems
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Converts data from a source axis system into a target axis system
+	// An axis system is given by its up & front axes (with their signs) and its handedness, the third axis being up x front
+	//	for right-handed systems and front x up for left-handed ones (the same convention as the FBX SDK).
+	//
+	// Such a conversion is always a signed permutation of the axes: a target component is a source component, possibly negated.
+	// When the handedness changes the conversion is a reflection and triangles must have their winding reversed (cf. FlipsWinding()).
+	//
+	// Vectors are converted 4 at a time with SSE. Matrices use the row-vector convention of WMath (translation in the last row).
+	// Euler rotations are converted axis by axis, which is exact for rotations about a single axis but only approximates rotations
+	//	combining several axes when the conversion permutes the axes (the rotation order stays X, Y, Z).
+	//
+	class	AxisConversion
+	{
+	public:		// NESTED TYPES
+
+		enum	AXIS
+		{
+			AXIS_X,
+			AXIS_Y,
+			AXIS_Z,
+		};
+
+		struct	AxisSystem
+		{
+			AXIS	Up;
+			int		UpSign;			// +1 or -1
+			AXIS	Front;
+			int		FrontSign;		// +1 or -1
+			bool	bRightHanded;
+		};
+
+		static const AxisSystem	Z_UP_RIGHT_HANDED;	// 3ds Max, Blender, Maya Z-Up
+		static const AxisSystem	Y_UP_RIGHT_HANDED;	// Maya Y-Up, OpenGL, OBJ
+		static const AxisSystem	Y_UP_LEFT_HANDED;	// Direct3D
+
+	protected:	// FIELDS
+
+		int		m_pSourceAxes[3];	// The source component of each target component
+		float	m_pSigns[3];		// The sign applied to each target component
+		float	m_Determinant;		// -1 for reflections
+		bool	m_bIdentity;
+
+	public:		// PROPERTIES
+
+		bool	IsIdentity() const							{ return m_bIdentity; }
+		bool	FlipsWinding() const						{ return m_Determinant < 0.0f; }
+		float	GetDeterminant() const						{ return m_Determinant; }
+		int		GetSourceAxis( int _TargetAxis ) const		{ return m_pSourceAxes[_TargetAxis]; }
+		float	GetSign( int _TargetAxis ) const			{ return m_pSigns[_TargetAxis]; }
+
+	public:		// METHODS
+
+		// Builds the identity conversion
+		AxisConversion();
+		AxisConversion( const AxisSystem& _Source, const AxisSystem& _Target );
+
+		// Converts packed 3D vectors (positions, normals, tangents, binormals, deltas) in place (3 floats per vector)
+		void	TransformVectors( float* _pVectors, int _Count ) const;
+
+		// Converts a 4x4 transform matrix in place (16 floats, row-major)
+		void	TransformMatrix( float* _pMatrix ) const;
+
+		// Converts packed P, R & S frames in place (9 floats per frame: translation, Euler rotation & scaling)
+		void	TransformFrames( float* _pFrames, int _FramesCount ) const;
+
+		// Tells if the axis system is valid (i.e. the up & front axes differ and signs are +1 or -1)
+		static bool	IsValid( const AxisSystem& _AxisSystem );
+
+	protected:
+
+		// Gets the signed source axes of the third, up & front directions
+		static void	GetBasis( const AxisSystem& _AxisSystem, int* _pAxes, int* _pSigns );
+	};
+}
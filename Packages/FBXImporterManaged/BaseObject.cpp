@@ -3,10 +3,238 @@
 #include "stdafx.h"
 
 #include "BaseObject.h"
+#include "Scene.h"
 
 using namespace	FBXImporter;
 using namespace System::Reflection;
 
+BaseObject::BaseObject( Scene^ _ParentScene, KFbxObject* _pObject ) : m_ParentScene( _ParentScene ), m_pObject( _pObject )
+{
+	m_PropertiesCount = 0;
+	m_pPropertyHandles = NULL;
+	m_UserPropertiesCount = 0;
+	m_pUserPropertyIndices = NULL;
+	m_bAllPropertiesMaterialized = false;
+	m_UserProperties = nullptr;
+	m_PropertyTable = nullptr;
+
+	if ( _pObject == NULL )
+	{	// No FBX object to wrap (e.g. default material)
+		m_Properties = gcnew cli::array<ObjectProperty^>( 0 );
+		m_UserProperties = gcnew cli::array<ObjectProperty^>( 0 );
+		m_bAllPropertiesMaterialized = true;
+		return;
+	}
+
+	m_Name = Helpers::GetString( _pObject->GetName() );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Only store the property handles, ObjectProperty instances are built on demand
+	PROFILE_SCOPE( "BaseObject::EnumerateProperties" );
+	for ( KFbxProperty Property = _pObject->GetFirstProperty(); Property.IsValid(); Property = _pObject->GetNextProperty( Property ) )
+	{
+		m_PropertiesCount++;
+		if ( Property.GetFlag( KFbxProperty::eUSER ) )
+			m_UserPropertiesCount++;
+	}
+
+	m_pPropertyHandles = new KFbxProperty[m_PropertiesCount];
+	m_pUserPropertyIndices = new int[m_UserPropertiesCount];
+
+	int	PropertyIndex = 0;
+	int	UserPropertyIndex = 0;
+	for ( KFbxProperty Property = _pObject->GetFirstProperty(); Property.IsValid(); Property = _pObject->GetNextProperty( Property ) )
+	{
+		if ( Property.GetFlag( KFbxProperty::eUSER ) )
+			m_pUserPropertyIndices[UserPropertyIndex++] = PropertyIndex;
+		m_pPropertyHandles[PropertyIndex++] = Property;
+	}
+
+	m_Properties = gcnew cli::array<ObjectProperty^>( m_PropertiesCount );
+
+	PROFILE_COUNT( OBJECTS_ALLOCATED, 1 );
+	PROFILE_COUNT( BYTES_PRODUCED, sizeof(KFbxProperty) * m_PropertiesCount + sizeof(int) * m_UserPropertiesCount );
+
+	// Register to the scene so we get notified before the SDK scene is destroyed
+	if ( m_ParentScene != nullptr )
+		m_ParentScene->RegisterObject( this );
+}
+
+BaseObject::~BaseObject()
+{
+	this->!BaseObject();
+}
+
+BaseObject::!BaseObject()
+{
+	ReleasePropertyHandles();
+}
+
+cli::array<ObjectProperty^>^	BaseObject::UserProperties::get()
+{
+	if ( m_UserProperties != nullptr )
+		return	m_UserProperties;
+
+	if ( m_pUserPropertyIndices == NULL )
+		throw gcnew Exception( "User properties of object \"" + Name + "\" were not materialized before the FBX scene got destroyed !" );
+
+	m_UserProperties = gcnew cli::array<ObjectProperty^>( m_UserPropertiesCount );
+	for ( int UserPropertyIndex=0; UserPropertyIndex < m_UserPropertiesCount; UserPropertyIndex++ )
+		m_UserProperties[UserPropertyIndex] = MaterializeProperty( m_pUserPropertyIndices[UserPropertyIndex] );
+
+	return	m_UserProperties;
+}
+
+ObjectProperty^	BaseObject::FindProperty( String^ _Name )
+{
+	if ( _Name == nullptr )
+		return	nullptr;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Look into the table shared by all the objects of our class
+	if ( m_PropertyTable == nullptr && m_pPropertyHandles != NULL && m_ParentScene != nullptr )
+		m_PropertyTable = m_ParentScene->GetPropertyNameTable( m_pObject, m_pPropertyHandles, m_PropertiesCount, m_PropertiesCount - m_UserPropertiesCount );
+
+	if ( m_PropertyTable != nullptr )
+	{
+		int	PropertyIndex = m_PropertyTable->Find( _Name );
+		if ( PropertyIndex >= 0 && PropertyHasName( PropertyIndex, _Name ) )
+			return	MaterializeProperty( PropertyIndex );
+
+		// Either a user property or our layout differs from the class' shared layout (the table is only keyed on the class name
+		//	& the amount of class properties, so objects with dynamic properties may share a table with different names),
+		//	fall back to a linear search...
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Linear search
+	for ( int PropertyIndex=0; PropertyIndex < m_PropertiesCount; PropertyIndex++ )
+		if ( PropertyHasName( PropertyIndex, _Name ) )
+			return	MaterializeProperty( PropertyIndex );
+
+	return	nullptr;
+}
+
+bool	BaseObject::PropertyHasName( int _PropertyIndex, String^ _Name )
+{
+	if ( _PropertyIndex >= m_PropertiesCount )
+		return	false;
+
+	ObjectProperty^	Property = m_Properties[_PropertyIndex];
+	if ( Property != nullptr )
+		return	Property->Name == _Name;
+	if ( m_pPropertyHandles == NULL )
+		return	false;	// Not materialized and not available anymore
+
+	// Compare against the native label so we don't materialize anything we don't need
+	return	Helpers::StringEquals( _Name, m_pPropertyHandles[_PropertyIndex].GetLabel().Buffer() );
+}
+
+ObjectProperty^	BaseObject::FindUserProperty( String^ _Name )
+{
+	if ( m_pUserPropertyIndices == NULL )
+	{	// Handles were released, only look into the snapshot
+		if ( m_UserProperties == nullptr )
+			return	nullptr;
+
+		for ( int PropertyIndex=0; PropertyIndex < m_UserProperties->Length; PropertyIndex++ )
+			if ( m_UserProperties[PropertyIndex]->Name == _Name )
+				return	m_UserProperties[PropertyIndex];
+
+		return	nullptr;
+	}
+
+	// User properties are specific to each object and are usually very few so they don't deserve a table
+	for ( int UserPropertyIndex=0; UserPropertyIndex < m_UserPropertiesCount; UserPropertyIndex++ )
+		if ( PropertyHasName( m_pUserPropertyIndices[UserPropertyIndex], _Name ) )
+			return	MaterializeProperty( m_pUserPropertyIndices[UserPropertyIndex] );
+
+	return	nullptr;
+}
+
+ObjectProperty^	BaseObject::MaterializeProperty( int _PropertyIndex )
+{
+	ObjectProperty^	Result = m_Properties[_PropertyIndex];
+	if ( Result != nullptr )
+		return	Result;
+
+	if ( m_pPropertyHandles == NULL )
+		throw gcnew Exception( "Property #" + _PropertyIndex + " of object \"" + Name + "\" was not materialized before the FBX scene got destroyed !" );
+
+	Result = gcnew ObjectProperty( this, m_pPropertyHandles[_PropertyIndex] );
+	m_Properties[_PropertyIndex] = Result;
+
+	return	Result;
+}
+
+void	BaseObject::MaterializeAllProperties()
+{
+	if ( m_bAllPropertiesMaterialized )
+		return;
+
+	if ( m_pPropertyHandles == NULL )
+		throw gcnew Exception( "Properties of object \"" + Name + "\" were not materialized before the FBX scene got destroyed !" );
+
+	for ( int PropertyIndex=0; PropertyIndex < m_PropertiesCount; PropertyIndex++ )
+		MaterializeProperty( PropertyIndex );
+
+	m_bAllPropertiesMaterialized = true;
+}
+
+void	BaseObject::SnapshotProperties()
+{
+	if ( m_pPropertyHandles == NULL )
+		return;	// Already released
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Materialize the properties one by one so an unsupported property doesn't cost the others
+	List<ObjectProperty^>^	SnapshotProps = gcnew List<ObjectProperty^>( m_PropertiesCount );
+	List<ObjectProperty^>^	SnapshotUserProps = gcnew List<ObjectProperty^>( m_UserPropertiesCount );
+	for ( int PropertyIndex=0; PropertyIndex < m_PropertiesCount; PropertyIndex++ )
+	{
+		ObjectProperty^	Property = nullptr;
+		try
+		{
+			Property = MaterializeProperty( PropertyIndex );
+		}
+		catch ( Exception^ _e )
+		{	// Leave that property out of the snapshot
+			ImportStats^	Stats = m_ParentScene != nullptr ? m_ParentScene->Stats : nullptr;
+			if ( Stats != nullptr )
+				Stats->RecordSkippedProperty( Name, Helpers::GetString( m_pPropertyHandles[PropertyIndex].GetLabel().Buffer() ), _e->Message );
+			continue;
+		}
+
+		SnapshotProps->Add( Property );
+		if ( m_pPropertyHandles[PropertyIndex].GetFlag( KFbxProperty::eUSER ) )
+			SnapshotUserProps->Add( Property );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Only keep the materialized properties, the shared name table doesn't match our list anymore
+	m_Properties = SnapshotProps->ToArray();
+	m_PropertiesCount = m_Properties->Length;
+	m_UserProperties = SnapshotUserProps->ToArray();
+	m_UserPropertiesCount = m_UserProperties->Length;
+	m_PropertyTable = nullptr;
+	m_bAllPropertiesMaterialized = true;
+
+	ReleasePropertyHandles();
+}
+
+void	BaseObject::ReleasePropertyHandles()
+{
+	delete[] m_pPropertyHandles;
+	m_pPropertyHandles = NULL;
+	delete[] m_pUserPropertyIndices;
+	m_pUserPropertyIndices = NULL;
+}
+
+void	BaseObject::ReleaseSDKObject()
+{
+	m_pObject = NULL;
+}
+
 String^	BaseObject::ListProperties()
 {
 	String^	Result = "";
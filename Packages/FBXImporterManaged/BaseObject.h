@@ -15,6 +15,42 @@ namespace FBXImporter
 {
 	ref class	Scene;
 
+	//////////////////////////////////////////////////////////////////////////
+	// Maps property names to their index in the properties list of an object
+	// Objects of the same FBX class usually share the same layout of (non-user) properties
+	//	so a single table is built per class and shared by all of them (cf. Scene::GetPropertyNameTable())
+	// The table is only a shortcut: a name it doesn't know or that maps to another property is searched linearly
+	//
+	public ref class		PropertyNameTable
+	{
+	protected:	// FIELDS
+
+		Dictionary<String^,int>^	m_Name2Index;
+
+	public:		// METHODS
+
+		PropertyNameTable( const KFbxProperty* _pHandles, int _PropertiesCount )
+		{
+			m_Name2Index = gcnew Dictionary<String^,int>( _PropertiesCount );
+			for ( int PropertyIndex=0; PropertyIndex < _PropertiesCount; PropertyIndex++ )
+			{
+				if ( _pHandles[PropertyIndex].GetFlag( KFbxProperty::eUSER ) )
+					continue;	// User properties are specific to each object
+
+				String^	Name = Helpers::GetString( _pHandles[PropertyIndex].GetLabel().Buffer() );
+				if ( !m_Name2Index->ContainsKey( Name ) )
+					m_Name2Index->Add( Name, PropertyIndex );	// Keep the first occurrence, like a linear search would
+			}
+		}
+
+		// Gets the index of the property with the given name, -1 if not in the table
+		int		Find( String^ _Name )
+		{
+			int	Result;
+			return	m_Name2Index->TryGetValue( _Name, Result ) ? Result : -1;
+		}
+	};
+
 	//////////////////////////////////////////////////////////////////////////
 	// Represents the base object used for all FBX objects
 	//
@@ -27,8 +63,18 @@ namespace FBXImporter
 
 		String^				m_Name;				// Node name
 
-		cli::array<ObjectProperty^>^	m_Properties;
-		cli::array<ObjectProperty^>^	m_UserProperties;
+		// Properties are enumerated at construction as a compact list of FBX handles
+		//	and are only materialized into ObjectProperty instances when accessed
+		int					m_PropertiesCount;
+		KFbxProperty*		m_pPropertyHandles;		// The FBX property handles (NULL once released)
+		int					m_UserPropertiesCount;
+		int*				m_pUserPropertyIndices;	// Indices of user properties into the handles list
+
+		PropertyNameTable^	m_PropertyTable;		// The name table shared by objects of our class (built on first lookup)
+
+		cli::array<ObjectProperty^>^	m_Properties;		// Materialized properties (null entries are not materialized yet)
+		cli::array<ObjectProperty^>^	m_UserProperties;	// Built on first access
+		bool				m_bAllPropertiesMaterialized;
 
 
 	public:		// PROPERTIES
@@ -50,41 +96,29 @@ namespace FBXImporter
 		//
 		property cli::array<ObjectProperty^>^	Properties
 		{
-			cli::array<ObjectProperty^>^	get()	{ return m_Properties; }
+			cli::array<ObjectProperty^>^	get()	{ MaterializeAllProperties(); return m_Properties; }
 		}
 
 		[DescriptionAttribute( "Gives the list of user properties tied to this object" )]
 		//
 		property cli::array<ObjectProperty^>^	UserProperties
 		{
-			cli::array<ObjectProperty^>^	get()	{ return m_UserProperties; }
+			cli::array<ObjectProperty^>^	get();
 		}
 
-
-	public:		// METHODS
-
-		BaseObject( Scene^ _ParentScene, KFbxObject* _pObject ) : m_ParentScene( _ParentScene ), m_pObject( _pObject )
+		[DescriptionAttribute( "Gives the amount of properties tied to this object (doesn't materialize them)" )]
+		//
+		property int		PropertiesCount
 		{
-			m_Name = Helpers::GetString( _pObject->GetName() );
-
-			// Build the object's user properties
-			List<ObjectProperty^>^	Props = gcnew List<ObjectProperty^>();
-			List<ObjectProperty^>^	UserProps = gcnew List<ObjectProperty^>();
+			int					get()	{ return m_PropertiesCount; }
+		}
 
-			KFbxProperty	Property = _pObject->GetFirstProperty();
-			while ( Property.IsValid() )
-			{
-				ObjectProperty^	Prop = gcnew ObjectProperty( this, Property );
-				Props->Add( Prop );
-				if ( Property.GetFlag( KFbxProperty::eUSER ) )
-					UserProps->Add( Prop );
 
-				Property = _pObject->GetNextProperty( Property );
-			}
+	public:		// METHODS
 
-			m_Properties = Props->ToArray();
-			m_UserProperties = UserProps->ToArray();
-		}
+		BaseObject( Scene^ _ParentScene, KFbxObject* _pObject );
+		~BaseObject();
+		!BaseObject();
 
 		[BrowsableAttribute( false )]
 		virtual String^	ToString() override
@@ -110,25 +144,11 @@ namespace FBXImporter
 
 		[DescriptionAttribute( "Finds a property by name" )]
 		//
-		virtual ObjectProperty^	FindProperty( String^ _Name )
-		{
-			for ( int PropertyIndex=0; PropertyIndex < m_Properties->Length; PropertyIndex++ )
-				if ( m_Properties[PropertyIndex]->Name == _Name )
-					return	m_Properties[PropertyIndex];
-
-			return	nullptr;
-		}
+		virtual ObjectProperty^	FindProperty( String^ _Name );
 
 		[DescriptionAttribute( "Finds a user property by name" )]
 		//
-		virtual ObjectProperty^	FindUserProperty( String^ _Name )
-		{
-			for ( int PropertyIndex=0; PropertyIndex < m_UserProperties->Length; PropertyIndex++ )
-				if ( m_UserProperties[PropertyIndex]->Name == _Name )
-					return	m_UserProperties[PropertyIndex];
-
-			return	nullptr;
-		}
+		virtual ObjectProperty^	FindUserProperty( String^ _Name );
 
 		[BrowsableAttribute( false )]
 		virtual int		GetHashCode() override
@@ -141,5 +161,29 @@ namespace FBXImporter
 		{
 			return	Object::Equals( o );
 		}
+
+	internal:
+
+		// Materializes every property that hasn't been accessed yet
+		void	MaterializeAllProperties();
+
+		// Materializes all properties then releases the FBX handles so the object no longer depends on the SDK scene
+		// Properties that fail to materialize are left out (and recorded in the scene's stats when profiling)
+		void	SnapshotProperties();
+
+		// Releases the FBX handles (properties that were not materialized become unavailable)
+		void	ReleasePropertyHandles();
+
+		// Snapshots the values read lazily from the FBX object into plain fields then forgets about the object
+		// Called for every object right before the SDK scene gets destroyed
+		virtual void	ReleaseSDKObject();
+
+	protected:
+
+		// Materializes the property at the given index in the handles list
+		ObjectProperty^	MaterializeProperty( int _PropertyIndex );
+
+		// Tells if the property at the given index has the given name
+		bool			PropertyHasName( int _PropertyIndex, String^ _Name );
 	};
 }
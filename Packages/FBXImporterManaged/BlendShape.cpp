@@ -0,0 +1,191 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "BlendShape.h"
+#include "NodeMesh.h"
+#include "Scene.h"
+
+using namespace	FBXImporter;
+
+namespace FBXImporter
+{
+	// A job applying blend shapes to a range of vertices on the thread pool
+	ref class	BlendShapeJob
+	{
+	public:
+
+		const BlendShapeTarget* const*	m_ppTargets;
+		const float*					m_pWeights;
+		int								m_TargetsCount;
+		float*							m_pPositions;
+		float*							m_pNormals;
+		int								m_VerticesCount;
+
+		void	Execute( int _JobIndex )
+		{
+			int	StartVertex = _JobIndex * BlendShape::VERTICES_PER_JOB;
+			int	EndVertex = Math::Min( StartVertex + BlendShape::VERTICES_PER_JOB, m_VerticesCount );
+			BlendShapeTarget::Apply( m_ppTargets, m_pWeights, m_TargetsCount, m_pPositions, m_pNormals, m_VerticesCount, StartVertex, EndVertex );
+		}
+	};
+}
+
+BlendShape::BlendShape( NodeMesh^ _Owner, KFbxMesh* _pMesh, int _ShapeIndex, float _Threshold, bool _bQuantize ) : m_Owner( _Owner ), m_pTarget( NULL )
+{
+	KFbxShape*	pShape = _pMesh->GetShape( _ShapeIndex );
+	m_Name = Helpers::GetString( _pMesh->GetShapeName( _ShapeIndex ) );
+
+	int	VerticesCount = _pMesh->GetControlPointsCount();
+	if ( pShape->GetControlPointsCount() != VerticesCount )
+		throw gcnew Exception( "Blend shape \"" + m_Name + "\" of mesh \"" + _Owner->Name + "\" has " + pShape->GetControlPointsCount() + " control points instead of " + VerticesCount + " !" );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Build the dense deltas
+	cli::array<float>^	PositionDeltas = gcnew cli::array<float>( 3 * VerticesCount + 1 );
+	KFbxVector4*		pMeshPoints = _pMesh->GetControlPoints();
+	KFbxVector4*		pShapePoints = pShape->GetControlPoints();
+	for ( int VertexIndex=0; VertexIndex < VerticesCount; VertexIndex++ )
+		for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+			PositionDeltas[3*VertexIndex+ComponentIndex] = (float) (pShapePoints[VertexIndex][ComponentIndex] - pMeshPoints[VertexIndex][ComponentIndex]);
+
+	// Normal deltas are only supported when both the mesh & the shape have normals mapped by control point
+	cli::array<float>^	NormalDeltas = gcnew cli::array<float>( 3 * VerticesCount + 1 );
+	cli::array<float>^	MeshNormals = gcnew cli::array<float>( 3 * VerticesCount + 1 );
+	bool	bHasNormals = ReadControlPointNormals( pShape, VerticesCount, NormalDeltas ) && ReadControlPointNormals( _pMesh, VerticesCount, MeshNormals );
+	if ( bHasNormals )
+		for ( int Index=0; Index < 3 * VerticesCount; Index++ )
+			NormalDeltas[Index] -= MeshNormals[Index];
+
+	// Convert to the target axis system
+	_Owner->ParentScene->ConvertVectors( PositionDeltas, VerticesCount );
+	if ( bHasNormals )
+		_Owner->ParentScene->ConvertVectors( NormalDeltas, VerticesCount );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Build the sparse target
+	pin_ptr<float>	pPositionDeltas = &PositionDeltas[0];
+	pin_ptr<float>	pNormalDeltas = &NormalDeltas[0];
+	m_pTarget = new BlendShapeTarget( pPositionDeltas, bHasNormals ? (float*) pNormalDeltas : NULL, VerticesCount, _Threshold, _bQuantize );
+}
+
+BlendShape::~BlendShape()
+{
+	this->!BlendShape();
+}
+
+BlendShape::!BlendShape()
+{
+	delete m_pTarget;
+	m_pTarget = NULL;
+}
+
+bool	BlendShape::ReadControlPointNormals( KFbxGeometryBase* _pGeometry, int _ControlPointsCount, cli::array<float>^ _Normals )
+{
+	KFbxLayer*	pLayer = _pGeometry->GetLayer( 0 );
+	if ( pLayer == NULL )
+		return	false;
+
+	KFbxLayerElementNormal*	pNormals = pLayer->GetNormals();
+	if ( pNormals == NULL || pNormals->GetMappingMode() != KFbxLayerElement::eBY_CONTROL_POINT )
+		return	false;
+
+	KFbxLayerElement::EReferenceMode	ReferenceMode = pNormals->GetReferenceMode();
+	if ( ReferenceMode != KFbxLayerElement::eDIRECT && ReferenceMode != KFbxLayerElement::eINDEX_TO_DIRECT )
+		return	false;
+
+	for ( int VertexIndex=0; VertexIndex < _ControlPointsCount; VertexIndex++ )
+	{
+		int			Index = ReferenceMode == KFbxLayerElement::eDIRECT ? VertexIndex : pNormals->GetIndexArray().GetAt( VertexIndex );
+		KFbxVector4	Normal = pNormals->GetDirectArray().GetAt( Index );
+		_Normals[3*VertexIndex+0] = (float) Normal[0];
+		_Normals[3*VertexIndex+1] = (float) Normal[1];
+		_Normals[3*VertexIndex+2] = (float) Normal[2];
+	}
+
+	return	true;
+}
+
+cli::array<int>^	BlendShape::Indices::get()
+{
+	cli::array<int>^	Result = gcnew cli::array<int>( m_pTarget->GetDeltasCount() );
+	for ( int DeltaIndex=0; DeltaIndex < Result->Length; DeltaIndex++ )
+		Result[DeltaIndex] = (int) m_pTarget->GetIndices()[DeltaIndex];
+
+	return	Result;
+}
+
+cli::array<WMath::Vector^>^	BlendShape::PositionDeltas::get()
+{
+	cli::array<WMath::Vector^>^	Result = gcnew cli::array<WMath::Vector^>( m_pTarget->GetDeltasCount() );
+	float	Delta[3];
+	for ( int DeltaIndex=0; DeltaIndex < Result->Length; DeltaIndex++ )
+	{
+		m_pTarget->GetPositionDelta( DeltaIndex, Delta );
+		Result[DeltaIndex] = gcnew WMath::Vector( Delta[0], Delta[1], Delta[2] );
+	}
+
+	return	Result;
+}
+
+cli::array<WMath::Vector^>^	BlendShape::NormalDeltas::get()
+{
+	if ( !m_pTarget->HasNormals() )
+		return	nullptr;
+
+	cli::array<WMath::Vector^>^	Result = gcnew cli::array<WMath::Vector^>( m_pTarget->GetDeltasCount() );
+	float	Delta[3];
+	for ( int DeltaIndex=0; DeltaIndex < Result->Length; DeltaIndex++ )
+	{
+		m_pTarget->GetNormalDelta( DeltaIndex, Delta );
+		Result[DeltaIndex] = gcnew WMath::Vector( Delta[0], Delta[1], Delta[2] );
+	}
+
+	return	Result;
+}
+
+void	BlendShape::Apply( cli::array<BlendShape^>^ _Shapes, cli::array<float>^ _Weights, cli::array<float>^ _Positions, cli::array<float>^ _Normals )
+{
+	if ( _Weights->Length < _Shapes->Length )
+		throw gcnew Exception( "Expected " + _Shapes->Length + " weights !" );
+	if ( _Normals != nullptr && _Normals->Length != _Positions->Length )
+		throw gcnew Exception( "Position & normal buffers must have the same size !" );
+
+	int	VerticesCount = _Positions->Length / 3;
+	for ( int ShapeIndex=0; ShapeIndex < _Shapes->Length; ShapeIndex++ )
+		if ( _Shapes[ShapeIndex]->m_Owner->VerticesCount > VerticesCount )
+			throw gcnew Exception( "Blend shape \"" + _Shapes[ShapeIndex]->Name + "\" applies to " + _Shapes[ShapeIndex]->m_Owner->VerticesCount + " vertices but the buffers only contain " + VerticesCount + " vertices !" );
+	if ( VerticesCount == 0 || _Shapes->Length == 0 )
+		return;
+
+	const BlendShapeTarget**	ppTargets = new const BlendShapeTarget*[_Shapes->Length];
+	try
+	{
+		for ( int ShapeIndex=0; ShapeIndex < _Shapes->Length; ShapeIndex++ )
+			ppTargets[ShapeIndex] = _Shapes[ShapeIndex]->m_pTarget;
+
+		pin_ptr<float>	pWeights = &_Weights[0];
+		pin_ptr<float>	pPositions = &_Positions[0];
+		pin_ptr<float>	pNormals = nullptr;
+		if ( _Normals != nullptr )
+			pNormals = &_Normals[0];
+
+		BlendShapeJob^	Job = gcnew BlendShapeJob();
+		Job->m_ppTargets = ppTargets;
+		Job->m_pWeights = pWeights;
+		Job->m_TargetsCount = _Shapes->Length;
+		Job->m_pPositions = pPositions;
+		Job->m_pNormals = pNormals;
+		Job->m_VerticesCount = VerticesCount;
+
+		int	JobsCount = (VerticesCount + VERTICES_PER_JOB - 1) / VERTICES_PER_JOB;
+		if ( JobsCount == 1 )
+			Job->Execute( 0 );
+		else
+			System::Threading::Tasks::Parallel::For( 0, JobsCount, gcnew Action<int>( Job, &BlendShapeJob::Execute ) );
+	}
+	finally
+	{
+		delete[] ppTargets;
+	}
+}
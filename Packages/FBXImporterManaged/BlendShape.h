@@ -0,0 +1,118 @@
+// Contains the blend shapes attached to a mesh node
+//
+#pragma managed
+#pragma once
+
+#include "Helpers.h"
+#include "BlendShapeKernels.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+
+namespace FBXImporter
+{
+	ref class	NodeMesh;
+
+	//////////////////////////////////////////////////////////////////////////
+	// A blend shape target of a mesh, stored as sparse deltas
+	// Only the vertices that move are kept, with their position delta and, if the shape has normals, their normal delta.
+	//
+	public ref class		BlendShape
+	{
+	public:		// NESTED TYPES
+
+		literal int		VERTICES_PER_JOB = 8192;
+
+	protected:	// FIELDS
+
+		NodeMesh^			m_Owner;
+		String^				m_Name;
+
+		BlendShapeTarget*	m_pTarget;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the mesh owning the blend shape" )]
+		//
+		property NodeMesh^		Owner
+		{
+			NodeMesh^			get()	{ return m_Owner; }
+		}
+
+		[DescriptionAttribute( "Gets the name of the blend shape (i.e. the name of its channel)" )]
+		//
+		property String^		Name
+		{
+			String^				get()	{ return m_Name; }
+		}
+
+		[DescriptionAttribute( "Gets the amount of vertices moved by the blend shape" )]
+		//
+		property int			DeltasCount
+		{
+			int					get()	{ return m_pTarget->GetDeltasCount(); }
+		}
+
+		[DescriptionAttribute( "Tells if the deltas are quantized" )]
+		//
+		property bool			IsQuantized
+		{
+			bool				get()	{ return m_pTarget->IsQuantized(); }
+		}
+
+		[DescriptionAttribute( "Tells if the blend shape also has normal deltas" )]
+		//
+		property bool			HasNormals
+		{
+			bool				get()	{ return m_pTarget->HasNormals(); }
+		}
+
+		[DescriptionAttribute( "Gets the memory used by the sparse deltas (in bytes)" )]
+		//
+		property int			MemorySize
+		{
+			int					get()	{ return m_pTarget->GetMemorySize(); }
+		}
+
+		// NOTE: The following arrays are decoded from the sparse storage on each call
+
+		[DescriptionAttribute( "Gets the indices of the moving vertices" )]
+		//
+		property cli::array<int>^	Indices
+		{
+			cli::array<int>^	get();
+		}
+
+		[DescriptionAttribute( "Gets the position delta of each moving vertex" )]
+		//
+		property cli::array<WMath::Vector^>^	PositionDeltas
+		{
+			cli::array<WMath::Vector^>^	get();
+		}
+
+		[DescriptionAttribute( "Gets the normal delta of each moving vertex (null if the shape has no normals)" )]
+		//
+		property cli::array<WMath::Vector^>^	NormalDeltas
+		{
+			cli::array<WMath::Vector^>^	get();
+		}
+
+	public:		// METHODS
+
+		BlendShape( NodeMesh^ _Owner, KFbxMesh* _pMesh, int _ShapeIndex, float _Threshold, bool _bQuantize );
+		~BlendShape();
+		!BlendShape();
+
+		// Accumulates the weighted blend shapes into the packed positions & normals (3 floats per vertex) using all the available processors
+		// Shapes with a 0 weight are skipped.
+		//	_Normals, can be null
+		static void	Apply( cli::array<BlendShape^>^ _Shapes, cli::array<float>^ _Weights, cli::array<float>^ _Positions, cli::array<float>^ _Normals );
+
+	protected:
+
+		// Reads the normal of a control point from a layer mapped by control point (returns false if not mapped that way)
+		static bool	ReadControlPointNormals( KFbxGeometryBase* _pGeometry, int _ControlPointsCount, cli::array<float>^ _Normals );
+	};
+}
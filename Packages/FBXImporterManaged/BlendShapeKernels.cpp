@@ -0,0 +1,217 @@
+// Native sparse blend shape targets & morph apply kernel
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <string.h>
+#include <xmmintrin.h>
+
+#include "BlendShapeKernels.h"
+
+using namespace	FBXImporter;
+
+namespace
+{
+	inline float	Abs( float _Value )		{ return _Value < 0.0f ? -_Value : _Value; }
+
+	inline short	Quantize( float _Value, float _InvScale )
+	{
+		float	Q = _Value * _InvScale;
+		return	(short) (Q < 0.0f ? Q - 0.5f : Q + 0.5f);
+	}
+
+	// Adds a weighted delta (whose 4th component is 0) to a packed float3
+	// When the 4 floats can be read & written (i.e. not the last vertex of the buffer or of the range processed
+	//	by that thread), the 4th float is the next vertex's x which is written back unchanged.
+	inline void		Accumulate( float* _pTarget, __m128 _WeightedDelta, bool _bWide )
+	{
+		if ( _bWide )
+		{
+			_mm_storeu_ps( _pTarget, _mm_add_ps( _mm_loadu_ps( _pTarget ), _WeightedDelta ) );
+			return;
+		}
+
+		float	Delta[4];
+		_mm_storeu_ps( Delta, _WeightedDelta );
+		_pTarget[0] += Delta[0];
+		_pTarget[1] += Delta[1];
+		_pTarget[2] += Delta[2];
+	}
+}
+
+BlendShapeTarget::BlendShapeTarget( const float* _pPositionDeltas, const float* _pNormalDeltas, int _VerticesCount, float _Threshold, bool _bQuantize ) : m_bQuantized( _bQuantize )
+{
+	m_pIndices = NULL;
+	m_pPositionDeltas = m_pNormalDeltas = NULL;
+	m_pQuantizedPositionDeltas = m_pQuantizedNormalDeltas = NULL;
+	m_PositionScale = m_NormalScale = 0.0f;
+
+	// Count the moving vertices & the deltas' ranges
+	m_DeltasCount = 0;
+	float	MaxPosition = 0.0f, MaxNormal = 0.0f;
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+	{
+		float	MaxDelta = 0.0f;
+		for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+		{
+			float	P = Abs( _pPositionDeltas[3*VertexIndex+ComponentIndex] );
+			float	N = _pNormalDeltas != NULL ? Abs( _pNormalDeltas[3*VertexIndex+ComponentIndex] ) : 0.0f;
+			MaxPosition = P > MaxPosition ? P : MaxPosition;
+			MaxNormal = N > MaxNormal ? N : MaxNormal;
+			MaxDelta = P > MaxDelta ? P : MaxDelta;
+			MaxDelta = N > MaxDelta ? N : MaxDelta;
+		}
+		if ( MaxDelta > _Threshold )
+			m_DeltasCount++;
+	}
+
+	m_pIndices = new unsigned int[m_DeltasCount > 0 ? m_DeltasCount : 1];
+	if ( _bQuantize )
+	{
+		m_pQuantizedPositionDeltas = new short[4 * (m_DeltasCount > 0 ? m_DeltasCount : 1)];
+		if ( _pNormalDeltas != NULL )
+			m_pQuantizedNormalDeltas = new short[4 * (m_DeltasCount > 0 ? m_DeltasCount : 1)];
+		m_PositionScale = MaxPosition / 32767.0f;
+		m_NormalScale = MaxNormal / 32767.0f;
+	}
+	else
+	{
+		m_pPositionDeltas = new float[4 * (m_DeltasCount > 0 ? m_DeltasCount : 1)];
+		if ( _pNormalDeltas != NULL )
+			m_pNormalDeltas = new float[4 * (m_DeltasCount > 0 ? m_DeltasCount : 1)];
+	}
+
+	float	InvPositionScale = m_PositionScale > 0.0f ? 1.0f / m_PositionScale : 0.0f;
+	float	InvNormalScale = m_NormalScale > 0.0f ? 1.0f / m_NormalScale : 0.0f;
+
+	// Store the moving vertices
+	int	DeltaIndex = 0;
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+	{
+		float	MaxDelta = 0.0f;
+		for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+		{
+			float	P = Abs( _pPositionDeltas[3*VertexIndex+ComponentIndex] );
+			float	N = _pNormalDeltas != NULL ? Abs( _pNormalDeltas[3*VertexIndex+ComponentIndex] ) : 0.0f;
+			MaxDelta = P > MaxDelta ? P : MaxDelta;
+			MaxDelta = N > MaxDelta ? N : MaxDelta;
+		}
+		if ( MaxDelta <= _Threshold )
+			continue;
+
+		m_pIndices[DeltaIndex] = (unsigned int) VertexIndex;
+		for ( int ComponentIndex=0; ComponentIndex < 4; ComponentIndex++ )
+		{
+			float	P = ComponentIndex < 3 ? _pPositionDeltas[3*VertexIndex+ComponentIndex] : 0.0f;
+			float	N = ComponentIndex < 3 && _pNormalDeltas != NULL ? _pNormalDeltas[3*VertexIndex+ComponentIndex] : 0.0f;
+			if ( _bQuantize )
+			{
+				m_pQuantizedPositionDeltas[4*DeltaIndex+ComponentIndex] = Quantize( P, InvPositionScale );
+				if ( m_pQuantizedNormalDeltas != NULL )
+					m_pQuantizedNormalDeltas[4*DeltaIndex+ComponentIndex] = Quantize( N, InvNormalScale );
+			}
+			else
+			{
+				m_pPositionDeltas[4*DeltaIndex+ComponentIndex] = P;
+				if ( m_pNormalDeltas != NULL )
+					m_pNormalDeltas[4*DeltaIndex+ComponentIndex] = N;
+			}
+		}
+		DeltaIndex++;
+	}
+}
+
+BlendShapeTarget::~BlendShapeTarget()
+{
+	delete[] m_pIndices;
+	delete[] m_pPositionDeltas;
+	delete[] m_pNormalDeltas;
+	delete[] m_pQuantizedPositionDeltas;
+	delete[] m_pQuantizedNormalDeltas;
+}
+
+int		BlendShapeTarget::GetMemorySize() const
+{
+	int	DeltaSize = m_bQuantized ? 4 * sizeof(short) : 4 * sizeof(float);
+	int	Result = sizeof(BlendShapeTarget) + m_DeltasCount * (sizeof(unsigned int) + DeltaSize);
+	if ( HasNormals() )
+		Result += m_DeltasCount * DeltaSize;
+
+	return	Result;
+}
+
+void	BlendShapeTarget::GetPositionDelta( int _DeltaIndex, float* _pDelta ) const
+{
+	for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+		_pDelta[ComponentIndex] = m_bQuantized ? m_pQuantizedPositionDeltas[4*_DeltaIndex+ComponentIndex] * m_PositionScale : m_pPositionDeltas[4*_DeltaIndex+ComponentIndex];
+}
+
+void	BlendShapeTarget::GetNormalDelta( int _DeltaIndex, float* _pDelta ) const
+{
+	for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+		_pDelta[ComponentIndex] = !HasNormals() ? 0.0f : (m_bQuantized ? m_pQuantizedNormalDeltas[4*_DeltaIndex+ComponentIndex] * m_NormalScale : m_pNormalDeltas[4*_DeltaIndex+ComponentIndex]);
+}
+
+int		BlendShapeTarget::FindFirstDelta( int _VertexIndex ) const
+{
+	int	Min = 0, Max = m_DeltasCount;	// Result is in [Min,Max]
+	while ( Min < Max )
+	{
+		int	Mid = (Min + Max) >> 1;
+		if ( m_pIndices[Mid] < (unsigned int) _VertexIndex )
+			Min = Mid + 1;
+		else
+			Max = Mid;
+	}
+
+	return	Min;
+}
+
+void	BlendShapeTarget::Apply( float _Weight, float* _pPositions, float* _pNormals, int _VerticesCount, int _StartVertex, int _EndVertex ) const
+{
+	int		DeltaIndex = _StartVertex > 0 ? FindFirstDelta( _StartVertex ) : 0;
+	int		LastWideVertex = (_EndVertex < _VerticesCount ? _EndVertex : _VerticesCount) - 1;	// The last vertex can't be accessed with 4 floats
+	bool	bNormals = _pNormals != NULL && HasNormals();
+
+	__m128	Weight = _mm_set1_ps( _Weight );
+	__m128	PositionWeight = _mm_set1_ps( _Weight * m_PositionScale );
+	__m128	NormalWeight = _mm_set1_ps( _Weight * m_NormalScale );
+
+	for ( ; DeltaIndex < m_DeltasCount; DeltaIndex++ )
+	{
+		int	VertexIndex = (int) m_pIndices[DeltaIndex];
+		if ( VertexIndex >= _EndVertex )
+			break;
+
+		bool	bWide = VertexIndex < LastWideVertex;
+		if ( m_bQuantized )
+		{
+			const short*	pP = m_pQuantizedPositionDeltas + 4*DeltaIndex;
+			Accumulate( _pPositions + 3*VertexIndex, _mm_mul_ps( PositionWeight, _mm_set_ps( 0.0f, pP[2], pP[1], pP[0] ) ), bWide );
+			if ( bNormals )
+			{
+				const short*	pN = m_pQuantizedNormalDeltas + 4*DeltaIndex;
+				Accumulate( _pNormals + 3*VertexIndex, _mm_mul_ps( NormalWeight, _mm_set_ps( 0.0f, pN[2], pN[1], pN[0] ) ), bWide );
+			}
+		}
+		else
+		{
+			Accumulate( _pPositions + 3*VertexIndex, _mm_mul_ps( Weight, _mm_loadu_ps( m_pPositionDeltas + 4*DeltaIndex ) ), bWide );
+			if ( bNormals )
+				Accumulate( _pNormals + 3*VertexIndex, _mm_mul_ps( Weight, _mm_loadu_ps( m_pNormalDeltas + 4*DeltaIndex ) ), bWide );
+		}
+	}
+}
+
+void	BlendShapeTarget::Apply( const BlendShapeTarget* const* _ppTargets, const float* _pWeights, int _TargetsCount, float* _pPositions, float* _pNormals, int _VerticesCount, int _StartVertex, int _EndVertex )
+{
+	for ( int TargetIndex=0; TargetIndex < _TargetsCount; TargetIndex++ )
+	{
+		float	Weight = _pWeights[TargetIndex];
+		if ( Weight == 0.0f || _ppTargets[TargetIndex] == NULL )
+			continue;	// Inactive channel
+
+		_ppTargets[TargetIndex]->Apply( Weight, _pPositions, _pNormals, _VerticesCount, _StartVertex, _EndVertex );
+	}
+}
@@ -0,0 +1,64 @@
+// Contains the native sparse blend shape targets and the morph apply kernel
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A sparse blend shape target
+	// Only the vertices that move are stored, as a sorted vertex index plus a position (and optionally a normal) delta.
+	// Deltas are stored either as 4 floats (the 4th being 0) or quantized as 4 shorts with a per-target scale.
+	//
+	class	BlendShapeTarget
+	{
+	protected:	// FIELDS
+
+		int				m_DeltasCount;
+		unsigned int*	m_pIndices;			// Sorted vertex indices
+
+		bool			m_bQuantized;
+		float*			m_pPositionDeltas;	// 4 floats per delta (when not quantized)
+		float*			m_pNormalDeltas;	// 4 floats per delta (when not quantized, optional)
+		short*			m_pQuantizedPositionDeltas;	// 4 shorts per delta (when quantized)
+		short*			m_pQuantizedNormalDeltas;	// 4 shorts per delta (when quantized, optional)
+		float			m_PositionScale;	// Dequantization scales
+		float			m_NormalScale;
+
+	public:		// PROPERTIES
+
+		int					GetDeltasCount() const	{ return m_DeltasCount; }
+		const unsigned int*	GetIndices() const		{ return m_pIndices; }
+		bool				IsQuantized() const		{ return m_bQuantized; }
+		bool				HasNormals() const		{ return m_pNormalDeltas != NULL || m_pQuantizedNormalDeltas != NULL; }
+		int					GetMemorySize() const;
+
+		// Gets the (dequantized) deltas of the given sparse entry
+		void	GetPositionDelta( int _DeltaIndex, float* _pDelta ) const;
+		void	GetNormalDelta( int _DeltaIndex, float* _pDelta ) const;
+
+	public:		// METHODS
+
+		// Builds the sparse target from dense deltas (3 floats per vertex)
+		//	_pNormalDeltas, can be NULL
+		//	_Threshold, vertices whose position & normal deltas are all below that value are not stored
+		BlendShapeTarget( const float* _pPositionDeltas, const float* _pNormalDeltas, int _VerticesCount, float _Threshold, bool _bQuantize );
+		~BlendShapeTarget();
+
+		// Accumulates the weighted deltas of the vertices in [_StartVertex,_EndVertex[ into the packed positions & normals (3 floats per vertex)
+		//	_pNormals, can be NULL
+		//	_VerticesCount, the total amount of vertices in the buffers
+		void	Apply( float _Weight, float* _pPositions, float* _pNormals, int _VerticesCount, int _StartVertex, int _EndVertex ) const;
+
+		// Accumulates several weighted targets, skipping the ones with a 0 weight
+		static void	Apply( const BlendShapeTarget* const* _ppTargets, const float* _pWeights, int _TargetsCount, float* _pPositions, float* _pNormals, int _VerticesCount, int _StartVertex, int _EndVertex );
+
+	protected:
+
+		// Finds the first delta whose vertex index is not below the given vertex
+		int		FindFirstDelta( int _VertexIndex ) const;
+
+	private:
+		BlendShapeTarget( const BlendShapeTarget& );
+		BlendShapeTarget&	operator=( const BlendShapeTarget& );
+	};
+}
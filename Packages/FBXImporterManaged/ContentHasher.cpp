@@ -0,0 +1,153 @@
+// Native streaming 128-bit hash
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <string.h>
+#include <math.h>
+#include "ContentHasher.h"
+
+using namespace	FBXImporter;
+
+static const unsigned __int64	C1 = 0x87C37B91114253D5ULL;
+static const unsigned __int64	C2 = 0x4CF5AD432745937FULL;
+
+static inline unsigned __int64	RotateLeft( unsigned __int64 _Value, int _Bits )
+{
+	return	(_Value << _Bits) | (_Value >> (64 - _Bits));
+}
+
+static inline unsigned __int64	FinalMix( unsigned __int64 _Value )
+{
+	_Value ^= _Value >> 33;
+	_Value *= 0xFF51AFD7ED558CCDULL;
+	_Value ^= _Value >> 33;
+	_Value *= 0xC4CEB9FE1A85EC53ULL;
+	_Value ^= _Value >> 33;
+	return	_Value;
+}
+
+ContentHasher::ContentHasher( unsigned int _Seed ) : m_H1( _Seed ), m_H2( _Seed ), m_TailSize( 0 ), m_TotalSize( 0 )
+{
+}
+
+void	ContentHasher::Append( const void* _pData, int _Size )
+{
+	const unsigned char*	pData = reinterpret_cast<const unsigned char*>( _pData );
+	m_TotalSize += _Size;
+
+	// Complete the pending block first
+	if ( m_TailSize > 0 )
+	{
+		int	Count = 16 - m_TailSize < _Size ? 16 - m_TailSize : _Size;
+		memcpy( m_pTail + m_TailSize, pData, Count );
+		m_TailSize += Count;
+		pData += Count;
+		_Size -= Count;
+
+		if ( m_TailSize < 16 )
+			return;
+
+		MixBlock( m_pTail );
+		m_TailSize = 0;
+	}
+
+	// Mix full blocks directly from the source
+	for ( ; _Size >= 16; pData+=16, _Size-=16 )
+		MixBlock( pData );
+
+	// Keep the remainder for later
+	memcpy( m_pTail, pData, _Size );
+	m_TailSize = _Size;
+}
+
+void	ContentHasher::AppendFloat( float _Value )
+{
+	if ( _Value == 0.0f )
+		_Value = 0.0f;	// Collapse -0 into +0
+	Append( &_Value, sizeof(float) );
+}
+
+void	ContentHasher::AppendFloats( const float* _pValues, int _Count )
+{
+	for ( int ValueIndex=0; ValueIndex < _Count; ValueIndex++ )
+		AppendFloat( _pValues[ValueIndex] );
+}
+
+void	ContentHasher::AppendQuantizedPositions( const float* _pPositions, int _Count, const float _pReference[3], float _Step )
+{
+	float	InvStep = 1.0f / _Step;		// Exact since the step is a power of 2
+	int		pCells[3*64];
+	for ( int Start=0; Start < _Count; Start+=64 )
+	{
+		int	Count = _Count - Start < 64 ? _Count - Start : 64;
+		const float*	pPosition = _pPositions + 3*Start;
+		for ( int ComponentIndex=0; ComponentIndex < 3*Count; ComponentIndex++ )
+			pCells[ComponentIndex] = (int) floorf( (pPosition[ComponentIndex] - _pReference[ComponentIndex % 3]) * InvStep + 0.5f );
+
+		Append( pCells, 3 * Count * sizeof(int) );
+	}
+}
+
+Hash128	ContentHasher::GetHash() const
+{
+	unsigned __int64	H1 = m_H1;
+	unsigned __int64	H2 = m_H2;
+
+	// Mix the tail bytes
+	unsigned __int64	K1 = 0;
+	unsigned __int64	K2 = 0;
+	for ( int ByteIndex=m_TailSize-1; ByteIndex >= 8; ByteIndex-- )
+		K2 = (K2 << 8) | m_pTail[ByteIndex];
+	for ( int ByteIndex=(m_TailSize < 8 ? m_TailSize : 8)-1; ByteIndex >= 0; ByteIndex-- )
+		K1 = (K1 << 8) | m_pTail[ByteIndex];
+
+	if ( m_TailSize > 8 )
+	{
+		K2 *= C2; K2 = RotateLeft( K2, 33 ); K2 *= C1; H2 ^= K2;
+	}
+	if ( m_TailSize > 0 )
+	{
+		K1 *= C1; K1 = RotateLeft( K1, 31 ); K1 *= C2; H1 ^= K1;
+	}
+
+	// Finalize
+	H1 ^= m_TotalSize;
+	H2 ^= m_TotalSize;
+	H1 += H2;
+	H2 += H1;
+	H1 = FinalMix( H1 );
+	H2 = FinalMix( H2 );
+	H1 += H2;
+	H2 += H1;
+
+	Hash128	Result;
+	Result.Low = H1;
+	Result.High = H2;
+	return	Result;
+}
+
+float	ContentHasher::ComputeQuantizationStep( float _Extent, int _Bits )
+{
+	if ( !(_Extent > 0.0f) )
+		return	1.0f;	// Degenerate mesh, any step will do
+
+	int	Exponent = 0;
+	frexpf( _Extent, &Exponent );	// _Extent < 2^Exponent
+
+	return	ldexpf( 1.0f, Exponent - _Bits );
+}
+
+void	ContentHasher::MixBlock( const unsigned char* _pBlock )
+{
+	unsigned __int64	K1, K2;
+	memcpy( &K1, _pBlock, 8 );
+	memcpy( &K2, _pBlock + 8, 8 );
+
+	K1 *= C1; K1 = RotateLeft( K1, 31 ); K1 *= C2; m_H1 ^= K1;
+	m_H1 = RotateLeft( m_H1, 27 ); m_H1 += m_H2; m_H1 = m_H1 * 5 + 0x52DCE729;
+
+	K2 *= C2; K2 = RotateLeft( K2, 33 ); K2 *= C1; m_H2 ^= K2;
+	m_H2 = RotateLeft( m_H2, 31 ); m_H2 += m_H1; m_H2 = m_H2 * 5 + 0x38495AB5;
+}
@@ -0,0 +1,60 @@
+// Contains the native streaming 128-bit hash used to identify meshes with identical contents
+//
+#pragma once
+
+namespace FBXImporter
+{
+	// A 128-bit hash value
+	struct	Hash128
+	{
+		unsigned __int64	Low;
+		unsigned __int64	High;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A streaming 128-bit hash (MurmurHash3 x64 128-bit variant)
+	// Data can be appended in chunks of any size, the result only depends on the concatenation of all the appended bytes.
+	// Floats are appended with +0 & -0 collapsed so equal values always hash the same.
+	//
+	class	ContentHasher
+	{
+	protected:	// FIELDS
+
+		unsigned __int64	m_H1;
+		unsigned __int64	m_H2;
+		unsigned char		m_pTail[16];	// Bytes waiting for a full 16-byte block
+		int					m_TailSize;
+		unsigned __int64	m_TotalSize;
+
+	public:		// METHODS
+
+		ContentHasher( unsigned int _Seed );
+
+		void	Append( const void* _pData, int _Size );
+		void	AppendInt( int _Value )				{ Append( &_Value, sizeof(int) ); }
+		void	AppendFloat( float _Value );
+		void	AppendFloats( const float* _pValues, int _Count );
+
+		// Appends positions quantized on a grid relative to a reference point
+		//	_pPositions, 3 floats per position
+		//	_pReference, the point positions are made relative to (e.g. the minimum of their bounding box)
+		//	_Step, the size of a grid cell (see ComputeQuantizationStep())
+		void	AppendQuantizedPositions( const float* _pPositions, int _Count, const float _pReference[3], float _Step );
+
+		// Gets the hash of everything appended so far (more data can still be appended afterward)
+		Hash128	GetHash() const;
+
+		// Computes a power of 2 quantization step dividing the given extent into 2^(_Bits-1) to 2^_Bits cells
+		// Being a power of 2, the step is the same for 2 meshes whose extents only differ by rounding errors (unless right at a power of 2)
+		static float	ComputeQuantizationStep( float _Extent, int _Bits );
+
+	protected:
+
+		void	MixBlock( const unsigned char* _pBlock );
+
+	private:
+
+		ContentHasher( const ContentHasher& );
+		ContentHasher&	operator=( const ContentHasher& );
+	};
+}
@@ -0,0 +1,219 @@
+// Native FBX SDK scene builder
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include "FBXSceneBuilder.h"
+
+using namespace	FBXImporter;
+
+static KFbxLayerElement::EMappingMode	ConvertMapping( SourceLayerElement::MAPPING _Mapping )
+{
+	switch ( _Mapping )
+	{
+	case SourceLayerElement::MAPPING_BY_CONTROL_POINT:	return KFbxLayerElement::eBY_CONTROL_POINT;
+	case SourceLayerElement::MAPPING_BY_POLYGON_VERTEX:	return KFbxLayerElement::eBY_POLYGON_VERTEX;
+	case SourceLayerElement::MAPPING_BY_POLYGON:		return KFbxLayerElement::eBY_POLYGON;
+	}
+
+	return KFbxLayerElement::eALL_SAME;
+}
+
+static void	MakeValue( const float* _pValue, KFbxVector4& _Value )	{ _Value.Set( _pValue[0], _pValue[1], _pValue[2], 0.0 ); }
+static void	MakeValue( const float* _pValue, KFbxVector2& _Value )	{ _Value.Set( _pValue[0], _pValue[1] ); }
+static void	MakeValue( const float* _pValue, KFbxColor& _Value )	{ _Value.Set( _pValue[0], _pValue[1], _pValue[2], _pValue[3] ); }
+
+// Fills the direct & index arrays of a layer element
+template<typename T> static void	FillElement( KFbxLayerElementTemplate<T>* _pElement, const SourceLayerElement& _Element, const float* _pValues, const int* _pIndices )
+{
+	_pElement->SetMappingMode( ConvertMapping( _Element.Mapping ) );
+	_pElement->SetReferenceMode( _Element.Reference == SourceLayerElement::REFERENCE_DIRECT ? KFbxLayerElement::eDIRECT : KFbxLayerElement::eINDEX_TO_DIRECT );
+
+	KFbxLayerElementArrayTemplate<T>&	Values = _pElement->GetDirectArray();
+	T									Value;
+	for ( int ValueIndex=0; ValueIndex < _Element.ValuesCount; ValueIndex++, _pValues += _Element.ComponentsCount )
+	{
+		MakeValue( _pValues, Value );
+		Values.Add( Value );
+	}
+
+	if ( _Element.Reference == SourceLayerElement::REFERENCE_DIRECT )
+		return;
+
+	KFbxLayerElementArrayTemplate<int>&	Indices = _pElement->GetIndexArray();
+	for ( int Index=0; Index < _Element.IndicesCount; Index++ )
+		Indices.Add( _pIndices[Index] );
+}
+
+void	FBXSceneBuilder::Build( const SceneSource& _Source, KFbxScene* _pScene )
+{
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Create the materials
+	int						MaterialsCount = _Source.GetMaterialsCount();
+	KFbxSurfacePhong**		ppMaterials = new KFbxSurfacePhong*[MaterialsCount > 0 ? MaterialsCount : 1];
+	for ( int MaterialIndex=0; MaterialIndex < MaterialsCount; MaterialIndex++ )
+	{
+		SourceMaterial	Material;
+		_Source.GetMaterial( MaterialIndex, Material );
+
+		KFbxSurfacePhong*	pPhong = KFbxSurfacePhong::Create( _pScene, Material.pName );
+		pPhong->GetDiffuseColor().Set( fbxDouble3( Material.DiffuseColor[0], Material.DiffuseColor[1], Material.DiffuseColor[2] ) );
+		pPhong->GetDiffuseFactor().Set( Material.DiffuseFactor );
+		pPhong->GetEmissiveColor().Set( fbxDouble3( Material.EmissiveColor[0], Material.EmissiveColor[1], Material.EmissiveColor[2] ) );
+		pPhong->GetEmissiveFactor().Set( Material.EmissiveFactor );
+		pPhong->GetSpecularColor().Set( fbxDouble3( Material.SpecularColor[0], Material.SpecularColor[1], Material.SpecularColor[2] ) );
+		pPhong->GetSpecularFactor().Set( Material.SpecularFactor );
+		pPhong->GetShininess().Set( Material.Shininess );
+		pPhong->GetTransparencyFactor().Set( 1.0 - Material.Opacity );
+		ppMaterials[MaterialIndex] = pPhong;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Create the nodes (parents are always listed before their children)
+	int			NodesCount = _Source.GetNodesCount();
+	KFbxNode**	ppNodes = new KFbxNode*[NodesCount > 0 ? NodesCount : 1];
+	for ( int NodeIndex=0; NodeIndex < NodesCount; NodeIndex++ )
+	{
+		SourceNode	Node;
+		_Source.GetNode( NodeIndex, Node );
+
+		KFbxNode*	pNode = NULL;
+		if ( Node.ParentIndex < 0 )
+			pNode = _pScene->GetRootNode();
+		else
+		{
+			pNode = KFbxNode::Create( _pScene, Node.pName );
+			ppNodes[Node.ParentIndex]->AddChild( pNode );
+
+			pNode->LclTranslation.Set( fbxDouble3( Node.Translation[0], Node.Translation[1], Node.Translation[2] ) );
+			pNode->LclRotation.Set( fbxDouble3( Node.Rotation[0], Node.Rotation[1], Node.Rotation[2] ) );
+			pNode->LclScaling.Set( fbxDouble3( Node.Scaling[0], Node.Scaling[1], Node.Scaling[2] ) );
+		}
+		ppNodes[NodeIndex] = pNode;
+
+		for ( int SlotIndex=0; SlotIndex < Node.MaterialsCount; SlotIndex++ )
+		{
+			int	MaterialIndex = _Source.GetNodeMaterial( NodeIndex, SlotIndex );
+			if ( MaterialIndex >= 0 )
+				pNode->AddMaterial( ppMaterials[MaterialIndex] );
+		}
+
+		if ( Node.Type == SourceNode::TYPE_MESH )
+			pNode->SetNodeAttribute( BuildMesh( _Source, NodeIndex, Node.pName, _pScene ) );
+	}
+
+	delete[] ppNodes;
+	delete[] ppMaterials;
+}
+
+KFbxMesh*	FBXSceneBuilder::BuildMesh( const SceneSource& _Source, int _NodeIndex, const char* _pName, KFbxScene* _pScene )
+{
+	SourceMesh	Mesh;
+	_Source.GetMesh( _NodeIndex, Mesh );
+
+	KFbxMesh*	pMesh = KFbxMesh::Create( _pScene, _pName );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Control points & polygons
+	float*	pPositions = new float[3*Mesh.ControlPointsCount+1];
+	_Source.GetControlPoints( _NodeIndex, pPositions );
+
+	pMesh->InitControlPoints( Mesh.ControlPointsCount );
+	KFbxVector4*	pControlPoints = pMesh->GetControlPoints();
+	for ( int VertexIndex=0; VertexIndex < Mesh.ControlPointsCount; VertexIndex++ )
+		pControlPoints[VertexIndex].Set( pPositions[3*VertexIndex+0], pPositions[3*VertexIndex+1], pPositions[3*VertexIndex+2] );
+	delete[] pPositions;
+
+	int*	pPolygonSizes = new int[Mesh.PolygonsCount+1];
+	int*	pPolygonVertices = new int[Mesh.PolygonVerticesCount+1];
+	_Source.GetPolygons( _NodeIndex, pPolygonSizes, pPolygonVertices );
+
+	const int*	pVertex = pPolygonVertices;
+	for ( int PolygonIndex=0; PolygonIndex < Mesh.PolygonsCount; PolygonIndex++ )
+	{
+		pMesh->BeginPolygon();
+		for ( int VertexIndex=0; VertexIndex < pPolygonSizes[PolygonIndex]; VertexIndex++ )
+			pMesh->AddPolygon( *pVertex++ );
+		pMesh->EndPolygon();
+	}
+	delete[] pPolygonVertices;
+	delete[] pPolygonSizes;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Layer elements (the channel of an element is the index of its layer)
+	for ( int ElementIndex=0; ElementIndex < Mesh.LayerElementsCount; ElementIndex++ )
+	{
+		SourceLayerElement	Element;
+		_Source.GetLayerElement( _NodeIndex, ElementIndex, Element );
+
+		float*	pValues = Element.ValuesCount > 0 ? new float[Element.ValuesCount * Element.ComponentsCount] : NULL;
+		int*	pIndices = Element.IndicesCount > 0 ? new int[Element.IndicesCount] : NULL;
+		_Source.GetLayerElementData( _NodeIndex, ElementIndex, pValues, pIndices );
+
+		while ( pMesh->GetLayerCount() <= Element.Channel )
+			pMesh->CreateLayer();
+		KFbxLayer*	pLayer = pMesh->GetLayer( Element.Channel );
+
+		switch ( Element.Type )
+		{
+		case SourceLayerElement::TYPE_NORMAL:
+			{
+				KFbxLayerElementNormal*	pNormals = KFbxLayerElementNormal::Create( pMesh, "" );
+				FillElement( pNormals, Element, pValues, pIndices );
+				pLayer->SetNormals( pNormals );
+			}
+			break;
+
+		case SourceLayerElement::TYPE_TANGENT:
+			{
+				KFbxLayerElementTangent*	pTangents = KFbxLayerElementTangent::Create( pMesh, "" );
+				FillElement( pTangents, Element, pValues, pIndices );
+				pLayer->SetTangents( pTangents );
+			}
+			break;
+
+		case SourceLayerElement::TYPE_BINORMAL:
+			{
+				KFbxLayerElementBinormal*	pBinormals = KFbxLayerElementBinormal::Create( pMesh, "" );
+				FillElement( pBinormals, Element, pValues, pIndices );
+				pLayer->SetBinormals( pBinormals );
+			}
+			break;
+
+		case SourceLayerElement::TYPE_UV:
+			{
+				KFbxLayerElementUV*	pUVs = KFbxLayerElementUV::Create( pMesh, "" );
+				FillElement( pUVs, Element, pValues, pIndices );
+				pLayer->SetUVs( pUVs, KFbxLayerElement::eDIFFUSE_TEXTURES );
+			}
+			break;
+
+		case SourceLayerElement::TYPE_VERTEX_COLOR:
+			{
+				KFbxLayerElementVertexColor*	pColors = KFbxLayerElementVertexColor::Create( pMesh, "" );
+				FillElement( pColors, Element, pValues, pIndices );
+				pLayer->SetVertexColors( pColors );
+			}
+			break;
+
+		case SourceLayerElement::TYPE_MATERIAL:
+			{	// Indices into the node's material slots
+				KFbxLayerElementMaterial*	pMaterials = KFbxLayerElementMaterial::Create( pMesh, "" );
+				pMaterials->SetMappingMode( ConvertMapping( Element.Mapping ) );
+				pMaterials->SetReferenceMode( KFbxLayerElement::eINDEX_TO_DIRECT );
+
+				KFbxLayerElementArrayTemplate<int>&	Indices = pMaterials->GetIndexArray();
+				for ( int Index=0; Index < Element.IndicesCount; Index++ )
+					Indices.Add( pIndices[Index] );
+				pLayer->SetMaterials( pMaterials );
+			}
+			break;
+		}
+
+		delete[] pIndices;
+		delete[] pValues;
+	}
+
+	return pMesh;
+}
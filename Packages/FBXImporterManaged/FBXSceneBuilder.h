@@ -0,0 +1,28 @@
+// Contains the builder of FBX SDK scenes from any scene source
+//
+#pragma once
+
+#include "SceneSource.h"
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Creates the nodes, meshes, layer elements & Phong materials of a scene source into an empty FBX SDK scene
+	// This lets files read by native parsers (e.g. OBJ or PLY) go through the regular scene reading path.
+	//
+	// The source's root node becomes the scene's root node, animation curves are ignored.
+	//
+	class	FBXSceneBuilder
+	{
+	public:		// METHODS
+
+		static void			Build( const SceneSource& _Source, KFbxScene* _pScene );
+
+	protected:
+
+		static KFbxMesh*	BuildMesh( const SceneSource& _Source, int _NodeIndex, const char* _pName, KFbxScene* _pScene );
+
+	private:
+		FBXSceneBuilder();
+	};
+}
@@ -0,0 +1,307 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "GeometryStreamer.h"
+#include "NodeMesh.h"
+#include "Scene.h"
+
+using namespace	FBXImporter;
+using namespace	System::Threading;
+
+GeometryStreamer::GeometryStreamer( Scene^ _Owner, ImportOptions^ _Options, VertexCacheReport^ _VertexCacheReport, VertexBufferReport^ _VertexBufferReport )
+	: m_Owner( _Owner ), m_Options( _Options ), m_VertexCacheReport( _VertexCacheReport ), m_VertexBufferReport( _VertexBufferReport )
+{
+	m_Meshes = gcnew List<NodeMesh^>();
+	m_SDKLock = gcnew Object();
+	m_bSDKAvailable = true;
+
+	m_ExtractedSizes = gcnew Dictionary<NodeMesh^,__int64>();
+	m_ReportedMeshes = gcnew Dictionary<NodeMesh^,bool>();
+	m_BudgetBytes = (__int64) _Options->GeometryBudgetMB << 20;
+	m_ExtractedBytes = 0;
+	m_AccessClock = 0;
+	m_ExtractionsCount = 0;
+	m_EvictionsCount = 0;
+	m_ExtractionMilliseconds = 0.0;
+
+	m_PrefetchQueue = gcnew Queue<NodeMesh^>();
+	m_BusyWorkersCount = 0;
+	m_bStopping = false;
+	m_Workers = nullptr;
+}
+
+GeometryStreamer::~GeometryStreamer()
+{
+	Shutdown( false );
+}
+
+void	GeometryStreamer::Prefetch( NodeMesh^ _Mesh )
+{
+	if ( _Mesh == nullptr || _Mesh->IsGeometryExtracted )
+		return;
+
+	Monitor::Enter( m_PrefetchQueue );
+	try
+	{
+		if ( m_bStopping )
+			return;
+
+		StartWorkers();
+		m_PrefetchQueue->Enqueue( _Mesh );
+		Monitor::PulseAll( m_PrefetchQueue );
+	}
+	finally
+	{
+		Monitor::Exit( m_PrefetchQueue );
+	}
+}
+
+void	GeometryStreamer::PrefetchAll()
+{
+	for ( int MeshIndex=0; MeshIndex < m_Meshes->Count; MeshIndex++ )
+		Prefetch( m_Meshes[MeshIndex] );
+}
+
+void	GeometryStreamer::WaitForPrefetch()
+{
+	Monitor::Enter( m_PrefetchQueue );
+	try
+	{
+		while ( !m_bStopping && (m_PrefetchQueue->Count > 0 || m_BusyWorkersCount > 0) )
+			Monitor::Wait( m_PrefetchQueue );
+	}
+	finally
+	{
+		Monitor::Exit( m_PrefetchQueue );
+	}
+}
+
+void	GeometryStreamer::Register( NodeMesh^ _Mesh )
+{
+	m_Meshes->Add( _Mesh );
+}
+
+void	GeometryStreamer::Acquire( NodeMesh^ _Mesh, bool _bEvict )
+{
+	_Mesh->m_LastAccess = Interlocked::Increment( m_AccessClock );
+	if ( _Mesh->IsGeometryExtracted )
+		return;
+
+	// Always lock the mesh before the SDK so we can't deadlock with a thread reading that mesh
+	Monitor::Enter( _Mesh );
+	Monitor::Enter( m_SDKLock );
+	try
+	{
+		// Extracted by another thread meanwhile, or read back by its own sub-objects while being extracted
+		if ( _Mesh->IsGeometryExtracted || _Mesh->IsExtractingGeometry() )
+			return;
+
+		Extract( _Mesh );
+		if ( _bEvict )
+			Evict( _Mesh );
+	}
+	finally
+	{
+		Monitor::Exit( m_SDKLock );
+		Monitor::Exit( _Mesh );
+	}
+}
+
+void	GeometryStreamer::Shutdown( bool _bExtractAll )
+{
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Stop the workers
+	Monitor::Enter( m_PrefetchQueue );
+	try
+	{
+		m_bStopping = true;
+		m_PrefetchQueue->Clear();
+		Monitor::PulseAll( m_PrefetchQueue );
+	}
+	finally
+	{
+		Monitor::Exit( m_PrefetchQueue );
+	}
+
+	if ( m_Workers != nullptr )
+		for ( int WorkerIndex=0; WorkerIndex < m_Workers->Length; WorkerIndex++ )
+			m_Workers[WorkerIndex]->Join();
+	m_Workers = nullptr;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Extract the remaining geometry while we still can
+	if ( _bExtractAll && m_bSDKAvailable )
+		for ( int MeshIndex=0; MeshIndex < m_Meshes->Count; MeshIndex++ )
+		{
+			try
+			{
+				Acquire( m_Meshes[MeshIndex], false );
+			}
+			catch ( Exception^ )
+			{	// The error will be thrown again when the mesh is accessed, don't prevent the scene from being destroyed
+			}
+		}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Forget about the SDK meshes
+	Monitor::Enter( m_SDKLock );
+	try
+	{
+		for ( int MeshIndex=0; MeshIndex < m_Meshes->Count; MeshIndex++ )
+			m_Meshes[MeshIndex]->ReleaseSDKMesh();
+		m_bSDKAvailable = false;
+	}
+	finally
+	{
+		Monitor::Exit( m_SDKLock );
+	}
+}
+
+void	GeometryStreamer::Extract( NodeMesh^ _Mesh )
+{
+	System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+
+	try
+	{
+		_Mesh->ExtractGeometry();
+
+		// Bones can be resolved right away since the hierarchy is complete
+		if ( _Mesh->Skin != nullptr )
+			_Mesh->Skin->ResolveBones( m_Owner );
+
+		// Apply the per-mesh processing stages in the same order as the scene does at load time
+		bool	bReport = !m_ReportedMeshes->ContainsKey( _Mesh );
+		if ( m_Options->GenerateTangentSpace )
+			_Mesh->GenerateTangentSpace();
+		if ( m_Options->OptimizeVertexCache )
+		{
+			VertexCacheReport::MeshEntry^	Entry = _Mesh->OptimizeVertexCache( m_Options->VertexCacheSize );
+			if ( m_VertexCacheReport != nullptr && bReport )
+				m_VertexCacheReport->AddEntry( Entry );
+		}
+		if ( m_Options->GenerateLODs )
+			_Mesh->GenerateLODs( m_Options->LODsCount, m_Options->LODReductionRatio, m_Options->LODMaxError, m_Options->LODNormalWeight, m_Options->LODUVWeight );
+		if ( m_Options->GenerateMeshlets )
+			_Mesh->GenerateMeshlets( m_Options->MeshletMaxVerticesCount, m_Options->MeshletMaxTrianglesCount );
+		if ( m_Options->EmitVertexBuffers )
+		{
+			VertexBufferReport::MeshEntry^	Entry = _Mesh->EmitVertexBuffer( m_Options->VertexLayout );
+			if ( m_VertexBufferReport != nullptr && bReport && Entry != nullptr )
+				m_VertexBufferReport->AddEntry( Entry );
+		}
+		if ( bReport )
+			m_ReportedMeshes->Add( _Mesh, true );
+	}
+	catch ( Exception^ )
+	{	// Don't keep half-processed geometry around, the next access will try again
+		_Mesh->ReleaseGeometry();
+		throw;
+	}
+
+	__int64	Size = _Mesh->EstimateGeometrySize();
+	m_ExtractedSizes[_Mesh] = Size;
+	m_ExtractedBytes += Size;
+
+	m_ExtractionsCount++;
+	m_ExtractionMilliseconds += Watch->Elapsed.TotalMilliseconds;
+}
+
+void	GeometryStreamer::Evict( NodeMesh^ _Keep )
+{
+	if ( m_BudgetBytes <= 0 || !m_bSDKAvailable )
+		return;
+
+	List<NodeMesh^>^	Busy = gcnew List<NodeMesh^>();
+	while ( m_ExtractedBytes > m_BudgetBytes )
+	{
+		// Find the least recently accessed mesh (access stamps are compared by difference so they can wrap around)
+		NodeMesh^	Oldest = nullptr;
+		for each ( KeyValuePair<NodeMesh^,__int64> Entry in m_ExtractedSizes )
+		{
+			NodeMesh^	Mesh = Entry.Key;
+			if ( Mesh == _Keep || Busy->Contains( Mesh ) )
+				continue;
+			if ( Oldest == nullptr || Mesh->m_LastAccess - Oldest->m_LastAccess < 0 )
+				Oldest = Mesh;
+		}
+		if ( Oldest == nullptr )
+			break;	// Everything else is being read
+
+		// Meshes currently being read by another thread are not "unused", skip them
+		if ( !Monitor::TryEnter( Oldest ) )
+		{
+			Busy->Add( Oldest );
+			continue;
+		}
+
+		try
+		{
+			m_ExtractedBytes -= m_ExtractedSizes[Oldest];
+			m_ExtractedSizes->Remove( Oldest );
+			Oldest->ReleaseGeometry();
+			m_EvictionsCount++;
+		}
+		finally
+		{
+			Monitor::Exit( Oldest );
+		}
+	}
+}
+
+void	GeometryStreamer::StartWorkers()
+{
+	if ( m_Workers != nullptr )
+		return;
+
+	m_Workers = gcnew cli::array<Thread^>( m_Options->PrefetchWorkersCount );
+	for ( int WorkerIndex=0; WorkerIndex < m_Workers->Length; WorkerIndex++ )
+	{
+		Thread^	Worker = gcnew Thread( gcnew ThreadStart( this, &GeometryStreamer::WorkerLoop ) );
+		Worker->Name = "FBX Geometry Prefetch #" + WorkerIndex;
+		Worker->IsBackground = true;
+		Worker->Start();
+		m_Workers[WorkerIndex] = Worker;
+	}
+}
+
+void	GeometryStreamer::WorkerLoop()
+{
+	while ( true )
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// 1] Wait for a mesh to extract
+		NodeMesh^	Mesh = nullptr;
+		Monitor::Enter( m_PrefetchQueue );
+		try
+		{
+			while ( m_PrefetchQueue->Count == 0 && !m_bStopping )
+				Monitor::Wait( m_PrefetchQueue );
+			if ( m_bStopping )
+				return;
+
+			Mesh = m_PrefetchQueue->Dequeue();
+			m_BusyWorkersCount++;
+		}
+		finally
+		{
+			Monitor::Exit( m_PrefetchQueue );
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// 2] Extract it unless the budget is already reached (prefetching never evicts anything)
+		try
+		{
+			if ( m_BudgetBytes <= 0 || m_ExtractedBytes < m_BudgetBytes )
+				Acquire( Mesh, false );
+		}
+		catch ( Exception^ )
+		{	// The error will be thrown again when the mesh is accessed
+		}
+
+		Monitor::Enter( m_PrefetchQueue );
+		m_BusyWorkersCount--;
+		Monitor::PulseAll( m_PrefetchQueue );
+		Monitor::Exit( m_PrefetchQueue );
+	}
+}
@@ -0,0 +1,164 @@
+// Contains the streamer extracting mesh geometry on demand when a scene is loaded progressively
+//
+#pragma managed
+#pragma once
+
+#include "ImportOptions.h"
+#include "VertexCacheReport.h"
+#include "VertexBufferReport.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	ref class	Scene;
+	ref class	NodeMesh;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Extracts the geometry of the meshes of a progressively loaded scene
+	// A mesh's geometry is extracted on first access to its geometry properties, or ahead of time by background workers serving a prefetch queue.
+	// The SDK is not thread-safe so extractions are serialized by a single lock: workers only hide the extraction latency from the caller.
+	// The per-mesh processing stages enabled in the import options (tangent space, vertex cache, LODs, meshlets & vertex buffers) are applied right after extraction.
+	//
+	// When the estimated size of the extracted geometry exceeds the budget, the least recently accessed meshes that are not being read are released
+	//	and extracted again on their next access. Prefetching never evicts anything, it simply stops extracting once the budget is reached.
+	// Arrays & objects obtained from a mesh before it got evicted stay valid for as long as the caller holds them.
+	//
+	// Once the SDK scene is destroyed, geometry that was not extracted can't be anymore and nothing is evicted.
+	//
+	public ref class		GeometryStreamer
+	{
+	protected:	// FIELDS
+
+		Scene^							m_Owner;
+		ImportOptions^					m_Options;				// The options the scene was loaded with
+		VertexCacheReport^				m_VertexCacheReport;	// The report optimized meshes are added to (null if vertex cache optimization is disabled)
+		VertexBufferReport^				m_VertexBufferReport;	// The report emitted vertex buffers are added to (null if vertex buffer emission is disabled)
+
+		List<NodeMesh^>^				m_Meshes;
+		Object^							m_SDKLock;				// Serializes SDK accesses & protects the fields below
+		bool							m_bSDKAvailable;
+
+		Dictionary<NodeMesh^,__int64>^	m_ExtractedSizes;		// Extracted meshes => estimated size of their geometry
+		Dictionary<NodeMesh^,bool>^		m_ReportedMeshes;		// Meshes already added to the reports (they're not added again when extracted after an eviction)
+		__int64							m_BudgetBytes;
+		__int64							m_ExtractedBytes;
+		int								m_AccessClock;
+		int								m_ExtractionsCount;
+		int								m_EvictionsCount;
+		double							m_ExtractionMilliseconds;
+
+		// Prefetch queue (the queue itself is used to lock the fields below)
+		Queue<NodeMesh^>^				m_PrefetchQueue;
+		int								m_BusyWorkersCount;
+		bool							m_bStopping;
+		cli::array<System::Threading::Thread^>^	m_Workers;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the scene the streamer extracts geometry for" )]
+		//
+		property Scene^					Owner
+		{
+			Scene^						get()	{ return m_Owner; }
+		}
+
+		[DescriptionAttribute( "Gets the amount of meshes whose geometry is currently extracted" )]
+		//
+		property int					ExtractedMeshesCount
+		{
+			int							get()	{ return m_ExtractedSizes->Count; }
+		}
+
+		[DescriptionAttribute( "Gets the estimated memory used by the extracted geometry (in bytes)" )]
+		//
+		property __int64				ExtractedBytes
+		{
+			__int64						get()	{ return m_ExtractedBytes; }
+		}
+
+		[DescriptionAttribute( "Gets the estimated memory above which extracted geometry gets evicted (in bytes, 0 for no limit)" )]
+		//
+		property __int64				BudgetBytes
+		{
+			__int64						get()	{ return m_BudgetBytes; }
+		}
+
+		[DescriptionAttribute( "Gets the amount of extractions performed so far (including extractions of evicted meshes)" )]
+		//
+		property int					ExtractionsCount
+		{
+			int							get()	{ return m_ExtractionsCount; }
+		}
+
+		[DescriptionAttribute( "Gets the amount of evictions performed so far" )]
+		//
+		property int					EvictionsCount
+		{
+			int							get()	{ return m_EvictionsCount; }
+		}
+
+		[DescriptionAttribute( "Gets the total time spent extracting geometry & applying the processing stages (in milliseconds)" )]
+		//
+		property double					ExtractionMilliseconds
+		{
+			double						get()	{ return m_ExtractionMilliseconds; }
+		}
+
+		[DescriptionAttribute( "Gets the amount of meshes waiting in the prefetch queue" )]
+		//
+		property int					PendingPrefetchCount
+		{
+			int							get()	{ return m_PrefetchQueue->Count; }
+		}
+
+		[DescriptionAttribute( "Tells if geometry can still be extracted (i.e. the SDK scene was not destroyed yet)" )]
+		//
+		property bool					IsSDKAvailable
+		{
+			bool						get()	{ return m_bSDKAvailable; }
+		}
+
+	public:		// METHODS
+
+		GeometryStreamer( Scene^ _Owner, ImportOptions^ _Options, VertexCacheReport^ _VertexCacheReport, VertexBufferReport^ _VertexBufferReport );
+		~GeometryStreamer();
+
+		// Queues a mesh for extraction by the background workers (does nothing if the mesh is already extracted)
+		void		Prefetch( NodeMesh^ _Mesh );
+
+		// Queues all the meshes that are not extracted yet
+		void		PrefetchAll();
+
+		// Waits until the prefetch queue is empty and the workers are idle
+		void		WaitForPrefetch();
+
+	internal:
+
+		// Registers a mesh whose geometry is extracted on demand
+		void		Register( NodeMesh^ _Mesh );
+
+		// Makes sure the geometry of a mesh is extracted, evicting the least recently used geometry if over budget
+		void		Acquire( NodeMesh^ _Mesh, bool _bEvict );
+
+		// Stops the workers and forgets about the SDK meshes before the SDK scene gets destroyed
+		//	_bExtractAll, extracts all the remaining geometry first so it stays available afterward
+		void		Shutdown( bool _bExtractAll );
+
+	protected:
+
+		// Extracts the geometry of a mesh and applies the processing stages (SDK lock must be held)
+		void		Extract( NodeMesh^ _Mesh );
+
+		// Releases the least recently used geometry until the extracted size fits the budget (SDK lock must be held)
+		void		Evict( NodeMesh^ _Keep );
+
+		// Starts the background workers on first prefetch
+		void		StartWorkers();
+
+		// The loop of a background worker
+		void		WorkerLoop();
+	};
+}
@@ -7,6 +7,9 @@
 using namespace System;
 using namespace System::Collections::Generic;
 
+#include "StringTable.h"
+#include "ImportStats.h"
+
 namespace FBXImporter
 {
 	//////////////////////////////////////////////////////////////////////////
@@ -52,9 +55,15 @@ namespace FBXImporter
 		//////////////////////////////////////////////////////////////////////////
 		// HELPER METHODS
 
+		// Converts a managed string into a native ANSI string
+		// NOTE: The returned string is allocated from the current MarshalArena and is released with it
 		static const char*		FromString( String^ _String )
 		{
-			return	(const char*) System::Runtime::InteropServices::Marshal::StringToHGlobalAnsi( _String ).ToPointer();
+			MarshalArena^	Arena = MarshalArena::Current;
+			if ( Arena == nullptr )
+				throw gcnew Exception( "Strings can only be converted to native strings within the scope of a MarshalArena !" );
+
+			return	Arena->FromString( _String );
 		}
 
 		static System::String^	GetString( KString* _pString )
@@ -62,11 +71,23 @@ namespace FBXImporter
 			return	GetString( _pString->Buffer() );
 		}
 
+		// Converts a native ANSI string into a managed string
+		// NOTE: If there is a current StringTable, the string is interned by that table
 		static System::String^	GetString( const char* _pString )
 		{
+			StringTable^	Table = StringTable::Current;
+			if ( Table != nullptr )
+				return	Table->GetString( _pString );
+
 			return	System::Runtime::InteropServices::Marshal::PtrToStringAnsi( System::IntPtr( (void*) _pString ) );
 		}
 
+		// Compares a managed string against a native ANSI string without allocating anything
+		static bool				StringEquals( String^ _String, const char* _pString )
+		{
+			return	StringTable::Matches( _String, _pString );
+		}
+
 		static WMath::Point2D^	ToPoint( fbxDouble2& _Value )
 		{
 			return gcnew WMath::Point2D( (float) _Value[0], (float) _Value[1] );
@@ -0,0 +1,479 @@
+// Contains the options driving the optional processing stages applied to a scene at import time
+//
+#pragma managed
+#pragma once
+
+#include "VertexBufferLayout.h"
+
+using namespace System;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Import options
+	// Every processing stage is disabled by default so a scene is imported as-is unless asked otherwise.
+	//
+	public ref class	ImportOptions
+	{
+	public:		// NESTED TYPES
+
+		// The axis systems the scenes can be converted into
+		enum class	TARGET_AXIS_SYSTEM
+		{
+			NONE,				// Keep the axis system of the file (default)
+			Z_UP_RIGHT_HANDED,	// 3ds Max, Maya Z-Up
+			Y_UP_RIGHT_HANDED,	// Maya Y-Up, OpenGL
+			Y_UP_LEFT_HANDED,	// Direct3D
+		};
+
+	protected:	// FIELDS
+
+		// Axis system conversion
+		TARGET_AXIS_SYSTEM	m_TargetAxisSystem;
+
+
+		// Animation compression
+		bool		m_bCompressAnimations;
+		float		m_AnimationSampleRate;
+		float		m_PositionTolerance;
+		float		m_RotationTolerance;
+		float		m_ScaleTolerance;
+
+		// Skinning
+		int			m_SkinInfluencesCount;
+
+		// Blend shapes
+		float		m_BlendShapeThreshold;
+		bool		m_bQuantizeBlendShapes;
+
+		// Tangent space generation
+		bool		m_bGenerateTangentSpace;
+
+		// Vertex cache optimization
+		bool		m_bOptimizeVertexCache;
+		int			m_VertexCacheSize;
+
+		// LOD generation
+		bool		m_bGenerateLODs;
+		int			m_LODsCount;
+		float		m_LODReductionRatio;
+		float		m_LODMaxError;
+		float		m_LODNormalWeight;
+		float		m_LODUVWeight;
+
+		// Meshlet generation
+		bool		m_bGenerateMeshlets;
+		int			m_MeshletMaxVerticesCount;
+		int			m_MeshletMaxTrianglesCount;
+
+		// Vertex buffer emission
+		bool				m_bEmitVertexBuffers;
+		VertexBufferLayout^	m_VertexLayout;
+
+		// Static batching
+		bool		m_bStaticBatching;
+		int			m_StaticBatchMaxVerticesCount;
+		float		m_StaticBatchCellSize;
+
+		// Progressive loading
+		bool		m_bProgressiveLoad;
+		int			m_GeometryBudgetMB;
+		int			m_PrefetchWorkersCount;
+
+		// Instancing
+		bool		m_bDetectInstances;
+		bool		m_bInstanceIgnoreTranslation;
+
+		// Detach mode
+		bool		m_bDetachFromSDK;
+
+		// OBJ & PLY parsing
+		int			m_MeshFileChunkSizeMB;
+		int			m_MeshFileWorkersCount;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets or sets the axis system every geometry, transform & animation is converted into whatever the axis system of the file (X-Up, Y-Up or Z-Up, left or right-handed). NONE (default) keeps the axis system of the file" )]
+		//
+		property TARGET_AXIS_SYSTEM	TargetAxisSystem
+		{
+			TARGET_AXIS_SYSTEM	get()	{ return m_TargetAxisSystem; }
+			void		set( TARGET_AXIS_SYSTEM _Value )	{ m_TargetAxisSystem = _Value; }
+		}
+
+		[DescriptionAttribute( "Enables the reduction & quantization of the nodes' P, R & S animation tracks" )]
+		//
+		property bool		CompressAnimations
+		{
+			bool		get()	{ return m_bCompressAnimations; }
+			void		set( bool _Value )	{ m_bCompressAnimations = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the rate (in samples per second) at which tracks are resampled before reduction" )]
+		//
+		property float		AnimationSampleRate
+		{
+			float		get()	{ return m_AnimationSampleRate; }
+			void		set( float _Value )
+			{
+				if ( _Value <= 0.0f )
+					throw gcnew Exception( "The animation sample rate must be strictly positive !" );
+				m_AnimationSampleRate = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum error allowed on position tracks (in scene units)" )]
+		//
+		property float		PositionTolerance
+		{
+			float		get()	{ return m_PositionTolerance; }
+			void		set( float _Value )	{ m_PositionTolerance = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum error allowed on rotation tracks (in the tracks' units, degrees for FBX files)" )]
+		//
+		property float		RotationTolerance
+		{
+			float		get()	{ return m_RotationTolerance; }
+			void		set( float _Value )	{ m_RotationTolerance = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum error allowed on scale tracks" )]
+		//
+		property float		ScaleTolerance
+		{
+			float		get()	{ return m_ScaleTolerance; }
+			void		set( float _Value )	{ m_ScaleTolerance = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum amount of bones influencing a skinned vertex (4 or 8)" )]
+		//
+		property int		SkinInfluencesCount
+		{
+			int			get()	{ return m_SkinInfluencesCount; }
+			void		set( int _Value )
+			{
+				if ( _Value != 4 && _Value != 8 )
+					throw gcnew Exception( "Skinned vertices can only be influenced by 4 or 8 bones !" );
+				m_SkinInfluencesCount = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Gets or sets the delta below which a vertex is considered not to be moved by a blend shape" )]
+		//
+		property float		BlendShapeThreshold
+		{
+			float		get()	{ return m_BlendShapeThreshold; }
+			void		set( float _Value )	{ m_BlendShapeThreshold = _Value; }
+		}
+
+		[DescriptionAttribute( "Stores blend shape deltas as 16-bit integers with a per-shape scale instead of floats" )]
+		//
+		property bool		QuantizeBlendShapes
+		{
+			bool		get()	{ return m_bQuantizeBlendShapes; }
+			void		set( bool _Value )	{ m_bQuantizeBlendShapes = _Value; }
+		}
+
+		[DescriptionAttribute( "Generates the missing normals (angle-weighted, split by smoothing groups) and the missing MikkTSpace tangents & binormals of every mesh" )]
+		//
+		property bool		GenerateTangentSpace
+		{
+			bool		get()	{ return m_bGenerateTangentSpace; }
+			void		set( bool _Value )	{ m_bGenerateTangentSpace = _Value; }
+		}
+
+		[DescriptionAttribute( "Reorders the triangles of each material for the post-transform vertex cache, then the control points by first use" )]
+		//
+		property bool		OptimizeVertexCache
+		{
+			bool		get()	{ return m_bOptimizeVertexCache; }
+			void		set( bool _Value )	{ m_bOptimizeVertexCache = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the size (in vertices) of the vertex cache the triangles are optimized for" )]
+		//
+		property int		VertexCacheSize
+		{
+			int			get()	{ return m_VertexCacheSize; }
+			void		set( int _Value )
+			{
+				if ( _Value < 4 || _Value > 64 )
+					throw gcnew Exception( "The vertex cache size must be in [4,64] !" );
+				m_VertexCacheSize = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Generates a chain of simplified LODs for every mesh" )]
+		//
+		property bool		GenerateLODs
+		{
+			bool		get()	{ return m_bGenerateLODs; }
+			void		set( bool _Value )	{ m_bGenerateLODs = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum amount of LODs generated for each mesh (not counting the mesh itself)" )]
+		//
+		property int		LODsCount
+		{
+			int			get()	{ return m_LODsCount; }
+			void		set( int _Value )
+			{
+				if ( _Value < 1 )
+					throw gcnew Exception( "At least one LOD must be generated !" );
+				m_LODsCount = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Gets or sets the ratio of triangles each LOD keeps from the previous one" )]
+		//
+		property float		LODReductionRatio
+		{
+			float		get()	{ return m_LODReductionRatio; }
+			void		set( float _Value )
+			{
+				if ( _Value <= 0.0f || _Value >= 1.0f )
+					throw gcnew Exception( "The LOD reduction ratio must be in ]0,1[ !" );
+				m_LODReductionRatio = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum geometric error of a LOD, relative to the size of its mesh" )]
+		//
+		property float		LODMaxError
+		{
+			float		get()	{ return m_LODMaxError; }
+			void		set( float _Value )	{ m_LODMaxError = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the weight of normal deviations in the simplification error (0 to ignore normals)" )]
+		//
+		property float		LODNormalWeight
+		{
+			float		get()	{ return m_LODNormalWeight; }
+			void		set( float _Value )	{ m_LODNormalWeight = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the weight of UV deviations in the simplification error (0 to ignore UVs)" )]
+		//
+		property float		LODUVWeight
+		{
+			float		get()	{ return m_LODUVWeight; }
+			void		set( float _Value )	{ m_LODUVWeight = _Value; }
+		}
+
+		[DescriptionAttribute( "Splits every mesh into meshlets with bounding spheres & normal cones for cluster culling" )]
+		//
+		property bool		GenerateMeshlets
+		{
+			bool		get()	{ return m_bGenerateMeshlets; }
+			void		set( bool _Value )	{ m_bGenerateMeshlets = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum amount of vertices in a meshlet" )]
+		//
+		property int		MeshletMaxVerticesCount
+		{
+			int			get()	{ return m_MeshletMaxVerticesCount; }
+			void		set( int _Value )
+			{
+				if ( _Value < 3 || _Value > 255 )
+					throw gcnew Exception( "The maximum amount of meshlet vertices must be in [3,255] !" );
+				m_MeshletMaxVerticesCount = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum amount of triangles in a meshlet" )]
+		//
+		property int		MeshletMaxTrianglesCount
+		{
+			int			get()	{ return m_MeshletMaxTrianglesCount; }
+			void		set( int _Value )
+			{
+				if ( _Value < 1 || _Value > 512 )
+					throw gcnew Exception( "The maximum amount of meshlet triangles must be in [1,512] !" );
+				m_MeshletMaxTrianglesCount = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Emits the final vertex & index buffers of every mesh in the formats of the VertexLayout (see NodeMesh::VertexBuffers)" )]
+		//
+		property bool		EmitVertexBuffers
+		{
+			bool		get()	{ return m_bEmitVertexBuffers; }
+			void		set( bool _Value )	{ m_bEmitVertexBuffers = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the attributes, formats & streams of the emitted vertex buffers" )]
+		//
+		property VertexBufferLayout^	VertexLayout
+		{
+			VertexBufferLayout^	get()	{ return m_VertexLayout; }
+			void		set( VertexBufferLayout^ _Value )
+			{
+				if ( _Value == nullptr || _Value->Attributes->Length == 0 )
+					throw gcnew Exception( "The vertex layout must have at least one attribute !" );
+				m_VertexLayout = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Merges the static meshes sharing a material & a spatial cell into batches pre-transformed in cell space & encoded in the formats of the VertexLayout (ignored when loading progressively)" )]
+		//
+		property bool		StaticBatching
+		{
+			bool		get()	{ return m_bStaticBatching; }
+			void		set( bool _Value )	{ m_bStaticBatching = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum amount of vertices in a static batch (batches of at most 65536 vertices use 16-bit indices)" )]
+		//
+		property int		StaticBatchMaxVerticesCount
+		{
+			int			get()	{ return m_StaticBatchMaxVerticesCount; }
+			void		set( int _Value )
+			{
+				if ( _Value < 3 )
+					throw gcnew Exception( "The maximum amount of static batch vertices must be at least 3 !" );
+				m_StaticBatchMaxVerticesCount = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Gets or sets the size of the cubic cells static meshes are grouped by, in scene units (meshes belong to the cell containing the center of their world bounding box, default is 50m for scenes in centimeters)" )]
+		//
+		property float		StaticBatchCellSize
+		{
+			float		get()	{ return m_StaticBatchCellSize; }
+			void		set( float _Value )
+			{
+				if ( _Value <= 0.0f )
+					throw gcnew Exception( "The static batch cell size must be strictly positive !" );
+				m_StaticBatchCellSize = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Only reads the hierarchy, transforms, bounding boxes & materials at load time, mesh geometry being extracted on first access or through the scene's GeometryStreamer" )]
+		//
+		property bool		ProgressiveLoad
+		{
+			bool		get()	{ return m_bProgressiveLoad; }
+			void		set( bool _Value )	{ m_bProgressiveLoad = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the estimated amount of extracted geometry (in MB) above which the least recently used meshes are released (0 for no limit)" )]
+		//
+		property int		GeometryBudgetMB
+		{
+			int			get()	{ return m_GeometryBudgetMB; }
+			void		set( int _Value )
+			{
+				if ( _Value < 0 )
+					throw gcnew Exception( "The geometry budget must be positive or 0 for no limit !" );
+				m_GeometryBudgetMB = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Gets or sets the amount of background threads serving the geometry prefetch queue" )]
+		//
+		property int		PrefetchWorkersCount
+		{
+			int			get()	{ return m_PrefetchWorkersCount; }
+			void		set( int _Value )
+			{
+				if ( _Value < 1 || _Value > 16 )
+					throw gcnew Exception( "The amount of prefetch workers must be in [1,16] !" );
+				m_PrefetchWorkersCount = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Collapses meshes with identical contents (positions, indices & every layer element) into a single geometry shared by all their nodes" )]
+		//
+		property bool		DetectInstances
+		{
+			bool		get()	{ return m_bDetectInstances; }
+			void		set( bool _Value )	{ m_bDetectInstances = _Value; }
+		}
+
+		[DescriptionAttribute( "Also detects meshes only differing by a translation of their vertices as instances, the translation being moved to their pivot (vertices must match within the quantization step of the hash, about 2^-20 of the mesh extent)" )]
+		//
+		property bool		InstanceIgnoreTranslation
+		{
+			bool		get()	{ return m_bInstanceIgnoreTranslation; }
+			void		set( bool _Value )	{ m_bInstanceIgnoreTranslation = _Value; }
+		}
+
+		[DescriptionAttribute( "Extracts everything at the end of the load then destroys the SDK scene & returns the SDK manager to the pool so only the extracted data remains in memory (see Scene::Detach())" )]
+		//
+		property bool		DetachFromSDK
+		{
+			bool		get()	{ return m_bDetachFromSDK; }
+			void		set( bool _Value )	{ m_bDetachFromSDK = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the size (in MB) of the chunks OBJ & PLY files are split into for parsing" )]
+		//
+		property int		MeshFileChunkSizeMB
+		{
+			int			get()	{ return m_MeshFileChunkSizeMB; }
+			void		set( int _Value )
+			{
+				if ( _Value < 1 || _Value > 256 )
+					throw gcnew Exception( "The chunk size must be in [1,256] MB !" );
+				m_MeshFileChunkSizeMB = _Value;
+			}
+		}
+
+		[DescriptionAttribute( "Gets or sets the amount of OBJ & PLY chunks parsed concurrently (0 for the amount of processors), which bounds the parser's working memory to about that many chunks" )]
+		//
+		property int		MeshFileWorkersCount
+		{
+			int			get()	{ return m_MeshFileWorkersCount; }
+			void		set( int _Value )
+			{
+				if ( _Value < 0 || _Value > 64 )
+					throw gcnew Exception( "The amount of mesh file workers must be in [0,64] !" );
+				m_MeshFileWorkersCount = _Value;
+			}
+		}
+
+	public:		// METHODS
+
+		ImportOptions()
+		{
+			m_TargetAxisSystem = TARGET_AXIS_SYSTEM::NONE;
+			m_bCompressAnimations = false;
+			m_AnimationSampleRate = 30.0f;
+			m_PositionTolerance = 1e-3f;
+			m_RotationTolerance = 0.05f;
+			m_ScaleTolerance = 1e-3f;
+			m_SkinInfluencesCount = 4;
+			m_BlendShapeThreshold = 1e-6f;
+			m_bQuantizeBlendShapes = false;
+			m_bGenerateTangentSpace = false;
+			m_bOptimizeVertexCache = false;
+			m_VertexCacheSize = 32;
+			m_bGenerateLODs = false;
+			m_LODsCount = 3;
+			m_LODReductionRatio = 0.5f;
+			m_LODMaxError = 0.05f;
+			m_LODNormalWeight = 0.5f;
+			m_LODUVWeight = 0.5f;
+			m_bGenerateMeshlets = false;
+			m_MeshletMaxVerticesCount = 64;
+			m_MeshletMaxTrianglesCount = 124;
+			m_bEmitVertexBuffers = false;
+			m_VertexLayout = VertexBufferLayout::Default;
+			m_bStaticBatching = false;
+			m_StaticBatchMaxVerticesCount = 65536;
+			m_StaticBatchCellSize = 5000.0f;
+			m_bProgressiveLoad = false;
+			m_GeometryBudgetMB = 0;
+			m_PrefetchWorkersCount = 1;
+			m_bDetectInstances = false;
+			m_bInstanceIgnoreTranslation = true;
+			m_bDetachFromSDK = false;
+			m_MeshFileChunkSizeMB = 8;
+			m_MeshFileWorkersCount = 0;
+		}
+	};
+}
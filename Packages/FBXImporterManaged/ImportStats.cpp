@@ -0,0 +1,345 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "ImportStats.h"
+
+using namespace	FBXImporter;
+using namespace	System::Threading;
+
+ImportStats::ImportStats()
+{
+	m_Lock = gcnew Object();
+	m_StartTicks = System::Diagnostics::Stopwatch::GetTimestamp();
+	m_RootTicks = 0;
+
+	m_Stages = gcnew List<Entry^>();
+	m_Name2Stage = gcnew Dictionary<String^,Entry^>();
+	m_Items = gcnew List<Entry^>();
+	m_Name2Item = gcnew Dictionary<String^,Entry^>();
+	m_Totals = gcnew cli::array<__int64>( (int) COUNTER::COUNT );
+
+	m_Events = gcnew List<TraceEvent>();
+	m_SkippedProperties = gcnew List<String^>();
+}
+
+cli::array<ImportStats::Entry^>^	ImportStats::Stages::get()
+{
+	Monitor::Enter( m_Lock );
+	try
+	{
+		return m_Stages->ToArray();
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+}
+
+cli::array<ImportStats::Entry^>^	ImportStats::Items::get()
+{
+	Monitor::Enter( m_Lock );
+	try
+	{
+		return m_Items->ToArray();
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+}
+
+cli::array<String^>^	ImportStats::SkippedProperties::get()
+{
+	Monitor::Enter( m_Lock );
+	try
+	{
+		return m_SkippedProperties->ToArray();
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+}
+
+__int64	ImportStats::GetTotal( COUNTER _Counter )
+{
+	Monitor::Enter( m_Lock );
+	try
+	{
+		return m_Totals[(int) _Counter];
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+}
+
+ImportStats::Entry^	ImportStats::FindStage( String^ _Name )
+{
+	Monitor::Enter( m_Lock );
+	try
+	{
+		Entry^	Result = nullptr;
+		m_Name2Stage->TryGetValue( _Name, Result );
+		return Result;
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+}
+
+ImportStats::Entry^	ImportStats::FindItem( String^ _Name )
+{
+	Monitor::Enter( m_Lock );
+	try
+	{
+		Entry^	Result = nullptr;
+		m_Name2Item->TryGetValue( _Name, Result );
+		return Result;
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+}
+
+void	ImportStats::RecordScope( String^ _Name, String^ _ItemName, __int64 _StartTicks, __int64 _DurationTicks, cli::array<__int64>^ _Counters, cli::array<__int64>^ _InclusiveCounters, bool _bRoot )
+{
+	double	Milliseconds = TicksToMilliseconds( _DurationTicks );
+
+	Monitor::Enter( m_Lock );
+	try
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// 1] Accumulate into the stage
+		Entry^	Stage = nullptr;
+		if ( !m_Name2Stage->TryGetValue( _Name, Stage ) )
+		{
+			Stage = gcnew Entry( _Name );
+			m_Stages->Add( Stage );
+			m_Name2Stage->Add( _Name, Stage );
+		}
+
+		Stage->CallsCount++;
+		Stage->TotalMilliseconds += Milliseconds;
+		Stage->MaxMilliseconds = Math::Max( Stage->MaxMilliseconds, Milliseconds );
+		for ( int CounterIndex=0; CounterIndex < (int) COUNTER::COUNT; CounterIndex++ )
+		{
+			Stage->Counters[CounterIndex] += _Counters[CounterIndex];
+			m_Totals[CounterIndex] += _Counters[CounterIndex];
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// 2] Accumulate into the item
+		if ( _ItemName != nullptr )
+		{
+			Entry^	Item = nullptr;
+			if ( !m_Name2Item->TryGetValue( _ItemName, Item ) )
+			{
+				Item = gcnew Entry( _ItemName );
+				m_Items->Add( Item );
+				m_Name2Item->Add( _ItemName, Item );
+			}
+
+			Item->CallsCount++;
+			Item->TotalMilliseconds += Milliseconds;
+			Item->MaxMilliseconds = Math::Max( Item->MaxMilliseconds, Milliseconds );
+			for ( int CounterIndex=0; CounterIndex < (int) COUNTER::COUNT; CounterIndex++ )
+				Item->Counters[CounterIndex] += _InclusiveCounters[CounterIndex];
+		}
+
+		if ( _bRoot )
+			m_RootTicks += _DurationTicks;
+
+		//////////////////////////////////////////////////////////////////////////
+		// 3] Keep the event for the trace
+		TraceEvent	Event;
+		Event.Name = _Name;
+		Event.ItemName = _ItemName;
+		Event.ThreadID = Thread::CurrentThread->ManagedThreadId;
+		Event.StartTicks = _StartTicks - m_StartTicks;
+		Event.DurationTicks = _DurationTicks;
+		Event.Counters = _Counters;
+		m_Events->Add( Event );
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+}
+
+void	ImportStats::RecordSkippedProperty( String^ _ObjectName, String^ _PropertyName, String^ _Reason )
+{
+	Monitor::Enter( m_Lock );
+	try
+	{
+		m_SkippedProperties->Add( _ObjectName + "." + _PropertyName + ": " + _Reason );
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+}
+
+void	ImportStats::ExportChromeTrace( String^ _FileName )
+{
+	cli::array<String^>^	CounterNames = gcnew cli::array<String^> { "objectsAllocated", "elementsConverted", "bytesProduced", "triangles" };
+	double					TicksToMicroseconds = 1e6 / System::Diagnostics::Stopwatch::Frequency;
+	System::Globalization::CultureInfo^	Invariant = System::Globalization::CultureInfo::InvariantCulture;
+
+	System::Text::StringBuilder^	JSON = gcnew System::Text::StringBuilder();
+	JSON->Append( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+
+	Monitor::Enter( m_Lock );
+	try
+	{
+		for ( int EventIndex=0; EventIndex < m_Events->Count; EventIndex++ )
+		{
+			TraceEvent	Event = m_Events[EventIndex];
+
+			// Complete events ("X") carry both their start & duration
+			JSON->Append( "{\"name\":" );
+			AppendJSONString( JSON, Event.Name );
+			JSON->Append( ",\"cat\":\"FBXImporter\",\"ph\":\"X\",\"pid\":1,\"tid\":" );
+			JSON->Append( Event.ThreadID );
+			JSON->Append( ",\"ts\":" );
+			JSON->Append( (Event.StartTicks * TicksToMicroseconds).ToString( "F3", Invariant ) );
+			JSON->Append( ",\"dur\":" );
+			JSON->Append( (Event.DurationTicks * TicksToMicroseconds).ToString( "F3", Invariant ) );
+
+			JSON->Append( ",\"args\":{" );
+			bool	bFirstArg = true;
+			if ( Event.ItemName != nullptr )
+			{
+				JSON->Append( "\"item\":" );
+				AppendJSONString( JSON, Event.ItemName );
+				bFirstArg = false;
+			}
+			for ( int CounterIndex=0; CounterIndex < (int) COUNTER::COUNT; CounterIndex++ )
+			{
+				if ( Event.Counters[CounterIndex] == 0 )
+					continue;
+
+				JSON->Append( bFirstArg ? "\"" : ",\"" );
+				JSON->Append( CounterNames[CounterIndex] );
+				JSON->Append( "\":" );
+				JSON->Append( Event.Counters[CounterIndex] );
+				bFirstArg = false;
+			}
+			JSON->Append( "}}" );
+			JSON->Append( EventIndex < m_Events->Count-1 ? ",\n" : "\n" );
+		}
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+
+	JSON->Append( "]}\n" );
+
+	System::IO::File::WriteAllText( _FileName, JSON->ToString() );
+}
+
+String^	ImportStats::ToString()
+{
+	System::Text::StringBuilder^	Result = gcnew System::Text::StringBuilder();
+
+	Monitor::Enter( m_Lock );
+	try
+	{
+		Result->AppendFormat( "Import took {0:F1} ms, {1} objects allocated, {2} elements converted, {3} bytes produced, {4} triangles\n", TotalMilliseconds, m_Totals[0], m_Totals[1], m_Totals[2], m_Totals[3] );
+
+		Result->Append( "Stages:\n" );
+		for each ( Entry^ E in m_Stages )
+			Result->AppendFormat( "  {0}\tx{1}\t{2:F2} ms\tmax {3:F2} ms\tobjects {4}\telements {5}\tbytes {6}\ttriangles {7}\n", E->Name, E->CallsCount, E->TotalMilliseconds, E->MaxMilliseconds, E->Counters[0], E->Counters[1], E->Counters[2], E->Counters[3] );
+
+		if ( m_Items->Count > 0 )
+			Result->Append( "Items:\n" );
+		for each ( Entry^ E in m_Items )
+			Result->AppendFormat( "  {0}\t{1:F2} ms\tobjects {2}\telements {3}\tbytes {4}\ttriangles {5}\n", E->Name, E->TotalMilliseconds, E->Counters[0], E->Counters[1], E->Counters[2], E->Counters[3] );
+
+		if ( m_SkippedProperties->Count > 0 )
+			Result->Append( "Skipped properties:\n" );
+		for each ( String^ SkippedProperty in m_SkippedProperties )
+			Result->AppendFormat( "  {0}\n", SkippedProperty );
+	}
+	finally
+	{
+		Monitor::Exit( m_Lock );
+	}
+
+	return	Result->ToString();
+}
+
+void	ImportStats::AppendJSONString( System::Text::StringBuilder^ _Builder, String^ _Value )
+{
+	_Builder->Append( '"' );
+	for ( int CharIndex=0; CharIndex < _Value->Length; CharIndex++ )
+	{
+		wchar_t	C = _Value[CharIndex];
+		switch ( C )
+		{
+		case '"':	_Builder->Append( "\\\"" ); break;
+		case '\\':	_Builder->Append( "\\\\" ); break;
+		case '\n':	_Builder->Append( "\\n" ); break;
+		case '\r':	_Builder->Append( "\\r" ); break;
+		case '\t':	_Builder->Append( "\\t" ); break;
+		default:
+			if ( C < 0x20 )
+				_Builder->AppendFormat( "\\u{0:X4}", (int) C );
+			else
+				_Builder->Append( C );
+			break;
+		}
+	}
+	_Builder->Append( '"' );
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// ProfileScope
+ProfileScope::ProfileScope( String^ _Name, String^ _ItemName )
+{
+	m_Stats = ImportStats::Current;
+	if ( m_Stats == nullptr )
+		return;
+
+	m_Name = _Name;
+	m_ItemName = _ItemName;
+	m_Counters = gcnew cli::array<__int64>( (int) ImportStats::COUNTER::COUNT );
+	m_InclusiveCounters = gcnew cli::array<__int64>( (int) ImportStats::COUNTER::COUNT );
+
+	m_Parent = ms_Current;
+	ms_Current = this;
+
+	m_StartTicks = System::Diagnostics::Stopwatch::GetTimestamp();
+}
+
+ProfileScope::~ProfileScope()
+{
+	if ( m_Stats == nullptr )
+		return;
+
+	__int64	DurationTicks = System::Diagnostics::Stopwatch::GetTimestamp() - m_StartTicks;
+	ms_Current = m_Parent;
+
+	// Items collect the counters of all their nested scopes
+	for ( int CounterIndex=0; CounterIndex < (int) ImportStats::COUNTER::COUNT; CounterIndex++ )
+	{
+		m_InclusiveCounters[CounterIndex] += m_Counters[CounterIndex];
+		if ( m_Parent != nullptr )
+			m_Parent->m_InclusiveCounters[CounterIndex] += m_InclusiveCounters[CounterIndex];
+	}
+
+	m_Stats->RecordScope( m_Name, m_ItemName, m_StartTicks, DurationTicks, m_Counters, m_InclusiveCounters, m_Parent == nullptr );
+	m_Stats = nullptr;
+}
+
+void	ProfileScope::Count( ImportStats::COUNTER _Counter, __int64 _Amount )
+{
+	ProfileScope^	Scope = ms_Current;
+	if ( Scope != nullptr )
+		Scope->m_Counters[(int) _Counter] += _Amount;
+}
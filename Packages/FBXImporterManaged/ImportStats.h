@@ -0,0 +1,217 @@
+// Contains the statistics gathered while importing a scene & the macros instrumenting the import pipeline
+//
+#pragma managed
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+//////////////////////////////////////////////////////////////////////////
+// Uncomment (or add to the project's preprocessor definitions) to instrument the import pipeline
+// When not defined, the PROFILE_XXX macros expand to nothing and their arguments are never evaluated
+//
+//#define FBXIMPORTER_PROFILING
+
+#define PROFILE_CONCAT_INNER( a, b )	a##b
+#define PROFILE_CONCAT( a, b )			PROFILE_CONCAT_INNER( a, b )
+
+#ifdef FBXIMPORTER_PROFILING
+	// Times the enclosing block as the given stage
+	#define PROFILE_SCOPE( _Name )						FBXImporter::ProfileScope	PROFILE_CONCAT( ProfileScope, __LINE__ )( _Name, nullptr )
+	// Times the enclosing block as the given stage & attributes it to the given item (e.g. a mesh name)
+	#define PROFILE_SCOPE_ITEM( _Name, _ItemName )		FBXImporter::ProfileScope	PROFILE_CONCAT( ProfileScope, __LINE__ )( _Name, _ItemName )
+	// Adds to a counter of the innermost scope
+	#define PROFILE_COUNT( _Counter, _Amount )			FBXImporter::ProfileScope::Count( FBXImporter::ImportStats::COUNTER::_Counter, _Amount )
+#else
+	#define PROFILE_SCOPE( _Name )
+	#define PROFILE_SCOPE_ITEM( _Name, _ItemName )
+	#define PROFILE_COUNT( _Counter, _Amount )
+#endif
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Gathers the timings & counters of the import stages and of the individual items (meshes) they processed
+	// Stats are only collected on the thread that loads the scene (work done by parallel jobs is timed as a whole by the stage that runs them)
+	//
+	public ref class	ImportStats
+	{
+	public:		// NESTED TYPES
+
+		enum class	COUNTER
+		{
+			OBJECTS_ALLOCATED,		// Managed objects created (nodes, materials, vertices, triangles, layer element values, etc.)
+			ELEMENTS_CONVERTED,		// SDK values converted into managed values
+			BYTES_PRODUCED,			// Estimated size of the produced data
+			TRIANGLES,
+
+			COUNT,
+		};
+
+		// The accumulated timings & counters of a stage or of an item
+		[System::Diagnostics::DebuggerDisplayAttribute( "{Name} x{CallsCount} {TotalMilliseconds} ms" )]
+		ref class	Entry
+		{
+		public:
+
+			String^					Name;
+			int						CallsCount;
+			double					TotalMilliseconds;
+			double					MaxMilliseconds;
+			cli::array<__int64>^	Counters;			// Indexed by COUNTER. Counters of a stage exclude nested stages while counters of an item include them
+
+			Entry( String^ _Name ) : Name( _Name ), CallsCount( 0 ), TotalMilliseconds( 0.0 ), MaxMilliseconds( 0.0 )
+			{
+				Counters = gcnew cli::array<__int64>( (int) COUNTER::COUNT );
+			}
+
+			__int64		GetCounter( COUNTER _Counter )	{ return Counters[(int) _Counter]; }
+		};
+
+		// Attaches stats to the calling thread for the lifetime of the session (use with stack semantics)
+		ref class	Session
+		{
+		protected:
+
+			ImportStats^	m_Previous;
+
+		public:
+
+			Session( ImportStats^ _Stats )
+			{
+				m_Previous = ImportStats::ms_Current;
+				ImportStats::ms_Current = _Stats;
+			}
+			~Session()
+			{
+				ImportStats::ms_Current = m_Previous;
+			}
+		};
+
+	protected:
+
+		// A single timed scope, kept for the trace export
+		value struct	TraceEvent
+		{
+			String^					Name;
+			String^					ItemName;
+			int						ThreadID;
+			__int64					StartTicks;
+			__int64					DurationTicks;
+			cli::array<__int64>^	Counters;
+		};
+
+	protected:	// FIELDS
+
+		Object^						m_Lock;
+		__int64						m_StartTicks;
+		__int64						m_RootTicks;
+
+		List<Entry^>^				m_Stages;
+		Dictionary<String^,Entry^>^	m_Name2Stage;
+		List<Entry^>^				m_Items;
+		Dictionary<String^,Entry^>^	m_Name2Item;
+		cli::array<__int64>^		m_Totals;
+
+		List<TraceEvent>^			m_Events;
+		List<String^>^				m_SkippedProperties;
+
+		[ThreadStatic]
+		static ImportStats^			ms_Current;
+
+	public:		// PROPERTIES
+
+		// Gets the time spent in the outermost scopes (i.e. the load itself plus any later on-demand extraction), in milliseconds
+		property double		TotalMilliseconds
+		{
+			double	get()	{ return TicksToMilliseconds( m_RootTicks ); }
+		}
+
+		// Gets the stages in the order they were first entered
+		property cli::array<Entry^>^	Stages
+		{
+			cli::array<Entry^>^	get();
+		}
+
+		// Gets the items (meshes) in the order they were first processed
+		property cli::array<Entry^>^	Items
+		{
+			cli::array<Entry^>^	get();
+		}
+
+		property int		TraceEventsCount
+		{
+			int		get()	{ return m_Events->Count; }
+		}
+
+		// Gets the properties that couldn't be snapshot before the SDK scene got destroyed (as "Object.Property: reason")
+		property cli::array<String^>^	SkippedProperties
+		{
+			cli::array<String^>^	get();
+		}
+
+		// Gets the stats attached to the calling thread (nullptr if none)
+		static property ImportStats^	Current
+		{
+			ImportStats^	get()	{ return ms_Current; }
+		}
+
+	public:		// METHODS
+
+		ImportStats();
+
+		// Gets the total of a counter over all the stages
+		__int64		GetTotal( COUNTER _Counter );
+
+		// Finds the entry of a stage or of an item by name (nullptr if not found)
+		Entry^		FindStage( String^ _Name );
+		Entry^		FindItem( String^ _Name );
+
+		// Writes the timed scopes as a Chrome trace-event JSON file (open with chrome://tracing)
+		void		ExportChromeTrace( String^ _FileName );
+
+		virtual String^	ToString() override;
+
+	internal:
+
+		// Accumulates a finished scope
+		void		RecordScope( String^ _Name, String^ _ItemName, __int64 _StartTicks, __int64 _DurationTicks, cli::array<__int64>^ _Counters, cli::array<__int64>^ _InclusiveCounters, bool _bRoot );
+
+		// Records a property that failed to materialize & was left out of its object's snapshot
+		void		RecordSkippedProperty( String^ _ObjectName, String^ _PropertyName, String^ _Reason );
+
+		static double	TicksToMilliseconds( __int64 _Ticks )	{ return 1000.0 * _Ticks / System::Diagnostics::Stopwatch::Frequency; }
+
+	protected:
+
+		static void		AppendJSONString( System::Text::StringBuilder^ _Builder, String^ _Value );
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Times a block of the import pipeline & collects its counters (use with stack semantics through the PROFILE_XXX macros)
+	// Does nothing when no stats are attached to the calling thread
+	//
+	ref class	ProfileScope
+	{
+	protected:	// FIELDS
+
+		ImportStats^			m_Stats;
+		ProfileScope^			m_Parent;
+		String^					m_Name;
+		String^					m_ItemName;
+		__int64					m_StartTicks;
+		cli::array<__int64>^	m_Counters;				// The counters of that scope alone
+		cli::array<__int64>^	m_InclusiveCounters;	// The counters of that scope & its nested scopes
+
+		[ThreadStatic]
+		static ProfileScope^	ms_Current;
+
+	public:		// METHODS
+
+		ProfileScope( String^ _Name, String^ _ItemName );
+		~ProfileScope();
+
+		// Adds to a counter of the innermost scope of the calling thread
+		static void		Count( ImportStats::COUNTER _Counter, __int64 _Amount );
+	};
+}
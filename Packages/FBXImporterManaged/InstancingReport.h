@@ -0,0 +1,123 @@
+// Contains the content hash identifying mesh instances and the report of the instancing stage
+//
+#pragma managed
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// The 128-bit hash of the contents of a mesh (positions, indices & every layer element)
+	//
+	public value struct	MeshContentHash : public IEquatable<MeshContentHash>
+	{
+		unsigned __int64	Low;
+		unsigned __int64	High;
+
+		MeshContentHash( unsigned __int64 _Low, unsigned __int64 _High ) : Low( _Low ), High( _High )	{}
+
+		virtual bool	Equals( MeshContentHash _Other )	{ return Low == _Other.Low && High == _Other.High; }
+		virtual bool	Equals( Object^ _Other ) override	{ return _Other != nullptr && _Other->GetType() == MeshContentHash::typeid && Equals( safe_cast<MeshContentHash>( _Other ) ); }
+		virtual int		GetHashCode() override				{ return (int) (Low ^ (Low >> 32)); }
+		virtual String^	ToString() override					{ return High.ToString( "X16" ) + Low.ToString( "X16" ); }
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Reports the geometries shared by several meshes after instance detection
+	//
+	public ref class	InstancingReport
+	{
+	public:		// NESTED TYPES
+
+		[System::Diagnostics::DebuggerDisplayAttribute( "{MasterName} x{InstancesCount}" )]
+		ref class	GeometryEntry
+		{
+		public:
+
+			String^				MasterName;			// The name of the mesh whose geometry is shared
+			MeshContentHash		Hash;
+			int					TrianglesCount;
+			int					VerticesCount;
+			int					InstancesCount;		// Amount of meshes sharing the geometry of the master (not counting the master itself)
+		};
+
+	protected:	// FIELDS
+
+		int						m_HashedMeshesCount;
+		int						m_RejectedMatchesCount;
+		List<GeometryEntry^>^	m_Entries;
+		double					m_Milliseconds;
+
+	public:		// PROPERTIES
+
+		// Gets the amount of meshes that were hashed (skinned & morphed meshes are never instanced)
+		property int		HashedMeshesCount
+		{
+			int		get()	{ return m_HashedMeshesCount; }
+		}
+
+		// Gets the amount of hash matches whose contents turned out to differ (these meshes were not instanced on that master)
+		property int		RejectedMatchesCount
+		{
+			int		get()	{ return m_RejectedMatchesCount; }
+		}
+
+		// Gets the geometries shared by at least 2 meshes
+		property cli::array<GeometryEntry^>^	Entries
+		{
+			cli::array<GeometryEntry^>^	get()	{ return m_Entries->ToArray(); }
+		}
+
+		property int		InstancesCount
+		{
+			int		get()	{ int Result = 0; for each ( GeometryEntry^ E in m_Entries ) Result += E->InstancesCount; return Result; }
+		}
+
+		// Gets the amount of vertices that didn't need to be stored thanks to instancing
+		property int		SavedVerticesCount
+		{
+			int		get()	{ int Result = 0; for each ( GeometryEntry^ E in m_Entries ) Result += E->VerticesCount * E->InstancesCount; return Result; }
+		}
+
+		// Gets the amount of triangles that didn't need to be stored or processed thanks to instancing
+		property int		SavedTrianglesCount
+		{
+			int		get()	{ int Result = 0; for each ( GeometryEntry^ E in m_Entries ) Result += E->TrianglesCount * E->InstancesCount; return Result; }
+		}
+
+		// Gets the time spent hashing & matching meshes (in milliseconds)
+		property double		Milliseconds
+		{
+			double	get()	{ return m_Milliseconds; }
+		}
+
+	public:		// METHODS
+
+		InstancingReport( int _HashedMeshesCount, int _RejectedMatchesCount, double _Milliseconds )
+		{
+			m_HashedMeshesCount = _HashedMeshesCount;
+			m_RejectedMatchesCount = _RejectedMatchesCount;
+			m_Entries = gcnew List<GeometryEntry^>();
+			m_Milliseconds = _Milliseconds;
+		}
+
+		[System::ComponentModel::BrowsableAttribute( false )]
+		void	AddEntry( GeometryEntry^ _Entry )
+		{
+			m_Entries->Add( _Entry );
+		}
+
+		virtual String^	ToString() override
+		{
+			System::Text::StringBuilder^	Result = gcnew System::Text::StringBuilder();
+			Result->AppendFormat( "{0} meshes hashed in {1:F1} ms, {2} shared geometries, {3} instances, {4} vertices & {5} triangles saved, {6} rejected hash matches\n", m_HashedMeshesCount, m_Milliseconds, m_Entries->Count, InstancesCount, SavedVerticesCount, SavedTrianglesCount, m_RejectedMatchesCount );
+
+			for each ( GeometryEntry^ E in m_Entries )
+				Result->AppendFormat( "  {0}\tx{1}\ttriangles {2}\tvertices {3}\thash {4}\n", E->MasterName, E->InstancesCount, E->TrianglesCount, E->VerticesCount, E->Hash );
+
+			return	Result->ToString();
+		}
+	};
+}
@@ -11,6 +11,8 @@ using namespace FBXImporter;
 
 void	LayerElement::BuildArray( KFbxLayerElement* _pLayerElement )
 {
+	PROFILE_SCOPE( "LayerElement::BuildArray" );
+
 	m_CachedArray = nullptr;
 
 	//////////////////////////////////////////////////////////////////////////
@@ -40,6 +42,30 @@ void	LayerElement::BuildArray( KFbxLayerElement* _pLayerElement )
 	}
 	m_CachedArray = gcnew cli::array<Object^>( ElementsCount );
 
+	// Every element is a new boxed value or object
+	PROFILE_COUNT( OBJECTS_ALLOCATED, ElementsCount );
+	PROFILE_COUNT( ELEMENTS_CONVERTED, ElementsCount );
+	PROFILE_COUNT( BYTES_PRODUCED, sizeof(void*) * ElementsCount );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Convert the whole direct array of vectors into the target axis system before resolving the mapping
+	if ( m_ElementType == ELEMENT_TYPE::NORMAL || m_ElementType == ELEMENT_TYPE::TANGENT || m_ElementType == ELEMENT_TYPE::BINORMAL )
+	{
+		KFbxLayerElementTemplate<KFbxVector4>*	pElementVector4 = dynamic_cast<KFbxLayerElementTemplate<KFbxVector4>*>( _pLayerElement );
+		int	VectorsCount = pElementVector4->GetDirectArray().GetCount();
+
+		m_ConvertedVectors = gcnew cli::array<float>( 3 * VectorsCount + 1 );
+		for ( int VectorIndex=0; VectorIndex < VectorsCount; VectorIndex++ )
+		{
+			KFbxVector4	Vector = pElementVector4->GetDirectArray().GetAt( VectorIndex );
+			m_ConvertedVectors[3*VectorIndex+0] = (float) Vector[0];
+			m_ConvertedVectors[3*VectorIndex+1] = (float) Vector[1];
+			m_ConvertedVectors[3*VectorIndex+2] = (float) Vector[2];
+		}
+
+		m_Owner->Owner->ParentScene->ConvertVectors( m_ConvertedVectors, VectorsCount );
+	}
+
 	//////////////////////////////////////////////////////////////////////////
 	// Fill it up with the appropriate objects
 	switch ( MappingType )
@@ -76,6 +102,8 @@ void	LayerElement::BuildArray( KFbxLayerElement* _pLayerElement )
 		}
 		break;
 	}
+
+	m_ConvertedVectors = nullptr;
 }
 
 Object^		LayerElement::GetElementByTriangleVertex( int _TriangleIndex, int _TriangleVertexIndex )
@@ -119,6 +147,50 @@ Object^		LayerElement::GetElementByTriangleVertex( int _TriangleIndex, int _Tria
 	return	nullptr;
 }
 
+void	LayerElement::RemapTriangles( cli::array<int>^ _TriangleOrder )
+{
+	if ( m_CachedArray == nullptr )
+		return;
+
+	cli::array<Object^>^	Remapped = nullptr;
+	switch ( m_MappingMode )
+	{
+	case MAPPING_TYPE::BY_TRIANGLE:
+		Remapped = gcnew cli::array<Object^>( m_CachedArray->Length );
+		for ( int TriangleIndex=0; TriangleIndex < _TriangleOrder->Length; TriangleIndex++ )
+			Remapped[TriangleIndex] = m_CachedArray[_TriangleOrder[TriangleIndex]];
+		break;
+
+	case MAPPING_TYPE::BY_TRIANGLE_VERTEX:
+		Remapped = gcnew cli::array<Object^>( m_CachedArray->Length );
+		for ( int TriangleIndex=0; TriangleIndex < _TriangleOrder->Length; TriangleIndex++ )
+		{
+			int	OldTriangleIndex = _TriangleOrder[TriangleIndex];
+			Remapped[3*TriangleIndex+0] = m_CachedArray[3*OldTriangleIndex+0];
+			Remapped[3*TriangleIndex+1] = m_CachedArray[3*OldTriangleIndex+1];
+			Remapped[3*TriangleIndex+2] = m_CachedArray[3*OldTriangleIndex+2];
+		}
+		break;
+
+	default:
+		return;	// Not indexed by triangle
+	}
+
+	m_CachedArray = Remapped;
+}
+
+void	LayerElement::RemapControlPoints( cli::array<int>^ _VertexRemap )
+{
+	if ( m_CachedArray == nullptr || m_MappingMode != MAPPING_TYPE::BY_CONTROL_POINT )
+		return;
+
+	cli::array<Object^>^	Remapped = gcnew cli::array<Object^>( m_CachedArray->Length );
+	for ( int VertexIndex=0; VertexIndex < _VertexRemap->Length; VertexIndex++ )
+		Remapped[_VertexRemap[VertexIndex]] = m_CachedArray[VertexIndex];
+
+	m_CachedArray = Remapped;
+}
+
 
 // Macro to get an element at the specified index (supports direct and by index addressing)
 //
@@ -140,8 +212,6 @@ Object^	LayerElement::GetElementAt( KFbxLayerElement* _pLayerElement, int _Index
 	KFbxLayerElementTemplate<KFbxColor>*	pElementColor = NULL;
 	KFbxLayerElementMaterial*				pElementMaterial = NULL;
 
-	Scene::UP_AXIS	UpAxis = m_Owner->Owner->ParentScene->UpAxis;
-
 	Object^	Result = nullptr;
 
 	switch ( m_ElementType )
@@ -150,20 +220,13 @@ Object^	LayerElement::GetElementAt( KFbxLayerElement* _pLayerElement, int _Index
 	case	ELEMENT_TYPE::NORMAL:
 	case	ELEMENT_TYPE::TANGENT:
 	case	ELEMENT_TYPE::BINORMAL:
+		// Vectors are read from the converted direct array (cf. BuildArray())
 		pElementVector4 = dynamic_cast<KFbxLayerElementTemplate<KFbxVector4>*>( _pLayerElement );
-		GET_ELEMENT( pElementVector4, _Index, Helpers::ToVector )
-
-		switch ( UpAxis )
-		{
-		case Scene::UP_AXIS::X:
-			throw gcnew Exception( "X as Up Axis is not supported !" );
-			break;
-		case Scene::UP_AXIS::Y:
-			WMath::Vector^	Temp = dynamic_cast<WMath::Vector^>( Result );
-			Result = gcnew WMath::Vector( Temp->x, Temp->z, -Temp->y );
-			break;
-		}
-
+		if ( ReferenceType == REFERENCE_TYPE::DIRECT )
+			Result = GetConvertedVector( _Index );
+		else if (  ReferenceType == REFERENCE_TYPE::INDEX
+				|| ReferenceType == REFERENCE_TYPE::INDEX_TO_DIRECT )
+			Result = GetConvertedVector( pElementVector4->GetIndexArray().GetAt( _Index ) );
 		break;
 
 	case	ELEMENT_TYPE::UV:
@@ -119,6 +119,7 @@ namespace FBXImporter
 
 		// Cached array conversion
 		cli::array<Object^>^	m_CachedArray;
+		cli::array<float>^		m_ConvertedVectors;	// The direct array of normals, tangents or binormals converted into the target axis system (only while building the cached array)
 
 
 	public:		// PROPERTIES
@@ -224,6 +225,16 @@ namespace FBXImporter
 		//
 		Object^			GetElementByTriangleVertex( int _TriangleIndex, int _TriangleVertexIndex );
 
+	internal:
+
+		// Reorders the cached array after the owner mesh's triangles were reordered
+		// _TriangleOrder gives the old index of the triangle now in N-th position
+		void			RemapTriangles( cli::array<int>^ _TriangleOrder );
+
+		// Reorders the cached array after the owner mesh's control points were reordered
+		// _VertexRemap gives the new index of each old control point
+		void			RemapControlPoints( cli::array<int>^ _VertexRemap );
+
 	protected:
 		
 		void			BuildArray( KFbxLayerElement* _pLayerElement );
@@ -231,5 +242,11 @@ namespace FBXImporter
 		// Gets the layer element's element at the given index
 		Object^			GetElementAt( KFbxLayerElement* _pLayerElement, int _Index );
 
+		// Gets a vector of the converted direct array
+		WMath::Vector^	GetConvertedVector( int _DirectIndex )
+		{
+			return	gcnew WMath::Vector( m_ConvertedVectors[3*_DirectIndex+0], m_ConvertedVectors[3*_DirectIndex+1], m_ConvertedVectors[3*_DirectIndex+2] );
+		}
+
 	};
 }
@@ -56,6 +56,12 @@ namespace FBXImporter
 			}
 		}
 
+		// This constructor is used for custom creation of a layer (i.e. procedural meshes or meshes without any layer)
+		Layer( NodeMesh^ _Owner ) : m_Owner( _Owner )
+		{
+			m_Elements = gcnew List<LayerElement^>();
+		}
+
 		// Adds another element to the list
 		//
 		void	AddElement( LayerElement^ _Element )
@@ -0,0 +1,163 @@
+// Native memory-mapped files
+//
+#ifdef _MANAGED
+#pragma unmanaged
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#define _FILE_OFFSET_BITS	64
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "MappedFile.h"
+
+using namespace	FBXImporter;
+
+MappedFile::MappedFile() : m_Size( -1 )
+{
+#ifdef _WIN32
+	m_hFile = INVALID_HANDLE_VALUE;
+	m_hMapping = NULL;
+
+	SYSTEM_INFO	Info;
+	GetSystemInfo( &Info );
+	m_Granularity = Info.dwAllocationGranularity;
+#else
+	m_File = -1;
+	m_Granularity = (int) sysconf( _SC_PAGESIZE );
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool	MappedFile::Open( const char* _pFileName )
+{
+	Close();
+
+#ifdef _WIN32
+	m_hFile = CreateFileA( _pFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if ( m_hFile == INVALID_HANDLE_VALUE )
+		return	false;
+
+	LARGE_INTEGER	Size;
+	if ( !GetFileSizeEx( m_hFile, &Size ) )
+	{
+		Close();
+		return	false;
+	}
+
+	// Empty files can't be mapped
+	if ( Size.QuadPart > 0 )
+	{
+		m_hMapping = CreateFileMappingA( m_hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+		if ( m_hMapping == NULL )
+		{
+			Close();
+			return	false;
+		}
+	}
+	m_Size = Size.QuadPart;
+#else
+	m_File = open( _pFileName, O_RDONLY );
+	if ( m_File < 0 )
+		return	false;
+
+	struct stat	Stat;
+	if ( fstat( m_File, &Stat ) != 0 )
+	{
+		Close();
+		return	false;
+	}
+	m_Size = Stat.st_size;
+#endif
+
+	return	true;
+}
+
+void	MappedFile::Close()
+{
+#ifdef _WIN32
+	if ( m_hMapping != NULL )
+		CloseHandle( m_hMapping );
+	if ( m_hFile != INVALID_HANDLE_VALUE )
+		CloseHandle( m_hFile );
+	m_hMapping = NULL;
+	m_hFile = INVALID_HANDLE_VALUE;
+#else
+	if ( m_File >= 0 )
+		close( m_File );
+	m_File = -1;
+#endif
+	m_Size = -1;
+}
+
+void*	MappedFile::Map( long long _Offset, size_t _Size ) const
+{
+#ifdef _WIN32
+	return	MapViewOfFile( m_hMapping, FILE_MAP_READ, (DWORD) (_Offset >> 32), (DWORD) (_Offset & 0xFFFFFFFF), _Size );
+#else
+	void*	pResult = mmap( NULL, _Size, PROT_READ, MAP_PRIVATE, m_File, (off_t) _Offset );
+	if ( pResult == MAP_FAILED )
+		return	NULL;
+
+	madvise( pResult, _Size, MADV_SEQUENTIAL );
+	return	pResult;
+#endif
+}
+
+void	MappedFile::Unmap( void* _pBase, size_t _Size )
+{
+#ifdef _WIN32
+	UnmapViewOfFile( _pBase );
+#else
+	munmap( _pBase, _Size );
+#endif
+}
+
+bool	MappedView::Map( const MappedFile& _File, long long _Offset, long long _Size )
+{
+	Unmap();
+
+	if ( _Offset < 0 || _Offset > _File.GetSize() )
+		return	false;
+	if ( _Offset + _Size > _File.GetSize() )
+		_Size = _File.GetSize() - _Offset;
+	if ( _Size <= 0 )
+		return	true;	// Empty view
+
+	// Views must start on a multiple of the granularity
+	long long	BaseOffset = _Offset - _Offset % _File.GetGranularity();
+	long long	BaseSize = _Size + (_Offset - BaseOffset);
+	if ( BaseSize != (long long) (size_t) BaseSize )
+		return	false;	// Doesn't fit the address space
+
+	m_pBase = _File.Map( BaseOffset, (size_t) BaseSize );
+	if ( m_pBase == NULL )
+		return	false;
+
+	m_BaseSize = (size_t) BaseSize;
+	m_pData = (const char*) m_pBase + (_Offset - BaseOffset);
+	m_Size = (size_t) _Size;
+
+	return	true;
+}
+
+void	MappedView::Unmap()
+{
+	if ( m_pBase != NULL )
+		MappedFile::Unmap( m_pBase, m_BaseSize );
+
+	m_pBase = NULL;
+	m_BaseSize = 0;
+	m_pData = NULL;
+	m_Size = 0;
+}
@@ -0,0 +1,86 @@
+// Contains the read-only memory-mapped files used by the streaming importers
+//
+#pragma once
+
+#include <stddef.h>
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A file opened for read-only mapping
+	// Files are never mapped as a whole (they may not fit a 32-bit address space): views of a part of the file are mapped instead.
+	// Views can be mapped & unmapped concurrently from several threads.
+	//
+	class	MappedFile
+	{
+	protected:	// FIELDS
+
+#ifdef _WIN32
+		void*		m_hFile;
+		void*		m_hMapping;
+#else
+		int			m_File;
+#endif
+		long long	m_Size;
+		int			m_Granularity;		// Alignment of the offsets of views
+
+	public:		// PROPERTIES
+
+		bool		IsOpen() const			{ return m_Size >= 0; }
+		long long	GetSize() const			{ return m_Size; }
+		int			GetGranularity() const	{ return m_Granularity; }
+
+	public:		// METHODS
+
+		MappedFile();
+		~MappedFile();
+
+		// Returns false if the file can't be opened or mapped
+		bool	Open( const char* _pFileName );
+		void	Close();
+
+	protected:
+
+		friend class	MappedView;
+
+		// Maps _Size bytes at _Offset (which must be a multiple of the granularity)
+		void*	Map( long long _Offset, size_t _Size ) const;
+		static void	Unmap( void* _pBase, size_t _Size );
+
+	private:
+		MappedFile( const MappedFile& );
+		MappedFile&	operator=( const MappedFile& );
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A view of a part of a mapped file, unmapped on destruction
+	//
+	class	MappedView
+	{
+	protected:	// FIELDS
+
+		void*		m_pBase;
+		size_t		m_BaseSize;
+		const char*	m_pData;
+		size_t		m_Size;
+
+	public:		// PROPERTIES
+
+		const char*	GetData() const		{ return m_pData; }
+		size_t		GetSize() const		{ return m_Size; }
+
+	public:		// METHODS
+
+		MappedView() : m_pBase( NULL ), m_BaseSize( 0 ), m_pData( NULL ), m_Size( 0 )	{}
+		~MappedView()		{ Unmap(); }
+
+		// Maps [_Offset, _Offset+_Size), clamped to the end of the file
+		// Returns false if the view can't be mapped
+		bool	Map( const MappedFile& _File, long long _Offset, long long _Size );
+		void	Unmap();
+
+	private:
+		MappedView( const MappedView& );
+		MappedView&	operator=( const MappedView& );
+	};
+}
@@ -46,7 +46,15 @@ namespace FBXImporter
 	{
 	protected:	// FIELDS
 
-		KFbxSurfaceLambert*		m_pLambert;
+		KFbxSurfaceLambert*		m_pLambert;		// NULL once the SDK scene is destroyed
+
+		// Snapshot of the material's values once released
+		WMath::Point^			m_EmissiveColor;
+		float					m_EmissiveFactor;
+		WMath::Point^			m_AmbientColor;
+		float					m_AmbientFactor;
+		WMath::Point^			m_DiffuseColor;
+		float					m_DiffuseFactor;
 
 	public:		// PROPERTIES
 
@@ -54,42 +62,42 @@ namespace FBXImporter
 		//
 		property WMath::Point^		EmissiveColor
 		{
-			WMath::Point^		get()	{ return Helpers::ToPoint( m_pLambert->GetEmissiveColor().Get() ); }
+			WMath::Point^		get()	{ return m_pLambert != NULL ? Helpers::ToPoint( m_pLambert->GetEmissiveColor().Get() ) : m_EmissiveColor; }
 		}
 
 		[DescriptionAttribute( "Gets emissive factor" )]
 		//
 		property float				EmissiveFactor
 		{
-			float				get()	{ return (float) m_pLambert->GetEmissiveFactor().Get(); }
+			float				get()	{ return m_pLambert != NULL ? (float) m_pLambert->GetEmissiveFactor().Get() : m_EmissiveFactor; }
 		}
 
 		[DescriptionAttribute( "Gets ambient color" )]
 		//
 		property WMath::Point^		AmbientColor
 		{
-			WMath::Point^		get()	{ return Helpers::ToPoint( m_pLambert->GetAmbientColor().Get() ); }
+			WMath::Point^		get()	{ return m_pLambert != NULL ? Helpers::ToPoint( m_pLambert->GetAmbientColor().Get() ) : m_AmbientColor; }
 		}
 
 		[DescriptionAttribute( "Gets ambient factor" )]
 		//
 		property float				AmbientFactor
 		{
-			float				get()	{ return (float) m_pLambert->GetAmbientFactor().Get(); }
+			float				get()	{ return m_pLambert != NULL ? (float) m_pLambert->GetAmbientFactor().Get() : m_AmbientFactor; }
 		}
 
 		[DescriptionAttribute( "Gets diffuse color" )]
 		//
 		property WMath::Point^		DiffuseColor
 		{
-			WMath::Point^		get()	{ return Helpers::ToPoint( m_pLambert->GetDiffuseColor().Get() ); }
+			WMath::Point^		get()	{ return m_pLambert != NULL ? Helpers::ToPoint( m_pLambert->GetDiffuseColor().Get() ) : m_DiffuseColor; }
 		}
 
 		[DescriptionAttribute( "Gets diffuse factor" )]
 		//
 		property float				DiffuseFactor
 		{
-			float				get()	{ return (float) m_pLambert->GetDiffuseFactor().Get(); }
+			float				get()	{ return m_pLambert != NULL ? (float) m_pLambert->GetDiffuseFactor().Get() : m_DiffuseFactor; }
 		}
 
 
@@ -98,6 +106,20 @@ namespace FBXImporter
 		MaterialLambert( Scene^ _ParentScene, KFbxSurfaceLambert* _pMaterial ) : Material( _ParentScene, _pMaterial ), m_pLambert( _pMaterial )
 		{
 		}
+
+	internal:
+
+		virtual void	ReleaseSDKObject() override
+		{
+			m_EmissiveColor = EmissiveColor;
+			m_EmissiveFactor = EmissiveFactor;
+			m_AmbientColor = AmbientColor;
+			m_AmbientFactor = AmbientFactor;
+			m_DiffuseColor = DiffuseColor;
+			m_DiffuseFactor = DiffuseFactor;
+			m_pLambert = NULL;
+			Material::ReleaseSDKObject();
+		}
 	};
 
 	// Standard Lambert material
@@ -106,7 +128,14 @@ namespace FBXImporter
 	{
 	protected:	// FIELDS
 
-		KFbxSurfacePhong*		m_pPhong;
+		KFbxSurfacePhong*		m_pPhong;		// NULL once the SDK scene is destroyed
+
+		// Snapshot of the material's values once released
+		WMath::Point^			m_SpecularColor;
+		float					m_SpecularFactor;
+		WMath::Point^			m_ReflectionColor;
+		float					m_ReflectionFactor;
+		float					m_Shininess;
 
 	public:		// PROPERTIES
 
@@ -114,35 +143,35 @@ namespace FBXImporter
 		//
 		property WMath::Point^		SpecularColor
 		{
-			WMath::Point^		get()	{ return Helpers::ToPoint( m_pPhong->GetSpecularColor().Get() ); }
+			WMath::Point^		get()	{ return m_pPhong != NULL ? Helpers::ToPoint( m_pPhong->GetSpecularColor().Get() ) : m_SpecularColor; }
 		}
 
 		[DescriptionAttribute( "Gets specular factor" )]
 		//
 		property float				SpecularFactor
 		{
-			float				get()	{ return (float) m_pPhong->GetSpecularFactor().Get(); }
+			float				get()	{ return m_pPhong != NULL ? (float) m_pPhong->GetSpecularFactor().Get() : m_SpecularFactor; }
 		}
 
 		[DescriptionAttribute( "Gets reflection color" )]
 		//
 		property WMath::Point^		ReflectionColor
 		{
-			WMath::Point^		get()	{ return Helpers::ToPoint( m_pPhong->GetReflectionColor().Get() ); }
+			WMath::Point^		get()	{ return m_pPhong != NULL ? Helpers::ToPoint( m_pPhong->GetReflectionColor().Get() ) : m_ReflectionColor; }
 		}
 
 		[DescriptionAttribute( "Gets reflection factor" )]
 		//
 		property float				ReflectionFactor
 		{
-			float				get()	{ return (float) m_pPhong->GetReflectionFactor().Get(); }
+			float				get()	{ return m_pPhong != NULL ? (float) m_pPhong->GetReflectionFactor().Get() : m_ReflectionFactor; }
 		}
 
 		[DescriptionAttribute( "Gets specular shininess (i.e. specular power)" )]
 		//
 		property float				Shininess
 		{
-			float				get()	{ return (float) m_pPhong->GetShininess().Get(); }
+			float				get()	{ return m_pPhong != NULL ? (float) m_pPhong->GetShininess().Get() : m_Shininess; }
 		}
 
 
@@ -151,5 +180,18 @@ namespace FBXImporter
 		MaterialPhong( Scene^ _ParentScene, KFbxSurfacePhong* _pMaterial ) : MaterialLambert( _ParentScene, _pMaterial ), m_pPhong( _pMaterial )
 		{
 		}
+
+	internal:
+
+		virtual void	ReleaseSDKObject() override
+		{
+			m_SpecularColor = SpecularColor;
+			m_SpecularFactor = SpecularFactor;
+			m_ReflectionColor = ReflectionColor;
+			m_ReflectionFactor = ReflectionFactor;
+			m_Shininess = Shininess;
+			m_pPhong = NULL;
+			MaterialLambert::ReleaseSDKObject();
+		}
 	};
 }
@@ -0,0 +1,98 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "MeshFileImporter.h"
+#include "MeshFileSource.h"
+#include "FBXSceneBuilder.h"
+#include "Scene.h"
+
+using namespace FBXImporter;
+
+namespace FBXImporter
+{
+	// A job parsing a batch of chunks of a mesh file on the thread pool
+	ref class	MeshFileParseJob
+	{
+	public:
+
+		MeshFileSource*	m_pSource;
+		int				m_FirstChunkIndex;
+
+		void	Execute( int _JobIndex )
+		{
+			m_pSource->ParseChunk( m_FirstChunkIndex + _JobIndex );
+		}
+	};
+}
+
+bool	MeshFileImporter::IsSupported( String^ _FileName )
+{
+	return	MeshFileSource::IsSupported( Helpers::FromString( _FileName ) );
+}
+
+MeshFileReport^	MeshFileImporter::Import( Scene^ _Owner, String^ _FileName, KFbxScene* _pScene, ImportOptions^ _Options )
+{
+	PROFILE_SCOPE( "MeshFileImporter::Import" );
+
+	MeshFileSource	Source;
+	int				WorkersCount = _Options->MeshFileWorkersCount > 0 ? _Options->MeshFileWorkersCount : Environment::ProcessorCount;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Parse the chunks by batches of WorkersCount chunks, merging each batch in file order
+	System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+	{
+		PROFILE_SCOPE( "MeshFileImporter::Parse" );
+
+		if ( !Source.Open( Helpers::FromString( _FileName ), _Options->MeshFileChunkSizeMB << 20 ) )
+			throw gcnew Exception( "Failed to open \"" + _FileName + "\" ! " + Helpers::GetString( Source.GetError() ) );
+
+		MeshFileParseJob^	Job = gcnew MeshFileParseJob();
+		Job->m_pSource = &Source;
+
+		int	ChunksCount = Source.GetChunksCount();
+		for ( int FirstChunkIndex=0; FirstChunkIndex < ChunksCount; FirstChunkIndex+=WorkersCount )
+		{
+			_Owner->CheckCancellation();
+			_Owner->ReportProgress( Scene::LOAD_STAGE::SDK_IMPORT, FirstChunkIndex, ChunksCount );
+
+			int	BatchSize = Math::Min( WorkersCount, ChunksCount - FirstChunkIndex );
+			Job->m_FirstChunkIndex = FirstChunkIndex;
+			if ( BatchSize > 1 )
+				System::Threading::Tasks::Parallel::For( 0, BatchSize, gcnew Action<int>( Job, &MeshFileParseJob::Execute ) );
+			else
+				Job->Execute( 0 );
+
+			for ( int ChunkIndex=FirstChunkIndex; ChunkIndex < FirstChunkIndex+BatchSize; ChunkIndex++ )
+				if ( !Source.CommitChunk( ChunkIndex ) )
+					throw gcnew Exception( "Failed to parse \"" + _FileName + "\" ! " + Helpers::GetString( Source.GetError() ) );
+		}
+
+		if ( !Source.Finalize() )
+			throw gcnew Exception( "Failed to parse \"" + _FileName + "\" ! " + Helpers::GetString( Source.GetError() ) );
+	}
+	double	ParseMilliseconds = Watch->Elapsed.TotalMilliseconds;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Build the SDK scene
+	_Owner->CheckCancellation();
+	Watch->Restart();
+	{
+		PROFILE_SCOPE( "MeshFileImporter::Build" );
+		FBXSceneBuilder::Build( Source, _pScene );
+
+		// OBJ & PLY files are Y-Up by convention, the scene reading converts them into the target axis system (if any)
+		_pScene->GetGlobalSettings().SetAxisSystem( KFbxAxisSystem::MayaYUp );
+	}
+	double	BuildMilliseconds = Watch->Elapsed.TotalMilliseconds;
+
+	String^	Format = "OBJ";
+	switch ( Source.GetFormat() )
+	{
+	case MeshFileSource::FORMAT_PLY_ASCII:						Format = "PLY (ASCII)"; break;
+	case MeshFileSource::FORMAT_PLY_BINARY_LITTLE_ENDIAN:		Format = "PLY (binary little endian)"; break;
+	case MeshFileSource::FORMAT_PLY_BINARY_BIG_ENDIAN:			Format = "PLY (binary big endian)"; break;
+	}
+
+	return	gcnew MeshFileReport( Format, Source.GetFileSize(), Source.GetChunksCount(), Math::Min( WorkersCount, Source.GetChunksCount() ), Source.GetVerticesCount(), Source.GetPolygonsCount(), ParseMilliseconds, BuildMilliseconds );
+}
@@ -0,0 +1,122 @@
+// Contains the native OBJ & PLY import path and its report
+//
+#pragma managed
+#pragma once
+
+#include "ImportOptions.h"
+
+using namespace System;
+
+namespace FBXImporter
+{
+	ref class	Scene;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Reports the throughput of the native parser when a scene was loaded from an OBJ or PLY file
+	//
+	public ref class	MeshFileReport
+	{
+	protected:	// FIELDS
+
+		String^		m_Format;
+		__int64		m_FileSize;
+		int			m_ChunksCount;
+		int			m_WorkersCount;
+		int			m_VerticesCount;
+		int			m_PolygonsCount;
+		double		m_ParseMilliseconds;
+		double		m_BuildMilliseconds;
+
+	public:		// PROPERTIES
+
+		property String^	Format
+		{
+			String^	get()	{ return m_Format; }
+		}
+
+		// Gets the size of the file (in bytes)
+		property __int64	FileSize
+		{
+			__int64	get()	{ return m_FileSize; }
+		}
+
+		// Gets the amount of chunks the file was split into
+		property int		ChunksCount
+		{
+			int		get()	{ return m_ChunksCount; }
+		}
+
+		// Gets the amount of chunks parsed concurrently
+		property int		WorkersCount
+		{
+			int		get()	{ return m_WorkersCount; }
+		}
+
+		property int		VerticesCount
+		{
+			int		get()	{ return m_VerticesCount; }
+		}
+
+		property int		PolygonsCount
+		{
+			int		get()	{ return m_PolygonsCount; }
+		}
+
+		// Gets the time spent mapping, parsing & merging the chunks (in milliseconds)
+		property double		ParseMilliseconds
+		{
+			double	get()	{ return m_ParseMilliseconds; }
+		}
+
+		// Gets the time spent building the SDK scene from the parsed data (in milliseconds)
+		property double		BuildMilliseconds
+		{
+			double	get()	{ return m_BuildMilliseconds; }
+		}
+
+		// Gets the parsing throughput (in megabytes per second)
+		property double		MegaBytesPerSecond
+		{
+			double	get()	{ return m_ParseMilliseconds > 0.0 ? (m_FileSize / (1024.0 * 1024.0)) / (0.001 * m_ParseMilliseconds) : 0.0; }
+		}
+
+	public:		// METHODS
+
+		MeshFileReport( String^ _Format, __int64 _FileSize, int _ChunksCount, int _WorkersCount, int _VerticesCount, int _PolygonsCount, double _ParseMilliseconds, double _BuildMilliseconds )
+		{
+			m_Format = _Format;
+			m_FileSize = _FileSize;
+			m_ChunksCount = _ChunksCount;
+			m_WorkersCount = _WorkersCount;
+			m_VerticesCount = _VerticesCount;
+			m_PolygonsCount = _PolygonsCount;
+			m_ParseMilliseconds = _ParseMilliseconds;
+			m_BuildMilliseconds = _BuildMilliseconds;
+		}
+
+		virtual String^	ToString() override
+		{
+			return	String::Format( "{0} {1:F1} MB in {2} chunks on {3} workers, {4} vertices & {5} polygons parsed in {6:F1} ms ({7:F1} MB/s), scene built in {8:F1} ms",
+									m_Format, m_FileSize / (1024.0 * 1024.0), m_ChunksCount, m_WorkersCount, m_VerticesCount, m_PolygonsCount, m_ParseMilliseconds, MegaBytesPerSecond, m_BuildMilliseconds );
+		}
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Loads OBJ & PLY files with the native streaming parser instead of the SDK importer
+	// The file is memory-mapped & split into chunks parsed concurrently by batches of MeshFileWorkersCount chunks, each batch being merged
+	//	in file order before the next one starts so the working memory of the parser stays bounded by the workers count & the chunk size.
+	// The parsed objects are then built into the (empty) SDK scene so they go through the regular scene reading path.
+	//
+	// NOTE: Only the parsing working memory is bounded. The merged geometry is copied into the SDK scene before the source is released,
+	//	so the peak memory of the import is about twice the size of the parsed geometry.
+	//
+	ref class	MeshFileImporter
+	{
+	public:		// METHODS
+
+		static bool				IsSupported( String^ _FileName );
+
+		// Parses the file into the given SDK scene, reporting progress & checking cancellation through the owner scene
+		static MeshFileReport^	Import( Scene^ _Owner, String^ _FileName, KFbxScene* _pScene, ImportOptions^ _Options );
+	};
+}
@@ -0,0 +1,1557 @@
+// Native streaming OBJ & PLY readers
+//
+#ifdef _MANAGED
+#pragma unmanaged
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MeshFileSource.h"
+
+using namespace	FBXImporter;
+
+static const int	NO_INDEX = (int) 0x80000000;	// Missing OBJ corner indices while parsing (-1 is a valid relative index)
+static const int	MISSING_INDEX = -1;				// Missing UV & normal corner indices once committed
+static const int	SCAN_WINDOW_SIZE = 32 << 20;	// Size of the views mapped while scanning PLY records
+
+//////////////////////////////////////////////////////////////////////////
+// Fast number parsing
+// Numbers are parsed in place, without copying the text or calling the CRT (strtod() is locale-aware and way too slow).
+// Up to 19 significant digits are accumulated in an integer that is then scaled by an exact power of 10, which is
+//	correctly rounded for the usual 6 to 9 significant digits & more than accurate enough for floats otherwise.
+//
+static const double	ms_pPowersOf10[] =
+{
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool	IsSpace( char _c )		{ return _c == ' ' || _c == '\t' || _c == '\r'; }
+static inline bool	IsDigit( char _c )		{ return (unsigned char) (_c - '0') < 10; }
+
+static inline const char*	SkipSpaces( const char* _p, const char* _pEnd )
+{
+	while ( _p < _pEnd && IsSpace( *_p ) )
+		_p++;
+	return	_p;
+}
+
+static inline const char*	SkipToken( const char* _p, const char* _pEnd )
+{
+	while ( _p < _pEnd && !IsSpace( *_p ) )
+		_p++;
+	return	_p;
+}
+
+static bool	ParseFloat( const char*& _p, const char* _pEnd, float& _Value )
+{
+	const char*	p = SkipSpaces( _p, _pEnd );
+
+	bool	bNegative = false;
+	if ( p < _pEnd && (*p == '-' || *p == '+') )
+		bNegative = *p++ == '-';
+
+	unsigned long long	Mantissa = 0;
+	int					DigitsCount = 0;
+	int					Exponent = 0;
+	bool				bDigits = false;
+	for ( ; p < _pEnd && IsDigit( *p ); p++ )
+	{
+		bDigits = true;
+		if ( DigitsCount < 19 )
+		{
+			Mantissa = 10 * Mantissa + (*p - '0');
+			DigitsCount += Mantissa != 0;
+		}
+		else
+			Exponent++;
+	}
+	if ( p < _pEnd && *p == '.' )
+		for ( p++; p < _pEnd && IsDigit( *p ); p++ )
+		{
+			bDigits = true;
+			if ( DigitsCount < 19 )
+			{
+				Mantissa = 10 * Mantissa + (*p - '0');
+				DigitsCount += Mantissa != 0;
+				Exponent--;
+			}
+		}
+	if ( !bDigits )
+		return	false;
+
+	if ( p < _pEnd && (*p == 'e' || *p == 'E') )
+	{
+		const char*	pExponent = p + 1;
+		bool		bNegativeExponent = false;
+		if ( pExponent < _pEnd && (*pExponent == '-' || *pExponent == '+') )
+			bNegativeExponent = *pExponent++ == '-';
+
+		if ( pExponent < _pEnd && IsDigit( *pExponent ) )
+		{
+			int	ExplicitExponent = 0;
+			for ( ; pExponent < _pEnd && IsDigit( *pExponent ); pExponent++ )
+				if ( ExplicitExponent < 10000 )
+					ExplicitExponent = 10 * ExplicitExponent + (*pExponent - '0');
+
+			Exponent += bNegativeExponent ? -ExplicitExponent : ExplicitExponent;
+			p = pExponent;
+		}
+	}
+
+	double	Value = (double) Mantissa;
+	if ( Value != 0.0 )
+	{
+		for ( ; Exponent > 22; Exponent -= 22 )
+			Value *= 1e22;
+		for ( ; Exponent < -22; Exponent += 22 )
+			Value /= 1e22;
+		Value = Exponent >= 0 ? Value * ms_pPowersOf10[Exponent] : Value / ms_pPowersOf10[-Exponent];
+	}
+
+	_Value = (float) (bNegative ? -Value : Value);
+	_p = p;
+	return	true;
+}
+
+static bool	ParseInt( const char*& _p, const char* _pEnd, int& _Value )
+{
+	const char*	p = SkipSpaces( _p, _pEnd );
+
+	bool	bNegative = false;
+	if ( p < _pEnd && (*p == '-' || *p == '+') )
+		bNegative = *p++ == '-';
+	if ( p == _pEnd || !IsDigit( *p ) )
+		return	false;
+
+	int	Value = 0;
+	for ( ; p < _pEnd && IsDigit( *p ); p++ )
+	{
+		if ( Value > (0x7FFFFFFF - 9) / 10 )
+			return	false;	// Overflow
+		Value = 10 * Value + (*p - '0');
+	}
+
+	_Value = bNegative ? -Value : Value;
+	_p = p;
+	return	true;
+}
+
+// Compares a token with a keyword
+static inline bool	IsToken( const char* _pToken, const char* _pTokenEnd, const char* _pKeyword )
+{
+	size_t	Length = strlen( _pKeyword );
+	return	size_t(_pTokenEnd - _pToken) == Length && !memcmp( _pToken, _pKeyword, Length );
+}
+
+// Trims the spaces at the end of a name
+static inline const char*	TrimEnd( const char* _pStart, const char* _pEnd )
+{
+	while ( _pEnd > _pStart && IsSpace( _pEnd[-1] ) )
+		_pEnd--;
+	return	_pEnd;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// PLY values
+static const int	ms_pPLYTypeSizes[] = { 0, 1, 1, 2, 2, 4, 4, 4, 8 };
+
+static double	ReadPLYValue( const unsigned char* _p, int _Type, bool _bSwap )
+{
+	unsigned char	pBytes[8];
+	int				Size = ms_pPLYTypeSizes[_Type];
+	for ( int ByteIndex=0; ByteIndex < Size; ByteIndex++ )
+		pBytes[ByteIndex] = _bSwap ? _p[Size-1-ByteIndex] : _p[ByteIndex];
+
+	switch ( _Type )
+	{
+	case 1:	return	*((signed char*) pBytes);
+	case 2:	return	*((unsigned char*) pBytes);
+	case 3:	{ short v; memcpy( &v, pBytes, 2 ); return v; }
+	case 4:	{ unsigned short v; memcpy( &v, pBytes, 2 ); return v; }
+	case 5:	{ int v; memcpy( &v, pBytes, 4 ); return v; }
+	case 6:	{ unsigned int v; memcpy( &v, pBytes, 4 ); return v; }
+	case 7:	{ float v; memcpy( &v, pBytes, 4 ); return v; }
+	case 8:	{ double v; memcpy( &v, pBytes, 8 ); return v; }
+	}
+
+	return	0.0;
+}
+
+// Pads a lazily allocated array to the given count
+template<typename T> static inline void	PadArray( ParseArray<T>& _Array, int _Count, const T& _Value )
+{
+	if ( _Array.GetCount() < _Count )
+		_Array.Append( NULL, _Count - _Array.GetCount(), _Value );
+}
+
+static inline void	AddCornerIndex( ParseArray<int>& _Corners, int _CornerIndex, int _Index )
+{
+	if ( _Index == NO_INDEX && _Corners.GetCount() == 0 )
+		return;	// Not allocated yet
+
+	PadArray( _Corners, _CornerIndex, NO_INDEX );
+	_Corners.Add( _Index );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Chunks
+void	MeshFileSource::Chunk::Release()
+{
+	Positions.Clear();
+	Colors.Clear();
+	Normals.Clear();
+	UVs.Clear();
+	PolygonSizes.Clear();
+	CornerVertices.Clear();
+	CornerUVs.Clear();
+	CornerNormals.Clear();
+	RelativeCorners.Clear();
+	Events.Clear();
+	Names.Clear();
+}
+
+MeshFileSource::MeshFileSource() : m_pFileName( NULL ), m_pChunks( NULL )
+{
+	Clear();
+}
+
+MeshFileSource::~MeshFileSource()
+{
+	Clear();
+}
+
+void	MeshFileSource::Clear()
+{
+	for ( int ObjectIndex=0; ObjectIndex < m_Objects.GetCount(); ObjectIndex++ )
+	{
+		delete[] m_Objects[ObjectIndex].pVertices;
+		delete[] m_Objects[ObjectIndex].pUVs;
+		delete[] m_Objects[ObjectIndex].pNormals;
+		delete[] m_Objects[ObjectIndex].pMaterials;
+	}
+
+	delete[] m_pChunks;
+	delete[] m_pFileName;
+	m_pChunks = NULL;
+	m_pFileName = NULL;
+	m_ChunksCount = 0;
+	m_CommittedChunksCount = 0;
+	m_PLYElementsCount = 0;
+	m_Format = FORMAT_OBJ;
+	m_ChunkSize = DEFAULT_CHUNK_SIZE;
+	m_pError[0] = '\0';
+
+	m_File.Close();
+	m_FileSize = 0;
+	m_Positions.Clear();
+	m_Colors.Clear();
+	m_Normals.Clear();
+	m_UVs.Clear();
+	m_PolygonSizes.Clear();
+	m_PolygonMaterials.Clear();
+	m_CornerVertices.Clear();
+	m_CornerUVs.Clear();
+	m_CornerNormals.Clear();
+	m_Names.Clear();
+	m_Objects.Clear();
+	m_Materials.Clear();
+	m_Libraries.Clear();
+	m_CurrentMaterial = -1;
+	m_bNormalsPerVertex = false;
+	m_RootNameOffset = 0;
+}
+
+bool	MeshFileSource::SetError( const char* _pFormat, const char* _pArgument )
+{
+	char	pArgument[128];
+	strncpy( pArgument, _pArgument != NULL ? _pArgument : "", sizeof(pArgument)-1 );
+	pArgument[sizeof(pArgument)-1] = '\0';
+
+	sprintf( m_pError, _pFormat, pArgument );
+	return	false;
+}
+
+bool	MeshFileSource::IsSupported( const char* _pFileName )
+{
+	const char*	pExtension = strrchr( _pFileName, '.' );
+	if ( pExtension == NULL )
+		return	false;
+
+	char	pLower[5] = { 0 };
+	for ( int CharIndex=0; CharIndex < 4 && pExtension[CharIndex] != '\0'; CharIndex++ )
+		pLower[CharIndex] = pExtension[CharIndex] >= 'A' && pExtension[CharIndex] <= 'Z' ? pExtension[CharIndex] - 'A' + 'a' : pExtension[CharIndex];
+
+	return	!strcmp( pLower, ".obj" ) || !strcmp( pLower, ".ply" );
+}
+
+int		MeshFileSource::AddName( const char* _pName, int _Length )
+{
+	int	Offset = m_Names.GetCount();
+	m_Names.Append( _pName, _Length, '\0' );
+	m_Names.Add( '\0' );
+	return	Offset;
+}
+
+int		MeshFileSource::FindMaterial( const char* _pName )
+{
+	for ( int MaterialIndex=0; MaterialIndex < m_Materials.GetCount(); MaterialIndex++ )
+		if ( !strcmp( m_Names.GetValues() + m_Materials[MaterialIndex].NameOffset, _pName ) )
+			return	MaterialIndex;
+
+	MeshMaterial	Material;
+	Material.NameOffset = AddName( _pName, (int) strlen( _pName ) );
+	Material.Diffuse[0] = Material.Diffuse[1] = Material.Diffuse[2] = 0.8f;
+	Material.Specular[0] = Material.Specular[1] = Material.Specular[2] = 0.0f;
+	Material.Emissive[0] = Material.Emissive[1] = Material.Emissive[2] = 0.0f;
+	Material.Shininess = 1.0f;
+	Material.Opacity = 1.0f;
+	m_Materials.Add( Material );
+
+	return	m_Materials.GetCount() - 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Opening & splitting
+bool	MeshFileSource::Open( const char* _pFileName, int _ChunkSize )
+{
+	Clear();
+	m_ChunkSize = _ChunkSize > MAX_LINE_LENGTH ? _ChunkSize : MAX_LINE_LENGTH;
+
+	size_t	FileNameLength = strlen( _pFileName );
+	m_pFileName = new char[FileNameLength+1];
+	memcpy( m_pFileName, _pFileName, FileNameLength+1 );
+
+	// The root is named after the file
+	const char*	pBaseName = _pFileName + FileNameLength;
+	while ( pBaseName > _pFileName && pBaseName[-1] != '/' && pBaseName[-1] != '\\' )
+		pBaseName--;
+	const char*	pExtension = strrchr( pBaseName, '.' );
+	m_RootNameOffset = AddName( pBaseName, int((pExtension != NULL ? pExtension : _pFileName + FileNameLength) - pBaseName) );
+
+	if ( !m_File.Open( _pFileName ) )
+		return	SetError( "Failed to open \"%s\"", _pFileName );
+	m_FileSize = m_File.GetSize();
+
+	// Check for a PLY header
+	MappedView	Header;
+	if ( !Header.Map( m_File, 0, MAX_LINE_LENGTH ) )
+		return	SetError( "Failed to map \"%s\"", _pFileName );
+
+	if ( Header.GetSize() >= 4 && !memcmp( Header.GetData(), "ply", 3 ) && (Header.GetData()[3] == '\n' || Header.GetData()[3] == '\r') )
+	{
+		int	HeaderSize = 0;
+		if ( !ReadPLYHeader( Header.GetData(), (int) Header.GetSize(), HeaderSize ) )
+			return	false;
+
+		Header.Unmap();
+		return	SplitPLY( HeaderSize );
+	}
+
+	m_Format = FORMAT_OBJ;
+	return	SplitOBJ();
+}
+
+bool	MeshFileSource::SplitOBJ()
+{
+	// OBJ chunks are fixed ranges of the file, lines are assigned to the chunk they start in
+	long long	ChunksCount = (m_File.GetSize() + m_ChunkSize - 1) / m_ChunkSize;
+	if ( ChunksCount > 0x7FFFFFFF )
+		return	SetError( "File \"%s\" is too large", m_pFileName );
+
+	m_ChunksCount = (int) ChunksCount;
+	m_pChunks = new Chunk[m_ChunksCount > 0 ? m_ChunksCount : 1];
+	for ( int ChunkIndex=0; ChunkIndex < m_ChunksCount; ChunkIndex++ )
+	{
+		Chunk&	C = m_pChunks[ChunkIndex];
+		C.Start = (long long) ChunkIndex * m_ChunkSize;
+		C.End = C.Start + m_ChunkSize < m_File.GetSize() ? C.Start + m_ChunkSize : m_File.GetSize();
+		C.ElementIndex = -1;
+		C.FirstRecord = C.RecordsCount = 0;
+		C.bParsed = false;
+		C.pError[0] = '\0';
+	}
+
+	return	true;
+}
+
+bool	MeshFileSource::ReadPLYHeader( const char* _pHeader, int _Size, int& _HeaderSize )
+{
+	const char*	pEnd = _pHeader + _Size;
+	const char*	p = _pHeader;
+	PLYElement*	pElement = NULL;
+	bool		bFormat = false;
+
+	while ( true )
+	{
+		const char*	pLineEnd = (const char*) memchr( p, '\n', pEnd - p );
+		if ( pLineEnd == NULL )
+			return	SetError( "Invalid PLY header in \"%s\" (missing end_header)", m_pFileName );
+
+		const char*	pToken = SkipSpaces( p, pLineEnd );
+		const char*	pTokenEnd = SkipToken( pToken, pLineEnd );
+		p = pLineEnd + 1;
+
+		if ( IsToken( pToken, pTokenEnd, "end_header" ) )
+			break;
+
+		if ( IsToken( pToken, pTokenEnd, "format" ) )
+		{
+			pToken = SkipSpaces( pTokenEnd, pLineEnd );
+			pTokenEnd = SkipToken( pToken, pLineEnd );
+			if ( IsToken( pToken, pTokenEnd, "ascii" ) )
+				m_Format = FORMAT_PLY_ASCII;
+			else if ( IsToken( pToken, pTokenEnd, "binary_little_endian" ) )
+				m_Format = FORMAT_PLY_BINARY_LITTLE_ENDIAN;
+			else if ( IsToken( pToken, pTokenEnd, "binary_big_endian" ) )
+				m_Format = FORMAT_PLY_BINARY_BIG_ENDIAN;
+			else
+				return	SetError( "Unsupported PLY format in \"%s\"", m_pFileName );
+			bFormat = true;
+		}
+		else if ( IsToken( pToken, pTokenEnd, "element" ) )
+		{
+			if ( m_PLYElementsCount == MAX_PLY_ELEMENTS )
+				return	SetError( "Too many PLY elements in \"%s\"", m_pFileName );
+
+			pElement = &m_pPLYElements[m_PLYElementsCount++];
+			memset( pElement, 0, sizeof(PLYElement) );
+
+			pToken = SkipSpaces( pTokenEnd, pLineEnd );
+			pTokenEnd = SkipToken( pToken, pLineEnd );
+			pElement->Kind = IsToken( pToken, pTokenEnd, "vertex" ) ? PLYElement::KIND_VERTEX : (IsToken( pToken, pTokenEnd, "face" ) ? PLYElement::KIND_FACE : PLYElement::KIND_OTHER);
+			if ( !ParseInt( pTokenEnd, pLineEnd, pElement->Count ) || pElement->Count < 0 )
+				return	SetError( "Invalid PLY element count in \"%s\"", m_pFileName );
+		}
+		else if ( IsToken( pToken, pTokenEnd, "property" ) )
+		{
+			if ( pElement == NULL || pElement->PropertiesCount == MAX_PLY_PROPERTIES )
+				return	SetError( "Invalid PLY property in \"%s\"", m_pFileName );
+
+			PLYProperty&	Property = pElement->pProperties[pElement->PropertiesCount++];
+			Property.CountType = PLY_INVALID;
+			Property.Semantic = SEMANTIC_NONE;
+
+			// Read the type (and the count type of lists)
+			static const char*	ppTypeNames[] = { "", "char", "uchar", "short", "ushort", "int", "uint", "float", "double" };
+			static const char*	ppSizedTypeNames[] = { "", "int8", "uint8", "int16", "uint16", "int32", "uint32", "float32", "float64" };
+			PLY_TYPE*			pTypes[2] = { &Property.CountType, &Property.Type };
+
+			pToken = SkipSpaces( pTokenEnd, pLineEnd );
+			pTokenEnd = SkipToken( pToken, pLineEnd );
+			bool	bList = IsToken( pToken, pTokenEnd, "list" );
+			for ( int TypeIndex=bList ? 0 : 1; TypeIndex < 2; TypeIndex++ )
+			{
+				if ( bList )
+				{
+					pToken = SkipSpaces( pTokenEnd, pLineEnd );
+					pTokenEnd = SkipToken( pToken, pLineEnd );
+				}
+
+				*pTypes[TypeIndex] = PLY_INVALID;
+				for ( int Type=PLY_CHAR; Type <= PLY_DOUBLE; Type++ )
+					if ( IsToken( pToken, pTokenEnd, ppTypeNames[Type] ) || IsToken( pToken, pTokenEnd, ppSizedTypeNames[Type] ) )
+						*pTypes[TypeIndex] = (PLY_TYPE) Type;
+				if ( *pTypes[TypeIndex] == PLY_INVALID )
+					return	SetError( "Invalid PLY property type in \"%s\"", m_pFileName );
+			}
+
+			// Recognize the name
+			pToken = SkipSpaces( pTokenEnd, pLineEnd );
+			pTokenEnd = SkipToken( pToken, pLineEnd );
+			if ( bList )
+			{
+				if ( pElement->Kind == PLYElement::KIND_FACE && (IsToken( pToken, pTokenEnd, "vertex_indices" ) || IsToken( pToken, pTokenEnd, "vertex_index" )) )
+					Property.Semantic = SEMANTIC_INDICES;
+			}
+			else if ( pElement->Kind == PLYElement::KIND_VERTEX )
+			{
+				static const char*	ppNames[] =
+				{
+					"x", "y", "z", "nx", "ny", "nz", "u", "v", "red", "green", "blue", "alpha",
+					"s", "t", "texture_u", "texture_v", "texture_s", "texture_t", "diffuse_red", "diffuse_green", "diffuse_blue",
+				};
+				static const PLY_SEMANTIC	pSemantics[] =
+				{
+					SEMANTIC_X, SEMANTIC_Y, SEMANTIC_Z, SEMANTIC_NX, SEMANTIC_NY, SEMANTIC_NZ, SEMANTIC_U, SEMANTIC_V, SEMANTIC_RED, SEMANTIC_GREEN, SEMANTIC_BLUE, SEMANTIC_ALPHA,
+					SEMANTIC_U, SEMANTIC_V, SEMANTIC_U, SEMANTIC_V, SEMANTIC_U, SEMANTIC_V, SEMANTIC_RED, SEMANTIC_GREEN, SEMANTIC_BLUE,
+				};
+				for ( int NameIndex=0; NameIndex < int(sizeof(pSemantics) / sizeof(pSemantics[0])); NameIndex++ )
+					if ( IsToken( pToken, pTokenEnd, ppNames[NameIndex] ) )
+						Property.Semantic = pSemantics[NameIndex];
+			}
+		}
+		// Comments & obj_info are ignored
+	}
+
+	if ( !bFormat )
+		return	SetError( "Invalid PLY header in \"%s\" (missing format)", m_pFileName );
+
+	_HeaderSize = int(p - _pHeader);
+	return	true;
+}
+
+bool	MeshFileSource::SplitPLY( long long _DataStart )
+{
+	bool		bBinary = m_Format != FORMAT_PLY_ASCII;
+	bool		bSwap = m_Format == FORMAT_PLY_BINARY_BIG_ENDIAN;
+	long long	Offset = _DataStart;
+
+	// Count the chunks as we go (an element can't have more chunks than records)
+	long long	MaxChunksCount = 0;
+	for ( int ElementIndex=0; ElementIndex < m_PLYElementsCount; ElementIndex++ )
+		if ( m_pPLYElements[ElementIndex].Kind != PLYElement::KIND_OTHER )
+			MaxChunksCount += 1 + m_File.GetSize() / m_ChunkSize;
+	if ( MaxChunksCount > 0x7FFFFFFF )
+		return	SetError( "File \"%s\" is too large", m_pFileName );
+
+	m_pChunks = new Chunk[MaxChunksCount > 0 ? (int) MaxChunksCount : 1];
+
+	for ( int ElementIndex=0; ElementIndex < m_PLYElementsCount; ElementIndex++ )
+	{
+		PLYElement&	Element = m_pPLYElements[ElementIndex];
+		Element.Start = Offset;
+
+		bool	bFixedSize = bBinary;
+		Element.RecordSize = 0;
+		for ( int PropertyIndex=0; PropertyIndex < Element.PropertiesCount; PropertyIndex++ )
+		{
+			bFixedSize &= Element.pProperties[PropertyIndex].CountType == PLY_INVALID;
+			Element.RecordSize += ms_pPLYTypeSizes[Element.pProperties[PropertyIndex].Type];
+		}
+		if ( !bFixedSize )
+			Element.RecordSize = 0;
+
+		bool	bChunked = Element.Kind != PLYElement::KIND_OTHER;
+		if ( Element.RecordSize > 0 )
+		{	// Records of fixed size are split directly
+			int	RecordsPerChunk = m_ChunkSize / Element.RecordSize;
+			for ( int FirstRecord=0; bChunked && FirstRecord < Element.Count; FirstRecord += RecordsPerChunk )
+			{
+				Chunk&	C = m_pChunks[m_ChunksCount++];
+				C.ElementIndex = ElementIndex;
+				C.FirstRecord = FirstRecord;
+				C.RecordsCount = Element.Count - FirstRecord < RecordsPerChunk ? Element.Count - FirstRecord : RecordsPerChunk;
+				C.Start = Offset + (long long) FirstRecord * Element.RecordSize;
+				C.End = C.Start + (long long) C.RecordsCount * Element.RecordSize;
+			}
+			Offset += (long long) Element.Count * Element.RecordSize;
+		}
+		else
+		{	// Scan the records (lines or binary records with lists) to find where they end
+			MappedView	Window;
+			long long	WindowStart = -1;
+			long long	ChunkStart = Offset;
+			int			ChunkFirstRecord = 0;
+			for ( int RecordIndex=0; RecordIndex < Element.Count; RecordIndex++ )
+			{
+				if ( WindowStart < 0 || Offset - WindowStart > SCAN_WINDOW_SIZE )
+				{
+					WindowStart = Offset;
+					if ( !Window.Map( m_File, WindowStart, SCAN_WINDOW_SIZE + MAX_LINE_LENGTH ) )
+						return	SetError( "Failed to map \"%s\"", m_pFileName );
+				}
+
+				const char*	pRecord = Window.GetData() + (Offset - WindowStart);
+				const char*	pWindowEnd = Window.GetData() + Window.GetSize();
+				if ( bBinary )
+				{
+					const unsigned char*	p = (const unsigned char*) pRecord;
+					for ( int PropertyIndex=0; PropertyIndex < Element.PropertiesCount; PropertyIndex++ )
+					{
+						const PLYProperty&	Property = Element.pProperties[PropertyIndex];
+						int					ValuesCount = 1;
+						if ( Property.CountType != PLY_INVALID )
+						{
+							if ( p + ms_pPLYTypeSizes[Property.CountType] > (const unsigned char*) pWindowEnd )
+								return	SetError( "Truncated PLY file \"%s\"", m_pFileName );
+							ValuesCount = (int) ReadPLYValue( p, Property.CountType, bSwap );
+							p += ms_pPLYTypeSizes[Property.CountType];
+						}
+						p += ValuesCount * ms_pPLYTypeSizes[Property.Type];
+					}
+					if ( p > (const unsigned char*) pWindowEnd )
+						return	SetError( "Truncated PLY file or record too large in \"%s\"", m_pFileName );
+					Offset += (const char*) p - pRecord;
+				}
+				else
+				{
+					const char*	pLineEnd = (const char*) memchr( pRecord, '\n', pWindowEnd - pRecord );
+					if ( pLineEnd == NULL && pWindowEnd - Window.GetData() + WindowStart < m_File.GetSize() )
+						return	SetError( "Line too long in \"%s\"", m_pFileName );
+					Offset += (pLineEnd != NULL ? pLineEnd + 1 : pWindowEnd) - pRecord;
+				}
+
+				if ( bChunked && (Offset - ChunkStart >= m_ChunkSize || RecordIndex == Element.Count-1) )
+				{
+					Chunk&	C = m_pChunks[m_ChunksCount++];
+					C.ElementIndex = ElementIndex;
+					C.FirstRecord = ChunkFirstRecord;
+					C.RecordsCount = RecordIndex + 1 - ChunkFirstRecord;
+					C.Start = ChunkStart;
+					C.End = Offset;
+					ChunkStart = Offset;
+					ChunkFirstRecord = RecordIndex + 1;
+				}
+			}
+		}
+
+		Element.End = Offset;
+		if ( Offset > m_File.GetSize() )
+			return	SetError( "Truncated PLY file \"%s\"", m_pFileName );
+	}
+
+	for ( int ChunkIndex=0; ChunkIndex < m_ChunksCount; ChunkIndex++ )
+	{
+		m_pChunks[ChunkIndex].bParsed = false;
+		m_pChunks[ChunkIndex].pError[0] = '\0';
+	}
+
+	return	true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Parsing
+bool	MeshFileSource::ParseChunk( int _ChunkIndex )
+{
+	Chunk&		C = m_pChunks[_ChunkIndex];
+	MappedView	View;
+	bool		bResult = false;
+
+	if ( m_Format == FORMAT_OBJ )
+	{	// Map the previous character to know if a line starts at the beginning of the chunk & enough to finish the last line
+		long long	ViewStart = C.Start > 0 ? C.Start - 1 : 0;
+		if ( !View.Map( m_File, ViewStart, C.End - ViewStart + MAX_LINE_LENGTH ) )
+			sprintf( C.pError, "Failed to map chunk %d", _ChunkIndex );
+		else
+		{
+			const char*	pStart = View.GetData();
+			if ( C.Start > 0 )
+			{	// Skip the end of the line started in the previous chunk
+				pStart = (const char*) memchr( pStart, '\n', View.GetSize() );
+				pStart = pStart != NULL ? pStart + 1 : View.GetData() + View.GetSize();
+			}
+			const char*	pLimit = View.GetData() + (C.End - ViewStart);
+			bool		bEndOfFile = ViewStart + (long long) View.GetSize() == m_File.GetSize();
+			bResult = ParseOBJChunk( C, pStart, pLimit, View.GetData() + View.GetSize(), bEndOfFile );
+		}
+	}
+	else
+	{
+		if ( !View.Map( m_File, C.Start, C.End - C.Start ) )
+			sprintf( C.pError, "Failed to map chunk %d", _ChunkIndex );
+		else
+			bResult = ParsePLYChunk( C, View.GetData(), View.GetData() + View.GetSize() );
+	}
+
+	C.bParsed = true;
+	return	bResult;
+}
+
+
+// Converts an OBJ index (1-based or negative to count from the last element) into a 0-based index
+// Negative indices are made relative to the first element of the chunk & recorded to be fixed when the chunk is committed,
+//	as they may refer to elements of the previous chunks (they're checked against the global counts then)
+static inline bool	ConvertOBJIndex( int& _Index, int _LocalCount, ParseArray<int>& _RelativeCorners, int _CornerIndex, int _Array )
+{
+	if ( _Index == 0 )
+		return	false;
+
+	if ( _Index > 0 )
+		_Index--;
+	else
+	{
+		_Index += _LocalCount;
+		_RelativeCorners.Add( 3 * _CornerIndex + _Array );
+	}
+	return	true;
+}
+
+bool	MeshFileSource::ParseOBJLine( Chunk& _Chunk, const char* p, const char* pLineEnd )
+{
+	p = SkipSpaces( p, pLineEnd );
+	if ( p == pLineEnd )
+		return	true;
+
+	const char*	pKeyword = p;
+	p = SkipToken( p, pLineEnd );
+	int			KeywordLength = int(p - pKeyword);
+
+	if ( KeywordLength == 1 && pKeyword[0] == 'v' )
+	{	// Position with optional w or colors
+		float	pValues[7];
+		int		ValuesCount = 0;
+		while ( ValuesCount < 7 && ParseFloat( p, pLineEnd, pValues[ValuesCount] ) )
+			ValuesCount++;
+		if ( ValuesCount < 3 )
+			return	false;
+
+		int	VerticesCount = _Chunk.Positions.GetCount() / 3;
+		_Chunk.Positions.Append( pValues, 3, 0.0f );
+		if ( ValuesCount >= 6 || _Chunk.Colors.GetCount() > 0 )
+		{
+			static const float	pWhite[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+			PadArray( _Chunk.Colors, 4 * VerticesCount, 1.0f );
+			_Chunk.Colors.Append( ValuesCount >= 6 ? pValues + 3 : pWhite, 3, 0.0f );
+			_Chunk.Colors.Add( 1.0f );
+		}
+	}
+	else if ( KeywordLength == 2 && pKeyword[0] == 'v' && pKeyword[1] == 't' )
+	{
+		float	pValues[2] = { 0.0f, 0.0f };
+		if ( !ParseFloat( p, pLineEnd, pValues[0] ) )
+			return	false;
+		ParseFloat( p, pLineEnd, pValues[1] );
+		_Chunk.UVs.Append( pValues, 2, 0.0f );
+	}
+	else if ( KeywordLength == 2 && pKeyword[0] == 'v' && pKeyword[1] == 'n' )
+	{
+		float	pValues[3];
+		if ( !ParseFloat( p, pLineEnd, pValues[0] ) || !ParseFloat( p, pLineEnd, pValues[1] ) || !ParseFloat( p, pLineEnd, pValues[2] ) )
+			return	false;
+		_Chunk.Normals.Append( pValues, 3, 0.0f );
+	}
+	else if ( KeywordLength == 1 && pKeyword[0] == 'f' )
+	{	// Face made of v, v/vt, v//vn or v/vt/vn corners
+		int	CornersCount = 0;
+		while ( true )
+		{
+			p = SkipSpaces( p, pLineEnd );
+			if ( p == pLineEnd )
+				break;
+
+			int	CornerIndex = _Chunk.CornerVertices.GetCount();
+			int	VertexIndex, UVIndex = NO_INDEX, NormalIndex = NO_INDEX;
+			if ( !ParseInt( p, pLineEnd, VertexIndex ) || !ConvertOBJIndex( VertexIndex, _Chunk.Positions.GetCount() / 3, _Chunk.RelativeCorners, CornerIndex, 0 ) )
+				break;
+			if ( p < pLineEnd && *p == '/' )
+			{
+				p++;
+				if ( p < pLineEnd && *p != '/' && (!ParseInt( p, pLineEnd, UVIndex ) || !ConvertOBJIndex( UVIndex, _Chunk.UVs.GetCount() / 2, _Chunk.RelativeCorners, CornerIndex, 1 )) )
+					break;
+				if ( p < pLineEnd && *p == '/' )
+				{
+					p++;
+					if ( !ParseInt( p, pLineEnd, NormalIndex ) || !ConvertOBJIndex( NormalIndex, _Chunk.Normals.GetCount() / 3, _Chunk.RelativeCorners, CornerIndex, 2 ) )
+						break;
+				}
+			}
+			if ( p < pLineEnd && !IsSpace( *p ) )
+				break;
+
+			AddCornerIndex( _Chunk.CornerUVs, CornerIndex, UVIndex );
+			AddCornerIndex( _Chunk.CornerNormals, CornerIndex, NormalIndex );
+			_Chunk.CornerVertices.Add( VertexIndex );
+			CornersCount++;
+		}
+		if ( p != pLineEnd || CornersCount < 3 )
+			return	false;
+
+		_Chunk.PolygonSizes.Add( CornersCount );
+	}
+	else if ( KeywordLength == 1 && (pKeyword[0] == 'o' || pKeyword[0] == 'g') )
+	{
+		p = SkipSpaces( p, pLineEnd );
+
+		ChunkEvent	Event;
+		Event.Type = ChunkEvent::TYPE_OBJECT;
+		Event.PolygonIndex = _Chunk.PolygonSizes.GetCount();
+		Event.NameOffset = _Chunk.Names.GetCount();
+		_Chunk.Names.Append( p, int(TrimEnd( p, pLineEnd ) - p), '\0' );
+		_Chunk.Names.Add( '\0' );
+		_Chunk.Events.Add( Event );
+	}
+	else if ( IsToken( pKeyword, p, "usemtl" ) || IsToken( pKeyword, p, "mtllib" ) )
+	{
+		ChunkEvent	Event;
+		Event.Type = pKeyword[0] == 'u' ? ChunkEvent::TYPE_MATERIAL : ChunkEvent::TYPE_LIBRARY;
+		Event.PolygonIndex = _Chunk.PolygonSizes.GetCount();
+		Event.NameOffset = _Chunk.Names.GetCount();
+
+		p = SkipSpaces( p, pLineEnd );
+		_Chunk.Names.Append( p, int(TrimEnd( p, pLineEnd ) - p), '\0' );
+		_Chunk.Names.Add( '\0' );
+		_Chunk.Events.Add( Event );
+	}
+	// Comments, smoothing groups, points, lines, free-form geometry & unknown statements are ignored
+
+	return	true;
+}
+
+bool	MeshFileSource::ParseOBJChunk( Chunk& _Chunk, const char* _pStart, const char* _pLimit, const char* _pEnd, bool _bEndOfFile )
+{
+	const char*	pLineEnd = NULL;
+	for ( const char* p=_pStart; p < _pLimit; p=pLineEnd+1 )
+	{
+		pLineEnd = (const char*) memchr( p, '\n', _pEnd - p );
+		if ( pLineEnd == NULL )
+		{
+			if ( !_bEndOfFile )
+			{
+				sprintf( _Chunk.pError, "Line too long near byte %lld", _Chunk.Start + (p - _pStart) );
+				return	false;
+			}
+			pLineEnd = _pEnd;
+		}
+
+		if ( !ParseOBJLine( _Chunk, p, pLineEnd ) )
+		{
+			sprintf( _Chunk.pError, "Invalid statement near byte %lld", _Chunk.Start + (p - _pStart) );
+			return	false;
+		}
+	}
+
+	// Complete the lazily allocated arrays
+	if ( _Chunk.Colors.GetCount() > 0 )
+		PadArray( _Chunk.Colors, 4 * (_Chunk.Positions.GetCount() / 3), 1.0f );
+	if ( _Chunk.CornerUVs.GetCount() > 0 )
+		PadArray( _Chunk.CornerUVs, _Chunk.CornerVertices.GetCount(), NO_INDEX );
+	if ( _Chunk.CornerNormals.GetCount() > 0 )
+		PadArray( _Chunk.CornerNormals, _Chunk.CornerVertices.GetCount(), NO_INDEX );
+
+	return	true;
+}
+
+bool	MeshFileSource::ParsePLYChunk( Chunk& _Chunk, const char* _pStart, const char* _pEnd )
+{
+	const PLYElement&	Element = m_pPLYElements[_Chunk.ElementIndex];
+	bool				bBinary = m_Format != FORMAT_PLY_ASCII;
+	bool				bSwap = m_Format == FORMAT_PLY_BINARY_BIG_ENDIAN;
+	bool				bVertex = Element.Kind == PLYElement::KIND_VERTEX;
+
+	// Find the attributes of the vertices (integer colors are normalized)
+	bool	pHasSemantic[SEMANTICS_COUNT] = { false };
+	float	pScales[MAX_PLY_PROPERTIES];
+	for ( int PropertyIndex=0; PropertyIndex < Element.PropertiesCount; PropertyIndex++ )
+	{
+		const PLYProperty&	Property = Element.pProperties[PropertyIndex];
+		if ( Property.Semantic != SEMANTIC_NONE )
+			pHasSemantic[Property.Semantic] = true;
+
+		pScales[PropertyIndex] = 1.0f;
+		if ( Property.Semantic >= SEMANTIC_RED && Property.Semantic <= SEMANTIC_ALPHA )
+			pScales[PropertyIndex] = Property.Type == PLY_UCHAR || Property.Type == PLY_CHAR ? 1.0f / 255.0f : (Property.Type == PLY_USHORT || Property.Type == PLY_SHORT ? 1.0f / 65535.0f : 1.0f);
+	}
+
+	if ( bVertex )
+	{
+		_Chunk.Positions.Reserve( 3 * _Chunk.RecordsCount );
+		if ( pHasSemantic[SEMANTIC_NX] )
+			_Chunk.Normals.Reserve( 3 * _Chunk.RecordsCount );
+		if ( pHasSemantic[SEMANTIC_U] )
+			_Chunk.UVs.Reserve( 2 * _Chunk.RecordsCount );
+		if ( pHasSemantic[SEMANTIC_RED] )
+			_Chunk.Colors.Reserve( 4 * _Chunk.RecordsCount );
+	}
+	else
+	{
+		_Chunk.PolygonSizes.Reserve( _Chunk.RecordsCount );
+		_Chunk.CornerVertices.Reserve( 3 * _Chunk.RecordsCount );
+	}
+
+	const char*	p = _pStart;
+	for ( int RecordIndex=0; RecordIndex < _Chunk.RecordsCount; RecordIndex++ )
+	{
+		float		pValues[SEMANTICS_COUNT] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f };
+		const char*	pRecordEnd = _pEnd;
+		if ( !bBinary )
+		{
+			pRecordEnd = (const char*) memchr( p, '\n', _pEnd - p );
+			if ( pRecordEnd == NULL )
+				pRecordEnd = _pEnd;
+		}
+
+		for ( int PropertyIndex=0; PropertyIndex < Element.PropertiesCount; PropertyIndex++ )
+		{
+			const PLYProperty&	Property = Element.pProperties[PropertyIndex];
+			int					ValueSize = ms_pPLYTypeSizes[Property.Type];
+			if ( Property.CountType != PLY_INVALID )
+			{	// List
+				int	Count = 0;
+				if ( bBinary )
+				{
+					if ( p + ms_pPLYTypeSizes[Property.CountType] > _pEnd )
+						goto Truncated;
+					Count = (int) ReadPLYValue( (const unsigned char*) p, Property.CountType, bSwap );
+					p += ms_pPLYTypeSizes[Property.CountType];
+					if ( Count < 0 || p + Count * ValueSize > _pEnd )
+						goto Truncated;
+				}
+				else if ( !ParseInt( p, pRecordEnd, Count ) || Count < 0 )
+					goto Invalid;
+
+				bool	bPolygon = Property.Semantic == SEMANTIC_INDICES && Count >= 3;
+				for ( int ValueIndex=0; ValueIndex < Count; ValueIndex++ )
+				{
+					int	Value = 0;
+					if ( bBinary )
+					{
+						if ( bPolygon )
+							Value = (int) ReadPLYValue( (const unsigned char*) p, Property.Type, bSwap );
+						p += ValueSize;
+					}
+					else
+					{
+						float	Dummy;
+						if ( bPolygon ? !ParseInt( p, pRecordEnd, Value ) : !ParseFloat( p, pRecordEnd, Dummy ) )
+							goto Invalid;
+					}
+					if ( bPolygon )
+					{
+						if ( Value < 0 )
+							goto Invalid;	// Out of range (too large indices are reported when the mesh is built)
+						_Chunk.CornerVertices.Add( Value );
+					}
+				}
+				if ( bPolygon )
+					_Chunk.PolygonSizes.Add( Count );	// Points & lines are dropped
+			}
+			else
+			{
+				float	Value = 0.0f;
+				if ( bBinary )
+				{
+					if ( p + ValueSize > _pEnd )
+						goto Truncated;
+					Value = (float) ReadPLYValue( (const unsigned char*) p, Property.Type, bSwap );
+					p += ValueSize;
+				}
+				else if ( !ParseFloat( p, pRecordEnd, Value ) )
+					goto Invalid;
+
+				if ( Property.Semantic != SEMANTIC_NONE && Property.Semantic != SEMANTIC_INDICES )
+					pValues[Property.Semantic] = Value * pScales[PropertyIndex];
+			}
+		}
+
+		if ( bVertex )
+		{
+			_Chunk.Positions.Append( pValues + SEMANTIC_X, 3, 0.0f );
+			if ( pHasSemantic[SEMANTIC_NX] )
+				_Chunk.Normals.Append( pValues + SEMANTIC_NX, 3, 0.0f );
+			if ( pHasSemantic[SEMANTIC_U] )
+				_Chunk.UVs.Append( pValues + SEMANTIC_U, 2, 0.0f );
+			if ( pHasSemantic[SEMANTIC_RED] )
+				_Chunk.Colors.Append( pValues + SEMANTIC_RED, 4, 0.0f );
+		}
+
+		if ( !bBinary )
+			p = pRecordEnd + 1;
+	}
+
+	return	true;
+
+Truncated:
+	sprintf( _Chunk.pError, "Truncated record in chunk starting at byte %lld", _Chunk.Start );
+	return	false;
+
+Invalid:
+	sprintf( _Chunk.pError, "Invalid record in chunk starting at byte %lld", _Chunk.Start );
+	return	false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Committing
+bool	MeshFileSource::CommitChunk( int _ChunkIndex )
+{
+	Chunk&	C = m_pChunks[_ChunkIndex];
+	if ( _ChunkIndex != m_CommittedChunksCount || !C.bParsed )
+		return	SetError( "Chunks of \"%s\" must be parsed then committed in order", m_pFileName );
+
+	// Resolve the relative indices now that we know what precedes the chunk
+	int					pBases[3] = { m_Positions.GetCount() / 3, m_UVs.GetCount() / 2, m_Normals.GetCount() / 3 };
+	ParseArray<int>*	ppCorners[3] = { &C.CornerVertices, &C.CornerUVs, &C.CornerNormals };
+	for ( int RelativeIndex=0; C.pError[0] == '\0' && RelativeIndex < C.RelativeCorners.GetCount(); RelativeIndex++ )
+	{
+		int		Array = C.RelativeCorners[RelativeIndex] % 3;
+		int&	Index = (*ppCorners[Array])[C.RelativeCorners[RelativeIndex] / 3];
+		Index += pBases[Array];
+		if ( Index < 0 )
+		{	// Counts back past the first element of the file
+			static const char*	ppArrayNames[3] = { "vertex", "UV", "normal" };
+			sprintf( C.pError, "Relative %s index out of range in chunk starting at byte %lld", ppArrayNames[Array], C.Start );
+		}
+	}
+
+	if ( C.pError[0] != '\0' )
+	{
+		SetError( "Failed to parse \"%s\": ", m_pFileName );
+		size_t	Length = strlen( m_pError );
+		memcpy( m_pError + Length, C.pError, ERROR_LENGTH - Length - 1 );
+		m_pError[ERROR_LENGTH-1] = '\0';
+		C.Release();
+		return	false;
+	}
+
+	int	PolygonsBase = m_PolygonSizes.GetCount();
+	int	CornersBase = m_CornerVertices.GetCount();
+	int	ChunkVerticesCount = C.Positions.GetCount() / 3;
+	int	ChunkCornersCount = C.CornerVertices.GetCount();
+
+	if ( _ChunkIndex == 0 && m_Format == FORMAT_OBJ && m_ChunksCount > 1 )
+	{	// Chunks of OBJ files are similar: reserve for the whole file (with a margin) rather than growing the arrays all along
+		int	Scale = m_ChunksCount + m_ChunksCount / 8;
+		m_Positions.Reserve( Scale * C.Positions.GetCount() );
+		m_UVs.Reserve( Scale * C.UVs.GetCount() );
+		m_Normals.Reserve( Scale * C.Normals.GetCount() );
+		m_Colors.Reserve( Scale * C.Colors.GetCount() );
+		m_PolygonSizes.Reserve( Scale * C.PolygonSizes.GetCount() );
+		m_PolygonMaterials.Reserve( Scale * C.PolygonSizes.GetCount() );
+		m_CornerVertices.Reserve( Scale * ChunkCornersCount );
+		m_CornerUVs.Reserve( Scale * C.CornerUVs.GetCount() );
+		m_CornerNormals.Reserve( Scale * C.CornerNormals.GetCount() );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Append the vertices
+	m_Positions.Append( C.Positions.GetValues(), C.Positions.GetCount(), 0.0f );
+	m_UVs.Append( C.UVs.GetValues(), C.UVs.GetCount(), 0.0f );
+	m_Normals.Append( C.Normals.GetValues(), C.Normals.GetCount(), 0.0f );
+	if ( C.Colors.GetCount() > 0 || m_Colors.GetCount() > 0 )
+	{
+		PadArray( m_Colors, 4 * pBases[0], 1.0f );
+		m_Colors.Append( C.Colors.GetCount() > 0 ? C.Colors.GetValues() : NULL, 4 * ChunkVerticesCount, 1.0f );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Append the corners
+	m_CornerVertices.Append( C.CornerVertices.GetValues(), ChunkCornersCount, 0 );
+
+	ParseArray<int>*	ppGlobalCorners[2] = { &m_CornerUVs, &m_CornerNormals };
+	for ( int Array=0; Array < 2; Array++ )
+	{
+		ParseArray<int>&	Corners = *ppCorners[1+Array];
+		ParseArray<int>&	GlobalCorners = *ppGlobalCorners[Array];
+		if ( Corners.GetCount() == 0 && GlobalCorners.GetCount() == 0 )
+			continue;	// Still unused
+
+		PadArray( GlobalCorners, CornersBase, MISSING_INDEX );
+		for ( int CornerIndex=0; CornerIndex < ChunkCornersCount; CornerIndex++ )
+			GlobalCorners.Add( Corners.GetCount() > 0 && Corners[CornerIndex] != NO_INDEX ? Corners[CornerIndex] : MISSING_INDEX );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Append the polygons & apply the object & material changes
+	int	EventIndex = 0;
+	int	CornerIndex = CornersBase;
+	for ( int PolygonIndex=0; PolygonIndex <= C.PolygonSizes.GetCount(); PolygonIndex++ )
+	{
+		for ( ; EventIndex < C.Events.GetCount() && C.Events[EventIndex].PolygonIndex == PolygonIndex; EventIndex++ )
+		{
+			const ChunkEvent&	Event = C.Events[EventIndex];
+			const char*			pName = C.Names.GetValues() + Event.NameOffset;
+			switch ( Event.Type )
+			{
+			case ChunkEvent::TYPE_OBJECT:
+				{
+					MeshObject	Object;
+					memset( &Object, 0, sizeof(MeshObject) );
+					Object.NameOffset = AddName( pName, (int) strlen( pName ) );
+					Object.FirstPolygon = PolygonsBase + PolygonIndex;
+					Object.FirstCorner = CornerIndex;
+					m_Objects.Add( Object );
+				}
+				break;
+
+			case ChunkEvent::TYPE_MATERIAL:
+				m_CurrentMaterial = FindMaterial( pName );
+				break;
+
+			case ChunkEvent::TYPE_LIBRARY:
+				m_Libraries.Add( AddName( pName, (int) strlen( pName ) ) );
+				break;
+			}
+		}
+		if ( PolygonIndex == C.PolygonSizes.GetCount() )
+			break;
+
+		if ( m_Objects.GetCount() == 0 )
+		{	// Polygons before any object go to an object named after the file
+			MeshObject	Object;
+			memset( &Object, 0, sizeof(MeshObject) );
+			Object.NameOffset = m_RootNameOffset;
+			Object.FirstPolygon = PolygonsBase + PolygonIndex;
+			Object.FirstCorner = CornerIndex;
+			m_Objects.Add( Object );
+		}
+
+		m_PolygonMaterials.Add( m_CurrentMaterial );
+		CornerIndex += C.PolygonSizes[PolygonIndex];
+	}
+	m_PolygonSizes.Append( C.PolygonSizes.GetValues(), C.PolygonSizes.GetCount(), 0 );
+
+	C.Release();
+	m_CommittedChunksCount++;
+
+	return	true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Finalizing
+bool	MeshFileSource::Finalize()
+{
+	if ( m_CommittedChunksCount != m_ChunksCount )
+		return	SetError( "Not all the chunks of \"%s\" were committed", m_pFileName );
+
+	delete[] m_pChunks;
+	m_pChunks = NULL;
+
+	int	VerticesCount = m_Positions.GetCount() / 3;
+	int	PolygonsCount = m_PolygonSizes.GetCount();
+	int	CornersCount = m_CornerVertices.GetCount();
+	m_bNormalsPerVertex = m_Format != FORMAT_OBJ;
+	if ( m_CornerUVs.GetCount() > 0 )
+		PadArray( m_CornerUVs, CornersCount, MISSING_INDEX );
+	if ( m_CornerNormals.GetCount() > 0 )
+		PadArray( m_CornerNormals, CornersCount, MISSING_INDEX );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Compute the ranges of the objects & drop the empty ones (point clouds make a single mesh without polygons)
+	if ( PolygonsCount == 0 && VerticesCount > 0 )
+	{
+		m_Objects.Clear();
+
+		MeshObject	Object;
+		memset( &Object, 0, sizeof(MeshObject) );
+		Object.NameOffset = m_RootNameOffset;
+		m_Objects.Add( Object );
+	}
+
+	int	KeptObjectsCount = 0;
+	for ( int ObjectIndex=0; ObjectIndex < m_Objects.GetCount(); ObjectIndex++ )
+	{
+		MeshObject&	Object = m_Objects[ObjectIndex];
+		bool		bLast = ObjectIndex == m_Objects.GetCount()-1;
+		Object.PolygonsCount = (bLast ? PolygonsCount : m_Objects[ObjectIndex+1].FirstPolygon) - Object.FirstPolygon;
+		Object.CornersCount = (bLast ? CornersCount : m_Objects[ObjectIndex+1].FirstCorner) - Object.FirstCorner;
+		if ( Object.PolygonsCount > 0 || PolygonsCount == 0 )
+			m_Objects[KeptObjectsCount++] = Object;
+	}
+	m_Objects.Truncate( KeptObjectsCount );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Polygons without material get a default one if other polygons have materials
+	bool	bWithMaterial = false;
+	bool	bWithoutMaterial = false;
+	for ( int PolygonIndex=0; PolygonIndex < PolygonsCount; PolygonIndex++ )
+		if ( m_PolygonMaterials[PolygonIndex] >= 0 )
+			bWithMaterial = true;
+		else
+			bWithoutMaterial = true;
+
+	if ( bWithMaterial && bWithoutMaterial )
+	{
+		int	DefaultMaterial = FindMaterial( "Default" );
+		for ( int PolygonIndex=0; PolygonIndex < PolygonsCount; PolygonIndex++ )
+			if ( m_PolygonMaterials[PolygonIndex] < 0 )
+				m_PolygonMaterials[PolygonIndex] = DefaultMaterial;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Build the objects
+	// The stamps map global indices to the local indices of the current object, they're checked against the object's
+	//	arrays (a sparse set) so they never need to be cleared between objects.
+	int*	pVertexStamps = new int[VerticesCount > 0 ? VerticesCount : 1];
+	int*	pUVStamps = new int[m_UVs.GetCount() > 0 ? m_UVs.GetCount() / 2 : 1];
+	int*	pNormalStamps = new int[m_Normals.GetCount() > 0 ? m_Normals.GetCount() / 3 : 1];
+	int*	pMaterialStamps = new int[m_Materials.GetCount() > 0 ? m_Materials.GetCount() : 1];
+
+	bool	bResult = true;
+	for ( int ObjectIndex=0; bResult && ObjectIndex < m_Objects.GetCount(); ObjectIndex++ )
+		bResult = BuildObject( m_Objects[ObjectIndex], pVertexStamps, pUVStamps, pNormalStamps, pMaterialStamps );
+
+	delete[] pMaterialStamps;
+	delete[] pNormalStamps;
+	delete[] pUVStamps;
+	delete[] pVertexStamps;
+
+	if ( !bResult )
+		return	false;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 4] Read the materials
+	for ( int LibraryIndex=0; LibraryIndex < m_Libraries.GetCount(); LibraryIndex++ )
+		ReadMaterialLibrary( m_Names.GetValues() + m_Libraries[LibraryIndex] );
+
+	m_File.Close();
+
+	return	true;
+}
+
+// Maps the global indices used by a range of corners to local indices (in place)
+// Returns the amount of local indices (or -1 if an index is out of range), _ppLocalToGlobal receiving the global index of
+//	each local index (or NULL if they're the same). Only UV & normal corners may be MISSING_INDEX.
+static int	CompactIndices( int* _pCorners, int _CornersCount, int _GlobalCount, bool _bMissingAllowed, int* _pStamps, int*& _ppLocalToGlobal )
+{
+	int	LocalCount = 0;
+	int	MaxLocalCount = _CornersCount < _GlobalCount ? _CornersCount : _GlobalCount;
+	_ppLocalToGlobal = new int[MaxLocalCount > 0 ? MaxLocalCount : 1];
+	for ( int CornerIndex=0; CornerIndex < _CornersCount; CornerIndex++ )
+	{
+		int	GlobalIndex = _pCorners[CornerIndex];
+		if ( GlobalIndex == MISSING_INDEX && _bMissingAllowed )
+			continue;
+		if ( GlobalIndex < 0 || GlobalIndex >= _GlobalCount )
+		{
+			delete[] _ppLocalToGlobal;
+			_ppLocalToGlobal = NULL;
+			return	-1;
+		}
+
+		int	LocalIndex = _pStamps[GlobalIndex];
+		if ( LocalIndex < 0 || LocalIndex >= LocalCount || _ppLocalToGlobal[LocalIndex] != GlobalIndex )
+		{
+			LocalIndex = LocalCount++;
+			_ppLocalToGlobal[LocalIndex] = GlobalIndex;
+			_pStamps[GlobalIndex] = LocalIndex;
+		}
+		_pCorners[CornerIndex] = LocalIndex;
+	}
+
+	// Objects using every index in order don't need a map
+	bool	bIdentity = LocalCount == _GlobalCount;
+	for ( int LocalIndex=0; bIdentity && LocalIndex < LocalCount; LocalIndex++ )
+		bIdentity = _ppLocalToGlobal[LocalIndex] == LocalIndex;
+	if ( bIdentity )
+	{
+		delete[] _ppLocalToGlobal;
+		_ppLocalToGlobal = NULL;
+	}
+
+	return	LocalCount;
+}
+
+bool	MeshFileSource::BuildObject( MeshObject& _Object, int* _pVertexStamps, int* _pUVStamps, int* _pNormalStamps, int* _pMaterialStamps )
+{
+	const char*	pObjectName = m_Names.GetValues() + _Object.NameOffset;
+	int			VerticesCount = m_Positions.GetCount() / 3;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Compact the vertices, UVs & normals used by the object
+	if ( _Object.PolygonsCount == 0 )
+	{	// Point cloud
+		_Object.pVertices = NULL;
+		_Object.VerticesCount = VerticesCount;
+	}
+	else
+	{
+		_Object.VerticesCount = CompactIndices( m_CornerVertices.GetValues() + _Object.FirstCorner, _Object.CornersCount, VerticesCount, false, _pVertexStamps, _Object.pVertices );
+		if ( _Object.VerticesCount < 0 )
+			return	SetError( "Vertex index out of range in object \"%s\"", pObjectName );
+	}
+
+	if ( m_CornerUVs.GetCount() > 0 )
+	{
+		_Object.UVsCount = CompactIndices( m_CornerUVs.GetValues() + _Object.FirstCorner, _Object.CornersCount, m_UVs.GetCount() / 2, true, _pUVStamps, _Object.pUVs );
+		if ( _Object.UVsCount < 0 )
+			return	SetError( "UV index out of range in object \"%s\"", pObjectName );
+	}
+
+	if ( m_CornerNormals.GetCount() > 0 )
+	{
+		_Object.NormalsCount = CompactIndices( m_CornerNormals.GetValues() + _Object.FirstCorner, _Object.CornersCount, m_Normals.GetCount() / 3, true, _pNormalStamps, _Object.pNormals );
+		if ( _Object.NormalsCount < 0 )
+			return	SetError( "Normal index out of range in object \"%s\"", pObjectName );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Gather the materials into slots
+	int*	pPolygonMaterials = m_PolygonMaterials.GetValues() + _Object.FirstPolygon;
+	if ( _Object.PolygonsCount > 0 && pPolygonMaterials[0] >= 0 )
+	{
+		_Object.MaterialsCount = CompactIndices( pPolygonMaterials, _Object.PolygonsCount, m_Materials.GetCount(), false, _pMaterialStamps, _Object.pMaterials );
+		if ( _Object.pMaterials == NULL )
+		{	// Identity maps are still needed for materials
+			_Object.pMaterials = new int[_Object.MaterialsCount];
+			for ( int SlotIndex=0; SlotIndex < _Object.MaterialsCount; SlotIndex++ )
+				_Object.pMaterials[SlotIndex] = SlotIndex;
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Describe the layer elements
+	_Object.LayerElementsCount = 0;
+	int	pCounts[2] = { m_bNormalsPerVertex ? (m_Normals.GetCount() > 0 ? _Object.VerticesCount : 0) : _Object.NormalsCount,
+					   m_bNormalsPerVertex ? (m_UVs.GetCount() > 0 ? _Object.VerticesCount : 0) : _Object.UVsCount };
+	for ( int TypeIndex=0; TypeIndex < 2; TypeIndex++ )
+	{
+		if ( pCounts[TypeIndex] == 0 )
+			continue;
+
+		SourceLayerElement&	Element = _Object.pLayerElements[_Object.LayerElementsCount++];
+		Element.Type = TypeIndex == 0 ? SourceLayerElement::TYPE_NORMAL : SourceLayerElement::TYPE_UV;
+		Element.Channel = 0;
+		Element.ComponentsCount = TypeIndex == 0 ? 3 : 2;
+		Element.ValuesCount = pCounts[TypeIndex];
+		Element.Mapping = m_bNormalsPerVertex ? SourceLayerElement::MAPPING_BY_CONTROL_POINT : SourceLayerElement::MAPPING_BY_POLYGON_VERTEX;
+		Element.Reference = m_bNormalsPerVertex ? SourceLayerElement::REFERENCE_DIRECT : SourceLayerElement::REFERENCE_INDEX_TO_DIRECT;
+		Element.IndicesCount = m_bNormalsPerVertex ? 0 : _Object.CornersCount;
+	}
+
+	if ( m_Colors.GetCount() > 0 )
+	{
+		SourceLayerElement&	Element = _Object.pLayerElements[_Object.LayerElementsCount++];
+		Element.Type = SourceLayerElement::TYPE_VERTEX_COLOR;
+		Element.Channel = 0;
+		Element.ComponentsCount = 4;
+		Element.ValuesCount = _Object.VerticesCount;
+		Element.Mapping = SourceLayerElement::MAPPING_BY_CONTROL_POINT;
+		Element.Reference = SourceLayerElement::REFERENCE_DIRECT;
+		Element.IndicesCount = 0;
+	}
+
+	if ( _Object.MaterialsCount > 0 )
+	{
+		SourceLayerElement&	Element = _Object.pLayerElements[_Object.LayerElementsCount++];
+		Element.Type = SourceLayerElement::TYPE_MATERIAL;
+		Element.Channel = 0;
+		Element.ComponentsCount = 0;
+		Element.ValuesCount = 0;
+		Element.Mapping = _Object.MaterialsCount > 1 ? SourceLayerElement::MAPPING_BY_POLYGON : SourceLayerElement::MAPPING_ALL_SAME;
+		Element.Reference = SourceLayerElement::REFERENCE_INDEX_TO_DIRECT;
+		Element.IndicesCount = _Object.MaterialsCount > 1 ? _Object.PolygonsCount : 1;
+	}
+
+	return	true;
+}
+
+void	MeshFileSource::ReadMaterialLibrary( const char* _pLibraryName )
+{
+	// Libraries are relative to the OBJ file
+	const char*	pDirectoryEnd = m_pFileName + strlen( m_pFileName );
+	while ( pDirectoryEnd > m_pFileName && pDirectoryEnd[-1] != '/' && pDirectoryEnd[-1] != '\\' )
+		pDirectoryEnd--;
+
+	int		DirectoryLength = int(pDirectoryEnd - m_pFileName);
+	char*	pPath = new char[DirectoryLength + strlen( _pLibraryName ) + 1];
+	memcpy( pPath, m_pFileName, DirectoryLength );
+	strcpy( pPath + DirectoryLength, _pLibraryName );
+
+	// Libraries are small & read at once (a missing library leaves the default values)
+	MappedFile	File;
+	MappedView	View;
+	bool		bMapped = File.Open( pPath ) && View.Map( File, 0, File.GetSize() );
+	delete[] pPath;
+	if ( !bMapped )
+		return;
+
+	const char*	pEnd = View.GetData() + View.GetSize();
+	const char*	pLineEnd = NULL;
+	MeshMaterial*	pMaterial = NULL;
+	for ( const char* p=View.GetData(); p < pEnd; p=pLineEnd+1 )
+	{
+		pLineEnd = (const char*) memchr( p, '\n', pEnd - p );
+		if ( pLineEnd == NULL )
+			pLineEnd = pEnd;
+
+		const char*	pKeyword = SkipSpaces( p, pLineEnd );
+		p = SkipToken( pKeyword, pLineEnd );
+
+		if ( IsToken( pKeyword, p, "newmtl" ) )
+		{	// Only the materials used by the faces are read
+			p = SkipSpaces( p, pLineEnd );
+			const char*	pNameEnd = TrimEnd( p, pLineEnd );
+
+			pMaterial = NULL;
+			for ( int MaterialIndex=0; MaterialIndex < m_Materials.GetCount(); MaterialIndex++ )
+			{
+				const char*	pName = m_Names.GetValues() + m_Materials[MaterialIndex].NameOffset;
+				if ( IsToken( p, pNameEnd, pName ) )
+					pMaterial = &m_Materials[MaterialIndex];
+			}
+		}
+		else if ( pMaterial == NULL )
+			continue;
+		else if ( IsToken( pKeyword, p, "Kd" ) || IsToken( pKeyword, p, "Ks" ) || IsToken( pKeyword, p, "Ke" ) )
+		{
+			float*	pColor = pKeyword[1] == 'd' ? pMaterial->Diffuse : (pKeyword[1] == 's' ? pMaterial->Specular : pMaterial->Emissive);
+			for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+				ParseFloat( p, pLineEnd, pColor[ComponentIndex] );
+		}
+		else if ( IsToken( pKeyword, p, "Ns" ) )
+			ParseFloat( p, pLineEnd, pMaterial->Shininess );
+		else if ( IsToken( pKeyword, p, "d" ) )
+			ParseFloat( p, pLineEnd, pMaterial->Opacity );
+		else if ( IsToken( pKeyword, p, "Tr" ) && ParseFloat( p, pLineEnd, pMaterial->Opacity ) )
+			pMaterial->Opacity = 1.0f - pMaterial->Opacity;
+	}
+}
+
+bool	MeshFileSource::Load( const char* _pFileName )
+{
+	if ( !Open( _pFileName, DEFAULT_CHUNK_SIZE ) )
+		return	false;
+
+	for ( int ChunkIndex=0; ChunkIndex < m_ChunksCount; ChunkIndex++ )
+	{
+		ParseChunk( ChunkIndex );
+		if ( !CommitChunk( ChunkIndex ) )
+			return	false;
+	}
+
+	return	Finalize();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SceneSource implementation
+int		MeshFileSource::GetNodesCount() const
+{
+	return	1 + m_Objects.GetCount();
+}
+
+void	MeshFileSource::GetNode( int _NodeIndex, SourceNode& _Node ) const
+{
+	memset( &_Node, 0, sizeof(SourceNode) );
+	_Node.Scaling[0] = _Node.Scaling[1] = _Node.Scaling[2] = 1.0f;
+	_Node.pName = m_Names.GetValues() + m_RootNameOffset;
+	if ( _NodeIndex == 0 )
+	{
+		_Node.ParentIndex = -1;
+		_Node.Type = SourceNode::TYPE_GENERIC;
+		return;
+	}
+
+	const MeshObject&	Object = GetObject( _NodeIndex );
+	if ( m_Names[Object.NameOffset] != '\0' )
+		_Node.pName = m_Names.GetValues() + Object.NameOffset;
+	_Node.ParentIndex = 0;
+	_Node.Type = SourceNode::TYPE_MESH;
+	_Node.MaterialsCount = Object.MaterialsCount;
+}
+
+int		MeshFileSource::GetNodeMaterial( int _NodeIndex, int _SlotIndex ) const
+{
+	if ( _NodeIndex == 0 || _SlotIndex < 0 || _SlotIndex >= GetObject( _NodeIndex ).MaterialsCount )
+		return	-1;
+
+	return	GetObject( _NodeIndex ).pMaterials[_SlotIndex];
+}
+
+int		MeshFileSource::GetMaterialsCount() const
+{
+	return	m_Materials.GetCount();
+}
+
+void	MeshFileSource::GetMaterial( int _MaterialIndex, SourceMaterial& _Material ) const
+{
+	const MeshMaterial&	Material = m_Materials[_MaterialIndex];
+	_Material.pName = m_Names.GetValues() + Material.NameOffset;
+	for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+	{
+		_Material.DiffuseColor[ComponentIndex] = Material.Diffuse[ComponentIndex];
+		_Material.EmissiveColor[ComponentIndex] = Material.Emissive[ComponentIndex];
+		_Material.SpecularColor[ComponentIndex] = Material.Specular[ComponentIndex];
+	}
+	_Material.DiffuseFactor = 1.0f;
+	_Material.EmissiveFactor = 1.0f;
+	_Material.SpecularFactor = 1.0f;
+	_Material.Shininess = Material.Shininess;
+	_Material.Opacity = Material.Opacity;
+}
+
+void	MeshFileSource::GetMesh( int _NodeIndex, SourceMesh& _Mesh ) const
+{
+	memset( &_Mesh, 0, sizeof(SourceMesh) );
+	if ( _NodeIndex == 0 )
+		return;
+
+	const MeshObject&	Object = GetObject( _NodeIndex );
+	_Mesh.ControlPointsCount = Object.VerticesCount;
+	_Mesh.PolygonsCount = Object.PolygonsCount;
+	_Mesh.PolygonVerticesCount = Object.CornersCount;
+	_Mesh.LayerElementsCount = Object.LayerElementsCount;
+}
+
+// Copies the values of the given local indices (or all of them if _pLocalToGlobal is NULL)
+static void	GatherValues( const float* _pValues, int _ComponentsCount, const int* _pLocalToGlobal, int _Count, float* _pResult )
+{
+	if ( _pLocalToGlobal == NULL )
+	{
+		memcpy( _pResult, _pValues, _Count * _ComponentsCount * sizeof(float) );
+		return;
+	}
+
+	for ( int LocalIndex=0; LocalIndex < _Count; LocalIndex++ )
+		for ( int ComponentIndex=0; ComponentIndex < _ComponentsCount; ComponentIndex++ )
+			*_pResult++ = _pValues[_ComponentsCount * _pLocalToGlobal[LocalIndex] + ComponentIndex];
+}
+
+void	MeshFileSource::GetControlPoints( int _NodeIndex, float* _pPositions ) const
+{
+	const MeshObject&	Object = GetObject( _NodeIndex );
+	GatherValues( m_Positions.GetValues(), 3, Object.pVertices, Object.VerticesCount, _pPositions );
+}
+
+void	MeshFileSource::GetPolygons( int _NodeIndex, int* _pPolygonSizes, int* _pPolygonVertices ) const
+{
+	const MeshObject&	Object = GetObject( _NodeIndex );
+	memcpy( _pPolygonSizes, m_PolygonSizes.GetValues() + Object.FirstPolygon, Object.PolygonsCount * sizeof(int) );
+	memcpy( _pPolygonVertices, m_CornerVertices.GetValues() + Object.FirstCorner, Object.CornersCount * sizeof(int) );
+}
+
+void	MeshFileSource::GetLayerElement( int _NodeIndex, int _ElementIndex, SourceLayerElement& _Element ) const
+{
+	_Element = GetObject( _NodeIndex ).pLayerElements[_ElementIndex];
+}
+
+void	MeshFileSource::GetLayerElementData( int _NodeIndex, int _ElementIndex, float* _pValues, int* _pIndices ) const
+{
+	const MeshObject&			Object = GetObject( _NodeIndex );
+	const SourceLayerElement&	Element = Object.pLayerElements[_ElementIndex];
+	switch ( Element.Type )
+	{
+	case SourceLayerElement::TYPE_NORMAL:
+	case SourceLayerElement::TYPE_UV:
+		{
+			bool					bNormals = Element.Type == SourceLayerElement::TYPE_NORMAL;
+			const ParseArray<float>&	Values = bNormals ? m_Normals : m_UVs;
+			if ( Element.Mapping == SourceLayerElement::MAPPING_BY_CONTROL_POINT )
+			{
+				GatherValues( Values.GetValues(), Element.ComponentsCount, Object.pVertices, Element.ValuesCount, _pValues );
+				break;
+			}
+
+			// Missing indices use the first value
+			const int*	pCorners = (bNormals ? m_CornerNormals : m_CornerUVs).GetValues() + Object.FirstCorner;
+			GatherValues( Values.GetValues(), Element.ComponentsCount, bNormals ? Object.pNormals : Object.pUVs, Element.ValuesCount, _pValues );
+			for ( int CornerIndex=0; CornerIndex < Object.CornersCount; CornerIndex++ )
+				_pIndices[CornerIndex] = pCorners[CornerIndex] >= 0 ? pCorners[CornerIndex] : 0;
+		}
+		break;
+
+	case SourceLayerElement::TYPE_VERTEX_COLOR:
+		GatherValues( m_Colors.GetValues(), 4, Object.pVertices, Element.ValuesCount, _pValues );
+		break;
+
+	case SourceLayerElement::TYPE_MATERIAL:
+		if ( Element.Mapping == SourceLayerElement::MAPPING_ALL_SAME )
+			_pIndices[0] = 0;
+		else
+			memcpy( _pIndices, m_PolygonMaterials.GetValues() + Object.FirstPolygon, Object.PolygonsCount * sizeof(int) );
+		break;
+
+	default:
+		break;
+	}
+}
+
+float	MeshFileSource::GetAnimationDuration() const
+{
+	return	0.0f;
+}
+
+int		MeshFileSource::GetCurvesCount( int /*_NodeIndex*/ ) const
+{
+	return	0;
+}
+
+void	MeshFileSource::GetCurve( int /*_NodeIndex*/, int /*_CurveIndex*/, SourceCurve& _Curve ) const
+{
+	_Curve.Channel = SourceCurve::CHANNEL_TRANSLATION_X;
+	_Curve.KeysCount = 0;
+}
+
+void	MeshFileSource::GetCurveKeys( int /*_NodeIndex*/, int /*_CurveIndex*/, float* /*_pTimes*/, float* /*_pValues*/ ) const
+{
+}
@@ -0,0 +1,357 @@
+// Contains the streaming OBJ & PLY readers
+//
+#pragma once
+
+#include "SceneSource.h"
+#include "MappedFile.h"
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A growable array of plain values used while parsing
+	//
+	template<typename T> class	ParseArray
+	{
+	protected:	// FIELDS
+
+		T*		m_pValues;
+		int		m_Count;
+		int		m_Capacity;
+
+	public:		// PROPERTIES
+
+		T*			GetValues()					{ return m_pValues; }
+		const T*	GetValues() const			{ return m_pValues; }
+		int			GetCount() const			{ return m_Count; }
+		T&			operator[]( int _Index )	{ return m_pValues[_Index]; }
+		const T&	operator[]( int _Index ) const	{ return m_pValues[_Index]; }
+
+	public:		// METHODS
+
+		ParseArray() : m_pValues( NULL ), m_Count( 0 ), m_Capacity( 0 )	{}
+		~ParseArray()	{ delete[] m_pValues; }
+
+		void	Add( const T& _Value )
+		{
+			if ( m_Count == m_Capacity )
+				Reserve( m_Capacity < 256 ? 256 : 2 * m_Capacity );
+			m_pValues[m_Count++] = _Value;
+		}
+
+		// Appends _Count values (or _Count copies of _Value if _pValues is NULL)
+		void	Append( const T* _pValues, int _Count, const T& _Value )
+		{
+			if ( m_Count + _Count > m_Capacity )
+				Reserve( m_Count + _Count > 2 * m_Capacity ? m_Count + _Count : 2 * m_Capacity );
+			T*	pTarget = m_pValues + m_Count;
+			if ( _pValues != NULL )
+				for ( int Index=0; Index < _Count; Index++ )
+					pTarget[Index] = _pValues[Index];
+			else
+				for ( int Index=0; Index < _Count; Index++ )
+					pTarget[Index] = _Value;
+			m_Count += _Count;
+		}
+
+		void	Reserve( int _Capacity )
+		{
+			if ( _Capacity <= m_Capacity )
+				return;
+
+			T*	pValues = new T[_Capacity];
+			for ( int Index=0; Index < m_Count; Index++ )
+				pValues[Index] = m_pValues[Index];
+			delete[] m_pValues;
+			m_pValues = pValues;
+			m_Capacity = _Capacity;
+		}
+
+		// Drops the values beyond _Count
+		void	Truncate( int _Count )	{ if ( _Count < m_Count ) m_Count = _Count; }
+
+		void	Clear()		{ delete[] m_pValues; m_pValues = NULL; m_Count = m_Capacity = 0; }
+
+	private:
+		ParseArray( const ParseArray& );
+		ParseArray&	operator=( const ParseArray& );
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Reads Wavefront OBJ files (with their MTL libraries) and ASCII or binary PLY files as a scene source
+	//
+	// The file is memory-mapped & split into chunks of lines (or records) that are parsed independently, so chunks can be
+	//	parsed concurrently by as many threads as wanted, then committed in order:
+	//		Open()
+	//		for each batch of chunks:
+	//			ParseChunk() for every chunk of the batch, in parallel
+	//			CommitChunk() for every chunk of the batch, in order (this releases the chunk's data)
+	//		Finalize()
+	// Only the chunks being parsed are mapped & hold temporary data, the working memory is thus bounded by the size of a batch.
+	//
+	// Every OBJ object or group with faces becomes a mesh node under the root, PLY files give a single mesh.
+	// Points & lines are ignored, files without any polygon give a single mesh holding the vertices as a point cloud.
+	// Indices out of range (including relative OBJ indices counting back past the first element) are reported as errors.
+	//
+	class	MeshFileSource : public SceneSource
+	{
+	public:		// NESTED TYPES
+
+		enum	FORMAT
+		{
+			FORMAT_OBJ,
+			FORMAT_PLY_ASCII,
+			FORMAT_PLY_BINARY_LITTLE_ENDIAN,
+			FORMAT_PLY_BINARY_BIG_ENDIAN,
+		};
+
+		static const int	DEFAULT_CHUNK_SIZE = 8 << 20;
+		static const int	MAX_LINE_LENGTH = 64 << 10;	// Longest line (or binary record) supported
+		static const int	ERROR_LENGTH = 256;
+
+	protected:
+
+		// The types of PLY properties
+		enum	PLY_TYPE
+		{
+			PLY_INVALID,
+			PLY_CHAR,
+			PLY_UCHAR,
+			PLY_SHORT,
+			PLY_USHORT,
+			PLY_INT,
+			PLY_UINT,
+			PLY_FLOAT,
+			PLY_DOUBLE,
+		};
+
+		// The vertex properties we read from PLY files
+		enum	PLY_SEMANTIC
+		{
+			SEMANTIC_NONE = -1,
+			SEMANTIC_X,
+			SEMANTIC_Y,
+			SEMANTIC_Z,
+			SEMANTIC_NX,
+			SEMANTIC_NY,
+			SEMANTIC_NZ,
+			SEMANTIC_U,
+			SEMANTIC_V,
+			SEMANTIC_RED,
+			SEMANTIC_GREEN,
+			SEMANTIC_BLUE,
+			SEMANTIC_ALPHA,
+			SEMANTIC_INDICES,		// The list of the vertex indices of a face
+			SEMANTICS_COUNT,
+		};
+
+		static const int	MAX_PLY_ELEMENTS = 16;
+		static const int	MAX_PLY_PROPERTIES = 32;
+
+		struct	PLYProperty
+		{
+			PLY_TYPE		Type;
+			PLY_TYPE		CountType;			// PLY_INVALID if not a list
+			PLY_SEMANTIC	Semantic;
+		};
+
+		struct	PLYElement
+		{
+			enum	KIND { KIND_OTHER, KIND_VERTEX, KIND_FACE };
+
+			KIND		Kind;
+			int			Count;
+			int			PropertiesCount;
+			PLYProperty	pProperties[MAX_PLY_PROPERTIES];
+			int			RecordSize;			// In bytes for binary elements without lists (0 otherwise)
+			long long	Start;				// Offset of the first record in the file
+			long long	End;
+		};
+
+		// The events changing the current object or material within a chunk
+		struct	ChunkEvent
+		{
+			enum	TYPE { TYPE_OBJECT, TYPE_MATERIAL, TYPE_LIBRARY };
+
+			TYPE	Type;
+			int		PolygonIndex;		// The first polygon of the chunk affected by the event
+			int		NameOffset;			// Offset of the name in the chunk's names
+		};
+
+		// A part of the file parsed independently & its results
+		struct	Chunk
+		{
+			long long	Start;				// For OBJ files, lines starting in [Start,End[ belong to the chunk
+			long long	End;
+			int			ElementIndex;		// PLY element of the records
+			int			FirstRecord;		// PLY records of the chunk
+			int			RecordsCount;
+
+			bool		bParsed;
+			char		pError[ERROR_LENGTH];
+
+			ParseArray<float>		Positions;
+			ParseArray<float>		Colors;			// 4 per position (lazily allocated & filled with white)
+			ParseArray<float>		Normals;
+			ParseArray<float>		UVs;
+			ParseArray<int>			PolygonSizes;
+			ParseArray<int>			CornerVertices;
+			ParseArray<int>			CornerUVs;		// Lazily allocated & filled with -1
+			ParseArray<int>			CornerNormals;
+			ParseArray<int>			RelativeCorners;	// Corners using negative OBJ indices: 3 * corner + array (0=vertices, 1=UVs, 2=normals)
+			ParseArray<ChunkEvent>	Events;
+			ParseArray<char>		Names;
+
+			void	Release();
+		};
+
+		// A mesh node, made of a range of polygons
+		struct	MeshObject
+		{
+			int		NameOffset;
+			int		FirstPolygon;
+			int		PolygonsCount;
+			int		FirstCorner;
+			int		CornersCount;
+
+			// Global vertices, UVs & normals used by the object (local corners index these)
+			int*	pVertices;
+			int		VerticesCount;
+			int*	pUVs;
+			int		UVsCount;
+			int*	pNormals;
+			int		NormalsCount;
+
+			int*	pMaterials;				// Global materials of the slots of the object
+			int		MaterialsCount;
+
+			int					LayerElementsCount;
+			SourceLayerElement	pLayerElements[4];
+		};
+
+		struct	MeshMaterial
+		{
+			int		NameOffset;
+			float	Diffuse[3];
+			float	Specular[3];
+			float	Emissive[3];
+			float	Shininess;
+			float	Opacity;
+		};
+
+	protected:	// FIELDS
+
+		MappedFile				m_File;				// Closed once finalized
+		long long				m_FileSize;
+		char*					m_pFileName;
+		FORMAT					m_Format;
+		int						m_ChunkSize;
+
+		int						m_PLYElementsCount;
+		PLYElement				m_pPLYElements[MAX_PLY_ELEMENTS];
+
+		Chunk*					m_pChunks;
+		int						m_ChunksCount;
+		int						m_CommittedChunksCount;
+
+		char					m_pError[ERROR_LENGTH];
+
+		// Committed data
+		ParseArray<float>		m_Positions;
+		ParseArray<float>		m_Colors;
+		ParseArray<float>		m_Normals;
+		ParseArray<float>		m_UVs;
+		ParseArray<int>			m_PolygonSizes;
+		ParseArray<int>			m_PolygonMaterials;	// Global material, then slot of the object once finalized
+		ParseArray<int>			m_CornerVertices;
+		ParseArray<int>			m_CornerUVs;
+		ParseArray<int>			m_CornerNormals;
+		ParseArray<char>		m_Names;
+		ParseArray<MeshObject>	m_Objects;
+		ParseArray<MeshMaterial>	m_Materials;
+		ParseArray<int>			m_Libraries;		// Name offsets of the MTL files
+		int						m_CurrentMaterial;
+		bool					m_bNormalsPerVertex;	// PLY normals & UVs are stored per vertex
+		int						m_RootNameOffset;
+
+	public:		// PROPERTIES
+
+		FORMAT		GetFormat() const			{ return m_Format; }
+		long long	GetFileSize() const			{ return m_FileSize; }
+		int			GetChunksCount() const		{ return m_ChunksCount; }
+		const char*	GetError() const			{ return m_pError; }
+
+		int			GetVerticesCount() const	{ return m_Positions.GetCount() / 3; }
+		int			GetPolygonsCount() const	{ return m_PolygonSizes.GetCount(); }
+
+	public:		// METHODS
+
+		MeshFileSource();
+		virtual ~MeshFileSource();
+
+		// Tells if the file has an extension we can read
+		static bool		IsSupported( const char* _pFileName );
+
+		// Maps the file, reads its header & splits it in chunks of roughly _ChunkSize bytes
+		// Returns false on error (cf. GetError())
+		bool	Open( const char* _pFileName, int _ChunkSize );
+
+		// Parses a chunk, can be called concurrently for different chunks
+		// Returns false on error (cf. GetError() once committed)
+		bool	ParseChunk( int _ChunkIndex );
+
+		// Appends the data of a parsed chunk & releases it, chunks must be committed in order
+		// Returns false on error (cf. GetError())
+		bool	CommitChunk( int _ChunkIndex );
+
+		// Splits the committed data into meshes & reads the material libraries once every chunk was committed
+		// Returns false on error (cf. GetError())
+		bool	Finalize();
+
+		// Parses the whole file on the calling thread
+		bool	Load( const char* _pFileName );
+
+		// SceneSource implementation
+		virtual int		GetNodesCount() const;
+		virtual void	GetNode( int _NodeIndex, SourceNode& _Node ) const;
+		virtual int		GetNodeMaterial( int _NodeIndex, int _SlotIndex ) const;
+
+		virtual int		GetMaterialsCount() const;
+		virtual void	GetMaterial( int _MaterialIndex, SourceMaterial& _Material ) const;
+
+		virtual void	GetMesh( int _NodeIndex, SourceMesh& _Mesh ) const;
+		virtual void	GetControlPoints( int _NodeIndex, float* _pPositions ) const;
+		virtual void	GetPolygons( int _NodeIndex, int* _pPolygonSizes, int* _pPolygonVertices ) const;
+		virtual void	GetLayerElement( int _NodeIndex, int _ElementIndex, SourceLayerElement& _Element ) const;
+		virtual void	GetLayerElementData( int _NodeIndex, int _ElementIndex, float* _pValues, int* _pIndices ) const;
+
+		virtual float	GetAnimationDuration() const;
+		virtual int		GetCurvesCount( int _NodeIndex ) const;
+		virtual void	GetCurve( int _NodeIndex, int _CurveIndex, SourceCurve& _Curve ) const;
+		virtual void	GetCurveKeys( int _NodeIndex, int _CurveIndex, float* _pTimes, float* _pValues ) const;
+
+	protected:
+
+		void	Clear();
+		bool	SetError( const char* _pFormat, const char* _pArgument );
+
+		bool	ReadPLYHeader( const char* _pHeader, int _Size, int& _HeaderSize );
+		bool	SplitOBJ();
+		bool	SplitPLY( long long _DataStart );
+
+		// Parses the lines starting in [_pStart,_pLimit[, the last line must end before _pEnd (unless it ends the file)
+		bool	ParseOBJChunk( Chunk& _Chunk, const char* _pStart, const char* _pLimit, const char* _pEnd, bool _bEndOfFile );
+		static bool	ParseOBJLine( Chunk& _Chunk, const char* p, const char* pLineEnd );
+		bool	ParsePLYChunk( Chunk& _Chunk, const char* _pStart, const char* _pEnd );
+
+		int		AddName( const char* _pName, int _Length );
+		int		FindMaterial( const char* _pName );
+		void	ReadMaterialLibrary( const char* _pLibraryName );
+		bool	BuildObject( MeshObject& _Object, int* _pVertexStamps, int* _pUVStamps, int* _pNormalStamps, int* _pMaterialStamps );
+
+		const MeshObject&	GetObject( int _NodeIndex ) const	{ return m_Objects[_NodeIndex-1]; }
+
+	private:
+		MeshFileSource( const MeshFileSource& );
+		MeshFileSource&	operator=( const MeshFileSource& );
+	};
+}
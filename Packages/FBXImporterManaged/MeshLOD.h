@@ -0,0 +1,102 @@
+// Contains the simplified levels of detail of a mesh
+//
+#pragma managed
+#pragma once
+
+#include "LayerElements.h"
+
+using namespace System;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	ref class	NodeMesh;
+
+	//////////////////////////////////////////////////////////////////////////
+	// A simplified version of a mesh
+	// A LOD doesn't create any vertex, its triangles reference the control points of the owner mesh.
+	// Each LOD triangle corner also references the original triangle corner it takes its attributes from so
+	//	the owner's layer elements can be read for LOD triangles as well (cf. GetElementByTriangleVertex()).
+	//
+	public ref class		MeshLOD
+	{
+	protected:	// FIELDS
+
+		NodeMesh^			m_Owner;
+		int					m_Level;
+		float				m_Error;
+		float				m_AbsoluteError;
+
+		cli::array<int>^	m_Indices;			// 3 control point indices per triangle
+		cli::array<int>^	m_SourceCorners;	// 3 * OriginalTriangleIndex + OriginalCornerIndex for each corner
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the mesh the LOD simplifies" )]
+		//
+		property NodeMesh^			Owner
+		{
+			NodeMesh^			get()	{ return m_Owner; }
+		}
+
+		[DescriptionAttribute( "Gets the level of detail (1 is the first simplified level, the owner mesh being level 0)" )]
+		//
+		property int				Level
+		{
+			int					get()	{ return m_Level; }
+		}
+
+		[DescriptionAttribute( "Gets the maximum geometric error of the LOD, relative to the size of the mesh (i.e. its largest extent)" )]
+		//
+		property float				Error
+		{
+			float				get()	{ return m_Error; }
+		}
+
+		[DescriptionAttribute( "Gets the maximum geometric error of the LOD, in scene units" )]
+		//
+		property float				AbsoluteError
+		{
+			float				get()	{ return m_AbsoluteError; }
+		}
+
+		property int				TrianglesCount
+		{
+			int					get()	{ return m_Indices->Length / 3; }
+		}
+
+		[DescriptionAttribute( "Gets the control point indices of the LOD triangles (3 per triangle)" )]
+		//
+		property cli::array<int>^	Indices
+		{
+			cli::array<int>^	get()	{ return m_Indices; }
+		}
+
+		[DescriptionAttribute( "Gets the original triangle corner each LOD corner takes its attributes from (3 * TriangleIndex + TriangleVertexIndex)" )]
+		//
+		property cli::array<int>^	SourceCorners
+		{
+			cli::array<int>^	get()	{ return m_SourceCorners; }
+		}
+
+	public:		// METHODS
+
+		MeshLOD( NodeMesh^ _Owner, int _Level, float _Error, float _AbsoluteError, cli::array<int>^ _Indices, cli::array<int>^ _SourceCorners )
+			: m_Owner( _Owner ), m_Level( _Level ), m_Error( _Error ), m_AbsoluteError( _AbsoluteError ), m_Indices( _Indices ), m_SourceCorners( _SourceCorners )
+		{
+		}
+
+		// Gets the index to a control point given the LOD triangle and its internal index
+		int		GetControlPointIndex( int _TriangleIndex, int _TriangleVertexIndex )
+		{
+			return	m_Indices[3 * _TriangleIndex + _TriangleVertexIndex];
+		}
+
+		// Gets the element of one of the owner's layer elements for the requested LOD triangle vertex
+		Object^	GetElementByTriangleVertex( LayerElement^ _Element, int _TriangleIndex, int _TriangleVertexIndex )
+		{
+			int	SourceCorner = m_SourceCorners[3 * _TriangleIndex + _TriangleVertexIndex];
+			return	_Element->GetElementByTriangleVertex( SourceCorner / 3, SourceCorner % 3 );
+		}
+	};
+}
@@ -0,0 +1,584 @@
+// Native quadric mesh simplifier
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include <algorithm>
+#include "MeshSimplifier.h"
+
+using namespace	FBXImporter;
+
+static const float	SEAM_ATTRIBUTE_EPSILON = 1e-3f;	// Corners whose attributes differ by more than that are considered on different sides of a seam
+static const double	BORDER_PLANE_WEIGHT = 10.0;		// Weight of the planes keeping border vertices on their border
+static const float	MIN_NORMAL_COSINE = 0.25f;		// Cosine of the maximum rotation of a triangle's normal during a collapse
+
+//////////////////////////////////////////////////////////////////////////
+// SimplifierQuadric
+//
+void	SimplifierQuadric::Clear( int _Dimension )
+{
+	memset( A, 0, sizeof(float) * _Dimension * (_Dimension+1) / 2 );
+	memset( b, 0, sizeof(float) * _Dimension );
+	c = 0.0f;
+	Weight = 0.0f;
+}
+
+void	SimplifierQuadric::Add( const SimplifierQuadric& _Other, int _Dimension )
+{
+	int	PackedSize = _Dimension * (_Dimension+1) / 2;
+	for ( int Index=0; Index < PackedSize; Index++ )
+		A[Index] += _Other.A[Index];
+	for ( int Index=0; Index < _Dimension; Index++ )
+		b[Index] += _Other.b[Index];
+	c += _Other.c;
+	Weight += _Other.Weight;
+}
+
+void	SimplifierQuadric::AddTriangle( const double* _pP0, const double* _pP1, const double* _pP2, int _Dimension, double _Weight )
+{
+	// Build an orthonormal frame (e1,e2) of the triangle's plane in the N-dimensional space
+	double	e1[MAX_DIMENSION], e2[MAX_DIMENSION];
+	double	Length1 = 0.0, Dot12 = 0.0;
+	for ( int i=0; i < _Dimension; i++ )
+	{
+		e1[i] = _pP1[i] - _pP0[i];
+		Length1 += e1[i] * e1[i];
+	}
+	if ( Length1 < 1e-24 )
+		return;
+	Length1 = 1.0 / sqrt( Length1 );
+	for ( int i=0; i < _Dimension; i++ )
+	{
+		e1[i] *= Length1;
+		e2[i] = _pP2[i] - _pP0[i];
+		Dot12 += e1[i] * e2[i];
+	}
+
+	double	Length2 = 0.0;
+	for ( int i=0; i < _Dimension; i++ )
+	{
+		e2[i] -= Dot12 * e1[i];
+		Length2 += e2[i] * e2[i];
+	}
+	if ( Length2 < 1e-24 )
+		return;
+	Length2 = 1.0 / sqrt( Length2 );
+
+	double	P0e1 = 0.0, P0e2 = 0.0, P0P0 = 0.0;
+	for ( int i=0; i < _Dimension; i++ )
+	{
+		e2[i] *= Length2;
+		P0e1 += _pP0[i] * e1[i];
+		P0e2 += _pP0[i] * e2[i];
+		P0P0 += _pP0[i] * _pP0[i];
+	}
+
+	// A = I - e1.e1T - e2.e2T
+	// b = (p0.e1) e1 + (p0.e2) e2 - p0
+	// c = p0.p0 - (p0.e1)^2 - (p0.e2)^2
+	int	PackedIndex = 0;
+	for ( int i=0; i < _Dimension; i++ )
+	{
+		for ( int j=i; j < _Dimension; j++ )
+			A[PackedIndex++] += (float) (_Weight * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]));
+		b[i] += (float) (_Weight * (P0e1 * e1[i] + P0e2 * e2[i] - _pP0[i]));
+	}
+	c += (float) (_Weight * (P0P0 - P0e1 * P0e1 - P0e2 * P0e2));
+	Weight += (float) _Weight;
+}
+
+void	SimplifierQuadric::AddPlane( const double _pNormal[3], double _Distance, int _Dimension, double _Weight )
+{
+	// (n.x + d)^2 = xT (n.nT) x + 2 d n.x + d^2
+	for ( int i=0; i < 3; i++ )
+	{
+		int	PackedIndex = i * _Dimension - i * (i-1) / 2;
+		for ( int j=i; j < 3; j++ )
+			A[PackedIndex++] += (float) (_Weight * _pNormal[i] * _pNormal[j]);
+		b[i] += (float) (_Weight * _Distance * _pNormal[i]);
+	}
+	c += (float) (_Weight * _Distance * _Distance);
+}
+
+float	SimplifierQuadric::Evaluate( const float* _pPoint, int _Dimension ) const
+{
+	float	Result = c;
+	int		PackedIndex = 0;
+	for ( int i=0; i < _Dimension; i++ )
+	{
+		float	xi = _pPoint[i];
+		Result += (2.0f * b[i] + A[PackedIndex++] * xi) * xi;
+		for ( int j=i+1; j < _Dimension; j++ )
+			Result += 2.0f * A[PackedIndex++] * xi * _pPoint[j];
+	}
+
+	return	Result > 0.0f ? Result : 0.0f;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// MeshSimplifier
+//
+namespace
+{
+	// Sorts collapse candidates by increasing cost
+	struct	CompareCosts
+	{
+		const float*	m_pCosts;
+
+		CompareCosts( const float* _pCosts ) : m_pCosts( _pCosts )	{}
+		bool	operator()( int _V0, int _V1 ) const	{ return m_pCosts[_V0] < m_pCosts[_V1]; }
+	};
+
+	void	ComputeNormal( const float* _pP0, const float* _pP1, const float* _pP2, float _pNormal[3] )
+	{
+		float	D1[3] = { _pP1[0] - _pP0[0], _pP1[1] - _pP0[1], _pP1[2] - _pP0[2] };
+		float	D2[3] = { _pP2[0] - _pP0[0], _pP2[1] - _pP0[1], _pP2[2] - _pP0[2] };
+		_pNormal[0] = D1[1] * D2[2] - D1[2] * D2[1];
+		_pNormal[1] = D1[2] * D2[0] - D1[0] * D2[2];
+		_pNormal[2] = D1[0] * D2[1] - D1[1] * D2[0];
+	}
+}
+
+MeshSimplifier::MeshSimplifier( const float* _pPositions, int _VerticesCount, const int* _pIndices, int _TrianglesCount, const float* _pCornerAttributes, int _AttributesCount, const int* _pTriangleMaterials )
+	: m_VerticesCount( _VerticesCount )
+	, m_TrianglesCount( _TrianglesCount )
+	, m_LiveTrianglesCount( 0 )
+	, m_AttributesCount( _AttributesCount < MAX_ATTRIBUTES ? _AttributesCount : MAX_ATTRIBUTES )
+	, m_Error( 0.0f )
+{
+	m_Dimension = 3 + m_AttributesCount;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Normalize positions so errors are relative to the mesh size
+	float	Min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float	Max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+		for ( int Component=0; Component < 3; Component++ )
+		{
+			float	Value = _pPositions[3*VertexIndex+Component];
+			Min[Component] = Value < Min[Component] ? Value : Min[Component];
+			Max[Component] = Value > Max[Component] ? Value : Max[Component];
+		}
+
+	m_Scale = 0.0f;
+	for ( int Component=0; Component < 3; Component++ )
+		m_Scale = Max[Component] - Min[Component] > m_Scale ? Max[Component] - Min[Component] : m_Scale;
+	if ( m_Scale <= 0.0f )
+		m_Scale = 1.0f;
+
+	float	InvScale = 1.0f / m_Scale;
+	m_pPositions = new float[3 * _VerticesCount];
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+		for ( int Component=0; Component < 3; Component++ )
+			m_pPositions[3*VertexIndex+Component] = (_pPositions[3*VertexIndex+Component] - Min[Component]) * InvScale;
+
+	m_pAttributes = NULL;
+	if ( m_AttributesCount > 0 )
+	{
+		m_pAttributes = new float[3 * _TrianglesCount * m_AttributesCount];
+		for ( int CornerIndex=0; CornerIndex < 3 * _TrianglesCount; CornerIndex++ )
+			for ( int AttributeIndex=0; AttributeIndex < m_AttributesCount; AttributeIndex++ )
+				m_pAttributes[m_AttributesCount*CornerIndex+AttributeIndex] = _pCornerAttributes[_AttributesCount*CornerIndex+AttributeIndex];
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Copy the triangles (degenerate triangles are discarded right away)
+	m_pIndices = new int[3 * _TrianglesCount];
+	m_pCornerSources = new int[3 * _TrianglesCount];
+	for ( int TriangleIndex=0; TriangleIndex < _TrianglesCount; TriangleIndex++ )
+	{
+		const int*	pTriangle = _pIndices + 3 * TriangleIndex;
+		bool		bDegenerate = pTriangle[0] == pTriangle[1] || pTriangle[1] == pTriangle[2] || pTriangle[2] == pTriangle[0];
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+		{
+			m_pIndices[3*TriangleIndex+CornerIndex] = pTriangle[CornerIndex];
+			m_pCornerSources[3*TriangleIndex+CornerIndex] = 3 * TriangleIndex + CornerIndex;
+		}
+		if ( bDegenerate )
+			m_pIndices[3*TriangleIndex] = -1;
+		else
+			m_LiveTrianglesCount++;
+	}
+
+	m_pAdjacencyOffsets = new int[_VerticesCount+1];
+	m_pAdjacency = new int[3 * _TrianglesCount];
+	BuildAdjacency();
+
+	m_pVertexKinds = new unsigned char[_VerticesCount];
+	ClassifyVertices( _pTriangleMaterials );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Accumulate the quadrics of the triangles & borders
+	m_pQuadrics = new SimplifierQuadric[_VerticesCount];
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+		m_pQuadrics[VertexIndex].Clear( m_Dimension );
+
+	for ( int TriangleIndex=0; TriangleIndex < _TrianglesCount; TriangleIndex++ )
+	{
+		const int*	pTriangle = m_pIndices + 3 * TriangleIndex;
+		if ( pTriangle[0] < 0 )
+			continue;
+
+		double	pPoints[3][SimplifierQuadric::MAX_DIMENSION];
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+		{
+			for ( int Component=0; Component < 3; Component++ )
+				pPoints[CornerIndex][Component] = m_pPositions[3*pTriangle[CornerIndex]+Component];
+			for ( int AttributeIndex=0; AttributeIndex < m_AttributesCount; AttributeIndex++ )
+				pPoints[CornerIndex][3+AttributeIndex] = m_pAttributes[m_AttributesCount*(3*TriangleIndex+CornerIndex)+AttributeIndex];
+		}
+
+		float	Normal[3];
+		ComputeNormal( m_pPositions + 3*pTriangle[0], m_pPositions + 3*pTriangle[1], m_pPositions + 3*pTriangle[2], Normal );
+		double	Area = 0.5 * sqrt( (double) Normal[0] * Normal[0] + (double) Normal[1] * Normal[1] + (double) Normal[2] * Normal[2] );
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+			m_pQuadrics[pTriangle[CornerIndex]].AddTriangle( pPoints[0], pPoints[1], pPoints[2], m_Dimension, Area );
+
+		// Add planes orthogonal to the border edges so border vertices stay on their border
+		for ( int EdgeIndex=0; EdgeIndex < 3; EdgeIndex++ )
+		{
+			int	V0 = pTriangle[EdgeIndex];
+			int	V1 = pTriangle[(EdgeIndex+1)%3];
+			if ( CountSharedTriangles( V0, V1 ) != 1 )
+				continue;
+
+			const float*	P0 = m_pPositions + 3*V0;
+			const float*	P1 = m_pPositions + 3*V1;
+			double	Edge[3] = { P1[0] - P0[0], P1[1] - P0[1], P1[2] - P0[2] };
+			double	PlaneNormal[3] = {	Edge[1] * Normal[2] - Edge[2] * Normal[1],
+										Edge[2] * Normal[0] - Edge[0] * Normal[2],
+										Edge[0] * Normal[1] - Edge[1] * Normal[0] };
+			double	Length = sqrt( PlaneNormal[0] * PlaneNormal[0] + PlaneNormal[1] * PlaneNormal[1] + PlaneNormal[2] * PlaneNormal[2] );
+			if ( Length < 1e-12 )
+				continue;
+
+			PlaneNormal[0] /= Length;
+			PlaneNormal[1] /= Length;
+			PlaneNormal[2] /= Length;
+			double	Distance = -(PlaneNormal[0] * P0[0] + PlaneNormal[1] * P0[1] + PlaneNormal[2] * P0[2]);
+			double	Weight = BORDER_PLANE_WEIGHT * (Edge[0] * Edge[0] + Edge[1] * Edge[1] + Edge[2] * Edge[2]);
+			m_pQuadrics[V0].AddPlane( PlaneNormal, Distance, m_Dimension, Weight );
+			m_pQuadrics[V1].AddPlane( PlaneNormal, Distance, m_Dimension, Weight );
+		}
+	}
+}
+
+MeshSimplifier::~MeshSimplifier()
+{
+	delete[] m_pPositions;
+	delete[] m_pAttributes;
+	delete[] m_pIndices;
+	delete[] m_pCornerSources;
+	delete[] m_pVertexKinds;
+	delete[] m_pQuadrics;
+	delete[] m_pAdjacencyOffsets;
+	delete[] m_pAdjacency;
+}
+
+void	MeshSimplifier::BuildAdjacency()
+{
+	memset( m_pAdjacencyOffsets, 0, sizeof(int) * (m_VerticesCount+1) );
+	for ( int TriangleIndex=0; TriangleIndex < m_TrianglesCount; TriangleIndex++ )
+	{
+		const int*	pTriangle = m_pIndices + 3 * TriangleIndex;
+		if ( pTriangle[0] < 0 )
+			continue;
+
+		m_pAdjacencyOffsets[pTriangle[0]+1]++;
+		m_pAdjacencyOffsets[pTriangle[1]+1]++;
+		m_pAdjacencyOffsets[pTriangle[2]+1]++;
+	}
+	for ( int VertexIndex=0; VertexIndex < m_VerticesCount; VertexIndex++ )
+		m_pAdjacencyOffsets[VertexIndex+1] += m_pAdjacencyOffsets[VertexIndex];
+
+	// Fill the lists backward using the end offsets, they end up at their start offsets
+	for ( int VertexIndex=m_VerticesCount; VertexIndex > 0; VertexIndex-- )
+		m_pAdjacencyOffsets[VertexIndex] = m_pAdjacencyOffsets[VertexIndex-1];
+	m_pAdjacencyOffsets[0] = 0;
+
+	for ( int TriangleIndex=0; TriangleIndex < m_TrianglesCount; TriangleIndex++ )
+	{
+		const int*	pTriangle = m_pIndices + 3 * TriangleIndex;
+		if ( pTriangle[0] < 0 )
+			continue;
+
+		m_pAdjacency[m_pAdjacencyOffsets[pTriangle[0]+1]++] = TriangleIndex;
+		m_pAdjacency[m_pAdjacencyOffsets[pTriangle[1]+1]++] = TriangleIndex;
+		m_pAdjacency[m_pAdjacencyOffsets[pTriangle[2]+1]++] = TriangleIndex;
+	}
+}
+
+int		MeshSimplifier::CountSharedTriangles( int _V0, int _V1 ) const
+{
+	int	Count = 0;
+	for ( int AdjacentIndex=m_pAdjacencyOffsets[_V0]; AdjacentIndex < m_pAdjacencyOffsets[_V0+1]; AdjacentIndex++ )
+	{
+		const int*	pTriangle = m_pIndices + 3 * m_pAdjacency[AdjacentIndex];
+		if ( pTriangle[0] >= 0 && (pTriangle[0] == _V1 || pTriangle[1] == _V1 || pTriangle[2] == _V1) )
+			Count++;
+	}
+
+	return	Count;
+}
+
+void	MeshSimplifier::ClassifyVertices( const int* _pTriangleMaterials )
+{
+	memset( m_pVertexKinds, VERTEX_MANIFOLD, m_VerticesCount );
+
+	// Lock seams & material boundaries
+	for ( int VertexIndex=0; VertexIndex < m_VerticesCount; VertexIndex++ )
+	{
+		int	FirstCorner = -1;
+		for ( int AdjacentIndex=m_pAdjacencyOffsets[VertexIndex]; AdjacentIndex < m_pAdjacencyOffsets[VertexIndex+1] && m_pVertexKinds[VertexIndex] != VERTEX_LOCKED; AdjacentIndex++ )
+		{
+			int			TriangleIndex = m_pAdjacency[AdjacentIndex];
+			const int*	pTriangle = m_pIndices + 3 * TriangleIndex;
+			int			Corner = 3 * TriangleIndex + (pTriangle[0] == VertexIndex ? 0 : (pTriangle[1] == VertexIndex ? 1 : 2));
+			if ( FirstCorner < 0 )
+			{
+				FirstCorner = Corner;
+				continue;
+			}
+
+			if ( _pTriangleMaterials != NULL && _pTriangleMaterials[TriangleIndex] != _pTriangleMaterials[FirstCorner / 3] )
+				m_pVertexKinds[VertexIndex] = VERTEX_LOCKED;
+
+			for ( int AttributeIndex=0; AttributeIndex < m_AttributesCount; AttributeIndex++ )
+				if ( fabsf( m_pAttributes[m_AttributesCount*Corner+AttributeIndex] - m_pAttributes[m_AttributesCount*FirstCorner+AttributeIndex] ) > SEAM_ATTRIBUTE_EPSILON )
+					m_pVertexKinds[VertexIndex] = VERTEX_LOCKED;
+		}
+	}
+
+	// Detect borders & lock non-manifold edges
+	for ( int TriangleIndex=0; TriangleIndex < m_TrianglesCount; TriangleIndex++ )
+	{
+		const int*	pTriangle = m_pIndices + 3 * TriangleIndex;
+		if ( pTriangle[0] < 0 )
+			continue;
+
+		for ( int EdgeIndex=0; EdgeIndex < 3; EdgeIndex++ )
+		{
+			int	V0 = pTriangle[EdgeIndex];
+			int	V1 = pTriangle[(EdgeIndex+1)%3];
+			int	SharedCount = CountSharedTriangles( V0, V1 );
+			if ( SharedCount == 2 )
+				continue;
+
+			unsigned char	Kind = SharedCount == 1 ? VERTEX_BORDER : VERTEX_LOCKED;
+			if ( m_pVertexKinds[V0] < Kind )
+				m_pVertexKinds[V0] = Kind;
+			if ( m_pVertexKinds[V1] < Kind )
+				m_pVertexKinds[V1] = Kind;
+		}
+	}
+}
+
+bool	MeshSimplifier::CanCollapse( int _From, int _To ) const
+{
+	switch ( m_pVertexKinds[_From] )
+	{
+	case VERTEX_MANIFOLD:
+		return	true;
+	case VERTEX_BORDER:
+		return	m_pVertexKinds[_To] != VERTEX_MANIFOLD && CountSharedTriangles( _From, _To ) == 1;
+	default:
+		return	false;
+	}
+}
+
+float	MeshSimplifier::ComputeCollapseCost( int _From, int _To, int _ToCornerSource ) const
+{
+	float	Point[SimplifierQuadric::MAX_DIMENSION];
+	Point[0] = m_pPositions[3*_To+0];
+	Point[1] = m_pPositions[3*_To+1];
+	Point[2] = m_pPositions[3*_To+2];
+	for ( int AttributeIndex=0; AttributeIndex < m_AttributesCount; AttributeIndex++ )
+		Point[3+AttributeIndex] = m_pAttributes[m_AttributesCount*_ToCornerSource+AttributeIndex];
+
+	const SimplifierQuadric&	Q0 = m_pQuadrics[_From];
+	const SimplifierQuadric&	Q1 = m_pQuadrics[_To];
+	float	Weight = Q0.Weight + Q1.Weight;
+
+	return	(Q0.Evaluate( Point, m_Dimension ) + Q1.Evaluate( Point, m_Dimension )) / (Weight > 1e-12f ? Weight : 1e-12f);
+}
+
+bool	MeshSimplifier::HasTriangleFlip( int _From, int _To ) const
+{
+	for ( int AdjacentIndex=m_pAdjacencyOffsets[_From]; AdjacentIndex < m_pAdjacencyOffsets[_From+1]; AdjacentIndex++ )
+	{
+		const int*	pTriangle = m_pIndices + 3 * m_pAdjacency[AdjacentIndex];
+		if ( pTriangle[0] < 0 || pTriangle[0] == _To || pTriangle[1] == _To || pTriangle[2] == _To )
+			continue;	// Collapsed or about to be
+
+		const float*	P[3];
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+			P[CornerIndex] = m_pPositions + 3 * pTriangle[CornerIndex];
+
+		float	NormalBefore[3], NormalAfter[3];
+		ComputeNormal( P[0], P[1], P[2], NormalBefore );
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+			if ( pTriangle[CornerIndex] == _From )
+				P[CornerIndex] = m_pPositions + 3 * _To;
+		ComputeNormal( P[0], P[1], P[2], NormalAfter );
+
+		// Reject flipped triangles as well as triangles whose normal rotates too much (they're usually slivers about to flip)
+		float	Dot = NormalBefore[0] * NormalAfter[0] + NormalBefore[1] * NormalAfter[1] + NormalBefore[2] * NormalAfter[2];
+		float	SqLengthBefore = NormalBefore[0] * NormalBefore[0] + NormalBefore[1] * NormalBefore[1] + NormalBefore[2] * NormalBefore[2];
+		float	SqLengthAfter = NormalAfter[0] * NormalAfter[0] + NormalAfter[1] * NormalAfter[1] + NormalAfter[2] * NormalAfter[2];
+		if ( Dot <= 0.0f || Dot * Dot < MIN_NORMAL_COSINE * MIN_NORMAL_COSINE * SqLengthBefore * SqLengthAfter )
+			return	true;
+	}
+
+	return	false;
+}
+
+void	MeshSimplifier::Collapse( int _From, int _To )
+{
+	// Retrieve the attributes of the target on the collapsed edge (the source is not on a seam so they're the same all around the source)
+	int	ToCornerSource = -1;
+	for ( int AdjacentIndex=m_pAdjacencyOffsets[_From]; AdjacentIndex < m_pAdjacencyOffsets[_From+1] && ToCornerSource < 0; AdjacentIndex++ )
+	{
+		int	TriangleIndex = m_pAdjacency[AdjacentIndex];
+		const int*	pTriangle = m_pIndices + 3 * TriangleIndex;
+		if ( pTriangle[0] < 0 )
+			continue;
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+			if ( pTriangle[CornerIndex] == _To )
+				ToCornerSource = m_pCornerSources[3*TriangleIndex+CornerIndex];
+	}
+
+	for ( int AdjacentIndex=m_pAdjacencyOffsets[_From]; AdjacentIndex < m_pAdjacencyOffsets[_From+1]; AdjacentIndex++ )
+	{
+		int		TriangleIndex = m_pAdjacency[AdjacentIndex];
+		int*	pTriangle = m_pIndices + 3 * TriangleIndex;
+		if ( pTriangle[0] < 0 )
+			continue;
+
+		if ( pTriangle[0] == _To || pTriangle[1] == _To || pTriangle[2] == _To )
+		{	// The triangle becomes degenerate
+			pTriangle[0] = -1;
+			m_LiveTrianglesCount--;
+			continue;
+		}
+
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+			if ( pTriangle[CornerIndex] == _From )
+			{
+				pTriangle[CornerIndex] = _To;
+				m_pCornerSources[3*TriangleIndex+CornerIndex] = ToCornerSource;
+			}
+	}
+
+	m_pQuadrics[_To].Add( m_pQuadrics[_From], m_Dimension );
+}
+
+int		MeshSimplifier::Simplify( int _TargetTrianglesCount, float _MaxError )
+{
+	int*			pTargets = new int[m_VerticesCount];
+	float*			pCosts = new float[m_VerticesCount];
+	int*			pCandidates = new int[m_VerticesCount];
+	unsigned char*	pTouched = new unsigned char[m_VerticesCount];
+	float			MaxCost = _MaxError * _MaxError;
+
+	while ( m_LiveTrianglesCount > _TargetTrianglesCount )
+	{
+		BuildAdjacency();
+
+		//////////////////////////////////////////////////////////////////////////
+		// Find the cheapest collapse of each vertex
+		for ( int VertexIndex=0; VertexIndex < m_VerticesCount; VertexIndex++ )
+		{
+			pTargets[VertexIndex] = -1;
+			pCosts[VertexIndex] = FLT_MAX;
+		}
+
+		for ( int TriangleIndex=0; TriangleIndex < m_TrianglesCount; TriangleIndex++ )
+		{
+			const int*	pTriangle = m_pIndices + 3 * TriangleIndex;
+			if ( pTriangle[0] < 0 )
+				continue;
+
+			for ( int EdgeIndex=0; EdgeIndex < 3; EdgeIndex++ )
+				for ( int Direction=0; Direction < 2; Direction++ )
+				{
+					int	FromCorner = 3 * TriangleIndex + (Direction == 0 ? EdgeIndex : (EdgeIndex+1)%3);
+					int	ToCorner = 3 * TriangleIndex + (Direction == 0 ? (EdgeIndex+1)%3 : EdgeIndex);
+					int	From = m_pIndices[FromCorner];
+					int	To = m_pIndices[ToCorner];
+					if ( m_pVertexKinds[From] == VERTEX_LOCKED || !CanCollapse( From, To ) )
+						continue;
+
+					float	Cost = ComputeCollapseCost( From, To, m_pCornerSources[ToCorner] );
+					if ( Cost < pCosts[From] )
+					{
+						pCosts[From] = Cost;
+						pTargets[From] = To;
+					}
+				}
+		}
+
+		int	CandidatesCount = 0;
+		for ( int VertexIndex=0; VertexIndex < m_VerticesCount; VertexIndex++ )
+			if ( pTargets[VertexIndex] >= 0 && pCosts[VertexIndex] <= MaxCost )
+				pCandidates[CandidatesCount++] = VertexIndex;
+
+		std::sort( pCandidates, pCandidates + CandidatesCount, CompareCosts( pCosts ) );
+
+		//////////////////////////////////////////////////////////////////////////
+		// Collapse by increasing cost, each vertex's neighborhood being modified at most once per pass
+		memset( pTouched, 0, m_VerticesCount );
+		int	CollapsesCount = 0;
+		for ( int CandidateIndex=0; CandidateIndex < CandidatesCount && m_LiveTrianglesCount > _TargetTrianglesCount; CandidateIndex++ )
+		{
+			int	From = pCandidates[CandidateIndex];
+			int	To = pTargets[From];
+			if ( pTouched[From] || pTouched[To] || HasTriangleFlip( From, To ) )
+				continue;
+
+			for ( int AdjacentIndex=m_pAdjacencyOffsets[From]; AdjacentIndex < m_pAdjacencyOffsets[From+1]; AdjacentIndex++ )
+			{
+				const int*	pTriangle = m_pIndices + 3 * m_pAdjacency[AdjacentIndex];
+				if ( pTriangle[0] < 0 )
+					continue;
+				pTouched[pTriangle[0]] = pTouched[pTriangle[1]] = pTouched[pTriangle[2]] = 1;
+			}
+
+			Collapse( From, To );
+			CollapsesCount++;
+
+			float	Error = sqrtf( pCosts[From] );
+			m_Error = Error > m_Error ? Error : m_Error;
+		}
+
+		if ( CollapsesCount == 0 )
+			break;	// Nothing can be collapsed anymore
+	}
+
+	delete[] pTouched;
+	delete[] pCandidates;
+	delete[] pCosts;
+	delete[] pTargets;
+
+	return	m_LiveTrianglesCount;
+}
+
+void	MeshSimplifier::GetResult( int* _pIndices, int* _pCornerSources ) const
+{
+	for ( int TriangleIndex=0; TriangleIndex < m_TrianglesCount; TriangleIndex++ )
+	{
+		const int*	pTriangle = m_pIndices + 3 * TriangleIndex;
+		if ( pTriangle[0] < 0 )
+			continue;
+
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+		{
+			*_pIndices++ = pTriangle[CornerIndex];
+			*_pCornerSources++ = m_pCornerSources[3*TriangleIndex+CornerIndex];
+		}
+	}
+}
@@ -0,0 +1,123 @@
+// Contains the native quadric mesh simplifier used to build LOD chains
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// An error quadric extended with vertex attributes (Garland & Heckbert 98)
+	// The quadric measures the squared distance of a point [x,y,z,a0,...,ak] to the planes of the triangles it accumulates.
+	// The symmetric matrix A is stored packed (upper triangle, row by row).
+	//
+	struct	SimplifierQuadric
+	{
+		static const int	MAX_DIMENSION = 8;
+		static const int	MAX_PACKED_SIZE = MAX_DIMENSION * (MAX_DIMENSION+1) / 2;
+
+		float	A[MAX_PACKED_SIZE];
+		float	b[MAX_DIMENSION];
+		float	c;
+		float	Weight;		// Sum of the accumulated areas
+
+		void	Clear( int _Dimension );
+		void	Add( const SimplifierQuadric& _Other, int _Dimension );
+
+		// Accumulates the quadric of a triangle whose corners are given as points of the given dimension
+		void	AddTriangle( const double* _pP0, const double* _pP1, const double* _pP2, int _Dimension, double _Weight );
+
+		// Accumulates the quadric of a plane (only the 3 position dimensions are involved)
+		void	AddPlane( const double _pNormal[3], double _Distance, int _Dimension, double _Weight );
+
+		// Evaluates the squared distance of a point
+		float	Evaluate( const float* _pPoint, int _Dimension ) const;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Simplifies a triangle mesh by successive half-edge collapses ordered by quadric error
+	// A vertex collapses onto one of its neighbors so no new vertex is ever created: LODs only need new indices.
+	//
+	// Attributes are given per triangle corner (i.e. per triangle vertex) and pre-multiplied by their weight.
+	// The simplifier preserves :
+	//	_ Seams : control points whose corners have different attributes never move
+	//	_ Material boundaries : control points used by triangles of different materials never move
+	//	_ Borders : border vertices only collapse along border edges onto other border vertices
+	//
+	// The error is expressed relative to the size of the mesh (i.e. positions are normalized so the largest extent is 1).
+	// Simplify() can be called several times with decreasing targets to build a chain of LODs progressively.
+	//
+	class	MeshSimplifier
+	{
+	public:		// NESTED TYPES
+
+		enum	VERTEX_KIND
+		{
+			VERTEX_MANIFOLD,	// Free to collapse onto any neighbor
+			VERTEX_BORDER,		// Can only collapse along a border edge
+			VERTEX_LOCKED,		// Never collapses (seams, material boundaries, non-manifold edges)
+		};
+
+		static const int	MAX_ATTRIBUTES = SimplifierQuadric::MAX_DIMENSION - 3;
+
+	protected:	// FIELDS
+
+		int					m_VerticesCount;
+		int					m_TrianglesCount;
+		int					m_LiveTrianglesCount;
+		int					m_AttributesCount;
+		int					m_Dimension;		// 3 + AttributesCount
+
+		float*				m_pPositions;		// Normalized positions (3 floats per vertex)
+		float*				m_pAttributes;		// Corner attributes (AttributesCount floats per corner)
+		float				m_Scale;			// The scale that was applied to normalize positions
+
+		int*				m_pIndices;			// Current indices of the triangles (first index is -1 for collapsed triangles)
+		int*				m_pCornerSources;	// Original corner each current corner takes its attributes from
+		unsigned char*		m_pVertexKinds;
+		SimplifierQuadric*	m_pQuadrics;
+
+		float				m_Error;			// Largest error of all the collapses so far (relative to the mesh size)
+
+		// Vertex => live triangles adjacency (rebuilt at each pass)
+		int*				m_pAdjacencyOffsets;
+		int*				m_pAdjacency;
+
+	public:		// PROPERTIES
+
+		int		GetTrianglesCount() const			{ return m_LiveTrianglesCount; }
+		float	GetError() const					{ return m_Error; }
+		float	GetScale() const					{ return m_Scale; }
+		int		GetVertexKind( int _VertexIndex ) const	{ return m_pVertexKinds[_VertexIndex]; }
+
+	public:		// METHODS
+
+		// _pPositions, 3 floats per vertex
+		// _pIndices, 3 indices per triangle
+		// _pCornerAttributes, AttributesCount floats per triangle corner (may be NULL if AttributesCount is 0)
+		// _pTriangleMaterials, a material ID per triangle (may be NULL)
+		MeshSimplifier( const float* _pPositions, int _VerticesCount, const int* _pIndices, int _TrianglesCount, const float* _pCornerAttributes, int _AttributesCount, const int* _pTriangleMaterials );
+		~MeshSimplifier();
+
+		// Collapses edges until there are no more than the target amount of triangles or until the next collapse would exceed the maximum error
+		// Returns the amount of remaining triangles
+		int		Simplify( int _TargetTrianglesCount, float _MaxError );
+
+		// Copies the remaining triangles
+		// _pIndices receives 3 vertex indices per triangle
+		// _pCornerSources receives, for each corner, the original corner (i.e. 3 * OriginalTriangleIndex + CornerIndex) its attributes come from
+		void	GetResult( int* _pIndices, int* _pCornerSources ) const;
+
+	protected:
+
+		void	ClassifyVertices( const int* _pTriangleMaterials );
+		void	BuildAdjacency();
+		int		CountSharedTriangles( int _V0, int _V1 ) const;
+		bool	CanCollapse( int _From, int _To ) const;
+		float	ComputeCollapseCost( int _From, int _To, int _ToCornerSource ) const;
+		bool	HasTriangleFlip( int _From, int _To ) const;
+		void	Collapse( int _From, int _To );
+
+	private:
+		MeshSimplifier( const MeshSimplifier& );
+		MeshSimplifier&	operator=( const MeshSimplifier& );
+	};
+}
@@ -0,0 +1,351 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "MeshSkin.h"
+#include "NodeMesh.h"
+#include "Scene.h"
+
+using namespace	FBXImporter;
+
+namespace FBXImporter
+{
+	// A skinning job processing a range of vertices on the thread pool
+	ref class	SkinningJob
+	{
+	public:
+
+		const SkinningBuffers*	m_pBuffers;
+		const float*			m_pBoneData;
+		int						m_VerticesCount;
+		bool					m_bDualQuaternion;
+
+		void	Execute( int _JobIndex )
+		{
+			int	StartVertex = _JobIndex * MeshSkin::VERTICES_PER_JOB;
+			int	EndVertex = Math::Min( StartVertex + MeshSkin::VERTICES_PER_JOB, m_VerticesCount );
+			if ( m_bDualQuaternion )
+				SkinningKernels::SkinDualQuaternion( *m_pBuffers, m_pBoneData, StartVertex, EndVertex );
+			else
+				SkinningKernels::SkinLinear( *m_pBuffers, m_pBoneData, StartVertex, EndVertex );
+		}
+	};
+}
+
+MeshSkin::MeshSkin( NodeMesh^ _Owner, KFbxMesh* _pMesh, int _InfluencesCount ) : m_Owner( _Owner ), m_InfluencesCount( _InfluencesCount )
+{
+	List<IntPtr>^					BoneFBXNodes = gcnew List<IntPtr>();
+	List<WMath::Matrix4x4^>^		BoneBindPoses = gcnew List<WMath::Matrix4x4^>();
+	Dictionary<IntPtr,int>^			FBXNode2BoneIndex = gcnew Dictionary<IntPtr,int>();
+
+	SkinInfluences*	pInfluences = new SkinInfluences( _pMesh->GetControlPointsCount(), _InfluencesCount );
+	try
+	{
+		int	SkinsCount = _pMesh->GetDeformerCount( KFbxDeformer::eSKIN );
+		for ( int SkinIndex=0; SkinIndex < SkinsCount; SkinIndex++ )
+		{
+			KFbxSkin*	pSkin = (KFbxSkin*) _pMesh->GetDeformer( SkinIndex, KFbxDeformer::eSKIN );
+			for ( int ClusterIndex=0; ClusterIndex < pSkin->GetClusterCount(); ClusterIndex++ )
+			{
+				KFbxCluster*	pCluster = pSkin->GetCluster( ClusterIndex );
+				KFbxNode*		pLink = pCluster->GetLink();
+				if ( pLink == NULL )
+					continue;
+
+				// Retrieve the bone index or create a new bone
+				int	BoneIndex = -1;
+				if ( !FBXNode2BoneIndex->TryGetValue( IntPtr( pLink ), BoneIndex ) )
+				{
+					BoneIndex = BoneFBXNodes->Count;
+					if ( BoneIndex > 65535 )
+						throw gcnew Exception( "Mesh \"" + _Owner->Name + "\" is influenced by more than 65536 bones !" );
+
+					FBXNode2BoneIndex->Add( IntPtr( pLink ), BoneIndex );
+					BoneFBXNodes->Add( IntPtr( pLink ) );
+
+					KFbxXMatrix	LinkTransform;
+					pCluster->GetTransformLinkMatrix( LinkTransform );
+					WMath::Matrix4x4^	BindPose = Helpers::ToMatrix( LinkTransform );
+					_Owner->ParentScene->ConvertTransform( BindPose );
+					BoneBindPoses->Add( BindPose );
+				}
+
+				if ( m_MeshBindPose == nullptr )
+				{
+					KFbxXMatrix	MeshTransform;
+					pCluster->GetTransformMatrix( MeshTransform );
+					m_MeshBindPose = Helpers::ToMatrix( MeshTransform );
+					_Owner->ParentScene->ConvertTransform( m_MeshBindPose );
+				}
+
+				// Accumulate the influences
+				int*	pIndices = pCluster->GetControlPointIndices();
+				double*	pWeights = pCluster->GetControlPointWeights();
+				int		Count = pCluster->GetControlPointIndicesCount();
+				for ( int Index=0; Index < Count; Index++ )
+					pInfluences->Add( pIndices[Index], BoneIndex, (float) pWeights[Index] );
+			}
+		}
+
+		// Keep the most important influences and renormalize them
+		pInfluences->Normalize();
+
+		int	SlotsCount = pInfluences->GetVerticesCount() * _InfluencesCount;
+		m_BoneIndices = gcnew cli::array<unsigned short>( SlotsCount );
+		m_BoneWeights = gcnew cli::array<float>( SlotsCount );
+		for ( int SlotIndex=0; SlotIndex < SlotsCount; SlotIndex++ )
+		{
+			m_BoneIndices[SlotIndex] = pInfluences->GetBoneIndices()[SlotIndex];
+			m_BoneWeights[SlotIndex] = pInfluences->GetBoneWeights()[SlotIndex];
+		}
+
+		m_MaxSourceInfluencesCount = pInfluences->GetMaxSourceInfluencesCount();
+		m_PrunedVerticesCount = pInfluences->GetPrunedVerticesCount();
+	}
+	finally
+	{
+		delete pInfluences;
+	}
+
+	m_BoneFBXNodes = BoneFBXNodes->ToArray();
+	m_BoneBindPoses = BoneBindPoses->ToArray();
+	if ( m_MeshBindPose == nullptr )
+	{
+		m_MeshBindPose = gcnew WMath::Matrix4x4();
+		m_MeshBindPose->MakeIdentity();
+	}
+
+	// Build the inverse bind poses
+	m_InverseBindPoses = gcnew cli::array<WMath::Matrix4x4^>( m_BoneBindPoses->Length );
+	for ( int BoneIndex=0; BoneIndex < m_BoneBindPoses->Length; BoneIndex++ )
+	{
+		WMath::Matrix4x4^	InvBoneBindPose = gcnew WMath::Matrix4x4( m_BoneBindPoses[BoneIndex] );
+							InvBoneBindPose->Invert();
+		m_InverseBindPoses[BoneIndex] = m_MeshBindPose * InvBoneBindPose;
+	}
+}
+
+void	MeshSkin::ResolveBones( Scene^ _Scene )
+{
+	m_Bones = gcnew cli::array<Node^>( m_BoneFBXNodes->Length );
+	for ( int BoneIndex=0; BoneIndex < m_BoneFBXNodes->Length; BoneIndex++ )
+	{
+		m_Bones[BoneIndex] = _Scene->FindNode( (KFbxNode*) m_BoneFBXNodes[BoneIndex].ToPointer() );
+		if ( m_Bones[BoneIndex] == nullptr )
+			throw gcnew Exception( "Mesh \"" + m_Owner->Name + "\" is skinned to a bone that is not part of the scene's hierarchy !" );
+	}
+
+	m_BoneFBXNodes = nullptr;
+}
+
+void	MeshSkin::RemapVertices( cli::array<int>^ _VertexRemap )
+{
+	cli::array<unsigned short>^	BoneIndices = gcnew cli::array<unsigned short>( m_BoneIndices->Length );
+	cli::array<float>^			BoneWeights = gcnew cli::array<float>( m_BoneWeights->Length );
+	for ( int VertexIndex=0; VertexIndex < _VertexRemap->Length; VertexIndex++ )
+	{
+		int	SourceSlot = VertexIndex * m_InfluencesCount;
+		int	TargetSlot = _VertexRemap[VertexIndex] * m_InfluencesCount;
+		for ( int InfluenceIndex=0; InfluenceIndex < m_InfluencesCount; InfluenceIndex++ )
+		{
+			BoneIndices[TargetSlot+InfluenceIndex] = m_BoneIndices[SourceSlot+InfluenceIndex];
+			BoneWeights[TargetSlot+InfluenceIndex] = m_BoneWeights[SourceSlot+InfluenceIndex];
+		}
+	}
+
+	m_BoneIndices = BoneIndices;
+	m_BoneWeights = BoneWeights;
+}
+
+cli::array<float>^	MeshSkin::GetBindPositions()
+{
+	cli::array<WMath::Point^>^	Vertices = m_Owner->Vertices;
+	cli::array<float>^			Result = gcnew cli::array<float>( 3 * Vertices->Length );
+	for ( int VertexIndex=0; VertexIndex < Vertices->Length; VertexIndex++ )
+	{
+		Result[3*VertexIndex+0] = Vertices[VertexIndex]->x;
+		Result[3*VertexIndex+1] = Vertices[VertexIndex]->y;
+		Result[3*VertexIndex+2] = Vertices[VertexIndex]->z;
+	}
+
+	return	Result;
+}
+
+cli::array<WMath::Matrix4x4^>^	MeshSkin::ComputeSkinningMatrices()
+{
+	if ( m_Bones == nullptr )
+		throw gcnew Exception( "Bones of mesh \"" + m_Owner->Name + "\" are not resolved !" );
+
+	cli::array<WMath::Matrix4x4^>^	BoneWorldTransforms = gcnew cli::array<WMath::Matrix4x4^>( m_Bones->Length );
+	for ( int BoneIndex=0; BoneIndex < m_Bones->Length; BoneIndex++ )
+		BoneWorldTransforms[BoneIndex] = m_Bones[BoneIndex]->LocalTransform;
+
+	return	ComputeSkinningMatrices( BoneWorldTransforms );
+}
+
+cli::array<WMath::Matrix4x4^>^	MeshSkin::ComputeSkinningMatrices( cli::array<WMath::Matrix4x4^>^ _BoneWorldTransforms )
+{
+	if ( _BoneWorldTransforms->Length != m_InverseBindPoses->Length )
+		throw gcnew Exception( "Expected " + m_InverseBindPoses->Length + " bone transforms !" );
+
+	cli::array<WMath::Matrix4x4^>^	Result = gcnew cli::array<WMath::Matrix4x4^>( m_InverseBindPoses->Length );
+	for ( int BoneIndex=0; BoneIndex < Result->Length; BoneIndex++ )
+		Result[BoneIndex] = m_InverseBindPoses[BoneIndex] * _BoneWorldTransforms[BoneIndex];
+
+	return	Result;
+}
+
+void	MeshSkin::Deform( cli::array<WMath::Matrix4x4^>^ _SkinningMatrices, cli::array<float>^ _Positions, cli::array<float>^ _Normals, cli::array<float>^ _SkinnedPositions, cli::array<float>^ _SkinnedNormals, SKINNING_METHOD _Method )
+{
+	int	VerticesCount = m_BoneWeights->Length / m_InfluencesCount;
+	if ( _SkinningMatrices->Length != m_InverseBindPoses->Length )
+		throw gcnew Exception( "Expected " + m_InverseBindPoses->Length + " skinning matrices !" );
+	if ( _Positions->Length < 3 * VerticesCount || _SkinnedPositions->Length < 3 * VerticesCount )
+		throw gcnew Exception( "Position buffers must contain at least " + 3 * VerticesCount + " floats !" );
+	if ( (_Normals == nullptr) != (_SkinnedNormals == nullptr) )
+		throw gcnew Exception( "Either provide both source and target normal buffers, or none !" );
+	if ( _Normals != nullptr && (_Normals->Length < 3 * VerticesCount || _SkinnedNormals->Length < 3 * VerticesCount) )
+		throw gcnew Exception( "Normal buffers must contain at least " + 3 * VerticesCount + " floats !" );
+	if ( VerticesCount == 0 )
+		return;
+
+	// Pack the matrices
+	int		BonesCount = _SkinningMatrices->Length;
+	float*	pBoneMatrices = new float[16 * (BonesCount > 0 ? BonesCount : 1)];
+	float*	pDualQuaternions = NULL;
+	try
+	{
+		for ( int BoneIndex=0; BoneIndex < BonesCount; BoneIndex++ )
+			for ( int Row=0; Row < 4; Row++ )
+				for ( int Column=0; Column < 4; Column++ )
+					pBoneMatrices[16*BoneIndex+4*Row+Column] = _SkinningMatrices[BoneIndex]->m[Row,Column];
+
+		if ( _Method == SKINNING_METHOD::DUAL_QUATERNION )
+		{
+			pDualQuaternions = new float[8 * (BonesCount > 0 ? BonesCount : 1)];
+			SkinningKernels::ConvertToDualQuaternions( pBoneMatrices, BonesCount, pDualQuaternions );
+		}
+
+		pin_ptr<unsigned short>	pBoneIndices = &m_BoneIndices[0];
+		pin_ptr<float>			pBoneWeights = &m_BoneWeights[0];
+		pin_ptr<float>			pPositions = &_Positions[0];
+		pin_ptr<float>			pSkinnedPositions = &_SkinnedPositions[0];
+		pin_ptr<float>			pNormals = nullptr;
+		pin_ptr<float>			pSkinnedNormals = nullptr;
+		if ( _Normals != nullptr )
+		{
+			pNormals = &_Normals[0];
+			pSkinnedNormals = &_SkinnedNormals[0];
+		}
+
+		SkinningBuffers	Buffers;
+		Buffers.InfluencesCount = m_InfluencesCount;
+		Buffers.pBoneIndices = pBoneIndices;
+		Buffers.pBoneWeights = pBoneWeights;
+		Buffers.pPositions = pPositions;
+		Buffers.pNormals = pNormals;
+		Buffers.pSkinnedPositions = pSkinnedPositions;
+		Buffers.pSkinnedNormals = pSkinnedNormals;
+
+		Skin( Buffers, pDualQuaternions != NULL ? pDualQuaternions : pBoneMatrices, VerticesCount, _Method );
+	}
+	finally
+	{
+		delete[] pBoneMatrices;
+		delete[] pDualQuaternions;
+	}
+}
+
+void	MeshSkin::Skin( const SkinningBuffers& _Buffers, const float* _pBoneData, int _VerticesCount, SKINNING_METHOD _Method )
+{
+	SkinningJob^	Job = gcnew SkinningJob();
+	Job->m_pBuffers = &_Buffers;
+	Job->m_pBoneData = _pBoneData;
+	Job->m_VerticesCount = _VerticesCount;
+	Job->m_bDualQuaternion = _Method == SKINNING_METHOD::DUAL_QUATERNION;
+
+	int	JobsCount = (_VerticesCount + VERTICES_PER_JOB - 1) / VERTICES_PER_JOB;
+	if ( JobsCount == 1 )
+		Job->Execute( 0 );
+	else
+		System::Threading::Tasks::Parallel::For( 0, JobsCount, gcnew Action<int>( Job, &SkinningJob::Execute ) );
+}
+
+double	MeshSkin::Benchmark( int _VerticesCount, int _BonesCount, int _InfluencesCount, SKINNING_METHOD _Method, int _IterationsCount )
+{
+	if ( _VerticesCount <= 0 || _BonesCount <= 0 || _BonesCount > 65536 || _InfluencesCount <= 0 || _IterationsCount <= 0 )
+		throw gcnew Exception( "Invalid benchmark parameters !" );
+
+	Random^	RNG = gcnew Random( 1 );
+
+	// Build random rigid bones
+	cli::array<WMath::Matrix4x4^>^	Bones = gcnew cli::array<WMath::Matrix4x4^>( _BonesCount );
+	for ( int BoneIndex=0; BoneIndex < _BonesCount; BoneIndex++ )
+	{
+		Bones[BoneIndex] = gcnew WMath::Matrix4x4();
+		Bones[BoneIndex]->FromEuler( gcnew WMath::Vector( (float) RNG->NextDouble(), (float) RNG->NextDouble(), (float) RNG->NextDouble() ) );
+		Bones[BoneIndex]->SetTrans( gcnew WMath::Point( (float) RNG->NextDouble(), (float) RNG->NextDouble(), (float) RNG->NextDouble() ) );
+	}
+
+	// Build random vertices & influences
+	SkinInfluences*	pInfluences = new SkinInfluences( _VerticesCount, _InfluencesCount );
+	float*			pPositions = new float[3*_VerticesCount];
+	float*			pNormals = new float[3*_VerticesCount];
+	float*			pSkinnedPositions = new float[3*_VerticesCount];
+	float*			pSkinnedNormals = new float[3*_VerticesCount];
+	float*			pBoneMatrices = new float[16*_BonesCount];
+	float*			pDualQuaternions = new float[8*_BonesCount];
+	double			Result = 0.0;
+	try
+	{
+		for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+		{
+			for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+			{
+				pPositions[3*VertexIndex+ComponentIndex] = (float) RNG->NextDouble();
+				pNormals[3*VertexIndex+ComponentIndex] = ComponentIndex == 2 ? 1.0f : 0.0f;
+			}
+			for ( int InfluenceIndex=0; InfluenceIndex < _InfluencesCount; InfluenceIndex++ )
+				pInfluences->Add( VertexIndex, RNG->Next( _BonesCount ), (float) RNG->NextDouble() );
+		}
+		pInfluences->Normalize();
+
+		for ( int BoneIndex=0; BoneIndex < _BonesCount; BoneIndex++ )
+			for ( int Row=0; Row < 4; Row++ )
+				for ( int Column=0; Column < 4; Column++ )
+					pBoneMatrices[16*BoneIndex+4*Row+Column] = Bones[BoneIndex]->m[Row,Column];
+		SkinningKernels::ConvertToDualQuaternions( pBoneMatrices, _BonesCount, pDualQuaternions );
+		const float*	pBoneData = _Method == SKINNING_METHOD::DUAL_QUATERNION ? pDualQuaternions : pBoneMatrices;
+
+		SkinningBuffers	Buffers;
+		Buffers.InfluencesCount = _InfluencesCount;
+		Buffers.pBoneIndices = pInfluences->GetBoneIndices();
+		Buffers.pBoneWeights = pInfluences->GetBoneWeights();
+		Buffers.pPositions = pPositions;
+		Buffers.pNormals = pNormals;
+		Buffers.pSkinnedPositions = pSkinnedPositions;
+		Buffers.pSkinnedNormals = pSkinnedNormals;
+
+		// Warm up then measure
+		Skin( Buffers, pBoneData, _VerticesCount, _Method );
+
+		System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+		for ( int IterationIndex=0; IterationIndex < _IterationsCount; IterationIndex++ )
+			Skin( Buffers, pBoneData, _VerticesCount, _Method );
+		Watch->Stop();
+
+		Result = (double) _VerticesCount * _IterationsCount / Math::Max( 1e-6, Watch->Elapsed.TotalMilliseconds );
+	}
+	finally
+	{
+		delete pInfluences;
+		delete[] pPositions;
+		delete[] pNormals;
+		delete[] pSkinnedPositions;
+		delete[] pSkinnedNormals;
+		delete[] pBoneMatrices;
+		delete[] pDualQuaternions;
+	}
+
+	return	Result;
+}
@@ -0,0 +1,168 @@
+// Contains the skin attached to a mesh node and the CPU skinning of its vertices
+//
+#pragma managed
+#pragma once
+
+#include "Helpers.h"
+#include "SkinningKernels.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+
+namespace FBXImporter
+{
+	ref class	Scene;
+	ref class	Node;
+	ref class	NodeMesh;
+
+	//////////////////////////////////////////////////////////////////////////
+	// The skin of a mesh, built from all the clusters of its skin deformers
+	// Each vertex is influenced by at most InfluencesCount bones whose weights sum to 1.
+	// Influences are sorted by decreasing weight and unused slots have a 0 weight.
+	//
+	// The bind pose of each bone is given in world space, as well as the bind pose of the mesh.
+	// The inverse bind pose of a bone transforms a mesh vertex into the bone's space at bind time so
+	//	a skinning matrix is simply InverseBindPose * BoneWorldTransform.
+	//
+	public ref class		MeshSkin
+	{
+	public:		// NESTED TYPES
+
+		enum class	SKINNING_METHOD
+		{
+			LINEAR_BLEND,		// Classical linear blend skinning (LBS)
+			DUAL_QUATERNION,	// Dual quaternion skinning (DQS), no candy wrapper effect but rigid bones only
+		};
+
+		literal int		VERTICES_PER_JOB = 4096;
+
+	protected:	// FIELDS
+
+		NodeMesh^						m_Owner;
+
+		cli::array<IntPtr>^				m_BoneFBXNodes;		// The FBX link nodes, until they're resolved into our nodes
+		cli::array<Node^>^				m_Bones;
+		cli::array<WMath::Matrix4x4^>^	m_BoneBindPoses;
+		WMath::Matrix4x4^				m_MeshBindPose;
+		cli::array<WMath::Matrix4x4^>^	m_InverseBindPoses;
+
+		int								m_InfluencesCount;
+		cli::array<unsigned short>^		m_BoneIndices;
+		cli::array<float>^				m_BoneWeights;
+
+		int								m_MaxSourceInfluencesCount;
+		int								m_PrunedVerticesCount;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the mesh owning the skin" )]
+		//
+		property NodeMesh^			Owner
+		{
+			NodeMesh^					get()	{ return m_Owner; }
+		}
+
+		[DescriptionAttribute( "Gets the bones influencing the mesh" )]
+		//
+		property cli::array<Node^>^	Bones
+		{
+			cli::array<Node^>^			get()	{ return m_Bones; }
+		}
+
+		[DescriptionAttribute( "Gets the world transform of each bone at bind time" )]
+		//
+		property cli::array<WMath::Matrix4x4^>^	BoneBindPoses
+		{
+			cli::array<WMath::Matrix4x4^>^	get()	{ return m_BoneBindPoses; }
+		}
+
+		[DescriptionAttribute( "Gets the world transform of the mesh at bind time" )]
+		//
+		property WMath::Matrix4x4^	MeshBindPose
+		{
+			WMath::Matrix4x4^			get()	{ return m_MeshBindPose; }
+		}
+
+		[DescriptionAttribute( "Gets the matrices transforming the mesh vertices into each bone's space at bind time" )]
+		//
+		property cli::array<WMath::Matrix4x4^>^	InverseBindPoses
+		{
+			cli::array<WMath::Matrix4x4^>^	get()	{ return m_InverseBindPoses; }
+		}
+
+		[DescriptionAttribute( "Gets the amount of influence slots per vertex" )]
+		//
+		property int				InfluencesCount
+		{
+			int							get()	{ return m_InfluencesCount; }
+		}
+
+		[DescriptionAttribute( "Gets the bone indices (InfluencesCount per vertex)" )]
+		//
+		property cli::array<unsigned short>^	BoneIndices
+		{
+			cli::array<unsigned short>^	get()	{ return m_BoneIndices; }
+		}
+
+		[DescriptionAttribute( "Gets the bone weights (InfluencesCount per vertex)" )]
+		//
+		property cli::array<float>^	BoneWeights
+		{
+			cli::array<float>^			get()	{ return m_BoneWeights; }
+		}
+
+		[DescriptionAttribute( "Gets the maximum amount of influences found on a single vertex in the source file" )]
+		//
+		property int				MaxSourceInfluencesCount
+		{
+			int							get()	{ return m_MaxSourceInfluencesCount; }
+		}
+
+		[DescriptionAttribute( "Gets the amount of vertices that lost some of their influences" )]
+		//
+		property int				PrunedVerticesCount
+		{
+			int							get()	{ return m_PrunedVerticesCount; }
+		}
+
+	public:		// METHODS
+
+		MeshSkin( NodeMesh^ _Owner, KFbxMesh* _pMesh, int _InfluencesCount );
+
+		// Tells if the FBX mesh has any skin deformer
+		static bool	HasSkin( KFbxMesh* _pMesh )	{ return _pMesh->GetDeformerCount( KFbxDeformer::eSKIN ) > 0; }
+
+		// Gets the bind pose positions of the mesh packed as 3 floats per vertex
+		cli::array<float>^	GetBindPositions();
+
+		// Computes the skinning matrices from the current world transform of each bone
+		cli::array<WMath::Matrix4x4^>^	ComputeSkinningMatrices();
+
+		// Computes the skinning matrices from the provided world transform of each bone
+		cli::array<WMath::Matrix4x4^>^	ComputeSkinningMatrices( cli::array<WMath::Matrix4x4^>^ _BoneWorldTransforms );
+
+		// Skins the packed positions & normals (3 floats per vertex) using all the available processors
+		//	_SkinningMatrices, one matrix per bone (cf. ComputeSkinningMatrices())
+		//	_Normals & _SkinnedNormals, can be null
+		void	Deform( cli::array<WMath::Matrix4x4^>^ _SkinningMatrices, cli::array<float>^ _Positions, cli::array<float>^ _Normals, cli::array<float>^ _SkinnedPositions, cli::array<float>^ _SkinnedNormals, SKINNING_METHOD _Method );
+
+		// Measures the amount of vertices skinned per millisecond on random data
+		static double	Benchmark( int _VerticesCount, int _BonesCount, int _InfluencesCount, SKINNING_METHOD _Method, int _IterationsCount );
+
+	internal:
+
+		// Resolves the FBX link nodes into our nodes, once the whole hierarchy is built
+		void	ResolveBones( Scene^ _Scene );
+
+		// Reorders the influences after the owner mesh's control points were reordered
+		// _VertexRemap gives the new index of each old control point
+		void	RemapVertices( cli::array<int>^ _VertexRemap );
+
+	protected:
+
+		// Runs the kernel on all the vertices, split into jobs dispatched on the thread pool
+		static void	Skin( const SkinningBuffers& _Buffers, const float* _pBoneData, int _VerticesCount, SKINNING_METHOD _Method );
+	};
+}
@@ -0,0 +1,328 @@
+// Native meshlet builder & culler
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include <xmmintrin.h>
+
+#include "MeshletBuilder.h"
+
+using namespace	FBXImporter;
+
+static const float	MIN_CONE_COSINE = 0.1f;		// Meshlets whose normals spread more than ~84 degrees from their average get no cone
+
+//////////////////////////////////////////////////////////////////////////
+// MeshletBuilder
+//
+int		MeshletBuilder::Build( const int* _pIndices, const int* _pRangeStarts, int _RangesCount, int _VerticesCount, int _MaxVertices, int _MaxTriangles,
+							   Meshlet* _pMeshlets, int* _pMeshletVertices, unsigned char* _pMeshletTriangles, int* _pMeshletSourceTriangles )
+{
+	int	TrianglesCount = _pRangeStarts[_RangesCount];
+	_MaxVertices = _MaxVertices < 3 ? 3 : (_MaxVertices > MAX_VERTICES ? MAX_VERTICES : _MaxVertices);
+	_MaxTriangles = _MaxTriangles < 1 ? 1 : (_MaxTriangles > MAX_TRIANGLES ? MAX_TRIANGLES : _MaxTriangles);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Build the vertex => triangles adjacency
+	int*	pAdjacencyOffsets = new int[_VerticesCount+1];
+	int*	pAdjacency = new int[3 * TrianglesCount];
+	memset( pAdjacencyOffsets, 0, sizeof(int) * (_VerticesCount+1) );
+	for ( int Index=0; Index < 3 * TrianglesCount; Index++ )
+		pAdjacencyOffsets[_pIndices[Index]+1]++;
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+		pAdjacencyOffsets[VertexIndex+1] += pAdjacencyOffsets[VertexIndex];
+	for ( int VertexIndex=_VerticesCount; VertexIndex > 0; VertexIndex-- )
+		pAdjacencyOffsets[VertexIndex] = pAdjacencyOffsets[VertexIndex-1];
+	pAdjacencyOffsets[0] = 0;
+	for ( int Index=0; Index < 3 * TrianglesCount; Index++ )
+		pAdjacency[pAdjacencyOffsets[_pIndices[Index]+1]++] = Index / 3;
+
+	bool*	pEmitted = new bool[TrianglesCount];
+	int*	pLocalIndices = new int[_VerticesCount];
+	memset( pEmitted, 0, sizeof(bool) * TrianglesCount );
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+		pLocalIndices[VertexIndex] = -1;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Grow meshlets
+	int	MeshletsCount = 0;
+	int	VerticesOffset = 0;
+	int	TrianglesOffset = 0;
+	for ( int RangeIndex=0; RangeIndex < _RangesCount; RangeIndex++ )
+	{
+		int	RangeStart = _pRangeStarts[RangeIndex];
+		int	RangeEnd = _pRangeStarts[RangeIndex+1];
+		int	Cursor = RangeStart;	// Next seed candidate, in input order
+
+		for ( ;; )
+		{
+			while ( Cursor < RangeEnd && pEmitted[Cursor] )
+				Cursor++;
+			if ( Cursor == RangeEnd )
+				break;
+
+			Meshlet&	M = _pMeshlets[MeshletsCount++];
+			M.VertexOffset = VerticesOffset;
+			M.VertexCount = 0;
+			M.TriangleOffset = TrianglesOffset;
+			M.TriangleCount = 0;
+
+			int*			pVertices = _pMeshletVertices + VerticesOffset;
+			unsigned char*	pTriangles = _pMeshletTriangles + 3 * TrianglesOffset;
+
+			int	TriangleIndex = Cursor;
+			while ( TriangleIndex >= 0 )
+			{
+				// Add the triangle
+				pEmitted[TriangleIndex] = true;
+				for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+				{
+					int	VertexIndex = _pIndices[3*TriangleIndex+CornerIndex];
+					if ( pLocalIndices[VertexIndex] < 0 )
+					{
+						pLocalIndices[VertexIndex] = M.VertexCount;
+						pVertices[M.VertexCount++] = VertexIndex;
+					}
+					pTriangles[3*M.TriangleCount+CornerIndex] = (unsigned char) pLocalIndices[VertexIndex];
+				}
+				_pMeshletSourceTriangles[TrianglesOffset+M.TriangleCount] = TriangleIndex;
+				if ( ++M.TriangleCount == _MaxTriangles )
+					break;
+
+				// Find the adjacent triangle bringing the fewest new vertices
+				TriangleIndex = -1;
+				int	BestNewVerticesCount = 4;
+				for ( int LocalIndex=0; LocalIndex < M.VertexCount && BestNewVerticesCount > 0; LocalIndex++ )
+				{
+					int	VertexIndex = pVertices[LocalIndex];
+					for ( int AdjacentIndex=pAdjacencyOffsets[VertexIndex]; AdjacentIndex < pAdjacencyOffsets[VertexIndex+1]; AdjacentIndex++ )
+					{
+						int	CandidateIndex = pAdjacency[AdjacentIndex];
+						if ( pEmitted[CandidateIndex] || CandidateIndex < RangeStart || CandidateIndex >= RangeEnd )
+							continue;
+
+						const int*	pCandidate = _pIndices + 3 * CandidateIndex;
+						int			NewVerticesCount = (pLocalIndices[pCandidate[0]] < 0 ? 1 : 0) + (pLocalIndices[pCandidate[1]] < 0 ? 1 : 0) + (pLocalIndices[pCandidate[2]] < 0 ? 1 : 0);
+						if ( NewVerticesCount < BestNewVerticesCount )
+						{
+							BestNewVerticesCount = NewVerticesCount;
+							TriangleIndex = CandidateIndex;
+							if ( NewVerticesCount == 0 )
+								break;
+						}
+					}
+				}
+
+				if ( TriangleIndex >= 0 && M.VertexCount + BestNewVerticesCount > _MaxVertices )
+					TriangleIndex = -1;	// Full
+			}
+
+			for ( int LocalIndex=0; LocalIndex < M.VertexCount; LocalIndex++ )
+				pLocalIndices[pVertices[LocalIndex]] = -1;
+
+			VerticesOffset += M.VertexCount;
+			TrianglesOffset += M.TriangleCount;
+		}
+	}
+
+	delete[] pLocalIndices;
+	delete[] pEmitted;
+	delete[] pAdjacency;
+	delete[] pAdjacencyOffsets;
+
+	return	MeshletsCount;
+}
+
+void	MeshletBuilder::ComputeBounds( const Meshlet& _Meshlet, const int* _pMeshletVertices, const unsigned char* _pMeshletTriangles, const float* _pPositions, MeshletBounds& _Bounds )
+{
+	const int*				pVertices = _pMeshletVertices + _Meshlet.VertexOffset;
+	const unsigned char*	pTriangles = _pMeshletTriangles + 3 * _Meshlet.TriangleOffset;
+
+	//////////////////////////////////////////////////////////////////////////
+	// AABB & sphere
+	for ( int Component=0; Component < 3; Component++ )
+	{
+		_Bounds.Min[Component] = FLT_MAX;
+		_Bounds.Max[Component] = -FLT_MAX;
+	}
+	for ( int LocalIndex=0; LocalIndex < _Meshlet.VertexCount; LocalIndex++ )
+	{
+		const float*	P = _pPositions + 3 * pVertices[LocalIndex];
+		for ( int Component=0; Component < 3; Component++ )
+		{
+			_Bounds.Min[Component] = P[Component] < _Bounds.Min[Component] ? P[Component] : _Bounds.Min[Component];
+			_Bounds.Max[Component] = P[Component] > _Bounds.Max[Component] ? P[Component] : _Bounds.Max[Component];
+		}
+	}
+
+	float	SqRadius = 0.0f;
+	for ( int Component=0; Component < 3; Component++ )
+		_Bounds.Center[Component] = 0.5f * (_Bounds.Min[Component] + _Bounds.Max[Component]);
+	for ( int LocalIndex=0; LocalIndex < _Meshlet.VertexCount; LocalIndex++ )
+	{
+		const float*	P = _pPositions + 3 * pVertices[LocalIndex];
+		float	D[3] = { P[0] - _Bounds.Center[0], P[1] - _Bounds.Center[1], P[2] - _Bounds.Center[2] };
+		float	SqDistance = D[0] * D[0] + D[1] * D[1] + D[2] * D[2];
+		SqRadius = SqDistance > SqRadius ? SqDistance : SqRadius;
+	}
+	_Bounds.Radius = sqrtf( SqRadius );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Normal cone
+	// By default, the cone never culls anything
+	_Bounds.ConeAxis[0] = _Bounds.ConeAxis[1] = _Bounds.ConeAxis[2] = 0.0f;
+	_Bounds.ConeCutoff = 1.0f;
+	_Bounds.ConeApex[0] = _Bounds.Center[0];
+	_Bounds.ConeApex[1] = _Bounds.Center[1];
+	_Bounds.ConeApex[2] = _Bounds.Center[2];
+
+	float	Axis[3] = { 0.0f, 0.0f, 0.0f };
+	for ( int TriangleIndex=0; TriangleIndex < _Meshlet.TriangleCount; TriangleIndex++ )
+	{
+		const float*	P0 = _pPositions + 3 * pVertices[pTriangles[3*TriangleIndex+0]];
+		const float*	P1 = _pPositions + 3 * pVertices[pTriangles[3*TriangleIndex+1]];
+		const float*	P2 = _pPositions + 3 * pVertices[pTriangles[3*TriangleIndex+2]];
+		float	D1[3] = { P1[0] - P0[0], P1[1] - P0[1], P1[2] - P0[2] };
+		float	D2[3] = { P2[0] - P0[0], P2[1] - P0[1], P2[2] - P0[2] };
+		float	N[3] = { D1[1] * D2[2] - D1[2] * D2[1], D1[2] * D2[0] - D1[0] * D2[2], D1[0] * D2[1] - D1[1] * D2[0] };
+		float	Length = sqrtf( N[0] * N[0] + N[1] * N[1] + N[2] * N[2] );
+		if ( Length < 1e-20f )
+			continue;
+
+		Axis[0] += N[0] / Length;
+		Axis[1] += N[1] / Length;
+		Axis[2] += N[2] / Length;
+	}
+
+	float	AxisLength = sqrtf( Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2] );
+	if ( AxisLength < 1e-6f )
+		return;
+	Axis[0] /= AxisLength;
+	Axis[1] /= AxisLength;
+	Axis[2] /= AxisLength;
+
+	// Find the widest normal & the apex of the cone (i.e. the point on the axis behind all the triangles' planes)
+	float	MinDot = 1.0f;
+	float	MaxT = 0.0f;
+	for ( int TriangleIndex=0; TriangleIndex < _Meshlet.TriangleCount; TriangleIndex++ )
+	{
+		const float*	P0 = _pPositions + 3 * pVertices[pTriangles[3*TriangleIndex+0]];
+		const float*	P1 = _pPositions + 3 * pVertices[pTriangles[3*TriangleIndex+1]];
+		const float*	P2 = _pPositions + 3 * pVertices[pTriangles[3*TriangleIndex+2]];
+		float	D1[3] = { P1[0] - P0[0], P1[1] - P0[1], P1[2] - P0[2] };
+		float	D2[3] = { P2[0] - P0[0], P2[1] - P0[1], P2[2] - P0[2] };
+		float	N[3] = { D1[1] * D2[2] - D1[2] * D2[1], D1[2] * D2[0] - D1[0] * D2[2], D1[0] * D2[1] - D1[1] * D2[0] };
+		float	Length = sqrtf( N[0] * N[0] + N[1] * N[1] + N[2] * N[2] );
+		if ( Length < 1e-20f )
+			continue;
+		N[0] /= Length;
+		N[1] /= Length;
+		N[2] /= Length;
+
+		float	Dot = N[0] * Axis[0] + N[1] * Axis[1] + N[2] * Axis[2];
+		MinDot = Dot < MinDot ? Dot : MinDot;
+		if ( MinDot < MIN_CONE_COSINE )
+			return;	// Too wide
+
+		float	DistanceToPlane = (_Bounds.Center[0] - P0[0]) * N[0] + (_Bounds.Center[1] - P0[1]) * N[1] + (_Bounds.Center[2] - P0[2]) * N[2];
+		float	T = DistanceToPlane / Dot;
+		MaxT = T > MaxT ? T : MaxT;
+	}
+
+	_Bounds.ConeAxis[0] = Axis[0];
+	_Bounds.ConeAxis[1] = Axis[1];
+	_Bounds.ConeAxis[2] = Axis[2];
+	_Bounds.ConeCutoff = sqrtf( 1.0f - MinDot * MinDot );
+	_Bounds.ConeApex[0] = _Bounds.Center[0] - Axis[0] * MaxT;
+	_Bounds.ConeApex[1] = _Bounds.Center[1] - Axis[1] * MaxT;
+	_Bounds.ConeApex[2] = _Bounds.Center[2] - Axis[2] * MaxT;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// MeshletCuller
+//
+MeshletCuller::MeshletCuller( const MeshletBounds* _pBounds, int _MeshletsCount ) : m_MeshletsCount( _MeshletsCount )
+{
+	m_BlocksCount = (_MeshletsCount + 3) >> 2;
+	m_pBlocks = new float[44 * m_BlocksCount];
+	memset( m_pBlocks, 0, sizeof(float) * 44 * m_BlocksCount );
+
+	for ( int MeshletIndex=0; MeshletIndex < _MeshletsCount; MeshletIndex++ )
+	{
+		const MeshletBounds&	B = _pBounds[MeshletIndex];
+		float*	pBlock = m_pBlocks + 44 * (MeshletIndex >> 2) + (MeshletIndex & 3);
+		pBlock[4*0] = B.Center[0];
+		pBlock[4*1] = B.Center[1];
+		pBlock[4*2] = B.Center[2];
+		pBlock[4*3] = B.Radius;
+		pBlock[4*4] = B.ConeAxis[0];
+		pBlock[4*5] = B.ConeAxis[1];
+		pBlock[4*6] = B.ConeAxis[2];
+		pBlock[4*7] = B.ConeCutoff;
+		pBlock[4*8] = B.ConeApex[0];
+		pBlock[4*9] = B.ConeApex[1];
+		pBlock[4*10] = B.ConeApex[2];
+	}
+}
+
+MeshletCuller::~MeshletCuller()
+{
+	delete[] m_pBlocks;
+}
+
+int		MeshletCuller::Cull( const float* _pPlanes, int _PlanesCount, const float* _pEyePosition, unsigned char* _pVisible ) const
+{
+	__m128	Zero = _mm_setzero_ps();
+	__m128	AllOnes = _mm_cmpeq_ps( Zero, Zero );
+	__m128	EyeX = _mm_set1_ps( _pEyePosition != NULL ? _pEyePosition[0] : 0.0f );
+	__m128	EyeY = _mm_set1_ps( _pEyePosition != NULL ? _pEyePosition[1] : 0.0f );
+	__m128	EyeZ = _mm_set1_ps( _pEyePosition != NULL ? _pEyePosition[2] : 0.0f );
+
+	int	VisibleCount = 0;
+	for ( int BlockIndex=0; BlockIndex < m_BlocksCount; BlockIndex++ )
+	{
+		const float*	pBlock = m_pBlocks + 44 * BlockIndex;
+		__m128	CenterX = _mm_loadu_ps( pBlock + 0 );
+		__m128	CenterY = _mm_loadu_ps( pBlock + 4 );
+		__m128	CenterZ = _mm_loadu_ps( pBlock + 8 );
+		__m128	NegRadius = _mm_sub_ps( Zero, _mm_loadu_ps( pBlock + 12 ) );
+
+		// Sphere against planes
+		__m128	Visible = AllOnes;
+		for ( int PlaneIndex=0; PlaneIndex < _PlanesCount; PlaneIndex++ )
+		{
+			const float*	pPlane = _pPlanes + 4 * PlaneIndex;
+			__m128	Distance = _mm_add_ps(	_mm_add_ps( _mm_mul_ps( _mm_set1_ps( pPlane[0] ), CenterX ), _mm_mul_ps( _mm_set1_ps( pPlane[1] ), CenterY ) ),
+											_mm_add_ps( _mm_mul_ps( _mm_set1_ps( pPlane[2] ), CenterZ ), _mm_set1_ps( pPlane[3] ) ) );
+			Visible = _mm_and_ps( Visible, _mm_cmpge_ps( Distance, NegRadius ) );
+		}
+
+		// Normal cone
+		if ( _pEyePosition != NULL )
+		{
+			__m128	DX = _mm_sub_ps( _mm_loadu_ps( pBlock + 32 ), EyeX );
+			__m128	DY = _mm_sub_ps( _mm_loadu_ps( pBlock + 36 ), EyeY );
+			__m128	DZ = _mm_sub_ps( _mm_loadu_ps( pBlock + 40 ), EyeZ );
+			__m128	Length = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( DX, DX ), _mm_mul_ps( DY, DY ) ), _mm_mul_ps( DZ, DZ ) ) );
+			__m128	Dot = _mm_add_ps( _mm_add_ps( _mm_mul_ps( DX, _mm_loadu_ps( pBlock + 16 ) ), _mm_mul_ps( DY, _mm_loadu_ps( pBlock + 20 ) ) ), _mm_mul_ps( DZ, _mm_loadu_ps( pBlock + 24 ) ) );
+			__m128	BackFacing = _mm_cmpgt_ps( Dot, _mm_mul_ps( _mm_loadu_ps( pBlock + 28 ), Length ) );
+			Visible = _mm_andnot_ps( BackFacing, Visible );
+		}
+
+		int	Mask = _mm_movemask_ps( Visible );
+		int	FirstMeshlet = 4 * BlockIndex;
+		int	LanesCount = m_MeshletsCount - FirstMeshlet < 4 ? m_MeshletsCount - FirstMeshlet : 4;
+		for ( int Lane=0; Lane < LanesCount; Lane++ )
+		{
+			unsigned char	bVisible = (unsigned char) ((Mask >> Lane) & 1);
+			_pVisible[FirstMeshlet+Lane] = bVisible;
+			VisibleCount += bVisible;
+		}
+	}
+
+	return	VisibleCount;
+}
@@ -0,0 +1,93 @@
+// Contains the native meshlet builder and the SIMD meshlet culler
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A meshlet is a small cluster of triangles referencing at most MaxVertices vertices
+	// Vertices are stored as global vertex indices, triangles as 3 local indices (bytes) into the meshlet's vertices.
+	//
+	struct	Meshlet
+	{
+		int		VertexOffset;		// Offset of the first vertex in the meshlet vertices array
+		int		VertexCount;
+		int		TriangleOffset;		// Offset of the first triangle in the meshlet triangles array (in triangles)
+		int		TriangleCount;
+	};
+
+	// Bounds of a meshlet (17 floats)
+	// The normal cone allows to cull back-facing meshlets: the meshlet is back-facing when
+	//	dot( normalize( ConeApex - EyePosition ), ConeAxis ) > ConeCutoff
+	// Meshlets whose normals spread too much get a null axis & a cutoff of 1 so they are never culled that way.
+	//
+	struct	MeshletBounds
+	{
+		float	Center[3];
+		float	Radius;
+		float	Min[3];
+		float	Max[3];
+		float	ConeAxis[3];
+		float	ConeCutoff;			// Sine of the cone's half angle
+		float	ConeApex[3];
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Splits a triangle list into meshlets
+	// Meshlets grow greedily from a seed triangle by always adding the adjacent triangle that brings the fewest new vertices,
+	//	which maximizes vertex reuse and keeps meshlets compact so their bounds and cones are tight.
+	// Triangle ranges (e.g. one per material) are never mixed in a same meshlet.
+	//
+	class	MeshletBuilder
+	{
+	public:
+
+		static const int	MAX_VERTICES = 255;		// Local indices are stored as bytes
+		static const int	MAX_TRIANGLES = 512;
+
+		// Builds the meshlets of all the ranges
+		// _pIndices, 3 vertex indices per triangle
+		// _pRangeStarts, _RangesCount+1 triangle offsets delimiting the ranges
+		// The output arrays must be able to hold the worst case: TrianglesCount meshlets, 3*TrianglesCount vertices and TrianglesCount triangles
+		// _pMeshletSourceTriangles receives the index in the input list of every meshlet triangle
+		// Returns the amount of meshlets
+		static int		Build( const int* _pIndices, const int* _pRangeStarts, int _RangesCount, int _VerticesCount, int _MaxVertices, int _MaxTriangles,
+							   Meshlet* _pMeshlets, int* _pMeshletVertices, unsigned char* _pMeshletTriangles, int* _pMeshletSourceTriangles );
+
+		// Computes the bounding sphere, the AABB and the normal cone of a meshlet
+		static void		ComputeBounds( const Meshlet& _Meshlet, const int* _pMeshletVertices, const unsigned char* _pMeshletTriangles, const float* _pPositions, MeshletBounds& _Bounds );
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Culls meshlets against a frustum and their normal cones, 4 meshlets at a time with SSE
+	// Bounds are stored in SoA blocks of 4 meshlets (padding meshlets are always culled).
+	//
+	class	MeshletCuller
+	{
+	protected:	// FIELDS
+
+		int		m_MeshletsCount;
+		int		m_BlocksCount;
+		float*	m_pBlocks;			// 11 x 4 floats per block: center xyz, radius, cone axis xyz, cone cutoff, cone apex xyz
+
+	public:		// PROPERTIES
+
+		int		GetMeshletsCount() const	{ return m_MeshletsCount; }
+
+	public:		// METHODS
+
+		MeshletCuller( const MeshletBounds* _pBounds, int _MeshletsCount );
+		~MeshletCuller();
+
+		// Tests all the meshlets
+		// _pPlanes, _PlanesCount planes (a,b,c,d) in the meshlets' space, a point being inside when a*x+b*y+c*z+d >= 0
+		// _pEyePosition, the eye position in the meshlets' space (NULL to skip the normal cone test)
+		// _pVisible receives 1 for visible meshlets and 0 for culled ones
+		// Returns the amount of visible meshlets
+		int		Cull( const float* _pPlanes, int _PlanesCount, const float* _pEyePosition, unsigned char* _pVisible ) const;
+
+	private:
+		MeshletCuller( const MeshletCuller& );
+		MeshletCuller&	operator=( const MeshletCuller& );
+	};
+}
@@ -0,0 +1,243 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "MeshletSet.h"
+#include "NodeMesh.h"
+
+using namespace	FBXImporter;
+
+MeshletSet::MeshletSet( NodeMesh^ _Owner, cli::array<float>^ _Positions, cli::array<int>^ _Indices, cli::array<int>^ _RangeStarts, List<Object^>^ _Materials, cli::array<int>^ _TriangleIDs, int _MaxVerticesCount, int _MaxTrianglesCount )
+	: m_Owner( _Owner ), m_MaxVerticesCount( _MaxVerticesCount ), m_MaxTrianglesCount( _MaxTrianglesCount ), m_pCuller( NULL )
+{
+	if ( _MaxVerticesCount < 3 || _MaxVerticesCount > MeshletBuilder::MAX_VERTICES || _MaxTrianglesCount < 1 || _MaxTrianglesCount > MeshletBuilder::MAX_TRIANGLES )
+		throw gcnew Exception( "Invalid meshlet limits !" );
+
+	int	TrianglesCount = _Indices->Length / 3;
+	int	VerticesCount = _Positions->Length / 3;
+	int	RangesCount = _RangeStarts->Length - 1;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Build the meshlets into worst-case sized buffers
+	Meshlet*		pMeshlets = new Meshlet[Math::Max( 1, TrianglesCount )];
+	int*			pMeshletVertices = new int[Math::Max( 1, 3 * TrianglesCount )];
+	unsigned char*	pMeshletTriangles = new unsigned char[Math::Max( 1, 3 * TrianglesCount )];
+	int*			pMeshletSourceTriangles = new int[Math::Max( 1, TrianglesCount )];
+	MeshletBounds*	pBounds = NULL;
+	try
+	{
+		int	MeshletsCount = 0;
+		{
+			pin_ptr<int>	pIndices = &_Indices[0];
+			pin_ptr<int>	pRangeStarts = &_RangeStarts[0];
+			MeshletsCount = MeshletBuilder::Build( pIndices, pRangeStarts, RangesCount, VerticesCount, _MaxVerticesCount, _MaxTrianglesCount, pMeshlets, pMeshletVertices, pMeshletTriangles, pMeshletSourceTriangles );
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// 2] Compute the bounds
+		pBounds = new MeshletBounds[Math::Max( 1, MeshletsCount )];
+		{
+			pin_ptr<float>	pPositions = &_Positions[0];
+			for ( int MeshletIndex=0; MeshletIndex < MeshletsCount; MeshletIndex++ )
+				MeshletBuilder::ComputeBounds( pMeshlets[MeshletIndex], pMeshletVertices, pMeshletTriangles, pPositions, pBounds[MeshletIndex] );
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// 3] Copy into trimmed arrays, mapping source triangles back to the owner's triangles
+		int	MeshletVerticesCount = MeshletsCount > 0 ? pMeshlets[MeshletsCount-1].VertexOffset + pMeshlets[MeshletsCount-1].VertexCount : 0;
+		int	MeshletTrianglesCount = MeshletsCount > 0 ? pMeshlets[MeshletsCount-1].TriangleOffset + pMeshlets[MeshletsCount-1].TriangleCount : 0;
+
+		m_Meshlets = gcnew cli::array<int>( 4 * MeshletsCount );
+		m_Materials = gcnew cli::array<Object^>( MeshletsCount );
+		m_Bounds = gcnew cli::array<float>( BOUNDS_STRIDE * MeshletsCount );
+		int	RangeIndex = 0;
+		for ( int MeshletIndex=0; MeshletIndex < MeshletsCount; MeshletIndex++ )
+		{
+			const Meshlet&	M = pMeshlets[MeshletIndex];
+			m_Meshlets[4*MeshletIndex+0] = M.VertexOffset;
+			m_Meshlets[4*MeshletIndex+1] = M.VertexCount;
+			m_Meshlets[4*MeshletIndex+2] = M.TriangleOffset;
+			m_Meshlets[4*MeshletIndex+3] = M.TriangleCount;
+
+			// Meshlets are emitted range by range
+			while ( RangeIndex < RangesCount-1 && pMeshletSourceTriangles[M.TriangleOffset] >= _RangeStarts[RangeIndex+1] )
+				RangeIndex++;
+			m_Materials[MeshletIndex] = _Materials->Count > 0 ? _Materials[RangeIndex] : nullptr;
+
+			const float*	pSource = &pBounds[MeshletIndex].Center[0];
+			for ( int FloatIndex=0; FloatIndex < BOUNDS_STRIDE; FloatIndex++ )
+				m_Bounds[BOUNDS_STRIDE*MeshletIndex+FloatIndex] = pSource[FloatIndex];
+		}
+
+		m_Vertices = gcnew cli::array<int>( MeshletVerticesCount );
+		for ( int VertexIndex=0; VertexIndex < MeshletVerticesCount; VertexIndex++ )
+			m_Vertices[VertexIndex] = pMeshletVertices[VertexIndex];
+
+		m_Triangles = gcnew cli::array<unsigned char>( 3 * MeshletTrianglesCount );
+		m_SourceTriangles = gcnew cli::array<int>( MeshletTrianglesCount );
+		for ( int TriangleIndex=0; TriangleIndex < MeshletTrianglesCount; TriangleIndex++ )
+		{
+			m_Triangles[3*TriangleIndex+0] = pMeshletTriangles[3*TriangleIndex+0];
+			m_Triangles[3*TriangleIndex+1] = pMeshletTriangles[3*TriangleIndex+1];
+			m_Triangles[3*TriangleIndex+2] = pMeshletTriangles[3*TriangleIndex+2];
+			m_SourceTriangles[TriangleIndex] = _TriangleIDs[pMeshletSourceTriangles[TriangleIndex]];
+		}
+	}
+	finally
+	{
+		delete[] pMeshlets;
+		delete[] pMeshletVertices;
+		delete[] pMeshletTriangles;
+		delete[] pMeshletSourceTriangles;
+		delete[] pBounds;
+	}
+}
+
+MeshletSet::~MeshletSet()
+{
+	this->!MeshletSet();
+}
+
+MeshletSet::!MeshletSet()
+{
+	delete m_pCuller;
+	m_pCuller = NULL;
+}
+
+int	MeshletSet::Cull( cli::array<float>^ _Planes, WMath::Point^ _EyePosition, cli::array<bool>^ _Visible )
+{
+	int	MeshletsCount = Count;
+	if ( _Planes == nullptr || (_Planes->Length & 3) != 0 )
+		throw gcnew Exception( "Planes must be given as 4 floats per plane !" );
+	if ( _Visible == nullptr || _Visible->Length < MeshletsCount )
+		throw gcnew Exception( "The visibility array is too small !" );
+	if ( MeshletsCount == 0 )
+		return	0;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Build the SoA culler on first use
+	if ( m_pCuller == NULL )
+	{
+		MeshletBounds*	pBounds = new MeshletBounds[MeshletsCount];
+		try
+		{
+			for ( int MeshletIndex=0; MeshletIndex < MeshletsCount; MeshletIndex++ )
+			{
+				float*	pTarget = &pBounds[MeshletIndex].Center[0];
+				for ( int FloatIndex=0; FloatIndex < BOUNDS_STRIDE; FloatIndex++ )
+					pTarget[FloatIndex] = m_Bounds[BOUNDS_STRIDE*MeshletIndex+FloatIndex];
+			}
+			m_pCuller = new MeshletCuller( pBounds, MeshletsCount );
+		}
+		finally
+		{
+			delete[] pBounds;
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Cull
+	float			pEye[3];
+	if ( _EyePosition != nullptr )
+	{
+		pEye[0] = _EyePosition->x;
+		pEye[1] = _EyePosition->y;
+		pEye[2] = _EyePosition->z;
+	}
+
+	unsigned char*	pVisible = new unsigned char[MeshletsCount];
+	int				VisibleCount = 0;
+	try
+	{
+		{
+			pin_ptr<float>	pPlanes = nullptr;
+			if ( _Planes->Length > 0 )
+				pPlanes = &_Planes[0];
+			VisibleCount = m_pCuller->Cull( pPlanes, _Planes->Length / 4, _EyePosition != nullptr ? pEye : NULL, pVisible );
+		}
+
+		for ( int MeshletIndex=0; MeshletIndex < MeshletsCount; MeshletIndex++ )
+			_Visible[MeshletIndex] = pVisible[MeshletIndex] != 0;
+	}
+	finally
+	{
+		delete[] pVisible;
+	}
+
+	return	VisibleCount;
+}
+
+double	MeshletSet::Benchmark( int _MeshletsCount, int _IterationsCount )
+{
+	if ( _MeshletsCount <= 0 || _IterationsCount <= 0 )
+		throw gcnew Exception( "Invalid benchmark parameters !" );
+
+	const int	TRIANGLES_PER_MESHLET = 124;
+
+	Random^	RNG = gcnew Random( 1 );
+
+	// Random meshlets scattered in a [-100,+100] cube, the frustum being the [-50,+50] cube seen from the origin
+	MeshletBounds*	pBounds = new MeshletBounds[_MeshletsCount];
+	unsigned char*	pVisible = new unsigned char[_MeshletsCount];
+	MeshletCuller*	pCuller = NULL;
+	double			Result = 0.0;
+	try
+	{
+		for ( int MeshletIndex=0; MeshletIndex < _MeshletsCount; MeshletIndex++ )
+		{
+			MeshletBounds&	B = pBounds[MeshletIndex];
+
+			float	Axis[3];
+			float	AxisLength = 0.0f;
+			do
+			{
+				for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+					Axis[ComponentIndex] = (float) (2.0 * RNG->NextDouble() - 1.0);
+				AxisLength = (float) Math::Sqrt( Axis[0]*Axis[0] + Axis[1]*Axis[1] + Axis[2]*Axis[2] );
+			} while ( AxisLength < 1e-3f );
+
+			B.Radius = (float) (1.0 + 2.0 * RNG->NextDouble());
+			B.ConeCutoff = 0.5f;
+			for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+			{
+				B.Center[ComponentIndex] = (float) (200.0 * RNG->NextDouble() - 100.0);
+				B.Min[ComponentIndex] = B.Center[ComponentIndex] - B.Radius;
+				B.Max[ComponentIndex] = B.Center[ComponentIndex] + B.Radius;
+				B.ConeAxis[ComponentIndex] = Axis[ComponentIndex] / AxisLength;
+				B.ConeApex[ComponentIndex] = B.Center[ComponentIndex] - B.Radius * B.ConeAxis[ComponentIndex];
+			}
+		}
+
+		float	pPlanes[6*4] =
+		{
+			 1.0f,  0.0f,  0.0f, 50.0f,
+			-1.0f,  0.0f,  0.0f, 50.0f,
+			 0.0f,  1.0f,  0.0f, 50.0f,
+			 0.0f, -1.0f,  0.0f, 50.0f,
+			 0.0f,  0.0f,  1.0f, 50.0f,
+			 0.0f,  0.0f, -1.0f, 50.0f,
+		};
+		float	pEye[3] = { 0.0f, 0.0f, 0.0f };
+
+		pCuller = new MeshletCuller( pBounds, _MeshletsCount );
+
+		// Warm up then measure
+		pCuller->Cull( pPlanes, 6, pEye, pVisible );
+
+		System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+		for ( int IterationIndex=0; IterationIndex < _IterationsCount; IterationIndex++ )
+			pCuller->Cull( pPlanes, 6, pEye, pVisible );
+		Watch->Stop();
+
+		double	Microseconds = 1000.0 * Watch->Elapsed.TotalMilliseconds;
+		Result = (double) TRIANGLES_PER_MESHLET * _MeshletsCount * _IterationsCount / Math::Max( 1e-3, Microseconds );
+	}
+	finally
+	{
+		delete pCuller;
+		delete[] pBounds;
+		delete[] pVisible;
+	}
+
+	return	Result;
+}
@@ -0,0 +1,145 @@
+// Contains the meshlets a mesh is split into, with their bounds and the CPU culling of these meshlets
+//
+#pragma managed
+#pragma once
+
+#include "MeshletBuilder.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	ref class	NodeMesh;
+
+	//////////////////////////////////////////////////////////////////////////
+	// The meshlets of a mesh
+	// Every array is flat so it can be uploaded as-is into GPU buffers :
+	//	_ Meshlets holds 4 ints per meshlet: vertex offset, vertex count, triangle offset (in triangles) and triangle count
+	//	_ Vertices holds the control point indices referenced by the meshlets
+	//	_ Triangles holds 3 bytes per triangle, indexing the meshlet's vertices
+	//	_ Bounds holds BOUNDS_STRIDE floats per meshlet: sphere center & radius, AABB min & max, cone axis & cutoff, cone apex
+	//
+	// A meshlet never mixes triangles of different materials.
+	// Each meshlet triangle keeps the corner order of the mesh triangle it comes from (cf. SourceTriangles) so layer elements
+	//	can be read with NodeMesh::Triangles indices.
+	//
+	public ref class		MeshletSet
+	{
+	public:		// NESTED TYPES
+
+		literal int		BOUNDS_STRIDE = 17;
+
+		// Offsets of the fields in a meshlet's bounds
+		literal int		BOUNDS_CENTER = 0;
+		literal int		BOUNDS_RADIUS = 3;
+		literal int		BOUNDS_MIN = 4;
+		literal int		BOUNDS_MAX = 7;
+		literal int		BOUNDS_CONE_AXIS = 10;
+		literal int		BOUNDS_CONE_CUTOFF = 13;
+		literal int		BOUNDS_CONE_APEX = 14;
+
+	protected:	// FIELDS
+
+		NodeMesh^					m_Owner;
+		int							m_MaxVerticesCount;
+		int							m_MaxTrianglesCount;
+
+		cli::array<int>^			m_Meshlets;
+		cli::array<Object^>^		m_Materials;
+		cli::array<int>^			m_Vertices;
+		cli::array<unsigned char>^	m_Triangles;
+		cli::array<int>^			m_SourceTriangles;
+		cli::array<float>^			m_Bounds;
+
+		MeshletCuller*				m_pCuller;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the mesh the meshlets were built from" )]
+		//
+		property NodeMesh^					Owner
+		{
+			NodeMesh^					get()	{ return m_Owner; }
+		}
+
+		property int						MaxVerticesCount
+		{
+			int							get()	{ return m_MaxVerticesCount; }
+		}
+
+		property int						MaxTrianglesCount
+		{
+			int							get()	{ return m_MaxTrianglesCount; }
+		}
+
+		property int						Count
+		{
+			int							get()	{ return m_Meshlets->Length / 4; }
+		}
+
+		[DescriptionAttribute( "Gets the meshlets (vertex offset, vertex count, triangle offset, triangle count)" )]
+		//
+		property cli::array<int>^			Meshlets
+		{
+			cli::array<int>^			get()	{ return m_Meshlets; }
+		}
+
+		[DescriptionAttribute( "Gets the material of each meshlet" )]
+		//
+		property cli::array<Object^>^		Materials
+		{
+			cli::array<Object^>^		get()	{ return m_Materials; }
+		}
+
+		[DescriptionAttribute( "Gets the control point indices referenced by the meshlets" )]
+		//
+		property cli::array<int>^			Vertices
+		{
+			cli::array<int>^			get()	{ return m_Vertices; }
+		}
+
+		[DescriptionAttribute( "Gets the meshlet triangles (3 local vertex indices per triangle)" )]
+		//
+		property cli::array<unsigned char>^	Triangles
+		{
+			cli::array<unsigned char>^	get()	{ return m_Triangles; }
+		}
+
+		[DescriptionAttribute( "Gets the index of the mesh triangle each meshlet triangle comes from" )]
+		//
+		property cli::array<int>^			SourceTriangles
+		{
+			cli::array<int>^			get()	{ return m_SourceTriangles; }
+		}
+
+		[DescriptionAttribute( "Gets the bounds of the meshlets (BOUNDS_STRIDE floats per meshlet)" )]
+		//
+		property cli::array<float>^			Bounds
+		{
+			cli::array<float>^			get()	{ return m_Bounds; }
+		}
+
+	public:		// METHODS
+
+		// Builds the meshlets of the given triangles
+		// _Positions, 3 floats per vertex
+		// _Indices, 3 vertex indices per triangle, triangles being grouped by material
+		// _RangeStarts, the start of each material range (plus the end of the last one)
+		// _TriangleIDs, the index in the owner mesh of each given triangle
+		MeshletSet( NodeMesh^ _Owner, cli::array<float>^ _Positions, cli::array<int>^ _Indices, cli::array<int>^ _RangeStarts, List<Object^>^ _Materials, cli::array<int>^ _TriangleIDs, int _MaxVerticesCount, int _MaxTrianglesCount );
+		~MeshletSet();
+		!MeshletSet();
+
+		// Culls the meshlets against planes and back-facing normal cones
+		// _Planes, 4 floats (a,b,c,d) per plane, expressed in mesh space, a point being inside when a*x+b*y+c*z+d >= 0
+		// _EyePosition, the eye position in mesh space (null to skip the normal cones)
+		// _Visible receives the visibility of each meshlet
+		// Returns the amount of visible meshlets
+		int		Cull( cli::array<float>^ _Planes, WMath::Point^ _EyePosition, cli::array<bool>^ _Visible );
+
+		// Measures the amount of triangles culled per microsecond (i.e. triangles whose meshlet was tested) on random meshlets of 124 triangles
+		static double	Benchmark( int _MeshletsCount, int _IterationsCount );
+	};
+}
@@ -4,18 +4,122 @@
 
 #include "NodeMesh.h"
 #include "Scene.h"
+#include "VertexCacheOptimizer.h"
+#include "MeshSimplifier.h"
+#include "TangentSpaceGenerator.h"
+#include "GeometryStreamer.h"
+#include "ContentHasher.h"
+#include "VertexTransform.h"
 
 using namespace	FBXImporter;
 
+namespace FBXImporter
+{
+	// A tangent space generation job processing a range of triangles (first stage) or control points (second stage) on the thread pool
+	ref class	TangentSpaceJob
+	{
+	public:
+
+		TangentSpaceGenerator*	m_pGenerator;
+		bool					m_bVerticesStage;
+
+		void	Execute( int _JobIndex )
+		{
+			int	ElementsCount = m_bVerticesStage ? m_pGenerator->GetVerticesCount() : m_pGenerator->GetTrianglesCount();
+			int	Start = _JobIndex * NodeMesh::TANGENT_SPACE_ELEMENTS_PER_JOB;
+			int	Count = Math::Min( NodeMesh::TANGENT_SPACE_ELEMENTS_PER_JOB, ElementsCount - Start );
+			if ( m_bVerticesStage )
+				m_pGenerator->ComputeVertices( Start, Count );
+			else
+				m_pGenerator->ComputeFaces( Start, Count );
+		}
+
+		void	Run( bool _bVerticesStage )
+		{
+			m_bVerticesStage = _bVerticesStage;
+
+			int	ElementsCount = m_bVerticesStage ? m_pGenerator->GetVerticesCount() : m_pGenerator->GetTrianglesCount();
+			int	JobsCount = (ElementsCount + NodeMesh::TANGENT_SPACE_ELEMENTS_PER_JOB - 1) / NodeMesh::TANGENT_SPACE_ELEMENTS_PER_JOB;
+			if ( JobsCount == 1 )
+				Execute( 0 );
+			else if ( JobsCount > 1 )
+				System::Threading::Tasks::Parallel::For( 0, JobsCount, gcnew Action<int>( this, &TangentSpaceJob::Execute ) );
+		}
+	};
+}
+
 NodeMesh::NodeMesh( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : NodeWithAttribute( _ParentScene, _Parent, _pNode )
 {
 	KFbxMesh*	pMesh = _pNode->GetMesh();
 
 	pMesh->ComputeBBox();				// Compute the bounding box
 
-	m_BBox = gcnew WMath::BoundingBox( Helpers::ToPoint( pMesh->BBoxMin.Get() ), Helpers::ToPoint( pMesh->BBoxMax.Get() ) );
+	// Convert the corners into the target axis system (a negated axis swaps its min & max)
+	WMath::Point^		BBoxMin = Helpers::ToPoint( pMesh->BBoxMin.Get() );
+	WMath::Point^		BBoxMax = Helpers::ToPoint( pMesh->BBoxMax.Get() );
+	cli::array<float>^	Corners = gcnew cli::array<float>( 6 );
+	Corners[0] = BBoxMin->x;	Corners[1] = BBoxMin->y;	Corners[2] = BBoxMin->z;
+	Corners[3] = BBoxMax->x;	Corners[4] = BBoxMax->y;	Corners[5] = BBoxMax->z;
+	_ParentScene->ConvertVectors( Corners, 2 );
+
+	m_BBox = gcnew WMath::BoundingBox(	gcnew WMath::Point( Math::Min( Corners[0], Corners[3] ), Math::Min( Corners[1], Corners[4] ), Math::Min( Corners[2], Corners[5] ) ),
+										gcnew WMath::Point( Math::Max( Corners[0], Corners[3] ), Math::Max( Corners[1], Corners[4] ), Math::Max( Corners[2], Corners[5] ) ) );
 	m_PolygonsCount = pMesh->GetPolygonCount();
 
+	//////////////////////////////////////////////////////////////////////////
+	// Count vertices & triangles without building them
+	m_VerticesCount = pMesh->GetControlPointsCount();
+	m_TrianglesCount = 0;
+	m_PolygonVerticesCount = 0;
+	for ( int PolygonIndex=0; PolygonIndex < m_PolygonsCount; PolygonIndex++ )
+	{
+		int		PolySize = pMesh->GetPolygonSize( PolygonIndex );
+		m_TrianglesCount += Math::Max( 0, PolySize-2 );
+		m_PolygonVerticesCount += PolySize;
+	}
+
+	m_pMesh = pMesh;
+	m_bGeometryExtracted = false;
+	m_bExtractingGeometry = false;
+	m_LastAccess = 0;
+
+	m_Pivot = ComputePivot();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Geometry is extracted by the scene once the hierarchy is complete, or on demand by the streamer if the scene is loaded progressively
+	m_Streamer = _ParentScene->Streamer;
+	if ( m_Streamer != nullptr )
+		m_Streamer->Register( this );
+}
+
+void	NodeMesh::ExtractGeometry()
+{
+	if ( m_bGeometryExtracted )
+		return;
+	if ( m_pMesh == NULL )
+		throw gcnew Exception( "Geometry of mesh \"" + Name + "\" can't be extracted since the SDK scene was destroyed !" );
+
+#ifdef FBXIMPORTER_PROFILING
+	// On-demand extractions happen after the load so they attach the stats of the scene themselves
+	ImportStats::Session	ProfileSession( m_ParentScene->Stats );
+#endif
+	PROFILE_SCOPE_ITEM( "NodeMesh::ExtractGeometry", Name );
+
+	m_bExtractingGeometry = true;
+	try
+	{
+		ReadGeometry();
+		m_bGeometryExtracted = true;
+	}
+	finally
+	{
+		m_bExtractingGeometry = false;
+	}
+}
+
+void	NodeMesh::ReadGeometry()
+{
+	KFbxMesh*	pMesh = m_pMesh;
 
 	//////////////////////////////////////////////////////////////////////////
 	// Build the array of vertices
@@ -33,23 +137,20 @@ NodeMesh::NodeMesh( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : Nod
 		throw gcnew Exception( "List of control points for mesh \"" + Name + "\" is not initialized!" );
 
 	m_Vertices = gcnew cli::array<WMath::Point^>( pMesh->GetControlPointsCount() );
+	PROFILE_COUNT( OBJECTS_ALLOCATED, m_Vertices->Length );
+	PROFILE_COUNT( ELEMENTS_CONVERTED, m_Vertices->Length );
+	PROFILE_COUNT( BYTES_PRODUCED, 3 * sizeof(float) * m_Vertices->Length );
 
-	switch ( m_ParentScene->UpAxis )
-	{
-	case Scene::UP_AXIS::X:
-		throw gcnew Exception( "X as Up Axis is not supported !" );
-		break;
+	// Convert all the control points into the target axis system at once
+	cli::array<float>^	Positions = gcnew cli::array<float>( 3 * m_Vertices->Length + 1 );
+	for ( int VertexIndex=0; VertexIndex < m_Vertices->Length; VertexIndex++ )
+		for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+			Positions[3*VertexIndex+ComponentIndex] = (float) pControlPoints[VertexIndex][ComponentIndex];
 
-	case Scene::UP_AXIS::Y:
-		for ( int VertexIndex=0; VertexIndex < pMesh->GetControlPointsCount(); VertexIndex++ )
-			m_Vertices[VertexIndex] = gcnew WMath::Point( (float) pControlPoints[VertexIndex][0], (float) pControlPoints[VertexIndex][2], -(float) pControlPoints[VertexIndex][1] );
-		break;
+	m_ParentScene->ConvertVectors( Positions, m_Vertices->Length );
 
-	case Scene::UP_AXIS::Z:
-		for ( int VertexIndex=0; VertexIndex < pMesh->GetControlPointsCount(); VertexIndex++ )
-			m_Vertices[VertexIndex] = gcnew WMath::Point( (float) pControlPoints[VertexIndex][0], (float) pControlPoints[VertexIndex][1], (float) pControlPoints[VertexIndex][2] );
-		break;
-	}
+	for ( int VertexIndex=0; VertexIndex < m_Vertices->Length; VertexIndex++ )
+		m_Vertices[VertexIndex] = gcnew WMath::Point( Positions[3*VertexIndex+0], Positions[3*VertexIndex+1], Positions[3*VertexIndex+2] );
 
 
 	//////////////////////////////////////////////////////////////////////////
@@ -57,35 +158,48 @@ NodeMesh::NodeMesh( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : Nod
 	List<Triangle^>^	Triangles = gcnew List<Triangle^>();
 	List<int>^			PolygonVertexOffsets = gcnew List<int>();
 
+	// Reflections (i.e. handedness changes) reverse the winding of the triangles, so we swap their last 2 corners to keep it
+	int	Corner1 = m_ParentScene->GetAxisConversion().FlipsWinding() ? 2 : 1;
+	int	Corner2 = 3 - Corner1;
+
 	int	PolygonVertexOffset = 0;
-	for ( int PolygonIndex=0; PolygonIndex < pMesh->GetPolygonCount(); PolygonIndex++ )
-	{
-		// We convert polygons into triangles assuming they are CONVEX !
-		// (I don't intend to support concave polygon splitting any time soon!)
-		// (If that bothers people, they should simply convert to triangle meshes before exporting)
-		// (sorry but that's how it is)
-		int		PolySize = pMesh->GetPolygonSize( PolygonIndex );
-		for ( int TriangleIndex=0; TriangleIndex < PolySize-2; TriangleIndex++ )
+	{	// Convert polygons into triangles
+		PROFILE_SCOPE( "NodeMesh::Triangulate" );
+		for ( int PolygonIndex=0; PolygonIndex < pMesh->GetPolygonCount(); PolygonIndex++ )
 		{
-			Triangle^	T = gcnew Triangle(	pMesh->GetPolygonVertex( PolygonIndex, 0 ),
-											pMesh->GetPolygonVertex( PolygonIndex, 1 + TriangleIndex ),
-											pMesh->GetPolygonVertex( PolygonIndex, 2 + TriangleIndex ),
+			// We convert polygons into triangles assuming they are CONVEX !
+			// (I don't intend to support concave polygon splitting any time soon!)
+			// (If that bothers people, they should simply convert to triangle meshes before exporting)
+			// (sorry but that's how it is)
+			int		PolySize = pMesh->GetPolygonSize( PolygonIndex );
+			for ( int TriangleIndex=0; TriangleIndex < PolySize-2; TriangleIndex++ )
+			{
+				Triangle^	T = gcnew Triangle(	pMesh->GetPolygonVertex( PolygonIndex, 0 ),
+												pMesh->GetPolygonVertex( PolygonIndex, Corner1 + TriangleIndex ),
+												pMesh->GetPolygonVertex( PolygonIndex, Corner2 + TriangleIndex ),
+
+												// Cumulated polygon indices to address BY_POLYGON_VERTEX mapped infos directly in the layer elements
+												PolygonVertexOffset + 0,
+												PolygonVertexOffset + Corner1 + TriangleIndex,
+												PolygonVertexOffset + Corner2 + TriangleIndex,
 
-											// Cumulated polygon indices to address BY_POLYGON_VERTEX mapped infos directly in the layer elements
-											PolygonVertexOffset + 0,
-											PolygonVertexOffset + 1 + TriangleIndex,
-											PolygonVertexOffset + 2 + TriangleIndex,
+												// Store the polygon index, and the polygon vertex offset (so we can subtract it to the above polygon offsets to retrieve the original polygon vertex index)
+												PolygonIndex,
+												PolygonVertexOffset
+											  );
 
-											// Store the polygon index, and the polygon vertex offset (so we can subtract it to the above polygon offsets to retrieve the original polygon vertex index)
-											PolygonIndex,
-											PolygonVertexOffset
-										  );
+				Triangles->Add( T );
+			}
 
-			Triangles->Add( T );
+			PolygonVertexOffsets->Add( PolygonVertexOffset );
+			PolygonVertexOffset += PolySize;
 		}
 
-		PolygonVertexOffsets->Add( PolygonVertexOffset );
-		PolygonVertexOffset += PolySize;
+		// Triangles store 3 control point indices, 3 polygon vertex indices, the polygon index & offset
+		PROFILE_COUNT( OBJECTS_ALLOCATED, Triangles->Count );
+		PROFILE_COUNT( ELEMENTS_CONVERTED, PolygonVertexOffset );
+		PROFILE_COUNT( BYTES_PRODUCED, 8 * sizeof(int) * Triangles->Count );
+		PROFILE_COUNT( TRIANGLES, Triangles->Count );
 	}
 
 	m_Triangles = Triangles->ToArray();
@@ -103,6 +217,364 @@ NodeMesh::NodeMesh( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : Nod
 	}
 
 
+	//////////////////////////////////////////////////////////////////////////
+	// Read the skin (bones are resolved once the whole hierarchy is built)
+	if ( MeshSkin::HasSkin( pMesh ) )
+		m_Skin = gcnew MeshSkin( this, pMesh, m_ParentScene->Options->SkinInfluencesCount );
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// Read the blend shapes
+	m_BlendShapes = gcnew List<BlendShape^>();
+	m_LODs = gcnew List<MeshLOD^>();
+	for ( int ShapeIndex=0; ShapeIndex < pMesh->GetShapeCount(); ShapeIndex++ )
+		m_BlendShapes->Add( gcnew BlendShape( this, pMesh, ShapeIndex, m_ParentScene->Options->BlendShapeThreshold, m_ParentScene->Options->QuantizeBlendShapes ) );
+}
+
+void	NodeMesh::ReleaseGeometry()
+{
+	m_Vertices = nullptr;
+	m_Triangles = nullptr;
+	m_PolygonVertexOffsets = nullptr;
+	m_Layers = nullptr;
+	m_Skin = nullptr;
+	m_BlendShapes = nullptr;
+	m_LODs = nullptr;
+	m_Meshlets = nullptr;
+	m_VertexBuffer = nullptr;
+	m_bGeometryExtracted = false;
+}
+
+__int64	NodeMesh::EstimateGeometrySize()
+{
+	if ( !m_bGeometryExtracted )
+		return	0;
+
+	// Object header + fields + array slot for each vertex & triangle
+	__int64	Result = 40 * (__int64) m_VerticesCount + 64 * (__int64) m_TrianglesCount + 4 * (__int64) m_PolygonsCount;
+
+	// Layer elements hold about one boxed value per mapped element
+	for each ( Layer^ L in m_Layers )
+		for each ( LayerElement^ Element in L->Elements )
+		{
+			cli::array<Object^>^	Elements = Element->ToArray();
+			if ( Elements != nullptr )
+				Result += 40 * (__int64) Elements->Length;
+		}
+
+	// Skin weights & blend shape deltas
+	if ( m_Skin != nullptr )
+		Result += 6 * m_ParentScene->Options->SkinInfluencesCount * (__int64) m_VerticesCount;
+	for each ( BlendShape^ Shape in m_BlendShapes )
+		Result += Shape->MemorySize;
+
+	if ( m_VertexBuffer != nullptr )
+		Result += m_VertexBuffer->EncodedSize;
+
+	return	Result;
+}
+
+bool	NodeMesh::CanBeInstanced()
+{
+	return	m_Skin == nullptr && m_BlendShapes->Count == 0;
+}
+
+// Converts the values of a layer element into a stream of 32-bit words, each value being prefixed by a tag telling its type
+static cli::array<int>^	GetLayerElementWords( cli::array<Object^>^ _Values, Dictionary<Object^,int>^ _MaterialIDs )
+{
+	if ( _Values == nullptr )
+	{
+		cli::array<int>^	Result = { -1 };
+		return	Result;
+	}
+
+	List<int>^	Words = gcnew List<int>( 5 * _Values->Length + 1 );
+	Words->Add( _Values->Length );
+
+	for ( int ValueIndex=0; ValueIndex < _Values->Length; ValueIndex++ )
+	{
+		Object^	Value = _Values[ValueIndex];
+		if ( Value == nullptr )
+		{
+			Words->Add( 0 );
+			continue;
+		}
+
+		// Floats are stored by bits with -0 collapsed to +0
+		float	pComponents[4];
+		int		ComponentsCount = 0;
+		int		MaterialID = 0;
+
+		Type^	T = Value->GetType();
+		if ( WMath::Point::typeid->IsAssignableFrom( T ) )
+		{
+			WMath::Point^	P = (WMath::Point^) Value;
+			pComponents[0] = P->x; pComponents[1] = P->y; pComponents[2] = P->z; ComponentsCount = 3;
+			Words->Add( 1 );
+		}
+		else if ( WMath::Vector::typeid->IsAssignableFrom( T ) )
+		{
+			WMath::Vector^	V = (WMath::Vector^) Value;
+			pComponents[0] = V->x; pComponents[1] = V->y; pComponents[2] = V->z; ComponentsCount = 3;
+			Words->Add( 2 );
+		}
+		else if ( WMath::Vector2D::typeid->IsAssignableFrom( T ) )
+		{
+			WMath::Vector2D^	V = (WMath::Vector2D^) Value;
+			pComponents[0] = V->x; pComponents[1] = V->y; ComponentsCount = 2;
+			Words->Add( 3 );
+		}
+		else if ( WMath::Vector4D::typeid->IsAssignableFrom( T ) )
+		{
+			WMath::Vector4D^	V = (WMath::Vector4D^) Value;
+			pComponents[0] = V->x; pComponents[1] = V->y; pComponents[2] = V->z; pComponents[3] = V->w; ComponentsCount = 4;
+			Words->Add( 4 );
+		}
+		else if ( bool::typeid->IsAssignableFrom( T ) )
+		{
+			Words->Add( 5 );
+			Words->Add( (bool) Value ? 1 : 0 );
+		}
+		else if ( int::typeid->IsAssignableFrom( T ) )
+		{
+			Words->Add( 6 );
+			Words->Add( (int) Value );
+		}
+		else if ( float::typeid->IsAssignableFrom( T ) )
+		{
+			pComponents[0] = (float) Value; ComponentsCount = 1;
+			Words->Add( 7 );
+		}
+		else if ( _MaterialIDs->TryGetValue( Value, MaterialID ) )
+		{	// Materials are shared scene objects, compare them by identity
+			Words->Add( 8 );
+			Words->Add( MaterialID );
+		}
+		else
+		{	// Strings & anything else are compared by their text
+			String^	Text = Value->ToString();
+			Words->Add( 9 );
+			Words->Add( Text->Length );
+			for ( int CharIndex=0; CharIndex < Text->Length; CharIndex++ )
+				Words->Add( Text[CharIndex] );
+		}
+
+		for ( int ComponentIndex=0; ComponentIndex < ComponentsCount; ComponentIndex++ )
+		{
+			float	Component = pComponents[ComponentIndex] == 0.0f ? 0.0f : pComponents[ComponentIndex];
+			Words->Add( *reinterpret_cast<int*>( &Component ) );
+		}
+	}
+
+	return	Words->ToArray();
+}
+
+static void	AppendLayerElementValues( ContentHasher& _Hasher, cli::array<Object^>^ _Values, Dictionary<Object^,int>^ _MaterialIDs )
+{
+	cli::array<int>^	Words = GetLayerElementWords( _Values, _MaterialIDs );
+	pin_ptr<int>		pWords = &Words[0];
+	_Hasher.Append( pWords, Words->Length * sizeof(int) );
+}
+
+MeshContentHash	NodeMesh::ComputeContentHash( bool _bIgnoreTranslation, Dictionary<Object^,int>^ _MaterialIDs, WMath::Point^% _Reference, float% _Step )
+{
+	ContentHasher	Hasher( CONTENT_HASH_SEED );
+	_Reference = gcnew WMath::Point( 0.0f, 0.0f, 0.0f );
+	_Step = 0.0f;
+
+	int	VerticesCount = m_Vertices->Length;
+	int	TrianglesCount = m_Triangles->Length;
+	Hasher.AppendInt( VerticesCount );
+	Hasher.AppendInt( TrianglesCount );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Hash the positions, either exactly or quantized relative to their minimum
+	if ( VerticesCount > 0 )
+	{
+		cli::array<float>^	Positions = GetPositions();
+		pin_ptr<float>		pPositions = &Positions[0];
+
+		if ( _bIgnoreTranslation )
+		{
+			float	pMin[3] = { pPositions[0], pPositions[1], pPositions[2] };
+			float	pMax[3] = { pPositions[0], pPositions[1], pPositions[2] };
+			for ( int ComponentIndex=3; ComponentIndex < 3*VerticesCount; ComponentIndex++ )
+			{
+				float	Value = pPositions[ComponentIndex];
+				int		Axis = ComponentIndex % 3;
+				pMin[Axis] = Math::Min( pMin[Axis], Value );
+				pMax[Axis] = Math::Max( pMax[Axis], Value );
+			}
+
+			float	Extent = Math::Max( pMax[0] - pMin[0], Math::Max( pMax[1] - pMin[1], pMax[2] - pMin[2] ) );
+			float	Step = ContentHasher::ComputeQuantizationStep( Extent, CONTENT_HASH_POSITION_BITS );
+			Hasher.AppendFloat( Step );
+			Hasher.AppendQuantizedPositions( pPositions, VerticesCount, pMin, Step );
+
+			_Reference = gcnew WMath::Point( pMin[0], pMin[1], pMin[2] );
+			_Step = Step;
+		}
+		else
+			Hasher.AppendFloats( pPositions, 3 * VerticesCount );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Hash the indices
+	if ( TrianglesCount > 0 )
+	{
+		cli::array<int>^	Indices = gcnew cli::array<int>( 3 * TrianglesCount );
+		for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+		{
+			Triangle^	T = m_Triangles[TriangleIndex];
+			Indices[3*TriangleIndex+0] = T->Vertex0;
+			Indices[3*TriangleIndex+1] = T->Vertex1;
+			Indices[3*TriangleIndex+2] = T->Vertex2;
+		}
+
+		pin_ptr<int>	pIndices = &Indices[0];
+		Hasher.Append( pIndices, 3 * TrianglesCount * sizeof(int) );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Hash every layer element
+	Hasher.AppendInt( m_Layers->Count );
+	for each ( Layer^ L in m_Layers )
+	{
+		cli::array<LayerElement^>^	Elements = L->Elements;
+		Hasher.AppendInt( Elements->Length );
+		for each ( LayerElement^ Element in Elements )
+		{
+			Hasher.AppendInt( (int) Element->ElementType );
+			Hasher.AppendInt( (int) Element->MappingType );
+			Hasher.AppendInt( (int) Element->ReferenceType );
+			Hasher.AppendInt( Element->Index );
+			AppendLayerElementValues( Hasher, Element->ToArray(), _MaterialIDs );
+		}
+	}
+
+	Hash128	Result = Hasher.GetHash();
+	return	MeshContentHash( Result.Low, Result.High );
+}
+
+bool	NodeMesh::HasSameContent( NodeMesh^ _Master, WMath::Vector^ _Offset, float _Tolerance, Dictionary<Object^,int>^ _MaterialIDs )
+{
+	int	VerticesCount = m_Vertices->Length;
+	int	TrianglesCount = m_Triangles->Length;
+	if ( _Master->m_Vertices->Length != VerticesCount || _Master->m_Triangles->Length != TrianglesCount || _Master->m_Layers->Count != m_Layers->Count )
+		return	false;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Compare the positions (quantized positions only tell they're within a step of each other)
+	for ( int VertexIndex=0; VertexIndex < VerticesCount; VertexIndex++ )
+	{
+		WMath::Point^	P = m_Vertices[VertexIndex];
+		WMath::Point^	MasterP = _Master->m_Vertices[VertexIndex];
+		if (	Math::Abs( P->x - (MasterP->x + _Offset->x) ) > _Tolerance
+			||	Math::Abs( P->y - (MasterP->y + _Offset->y) ) > _Tolerance
+			||	Math::Abs( P->z - (MasterP->z + _Offset->z) ) > _Tolerance )
+			return	false;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Compare the indices
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+	{
+		Triangle^	T = m_Triangles[TriangleIndex];
+		Triangle^	MasterT = _Master->m_Triangles[TriangleIndex];
+		if ( T->Vertex0 != MasterT->Vertex0 || T->Vertex1 != MasterT->Vertex1 || T->Vertex2 != MasterT->Vertex2 )
+			return	false;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Compare every layer element the same way they're hashed
+	for ( int LayerIndex=0; LayerIndex < m_Layers->Count; LayerIndex++ )
+	{
+		cli::array<LayerElement^>^	Elements = m_Layers[LayerIndex]->Elements;
+		cli::array<LayerElement^>^	MasterElements = _Master->m_Layers[LayerIndex]->Elements;
+		if ( MasterElements->Length != Elements->Length )
+			return	false;
+
+		for ( int ElementIndex=0; ElementIndex < Elements->Length; ElementIndex++ )
+		{
+			LayerElement^	Element = Elements[ElementIndex];
+			LayerElement^	MasterElement = MasterElements[ElementIndex];
+			if (	Element->ElementType != MasterElement->ElementType
+				||	Element->MappingType != MasterElement->MappingType
+				||	Element->ReferenceType != MasterElement->ReferenceType
+				||	Element->Index != MasterElement->Index )
+				return	false;
+
+			cli::array<int>^	Words = GetLayerElementWords( Element->ToArray(), _MaterialIDs );
+			cli::array<int>^	MasterWords = GetLayerElementWords( MasterElement->ToArray(), _MaterialIDs );
+			if ( MasterWords->Length != Words->Length )
+				return	false;
+			for ( int WordIndex=0; WordIndex < Words->Length; WordIndex++ )
+				if ( Words[WordIndex] != MasterWords[WordIndex] )
+					return	false;
+		}
+	}
+
+	return	true;
+}
+
+void	NodeMesh::ShareGeometry( NodeMesh^ _Master, WMath::Vector^ _Offset )
+{
+	m_InstanceOf = _Master;
+
+	// Our vertices are the master's translated by the offset so we transform them by Translation(Offset) * Pivot
+	WMath::Matrix4x4^	Translation = gcnew WMath::Matrix4x4();
+	Translation->MakeIdentity();
+	Translation->SetTrans( gcnew WMath::Point( _Offset->x, _Offset->y, _Offset->z ) );
+	m_Pivot = Translation * m_Pivot;
+	m_BBox = _Master->m_BBox;
+
+	SyncSharedGeometry();
+}
+
+void	NodeMesh::SyncSharedGeometry()
+{
+	if ( m_InstanceOf == nullptr )
+		return;
+
+	m_Vertices = m_InstanceOf->m_Vertices;
+	m_Triangles = m_InstanceOf->m_Triangles;
+	m_PolygonVertexOffsets = m_InstanceOf->m_PolygonVertexOffsets;
+	m_Layers = m_InstanceOf->m_Layers;
+	m_LODs = m_InstanceOf->m_LODs;
+	m_Meshlets = m_InstanceOf->m_Meshlets;
+	m_VertexBuffer = m_InstanceOf->m_VertexBuffer;
+}
+
+NodeMesh::GeometryAccess::GeometryAccess( NodeMesh^ _Mesh ) : m_Mesh( nullptr )
+{
+	if ( _Mesh->m_Streamer == nullptr )
+		return;	// Geometry was extracted at load time and is never released
+
+	System::Threading::Monitor::Enter( _Mesh );
+	try
+	{
+		_Mesh->m_Streamer->Acquire( _Mesh, true );
+	}
+	catch ( Exception^ )
+	{
+		System::Threading::Monitor::Exit( _Mesh );
+		throw;
+	}
+	m_Mesh = _Mesh;
+}
+
+NodeMesh::GeometryAccess::~GeometryAccess()
+{
+	if ( m_Mesh != nullptr )
+		System::Threading::Monitor::Exit( m_Mesh );
+	m_Mesh = nullptr;
+}
+
+WMath::Matrix4x4^	NodeMesh::ComputePivot()
+{
+	KFbxMesh*	pMesh = m_pMesh;
+
+
 	//////////////////////////////////////////////////////////////////////////
 	// Cache pivot
 	//
@@ -131,41 +603,26 @@ NodeMesh::NodeMesh( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : Nod
 	//////////////////////////////////////////////////////////////////////////
 	// Build the pivot matrix
 	//
-	m_Pivot = gcnew WMath::Matrix4x4();
-	m_Pivot->MakeIdentity();
-
-	switch ( m_ParentScene->UpAxis )
-	{
-		case Scene::UP_AXIS::X:
-			throw gcnew Exception( "X as Up Axis is not supported !" );
-			break;
+	WMath::Matrix4x4^	Result = gcnew WMath::Matrix4x4();
+	Result->MakeIdentity();
 
-		case Scene::UP_AXIS::Y:
-		{
-			WMath::Matrix3x3^	RotPYR = gcnew WMath::Matrix3x3();
-								RotPYR->FromEuler( gcnew WMath::Vector( RotXYZ->x, RotXYZ->z, -RotXYZ->y ) );
+	WMath::Matrix3x3^	RotPYR = gcnew WMath::Matrix3x3();
+						RotPYR->FromEuler( RotXYZ );
 
-			m_Pivot->SetRotation( RotPYR );
-			m_Pivot->Scale( gcnew WMath::Vector( Scale->x, Scale->z, Scale->y ) );
-			m_Pivot->SetTrans( gcnew WMath::Point( Trans->x, Trans->z, -Trans->y ) );
-			break;
-		}
+	Result->SetRotation( RotPYR );
+	Result->Scale( Scale );
+	Result->SetTrans( Trans );
 
-		case Scene::UP_AXIS::Z:
-		{
-			WMath::Matrix3x3^	RotPYR = gcnew WMath::Matrix3x3();
-								RotPYR->FromEuler( RotXYZ );
+	// Convert into the target axis system (exact whatever the rotation, unlike converting the Euler angles)
+	m_ParentScene->ConvertTransform( Result );
 
-			m_Pivot->SetRotation( RotPYR );
-			m_Pivot->Scale( Scale );
-			m_Pivot->SetTrans( Trans );
-			break;
-		}
-	}
+	return	Result;
 }
 
 int	NodeMesh::GetControlPointIndex( int _TriangleIndex, int _TriangleVertexIndex )
 {
+	GeometryAccess	Access( this );
+
 	switch ( _TriangleVertexIndex )
 	{
 	case	0:
@@ -179,6 +636,745 @@ int	NodeMesh::GetControlPointIndex( int _TriangleIndex, int _TriangleVertexIndex
 	throw gcnew Exception( "Triangle vertex index out of range !" );
 }
 
+cli::array<Object^>^	NodeMesh::GetTriangleMaterials()
+{
+	if ( m_Layers->Count == 0 )
+		return	nullptr;
+
+	for each ( LayerElement^ Element in m_Layers[0]->Elements )
+	{
+		if ( Element->ElementType != LayerElement::ELEMENT_TYPE::MATERIAL || Element->ToArray() == nullptr )
+			continue;
+
+		cli::array<Object^>^	Result = gcnew cli::array<Object^>( m_Triangles->Length );
+		for ( int TriangleIndex=0; TriangleIndex < m_Triangles->Length; TriangleIndex++ )
+			Result[TriangleIndex] = Element->GetElementByTriangleVertex( TriangleIndex, 0 );
+
+		return	Result;
+	}
+
+	return	nullptr;
+}
+
+WMath::BoundingBox^	NodeMesh::WorldBoundingBox::get()
+{
+	return	m_ParentScene->Transforms->GetWorldBoundingBox( this );
+}
+
+cli::array<float>^	NodeMesh::GetPositions()
+{
+	cli::array<float>^	Result = gcnew cli::array<float>( 3 * m_Vertices->Length );
+	for ( int VertexIndex=0; VertexIndex < m_Vertices->Length; VertexIndex++ )
+	{
+		Result[3*VertexIndex+0] = m_Vertices[VertexIndex]->x;
+		Result[3*VertexIndex+1] = m_Vertices[VertexIndex]->y;
+		Result[3*VertexIndex+2] = m_Vertices[VertexIndex]->z;
+	}
+
+	return	Result;
+}
+
+cli::array<int>^	NodeMesh::GroupTrianglesByMaterial( List<Object^>^ _Materials, cli::array<int>^% _RangeStarts )
+{
+	int	TrianglesCount = m_Triangles->Length;
+
+	cli::array<Object^>^	TriangleMaterials = GetTriangleMaterials();
+	cli::array<int>^		TriangleRanges = gcnew cli::array<int>( TrianglesCount );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+	{
+		Object^	Material = TriangleMaterials != nullptr ? TriangleMaterials[TriangleIndex] : nullptr;
+		int		RangeIndex = _Materials->IndexOf( Material );
+		if ( RangeIndex < 0 )
+		{
+			RangeIndex = _Materials->Count;
+			_Materials->Add( Material );
+		}
+		TriangleRanges[TriangleIndex] = RangeIndex;
+	}
+
+	int	RangesCount = _Materials->Count;
+	_RangeStarts = gcnew cli::array<int>( RangesCount+1 );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+		_RangeStarts[TriangleRanges[TriangleIndex]+1]++;
+	for ( int RangeIndex=0; RangeIndex < RangesCount; RangeIndex++ )
+		_RangeStarts[RangeIndex+1] += _RangeStarts[RangeIndex];
+
+	cli::array<int>^	GroupedOrder = gcnew cli::array<int>( TrianglesCount );
+	cli::array<int>^	RangeCursors = (cli::array<int>^) _RangeStarts->Clone();
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+		GroupedOrder[RangeCursors[TriangleRanges[TriangleIndex]]++] = TriangleIndex;
+
+	return	GroupedOrder;
+}
+
+bool	NodeMesh::GenerateTangentSpace()
+{
+	int	TrianglesCount = m_Triangles->Length;
+	int	VerticesCount = m_Vertices->Length;
+	if ( TrianglesCount == 0 )
+		return	false;
+
+	if ( m_Layers->Count == 0 )
+		m_Layers->Add( gcnew Layer( this ) );
+	Layer^	MainLayer = m_Layers[0];
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Find out what's available in the first layer
+	LayerElement^	NormalElement = nullptr;
+	LayerElement^	TangentElement = nullptr;
+	LayerElement^	BinormalElement = nullptr;
+	LayerElement^	UVElement = nullptr;
+	LayerElement^	SmoothingElement = nullptr;
+	for each ( LayerElement^ Element in MainLayer->Elements )
+	{
+		if ( Element->ToArray() == nullptr )
+			continue;	// BY_EDGE mapping is not supported
+
+		switch ( Element->ElementType )
+		{
+		case LayerElement::ELEMENT_TYPE::NORMAL:
+			if ( NormalElement == nullptr )
+				NormalElement = Element;
+			break;
+		case LayerElement::ELEMENT_TYPE::TANGENT:
+			if ( TangentElement == nullptr )
+				TangentElement = Element;
+			break;
+		case LayerElement::ELEMENT_TYPE::BINORMAL:
+			if ( BinormalElement == nullptr )
+				BinormalElement = Element;
+			break;
+		case LayerElement::ELEMENT_TYPE::UV:
+			if ( UVElement == nullptr || Element->Index == 0 )
+				UVElement = Element;
+			break;
+		case LayerElement::ELEMENT_TYPE::SMOOTHING:
+			if ( SmoothingElement == nullptr )
+				SmoothingElement = Element;
+			break;
+		}
+	}
+
+	bool	bGenerateNormals = NormalElement == nullptr;
+	bool	bGenerateTangents = UVElement != nullptr && (TangentElement == nullptr || BinormalElement == nullptr);
+	if ( !bGenerateNormals && !bGenerateTangents )
+		return	false;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Flatten the inputs
+	cli::array<float>^	Positions = GetPositions();
+	cli::array<int>^	Indices = gcnew cli::array<int>( 3 * TrianglesCount );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+	{
+		Indices[3*TriangleIndex+0] = m_Triangles[TriangleIndex]->Vertex0;
+		Indices[3*TriangleIndex+1] = m_Triangles[TriangleIndex]->Vertex1;
+		Indices[3*TriangleIndex+2] = m_Triangles[TriangleIndex]->Vertex2;
+	}
+
+	cli::array<float>^	UVs = nullptr;
+	if ( bGenerateTangents )
+	{
+		UVs = gcnew cli::array<float>( 6 * TrianglesCount );
+		for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+			for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+			{
+				WMath::Vector2D^	UV = (WMath::Vector2D^) UVElement->GetElementByTriangleVertex( TriangleIndex, CornerIndex );
+				UVs[2*(3*TriangleIndex+CornerIndex)+0] = UV->x;
+				UVs[2*(3*TriangleIndex+CornerIndex)+1] = UV->y;
+			}
+	}
+
+	cli::array<int>^	SmoothingGroups = nullptr;
+	if ( SmoothingElement != nullptr )
+	{
+		SmoothingGroups = gcnew cli::array<int>( TrianglesCount );
+		for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+			SmoothingGroups[TriangleIndex] = (int) SmoothingElement->GetElementByTriangleVertex( TriangleIndex, 0 );
+	}
+
+	cli::array<float>^	SourceNormals = nullptr;
+	if ( !bGenerateNormals )
+	{	// Tangents must be built from the existing normals
+		SourceNormals = gcnew cli::array<float>( 9 * TrianglesCount );
+		for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+			for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+			{
+				WMath::Vector^	Normal = (WMath::Vector^) NormalElement->GetElementByTriangleVertex( TriangleIndex, CornerIndex );
+				SourceNormals[3*(3*TriangleIndex+CornerIndex)+0] = Normal->x;
+				SourceNormals[3*(3*TriangleIndex+CornerIndex)+1] = Normal->y;
+				SourceNormals[3*(3*TriangleIndex+CornerIndex)+2] = Normal->z;
+			}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Generate in parallel chunks
+	cli::array<Object^>^	Normals = gcnew cli::array<Object^>( 3 * TrianglesCount );
+	cli::array<Object^>^	Tangents = bGenerateTangents ? gcnew cli::array<Object^>( 3 * TrianglesCount ) : nullptr;
+	cli::array<Object^>^	Binormals = bGenerateTangents ? gcnew cli::array<Object^>( 3 * TrianglesCount ) : nullptr;
+
+	TangentSpaceGenerator*	pGenerator = NULL;
+	try
+	{
+		pin_ptr<float>	pPositions = &Positions[0];
+		pin_ptr<int>	pIndices = &Indices[0];
+		pin_ptr<float>	pUVs = nullptr;
+		if ( UVs != nullptr )
+			pUVs = &UVs[0];
+		pin_ptr<int>	pSmoothingGroups = nullptr;
+		if ( SmoothingGroups != nullptr )
+			pSmoothingGroups = &SmoothingGroups[0];
+		pin_ptr<float>	pSourceNormals = nullptr;
+		if ( SourceNormals != nullptr )
+			pSourceNormals = &SourceNormals[0];
+
+		pGenerator = new TangentSpaceGenerator( pPositions, VerticesCount, pIndices, TrianglesCount, pUVs, pSmoothingGroups, pSourceNormals );
+
+		TangentSpaceJob^	Job = gcnew TangentSpaceJob();
+		Job->m_pGenerator = pGenerator;
+		Job->Run( false );
+		Job->Run( true );
+
+		const float*	pNormals = pGenerator->GetNormals();
+		const float*	pTangents = pGenerator->GetTangents();
+		const float*	pBinormals = pGenerator->GetBinormals();
+		for ( int CornerIndex=0; CornerIndex < 3*TrianglesCount; CornerIndex++ )
+		{
+			Normals[CornerIndex] = gcnew WMath::Vector( pNormals[3*CornerIndex+0], pNormals[3*CornerIndex+1], pNormals[3*CornerIndex+2] );
+			if ( !bGenerateTangents )
+				continue;
+
+			Tangents[CornerIndex] = gcnew WMath::Vector( pTangents[3*CornerIndex+0], pTangents[3*CornerIndex+1], pTangents[3*CornerIndex+2] );
+			Binormals[CornerIndex] = gcnew WMath::Vector( pBinormals[3*CornerIndex+0], pBinormals[3*CornerIndex+1], pBinormals[3*CornerIndex+2] );
+		}
+	}
+	finally
+	{
+		delete pGenerator;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 4] Emit the missing layer elements
+	if ( bGenerateNormals )
+	{
+		LayerElement^	Element = gcnew LayerElement( "Normal", LayerElement::ELEMENT_TYPE::NORMAL, LayerElement::MAPPING_TYPE::BY_TRIANGLE_VERTEX, 0 );
+		Element->SetArrayOfData( Normals );
+		MainLayer->AddElement( Element );
+	}
+	if ( bGenerateTangents && TangentElement == nullptr )
+	{
+		LayerElement^	Element = gcnew LayerElement( "Tangent", LayerElement::ELEMENT_TYPE::TANGENT, LayerElement::MAPPING_TYPE::BY_TRIANGLE_VERTEX, 0 );
+		Element->SetArrayOfData( Tangents );
+		MainLayer->AddElement( Element );
+	}
+	if ( bGenerateTangents && BinormalElement == nullptr )
+	{
+		LayerElement^	Element = gcnew LayerElement( "BiNormal", LayerElement::ELEMENT_TYPE::BINORMAL, LayerElement::MAPPING_TYPE::BY_TRIANGLE_VERTEX, 0 );
+		Element->SetArrayOfData( Binormals );
+		MainLayer->AddElement( Element );
+	}
+
+	return	true;
+}
+
+VertexCacheReport::MeshEntry^	NodeMesh::OptimizeVertexCache( int _CacheSize )
+{
+	int	TrianglesCount = m_Triangles->Length;
+	int	VerticesCount = m_Vertices->Length;
+
+	VertexCacheReport::MeshEntry^	Entry = gcnew VertexCacheReport::MeshEntry();
+	Entry->MeshName = Name;
+	Entry->TrianglesCount = TrianglesCount;
+	Entry->VerticesCount = VerticesCount;
+	if ( TrianglesCount == 0 )
+		return	Entry;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Group the triangles by material (keeping their relative order) so each material is a contiguous sub-range
+	List<Object^>^		Materials = gcnew List<Object^>();
+	cli::array<int>^	RangeStarts = nullptr;
+	cli::array<int>^	GroupedOrder = GroupTrianglesByMaterial( Materials, RangeStarts );
+	int					RangesCount = Materials->Count;
+
+	Entry->RangesCount = RangesCount;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Optimize the triangle order of each range
+	cli::array<int>^	SourceIndices = gcnew cli::array<int>( 3 * TrianglesCount );
+	cli::array<int>^	GroupedIndices = gcnew cli::array<int>( 3 * TrianglesCount );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+	{
+		Triangle^	T = m_Triangles[TriangleIndex];
+		SourceIndices[3*TriangleIndex+0] = T->Vertex0;
+		SourceIndices[3*TriangleIndex+1] = T->Vertex1;
+		SourceIndices[3*TriangleIndex+2] = T->Vertex2;
+
+		T = m_Triangles[GroupedOrder[TriangleIndex]];
+		GroupedIndices[3*TriangleIndex+0] = T->Vertex0;
+		GroupedIndices[3*TriangleIndex+1] = T->Vertex1;
+		GroupedIndices[3*TriangleIndex+2] = T->Vertex2;
+	}
+
+	cli::array<int>^	RangeOrder = gcnew cli::array<int>( TrianglesCount );
+	{
+		pin_ptr<int>	pSourceIndices = &SourceIndices[0];
+		pin_ptr<int>	pGroupedIndices = &GroupedIndices[0];
+		pin_ptr<int>	pRangeOrder = &RangeOrder[0];
+
+		VertexCacheStatistics	Before = VertexCacheOptimizer::Simulate( pSourceIndices, TrianglesCount, VerticesCount, _CacheSize );
+		Entry->ACMRBefore = Before.GetACMR();
+		Entry->ATVRBefore = Before.GetATVR();
+
+		VertexCacheOptimizer	Optimizer( VerticesCount, _CacheSize );
+		for ( int RangeIndex=0; RangeIndex < RangesCount; RangeIndex++ )
+		{
+			int	RangeStart = RangeStarts[RangeIndex];
+			Optimizer.OptimizeTriangleOrder( pGroupedIndices + 3 * RangeStart, RangeStarts[RangeIndex+1] - RangeStart, pRangeOrder + RangeStart );
+		}
+	}
+
+	// Compose the material grouping & the optimized order of each range
+	cli::array<int>^	TriangleOrder = gcnew cli::array<int>( TrianglesCount );
+	for ( int RangeIndex=0; RangeIndex < RangesCount; RangeIndex++ )
+		for ( int TriangleIndex=RangeStarts[RangeIndex]; TriangleIndex < RangeStarts[RangeIndex+1]; TriangleIndex++ )
+			TriangleOrder[TriangleIndex] = GroupedOrder[RangeStarts[RangeIndex] + RangeOrder[TriangleIndex]];
+
+	cli::array<Triangle^>^	Triangles = gcnew cli::array<Triangle^>( TrianglesCount );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+		Triangles[TriangleIndex] = m_Triangles[TriangleOrder[TriangleIndex]];
+	m_Triangles = Triangles;
+
+	for each ( Layer^ L in m_Layers )
+		for each ( LayerElement^ Element in L->Elements )
+			Element->RemapTriangles( TriangleOrder );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Measure the new order & reorder the control points by first use
+	cli::array<int>^	Indices = gcnew cli::array<int>( 3 * TrianglesCount );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+	{
+		Indices[3*TriangleIndex+0] = m_Triangles[TriangleIndex]->Vertex0;
+		Indices[3*TriangleIndex+1] = m_Triangles[TriangleIndex]->Vertex1;
+		Indices[3*TriangleIndex+2] = m_Triangles[TriangleIndex]->Vertex2;
+	}
+
+	cli::array<int>^	VertexRemap = gcnew cli::array<int>( VerticesCount );
+	{
+		pin_ptr<int>	pIndices = &Indices[0];
+
+		VertexCacheStatistics	After = VertexCacheOptimizer::Simulate( pIndices, TrianglesCount, VerticesCount, _CacheSize );
+		Entry->ACMRAfter = After.GetACMR();
+		Entry->ATVRAfter = After.GetATVR();
+
+		pin_ptr<int>	pVertexRemap = &VertexRemap[0];
+		VertexCacheOptimizer::BuildVertexFetchRemap( pIndices, Indices->Length, VerticesCount, pVertexRemap );
+	}
+
+	// Blend shapes store sorted sparse control point indices so we leave control points untouched for them
+	Entry->VerticesReordered = m_BlendShapes->Count == 0;
+	if ( !Entry->VerticesReordered )
+		return	Entry;
+
+	cli::array<WMath::Point^>^	Vertices = gcnew cli::array<WMath::Point^>( VerticesCount );
+	for ( int VertexIndex=0; VertexIndex < VerticesCount; VertexIndex++ )
+		Vertices[VertexRemap[VertexIndex]] = m_Vertices[VertexIndex];
+	m_Vertices = Vertices;
+
+	for each ( Triangle^ T in m_Triangles )
+	{
+		T->Vertex0 = VertexRemap[T->Vertex0];
+		T->Vertex1 = VertexRemap[T->Vertex1];
+		T->Vertex2 = VertexRemap[T->Vertex2];
+	}
+
+	for each ( Layer^ L in m_Layers )
+		for each ( LayerElement^ Element in L->Elements )
+			Element->RemapControlPoints( VertexRemap );
+
+	if ( m_Skin != nullptr )
+		m_Skin->RemapVertices( VertexRemap );
+
+	return	Entry;
+}
+
+void	NodeMesh::GenerateLODs( int _LevelsCount, float _ReductionRatio, float _MaxError, float _NormalWeight, float _UVWeight )
+{
+	m_LODs->Clear();
+
+	int	TrianglesCount = m_Triangles->Length;
+	int	VerticesCount = m_Vertices->Length;
+	if ( TrianglesCount == 0 )
+		return;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Gather positions, indices & materials
+	cli::array<float>^	Positions = GetPositions();
+
+	cli::array<int>^	Indices = gcnew cli::array<int>( 3 * TrianglesCount );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+	{
+		Indices[3*TriangleIndex+0] = m_Triangles[TriangleIndex]->Vertex0;
+		Indices[3*TriangleIndex+1] = m_Triangles[TriangleIndex]->Vertex1;
+		Indices[3*TriangleIndex+2] = m_Triangles[TriangleIndex]->Vertex2;
+	}
+
+	cli::array<Object^>^	TriangleMaterials = GetTriangleMaterials();
+	cli::array<int>^		MaterialIDs = gcnew cli::array<int>( TrianglesCount );
+	List<Object^>^			Materials = gcnew List<Object^>();
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount && TriangleMaterials != nullptr; TriangleIndex++ )
+	{
+		int	MaterialID = Materials->IndexOf( TriangleMaterials[TriangleIndex] );
+		if ( MaterialID < 0 )
+		{
+			MaterialID = Materials->Count;
+			Materials->Add( TriangleMaterials[TriangleIndex] );
+		}
+		MaterialIDs[TriangleIndex] = MaterialID;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Gather the weighted normals & UVs of each triangle corner from the first layer
+	LayerElement^	NormalElement = nullptr;
+	LayerElement^	UVElement = nullptr;
+	if ( m_Layers->Count > 0 )
+		for each ( LayerElement^ Element in m_Layers[0]->Elements )
+		{
+			if ( Element->ToArray() == nullptr )
+				continue;
+			if ( Element->ElementType == LayerElement::ELEMENT_TYPE::NORMAL && NormalElement == nullptr && _NormalWeight > 0.0f )
+				NormalElement = Element;
+			else if ( Element->ElementType == LayerElement::ELEMENT_TYPE::UV && UVElement == nullptr && _UVWeight > 0.0f )
+				UVElement = Element;
+		}
+
+	int					AttributesCount = (NormalElement != nullptr ? 3 : 0) + (UVElement != nullptr ? 2 : 0);
+	cli::array<float>^	Attributes = gcnew cli::array<float>( Math::Max( 1, 3 * TrianglesCount * AttributesCount ) );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount && AttributesCount > 0; TriangleIndex++ )
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+		{
+			int	AttributeOffset = AttributesCount * (3 * TriangleIndex + CornerIndex);
+			if ( NormalElement != nullptr )
+			{
+				WMath::Vector^	Normal = (WMath::Vector^) NormalElement->GetElementByTriangleVertex( TriangleIndex, CornerIndex );
+				Attributes[AttributeOffset++] = _NormalWeight * Normal->x;
+				Attributes[AttributeOffset++] = _NormalWeight * Normal->y;
+				Attributes[AttributeOffset++] = _NormalWeight * Normal->z;
+			}
+			if ( UVElement != nullptr )
+			{
+				WMath::Vector2D^	UV = (WMath::Vector2D^) UVElement->GetElementByTriangleVertex( TriangleIndex, CornerIndex );
+				Attributes[AttributeOffset++] = _UVWeight * UV->x;
+				Attributes[AttributeOffset++] = _UVWeight * UV->y;
+			}
+		}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Simplify progressively, each LOD starting from the previous one
+	MeshSimplifier*	pSimplifier = NULL;
+	{
+		pin_ptr<float>	pPositions = &Positions[0];
+		pin_ptr<int>	pIndices = &Indices[0];
+		pin_ptr<float>	pAttributes = &Attributes[0];
+		pin_ptr<int>	pMaterialIDs = &MaterialIDs[0];
+
+		pSimplifier = new MeshSimplifier( pPositions, VerticesCount, pIndices, TrianglesCount, pAttributes, AttributesCount, TriangleMaterials != nullptr ? (const int*) pMaterialIDs : NULL );
+	}
+
+	try
+	{
+		int		PreviousTrianglesCount = pSimplifier->GetTrianglesCount();
+		float	TargetTrianglesCount = (float) PreviousTrianglesCount;
+		for ( int Level=1; Level <= _LevelsCount; Level++ )
+		{
+			TargetTrianglesCount *= _ReductionRatio;
+			int	LODTrianglesCount = pSimplifier->Simplify( (int) TargetTrianglesCount, _MaxError );
+			if ( LODTrianglesCount == 0 || LODTrianglesCount >= PreviousTrianglesCount )
+				break;	// Can't simplify any further within the error budget
+
+			cli::array<int>^	LODIndices = gcnew cli::array<int>( 3 * LODTrianglesCount );
+			cli::array<int>^	LODSourceCorners = gcnew cli::array<int>( 3 * LODTrianglesCount );
+			{
+				pin_ptr<int>	pLODIndices = &LODIndices[0];
+				pin_ptr<int>	pLODSourceCorners = &LODSourceCorners[0];
+				pSimplifier->GetResult( pLODIndices, pLODSourceCorners );
+			}
+
+			m_LODs->Add( gcnew MeshLOD( this, Level, pSimplifier->GetError(), pSimplifier->GetError() * pSimplifier->GetScale(), LODIndices, LODSourceCorners ) );
+			PreviousTrianglesCount = LODTrianglesCount;
+		}
+	}
+	finally
+	{
+		delete pSimplifier;
+	}
+}
+
+void	NodeMesh::GenerateMeshlets( int _MaxVerticesCount, int _MaxTrianglesCount )
+{
+	m_Meshlets = nullptr;
+
+	int	TrianglesCount = m_Triangles->Length;
+	if ( TrianglesCount == 0 )
+		return;
+
+	// Group the triangles by material so meshlets never mix materials
+	List<Object^>^		Materials = gcnew List<Object^>();
+	cli::array<int>^	RangeStarts = nullptr;
+	cli::array<int>^	GroupedOrder = GroupTrianglesByMaterial( Materials, RangeStarts );
+
+	cli::array<int>^	GroupedIndices = gcnew cli::array<int>( 3 * TrianglesCount );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+	{
+		Triangle^	T = m_Triangles[GroupedOrder[TriangleIndex]];
+		GroupedIndices[3*TriangleIndex+0] = T->Vertex0;
+		GroupedIndices[3*TriangleIndex+1] = T->Vertex1;
+		GroupedIndices[3*TriangleIndex+2] = T->Vertex2;
+	}
+
+	m_Meshlets = gcnew MeshletSet( this, GetPositions(), GroupedIndices, RangeStarts, Materials, GroupedOrder, _MaxVerticesCount, _MaxTrianglesCount );
+}
+
+VertexBufferReport::MeshEntry^	NodeMesh::EmitVertexBuffer( VertexBufferLayout^ _Layout )
+{
+	m_VertexBuffer = nullptr;
+
+	int	TrianglesCount = m_Triangles->Length;
+	if ( TrianglesCount == 0 )
+		return	nullptr;
+
+	// Group the triangles by material so each material is a single range of indices
+	List<Object^>^		Materials = gcnew List<Object^>();
+	cli::array<int>^	RangeStarts = nullptr;
+	cli::array<int>^	GroupedOrder = GroupTrianglesByMaterial( Materials, RangeStarts );
+
+	cli::array<VertexBufferLayout::Attribute^>^	Attributes = _Layout->Attributes;
+	cli::array<cli::array<float>^>^				Sources = gcnew cli::array<cli::array<float>^>( Attributes->Length );
+	for ( int AttributeIndex=0; AttributeIndex < Attributes->Length; AttributeIndex++ )
+		Sources[AttributeIndex] = GatherCornerValues( Attributes[AttributeIndex]->Semantic, Attributes[AttributeIndex]->SemanticIndex, GroupedOrder, _Layout );
+
+	m_VertexBuffer = gcnew VertexBuffer( this, _Layout, Sources, 3 * TrianglesCount, Materials, RangeStarts );
+
+	VertexBufferReport::MeshEntry^	Entry = gcnew VertexBufferReport::MeshEntry();
+	Entry->MeshName = Name;
+	Entry->CornersCount = 3 * TrianglesCount;
+	Entry->VerticesCount = m_VertexBuffer->VerticesCount;
+	Entry->IndexSize = m_VertexBuffer->IndexSize;
+	Entry->EncodedSize = m_VertexBuffer->EncodedSize;
+	Entry->FloatSize = m_VertexBuffer->FloatSize;
+	Entry->Errors = m_VertexBuffer->Errors;
+
+	return	Entry;
+}
+
+LayerElement^	NodeMesh::FindLayerElement( LayerElement::ELEMENT_TYPE _Type, int _SemanticIndex )
+{
+	for each ( Layer^ L in m_Layers )
+		for each ( LayerElement^ Element in L->Elements )
+			if ( Element->ElementType == _Type && Element->Index == _SemanticIndex && Element->ToArray() != nullptr )
+				return	Element;
+
+	return	nullptr;
+}
+
+cli::array<float>^	NodeMesh::GatherCornerValues( VertexBufferLayout::SEMANTIC _Semantic, int _SemanticIndex, cli::array<int>^ _TriangleOrder, VertexBufferLayout^ _Layout )
+{
+	int					TrianglesCount = _TriangleOrder->Length;
+	int					ComponentsCount = VertexLayout::GetSourceComponentsCount( (VertexLayout::SEMANTIC) _Semantic );
+	cli::array<float>^	Result = gcnew cli::array<float>( ComponentsCount * 3 * TrianglesCount );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Positions come from the control points
+	if ( _Semantic == VertexBufferLayout::SEMANTIC::POSITION )
+	{
+		float	Scale = _Layout->PositionScale;
+		for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+		{
+			Triangle^	T = m_Triangles[_TriangleOrder[TriangleIndex]];
+			for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+			{
+				WMath::Point^	P = m_Vertices[CornerIndex == 0 ? T->Vertex0 : (CornerIndex == 1 ? T->Vertex1 : T->Vertex2)];
+				int				Offset = 3 * (3 * TriangleIndex + CornerIndex);
+				Result[Offset+0] = Scale * P->x;
+				Result[Offset+1] = Scale * P->y;
+				Result[Offset+2] = Scale * P->z;
+			}
+		}
+
+		return	Result;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Other attributes come from the layer elements
+	LayerElement^	Element = nullptr;
+	LayerElement^	BinormalElement = nullptr;
+	LayerElement^	NormalElement = nullptr;
+	switch ( _Semantic )
+	{
+	case VertexBufferLayout::SEMANTIC::NORMAL:		Element = FindLayerElement( LayerElement::ELEMENT_TYPE::NORMAL, _SemanticIndex ); break;
+	case VertexBufferLayout::SEMANTIC::BINORMAL:	Element = FindLayerElement( LayerElement::ELEMENT_TYPE::BINORMAL, _SemanticIndex ); break;
+	case VertexBufferLayout::SEMANTIC::UV:			Element = FindLayerElement( LayerElement::ELEMENT_TYPE::UV, _SemanticIndex ); break;
+	case VertexBufferLayout::SEMANTIC::COLOR:		Element = FindLayerElement( LayerElement::ELEMENT_TYPE::VERTEX_COLOR, _SemanticIndex ); break;
+	case VertexBufferLayout::SEMANTIC::TANGENT:
+		Element = FindLayerElement( LayerElement::ELEMENT_TYPE::TANGENT, _SemanticIndex );
+		NormalElement = FindLayerElement( LayerElement::ELEMENT_TYPE::NORMAL, _SemanticIndex );
+		BinormalElement = FindLayerElement( LayerElement::ELEMENT_TYPE::BINORMAL, _SemanticIndex );
+		break;
+	}
+	if ( Element == nullptr )
+		return	nullptr;
+
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+	{
+		int	SourceTriangleIndex = _TriangleOrder[TriangleIndex];
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+		{
+			int		Offset = ComponentsCount * (3 * TriangleIndex + CornerIndex);
+			Object^	Value = Element->GetElementByTriangleVertex( SourceTriangleIndex, CornerIndex );
+			switch ( _Semantic )
+			{
+			case VertexBufferLayout::SEMANTIC::UV:
+				{
+					WMath::Vector2D^	UV = (WMath::Vector2D^) Value;
+					Result[Offset+0] = UV->x;
+					Result[Offset+1] = _Layout->FlipUVs ? 1.0f - UV->y : UV->y;
+					break;
+				}
+
+			case VertexBufferLayout::SEMANTIC::COLOR:
+				{
+					WMath::Vector4D^	Color = (WMath::Vector4D^) Value;
+					Result[Offset+0] = Color->x;
+					Result[Offset+1] = Color->y;
+					Result[Offset+2] = Color->z;
+					Result[Offset+3] = Color->w;
+					break;
+				}
+
+			case VertexBufferLayout::SEMANTIC::TANGENT:
+				{
+					// The handedness is the side of the binormal relative to N x T (right-handed when there's no binormal to tell)
+					WMath::Vector^	Tangent = (WMath::Vector^) Value;
+					float			Handedness = 1.0f;
+					if ( NormalElement != nullptr && BinormalElement != nullptr )
+					{
+						WMath::Vector^	Normal = (WMath::Vector^) NormalElement->GetElementByTriangleVertex( SourceTriangleIndex, CornerIndex );
+						WMath::Vector^	Binormal = (WMath::Vector^) BinormalElement->GetElementByTriangleVertex( SourceTriangleIndex, CornerIndex );
+						float	CrossX = Normal->y * Tangent->z - Normal->z * Tangent->y;
+						float	CrossY = Normal->z * Tangent->x - Normal->x * Tangent->z;
+						float	CrossZ = Normal->x * Tangent->y - Normal->y * Tangent->x;
+						Handedness = CrossX * Binormal->x + CrossY * Binormal->y + CrossZ * Binormal->z < 0.0f ? -1.0f : 1.0f;
+					}
+					Result[Offset+0] = Tangent->x;
+					Result[Offset+1] = Tangent->y;
+					Result[Offset+2] = Tangent->z;
+					Result[Offset+3] = Handedness;
+					break;
+				}
+
+			default:
+				{
+					WMath::Vector^	V = (WMath::Vector^) Value;
+					Result[Offset+0] = V->x;
+					Result[Offset+1] = V->y;
+					Result[Offset+2] = V->z;
+					break;
+				}
+			}
+		}
+	}
+
+	return	Result;
+}
+
+bool	NodeMesh::CanBeStaticBatched()
+{
+	if ( !CanBeInstanced() )
+		return	false;
+
+	for ( Node^ Current = this; Current != nullptr; Current = Current->Parent )
+		if ( Current->IsPRSAnimated )
+			return	false;
+
+	return	true;
+}
+
+cli::array<StaticBatch::Piece^>^	NodeMesh::EmitStaticBatchPieces( VertexBufferLayout^ _Layout, cli::array<float>^ _GeometryToCell )
+{
+	List<Object^>^		Materials = gcnew List<Object^>();
+	cli::array<int>^	RangeStarts = nullptr;
+	cli::array<int>^	GroupedOrder = GroupTrianglesByMaterial( Materials, RangeStarts );
+
+	float	pMatrix[16];
+	for ( int Index=0; Index < 16; Index++ )
+		pMatrix[Index] = _GeometryToCell[Index];
+	VertexTransform	Transform( pMatrix );
+
+	cli::array<VertexBufferLayout::Attribute^>^	Attributes = _Layout->Attributes;
+	cli::array<StaticBatch::Piece^>^			Result = gcnew cli::array<StaticBatch::Piece^>( Materials->Count );
+	for ( int RangeIndex=0; RangeIndex < Materials->Count; RangeIndex++ )
+	{
+		int					TrianglesCount = RangeStarts[RangeIndex+1] - RangeStarts[RangeIndex];
+		int					CornersCount = 3 * TrianglesCount;
+		cli::array<int>^	RangeOrder = gcnew cli::array<int>( TrianglesCount );
+		cli::array<int>::Copy( GroupedOrder, RangeStarts[RangeIndex], RangeOrder, 0, TrianglesCount );
+
+		//////////////////////////////////////////////////////////////////////////
+		// 1] Transform the positions first as they give the bounds of the piece whether the layout has positions or not
+		cli::array<float>^	Positions = GatherCornerValues( VertexBufferLayout::SEMANTIC::POSITION, 0, RangeOrder, _Layout );
+		float	pMin[3] = { Single::MaxValue, Single::MaxValue, Single::MaxValue };
+		float	pMax[3] = { -Single::MaxValue, -Single::MaxValue, -Single::MaxValue };
+		{
+			pin_ptr<float>	pPositions = &Positions[0];
+			Transform.TransformPositions( pPositions, CornersCount, pMin, pMax );
+			if ( Transform.IsMirrored() )
+				VertexTransform::FlipWinding( pPositions, TrianglesCount, 3 );
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// 2] Transform the other attributes
+		cli::array<cli::array<float>^>^	Sources = gcnew cli::array<cli::array<float>^>( Attributes->Length );
+		for ( int AttributeIndex=0; AttributeIndex < Attributes->Length; AttributeIndex++ )
+		{
+			VertexBufferLayout::SEMANTIC	Semantic = Attributes[AttributeIndex]->Semantic;
+			if ( Semantic == VertexBufferLayout::SEMANTIC::POSITION )
+			{
+				Sources[AttributeIndex] = Positions;
+				continue;
+			}
+
+			cli::array<float>^	Values = GatherCornerValues( Semantic, Attributes[AttributeIndex]->SemanticIndex, RangeOrder, _Layout );
+			Sources[AttributeIndex] = Values;
+			if ( Values == nullptr )
+				continue;
+
+			pin_ptr<float>	pValues = &Values[0];
+			switch ( Semantic )
+			{
+			case VertexBufferLayout::SEMANTIC::NORMAL:		Transform.TransformNormals( pValues, CornersCount ); break;
+			case VertexBufferLayout::SEMANTIC::TANGENT:		Transform.TransformTangents( pValues, CornersCount, 4 ); break;
+			case VertexBufferLayout::SEMANTIC::BINORMAL:	Transform.TransformTangents( pValues, CornersCount, 3 ); break;
+			default:										break;	// UVs & colors don't depend on the transform
+			}
+			if ( Transform.IsMirrored() )
+				VertexTransform::FlipWinding( pValues, TrianglesCount, VertexLayout::GetSourceComponentsCount( (VertexLayout::SEMANTIC) Semantic ) );
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// 3] Encode the piece as a single material range
+		List<Object^>^		PieceMaterials = gcnew List<Object^>();
+		PieceMaterials->Add( Materials[RangeIndex] );
+		cli::array<int>^	PieceRangeStarts = { 0, TrianglesCount };
+
+		StaticBatch::Piece^	P = gcnew StaticBatch::Piece();
+		P->Mesh = this;
+		P->Material = Materials[RangeIndex];
+		P->Buffer = gcnew VertexBuffer( this, _Layout, Sources, CornersCount, PieceMaterials, PieceRangeStarts );
+		P->BoundingBox = gcnew WMath::BoundingBox( pMin[0], pMin[1], pMin[2], pMax[0], pMax[1], pMax[2] );
+		Result[RangeIndex] = P;
+	}
+
+	return	Result;
+}
+
 // int	NodeMesh::GetAbsolutePolygonVertexIndex( int _PolygonIndex, int _PolygonVertexIndex )
 // {
 // 	return	m_PolygonVertexOffsets[_PolygonIndex] + _PolygonVertexIndex;
@@ -5,6 +5,14 @@
 
 #include "Layers.h"
 #include "Nodes.h"
+#include "MeshSkin.h"
+#include "BlendShape.h"
+#include "VertexCacheReport.h"
+#include "MeshLOD.h"
+#include "MeshletSet.h"
+#include "VertexBufferReport.h"
+#include "StaticBatch.h"
+#include "InstancingReport.h"
 
 using namespace System;
 using namespace System::Collections::Generic;
@@ -13,8 +21,12 @@ using namespace System::ComponentModel;
 
 namespace FBXImporter
 {
+	ref class	GeometryStreamer;
+
 	//////////////////////////////////////////////////////////////////////////
 	// A Mesh node
+	// When the scene is loaded progressively, only the bounding box, pivot & counts are read at load time and the geometry
+	//	(vertices, triangles, layers, skin & blend shapes) is extracted on first access or by the scene's GeometryStreamer.
 	//
 	public ref class		NodeMesh : public NodeWithAttribute
 	{
@@ -62,6 +74,25 @@ namespace FBXImporter
 // 			int		GetPolygonVertexIndex2()	{ return PolygonVertex2 - PolygonVertexOffset; }
 		};
 
+		// The amount of triangles or control points processed by a single tangent space generation job
+		literal int		TANGENT_SPACE_ELEMENTS_PER_JOB = 16384;
+
+		// The seed of the content hash & the precision positions are hashed with when translation is ignored (the grid has 2^BITS cells along the largest extent)
+		literal int		CONTENT_HASH_SEED = 0x46425849;
+		literal int		CONTENT_HASH_POSITION_BITS = 20;
+
+		// Keeps the geometry of a progressively loaded mesh extracted & protected from eviction for the duration of its scope (use stack semantics)
+		// Every geometry property uses one internally, hold one yourself to read several properties consistently from another thread
+		ref class	GeometryAccess
+		{
+		protected:
+			NodeMesh^	m_Mesh;		// The locked mesh (null if the mesh is not streamed)
+
+		public:
+			GeometryAccess( NodeMesh^ _Mesh );
+			~GeometryAccess();
+		};
+
 
 	protected:	// FIELDS
 
@@ -77,6 +108,26 @@ namespace FBXImporter
 
 		int							m_PolygonVerticesCount;	// The total amount of polygon vertices
 
+		MeshSkin^					m_Skin;		// The optional skin
+		List<BlendShape^>^			m_BlendShapes;
+		List<MeshLOD^>^				m_LODs;		// The optional simplified levels of detail
+		MeshletSet^					m_Meshlets;	// The optional meshlets
+		VertexBuffer^				m_VertexBuffer;	// The optional GPU-ready buffers
+
+		NodeMesh^					m_InstanceOf;	// The mesh whose geometry we share (null if we own our geometry)
+
+		// Progressive loading
+		KFbxMesh*					m_pMesh;				// The SDK mesh the geometry is extracted from (null once the SDK scene is destroyed)
+		GeometryStreamer^			m_Streamer;				// The streamer extracting our geometry on demand (null if it was extracted at load time)
+		bool						m_bGeometryExtracted;
+		bool						m_bExtractingGeometry;	// True while the geometry is being extracted (sub-objects read it back during construction)
+		int							m_VerticesCount;
+		int							m_TrianglesCount;
+
+	internal:
+
+		int							m_LastAccess;			// Access stamp used by the streamer to find the least recently used geometry
+
 	public:		// PROPERTIES
 
 		property WMath::BoundingBox^		BoundingBox
@@ -84,16 +135,10 @@ namespace FBXImporter
 			WMath::BoundingBox^			get()	{ return m_BBox; }
 		}
 
+		// Gets the world bounding box, cached by the scene's transform hierarchy (must not be modified)
 		property WMath::BoundingBox^		WorldBoundingBox
 		{
-			WMath::BoundingBox^			get()
-			{
-				WMath::Matrix4x4^	Mesh2World = m_Pivot * m_LocalTransform;
-				WMath::BoundingBox^	WorldBBox = WMath::BoundingBox::Empty;
-									WorldBBox->Grow( m_BBox, Mesh2World );
-
-				return WorldBBox;
-			}
+			WMath::BoundingBox^			get();
 		}
 
 		property WMath::Matrix4x4^			Pivot
@@ -103,27 +148,27 @@ namespace FBXImporter
 
 		property cli::array<Triangle^>^		Triangles
 		{
-			cli::array<Triangle^>^		get()	{ return m_Triangles; }
+			cli::array<Triangle^>^		get()	{ GeometryAccess Access( this ); return m_Triangles; }
 		}
 
 		property int						TrianglesCount
 		{
-			int							get()	{ return m_Triangles->Length; }
+			int							get()	{ return m_TrianglesCount; }
 		}
 
 		property cli::array<WMath::Point^>^	Vertices
 		{
-			cli::array<WMath::Point^>^	get()	{ return m_Vertices; }
+			cli::array<WMath::Point^>^	get()	{ GeometryAccess Access( this ); return m_Vertices; }
 		}
 
 		property int						VerticesCount
 		{
-			int							get()	{ return m_Vertices->Length; }
+			int							get()	{ return m_VerticesCount; }
 		}
 
 		property cli::array<Layer^>^		Layers
 		{
-			cli::array<Layer^>^			get()	{ return m_Layers->ToArray(); }
+			cli::array<Layer^>^			get()	{ GeometryAccess Access( this ); return m_Layers->ToArray(); }
 		}
 
 		property int						PolygonsCount
@@ -136,6 +181,56 @@ namespace FBXImporter
 			int							get()	{ return m_PolygonVerticesCount; }
 		}
 
+		[DescriptionAttribute( "Gets the skin deforming the mesh (null if the mesh is not skinned)" )]
+		//
+		property MeshSkin^					Skin
+		{
+			MeshSkin^					get()	{ GeometryAccess Access( this ); return m_Skin; }
+		}
+
+
+		[DescriptionAttribute( "Gets the blend shapes of the mesh" )]
+		//
+		property cli::array<BlendShape^>^	BlendShapes
+		{
+			cli::array<BlendShape^>^	get()	{ GeometryAccess Access( this ); return m_BlendShapes->ToArray(); }
+		}
+
+		[DescriptionAttribute( "Gets the simplified levels of detail of the mesh, from the finest to the coarsest (empty if LODs were not generated)" )]
+		//
+		property cli::array<MeshLOD^>^		LODs
+		{
+			cli::array<MeshLOD^>^		get()	{ GeometryAccess Access( this ); return m_LODs->ToArray(); }
+		}
+
+		[DescriptionAttribute( "Gets the meshlets the mesh is split into (null if meshlets were not generated)" )]
+		//
+		property MeshletSet^				Meshlets
+		{
+			MeshletSet^					get()	{ GeometryAccess Access( this ); return m_Meshlets; }
+		}
+
+		[DescriptionAttribute( "Gets the GPU-ready vertex & index buffers of the mesh (null if vertex buffers were not emitted)" )]
+		//
+		property VertexBuffer^				VertexBuffers
+		{
+			VertexBuffer^				get()	{ GeometryAccess Access( this ); return m_VertexBuffer; }
+		}
+
+		[DescriptionAttribute( "Tells if the geometry of the mesh is currently extracted (always true unless the scene was loaded progressively)" )]
+		//
+		property bool						IsGeometryExtracted
+		{
+			bool						get()	{ return m_bGeometryExtracted; }
+		}
+
+		[DescriptionAttribute( "Gets the mesh whose geometry this mesh shares (null if the mesh is not an instance), the difference in translation being folded into the pivot" )]
+		//
+		property NodeMesh^					InstanceOf
+		{
+			NodeMesh^					get()	{ return m_InstanceOf; }
+		}
+
 
 	public:		// METHODS
 
@@ -146,5 +241,106 @@ namespace FBXImporter
 
 		// Gets the absolute index to a polygon vertex index given the polygon and its internal index
 //		int		GetAbsolutePolygonVertexIndex( int _PolygonIndex, int _PolygonVertexIndex );
+
+	internal:
+
+		// Extracts the geometry from the SDK mesh (the caller is responsible for serializing SDK accesses)
+		void	ExtractGeometry();
+
+		// Releases the extracted geometry so it's extracted again on next access
+		// Arrays & objects previously returned by the properties stay valid but are not updated anymore
+		void	ReleaseGeometry();
+
+		// Forgets about the SDK mesh when the SDK scene gets destroyed
+		void	ReleaseSDKMesh()	{ m_pMesh = NULL; }
+
+		virtual void	ReleaseSDKObject() override
+		{
+			ReleaseSDKMesh();
+			NodeWithAttribute::ReleaseSDKObject();
+		}
+
+		// Tells if the geometry is being extracted by the current extraction
+		bool	IsExtractingGeometry()	{ return m_bExtractingGeometry; }
+
+		// Tells if the geometry can still be extracted from the SDK
+		bool	CanExtractGeometry()	{ return m_pMesh != NULL; }
+
+		// Estimates the managed memory used by the extracted geometry (in bytes)
+		__int64	EstimateGeometrySize();
+
+		// Tells if the mesh can share its geometry with other meshes (skinned & morphed meshes are deformed individually so they can't)
+		bool	CanBeInstanced();
+
+		// Computes the hash of the positions, indices & every layer element of the mesh
+		//	_bIgnoreTranslation, positions are quantized relative to the minimum of their bounding box so meshes only differing by a translation hash the same
+		//	_MaterialIDs, the index of each scene material (materials are hashed by identity)
+		//	_Reference, returns the point positions were made relative to (the origin if translation is not ignored)
+		//	_Step, returns the quantization step of the positions (0 if translation is not ignored)
+		MeshContentHash	ComputeContentHash( bool _bIgnoreTranslation, Dictionary<Object^,int>^ _MaterialIDs, WMath::Point^% _Reference, float% _Step );
+
+		// Tells if the contents of the mesh are the same as the master's, once the master's positions are translated by the offset
+		// A hash match is only a candidate, this comparison decides whether the geometry can really be shared
+		//	_Tolerance, the maximum difference between the components of 2 positions (0 for an exact comparison)
+		bool	HasSameContent( NodeMesh^ _Master, WMath::Vector^ _Offset, float _Tolerance, Dictionary<Object^,int>^ _MaterialIDs );
+
+		// Makes the mesh an instance of a master mesh with the same contents
+		//	_Offset, the translation from the master's vertices to ours (folded into our pivot)
+		void	ShareGeometry( NodeMesh^ _Master, WMath::Vector^ _Offset );
+
+		// Fetches the geometry of our master again once processing stages have replaced it
+		void	SyncSharedGeometry();
+
+		// Generates the normals of the first layer if they're missing, then its tangents & binormals if they're missing and a UV set is available
+		// Normals are angle-weighted & split by smoothing groups, tangents & binormals follow the MikkTSpace conventions
+		// Returns true if any layer element was generated
+		bool	GenerateTangentSpace();
+
+		// Reorders the triangles of each material for the post-transform vertex cache, then reorders the control points in the order they are first used
+		// Every layer element & deformer indexed by triangle or control point is remapped accordingly
+		VertexCacheReport::MeshEntry^	OptimizeVertexCache( int _CacheSize );
+
+		// Builds a chain of LODs by quadric simplification, each LOD having ReductionRatio times the triangles of the previous one
+		// The chain stops early if the next LOD would exceed the maximum error (relative to the mesh size) or if nothing can be simplified anymore
+		void	GenerateLODs( int _LevelsCount, float _ReductionRatio, float _MaxError, float _NormalWeight, float _UVWeight );
+
+		// Splits the triangles of each material into meshlets of at most MaxVertices vertices & MaxTriangles triangles
+		void	GenerateMeshlets( int _MaxVerticesCount, int _MaxTrianglesCount );
+
+		// Emits the final vertex & index buffers in the formats of the layout, triangles being grouped by material
+		// Attributes are read from the first layer element of their type & semantic index, tangents getting the handedness of the binormals
+		// Returns the report entry of the mesh (null if the mesh has no triangle)
+		VertexBufferReport::MeshEntry^	EmitVertexBuffer( VertexBufferLayout^ _Layout );
+
+		// Tells if the mesh never moves nor deforms: it can't be skinned, morphed, PRS animated or have a PRS animated ancestor
+		bool	CanBeStaticBatched();
+
+		// Encodes the triangles of each material in the space of a static batch cell, triangles keeping their facing under mirroring transforms
+		//	_GeometryToCell, the 16 floats of the transform from the mesh's geometry to the cell, its translation being already scaled by the layout's PositionScale
+		cli::array<StaticBatch::Piece^>^	EmitStaticBatchPieces( VertexBufferLayout^ _Layout, cli::array<float>^ _GeometryToCell );
+
+	protected:
+
+		// Reads the vertices, triangles, layers, skin & blend shapes of the SDK mesh
+		void	ReadGeometry();
+
+		// Computes the geometric pivot from the "GeometricXxx" properties
+		WMath::Matrix4x4^		ComputePivot();
+
+		// Gets the material of each triangle from the first layer (null if the mesh has no material element)
+		cli::array<Object^>^	GetTriangleMaterials();
+
+		// Gets the control point positions as a flat array (3 floats per control point)
+		cli::array<float>^		GetPositions();
+
+		// Sorts the triangles by material, keeping their relative order
+		// Returns the sorted triangle indices, the materials in order of first use and the start of each material range (plus the end of the last one)
+		cli::array<int>^		GroupTrianglesByMaterial( List<Object^>^ _Materials, cli::array<int>^% _RangeStarts );
+
+		// Finds the first layer element of the given type & semantic index (null if there is none or if it can't be read by triangle corner)
+		LayerElement^			FindLayerElement( LayerElement::ELEMENT_TYPE _Type, int _SemanticIndex );
+
+		// Gathers the values of an attribute for every corner of the given triangles, as expected by the vertex encoder (null if the mesh has no such attribute)
+		cli::array<float>^		GatherCornerValues( VertexBufferLayout::SEMANTIC _Semantic, int _SemanticIndex, cli::array<int>^ _TriangleOrder, VertexBufferLayout^ _Layout );
 	};
 }
@@ -53,29 +53,14 @@ Node::Node( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : BaseObject(
 
 
 	// ADDITIONAL CODE
+	// Convert into the target axis system (every local transform is converted so the world transforms are converted as well)
+	m_ParentScene->ConvertTransform( m_LocalTransform );
+	m_ParentScene->ConvertTransform( m_PreRotation );
+	m_ParentScene->ConvertTransform( m_PostRotation );
+
 	Scene::UP_AXIS	UpAxis = Scene::UP_AXIS::Y;	// Default is Y-Up (no transform)
 	if ( m_Parent == nullptr || dynamic_cast<NodeRoot^>( m_Parent ) != nullptr )
-		UpAxis = m_ParentScene->UpAxis;			// If root, use scene's Up axis to transform into Y-up
-
-	switch ( UpAxis )
-	{
-	case Scene::UP_AXIS::X:
-		throw gcnew Exception( "X as Up Axis is not supported !" );
-		break;
-
-	case Scene::UP_AXIS::Y:
-//		throw gcnew Exception( "TODO!" );
-		break;
-
-	case Scene::UP_AXIS::Z:
-		{
-// 			WMath::Matrix4x4^	RotX = gcnew WMath::Matrix4x4();
-// 								RotX->MakeRotX( -0.5f * (float) Math::PI );
-// 
-// 			m_LocalTransform *= RotX;
-			break;
-		}
-	}
+		UpAxis = m_ParentScene->TargetUpAxis;	// If root, use the Up axis of the imported data to transform into Y-up
 	// ADDITIONAL CODE
 
 
@@ -96,6 +81,8 @@ Node::Node( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : BaseObject(
 		m_AnimP[0] = ChildTracks[0];
 		m_AnimP[1] = ChildTracks[1];
 		m_AnimP[2] = ChildTracks[2];
+
+		m_ParentScene->ConvertTracks( m_AnimP, false, false );
 	}
 
 	Prop = FindProperty( "Lcl Rotation" );
@@ -114,6 +101,8 @@ Node::Node( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : BaseObject(
 		m_AnimR[0]->ApplyFactor( (float) Math::PI / 180.0f );
 		m_AnimR[1]->ApplyFactor( (float) Math::PI / 180.0f );
 		m_AnimR[2]->ApplyFactor( (float) Math::PI / 180.0f );
+
+		m_ParentScene->ConvertTracks( m_AnimR, true, false );
 	}
 
 	Prop = FindProperty( "Lcl Scaling" );
@@ -128,6 +117,8 @@ Node::Node( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : BaseObject(
 		m_AnimS[0] = ChildTracks[0];
 		m_AnimS[1] = ChildTracks[1];
 		m_AnimS[2] = ChildTracks[2];
+
+		m_ParentScene->ConvertTracks( m_AnimS, false, true );
 	}
 
 	//////////////////////////////////////////////////////////////////////////
@@ -138,7 +129,8 @@ Node::Node( Scene^ _ParentScene, Node^ _Parent, KFbxNode* _pNode ) : BaseObject(
 	switch ( UpAxis )
 	{
 	case Scene::UP_AXIS::X:
-		throw gcnew Exception( "X as Up Axis is not supported !" );
+		// Only when an X-Up file isn't converted
+		m_AnimationSourceMatrix->MakeRotZ( 0.5f * (float) Math::PI );
 		break;
 
 	case Scene::UP_AXIS::Y:
@@ -287,6 +279,22 @@ float		Node::AnimationDuration::get()
 	return m_ParentScene->CurrentTake != nullptr ? m_ParentScene->CurrentTake->Duration : 0.0f;
 }
 
+WMath::Matrix4x4^	Node::WorldTransform::get()
+{
+	return	m_ParentScene->Transforms->GetWorldTransform( this );
+}
+
+void	Node::ReleaseSDKObject()
+{
+	cli::array<cli::array<AnimationTrack^>^>^	PRSTracks = { m_AnimP, m_AnimR, m_AnimS };
+	for each ( cli::array<AnimationTrack^>^ Tracks in PRSTracks )
+		if ( Tracks != nullptr )
+			for ( int TrackIndex=0; TrackIndex < Tracks->Length; TrackIndex++ )
+				Tracks[TrackIndex]->ReleaseSDKCurve();
+
+	BaseObject::ReleaseSDKObject();
+}
+
 Material^	Node::ResolveMaterial( KFbxSurfaceMaterial* _pMaterial )
 {
 	return	m_ParentScene->ResolveMaterial( _pMaterial );
@@ -295,4 +303,28 @@ Material^	Node::ResolveMaterial( KFbxSurfaceMaterial* _pMaterial )
 Take^		Node::GetCurrentTake()
 {
 	return m_ParentScene->CurrentTake;
-}
\ No newline at end of file
+}
+
+WMath::Vector^	NodeCamera::UpVector::get()
+{
+	if ( m_pCamera == NULL )
+		return	m_UpVector;
+
+	WMath::Vector^		SourceUpVector = Helpers::ToVector( m_pCamera->UpVector.Get() );
+	cli::array<float>^	Vector = { SourceUpVector->x, SourceUpVector->y, SourceUpVector->z };
+	m_ParentScene->ConvertVectors( Vector, 1 );
+
+	return	gcnew WMath::Vector( Vector[0], Vector[1], Vector[2] );
+}
+
+WMath::Point^	NodeCamera::Target::get()
+{
+	if ( m_pCamera == NULL )
+		return	m_Target;
+
+	WMath::Point^		SourceTarget = Helpers::ToPoint( m_pCamera->InterestPosition.Get() );
+	cli::array<float>^	Point = { SourceTarget->x, SourceTarget->y, SourceTarget->z };
+	m_ParentScene->ConvertVectors( Point, 1 );
+
+	return	gcnew WMath::Point( Point[0], Point[1], Point[2] );
+}
@@ -88,6 +88,13 @@ namespace FBXImporter
 			WMath::Matrix4x4^	get()	{ return m_LocalTransform; }
 		}
 
+		[DescriptionAttribute( "Gets the world transform of the node, cached by the scene's transform hierarchy (must not be modified)" )]
+		//
+		property WMath::Matrix4x4^	WorldTransform
+		{
+			WMath::Matrix4x4^	get();
+		}
+
 		[DescriptionAttribute( "Tells if the node has PRS animation" )]
 		//
 		property bool				IsPRSAnimated
@@ -148,6 +155,10 @@ namespace FBXImporter
 		// Gets the default scene's take name
 		[BrowsableAttribute( false )]
 		Take^		GetCurrentTake();
+
+	internal:
+
+		virtual void	ReleaseSDKObject() override;
 	};
 
 	//////////////////////////////////////////////////////////////////////////
@@ -183,7 +194,8 @@ namespace FBXImporter
 	{
 	protected:	// FIELDS
 
-		KFbxNodeAttribute*	m_pAttribute;
+		KFbxNodeAttribute*	m_pAttribute;	// NULL once the SDK scene is destroyed
+		WMath::Vector^		m_Color;		// Snapshot of the attribute's color once released
 
 		List<Material^>^	m_Materials;
 
@@ -193,7 +205,7 @@ namespace FBXImporter
 		//
 		property WMath::Vector^	Color
 		{
-			WMath::Vector^			get()	{ return Helpers::ToVector( m_pAttribute->Color.Get() ); }
+			WMath::Vector^			get()	{ return m_pAttribute != NULL ? Helpers::ToVector( m_pAttribute->Color.Get() ) : m_Color; }
 		}
 
 		[DescriptionAttribute( "Gets the list of materials associated to that node" )]
@@ -223,6 +235,15 @@ namespace FBXImporter
 		{
 			return	m_Materials[_MaterialIndex];
 		}
+
+	internal:
+
+		virtual void	ReleaseSDKObject() override
+		{
+			m_Color = Color;
+			m_pAttribute = NULL;
+			Node::ReleaseSDKObject();
+		}
 	};
 
 
@@ -249,7 +270,24 @@ namespace FBXImporter
 
 	protected:	// FIELDS
 
-		KFbxLight*	m_pLight;	// The node attribute cast to a light
+		KFbxLight*	m_pLight;	// The node attribute cast to a light (NULL once the SDK scene is destroyed)
+
+		// Snapshot of the light's values once released
+		LIGHT_TYPE		m_LightType;
+		WMath::Vector^	m_LightColor;
+		float			m_Intensity;
+		float			m_HotSpot;
+		float			m_ConeAngle;
+		DECAY_TYPE		m_DecayType;
+		float			m_DecayStart;
+		bool			m_bCastShadows;
+		float			m_Fog;
+		bool			m_bEnableNearAttenuation;
+		float			m_NearAttenuationStart;
+		float			m_NearAttenuationEnd;
+		bool			m_bEnableFarAttenuation;
+		float			m_FarAttenuationStart;
+		float			m_FarAttenuationEnd;
 
 	public:		// PROPERTIES
 
@@ -257,6 +295,9 @@ namespace FBXImporter
 		{
 			LIGHT_TYPE	get()
 			{
+				if ( m_pLight == NULL )
+					return	m_LightType;
+
 				switch ( m_pLight->LightType.Get() )
 				{
 				case KFbxLight::ePOINT:
@@ -277,28 +318,28 @@ namespace FBXImporter
 		//
 		property WMath::Vector^	Color
 		{
-			WMath::Vector^	get()	{ return Helpers::ToVector( m_pLight->Color.Get() ); }
+			WMath::Vector^	get()	{ return m_pLight != NULL ? Helpers::ToVector( m_pLight->Color.Get() ) : m_LightColor; }
 		}
 
 		[DescriptionAttribute( "Gets the light intensity" )]
 		//
 		property float			Intensity
 		{
-			float			get()	{ return (float) m_pLight->Intensity.Get() * 0.01f; }
+			float			get()	{ return m_pLight != NULL ? (float) m_pLight->Intensity.Get() * 0.01f : m_Intensity; }
 		}
 
 		[DescriptionAttribute( "Gets the Hotspot angle in radians" )]
 		// 
 		property float			HotSpot
 		{
-			float			get()	{ return (float) (Math::PI * m_pLight->HotSpot.Get() / 180.0f); }
+			float			get()	{ return m_pLight != NULL ? (float) (Math::PI * m_pLight->HotSpot.Get() / 180.0f) : m_HotSpot; }
 		}
 
 		[DescriptionAttribute( "Gets the Cone angle in radians" )]
 		// 
 		property float			ConeAngle
 		{
-			float			get()	{ return (float) (Math::PI * m_pLight->ConeAngle.Get() / 180.0f); }
+			float			get()	{ return m_pLight != NULL ? (float) (Math::PI * m_pLight->ConeAngle.Get() / 180.0f) : m_ConeAngle; }
 		}
 
 		[DescriptionAttribute( "Gets the decay type (e.g. linear, quadratic, cubic)" )]
@@ -307,6 +348,9 @@ namespace FBXImporter
 		{
 			DECAY_TYPE	get()
 			{
+				if ( m_pLight == NULL )
+					return	m_DecayType;
+
 				switch ( m_pLight->DecayType.Get() )
 				{
 				case	KFbxLight::eLINEAR:
@@ -327,63 +371,63 @@ namespace FBXImporter
 		// 
 		property float			DecayStart
 		{
-			float	get()	{ return (float) m_pLight->DecayStart.Get(); }
+			float	get()	{ return m_pLight != NULL ? (float) m_pLight->DecayStart.Get() : m_DecayStart; }
 		}
 
 		[DescriptionAttribute( "Tells if the light casts shadows" )]
 		// 
 		property bool			CastShadows
 		{
-			bool	get()	{ return m_pLight->CastShadows.Get(); }
+			bool	get()	{ return m_pLight != NULL ? m_pLight->CastShadows.Get() : m_bCastShadows; }
 		}
 
 		[DescriptionAttribute( "Gets the fog value" )]
 		// 
 		property float			Fog
 		{
-			float			get()	{ return (float) m_pLight->Fog.Get(); }
+			float			get()	{ return m_pLight != NULL ? (float) m_pLight->Fog.Get() : m_Fog; }
 		}
 
 		[DescriptionAttribute( "Tells if the light has near attenuation" )]
 		// 
 		property bool			EnableNearAttenuation
 		{
-			bool	get()	{ return m_pLight->EnableNearAttenuation.Get(); }
+			bool	get()	{ return m_pLight != NULL ? m_pLight->EnableNearAttenuation.Get() : m_bEnableNearAttenuation; }
 		}
 
 		[DescriptionAttribute( "Gets the near attenuation start" )]
 		// 
 		property float			NearAttenuationStart
 		{
-			float			get()	{ return (float) m_pLight->NearAttenuationStart.Get(); }
+			float			get()	{ return m_pLight != NULL ? (float) m_pLight->NearAttenuationStart.Get() : m_NearAttenuationStart; }
 		}
 
 		[DescriptionAttribute( "Gets the near attenuation end" )]
 		// 
 		property float			NearAttenuationEnd
 		{
-			float			get()	{ return (float) m_pLight->NearAttenuationEnd.Get(); }
+			float			get()	{ return m_pLight != NULL ? (float) m_pLight->NearAttenuationEnd.Get() : m_NearAttenuationEnd; }
 		}
 
 		[DescriptionAttribute( "Tells if the light has far attenuation" )]
 		// 
 		property bool			EnableFarAttenuation
 		{
-			bool	get()	{ return m_pLight->EnableFarAttenuation.Get(); }
+			bool	get()	{ return m_pLight != NULL ? m_pLight->EnableFarAttenuation.Get() : m_bEnableFarAttenuation; }
 		}
 
 		[DescriptionAttribute( "Gets the far attenuation start" )]
 		// 
 		property float			FarAttenuationStart
 		{
-			float			get()	{ return (float) m_pLight->FarAttenuationStart.Get(); }
+			float			get()	{ return m_pLight != NULL ? (float) m_pLight->FarAttenuationStart.Get() : m_FarAttenuationStart; }
 		}
 
 		[DescriptionAttribute( "Gets the far attenuation end" )]
 		// 
 		property float			FarAttenuationEnd
 		{
-			float			get()	{ return (float) m_pLight->FarAttenuationEnd.Get(); }
+			float			get()	{ return m_pLight != NULL ? (float) m_pLight->FarAttenuationEnd.Get() : m_FarAttenuationEnd; }
 		}
 
 
@@ -393,6 +437,29 @@ namespace FBXImporter
 		{
 			m_pLight = _pNode->GetLight();
 		}
+
+	internal:
+
+		virtual void	ReleaseSDKObject() override
+		{
+			m_LightType = LightType;
+			m_LightColor = Color;
+			m_Intensity = Intensity;
+			m_HotSpot = HotSpot;
+			m_ConeAngle = ConeAngle;
+			m_DecayType = DecayType;
+			m_DecayStart = DecayStart;
+			m_bCastShadows = CastShadows;
+			m_Fog = Fog;
+			m_bEnableNearAttenuation = EnableNearAttenuation;
+			m_NearAttenuationStart = NearAttenuationStart;
+			m_NearAttenuationEnd = NearAttenuationEnd;
+			m_bEnableFarAttenuation = EnableFarAttenuation;
+			m_FarAttenuationStart = FarAttenuationStart;
+			m_FarAttenuationEnd = FarAttenuationEnd;
+			m_pLight = NULL;
+			NodeWithAttribute::ReleaseSDKObject();
+		}
 	};
 
 	//////////////////////////////////////////////////////////////////////////
@@ -410,7 +477,18 @@ namespace FBXImporter
 
 	protected:	// FIELDS
 
-		KFbxCamera*	m_pCamera;	// The node attribute cast to a camera
+		KFbxCamera*	m_pCamera;	// The node attribute cast to a camera (NULL once the SDK scene is destroyed)
+
+		// Snapshot of the camera's values once released
+		PROJECTION_TYPE	m_ProjectionType;
+		WMath::Vector^	m_UpVector;
+		WMath::Point^	m_Target;
+		float			m_FOVX;
+		float			m_FOVY;
+		float			m_FocalLength;
+		float			m_Roll;
+		float			m_NearClipPlane;
+		float			m_FarClipPlane;
 
 	public:		// PROPERTIES
 
@@ -420,65 +498,68 @@ namespace FBXImporter
 		{
 			PROJECTION_TYPE	get()
 			{
+				if ( m_pCamera == NULL )
+					return	m_ProjectionType;
+
 				KFbxCamera::ECameraProjectionType	ProjType = m_pCamera->ProjectionType.Get();
 				return	ProjType == KFbxCamera::ePERSPECTIVE ? PROJECTION_TYPE::PERSPECTIVE : PROJECTION_TYPE::ORTHOGRAPHIC;
 			}
 		}
 
-		[DescriptionAttribute( "Gets the camera up vector" )]
+		[DescriptionAttribute( "Gets the camera up vector (in the target axis system)" )]
 		// 
 		property WMath::Vector^		UpVector
 		{
-			WMath::Vector^	get()	{ return Helpers::ToVector( m_pCamera->UpVector.Get() ); }
+			WMath::Vector^	get();
 		}
 
-		[DescriptionAttribute( "Gets the target position" )]
+		[DescriptionAttribute( "Gets the target position (in the target axis system)" )]
 		// 
 		property WMath::Point^		Target
 		{
-			WMath::Point^	get()	{ return Helpers::ToPoint( m_pCamera->InterestPosition.Get() ); }
+			WMath::Point^	get();
 		}
 
 		[DescriptionAttribute( "Gets the horizontal field of view in radians" )]
 		// 
 		property float				FOVX
 		{
-			float			get()	{ return (float) (Math::PI * m_pCamera->FieldOfViewX.Get() / 180.0f); }
+			float			get()	{ return m_pCamera != NULL ? (float) (Math::PI * m_pCamera->FieldOfViewX.Get() / 180.0f) : m_FOVX; }
 		}
 
 		[DescriptionAttribute( "Gets the vertical field of view in radians" )]
 		// 
 		property float				FOVY
 		{
-			float			get()	{ return (float) (Math::PI * m_pCamera->FieldOfViewX.Get() / 180.0f); }
+			float			get()	{ return m_pCamera != NULL ? (float) (Math::PI * m_pCamera->FieldOfViewX.Get() / 180.0f) : m_FOVY; }
 		}
 
 		[DescriptionAttribute( "Gets the focal length" )]
 		// 
 		property float				FocalLength
 		{
-			float			get()	{ return (float) m_pCamera->FocalLength.Get(); }
+			float			get()	{ return m_pCamera != NULL ? (float) m_pCamera->FocalLength.Get() : m_FocalLength; }
 		}
 
 		[DescriptionAttribute( "Gets the camera roll in radians" )]
 		// 
 		property float				Roll
 		{
-			float			get()	{ return (float) (Math::PI * m_pCamera->Roll.Get() / 180.0f); }
+			float			get()	{ return m_pCamera != NULL ? (float) (Math::PI * m_pCamera->Roll.Get() / 180.0f) : m_Roll; }
 		}
 
 		[DescriptionAttribute( "Gets the near clip distance" )]
 		// 
 		property float				NearClipPlane
 		{
-			float			get()	{ return (float) m_pCamera->NearPlane.Get(); }
+			float			get()	{ return m_pCamera != NULL ? (float) m_pCamera->NearPlane.Get() : m_NearClipPlane; }
 		}
 
 		[DescriptionAttribute( "Gets the far clip distance" )]
 		// 
 		property float				FarClipPlane
 		{
-			float			get()	{ return (float) m_pCamera->FarPlane.Get(); }
+			float			get()	{ return m_pCamera != NULL ? (float) m_pCamera->FarPlane.Get() : m_FarClipPlane; }
 		}
 
 
@@ -488,5 +569,22 @@ namespace FBXImporter
 		{
 			m_pCamera = _pNode->GetCamera();
 		}
+
+	internal:
+
+		virtual void	ReleaseSDKObject() override
+		{
+			m_ProjectionType = ProjectionType;
+			m_UpVector = UpVector;
+			m_Target = Target;
+			m_FOVX = FOVX;
+			m_FOVY = FOVY;
+			m_FocalLength = FocalLength;
+			m_Roll = Roll;
+			m_NearClipPlane = NearClipPlane;
+			m_FarClipPlane = FarClipPlane;
+			m_pCamera = NULL;
+			NodeWithAttribute::ReleaseSDKObject();
+		}
 	};
 }
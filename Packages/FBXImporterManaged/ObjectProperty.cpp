@@ -86,9 +86,16 @@ ObjectProperty::ObjectProperty( BaseObject^ _Owner, KFbxProperty& _Property ) :
 	if ( OwnerNode == nullptr || OwnerNode->GetCurrentTake() == nullptr )
 		return;	// Anim tracks are only supported on node objects
 
-	// TODO !
-// 	const char*		pCurrentTakeName = Helpers::FromString( OwnerNode->GetCurrentTake()->Name );
-// 	KFCurveNode*	pCurveNode = _Property.GetKFCurveNode( false, pCurrentTakeName );
-// 	if ( pCurveNode != NULL )
-// 		m_AnimTrack = gcnew AnimationTrack( nullptr, this, OwnerNode, pCurveNode, _Property.GetPropertyDataType().GetType() );	// Create the single anim track
+	// The take name isn't marshalled through the current MarshalArena since properties are also materialized lazily, after LoadFile() returned
+	IntPtr	pCurrentTakeName = System::Runtime::InteropServices::Marshal::StringToHGlobalAnsi( OwnerNode->GetCurrentTake()->Name );
+	try
+	{
+		KFCurveNode*	pCurveNode = _Property.GetKFCurveNode( false, (const char*) pCurrentTakeName.ToPointer() );
+		if ( pCurveNode != NULL )
+			m_AnimTrack = gcnew AnimationTrack( nullptr, this, OwnerNode, pCurveNode, _Property.GetPropertyDataType().GetType() );	// Create the single anim track
+	}
+	finally
+	{
+		System::Runtime::InteropServices::Marshal::FreeHGlobal( pCurrentTakeName );
+	}
 }
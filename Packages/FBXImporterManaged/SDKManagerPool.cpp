@@ -0,0 +1,125 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "SDKManagerPool.h"
+
+using namespace	FBXImporter;
+using namespace	System::Threading;
+
+int	SDKManagerPool::ManagersCount::get()
+{
+	Monitor::Enter( ms_Lock );
+	try
+	{
+		return ms_IdleManagers->Count + ms_LeasedCount;
+	}
+	finally
+	{
+		Monitor::Exit( ms_Lock );
+	}
+}
+
+void	SDKManagerPool::Trim()
+{
+	Monitor::Enter( ms_Lock );
+	try
+	{
+		// Delete the FBX SDK managers. All the objects that have been allocated
+		// using the FBX SDK manager and that haven't been explicitly destroyed
+		// are automatically destroyed at the same time.
+		while ( ms_IdleManagers->Count > 0 )
+		{
+			KFbxSdkManager*	pManager = (KFbxSdkManager*) ms_IdleManagers->Pop().ToPointer();
+			pManager->Destroy();
+		}
+	}
+	finally
+	{
+		Monitor::Exit( ms_Lock );
+	}
+}
+
+void	SDKManagerPool::AddReference()
+{
+	Monitor::Enter( ms_Lock );
+	ms_ReferencesCount++;
+	Monitor::Exit( ms_Lock );
+}
+
+void	SDKManagerPool::RemoveReference()
+{
+	Monitor::Enter( ms_Lock );
+	try
+	{
+		if ( ms_ReferencesCount == 0 )
+			throw gcnew Exception( "SDK manager pool references are unbalanced !" );
+
+		if ( --ms_ReferencesCount == 0 )
+			Trim();		// Monitors are reentrant
+	}
+	finally
+	{
+		Monitor::Exit( ms_Lock );
+	}
+}
+
+KFbxSdkManager*	SDKManagerPool::Lease()
+{
+	Monitor::Enter( ms_Lock );
+	try
+	{
+		KFbxSdkManager*	pManager = ms_IdleManagers->Count > 0 ? (KFbxSdkManager*) ms_IdleManagers->Pop().ToPointer() : NULL;
+		if ( pManager == NULL )
+		{
+			// Plugins are loaded from disk so this is the slow path, but creating managers concurrently is not safe
+			pManager = CreateManager();
+			ms_CreatedCount++;
+		}
+		ms_LeasedCount++;
+
+		return pManager;
+	}
+	finally
+	{
+		Monitor::Exit( ms_Lock );
+	}
+}
+
+void	SDKManagerPool::Return( KFbxSdkManager* _pManager )
+{
+	if ( _pManager == NULL )
+		return;
+
+	Monitor::Enter( ms_Lock );
+	try
+	{
+		ms_LeasedCount--;
+		if ( ms_ReferencesCount > 0 )
+			ms_IdleManagers->Push( IntPtr( _pManager ) );
+		else
+			_pManager->Destroy();	// Nobody's left to lease it again
+	}
+	finally
+	{
+		Monitor::Exit( ms_Lock );
+	}
+}
+
+KFbxSdkManager*	SDKManagerPool::CreateManager()
+{
+	KFbxSdkManager*	pManager = KFbxSdkManager::Create();
+	if ( !pManager )
+		throw gcnew Exception( "Unable to create the FBX SDK manager!" );
+
+	// Create an IOSettings object
+	KFbxIOSettings*	pIOSettings = KFbxIOSettings::Create( pManager, IOSROOT );
+	pManager->SetIOSettings( pIOSettings );
+
+	// Load plugins from the executable directory
+	KString lPath = KFbxGetApplicationDirectory();
+	KString lExtension = "dll";
+	pManager->LoadPluginsDirectory( lPath.Buffer(), lExtension.Buffer() );
+
+	return pManager;
+}
@@ -0,0 +1,83 @@
+// Contains the process-wide pool of FBX SDK managers leased to the scenes being loaded
+//
+#pragma managed
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A process-wide pool of FBX SDK managers
+	// Creating a manager and loading the reader plugins is expensive so managers are created once and leased to the scenes for the lifetime of their SDK scene.
+	// The SDK is not thread-safe so a manager is leased to a single scene at a time: concurrent loads each get their own manager
+	//	and the pool grows up to the largest amount of concurrent loads.
+	//
+	// The pool is reference-counted by the living scenes and the idle managers are destroyed when the last scene is disposed of.
+	//
+	public ref class	SDKManagerPool abstract sealed
+	{
+	protected:	// FIELDS
+
+		static Object^				ms_Lock;				// Protects the fields below
+		static Stack<IntPtr>^		ms_IdleManagers;		// Managers waiting for a lease
+		static int					ms_LeasedCount;			// Managers currently leased to a scene
+		static int					ms_CreatedCount;		// Managers created since the process started
+		static int					ms_ReferencesCount;		// Living scenes
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the amount of managers currently alive (idle or leased)" )]
+		//
+		static property int			ManagersCount
+		{
+			int						get();
+		}
+
+		[DescriptionAttribute( "Gets the amount of managers currently leased to a scene" )]
+		//
+		static property int			LeasedCount
+		{
+			int						get()	{ return ms_LeasedCount; }
+		}
+
+		[DescriptionAttribute( "Gets the amount of managers created since the process started (a count that keeps growing means managers are not reused)" )]
+		//
+		static property int			CreatedCount
+		{
+			int						get()	{ return ms_CreatedCount; }
+		}
+
+	public:		// METHODS
+
+		static SDKManagerPool()
+		{
+			ms_Lock = gcnew Object();
+			ms_IdleManagers = gcnew Stack<IntPtr>();
+			ms_LeasedCount = 0;
+			ms_CreatedCount = 0;
+			ms_ReferencesCount = 0;
+		}
+
+		// Destroys the idle managers now to reclaim their memory (new managers are created on demand by the next loads)
+		static void					Trim();
+
+	internal:
+
+		// Adds & removes a reference to the pool (the idle managers are destroyed once the last reference is removed)
+		static void					AddReference();
+		static void					RemoveReference();
+
+		// Leases an idle manager, creating a new one if none is available
+		static KFbxSdkManager*		Lease();
+
+		// Returns a leased manager to the pool (the manager must not hold any SDK object anymore)
+		static void					Return( KFbxSdkManager* _pManager );
+
+	protected:
+
+		static KFbxSdkManager*		CreateManager();
+	};
+}
@@ -2,42 +2,501 @@
 
 #include "stdafx.h"
 #include "Scene.h"
+#include "AnimationTrack.h"
+#include "VertexTransform.h"
 
 using namespace FBXImporter;
 
+namespace FBXImporter
+{
+	// A job generating the LODs of a single mesh on the thread pool
+	ref class	LODGenerationJob
+	{
+	public:
+
+		cli::array<NodeMesh^>^	m_Meshes;
+		ImportOptions^			m_Options;
+
+		void	Execute( int _JobIndex )
+		{
+			m_Meshes[_JobIndex]->GenerateLODs( m_Options->LODsCount, m_Options->LODReductionRatio, m_Options->LODMaxError, m_Options->LODNormalWeight, m_Options->LODUVWeight );
+		}
+	};
+
+	// A job emitting the vertex buffers of a single mesh on the thread pool
+	ref class	VertexBufferEmissionJob
+	{
+	public:
+
+		cli::array<NodeMesh^>^							m_Meshes;
+		VertexBufferLayout^								m_Layout;
+		cli::array<VertexBufferReport::MeshEntry^>^		m_Entries;
+
+		void	Execute( int _JobIndex )
+		{
+			m_Entries[_JobIndex] = m_Meshes[_JobIndex]->EmitVertexBuffer( m_Layout );
+		}
+	};
+
+	// A job encoding the material ranges of a single static mesh in the space of its cell on the thread pool
+	ref class	StaticBatchJob
+	{
+	public:
+
+		cli::array<NodeMesh^>^							m_Meshes;
+		cli::array<cli::array<float>^>^					m_Transforms;
+		VertexBufferLayout^								m_Layout;
+		cli::array<cli::array<StaticBatch::Piece^>^>^	m_Pieces;
+
+		void	Execute( int _JobIndex )
+		{
+			m_Pieces[_JobIndex] = m_Meshes[_JobIndex]->EmitStaticBatchPieces( m_Layout, m_Transforms[_JobIndex] );
+		}
+	};
+
+	// A job hashing the contents of a single mesh on the thread pool
+	ref class	ContentHashJob
+	{
+	public:
+
+		cli::array<NodeMesh^>^			m_Meshes;
+		bool							m_bIgnoreTranslation;
+		Dictionary<Object^,int>^		m_MaterialIDs;	// Only read by the jobs
+		cli::array<MeshContentHash>^	m_Hashes;
+		cli::array<WMath::Point^>^		m_References;
+		cli::array<float>^				m_Steps;
+
+		void	Execute( int _JobIndex )
+		{
+			WMath::Point^	Reference = nullptr;
+			float			Step = 0.0f;
+			m_Hashes[_JobIndex] = m_Meshes[_JobIndex]->ComputeContentHash( m_bIgnoreTranslation, m_MaterialIDs, Reference, Step );
+			m_References[_JobIndex] = Reference;
+			m_Steps[_JobIndex] = Step;
+		}
+	};
+
+	// A job loading a scene on a background thread
+	ref class	SceneLoadJob
+	{
+	public:
+
+		Scene^									m_Scene;
+		String^									m_FileName;
+		Scene::LoadProgressHandler^				m_Progress;
+		System::Threading::CancellationToken	m_Cancellation;
+
+		void	Execute()
+		{
+			m_Scene->Load( m_FileName, m_Progress, m_Cancellation );
+		}
+	};
+}
+
+System::Threading::Tasks::Task^	Scene::LoadAsync( String^ _FileName, LoadProgressHandler^ _Progress, System::Threading::CancellationToken _Cancellation )
+{
+	SceneLoadJob^	Job = gcnew SceneLoadJob();
+	Job->m_Scene = this;
+	Job->m_FileName = _FileName;
+	Job->m_Progress = _Progress;
+	Job->m_Cancellation = _Cancellation;
+
+	// Loads are long and mostly spent in the SDK so we don't hold up a thread pool thread
+	return	System::Threading::Tasks::Task::Factory->StartNew( gcnew Action( Job, &SceneLoadJob::Execute ), _Cancellation,
+															  System::Threading::Tasks::TaskCreationOptions::LongRunning,
+															  System::Threading::Tasks::TaskScheduler::Default );
+}
+
+// Loads a scene from disk on the calling thread
+//
+void	Scene::LoadFile( System::String^ _FileName )
+{
+	// Names are interned and native strings are released at the end of the load
+	StringTable		Strings;
+	MarshalArena	Arena;
+
+#ifdef FBXIMPORTER_PROFILING
+	m_Stats = gcnew ImportStats();
+	ImportStats::Session	ProfileSession( m_Stats );
+#endif
+	PROFILE_SCOPE( "Scene::LoadFile" );
+
+	// Destroy any existing scene (which returns the previous manager to the pool)
+	DestroySDKScene();
+	ClearSceneData();
+	m_bDetached = false;
+
+	// Cancel before leasing a manager for the new scene so a cancelled load doesn't keep it out of the pool
+	ReportProgress( LOAD_STAGE::SDK_IMPORT, 0, 1 );
+	CheckCancellation();
+	LeaseSDKManager();
+
+	// OBJ & PLY files are read by our own parser, everything else by the SDK importer
+	if ( MeshFileImporter::IsSupported( _FileName ) )
+		ImportMeshFile( _FileName );
+	else
+		ImportSDKFile( _FileName );
+
+	try
+	{
+		ReportProgress( LOAD_STAGE::SDK_IMPORT, 1, 1 );
+		ReadSceneData();
+	}
+	catch ( OperationCanceledException^ )
+	{	// Don't leave a half-built scene behind
+		DestroySDKScene();
+		ClearSceneData();
+		throw;
+	}
+	catch ( Exception^ _e )
+	{
+		DestroySDKScene();
+		throw gcnew Exception( "An error occurred while importing scene data !", _e );
+	}
+
+	if ( m_Options->DetachFromSDK )
+	{
+		ReportProgress( LOAD_STAGE::DETACHING, 0, 1 );
+		PROFILE_SCOPE( "Scene::Detach" );
+		Detach();
+		ReportProgress( LOAD_STAGE::DETACHING, 1, 1 );
+	}
+
+	ReportProgress( LOAD_STAGE::DONE, 1, 1 );
+}
+
+// Imports the file with the FBX SDK into a new SDK scene
+//
+void	Scene::ImportSDKFile( String^ _FileName )
+{
+	// Get the file version number generate by the FBX SDK.
+	int lSDKMajor,  lSDKMinor,  lSDKRevision;
+	KFbxSdkManager::GetFileFormatVersion( lSDKMajor, lSDKMinor, lSDKRevision );
+
+	// Create an importer.
+	KFbxImporter* pImporter = KFbxImporter::Create( m_pSDKManager,"" );
+	
+	try
+	{
+		// Create the entity that will hold the scene.
+		m_pScene = KFbxScene::Create( m_pSDKManager, "" );
+
+		// Initialize the importer by providing a filename.
+		const char*	pFileName = Helpers::FromString( _FileName );
+		bool		bImportStatus = false;
+		{
+			PROFILE_SCOPE( "KFbxImporter::Initialize" );
+			bImportStatus = pImporter->Initialize( pFileName, -1, m_pIOSettings );
+		}
+
+		int lFileMajor, lFileMinor, lFileRevision;
+		pImporter->GetFileVersion( lFileMajor, lFileMinor, lFileRevision );
+
+		if ( !bImportStatus )
+		{
+			System::String^	Report = "Call to KFbxImporter::Initialize() failed.\n" +
+									 "Error returned: " + Helpers::GetString( pImporter->GetLastErrorString() ) + "\n\n";
+
+			if ( pImporter->GetLastErrorID() == KFbxIO::eFILE_VERSION_NOT_SUPPORTED_YET ||
+				 pImporter->GetLastErrorID() == KFbxIO::eFILE_VERSION_NOT_SUPPORTED_ANYMORE )
+			{
+				Report += "FBX version number for this FBX SDK is " + lSDKMajor + "." + lSDKMinor + "." + lSDKRevision + "\n";
+				Report += "FBX version number for file \"" + _FileName + "\" is " + lFileMajor + "." + lFileMinor + "." + lFileRevision + "\n\n";
+			}
+
+			throw gcnew Exception( Report );
+		}
+
+		if ( pImporter->IsFBX() )
+		{	// Build animation takes
+			int				AnimTakesCount = pImporter->GetAnimStackCount();
+			System::String^	pCurrentTakeName = Helpers::GetString( pImporter->GetActiveAnimStackName().Buffer() );
+			for ( int AnimTakeIndex=0; AnimTakeIndex < AnimTakesCount; AnimTakeIndex++ )
+			{
+				KFbxTakeInfo*	pTakeInfo = pImporter->GetTakeInfo( AnimTakeIndex );
+				Take^			NewTake = gcnew Take( AnimTakeIndex, pTakeInfo );
+				m_Takes->Add( NewTake );
+
+				// Is this current take ??
+				if ( NewTake->Name == pCurrentTakeName )
+					m_CurrentTake = NewTake;	// This is our current take...
+			}
+
+			// Set the import states. By default, the import states are always set to true. The code below shows how to change these states.
+			m_pIOSettings->SetBoolProp(IMP_FBX_MATERIAL,        true);
+			m_pIOSettings->SetBoolProp(IMP_FBX_TEXTURE,         true);
+			m_pIOSettings->SetBoolProp(IMP_FBX_LINK,            true);
+			m_pIOSettings->SetBoolProp(IMP_FBX_SHAPE,           true);
+			m_pIOSettings->SetBoolProp(IMP_FBX_GOBO,            true);
+			m_pIOSettings->SetBoolProp(IMP_FBX_ANIMATION,       true);
+			m_pIOSettings->SetBoolProp(IMP_FBX_GLOBAL_SETTINGS, true);
+		}
+
+		// Import the scene.
+		bool	bStatus = false;
+		{
+			PROFILE_SCOPE( "KFbxImporter::Import" );
+			bStatus = pImporter->Import( m_pScene );
+		}
+		if ( !bStatus )
+			throw gcnew Exception( "Failed to import \"" + _FileName + "\" ! Last Error : " + Helpers::GetString( pImporter->GetLastErrorString() ) );
+	}
+	catch ( Exception^ )
+	{
+		// The importer belongs to the manager so it must be destroyed before the manager returns to the pool
+		pImporter->Destroy();
+		pImporter = NULL;
+		DestroySDKScene();
+		throw;
+	}
+	finally
+	{
+		// Destroy the importer.
+		if ( pImporter != NULL )
+			pImporter->Destroy();
+	}
+}
+
+// Parses an OBJ or PLY file with the native parser into a new SDK scene
+//
+void	Scene::ImportMeshFile( String^ _FileName )
+{
+	try
+	{
+		m_pScene = KFbxScene::Create( m_pSDKManager, "" );
+		m_MeshFileReport = MeshFileImporter::Import( this, _FileName, m_pScene, m_Options );
+	}
+	catch ( Exception^ )
+	{
+		DestroySDKScene();
+		throw;
+	}
+}
+
+void	Scene::Detach()
+{
+	if ( m_bDetached || m_pScene == NULL )
+		return;	// Already detached or nothing loaded
+
+	// Everything must survive the destruction of the SDK scene, whatever the user's choice for regular destructions
+	bool	bExtractGeometry = m_bExtractGeometryOnDestroy;
+	m_bExtractGeometryOnDestroy = true;
+	try
+	{
+		DestroySDKScene();
+	}
+	finally
+	{
+		m_bExtractGeometryOnDestroy = bExtractGeometry;
+	}
+
+	// These map SDK pointers that are now dangling
+	m_FBXMaterial2Material->Clear();
+	m_FBXNode2Node->Clear();
+	m_PropertyTables->Clear();
+
+	m_bDetached = true;
+}
+
+void	Scene::LeaseSDKManager()
+{
+	if ( m_pSDKManager != NULL )
+		return;
+
+	m_pSDKManager = SDKManagerPool::Lease();
+	m_pIOSettings = m_pSDKManager->GetIOSettings();
+}
+
+void	Scene::ReturnSDKManager()
+{
+	// The manager goes back to the pool for the next load (from this scene or any other)
+	SDKManagerPool::Return( m_pSDKManager );
+	m_pSDKManager = NULL;
+	m_pIOSettings = NULL;
+}
+
+// Clears the lists & pointers of the previous scene
+//
+void	Scene::ClearSceneData()
+{
+	m_CurrentTake = nullptr;
+	m_Takes->Clear();
+	m_AnimationCompressionReport = nullptr;
+	m_VertexCacheReport = nullptr;
+	m_VertexBufferReport = nullptr;
+	m_InstancingReport = nullptr;
+	m_StaticBatchReport = nullptr;
+	m_StaticBatches->Clear();
+	m_MeshFileReport = nullptr;
+
+	if ( m_Transforms != nullptr )
+		delete m_Transforms;
+	m_Transforms = nullptr;
+	m_Streamer = nullptr;
+
+	m_RootNode = nullptr;
+	m_Nodes->Clear();
+	m_Name2Nodes->Clear();
+	m_FBXNode2Node->Clear();
+	m_PropertyTables->Clear();
+
+	m_Materials->Clear();
+	m_Name2Material->Clear();
+	m_FBXMaterial2Material->Clear();
+}
+
 // Read the relevant scene data
 //
 void	Scene::ReadSceneData()
 {
+	PROFILE_SCOPE( "Scene::ReadSceneData" );
+
 	// ======================================
 	// 1] Read scene global settings
 	KFbxGlobalSettings&	Settings = m_pScene->GetGlobalSettings();
 
+	// Build the conversion from the axis system of the file into the target axis system, applied to everything we read
 	KFbxAxisSystem	AxisSystem = Settings.GetAxisSystem();
-	int				Sign = 0;
-	switch ( AxisSystem.GetUpVector( Sign ) )
+	int				UpSign = 0, FrontSign = 0;
+
+	AxisConversion::AxisSystem	Source;
+	switch ( AxisSystem.GetUpVector( UpSign ) )
 	{
 	case KFbxAxisSystem::XAxis:
-		m_UpAxis = UP_AXIS::X;
+		Source.Up = AxisConversion::AXIS_X;
 		break;
 	case KFbxAxisSystem::YAxis:
-		m_UpAxis = UP_AXIS::Y;
+		Source.Up = AxisConversion::AXIS_Y;
+		break;
+	default:
+		Source.Up = AxisConversion::AXIS_Z;
+		break;
+	}
+	bool	bEvenFront = AxisSystem.GetFrontVector( FrontSign ) == KFbxAxisSystem::ParityEven;
+
+	Source.UpSign = UpSign < 0 ? -1 : 1;
+	Source.FrontSign = FrontSign < 0 ? -1 : 1;
+	Source.bRightHanded = AxisSystem.GetCoorSystem() == KFbxAxisSystem::RightHanded;
+
+	// The front axis is given by its parity: the first (even) or the second (odd) of the 2 remaining axes in X, Y, Z order
+	int	FirstRemainingAxis = Source.Up == AxisConversion::AXIS_X ? AxisConversion::AXIS_Y : AxisConversion::AXIS_X;
+	int	SecondRemainingAxis = Source.Up == AxisConversion::AXIS_Z ? AxisConversion::AXIS_Y : AxisConversion::AXIS_Z;
+	Source.Front = (AxisConversion::AXIS) (bEvenFront ? FirstRemainingAxis : SecondRemainingAxis);
+
+	if ( !AxisConversion::IsValid( Source ) )
+		throw gcnew Exception( "The scene has an invalid axis system !" );
+
+	const AxisConversion::AxisSystem*	pTarget = &Source;	// No conversion by default
+	switch ( m_Options->TargetAxisSystem )
+	{
+	case ImportOptions::TARGET_AXIS_SYSTEM::Z_UP_RIGHT_HANDED:
+		pTarget = &AxisConversion::Z_UP_RIGHT_HANDED;
+		break;
+	case ImportOptions::TARGET_AXIS_SYSTEM::Y_UP_RIGHT_HANDED:
+		pTarget = &AxisConversion::Y_UP_RIGHT_HANDED;
 		break;
-	case KFbxAxisSystem::ZAxis:
-		m_UpAxis = UP_AXIS::Z;
+	case ImportOptions::TARGET_AXIS_SYSTEM::Y_UP_LEFT_HANDED:
+		pTarget = &AxisConversion::Y_UP_LEFT_HANDED;
 		break;
 	}
 
-	if ( m_UpAxis != UP_AXIS::Z )
-		throw gcnew Exception( "Only Z-Up is supported for now !" );
- 
+	*m_pAxisConversion = AxisConversion( Source, *pTarget );
+	m_UpAxis = (UP_AXIS) Source.Up;
+	m_TargetUpAxis = (UP_AXIS) pTarget->Up;
+
+
+	// When loading progressively, meshes only read their bounds at creation & register to the streamer for their geometry
+	if ( m_Options->ProgressiveLoad )
+	{
+		if ( m_Options->OptimizeVertexCache )
+			m_VertexCacheReport = gcnew VertexCacheReport( m_Options->VertexCacheSize );
+		if ( m_Options->EmitVertexBuffers )
+			m_VertexBufferReport = gcnew VertexBufferReport( m_Options->VertexLayout );
+		m_Streamer = gcnew GeometryStreamer( this, m_Options, m_VertexCacheReport, m_VertexBufferReport );
+	}
+
 
 	// ======================================
-	// 2] Read back the nodes' hierarchy
+	// 2] Resolve the materials in hierarchy order (so the materials list is still sorted by first use)
 	KFbxNode*	pRootNode = m_pScene->GetRootNode();
 
+	List<IntPtr>^	FBXNodes = gcnew List<IntPtr>();
+	CollectFBXNodes( pRootNode, FBXNodes );
+
+	CheckCancellation();
+	ResolveMaterials( FBXNodes );
+
+
+	// ======================================
+	// 3] Read back the nodes' hierarchy
+	CheckCancellation();
 	m_Nodes->Clear();
-	m_RootNode = CreateNodesHierarchy( nullptr, pRootNode );
+	m_Name2Nodes->Clear();
+	m_FBXNode2Node->Clear();
+	{
+		PROFILE_SCOPE( "Scene::CreateNodesHierarchy" );
+		m_RootNode = CreateNodesHierarchy( nullptr, pRootNode, FBXNodes->Count );
+	}
+	ReportProgress( LOAD_STAGE::HIERARCHY, m_Nodes->Count, FBXNodes->Count );
+
+
+	// ======================================
+	// 4] Extract the meshes' geometry (streamed meshes are extracted on demand)
+	if ( m_Streamer == nullptr )
+		ExtractMeshes();
+
+	// Meshes with identical contents share a single geometry, processed only once below
+	if ( m_Streamer == nullptr && m_Options->DetectInstances )
+		DetectInstances();
+
+
+	// ======================================
+	// 5] Apply optional processing stages (the streamer applies the per-mesh stages after extraction)
+	const int	PROCESSING_STAGES_COUNT = 7;
+	ReportProgress( LOAD_STAGE::PROCESSING, 0, PROCESSING_STAGES_COUNT );
+	CheckCancellation();
+	if ( m_Options->CompressAnimations )
+		CompressAnimations();
+	if ( m_Streamer != nullptr )
+	{	// The remaining stages are applied by the streamer as the meshes get extracted
+		ReportProgress( LOAD_STAGE::PROCESSING, PROCESSING_STAGES_COUNT, PROCESSING_STAGES_COUNT );
+		return;
+	}
+	ReportProgress( LOAD_STAGE::PROCESSING, 1, PROCESSING_STAGES_COUNT );
+
+	CheckCancellation();
+	if ( m_Options->GenerateTangentSpace )
+		GenerateTangentSpace();
+	ReportProgress( LOAD_STAGE::PROCESSING, 2, PROCESSING_STAGES_COUNT );
+
+	CheckCancellation();
+	if ( m_Options->OptimizeVertexCache )
+		OptimizeVertexCache();
+	ReportProgress( LOAD_STAGE::PROCESSING, 3, PROCESSING_STAGES_COUNT );
+
+	CheckCancellation();
+	if ( m_Options->GenerateLODs )
+		GenerateLODs();
+	ReportProgress( LOAD_STAGE::PROCESSING, 4, PROCESSING_STAGES_COUNT );
+
+	CheckCancellation();
+	if ( m_Options->GenerateMeshlets )
+		GenerateMeshlets();
+	ReportProgress( LOAD_STAGE::PROCESSING, 5, PROCESSING_STAGES_COUNT );
+
+	CheckCancellation();
+	if ( m_Options->EmitVertexBuffers )
+		EmitVertexBuffers();
+	ReportProgress( LOAD_STAGE::PROCESSING, 6, PROCESSING_STAGES_COUNT );
+
+	// Instances fetch the processed geometry of their master
+	if ( m_InstancingReport != nullptr )
+		SyncInstances();
+
+	CheckCancellation();
+	if ( m_Options->StaticBatching )
+		BuildStaticBatches();
+	ReportProgress( LOAD_STAGE::PROCESSING, 7, PROCESSING_STAGES_COUNT );
 
 	// ======================================
 
@@ -46,8 +505,183 @@ void	Scene::ReadSceneData()
 	// _ Support markers as simple transforms
 }
 
+// Lists the FBX nodes in the order the hierarchy is created (depth-first, parents before children)
+void	Scene::CollectFBXNodes( KFbxNode* _pNode, List<IntPtr>^ _FBXNodes )
+{
+	_FBXNodes->Add( IntPtr( _pNode ) );
+	for ( int ChildIndex=0; ChildIndex < _pNode->GetChildCount(); ChildIndex++ )
+		CollectFBXNodes( _pNode->GetChild( ChildIndex ), _FBXNodes );
+}
+
+// Resolves the materials of the nodes that will hold them (i.e. nodes with an attribute)
+void	Scene::ResolveMaterials( List<IntPtr>^ _FBXNodes )
+{
+	PROFILE_SCOPE( "Scene::ResolveMaterials" );
+
+	for ( int NodeIndex=0; NodeIndex < _FBXNodes->Count; NodeIndex++ )
+	{
+		if ( (NodeIndex & 0xFF) == 0 )
+		{
+			ReportProgress( LOAD_STAGE::MATERIALS, NodeIndex, _FBXNodes->Count );
+			CheckCancellation();
+		}
+
+		KFbxNode*	pNode = reinterpret_cast<KFbxNode*>( _FBXNodes[NodeIndex].ToPointer() );
+		if ( pNode->GetNodeAttribute() == NULL )
+			continue;
+
+		KFbxNodeAttribute::EAttributeType	AttributeType = pNode->GetNodeAttribute()->GetAttributeType();
+		if ( AttributeType != KFbxNodeAttribute::eMESH && AttributeType != KFbxNodeAttribute::eCAMERA && AttributeType != KFbxNodeAttribute::eLIGHT && AttributeType != KFbxNodeAttribute::eSKELETON )
+			continue;
+
+		for ( int MaterialIndex=0; MaterialIndex < pNode->GetMaterialCount(); MaterialIndex++ )
+			ResolveMaterial( pNode->GetMaterial( MaterialIndex ) );
+	}
+
+	ReportProgress( LOAD_STAGE::MATERIALS, _FBXNodes->Count, _FBXNodes->Count );
+}
+
+// Extracts the geometry of all the meshes, checking for cancellation between meshes
+void	Scene::ExtractMeshes()
+{
+	PROFILE_SCOPE( "Scene::ExtractMeshes" );
+
+	List<NodeMesh^>^	Meshes = gcnew List<NodeMesh^>();
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( m_Nodes[NodeIndex] );
+		if ( Mesh != nullptr )
+			Meshes->Add( Mesh );
+	}
+
+	for ( int MeshIndex=0; MeshIndex < Meshes->Count; MeshIndex++ )
+	{
+		ReportProgress( LOAD_STAGE::MESHES, MeshIndex, Meshes->Count );
+		CheckCancellation();
+
+		NodeMesh^	Mesh = Meshes[MeshIndex];
+		Mesh->ExtractGeometry();
+
+		// Resolve the bones of skinned meshes now that all the nodes exist
+		if ( Mesh->Skin != nullptr )
+			Mesh->Skin->ResolveBones( this );
+	}
+
+	ReportProgress( LOAD_STAGE::MESHES, Meshes->Count, Meshes->Count );
+}
+
+// Hashes the contents of the meshes in parallel and makes every mesh whose hash was already met an instance of the first mesh with that hash
+void	Scene::DetectInstances()
+{
+	PROFILE_SCOPE( "Scene::DetectInstances" );
+
+	System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Hash the meshes that can share their geometry
+	List<NodeMesh^>^	Meshes = gcnew List<NodeMesh^>();
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( m_Nodes[NodeIndex] );
+		if ( Mesh != nullptr && Mesh->CanBeInstanced() )
+			Meshes->Add( Mesh );
+	}
+
+	ContentHashJob^	Job = gcnew ContentHashJob();
+	Job->m_Meshes = Meshes->ToArray();
+	Job->m_bIgnoreTranslation = m_Options->InstanceIgnoreTranslation;
+	Job->m_MaterialIDs = gcnew Dictionary<Object^,int>();
+	for ( int MaterialIndex=0; MaterialIndex < m_Materials->Count; MaterialIndex++ )
+		Job->m_MaterialIDs[m_Materials[MaterialIndex]] = MaterialIndex;
+	Job->m_Hashes = gcnew cli::array<MeshContentHash>( Meshes->Count );
+	Job->m_References = gcnew cli::array<WMath::Point^>( Meshes->Count );
+	Job->m_Steps = gcnew cli::array<float>( Meshes->Count );
+
+	ReportProgress( LOAD_STAGE::INSTANCING, 0, Meshes->Count );
+
+	System::Threading::Tasks::ParallelOptions^	Options = gcnew System::Threading::Tasks::ParallelOptions();
+	Options->CancellationToken = m_LoadCancellation;
+
+	if ( Meshes->Count > 1 )
+		System::Threading::Tasks::Parallel::For( 0, Meshes->Count, Options, gcnew Action<int>( Job, &ContentHashJob::Execute ) );
+	else if ( Meshes->Count == 1 )
+		Job->Execute( 0 );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Share the geometry of the first mesh met with the same contents (meshes are in hierarchy order so the result is deterministic)
+	// A hash match is only a candidate: the contents are compared before sharing, within the quantization step when translation is ignored
+	Dictionary<MeshContentHash,List<int>^>^					Hash2Masters = gcnew Dictionary<MeshContentHash,List<int>^>();
+	Dictionary<NodeMesh^,InstancingReport::GeometryEntry^>^	Master2Entry = gcnew Dictionary<NodeMesh^,InstancingReport::GeometryEntry^>();
+	List<InstancingReport::GeometryEntry^>^					Entries = gcnew List<InstancingReport::GeometryEntry^>();
+	int														RejectedMatchesCount = 0;
+	for ( int MeshIndex=0; MeshIndex < Meshes->Count; MeshIndex++ )
+	{
+		List<int>^	MasterIndices = nullptr;
+		if ( !Hash2Masters->TryGetValue( Job->m_Hashes[MeshIndex], MasterIndices ) )
+		{
+			MasterIndices = gcnew List<int>();
+			Hash2Masters->Add( Job->m_Hashes[MeshIndex], MasterIndices );
+		}
+
+		WMath::Point^	Reference = Job->m_References[MeshIndex];
+		NodeMesh^		Master = nullptr;
+		WMath::Vector^	Offset = nullptr;
+		for ( int CandidateIndex=0; CandidateIndex < MasterIndices->Count; CandidateIndex++ )
+		{
+			int				MasterIndex = MasterIndices[CandidateIndex];
+			WMath::Point^	MasterReference = Job->m_References[MasterIndex];
+			WMath::Vector^	CandidateOffset = gcnew WMath::Vector( Reference->x - MasterReference->x, Reference->y - MasterReference->y, Reference->z - MasterReference->z );
+			if ( Meshes[MeshIndex]->HasSameContent( Meshes[MasterIndex], CandidateOffset, Job->m_Steps[MasterIndex], Job->m_MaterialIDs ) )
+			{
+				Master = Meshes[MasterIndex];
+				Offset = CandidateOffset;
+				break;
+			}
+			RejectedMatchesCount++;
+		}
+
+		if ( Master == nullptr )
+		{	// Keep our own geometry & become a candidate for the next meshes
+			MasterIndices->Add( MeshIndex );
+			continue;
+		}
+
+		Meshes[MeshIndex]->ShareGeometry( Master, Offset );
+
+		InstancingReport::GeometryEntry^	Entry = nullptr;
+		if ( !Master2Entry->TryGetValue( Master, Entry ) )
+		{
+			Entry = gcnew InstancingReport::GeometryEntry();
+			Entry->MasterName = Master->Name;
+			Entry->Hash = Job->m_Hashes[MeshIndex];
+			Entry->TrianglesCount = Master->TrianglesCount;
+			Entry->VerticesCount = Master->VerticesCount;
+			Master2Entry->Add( Master, Entry );
+			Entries->Add( Entry );
+		}
+		Entry->InstancesCount++;
+	}
+
+	m_InstancingReport = gcnew InstancingReport( Meshes->Count, RejectedMatchesCount, Watch->Elapsed.TotalMilliseconds );
+	for each ( InstancingReport::GeometryEntry^ Entry in Entries )
+		m_InstancingReport->AddEntry( Entry );
+
+	ReportProgress( LOAD_STAGE::INSTANCING, Meshes->Count, Meshes->Count );
+}
+
+// Makes the instances point to the geometry of their master again once the processing stages replaced it
+void	Scene::SyncInstances()
+{
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( m_Nodes[NodeIndex] );
+		if ( Mesh != nullptr )
+			Mesh->SyncSharedGeometry();
+	}
+}
+
 // Recursively creates the hierarchy of nodes
-Node^	Scene::CreateNodesHierarchy( Node^ _Parent, KFbxNode* _pNode )
+Node^	Scene::CreateNodesHierarchy( Node^ _Parent, KFbxNode* _pNode, int _TotalNodesCount )
 {
 	Node^	Result = nullptr;
 
@@ -85,15 +719,369 @@ Node^	Scene::CreateNodesHierarchy( Node^ _Parent, KFbxNode* _pNode )
 		return	nullptr;
 
 	// Add that node
+	PROFILE_COUNT( OBJECTS_ALLOCATED, 1 );
 	m_Nodes->Add( Result );
+	m_FBXNode2Node[IntPtr( _pNode )] = Result;
+
+	if ( (m_Nodes->Count & 0xFF) == 0 )
+	{
+		ReportProgress( LOAD_STAGE::HIERARCHY, m_Nodes->Count, _TotalNodesCount );
+		CheckCancellation();
+	}
+
+	// Index it by name (duplicate names are detected by FindNode() from that index)
+	List<Node^>^	SameNameNodes = nullptr;
+	if ( Result->Name != nullptr )
+	{
+		if ( !m_Name2Nodes->TryGetValue( Result->Name, SameNameNodes ) )
+		{
+			SameNameNodes = gcnew List<Node^>( 1 );
+			m_Name2Nodes->Add( Result->Name, SameNameNodes );
+		}
+		SameNameNodes->Add( Result );
+	}
 
 	// Create child nodes
 	for ( int ChildIndex=0; ChildIndex < _pNode->GetChildCount(); ChildIndex++ )
 	{
-		Node^	Child = CreateNodesHierarchy( Result, _pNode->GetChild( ChildIndex ) );
+		Node^	Child = CreateNodesHierarchy( Result, _pNode->GetChild( ChildIndex ), _TotalNodesCount );
 		if ( Child != nullptr )
 			Result->AddChild( Child );
 	}
 
 	return	Result;
 }
+
+// Reduces & quantizes the P, R & S animation tracks of all the nodes
+void	Scene::CompressAnimations()
+{
+	PROFILE_SCOPE( "Scene::CompressAnimations" );
+
+	m_AnimationCompressionReport = gcnew AnimationCompressionReport();
+
+	cli::array<String^>^	ChannelNames = gcnew cli::array<String^> { "P", "R", "S" };
+	cli::array<String^>^	ComponentNames = gcnew cli::array<String^> { "x", "y", "z" };
+	cli::array<float>^		Tolerances = gcnew cli::array<float> { m_Options->PositionTolerance, m_Options->RotationTolerance, m_Options->ScaleTolerance };
+
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		Node^	N = m_Nodes[NodeIndex];
+		if ( !N->IsPRSAnimated )
+			continue;
+
+		cli::array<cli::array<AnimationTrack^>^>^	Channels = gcnew cli::array<cli::array<AnimationTrack^>^> { N->AnimationTracksPosition, N->AnimationTracksRotation, N->AnimationTracksScale };
+		for ( int ChannelIndex=0; ChannelIndex < 3; ChannelIndex++ )
+		{
+			cli::array<AnimationTrack^>^	Tracks = Channels[ChannelIndex];
+			if ( Tracks == nullptr )
+				continue;
+
+			for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+			{
+				AnimationCompressionReport::TrackEntry^	Entry = Tracks[ComponentIndex]->Compress( m_Options->AnimationSampleRate, Tolerances[ChannelIndex] );
+				Entry->NodeName = N->Name;
+				Entry->Channel = ChannelNames[ChannelIndex] + "." + ComponentNames[ComponentIndex];
+				m_AnimationCompressionReport->AddEntry( Entry );
+			}
+		}
+	}
+}
+
+// Generates the missing normals, tangents & binormals of all the meshes (each mesh is processed in parallel chunks)
+void	Scene::GenerateTangentSpace()
+{
+	PROFILE_SCOPE( "Scene::GenerateTangentSpace" );
+
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( m_Nodes[NodeIndex] );
+		if ( Mesh == nullptr || Mesh->InstanceOf != nullptr )
+			continue;
+
+		CheckCancellation();
+		Mesh->GenerateTangentSpace();
+	}
+}
+
+// Reorders the triangles & vertices of all the meshes for the post-transform vertex cache
+void	Scene::OptimizeVertexCache()
+{
+	PROFILE_SCOPE( "Scene::OptimizeVertexCache" );
+
+	m_VertexCacheReport = gcnew VertexCacheReport( m_Options->VertexCacheSize );
+
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( m_Nodes[NodeIndex] );
+		if ( Mesh == nullptr || Mesh->InstanceOf != nullptr )
+			continue;
+
+		CheckCancellation();
+		m_VertexCacheReport->AddEntry( Mesh->OptimizeVertexCache( m_Options->VertexCacheSize ) );
+	}
+}
+
+// Generates the LODs of all the meshes, in parallel
+void	Scene::GenerateLODs()
+{
+	PROFILE_SCOPE( "Scene::GenerateLODs" );
+
+	List<NodeMesh^>^	Meshes = gcnew List<NodeMesh^>();
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( m_Nodes[NodeIndex] );
+		if ( Mesh != nullptr && Mesh->InstanceOf == nullptr )
+			Meshes->Add( Mesh );
+	}
+
+	LODGenerationJob^	Job = gcnew LODGenerationJob();
+	Job->m_Meshes = Meshes->ToArray();
+	Job->m_Options = m_Options;
+
+	// Meshes that didn't start yet are skipped on cancellation
+	System::Threading::Tasks::ParallelOptions^	Options = gcnew System::Threading::Tasks::ParallelOptions();
+	Options->CancellationToken = m_LoadCancellation;
+
+	if ( Meshes->Count > 1 )
+		System::Threading::Tasks::Parallel::For( 0, Meshes->Count, Options, gcnew Action<int>( Job, &LODGenerationJob::Execute ) );
+	else if ( Meshes->Count == 1 )
+		Job->Execute( 0 );
+}
+
+// Splits all the meshes into meshlets
+void	Scene::GenerateMeshlets()
+{
+	PROFILE_SCOPE( "Scene::GenerateMeshlets" );
+
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( m_Nodes[NodeIndex] );
+		if ( Mesh == nullptr || Mesh->InstanceOf != nullptr )
+			continue;
+
+		CheckCancellation();
+		Mesh->GenerateMeshlets( m_Options->MeshletMaxVerticesCount, m_Options->MeshletMaxTrianglesCount );
+	}
+}
+
+// Emits the vertex buffers of all the meshes, in parallel
+void	Scene::EmitVertexBuffers()
+{
+	PROFILE_SCOPE( "Scene::EmitVertexBuffers" );
+
+	List<NodeMesh^>^	Meshes = gcnew List<NodeMesh^>();
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( m_Nodes[NodeIndex] );
+		if ( Mesh != nullptr && Mesh->InstanceOf == nullptr )
+			Meshes->Add( Mesh );
+	}
+
+	VertexBufferEmissionJob^	Job = gcnew VertexBufferEmissionJob();
+	Job->m_Meshes = Meshes->ToArray();
+	Job->m_Layout = m_Options->VertexLayout;
+	Job->m_Entries = gcnew cli::array<VertexBufferReport::MeshEntry^>( Meshes->Count );
+
+	System::Threading::Tasks::ParallelOptions^	Options = gcnew System::Threading::Tasks::ParallelOptions();
+	Options->CancellationToken = m_LoadCancellation;
+
+	if ( Meshes->Count > 1 )
+		System::Threading::Tasks::Parallel::For( 0, Meshes->Count, Options, gcnew Action<int>( Job, &VertexBufferEmissionJob::Execute ) );
+	else if ( Meshes->Count == 1 )
+		Job->Execute( 0 );
+
+	// Entries are reported in the order of the nodes whatever the order the jobs ran in
+	m_VertexBufferReport = gcnew VertexBufferReport( m_Options->VertexLayout );
+	for each ( VertexBufferReport::MeshEntry^ Entry in Job->m_Entries )
+		if ( Entry != nullptr )
+			m_VertexBufferReport->AddEntry( Entry );
+}
+
+// Creates the batch of a material & a cell from its pieces
+static StaticBatch^	CreateStaticBatch( Tuple<Object^,int,int,int>^ _Key, List<StaticBatch::Piece^>^ _Pieces, VertexBufferLayout^ _Layout, float _CellSize )
+{
+	WMath::Point^	Origin = gcnew WMath::Point( (_Key->Item2 + 0.5f) * _CellSize, (_Key->Item3 + 0.5f) * _CellSize, (_Key->Item4 + 0.5f) * _CellSize );
+	return	gcnew StaticBatch( _Key->Item1, _Key->Item2, _Key->Item3, _Key->Item4, Origin, _Layout, _Pieces );
+}
+
+// Merges the static meshes sharing a material & a cell into batches pre-transformed in the space of their cell
+void	Scene::BuildStaticBatches()
+{
+	PROFILE_SCOPE( "Scene::BuildStaticBatches" );
+
+	System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+
+	VertexBufferLayout^	Layout = m_Options->VertexLayout;
+	float				CellSize = m_Options->StaticBatchCellSize;
+	float				PositionScale = Layout->PositionScale;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Find the static meshes & the cell containing the center of their world bounding box
+	List<NodeMesh^>^			Meshes = gcnew List<NodeMesh^>();
+	List<cli::array<int>^>^		Cells = gcnew List<cli::array<int>^>();
+	List<cli::array<float>^>^	Transforms = gcnew List<cli::array<float>^>();
+	int							SkippedMeshesCount = 0;
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( m_Nodes[NodeIndex] );
+		if ( Mesh == nullptr || Mesh->TrianglesCount == 0 )
+			continue;
+		if ( !Mesh->CanBeStaticBatched() )
+		{
+			SkippedMeshesCount++;
+			continue;
+		}
+
+		WMath::BoundingBox^	Bounds = Mesh->WorldBoundingBox;
+		cli::array<int>^	Cell = gcnew cli::array<int>( 3 );
+		Cell[0] = (int) Math::Floor( 0.5f * (Bounds->m_Min->x + Bounds->m_Max->x) / CellSize );
+		Cell[1] = (int) Math::Floor( 0.5f * (Bounds->m_Min->y + Bounds->m_Max->y) / CellSize );
+		Cell[2] = (int) Math::Floor( 0.5f * (Bounds->m_Min->z + Bounds->m_Max->z) / CellSize );
+
+		// Geometry to cell = Pivot * World, translated to the center of the cell (positions are scaled before being transformed so the translation is scaled too)
+		float	pPivot[16], pWorld[16], pGeometryToWorld[16];
+		for ( int RowIndex=0; RowIndex < 4; RowIndex++ )
+			for ( int ColumnIndex=0; ColumnIndex < 4; ColumnIndex++ )
+			{
+				pPivot[4*RowIndex+ColumnIndex] = Mesh->Pivot->m[RowIndex,ColumnIndex];
+				pWorld[4*RowIndex+ColumnIndex] = Mesh->WorldTransform->m[RowIndex,ColumnIndex];
+			}
+		VertexTransform::Multiply( pPivot, pWorld, pGeometryToWorld );
+
+		cli::array<float>^	GeometryToCell = gcnew cli::array<float>( 16 );
+		for ( int Index=0; Index < 16; Index++ )
+			GeometryToCell[Index] = pGeometryToWorld[Index];
+		for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+			GeometryToCell[12+ComponentIndex] = PositionScale * (GeometryToCell[12+ComponentIndex] - (Cell[ComponentIndex] + 0.5f) * CellSize);
+
+		Meshes->Add( Mesh );
+		Cells->Add( Cell );
+		Transforms->Add( GeometryToCell );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Encode the material ranges of every mesh in the space of its cell
+	StaticBatchJob^	Job = gcnew StaticBatchJob();
+	Job->m_Meshes = Meshes->ToArray();
+	Job->m_Transforms = Transforms->ToArray();
+	Job->m_Layout = Layout;
+	Job->m_Pieces = gcnew cli::array<cli::array<StaticBatch::Piece^>^>( Meshes->Count );
+
+	System::Threading::Tasks::ParallelOptions^	Options = gcnew System::Threading::Tasks::ParallelOptions();
+	Options->CancellationToken = m_LoadCancellation;
+
+	if ( Meshes->Count > 1 )
+		System::Threading::Tasks::Parallel::For( 0, Meshes->Count, Options, gcnew Action<int>( Job, &StaticBatchJob::Execute ) );
+	else if ( Meshes->Count == 1 )
+		Job->Execute( 0 );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Append the pieces to the open batch of their material & cell, in hierarchy order so the result is deterministic
+	//	A batch is closed when the next piece would make it exceed the maximum amount of vertices
+	typedef	Tuple<Object^,int,int,int>	BatchKey;
+	Dictionary<BatchKey^,List<StaticBatch::Piece^>^>^	OpenBatches = gcnew Dictionary<BatchKey^,List<StaticBatch::Piece^>^>();
+	Dictionary<BatchKey^,int>^							OpenVerticesCounts = gcnew Dictionary<BatchKey^,int>();
+	List<BatchKey^>^									Keys = gcnew List<BatchKey^>();
+
+	m_StaticBatches->Clear();
+	int	RangesCount = 0;
+	int	MaxVerticesCount = m_Options->StaticBatchMaxVerticesCount;
+	for ( int MeshIndex=0; MeshIndex < Meshes->Count; MeshIndex++ )
+	{
+		cli::array<int>^	Cell = Cells[MeshIndex];
+		for each ( StaticBatch::Piece^ P in Job->m_Pieces[MeshIndex] )
+		{
+			BatchKey^	Key = gcnew BatchKey( P->Material, Cell[0], Cell[1], Cell[2] );
+			List<StaticBatch::Piece^>^	Pieces = nullptr;
+			if ( !OpenBatches->TryGetValue( Key, Pieces ) )
+			{
+				Pieces = gcnew List<StaticBatch::Piece^>();
+				OpenBatches->Add( Key, Pieces );
+				OpenVerticesCounts->Add( Key, 0 );
+				Keys->Add( Key );
+			}
+			else if ( OpenVerticesCounts[Key] + P->Buffer->VerticesCount > MaxVerticesCount )
+			{
+				m_StaticBatches->Add( CreateStaticBatch( Key, Pieces, Layout, CellSize ) );
+				Pieces->Clear();
+				OpenVerticesCounts[Key] = 0;
+			}
+
+			Pieces->Add( P );
+			OpenVerticesCounts[Key] += P->Buffer->VerticesCount;
+			RangesCount++;
+		}
+	}
+
+	for each ( BatchKey^ Key in Keys )
+		if ( OpenBatches[Key]->Count > 0 )
+			m_StaticBatches->Add( CreateStaticBatch( Key, OpenBatches[Key], Layout, CellSize ) );
+
+	m_StaticBatchReport = gcnew StaticBatchReport( Meshes->Count, SkippedMeshesCount, RangesCount, CellSize, gcnew List<StaticBatch^>( m_StaticBatches ), Watch->Elapsed.TotalMilliseconds );
+}
+
+// Releases the objects' dependencies on the SDK scene then destroys it
+void	Scene::DestroySDKScene()
+{
+	// Streamed geometry that was not extracted yet is lost unless asked otherwise
+	if ( m_Streamer != nullptr )
+		m_Streamer->Shutdown( m_bExtractGeometryOnDestroy );
+
+	// Properties are always snapshot so they don't depend on the SDK scene's lifetime
+	for ( int ObjectIndex=0; ObjectIndex < m_Objects->Count; ObjectIndex++ )
+	{
+		BaseObject^	Object = m_Objects[ObjectIndex];
+		Object->SnapshotProperties();
+		Object->ReleaseSDKObject();
+	}
+	m_Objects->Clear();
+
+	if ( m_pScene != NULL )
+		m_pScene->Destroy( true, true );
+	m_pScene = NULL;
+
+	ReturnSDKManager();
+}
+
+void	Scene::ConvertVectors( cli::array<float>^ _Vectors, int _Count )
+{
+	if ( _Count == 0 || m_pAxisConversion->IsIdentity() )
+		return;
+
+	pin_ptr<float>	pVectors = &_Vectors[0];
+	m_pAxisConversion->TransformVectors( pVectors, _Count );
+}
+
+void	Scene::ConvertTransform( WMath::Matrix4x4^ _Transform )
+{
+	if ( m_pAxisConversion->IsIdentity() )
+		return;
+
+	float	pMatrix[16];
+	for ( int Row=0; Row < 4; Row++ )
+		for ( int Column=0; Column < 4; Column++ )
+			pMatrix[4*Row+Column] = _Transform->m[Row,Column];
+
+	m_pAxisConversion->TransformMatrix( pMatrix );
+
+	for ( int Row=0; Row < 4; Row++ )
+		for ( int Column=0; Column < 4; Column++ )
+			_Transform->m[Row,Column] = pMatrix[4*Row+Column];
+}
+
+void	Scene::ConvertTracks( cli::array<AnimationTrack^>^ _Tracks, bool _bRotation, bool _bScaling )
+{
+	if ( m_pAxisConversion->IsIdentity() )
+		return;
+
+	cli::array<AnimationTrack^>^	SourceTracks = (cli::array<AnimationTrack^>^) _Tracks->Clone();
+	for ( int AxisIndex=0; AxisIndex < 3; AxisIndex++ )
+	{
+		_Tracks[AxisIndex] = SourceTracks[m_pAxisConversion->GetSourceAxis( AxisIndex )];
+
+		// Scales are never negated, rotations are also reversed by reflections
+		float	Sign = _bScaling ? 1.0f : m_pAxisConversion->GetSign( AxisIndex ) * (_bRotation ? m_pAxisConversion->GetDeterminant() : 1.0f);
+		if ( Sign < 0.0f )
+			_Tracks[AxisIndex]->ApplyFactor( -1.0f );
+	}
+}
@@ -12,6 +12,13 @@ using namespace System::Collections::Generic;
 #include "Layers.h"
 #include "Materials.h"
 #include "HardwareMaterials.h"
+#include "ImportOptions.h"
+#include "SceneTransforms.h"
+#include "GeometryStreamer.h"
+#include "StaticBatchReport.h"
+#include "MeshFileImporter.h"
+#include "AxisConversion.h"
+#include "SDKManagerPool.h"
 
 namespace FBXImporter
 {
@@ -74,9 +81,26 @@ namespace FBXImporter
 			Z
 		};
 
+		// The stages of a load, in the order they're performed
+		enum class	LOAD_STAGE
+		{
+			SDK_IMPORT,		// Reading the file with the SDK (reported at start & end only)
+			MATERIALS,		// Resolving the materials of the nodes
+			HIERARCHY,		// Creating the nodes
+			MESHES,			// Extracting the geometry of each mesh (skipped when loading progressively)
+			INSTANCING,		// Hashing the meshes to detect instances (skipped when not enabled or loading progressively)
+			PROCESSING,		// Applying the optional processing stages
+			DETACHING,		// Destroying the SDK scene & manager (only when detaching)
+			DONE,
+		};
+
+		// Reports the progress of a load within a stage
+		// NOTE: When loading asynchronously, this is called on the loading thread
+		delegate void	LoadProgressHandler( Scene^ _Scene, LOAD_STAGE _Stage, int _Completed, int _Total );
+
 	protected:	// FIELDS
 
-		KFbxSdkManager*		m_pSDKManager;			// SdkManager pointer
+		KFbxSdkManager*		m_pSDKManager;			// SdkManager pointer (leased from the pool for the lifetime of the SDK scene)
 		KFbxScene*			m_pScene;				// Scene pointer
 		KFbxIOSettings*		m_pIOSettings;
 
@@ -84,15 +108,47 @@ namespace FBXImporter
 		Take^				m_CurrentTake;
 		List<Take^>^		m_Takes;
 
-		UP_AXIS				m_UpAxis;
+		UP_AXIS				m_UpAxis;				// The up axis of the file
+		UP_AXIS				m_TargetUpAxis;			// The up axis of the imported data (i.e. of the target axis system)
+		AxisConversion*		m_pAxisConversion;		// Converts from the axis system of the file into the target axis system (identity by default)
+
+		// Import options & reports
+		ImportOptions^		m_Options;
+		AnimationCompressionReport^	m_AnimationCompressionReport;
+		VertexCacheReport^	m_VertexCacheReport;
+		VertexBufferReport^	m_VertexBufferReport;
+		InstancingReport^	m_InstancingReport;
+		StaticBatchReport^	m_StaticBatchReport;
+		MeshFileReport^		m_MeshFileReport;
+		ImportStats^		m_Stats;
 
 		// Materials list
 		List<Material^>^	m_Materials;
 		Dictionary<String^,Material^>^	m_Name2Material;
+		Dictionary<IntPtr,Material^>^	m_FBXMaterial2Material;	// Avoids building the material name again for every node referencing it
 
 		// Nodes hierarchy
 		List<Node^>^		m_Nodes;
 		Node^				m_RootNode;
+		Dictionary<String^,List<Node^>^>^	m_Name2Nodes;	// Multi-map of node names to nodes
+		Dictionary<IntPtr,Node^>^			m_FBXNode2Node;	// FBX nodes to our nodes
+		List<StaticBatch^>^	m_StaticBatches;	// The merged static meshes (empty unless static batching is enabled)
+		SceneTransforms^	m_Transforms;		// The flattened transform hierarchy (built on first use)
+		GeometryStreamer^	m_Streamer;			// Extracts mesh geometry on demand (only when loaded progressively)
+
+		// Property name tables shared by objects of the same FBX class
+		Dictionary<String^,PropertyNameTable^>^	m_PropertyTables;
+
+		// All the objects wrapping an FBX object, notified before the SDK scene is destroyed
+		List<BaseObject^>^	m_Objects;
+		bool				m_bExtractGeometryOnDestroy;
+
+		// Load state
+		int									m_bLoading;				// 1 while a load is in progress (int so it can be swapped atomically)
+		bool								m_bDetached;			// True once Detach() destroyed the SDK scene (until the next load)
+		bool								m_bReferencesPool;		// True until the scene is disposed of and removed its reference to the SDK manager pool
+		LoadProgressHandler^				m_LoadProgress;			// The progress callback of the current load (may be null)
+		System::Threading::CancellationToken	m_LoadCancellation;	// The cancellation token of the current load
 
 
 	public:		// PROPERTIES
@@ -117,163 +173,215 @@ namespace FBXImporter
 			cli::array<Node^>^		get()	{ return m_Nodes->ToArray(); }
 		}
 
+		// Gets the batches the static meshes were merged into (empty unless ImportOptions::StaticBatching was enabled)
+		// The batched nodes stay in the hierarchy so the batches' ranges can map back to them
+		property cli::array<StaticBatch^>^	StaticBatches
+		{
+			cli::array<StaticBatch^>^	get()	{ return m_StaticBatches->ToArray(); }
+		}
+
 		property Node^						RootNode
 		{
 			Node^					get()	{ return m_RootNode; }
 		}
 
+		// Gets the cached world transforms & bounds of the nodes (built on first access)
+		property SceneTransforms^			Transforms
+		{
+			SceneTransforms^		get()
+			{
+				if ( m_Transforms == nullptr )
+					m_Transforms = gcnew SceneTransforms( this );
+				return	m_Transforms;
+			}
+		}
+
+		// Gets the streamer extracting mesh geometry on demand (null unless the scene was loaded with ImportOptions::ProgressiveLoad)
+		property GeometryStreamer^			Streamer
+		{
+			GeometryStreamer^		get()	{ return m_Streamer; }
+		}
+
+		// Gets the up axis of the file the scene was loaded from
 		property UP_AXIS					UpAxis
 		{
 			UP_AXIS					get()	{ return m_UpAxis; }
 		}
 
+		// Gets the up axis of the imported data (i.e. the up axis of ImportOptions::TargetAxisSystem, the same as UpAxis when the scene isn't converted)
+		property UP_AXIS					TargetUpAxis
+		{
+			UP_AXIS					get()	{ return m_TargetUpAxis; }
+		}
 
-	public:		// METHODS
+		// Gets or sets the options applied to the next scenes loaded
+		property ImportOptions^				Options
+		{
+			ImportOptions^			get()	{ return m_Options; }
+			void					set( ImportOptions^ _Value )	{ m_Options = _Value != nullptr ? _Value : gcnew ImportOptions(); }
+		}
 
-		Scene()
+		// Gets the report of the animation compression stage (null if animations were not compressed)
+		property AnimationCompressionReport^	AnimationCompression
 		{
-			// The first thing to do is to create the FBX SDK manager which is the object allocator for almost all the classes in the SDK.
-			m_pSDKManager = KFbxSdkManager::Create();
-			if ( !m_pSDKManager )
-				throw gcnew Exception( "Unable to create the FBX SDK manager!" );
+			AnimationCompressionReport^	get()	{ return m_AnimationCompressionReport; }
+		}
 
+		// Gets the report of the vertex cache optimization stage (null if meshes were not optimized)
+		property VertexCacheReport^			VertexCache
+		{
+			VertexCacheReport^		get()	{ return m_VertexCacheReport; }
+		}
 
-			// Create an IOSettings object
-			m_pIOSettings = KFbxIOSettings::Create( m_pSDKManager, IOSROOT );
-			m_pSDKManager->SetIOSettings( m_pIOSettings );
+		// Gets the report of the vertex buffer emission stage (null if vertex buffers were not emitted)
+		property VertexBufferReport^		VertexBuffers
+		{
+			VertexBufferReport^		get()	{ return m_VertexBufferReport; }
+		}
 
-			// Load plugins from the executable directory
-			KString lPath = KFbxGetApplicationDirectory();
-			KString lExtension = "dll";
-			m_pSDKManager->LoadPluginsDirectory( lPath.Buffer(), lExtension.Buffer() );
+		// Gets the report of the instancing stage (null if instances were not detected)
+		property InstancingReport^			Instancing
+		{
+			InstancingReport^		get()	{ return m_InstancingReport; }
+		}
 
+		// Gets the report of the static batching stage (null if static meshes were not batched)
+		property StaticBatchReport^			StaticBatching
+		{
+			StaticBatchReport^		get()	{ return m_StaticBatchReport; }
+		}
 
-			// Initialize lists
-			m_Takes = gcnew List<Take^>();
-			m_Materials = gcnew List<Material^>();
-			m_Nodes = gcnew List<Node^>();
-			m_Name2Material = gcnew Dictionary<String^,Material^>();
+		// Gets the report of the native OBJ & PLY parser (null if the scene was loaded by the SDK importer)
+		property MeshFileReport^			MeshFile
+		{
+			MeshFileReport^			get()	{ return m_MeshFileReport; }
 		}
 
-		~Scene()
+		// Gets the timings & counters of the last load (null unless the importer was built with FBXIMPORTER_PROFILING defined)
+		// Meshes extracted on demand after a progressive load keep adding to these stats
+		property ImportStats^				Stats
 		{
-			// Destroy any existing scene
-			if ( m_pScene != nullptr )
-				m_pScene->Destroy( true, true );
+			ImportStats^			get()	{ return m_Stats; }
+		}
 
-			// Delete the FBX SDK manager. All the objects that have been allocated 
-			// using the FBX SDK manager and that haven't been explicitly destroyed 
-			// are automatically destroyed at the same time.
-			if ( m_pSDKManager )
-				m_pSDKManager->Destroy();
-			m_pSDKManager = NULL;
+		// Properties are always materialized before the SDK scene gets destroyed (i.e. when loading another scene or disposing of that one)
+		//	so they stay available afterward.
+		// If true, the meshes of a progressive load whose geometry was not extracted yet are also extracted before the destruction
+		// If false (default), their geometry is lost
+		property bool						ExtractGeometryOnDestroy
+		{
+			bool					get()	{ return m_bExtractGeometryOnDestroy; }
+			void					set( bool _Value )	{ m_bExtractGeometryOnDestroy = _Value; }
 		}
 
-		//////////////////////////////////////////////////////////////////////////
-		// Loads a scene from disk
-		//
-		void		Load( System::String^ _FileName )
+		// Same as ExtractGeometryOnDestroy, properties don't depend on that flag anymore
+		[ObsoleteAttribute( "Properties are always snapshot before the SDK scene gets destroyed, use ExtractGeometryOnDestroy for the streamed geometry" )]
+		property bool						SnapshotPropertiesOnDestroy
 		{
-			// Clear lists & pointers
-			m_CurrentTake = nullptr;
-			m_Takes->Clear();
+			bool					get()	{ return m_bExtractGeometryOnDestroy; }
+			void					set( bool _Value )	{ m_bExtractGeometryOnDestroy = _Value; }
+		}
 
-			m_RootNode = nullptr;
-			m_Nodes->Clear();
+		// Tells if the scene was detached from the FBX SDK (i.e. the SDK scene & manager were destroyed and everything was snapshot)
+		property bool						IsDetached
+		{
+			bool					get()	{ return m_bDetached; }
+		}
 
-			m_Materials->Clear();
-			m_Name2Material->Clear();
 
-			// Get the file version number generate by the FBX SDK.
-			int lSDKMajor,  lSDKMinor,  lSDKRevision;
-			KFbxSdkManager::GetFileFormatVersion( lSDKMajor, lSDKMinor, lSDKRevision );
+	public:		// METHODS
 
-			// Create an importer.
-			KFbxImporter* pImporter = KFbxImporter::Create( m_pSDKManager,"" );
-			
-			try
-			{
-				// Destroy any existing scene
-				if ( m_pScene != nullptr )
-					m_pScene->Destroy( true, true );
+		Scene()
+		{
+			// The FBX SDK manager, which is the object allocator for almost all the classes in the SDK, is leased from the pool when loading
+			m_pSDKManager = NULL;
+			m_pIOSettings = NULL;
+			m_pScene = NULL;
+			m_pAxisConversion = new AxisConversion();
+			m_UpAxis = m_TargetUpAxis = UP_AXIS::Z;
+			m_bDetached = false;
+			m_bReferencesPool = true;
+			SDKManagerPool::AddReference();
 
-				// Create the entity that will hold the scene.
-				m_pScene = KFbxScene::Create( m_pSDKManager, "" );
 
-				// Initialize the importer by providing a filename.
-				const char*	pFileName = Helpers::FromString( _FileName );
-				const bool	bImportStatus = pImporter->Initialize( pFileName, -1, m_pIOSettings );
+			// Initialize lists
+			m_Takes = gcnew List<Take^>();
+			m_Materials = gcnew List<Material^>();
+			m_Nodes = gcnew List<Node^>();
+			m_Name2Material = gcnew Dictionary<String^,Material^>();
+			m_FBXMaterial2Material = gcnew Dictionary<IntPtr,Material^>();
+			m_Name2Nodes = gcnew Dictionary<String^,List<Node^>^>();
+			m_FBXNode2Node = gcnew Dictionary<IntPtr,Node^>();
+			m_StaticBatches = gcnew List<StaticBatch^>();
+			m_PropertyTables = gcnew Dictionary<String^,PropertyNameTable^>();
+			m_Objects = gcnew List<BaseObject^>();
+			m_bExtractGeometryOnDestroy = false;
+			m_Options = gcnew ImportOptions();
+			m_bLoading = 0;
+		}
 
-				int lFileMajor, lFileMinor, lFileRevision;
-				pImporter->GetFileVersion( lFileMajor, lFileMinor, lFileRevision );
+		~Scene()
+		{
+			// Destroy any existing scene (which returns the manager to the pool)
+			DestroySDKScene();
 
-				if ( !bImportStatus )
-				{
-					System::String^	Report = "Call to KFbxImporter::Initialize() failed.\n" +
-											 "Error returned: " + Helpers::GetString( pImporter->GetLastErrorString() ) + "\n\n";
+			if ( m_bReferencesPool )
+				SDKManagerPool::RemoveReference();
+			m_bReferencesPool = false;
 
-					if ( pImporter->GetLastErrorID() == KFbxIO::eFILE_VERSION_NOT_SUPPORTED_YET ||
-						 pImporter->GetLastErrorID() == KFbxIO::eFILE_VERSION_NOT_SUPPORTED_ANYMORE )
-					{
-						Report += "FBX version number for this FBX SDK is " + lSDKMajor + "." + lSDKMinor + "." + lSDKRevision + "\n";
-						Report += "FBX version number for file \"" + _FileName + "\" is " + lFileMajor + "." + lFileMinor + "." + lFileRevision + "\n\n";
-					}
+			this->!Scene();
+		}
 
-					throw gcnew Exception( Report );
-				}
+		!Scene()
+		{
+			delete m_pAxisConversion;
+			m_pAxisConversion = NULL;
+		}
 
-				if ( pImporter->IsFBX() )
-				{	// Build animation takes
-					int				AnimTakesCount = pImporter->GetAnimStackCount();
-					System::String^	pCurrentTakeName = Helpers::GetString( pImporter->GetActiveAnimStackName().Buffer() );
-					for ( int AnimTakeIndex=0; AnimTakeIndex < AnimTakesCount; AnimTakeIndex++ )
-					{
-						KFbxTakeInfo*	pTakeInfo = pImporter->GetTakeInfo( AnimTakeIndex );
-						Take^			NewTake = gcnew Take( AnimTakeIndex, pTakeInfo );
-						m_Takes->Add( NewTake );
-
-						// Is this current take ??
-						if ( NewTake->Name == pCurrentTakeName )
-							m_CurrentTake = NewTake;	// This is our current take...
-					}
-
-					// Set the import states. By default, the import states are always set to true. The code below shows how to change these states.
-					m_pIOSettings->SetBoolProp(IMP_FBX_MATERIAL,        true);
-					m_pIOSettings->SetBoolProp(IMP_FBX_TEXTURE,         true);
-					m_pIOSettings->SetBoolProp(IMP_FBX_LINK,            true);
-					m_pIOSettings->SetBoolProp(IMP_FBX_SHAPE,           true);
-					m_pIOSettings->SetBoolProp(IMP_FBX_GOBO,            true);
-					m_pIOSettings->SetBoolProp(IMP_FBX_ANIMATION,       true);
-					m_pIOSettings->SetBoolProp(IMP_FBX_GLOBAL_SETTINGS, true);
-				}
+		//////////////////////////////////////////////////////////////////////////
+		// Loads a scene from disk
+		//
+		void		Load( System::String^ _FileName )
+		{
+			Load( _FileName, nullptr, System::Threading::CancellationToken::None );
+		}
 
-				// Import the scene.
-				bool	bStatus = pImporter->Import( m_pScene );
-				if ( !bStatus )
-					throw gcnew Exception( "Failed to import \"" + _FileName + "\" ! Last Error : " + Helpers::GetString( pImporter->GetLastErrorString() ) );
-			}
-			catch ( Exception^ )
-			{
-				m_pScene->Destroy( true, true );
-				throw;
-			}
-			finally
-			{
-				// Destroy the importer.
-				pImporter->Destroy();
-			}
+		// Loads a scene from disk, reporting progress & checking for cancellation between stages and between meshes
+		//	_Progress, an optional progress callback
+		//	_Cancellation, if cancellation is requested an OperationCanceledException is thrown and the scene is left empty
+		//
+		void		Load( System::String^ _FileName, LoadProgressHandler^ _Progress, System::Threading::CancellationToken _Cancellation )
+		{
+			if ( System::Threading::Interlocked::CompareExchange( m_bLoading, 1, 0 ) != 0 )
+				throw gcnew Exception( "A scene is already being loaded !" );
 
+			m_LoadProgress = _Progress;
+			m_LoadCancellation = _Cancellation;
 			try
 			{
-				ReadSceneData();
+				LoadFile( _FileName );
 			}
-			catch ( Exception^ _e )
+			finally
 			{
-				m_pScene->Destroy( true, true );
-				throw gcnew Exception( "An error occurred while importing scene data !", _e );
+				m_LoadProgress = nullptr;
+				m_LoadCancellation = System::Threading::CancellationToken::None;
+				m_bLoading = 0;
 			}
 		}
 
+		// Loads a scene from disk on a background thread
+		// The scene must not be accessed until the returned task completes. The task is canceled if cancellation is requested
+		//	through _Cancellation (the scene is then left empty) and faulted if the load fails.
+		// Several scenes can be loaded concurrently, each with its own Scene object.
+		//
+		System::Threading::Tasks::Task^	LoadAsync( System::String^ _FileName, LoadProgressHandler^ _Progress, System::Threading::CancellationToken _Cancellation );
+
+		// Extracts everything that is still read lazily from the SDK (streamed geometry, properties, light, camera & material values, animation curves)
+		//	then destroys the SDK scene and returns the SDK manager to the pool so only our own data remains in memory
+		// The scene stays fully usable afterward, a manager is leased again by the next load.
+		//
+		void		Detach();
+
 		// Finds a node by name
 		//	_bThrowOnMultipleNodes, will throw an exception if multiple nodes are found with the same name
 		//
@@ -286,29 +394,114 @@ namespace FBXImporter
 			if ( _NodeName == nullptr )
 				return	nullptr;
 
-			Node^	Result = nullptr;
-			for ( int NodeIndex=0; NodeIndex < m_Nodes->Count; NodeIndex++ )
-				if ( m_Nodes[NodeIndex]->Name == _NodeName )
-				{
-					if ( !_bThrowOnMultipleNodes )
-						return	m_Nodes[NodeIndex];	// No use to look any further if we don't check duplicate names !
+			List<Node^>^	Nodes = nullptr;
+			if ( !m_Name2Nodes->TryGetValue( _NodeName, Nodes ) )
+				return	nullptr;
 
-					if ( Result != nullptr )
-						throw gcnew Exception( "There are more than one object with the name \"" + _NodeName + "\" !" );
+			if ( _bThrowOnMultipleNodes && Nodes->Count > 1 )
+				throw gcnew Exception( "There are more than one object with the name \"" + _NodeName + "\" !" );
 
-					Result = m_Nodes[NodeIndex];
-				}
+			return	Nodes[0];
+		}
 
-			return	Result;
+		// Finds all the nodes with the given name
+		//
+		cli::array<Node^>^	FindNodes( String^ _NodeName )
+		{
+			List<Node^>^	Nodes = nullptr;
+			if ( _NodeName == nullptr || !m_Name2Nodes->TryGetValue( _NodeName, Nodes ) )
+				return	gcnew cli::array<Node^>( 0 );
+
+			return	Nodes->ToArray();
 		}
 
 	protected:
 
+		void	LoadFile( System::String^ _FileName );
+		void	ImportSDKFile( System::String^ _FileName );
+		void	ImportMeshFile( System::String^ _FileName );
+		void	ClearSceneData();
 		void	ReadSceneData();
-		Node^	CreateNodesHierarchy( Node^ _Parent, KFbxNode* _pNode );
+		void	ResolveMaterials( List<IntPtr>^ _FBXNodes );
+		void	ExtractMeshes();
+		void	DetectInstances();
+		void	SyncInstances();
+		void	CompressAnimations();
+		void	GenerateTangentSpace();
+		void	OptimizeVertexCache();
+		void	GenerateLODs();
+		void	GenerateMeshlets();
+		void	EmitVertexBuffers();
+		void	BuildStaticBatches();
+		Node^	CreateNodesHierarchy( Node^ _Parent, KFbxNode* _pNode, int _TotalNodesCount );
+		static void	CollectFBXNodes( KFbxNode* _pNode, List<IntPtr>^ _FBXNodes );
+
+		// Releases the objects' dependencies on the SDK scene then destroys it
+		void	DestroySDKScene();
+
+		// Leases a manager from the pool & returns it (the manager is returned with the destruction of the SDK scene)
+		void	LeaseSDKManager();
+		void	ReturnSDKManager();
+
+		// Notifies the progress callback of the current load (if any)
+		void		ReportProgress( LOAD_STAGE _Stage, int _Completed, int _Total )
+		{
+			if ( m_LoadProgress != nullptr )
+				m_LoadProgress( this, _Stage, _Completed, _Total );
+		}
+
+		// Throws an OperationCanceledException if the current load was canceled
+		void		CheckCancellation()
+		{
+			m_LoadCancellation.ThrowIfCancellationRequested();
+		}
 
 	internal:
 
+		// Gets the conversion from the axis system of the file into the target axis system (valid once the SDK scene is read)
+		const AxisConversion&	GetAxisConversion()	{ return *m_pAxisConversion; }
+
+		// Converts packed 3D vectors (3 floats per vector) into the target axis system
+		void	ConvertVectors( cli::array<float>^ _Vectors, int _Count );
+
+		// Converts a transform matrix into the target axis system
+		void	ConvertTransform( WMath::Matrix4x4^ _Transform );
+
+		// Reorders & negates the X, Y & Z tracks of an animated translation, Euler rotation (in radians) or scaling into the target axis system
+		//	(the same way AxisConversion::TransformFrames() converts sampled frames)
+		void	ConvertTracks( cli::array<AnimationTrack^>^ _Tracks, bool _bRotation, bool _bScaling );
+
+		// Gets the property name table shared by all the objects of the same class and layout as the given object
+		//
+		PropertyNameTable^	GetPropertyNameTable( KFbxObject* _pObject, const KFbxProperty* _pHandles, int _PropertiesCount, int _ClassPropertiesCount )
+		{
+			String^	Key = Helpers::GetString( _pObject->GetClassId().GetName() ) + "|" + _ClassPropertiesCount;
+
+			PropertyNameTable^	Result = nullptr;
+			if ( !m_PropertyTables->TryGetValue( Key, Result ) )
+			{
+				Result = gcnew PropertyNameTable( _pHandles, _PropertiesCount );
+				m_PropertyTables->Add( Key, Result );
+			}
+
+			return	Result;
+		}
+
+		// Finds the node wrapping the given FBX node
+		Node^			FindNode( KFbxNode* _pNode )
+		{
+			Node^	Result = nullptr;
+			m_FBXNode2Node->TryGetValue( IntPtr( _pNode ), Result );
+
+			return	Result;
+		}
+
+		// Registers an object wrapping an FBX object of our SDK scene
+		void			RegisterObject( BaseObject^ _Object )
+		{
+			m_Objects->Add( _Object );
+		}
+
 		// Resolves a FBX material into one of our materials
 		//
 		Material^		ResolveMaterial( KFbxSurfaceMaterial* _pMaterial )
@@ -316,12 +509,21 @@ namespace FBXImporter
 			if ( _pMaterial == NULL )
 				return	nullptr;
 
+			Material^	Result = nullptr;
+			if ( m_FBXMaterial2Material->TryGetValue( IntPtr( _pMaterial ), Result ) )
+				return	Result;
+
 			String^	MaterialName = Helpers::GetString( _pMaterial->GetName() );
-			if ( m_Name2Material->ContainsKey( MaterialName ) )
-				return	m_Name2Material[MaterialName];
+			if ( m_Name2Material->TryGetValue( MaterialName, Result ) )
+			{
+				m_FBXMaterial2Material->Add( IntPtr( _pMaterial ), Result );
+				return	Result;
+			}
 
 			//////////////////////////////////////////////////////////////////////////
 			// Build a brand new material
+			PROFILE_SCOPE( "Scene::ResolveMaterial" );
+			PROFILE_COUNT( OBJECTS_ALLOCATED, 1 );
 			Material^	NewMaterial = nullptr;
 
 			// Check for hardward shader materials
@@ -350,6 +552,7 @@ namespace FBXImporter
 			// Register it for later
 			m_Materials->Add( NewMaterial );
 			m_Name2Material->Add( MaterialName, NewMaterial );
+			m_FBXMaterial2Material->Add( IntPtr( _pMaterial ), NewMaterial );
 
 			return	NewMaterial;
 		}
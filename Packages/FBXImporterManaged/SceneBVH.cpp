@@ -0,0 +1,429 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "SceneBVH.h"
+#include "NodeMesh.h"
+#include "Scene.h"
+
+using namespace	FBXImporter;
+
+namespace FBXImporter
+{
+	// A job building one of the independent subtrees of the BVH
+	ref class	BVHBuildJob
+	{
+	public:
+
+		TriangleBVH*	m_pBVH;
+
+		void	Execute( int _JobIndex )
+		{
+			m_pBVH->BuildSubtree( _JobIndex );
+		}
+	};
+
+	// A job refitting a range of triangles of the BVH
+	ref class	BVHRefitJob
+	{
+	public:
+
+		TriangleBVH*	m_pBVH;
+
+		void	Execute( int _JobIndex )
+		{
+			int	FirstTriangle = _JobIndex * SceneBVH::TRIANGLES_PER_REFIT_JOB;
+			int	TrianglesCount = Math::Min( SceneBVH::TRIANGLES_PER_REFIT_JOB, m_pBVH->GetTrianglesCount() - FirstTriangle );
+			m_pBVH->RefitTriangles( FirstTriangle, TrianglesCount );
+		}
+	};
+
+	// A job tracing a range of rays by packets of 4
+	ref class	BVHRaysJob
+	{
+	public:
+
+		const TriangleBVH*	m_pBVH;
+		const float*		m_pOrigins;
+		const float*		m_pDirections;
+		float*				m_pDistances;
+		int*				m_pTriangleIDs;
+		int					m_RaysCount;
+		float				m_MaxDistance;
+		int					m_HitsCount;
+
+		void	Execute( int _JobIndex )
+		{
+			int	StartRay = _JobIndex * SceneBVH::RAYS_PER_JOB;
+			int	EndRay = Math::Min( StartRay + SceneBVH::RAYS_PER_JOB, m_RaysCount );
+
+			float	pOrigins[12];
+			float	pDirections[12];
+			BVHHit	pHits[4];
+			int		HitsCount = 0;
+			for ( int PacketStart=StartRay; PacketStart < EndRay; PacketStart+=4 )
+			{
+				// Convert to SoA, padding the last packet by repeating its last ray
+				int	PacketSize = Math::Min( 4, EndRay - PacketStart );
+				for ( int RayIndex=0; RayIndex < 4; RayIndex++ )
+				{
+					int	SourceRay = PacketStart + Math::Min( RayIndex, PacketSize-1 );
+					for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+					{
+						pOrigins[4*ComponentIndex+RayIndex] = m_pOrigins[3*SourceRay+ComponentIndex];
+						pDirections[4*ComponentIndex+RayIndex] = m_pDirections[3*SourceRay+ComponentIndex];
+					}
+				}
+
+				m_pBVH->IntersectPacket( pOrigins, pDirections, m_MaxDistance, pHits );
+
+				for ( int RayIndex=0; RayIndex < PacketSize; RayIndex++ )
+				{
+					m_pDistances[PacketStart+RayIndex] = pHits[RayIndex].Distance;
+					m_pTriangleIDs[PacketStart+RayIndex] = pHits[RayIndex].TriangleIndex;
+					if ( pHits[RayIndex].TriangleIndex >= 0 )
+						HitsCount++;
+				}
+			}
+
+			System::Threading::Interlocked::Add( m_HitsCount, HitsCount );
+		}
+	};
+}
+
+SceneBVH::SceneBVH( Scene^ _Owner ) : m_Owner( _Owner ), m_pBVH( NULL )
+{
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Gather the meshes and their offsets
+	List<NodeMesh^>^	Meshes = gcnew List<NodeMesh^>();
+	cli::array<Node^>^	Nodes = _Owner->Nodes;
+	for ( int NodeIndex=0; NodeIndex < Nodes->Length; NodeIndex++ )
+	{
+		NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( Nodes[NodeIndex] );
+		if ( Mesh != nullptr && Mesh->TrianglesCount > 0 )
+			Meshes->Add( Mesh );
+	}
+	m_Meshes = Meshes->ToArray();
+
+	m_VertexOffsets = gcnew cli::array<int>( m_Meshes->Length+1 );
+	m_TriangleOffsets = gcnew cli::array<int>( m_Meshes->Length+1 );
+	for ( int MeshIndex=0; MeshIndex < m_Meshes->Length; MeshIndex++ )
+	{
+		m_VertexOffsets[MeshIndex+1] = m_VertexOffsets[MeshIndex] + m_Meshes[MeshIndex]->VerticesCount;
+		m_TriangleOffsets[MeshIndex+1] = m_TriangleOffsets[MeshIndex] + m_Meshes[MeshIndex]->TrianglesCount;
+	}
+
+	int	VerticesCount = m_VertexOffsets[m_Meshes->Length];
+	int	TrianglesCount = m_TriangleOffsets[m_Meshes->Length];
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Build the world space vertices & the scene-wide indices
+	cli::array<WMath::Matrix4x4^>^	MeshToWorld = gcnew cli::array<WMath::Matrix4x4^>( m_Meshes->Length );
+	for ( int MeshIndex=0; MeshIndex < m_Meshes->Length; MeshIndex++ )
+		MeshToWorld[MeshIndex] = ComputeMeshToWorld( m_Meshes[MeshIndex] );
+
+	System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+
+	cli::array<float>^	Vertices = TransformVertices( MeshToWorld );
+	cli::array<int>^	Indices = gcnew cli::array<int>( Math::Max( 1, 3 * TrianglesCount ) );
+	for ( int MeshIndex=0; MeshIndex < m_Meshes->Length; MeshIndex++ )
+	{
+		cli::array<NodeMesh::Triangle^>^	Triangles = m_Meshes[MeshIndex]->Triangles;
+		int	VertexOffset = m_VertexOffsets[MeshIndex];
+		int	TriangleOffset = m_TriangleOffsets[MeshIndex];
+		for ( int TriangleIndex=0; TriangleIndex < Triangles->Length; TriangleIndex++ )
+		{
+			Indices[3*(TriangleOffset+TriangleIndex)+0] = VertexOffset + Triangles[TriangleIndex]->Vertex0;
+			Indices[3*(TriangleOffset+TriangleIndex)+1] = VertexOffset + Triangles[TriangleIndex]->Vertex1;
+			Indices[3*(TriangleOffset+TriangleIndex)+2] = VertexOffset + Triangles[TriangleIndex]->Vertex2;
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Build the BVH, the subtrees being built in parallel
+	{
+		pin_ptr<float>	pVertices = &Vertices[0];
+		pin_ptr<int>	pIndices = &Indices[0];
+		m_pBVH = new TriangleBVH( pVertices, VerticesCount, pIndices, TrianglesCount );
+	}
+
+	int	JobsCount = m_pBVH->BeginBuild( 4 * Environment::ProcessorCount );
+
+	BVHBuildJob^	Job = gcnew BVHBuildJob();
+	Job->m_pBVH = m_pBVH;
+	if ( JobsCount == 1 )
+		Job->Execute( 0 );
+	else if ( JobsCount > 1 )
+		System::Threading::Tasks::Parallel::For( 0, JobsCount, gcnew Action<int>( Job, &BVHBuildJob::Execute ) );
+
+	m_pBVH->EndBuild();
+
+	Watch->Stop();
+	m_BuildTimeMilliseconds = Watch->Elapsed.TotalMilliseconds;
+}
+
+SceneBVH::~SceneBVH()
+{
+	this->!SceneBVH();
+}
+
+SceneBVH::!SceneBVH()
+{
+	delete m_pBVH;
+	m_pBVH = NULL;
+}
+
+void	SceneBVH::Refit()
+{
+	cli::array<WMath::Matrix4x4^>^	MeshToWorld = gcnew cli::array<WMath::Matrix4x4^>( m_Meshes->Length );
+	for ( int MeshIndex=0; MeshIndex < m_Meshes->Length; MeshIndex++ )
+		MeshToWorld[MeshIndex] = ComputeMeshToWorld( m_Meshes[MeshIndex] );
+
+	Refit( MeshToWorld );
+}
+
+void	SceneBVH::Refit( cli::array<WMath::Matrix4x4^>^ _MeshToWorld )
+{
+	if ( _MeshToWorld == nullptr || _MeshToWorld->Length != m_Meshes->Length )
+		throw gcnew Exception( "Expected " + m_Meshes->Length + " mesh transforms !" );
+
+	int	TrianglesCount = m_pBVH->GetTrianglesCount();
+	if ( TrianglesCount == 0 )
+		return;
+
+	cli::array<float>^	Vertices = TransformVertices( _MeshToWorld );
+	{
+		pin_ptr<float>	pVertices = &Vertices[0];
+		m_pBVH->UpdateVertices( pVertices, 0, m_pBVH->GetVerticesCount() );
+	}
+
+	int	JobsCount = (TrianglesCount + TRIANGLES_PER_REFIT_JOB - 1) / TRIANGLES_PER_REFIT_JOB;
+
+	BVHRefitJob^	Job = gcnew BVHRefitJob();
+	Job->m_pBVH = m_pBVH;
+	if ( JobsCount == 1 )
+		Job->Execute( 0 );
+	else
+		System::Threading::Tasks::Parallel::For( 0, JobsCount, gcnew Action<int>( Job, &BVHRefitJob::Execute ) );
+
+	m_pBVH->RefitNodes();
+}
+
+SceneBVH::Hit^	SceneBVH::IntersectClosest( WMath::Point^ _Origin, WMath::Vector^ _Direction, float _MaxDistance )
+{
+	float	pOrigin[3] = { _Origin->x, _Origin->y, _Origin->z };
+	float	pDirection[3] = { _Direction->x, _Direction->y, _Direction->z };
+
+	BVHHit	NativeHit;
+	if ( !m_pBVH->IntersectClosest( pOrigin, pDirection, _MaxDistance, NativeHit ) )
+		return	nullptr;
+
+	Hit^	Result = gcnew Hit();
+	Result->Mesh = GetMesh( NativeHit.TriangleIndex, Result->TriangleIndex );
+	Result->Distance = NativeHit.Distance;
+	Result->U = NativeHit.U;
+	Result->V = NativeHit.V;
+	Result->Position = gcnew WMath::Point( pOrigin[0] + NativeHit.Distance * pDirection[0], pOrigin[1] + NativeHit.Distance * pDirection[1], pOrigin[2] + NativeHit.Distance * pDirection[2] );
+
+	return	Result;
+}
+
+bool	SceneBVH::IntersectAny( WMath::Point^ _Origin, WMath::Vector^ _Direction, float _MaxDistance )
+{
+	float	pOrigin[3] = { _Origin->x, _Origin->y, _Origin->z };
+	float	pDirection[3] = { _Direction->x, _Direction->y, _Direction->z };
+
+	return	m_pBVH->IntersectAny( pOrigin, pDirection, _MaxDistance );
+}
+
+int		SceneBVH::IntersectRays( cli::array<float>^ _Origins, cli::array<float>^ _Directions, float _MaxDistance, cli::array<float>^ _Distances, cli::array<int>^ _TriangleIDs )
+{
+	if ( _Origins == nullptr || _Directions == nullptr || _Origins->Length != _Directions->Length || (_Origins->Length % 3) != 0 )
+		throw gcnew Exception( "Origins & directions must be given as 3 floats per ray !" );
+
+	int	RaysCount = _Origins->Length / 3;
+	if ( _Distances == nullptr || _Distances->Length < RaysCount || _TriangleIDs == nullptr || _TriangleIDs->Length < RaysCount )
+		throw gcnew Exception( "The result arrays are too small !" );
+	if ( RaysCount == 0 )
+		return	0;
+
+	pin_ptr<float>	pOrigins = &_Origins[0];
+	pin_ptr<float>	pDirections = &_Directions[0];
+	pin_ptr<float>	pDistances = &_Distances[0];
+	pin_ptr<int>	pTriangleIDs = &_TriangleIDs[0];
+
+	BVHRaysJob^	Job = gcnew BVHRaysJob();
+	Job->m_pBVH = m_pBVH;
+	Job->m_pOrigins = pOrigins;
+	Job->m_pDirections = pDirections;
+	Job->m_pDistances = pDistances;
+	Job->m_pTriangleIDs = pTriangleIDs;
+	Job->m_RaysCount = RaysCount;
+	Job->m_MaxDistance = _MaxDistance;
+	Job->m_HitsCount = 0;
+
+	int	JobsCount = (RaysCount + RAYS_PER_JOB - 1) / RAYS_PER_JOB;
+	if ( JobsCount == 1 )
+		Job->Execute( 0 );
+	else
+		System::Threading::Tasks::Parallel::For( 0, JobsCount, gcnew Action<int>( Job, &BVHRaysJob::Execute ) );
+
+	return	Job->m_HitsCount;
+}
+
+NodeMesh^	SceneBVH::GetMesh( int _TriangleID, int% _TriangleIndex )
+{
+	_TriangleIndex = -1;
+	if ( _TriangleID < 0 || _TriangleID >= m_TriangleOffsets[m_Meshes->Length] )
+		return	nullptr;
+
+	// Binary search the mesh owning the triangle
+	int	Min = 0;
+	int	Max = m_Meshes->Length - 1;
+	while ( Min < Max )
+	{
+		int	Mid = (Min + Max + 1) / 2;
+		if ( m_TriangleOffsets[Mid] <= _TriangleID )
+			Min = Mid;
+		else
+			Max = Mid - 1;
+	}
+
+	_TriangleIndex = _TriangleID - m_TriangleOffsets[Min];
+	return	m_Meshes[Min];
+}
+
+SceneBVH::BenchmarkResult^	SceneBVH::Benchmark( int _RaysCount )
+{
+	if ( _RaysCount <= 0 )
+		throw gcnew Exception( "Invalid benchmark parameters !" );
+
+	BenchmarkResult^	Result = gcnew BenchmarkResult();
+	Result->TrianglesCount = m_pBVH->GetTrianglesCount();
+	Result->NodesCount = m_pBVH->GetNodesCount();
+	Result->Depth = m_pBVH->GetDepth();
+	Result->BuildTimeMilliseconds = m_BuildTimeMilliseconds;
+	if ( Result->NodesCount == 0 )
+		return	Result;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Generate random rays starting inside the scene's bounds
+	// Packets of 4 consecutive rays share their origin and have jittered directions so they're coherent
+	_RaysCount = (_RaysCount + 3) & ~3;
+
+	const BVHNode&	Root = m_pBVH->GetNodes()[0];
+	float			Diagonal = (float) Math::Sqrt( (Root.Max[0] - Root.Min[0]) * (Root.Max[0] - Root.Min[0]) + (Root.Max[1] - Root.Min[1]) * (Root.Max[1] - Root.Min[1]) + (Root.Max[2] - Root.Min[2]) * (Root.Max[2] - Root.Min[2]) );
+	float			MaxDistance = 2.0f * Diagonal + 1.0f;
+
+	Random^				RNG = gcnew Random( 1 );
+	cli::array<float>^	Origins = gcnew cli::array<float>( 3 * _RaysCount );
+	cli::array<float>^	Directions = gcnew cli::array<float>( 3 * _RaysCount );
+	for ( int PacketStart=0; PacketStart < _RaysCount; PacketStart+=4 )
+	{
+		float	Origin[3];
+		float	Direction[3];
+		for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+		{
+			Origin[ComponentIndex] = Root.Min[ComponentIndex] + (float) RNG->NextDouble() * (Root.Max[ComponentIndex] - Root.Min[ComponentIndex]);
+			Direction[ComponentIndex] = (float) (2.0 * RNG->NextDouble() - 1.0);
+		}
+
+		for ( int RayIndex=0; RayIndex < 4; RayIndex++ )
+			for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+			{
+				Origins[3*(PacketStart+RayIndex)+ComponentIndex] = Origin[ComponentIndex];
+				Directions[3*(PacketStart+RayIndex)+ComponentIndex] = Direction[ComponentIndex] + (float) (0.02 * RNG->NextDouble() - 0.01);
+			}
+	}
+
+	cli::array<float>^	Distances = gcnew cli::array<float>( _RaysCount );
+	cli::array<int>^	TriangleIDs = gcnew cli::array<int>( _RaysCount );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Single rays
+	{
+		pin_ptr<float>	PinnedOrigins = &Origins[0];
+		pin_ptr<float>	PinnedDirections = &Directions[0];
+		const float*	pOrigins = PinnedOrigins;
+		const float*	pDirections = PinnedDirections;
+		BVHHit			NativeHit;
+
+		// Warm up then measure
+		m_pBVH->IntersectClosest( pOrigins, pDirections, MaxDistance, NativeHit );
+
+		System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+		for ( int RayIndex=0; RayIndex < _RaysCount; RayIndex++ )
+			m_pBVH->IntersectClosest( pOrigins + 3*RayIndex, pDirections + 3*RayIndex, MaxDistance, NativeHit );
+		Watch->Stop();
+		Result->ClosestHitMRaysPerSecond = _RaysCount / Math::Max( 1e-6, 1000.0 * Watch->Elapsed.TotalMilliseconds );
+
+		Watch = System::Diagnostics::Stopwatch::StartNew();
+		for ( int RayIndex=0; RayIndex < _RaysCount; RayIndex++ )
+			m_pBVH->IntersectAny( pOrigins + 3*RayIndex, pDirections + 3*RayIndex, MaxDistance );
+		Watch->Stop();
+		Result->AnyHitMRaysPerSecond = _RaysCount / Math::Max( 1e-6, 1000.0 * Watch->Elapsed.TotalMilliseconds );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Packets on a single thread
+	{
+		pin_ptr<float>	pOrigins = &Origins[0];
+		pin_ptr<float>	pDirections = &Directions[0];
+		pin_ptr<float>	pDistances = &Distances[0];
+		pin_ptr<int>	pTriangleIDs = &TriangleIDs[0];
+
+		BVHRaysJob^	Job = gcnew BVHRaysJob();
+		Job->m_pBVH = m_pBVH;
+		Job->m_pOrigins = pOrigins;
+		Job->m_pDirections = pDirections;
+		Job->m_pDistances = pDistances;
+		Job->m_pTriangleIDs = pTriangleIDs;
+		Job->m_RaysCount = _RaysCount;
+		Job->m_MaxDistance = MaxDistance;
+		Job->m_HitsCount = 0;
+
+		int	JobsCount = (_RaysCount + RAYS_PER_JOB - 1) / RAYS_PER_JOB;
+
+		System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+		for ( int JobIndex=0; JobIndex < JobsCount; JobIndex++ )
+			Job->Execute( JobIndex );
+		Watch->Stop();
+		Result->PacketMRaysPerSecond = _RaysCount / Math::Max( 1e-6, 1000.0 * Watch->Elapsed.TotalMilliseconds );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 4] Packets on all the cores
+	{
+		System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+		IntersectRays( Origins, Directions, MaxDistance, Distances, TriangleIDs );
+		Watch->Stop();
+		Result->ParallelMRaysPerSecond = _RaysCount / Math::Max( 1e-6, 1000.0 * Watch->Elapsed.TotalMilliseconds );
+	}
+
+	return	Result;
+}
+
+WMath::Matrix4x4^	SceneBVH::ComputeMeshToWorld( NodeMesh^ _Mesh )
+{
+	return	_Mesh->Pivot * _Mesh->WorldTransform;
+}
+
+cli::array<float>^	SceneBVH::TransformVertices( cli::array<WMath::Matrix4x4^>^ _MeshToWorld )
+{
+	cli::array<float>^	Result = gcnew cli::array<float>( Math::Max( 1, 3 * m_VertexOffsets[m_Meshes->Length] ) );
+	for ( int MeshIndex=0; MeshIndex < m_Meshes->Length; MeshIndex++ )
+	{
+		cli::array<float,2>^		M = _MeshToWorld[MeshIndex]->m;
+		cli::array<WMath::Point^>^	Vertices = m_Meshes[MeshIndex]->Vertices;
+		int							Offset = 3 * m_VertexOffsets[MeshIndex];
+		for ( int VertexIndex=0; VertexIndex < Vertices->Length; VertexIndex++ )
+		{
+			WMath::Point^	P = Vertices[VertexIndex];
+			Result[Offset++] = P->x * M[0,0] + P->y * M[1,0] + P->z * M[2,0] + M[3,0];
+			Result[Offset++] = P->x * M[0,1] + P->y * M[1,1] + P->z * M[2,1] + M[3,1];
+			Result[Offset++] = P->x * M[0,2] + P->y * M[1,2] + P->z * M[2,2] + M[3,2];
+		}
+	}
+
+	return	Result;
+}
@@ -0,0 +1,160 @@
+// Contains the scene-wide BVH used for ray queries against all the meshes of a scene
+//
+#pragma managed
+#pragma once
+
+#include "TriangleBVH.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	ref class	Scene;
+	ref class	NodeMesh;
+
+	//////////////////////////////////////////////////////////////////////////
+	// A bounding volume hierarchy over the world-space triangles of all the meshes of a scene
+	// A mesh's vertices are transformed by Pivot * WorldTransform, the world transform coming from the scene's SceneTransforms.
+	//
+	// The BVH is built with a binned SAH, the subtrees being built in parallel on the thread pool.
+	// Triangles are identified by a scene-wide index that GetMesh() converts back into a mesh and a triangle of that mesh.
+	//
+	// When nodes move without changing topology, Refit() updates the bounds in place which is much cheaper than a rebuild
+	//	(although the tree quality slowly degrades if the motion is large).
+	//
+	public ref class		SceneBVH
+	{
+	public:		// NESTED TYPES
+
+		literal int		TRIANGLES_PER_REFIT_JOB = 16384;
+		literal int		RAYS_PER_JOB = 1024;
+
+		// The result of a closest hit query
+		ref class	Hit
+		{
+		public:
+
+			NodeMesh^		Mesh;
+			int				TriangleIndex;	// Index of the triangle in the mesh's Triangles
+			float			Distance;		// Distance along the ray, in units of the ray direction's length
+			float			U, V;			// Barycentric coordinates of the hit relative to the triangle's Vertex1 & Vertex2
+			WMath::Point^	Position;		// World space position of the hit
+		};
+
+		// The result of a benchmark
+		ref class	BenchmarkResult
+		{
+		public:
+
+			int			TrianglesCount;
+			int			NodesCount;
+			int			Depth;
+			double		BuildTimeMilliseconds;
+			double		ClosestHitMRaysPerSecond;	// Single rays, single thread
+			double		AnyHitMRaysPerSecond;		// Single rays, single thread
+			double		PacketMRaysPerSecond;		// Coherent packets of 4 rays, single thread
+			double		ParallelMRaysPerSecond;		// Coherent packets of 4 rays on all the cores
+
+			virtual String^	ToString() override
+			{
+				return	String::Format( "{0} triangles, {1} nodes, depth {2}, built in {3:F1} ms | closest {4:F2} Mrays/s, any {5:F2} Mrays/s, packets {6:F2} Mrays/s, parallel {7:F2} Mrays/s",
+					TrianglesCount, NodesCount, Depth, BuildTimeMilliseconds, ClosestHitMRaysPerSecond, AnyHitMRaysPerSecond, PacketMRaysPerSecond, ParallelMRaysPerSecond );
+			}
+		};
+
+	protected:	// FIELDS
+
+		Scene^						m_Owner;
+		cli::array<NodeMesh^>^		m_Meshes;
+		cli::array<int>^			m_VertexOffsets;	// Offset of each mesh's vertices (MeshesCount+1 entries)
+		cli::array<int>^			m_TriangleOffsets;	// Offset of each mesh's triangles (MeshesCount+1 entries)
+
+		TriangleBVH*				m_pBVH;
+		double						m_BuildTimeMilliseconds;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the scene the BVH was built from" )]
+		//
+		property Scene^						Owner
+		{
+			Scene^						get()	{ return m_Owner; }
+		}
+
+		[DescriptionAttribute( "Gets the meshes referenced by the BVH" )]
+		//
+		property cli::array<NodeMesh^>^		Meshes
+		{
+			cli::array<NodeMesh^>^		get()	{ return m_Meshes; }
+		}
+
+		[DescriptionAttribute( "Gets the total amount of triangles in the BVH" )]
+		//
+		property int						TrianglesCount
+		{
+			int							get()	{ return m_pBVH->GetTrianglesCount(); }
+		}
+
+		[DescriptionAttribute( "Gets the amount of nodes in the BVH" )]
+		//
+		property int						NodesCount
+		{
+			int							get()	{ return m_pBVH->GetNodesCount(); }
+		}
+
+		[DescriptionAttribute( "Gets the depth of the BVH" )]
+		//
+		property int						Depth
+		{
+			int							get()	{ return m_pBVH->GetDepth(); }
+		}
+
+		[DescriptionAttribute( "Gets the time it took to build the BVH (in milliseconds)" )]
+		//
+		property double						BuildTimeMilliseconds
+		{
+			double						get()	{ return m_BuildTimeMilliseconds; }
+		}
+
+	public:		// METHODS
+
+		SceneBVH( Scene^ _Owner );
+		~SceneBVH();
+		!SceneBVH();
+
+		// Updates the BVH with the current world transforms of the nodes
+		void		Refit();
+
+		// Updates the BVH with explicit mesh to world transforms (one per mesh in Meshes)
+		void		Refit( cli::array<WMath::Matrix4x4^>^ _MeshToWorld );
+
+		// Finds the closest triangle hit by a ray within [0,_MaxDistance] (returns null if nothing is hit)
+		Hit^		IntersectClosest( WMath::Point^ _Origin, WMath::Vector^ _Direction, float _MaxDistance );
+
+		// Tells if any triangle is hit by a ray within [0,_MaxDistance] (e.g. shadow or visibility rays)
+		bool		IntersectAny( WMath::Point^ _Origin, WMath::Vector^ _Direction, float _MaxDistance );
+
+		// Traces a batch of rays in parallel, by packets of 4
+		//	_Origins & _Directions, 3 floats per ray
+		//	_Distances, receives the distance to the closest hit of each ray (or _MaxDistance if nothing is hit)
+		//	_TriangleIDs, receives the scene-wide triangle index of each hit (or -1 if nothing is hit)
+		// Returns the amount of rays that hit something
+		int			IntersectRays( cli::array<float>^ _Origins, cli::array<float>^ _Directions, float _MaxDistance, cli::array<float>^ _Distances, cli::array<int>^ _TriangleIDs );
+
+		// Converts a scene-wide triangle index into a mesh and the index of the triangle in that mesh
+		NodeMesh^	GetMesh( int _TriangleID, int% _TriangleIndex );
+
+		// Measures the BVH build time and the ray throughput of the various queries with _RaysCount random rays
+		BenchmarkResult^	Benchmark( int _RaysCount );
+
+	protected:
+
+		// Computes the mesh to world transform of a mesh from the scene's cached transform hierarchy
+		static WMath::Matrix4x4^	ComputeMeshToWorld( NodeMesh^ _Mesh );
+
+		// Transforms the vertices of all the meshes into a single flat array
+		cli::array<float>^			TransformVertices( cli::array<WMath::Matrix4x4^>^ _MeshToWorld );
+	};
+}
@@ -0,0 +1,222 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "SceneBatchLoader.h"
+#include "Scene.h"
+
+using namespace	FBXImporter;
+using namespace	System::Threading;
+
+namespace FBXImporter
+{
+	// Sorts results by decreasing file size
+	ref class	LargestFileFirst : public IComparer<SceneBatchLoader::Result^>
+	{
+	public:
+
+		virtual int	Compare( SceneBatchLoader::Result^ _A, SceneBatchLoader::Result^ _B )
+		{
+			return _B->FileSize.CompareTo( _A->FileSize );
+		}
+	};
+}
+
+SceneBatchLoader::SceneBatchLoader()
+{
+	m_Options = gcnew ImportOptions();
+	m_MaxConcurrency = Environment::ProcessorCount;
+	m_MemoryCapMB = 0;
+	m_MemoryFactor = DEFAULT_MEMORY_FACTOR;
+	m_bDisposeLoadedScenes = false;
+
+	m_Pending = gcnew List<Result^>();
+	m_InFlightBytes = 0;
+	m_InFlightCount = 0;
+	m_PeakConcurrency = 0;
+	m_PeakInFlightBytes = 0;
+	m_TotalMilliseconds = 0.0;
+}
+
+cli::array<SceneBatchLoader::Result^>^	SceneBatchLoader::Load( cli::array<String^>^ _FileNames )
+{
+	return Load( _FileNames, nullptr, CancellationToken::None );
+}
+
+cli::array<SceneBatchLoader::Result^>^	SceneBatchLoader::Load( cli::array<String^>^ _FileNames, LoadedHandler^ _Loaded, CancellationToken _Cancellation )
+{
+	if ( _FileNames == nullptr )
+		throw gcnew Exception( "Invalid file names !" );
+
+	System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Build the results and queue them largest first
+	cli::array<Result^>^	Results = gcnew cli::array<Result^>( _FileNames->Length );
+	for ( int FileIndex=0; FileIndex < _FileNames->Length; FileIndex++ )
+	{
+		Result^	R = gcnew Result();
+		R->FileName = _FileNames[FileIndex];
+		R->FileSize = 0;
+		R->Milliseconds = 0.0;
+		try
+		{
+			System::IO::FileInfo^	Info = gcnew System::IO::FileInfo( R->FileName );
+			if ( Info->Exists )
+				R->FileSize = Info->Length;
+		}
+		catch ( Exception^ )
+		{	// Invalid paths fail when loaded
+		}
+		Results[FileIndex] = R;
+	}
+
+	m_Pending->Clear();
+	m_Pending->AddRange( Results );
+	m_Pending->Sort( gcnew LargestFileFirst() );
+
+	m_InFlightBytes = 0;
+	m_InFlightCount = 0;
+	m_PeakConcurrency = 0;
+	m_PeakInFlightBytes = 0;
+	m_Loaded = _Loaded;
+	m_Cancellation = _Cancellation;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Run the workers until the queue is empty
+	try
+	{
+		int	WorkersCount = Math::Min( m_MaxConcurrency, Results->Length );
+		cli::array<Thread^>^	Workers = gcnew cli::array<Thread^>( WorkersCount );
+		for ( int WorkerIndex=0; WorkerIndex < WorkersCount; WorkerIndex++ )
+		{
+			Thread^	Worker = gcnew Thread( gcnew ThreadStart( this, &SceneBatchLoader::WorkerLoop ) );
+			Worker->Name = "FBX Batch Loader #" + WorkerIndex;
+			Worker->IsBackground = true;
+			Worker->Start();
+			Workers[WorkerIndex] = Worker;
+		}
+
+		for ( int WorkerIndex=0; WorkerIndex < WorkersCount; WorkerIndex++ )
+			Workers[WorkerIndex]->Join();
+	}
+	finally
+	{
+		m_Loaded = nullptr;
+		m_Cancellation = CancellationToken::None;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Files that were never taken were canceled
+	for each ( Result^ R in m_Pending )
+		R->Error = gcnew OperationCanceledException( _Cancellation );
+	m_Pending->Clear();
+
+	m_TotalMilliseconds = Watch->Elapsed.TotalMilliseconds;
+
+	return Results;
+}
+
+SceneBatchLoader::Result^	SceneBatchLoader::TakeNext()
+{
+	Monitor::Enter( m_Pending );
+	try
+	{
+		__int64	CapBytes = (__int64) m_MemoryCapMB << 20;
+		while ( true )
+		{
+			if ( m_Pending->Count == 0 || m_Cancellation.IsCancellationRequested )
+				return nullptr;
+
+			// Take the largest file that fits (always the largest one when nothing is in flight)
+			int	PendingIndex = -1;
+			if ( CapBytes <= 0 || m_InFlightCount == 0 )
+				PendingIndex = 0;
+			else
+			{
+				for ( int Index=0; Index < m_Pending->Count; Index++ )
+					if ( m_InFlightBytes + EstimateBytes( m_Pending[Index] ) <= CapBytes )
+					{
+						PendingIndex = Index;
+						break;
+					}
+			}
+
+			if ( PendingIndex < 0 )
+			{	// Wait for a load in flight to complete (cancellation is checked on every completion)
+				Monitor::Wait( m_Pending );
+				continue;
+			}
+
+			Result^	Next = m_Pending[PendingIndex];
+			m_Pending->RemoveAt( PendingIndex );
+
+			m_InFlightBytes += EstimateBytes( Next );
+			m_InFlightCount++;
+			m_PeakConcurrency = Math::Max( m_PeakConcurrency, m_InFlightCount );
+			m_PeakInFlightBytes = Math::Max( m_PeakInFlightBytes, m_InFlightBytes );
+
+			return Next;
+		}
+	}
+	finally
+	{
+		Monitor::Exit( m_Pending );
+	}
+}
+
+void	SceneBatchLoader::WorkerLoop()
+{
+	while ( true )
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// 1] Wait for a file that fits within the memory cap
+		Result^	R = TakeNext();
+		if ( R == nullptr )
+			return;
+
+		//////////////////////////////////////////////////////////////////////////
+		// 2] Load it into its own scene
+		System::Diagnostics::Stopwatch^	Watch = System::Diagnostics::Stopwatch::StartNew();
+		Scene^	LoadedScene = gcnew Scene();
+		try
+		{
+			LoadedScene->Options = m_Options;
+			LoadedScene->Load( R->FileName, nullptr, m_Cancellation );
+			R->Scene = LoadedScene;
+		}
+		catch ( Exception^ _e )
+		{
+			R->Error = _e;
+			delete LoadedScene;
+		}
+		R->Milliseconds = Watch->Elapsed.TotalMilliseconds;
+
+		//////////////////////////////////////////////////////////////////////////
+		// 3] Notify the load
+		try
+		{
+			if ( m_Loaded != nullptr )
+				m_Loaded( this, R );
+		}
+		catch ( Exception^ _e )
+		{	// Don't let the callback kill the worker
+			if ( R->Error == nullptr )
+				R->Error = _e;
+		}
+		finally
+		{
+			if ( m_bDisposeLoadedScenes && R->Scene != nullptr )
+			{
+				delete R->Scene;
+				R->Scene = nullptr;
+			}
+
+			Monitor::Enter( m_Pending );
+			m_InFlightBytes -= EstimateBytes( R );
+			m_InFlightCount--;
+			Monitor::PulseAll( m_Pending );
+			Monitor::Exit( m_Pending );
+		}
+	}
+}
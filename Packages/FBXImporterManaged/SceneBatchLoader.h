@@ -0,0 +1,155 @@
+// Contains the loader importing several files in parallel
+//
+#pragma managed
+#pragma once
+
+#include "ImportOptions.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	ref class	Scene;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Imports several files in parallel, each into its own scene
+	// Every load gets its own importer, SDK scene and SDK manager leased from the SDKManagerPool so loads never share SDK objects.
+	//
+	// Files are loaded largest first by a fixed amount of workers so the longest loads don't end up running alone at the end of the batch.
+	// The memory used by a load is estimated from the size of its file and a load only starts when the estimates of all the loads
+	//	in flight fit within the memory cap. A file is always loaded when nothing else is in flight, even if its estimate alone exceeds the cap.
+	//
+	public ref class	SceneBatchLoader
+	{
+	public:		// NESTED TYPES
+
+		// The outcome of the load of a single file
+		[System::Diagnostics::DebuggerDisplayAttribute( "{FileName} {Milliseconds} ms Error={Error}" )]
+		ref class	Result
+		{
+		public:
+
+			String^		FileName;
+			__int64		FileSize;		// The size of the file (in bytes, 0 if it doesn't exist)
+			Scene^		Scene;			// The loaded scene (null if the load failed or the scene was disposed of after the Loaded callback)
+			Exception^	Error;			// The reason of the failure (null on success, OperationCanceledException if the batch was canceled before the file was loaded)
+			double		Milliseconds;	// The time spent loading the file
+		};
+
+		// Notifies the load of a file (successful or not)
+		// NOTE: This is called on the worker thread that loaded the file
+		delegate void	LoadedHandler( SceneBatchLoader^ _Loader, Result^ _Result );
+
+		// The default amount of bytes a load is estimated to use per byte of file
+		literal float	DEFAULT_MEMORY_FACTOR = 8.0f;
+
+	protected:	// FIELDS
+
+		ImportOptions^				m_Options;
+		int							m_MaxConcurrency;
+		int							m_MemoryCapMB;
+		float						m_MemoryFactor;
+		bool						m_bDisposeLoadedScenes;
+
+		// Batch state (the pending list is used to lock the fields below)
+		List<Result^>^				m_Pending;
+		__int64						m_InFlightBytes;
+		int							m_InFlightCount;
+		int							m_PeakConcurrency;
+		__int64						m_PeakInFlightBytes;
+		LoadedHandler^				m_Loaded;
+		System::Threading::CancellationToken	m_Cancellation;
+
+		double						m_TotalMilliseconds;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets or sets the options every file is imported with" )]
+		//
+		property ImportOptions^		Options
+		{
+			ImportOptions^			get()	{ return m_Options; }
+			void					set( ImportOptions^ _Value )	{ m_Options = _Value != nullptr ? _Value : gcnew ImportOptions(); }
+		}
+
+		[DescriptionAttribute( "Gets or sets the maximum amount of files loaded at the same time (defaults to the amount of processors)" )]
+		//
+		property int				MaxConcurrency
+		{
+			int						get()	{ return m_MaxConcurrency; }
+			void					set( int _Value )	{ m_MaxConcurrency = Math::Max( 1, _Value ); }
+		}
+
+		[DescriptionAttribute( "Gets or sets the estimated memory the loads in flight must fit within (in MB, 0 for no limit)" )]
+		//
+		property int				MemoryCapMB
+		{
+			int						get()	{ return m_MemoryCapMB; }
+			void					set( int _Value )	{ m_MemoryCapMB = Math::Max( 0, _Value ); }
+		}
+
+		[DescriptionAttribute( "Gets or sets the amount of bytes a load is estimated to use per byte of file (e.g. binary files expand more than ASCII ones)" )]
+		//
+		property float				MemoryFactor
+		{
+			float					get()	{ return m_MemoryFactor; }
+			void					set( float _Value )	{ m_MemoryFactor = Math::Max( 0.0f, _Value ); }
+		}
+
+		[DescriptionAttribute( "If true, the scenes are disposed of after the Loaded callback returns so only one scene per worker is alive at any time (results then have no scene)" )]
+		//
+		property bool				DisposeLoadedScenes
+		{
+			bool					get()	{ return m_bDisposeLoadedScenes; }
+			void					set( bool _Value )	{ m_bDisposeLoadedScenes = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets the largest amount of files that were loaded at the same time during the last batch" )]
+		//
+		property int				PeakConcurrency
+		{
+			int						get()	{ return m_PeakConcurrency; }
+		}
+
+		[DescriptionAttribute( "Gets the largest estimated memory of the loads in flight during the last batch (in bytes)" )]
+		//
+		property __int64			PeakInFlightBytes
+		{
+			__int64					get()	{ return m_PeakInFlightBytes; }
+		}
+
+		[DescriptionAttribute( "Gets the wall-clock time of the last batch (in milliseconds)" )]
+		//
+		property double				TotalMilliseconds
+		{
+			double					get()	{ return m_TotalMilliseconds; }
+		}
+
+	public:		// METHODS
+
+		SceneBatchLoader();
+
+		// Loads the files and returns their results in the order of the provided file names
+		// Failed loads don't stop the batch, their error is stored in their result.
+		//
+		cli::array<Result^>^	Load( cli::array<String^>^ _FileNames );
+
+		// Loads the files, notifying each load as soon as it completes
+		//	_Loaded, an optional callback called on the worker thread once a file is loaded (see DisposeLoadedScenes)
+		//	_Cancellation, if cancellation is requested the loads in flight are canceled and the remaining files are not loaded
+		//
+		cli::array<Result^>^	Load( cli::array<String^>^ _FileNames, LoadedHandler^ _Loaded, System::Threading::CancellationToken _Cancellation );
+
+	protected:
+
+		// Takes the next file that fits within the memory cap, waiting for loads in flight to complete if needed (null once the batch is over)
+		Result^		TakeNext();
+
+		// The loop of a worker
+		void		WorkerLoop();
+
+		__int64		EstimateBytes( Result^ _Result )	{ return (__int64) (_Result->FileSize * (double) m_MemoryFactor); }
+	};
+}
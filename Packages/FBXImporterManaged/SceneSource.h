@@ -0,0 +1,162 @@
+// Contains the SDK-independent interface native scene sources (OBJ & PLY files, synthetic scenes) are read through
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Describes a node of the source scene
+	//
+	struct	SourceNode
+	{
+		enum	TYPE
+		{
+			TYPE_GENERIC,
+			TYPE_MESH,
+			TYPE_CAMERA,
+			TYPE_LIGHT,
+			TYPE_SKELETON,
+		};
+
+		const char*	pName;				// Valid for the lifetime of the source
+		int			ParentIndex;		// -1 for the root
+		TYPE		Type;
+		float		Translation[3];		// Static local transform (used for channels that are not animated)
+		float		Rotation[3];		// Euler angles in degrees, applied in X, Y, Z order
+		float		Scaling[3];
+		int			MaterialsCount;		// Amount of material slots of the node
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Describes the sizes of the mesh of a node
+	//
+	struct	SourceMesh
+	{
+		int		ControlPointsCount;
+		int		PolygonsCount;
+		int		PolygonVerticesCount;	// Sum of the sizes of all the polygons
+		int		LayerElementsCount;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Describes a layer element of a mesh (i.e. an array of values mapped onto the polygons)
+	//
+	struct	SourceLayerElement
+	{
+		enum	TYPE
+		{
+			TYPE_NORMAL,
+			TYPE_TANGENT,
+			TYPE_BINORMAL,
+			TYPE_UV,
+			TYPE_VERTEX_COLOR,
+			TYPE_MATERIAL,			// Only has indices, into the material slots of the node
+		};
+
+		enum	MAPPING
+		{
+			MAPPING_BY_CONTROL_POINT,
+			MAPPING_BY_POLYGON_VERTEX,
+			MAPPING_BY_POLYGON,
+			MAPPING_ALL_SAME,
+		};
+
+		enum	REFERENCE
+		{
+			REFERENCE_DIRECT,
+			REFERENCE_INDEX_TO_DIRECT,
+		};
+
+		TYPE		Type;
+		MAPPING		Mapping;
+		REFERENCE	Reference;
+		int			Channel;			// Index of the element among the elements of the same type (e.g. the UV set)
+		int			ComponentsCount;	// Floats per value (3 for vectors, 2 for UVs, 4 for colors, 0 for materials)
+		int			ValuesCount;		// Amount of direct values
+		int			IndicesCount;		// Amount of indices (0 for DIRECT references)
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Describes a material of the source scene
+	//
+	struct	SourceMaterial
+	{
+		const char*	pName;
+		float		DiffuseColor[3];
+		float		DiffuseFactor;
+		float		EmissiveColor[3];
+		float		EmissiveFactor;
+		float		SpecularColor[3];
+		float		SpecularFactor;
+		float		Shininess;
+		float		Opacity;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Describes an animation curve of a node (keys are linearly interpolated)
+	//
+	struct	SourceCurve
+	{
+		enum	CHANNEL
+		{
+			CHANNEL_TRANSLATION_X,
+			CHANNEL_TRANSLATION_Y,
+			CHANNEL_TRANSLATION_Z,
+			CHANNEL_ROTATION_X,
+			CHANNEL_ROTATION_Y,
+			CHANNEL_ROTATION_Z,
+			CHANNEL_SCALING_X,
+			CHANNEL_SCALING_Y,
+			CHANNEL_SCALING_Z,
+
+			CHANNELS_COUNT,
+		};
+
+		CHANNEL	Channel;
+		int		KeysCount;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// The scene data of a source that isn't read by the FBX SDK (mesh files, synthetic generator, etc.)
+	//
+	// Sources are consumed by FBXSceneBuilder, which builds them into an SDK scene so they go through the regular scene reading path,
+	//	and by the SceneSourceBenchmark tool. FBX files are read by Scene & NodeMesh directly from the SDK, not through this interface.
+	// NOTE: FBXSceneBuilder only builds nodes, materials & meshes, the curves are only read by the benchmark.
+	//
+	// Nodes are listed depth-first, parents before their children, the root node being node 0.
+	// Bulk data are copied into arrays allocated by the caller so reading a mesh only costs a few virtual calls.
+	// Values are given as they are stored by the source (i.e. no axis conversion).
+	//
+	class	SceneSource
+	{
+	public:		// METHODS
+
+		virtual ~SceneSource()	{}
+
+		// Nodes
+		virtual int		GetNodesCount() const = 0;
+		virtual void	GetNode( int _NodeIndex, SourceNode& _Node ) const = 0;
+		virtual int		GetNodeMaterial( int _NodeIndex, int _SlotIndex ) const = 0;	// Index of the scene material in the given slot (-1 if none)
+
+		// Materials
+		virtual int		GetMaterialsCount() const = 0;
+		virtual void	GetMaterial( int _MaterialIndex, SourceMaterial& _Material ) const = 0;
+
+		// Meshes (only for nodes of type TYPE_MESH)
+		virtual void	GetMesh( int _NodeIndex, SourceMesh& _Mesh ) const = 0;
+		// _pPositions receives 3 floats per control point
+		virtual void	GetControlPoints( int _NodeIndex, float* _pPositions ) const = 0;
+		// _pPolygonSizes receives the amount of vertices of each polygon, _pPolygonVertices the control point index of each polygon vertex
+		virtual void	GetPolygons( int _NodeIndex, int* _pPolygonSizes, int* _pPolygonVertices ) const = 0;
+		virtual void	GetLayerElement( int _NodeIndex, int _ElementIndex, SourceLayerElement& _Element ) const = 0;
+		// _pValues receives ComponentsCount floats per value, _pIndices receives IndicesCount indices (both may be NULL when empty)
+		virtual void	GetLayerElementData( int _NodeIndex, int _ElementIndex, float* _pValues, int* _pIndices ) const = 0;
+
+		// Animation
+		virtual float	GetAnimationDuration() const = 0;	// In seconds (0 if the scene is not animated)
+		virtual int		GetCurvesCount( int _NodeIndex ) const = 0;
+		virtual void	GetCurve( int _NodeIndex, int _CurveIndex, SourceCurve& _Curve ) const = 0;
+		// _pTimes receives the time of each key in seconds, _pValues its value (rotations in degrees)
+		virtual void	GetCurveKeys( int _NodeIndex, int _CurveIndex, float* _pTimes, float* _pValues ) const = 0;
+	};
+}
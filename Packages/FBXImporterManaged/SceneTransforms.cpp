@@ -0,0 +1,227 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "SceneTransforms.h"
+#include "NodeMesh.h"
+#include "Scene.h"
+
+using namespace	FBXImporter;
+
+SceneTransforms::SceneTransforms( Scene^ _Owner ) : m_Owner( _Owner ), m_pHierarchy( NULL )
+{
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Flatten the hierarchy in depth-first order
+	List<Node^>^	Nodes = gcnew List<Node^>();
+	List<int>^		Parents = gcnew List<int>();
+	m_Node2Index = gcnew Dictionary<Node^,int>();
+
+	Stack<Node^>^	PendingNodes = gcnew Stack<Node^>();
+	if ( _Owner->RootNode != nullptr )
+		PendingNodes->Push( _Owner->RootNode );
+
+	while ( PendingNodes->Count > 0 )
+	{
+		Node^	Current = PendingNodes->Pop();
+		int		ParentIndex = -1;
+		if ( Current->Parent != nullptr && !m_Node2Index->TryGetValue( Current->Parent, ParentIndex ) )
+			ParentIndex = -1;
+
+		m_Node2Index[Current] = Nodes->Count;
+		Nodes->Add( Current );
+		Parents->Add( ParentIndex );
+
+		// Push children in reverse order so they're stored in their original order
+		cli::array<Node^>^	Children = Current->Children;
+		for ( int ChildIndex=Children->Length-1; ChildIndex >= 0; ChildIndex-- )
+			PendingNodes->Push( Children[ChildIndex] );
+	}
+	m_Nodes = Nodes->ToArray();
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Create the native hierarchy and read the local transforms & bounds
+	cli::array<int>^	ParentsArray = Parents->ToArray();
+	{
+		pin_ptr<int>	pParents = nullptr;
+		if ( ParentsArray->Length > 0 )
+			pParents = &ParentsArray[0];
+		m_pHierarchy = new TransformHierarchy( pParents, m_Nodes->Length );
+	}
+
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Length; NodeIndex++ )
+		ReadNode( NodeIndex );
+
+	m_WorldCache = gcnew cli::array<WMath::Matrix4x4^>( m_Nodes->Length );
+	m_WorldCacheGenerations = gcnew cli::array<int>( m_Nodes->Length );
+	m_BoundsCache = gcnew cli::array<WMath::BoundingBox^>( m_Nodes->Length );
+	m_BoundsCacheGenerations = gcnew cli::array<int>( m_Nodes->Length );
+	for ( int NodeIndex=0; NodeIndex < m_Nodes->Length; NodeIndex++ )
+	{
+		m_WorldCacheGenerations[NodeIndex] = -1;
+		m_BoundsCacheGenerations[NodeIndex] = -1;
+	}
+}
+
+SceneTransforms::~SceneTransforms()
+{
+	this->!SceneTransforms();
+}
+
+SceneTransforms::!SceneTransforms()
+{
+	delete m_pHierarchy;
+	m_pHierarchy = NULL;
+}
+
+int		SceneTransforms::IndexOf( Node^ _Node )
+{
+	int	Result = -1;
+	if ( _Node == nullptr || !m_Node2Index->TryGetValue( _Node, Result ) )
+		return	-1;
+
+	return	Result;
+}
+
+void	SceneTransforms::SetLocalTransform( Node^ _Node, WMath::Matrix4x4^ _LocalTransform )
+{
+	SetLocalTransform( GetIndexChecked( _Node ), _LocalTransform );
+}
+
+void	SceneTransforms::SetLocalTransform( int _NodeIndex, WMath::Matrix4x4^ _LocalTransform )
+{
+	if ( _NodeIndex < 0 || _NodeIndex >= m_Nodes->Length )
+		throw gcnew Exception( "Node index out of range !" );
+
+	float	pLocal[16];
+	ToFloats( _LocalTransform, pLocal );
+	m_pHierarchy->SetLocal( _NodeIndex, pLocal );
+}
+
+void	SceneTransforms::SetLocalTransforms( cli::array<int>^ _NodeIndices, cli::array<float>^ _LocalTransforms )
+{
+	if ( _NodeIndices == nullptr || _LocalTransforms == nullptr || _LocalTransforms->Length < MATRIX_STRIDE * _NodeIndices->Length )
+		throw gcnew Exception( "Expected " + MATRIX_STRIDE + " floats per node !" );
+	if ( _NodeIndices->Length == 0 )
+		return;
+
+	for ( int i=0; i < _NodeIndices->Length; i++ )
+		if ( _NodeIndices[i] < 0 || _NodeIndices[i] >= m_Nodes->Length )
+			throw gcnew Exception( "Node index out of range !" );
+
+	pin_ptr<int>	pNodeIndices = &_NodeIndices[0];
+	pin_ptr<float>	pLocalTransforms = &_LocalTransforms[0];
+	m_pHierarchy->SetLocals( pNodeIndices, _NodeIndices->Length, pLocalTransforms );
+}
+
+void	SceneTransforms::Invalidate( Node^ _Node )
+{
+	ReadNode( GetIndexChecked( _Node ) );
+}
+
+int		SceneTransforms::Update()
+{
+	return	m_pHierarchy->Update();
+}
+
+WMath::Matrix4x4^	SceneTransforms::GetWorldTransform( Node^ _Node )
+{
+	int	NodeIndex = GetIndexChecked( _Node );
+	m_pHierarchy->Update();
+
+	int	Generation = m_pHierarchy->GetGeneration( NodeIndex );
+	if ( m_WorldCacheGenerations[NodeIndex] != Generation )
+	{
+		const float*		pWorld = m_pHierarchy->GetWorld( NodeIndex );
+		WMath::Matrix4x4^	World = gcnew WMath::Matrix4x4();
+		for ( int RowIndex=0; RowIndex < 4; RowIndex++ )
+			for ( int ColumnIndex=0; ColumnIndex < 4; ColumnIndex++ )
+				World->m[RowIndex,ColumnIndex] = pWorld[4*RowIndex+ColumnIndex];
+
+		m_WorldCache[NodeIndex] = World;
+		m_WorldCacheGenerations[NodeIndex] = Generation;
+	}
+
+	return	m_WorldCache[NodeIndex];
+}
+
+WMath::BoundingBox^	SceneTransforms::GetWorldBoundingBox( Node^ _Node )
+{
+	int	NodeIndex = GetIndexChecked( _Node );
+	m_pHierarchy->Update();
+
+	int	Generation = m_pHierarchy->GetGeneration( NodeIndex );
+	if ( m_BoundsCacheGenerations[NodeIndex] != Generation )
+	{
+		const float*	pBounds = m_pHierarchy->GetWorldBounds( NodeIndex );
+		m_BoundsCache[NodeIndex] = gcnew WMath::BoundingBox( pBounds[0], pBounds[1], pBounds[2], pBounds[3], pBounds[4], pBounds[5] );
+		m_BoundsCacheGenerations[NodeIndex] = Generation;
+	}
+
+	return	m_BoundsCache[NodeIndex];
+}
+
+void	SceneTransforms::CopyWorldTransforms( cli::array<float>^ _WorldTransforms )
+{
+	int	FloatsCount = MATRIX_STRIDE * m_Nodes->Length;
+	if ( _WorldTransforms == nullptr || _WorldTransforms->Length < FloatsCount )
+		throw gcnew Exception( "The target array is too small !" );
+	if ( FloatsCount == 0 )
+		return;
+
+	m_pHierarchy->Update();
+
+	System::Runtime::InteropServices::Marshal::Copy( IntPtr( (void*) m_pHierarchy->GetWorlds() ), _WorldTransforms, 0, FloatsCount );
+}
+
+void	SceneTransforms::CopyWorldBounds( cli::array<float>^ _WorldBounds )
+{
+	int	FloatsCount = BOUNDS_STRIDE * m_Nodes->Length;
+	if ( _WorldBounds == nullptr || _WorldBounds->Length < FloatsCount )
+		throw gcnew Exception( "The target array is too small !" );
+	if ( FloatsCount == 0 )
+		return;
+
+	m_pHierarchy->Update();
+
+	System::Runtime::InteropServices::Marshal::Copy( IntPtr( (void*) m_pHierarchy->GetWorldBounds( 0 ) ), _WorldBounds, 0, FloatsCount );
+}
+
+void	SceneTransforms::ReadNode( int _NodeIndex )
+{
+	Node^	Current = m_Nodes[_NodeIndex];
+
+	float	pLocal[16];
+	ToFloats( Current->LocalTransform, pLocal );
+	m_pHierarchy->SetLocal( _NodeIndex, pLocal );
+
+	NodeMesh^	Mesh = dynamic_cast<NodeMesh^>( Current );
+	if ( Mesh == nullptr || Mesh->BoundingBox == nullptr )
+	{
+		m_pHierarchy->SetBounds( _NodeIndex, NULL, NULL, NULL );
+		return;
+	}
+
+	WMath::BoundingBox^	BBox = Mesh->BoundingBox;
+	float	pMin[3] = { BBox->m_Min->x, BBox->m_Min->y, BBox->m_Min->z };
+	float	pMax[3] = { BBox->m_Max->x, BBox->m_Max->y, BBox->m_Max->z };
+	float	pPivot[16];
+	ToFloats( Mesh->Pivot, pPivot );
+	m_pHierarchy->SetBounds( _NodeIndex, pMin, pMax, pPivot );
+}
+
+int		SceneTransforms::GetIndexChecked( Node^ _Node )
+{
+	int	Result = IndexOf( _Node );
+	if ( Result < 0 )
+		throw gcnew Exception( "Node \"" + (_Node != nullptr ? _Node->Name : "null") + "\" is not part of the hierarchy !" );
+
+	return	Result;
+}
+
+void	SceneTransforms::ToFloats( WMath::Matrix4x4^ _Matrix, float* _pTarget )
+{
+	cli::array<float,2>^	M = _Matrix->m;
+	for ( int RowIndex=0; RowIndex < 4; RowIndex++ )
+		for ( int ColumnIndex=0; ColumnIndex < 4; ColumnIndex++ )
+			_pTarget[4*RowIndex+ColumnIndex] = M[RowIndex,ColumnIndex];
+}
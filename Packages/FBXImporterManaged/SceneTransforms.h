@@ -0,0 +1,128 @@
+// Contains the cached world transforms & bounds of the nodes of a scene
+//
+#pragma managed
+#pragma once
+
+#include "TransformHierarchy.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	ref class	Scene;
+	ref class	Node;
+
+	//////////////////////////////////////////////////////////////////////////
+	// The flattened transform hierarchy of a scene
+	// Nodes are stored in depth-first order with their local & world matrices in contiguous native arrays.
+	// A node's world transform is LocalTransform * Parent's world transform, and the world bounds of a mesh node are
+	//	the AABB of its BoundingBox transformed by Pivot * World.
+	//
+	// Changing local transforms only flags nodes as dirty: world transforms & bounds are recomputed on the next Update()
+	//	(or the next query) for the dirty subtrees only. Typical per-frame usage is :
+	//	_ SetLocalTransforms() with all the animated nodes at once
+	//	_ Update()
+	//	_ CopyWorldTransforms() and/or CopyWorldBounds() to read back everything without allocating
+	//
+	// Matrices & bounding boxes returned by GetWorldTransform() and GetWorldBoundingBox() are cached until the node is
+	//	recomputed so they must not be modified.
+	//
+	public ref class		SceneTransforms
+	{
+	public:		// NESTED TYPES
+
+		literal int		MATRIX_STRIDE = 16;
+		literal int		BOUNDS_STRIDE = 6;
+
+	protected:	// FIELDS
+
+		Scene^							m_Owner;
+		cli::array<Node^>^				m_Nodes;			// Nodes in depth-first order
+		Dictionary<Node^,int>^			m_Node2Index;
+
+		TransformHierarchy*				m_pHierarchy;
+
+		cli::array<WMath::Matrix4x4^>^		m_WorldCache;
+		cli::array<int>^					m_WorldCacheGenerations;
+		cli::array<WMath::BoundingBox^>^	m_BoundsCache;
+		cli::array<int>^					m_BoundsCacheGenerations;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the scene the transforms belong to" )]
+		//
+		property Scene^					Owner
+		{
+			Scene^						get()	{ return m_Owner; }
+		}
+
+		[DescriptionAttribute( "Gets the nodes in the order of the transform arrays (parents always come before their children)" )]
+		//
+		property cli::array<Node^>^		Nodes
+		{
+			cli::array<Node^>^			get()	{ return m_Nodes; }
+		}
+
+		[DescriptionAttribute( "Gets the amount of nodes in the hierarchy" )]
+		//
+		property int					NodesCount
+		{
+			int							get()	{ return m_Nodes->Length; }
+		}
+
+		[DescriptionAttribute( "Tells if some world transforms need to be recomputed" )]
+		//
+		property bool					IsDirty
+		{
+			bool						get()	{ return m_pHierarchy->IsDirty(); }
+		}
+
+	public:		// METHODS
+
+		SceneTransforms( Scene^ _Owner );
+		~SceneTransforms();
+		!SceneTransforms();
+
+		// Gets the index of a node in the transform arrays (-1 if the node is not part of the hierarchy)
+		int						IndexOf( Node^ _Node );
+
+		// Sets the local transform of a node
+		void					SetLocalTransform( Node^ _Node, WMath::Matrix4x4^ _LocalTransform );
+		void					SetLocalTransform( int _NodeIndex, WMath::Matrix4x4^ _LocalTransform );
+
+		// Sets the local transforms of a list of nodes in a single call
+		//	_NodeIndices, the indices of the nodes in the transform arrays
+		//	_LocalTransforms, 16 floats per node (row-vector convention, same layout as Matrix4x4::m)
+		void					SetLocalTransforms( cli::array<int>^ _NodeIndices, cli::array<float>^ _LocalTransforms );
+
+		// Reads back the local transform & bounds of a node (e.g. after its LocalTransform matrix was modified in place)
+		void					Invalidate( Node^ _Node );
+
+		// Recomputes the world transforms & bounds of the dirty subtrees
+		// Returns the amount of nodes that were recomputed
+		int						Update();
+
+		// Gets the world transform of a node (updating the hierarchy first if needed)
+		WMath::Matrix4x4^		GetWorldTransform( Node^ _Node );
+
+		// Gets the world bounding box of a node (empty if the node has no geometry)
+		WMath::BoundingBox^		GetWorldBoundingBox( Node^ _Node );
+
+		// Copies all the world transforms, MATRIX_STRIDE floats per node in the order of Nodes
+		void					CopyWorldTransforms( cli::array<float>^ _WorldTransforms );
+
+		// Copies all the world bounds, BOUNDS_STRIDE floats per node (Min then Max) in the order of Nodes
+		void					CopyWorldBounds( cli::array<float>^ _WorldBounds );
+
+	protected:
+
+		// Reads the local transform & bounds of a node into the hierarchy
+		void					ReadNode( int _NodeIndex );
+
+		int						GetIndexChecked( Node^ _Node );
+
+		static void				ToFloats( WMath::Matrix4x4^ _Matrix, float* _pTarget );
+	};
+}
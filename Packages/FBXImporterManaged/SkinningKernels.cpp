@@ -0,0 +1,315 @@
+// Native skin influences & CPU skinning kernels
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <string.h>
+#include <xmmintrin.h>
+
+#include "SkinningKernels.h"
+
+using namespace	FBXImporter;
+
+namespace
+{
+	// Stores the x, y & z components of a vector into a packed float3
+	inline void		Store3( float* _pTarget, __m128 _Value )
+	{
+		_mm_storel_pi( reinterpret_cast<__m64*>( _pTarget ), _Value );
+		_mm_store_ss( _pTarget + 2, _mm_movehl_ps( _Value, _Value ) );
+	}
+
+	inline __m128	Load3( const float* _pSource )
+	{
+		return	_mm_set_ps( 0.0f, _pSource[2], _pSource[1], _pSource[0] );
+	}
+
+	inline __m128	Dot3( __m128 _a, __m128 _b )
+	{
+		__m128	P = _mm_mul_ps( _a, _b );
+		__m128	Sum = _mm_add_ss( P, _mm_shuffle_ps( P, P, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+				Sum = _mm_add_ss( Sum, _mm_shuffle_ps( P, P, _MM_SHUFFLE( 2, 2, 2, 2 ) ) );
+		return	_mm_shuffle_ps( Sum, Sum, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+	}
+
+	inline __m128	Dot4( __m128 _a, __m128 _b )
+	{
+		__m128	P = _mm_mul_ps( _a, _b );
+		__m128	Sum = _mm_add_ps( P, _mm_shuffle_ps( P, P, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+		return	_mm_add_ps( Sum, _mm_shuffle_ps( Sum, Sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	}
+
+	inline __m128	Cross( __m128 _a, __m128 _b )
+	{
+		__m128	a_yzx = _mm_shuffle_ps( _a, _a, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+		__m128	b_yzx = _mm_shuffle_ps( _b, _b, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+		__m128	C = _mm_sub_ps( _mm_mul_ps( _a, b_yzx ), _mm_mul_ps( a_yzx, _b ) );
+		return	_mm_shuffle_ps( C, C, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+	}
+
+	inline __m128	Normalize3( __m128 _v )
+	{
+		__m128	SqLength = Dot3( _v, _v );
+		__m128	Mask = _mm_cmpgt_ps( SqLength, _mm_set1_ps( 1e-20f ) );
+		return	_mm_and_ps( Mask, _mm_div_ps( _v, _mm_sqrt_ps( SqLength ) ) );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SkinInfluences
+//
+SkinInfluences::SkinInfluences( int _VerticesCount, int _InfluencesCount ) : m_VerticesCount( _VerticesCount ), m_InfluencesCount( _InfluencesCount )
+{
+	int	SlotsCount = _VerticesCount * _InfluencesCount;
+	m_pBoneIndices = new unsigned short[SlotsCount];
+	m_pBoneWeights = new float[SlotsCount];
+	m_pSourceCounts = new int[_VerticesCount];
+	memset( m_pBoneIndices, 0, SlotsCount * sizeof(unsigned short) );
+	memset( m_pBoneWeights, 0, SlotsCount * sizeof(float) );
+	memset( m_pSourceCounts, 0, _VerticesCount * sizeof(int) );
+}
+
+SkinInfluences::~SkinInfluences()
+{
+	delete[] m_pBoneIndices;
+	delete[] m_pBoneWeights;
+	delete[] m_pSourceCounts;
+}
+
+void	SkinInfluences::Add( int _VertexIndex, int _BoneIndex, float _Weight )
+{
+	if ( _VertexIndex < 0 || _VertexIndex >= m_VerticesCount || _Weight <= 0.0f )
+		return;
+
+	unsigned short*	pIndices = m_pBoneIndices + _VertexIndex * m_InfluencesCount;
+	float*			pWeights = m_pBoneWeights + _VertexIndex * m_InfluencesCount;
+
+	// Check if the bone already influences that vertex
+	int	Slot = -1;
+	for ( int SlotIndex=0; SlotIndex < m_InfluencesCount && pWeights[SlotIndex] > 0.0f; SlotIndex++ )
+		if ( pIndices[SlotIndex] == _BoneIndex )
+		{
+			Slot = SlotIndex;
+			_Weight += pWeights[SlotIndex];
+			break;
+		}
+
+	if ( Slot == -1 )
+	{	// New influence
+		m_pSourceCounts[_VertexIndex]++;
+		Slot = m_InfluencesCount - 1;
+		if ( _Weight <= pWeights[Slot] )
+			return;	// Less important than all the kept influences
+	}
+
+	// Insert the influence at its sorted position
+	while ( Slot > 0 && pWeights[Slot-1] < _Weight )
+	{
+		pIndices[Slot] = pIndices[Slot-1];
+		pWeights[Slot] = pWeights[Slot-1];
+		Slot--;
+	}
+	pIndices[Slot] = (unsigned short) _BoneIndex;
+	pWeights[Slot] = _Weight;
+}
+
+void	SkinInfluences::Normalize()
+{
+	for ( int VertexIndex=0; VertexIndex < m_VerticesCount; VertexIndex++ )
+	{
+		float*	pWeights = m_pBoneWeights + VertexIndex * m_InfluencesCount;
+
+		float	Sum = 0.0f;
+		for ( int SlotIndex=0; SlotIndex < m_InfluencesCount; SlotIndex++ )
+			Sum += pWeights[SlotIndex];
+		if ( Sum <= 0.0f )
+			continue;	// Unskinned vertex
+
+		float	InvSum = 1.0f / Sum;
+		for ( int SlotIndex=0; SlotIndex < m_InfluencesCount; SlotIndex++ )
+			pWeights[SlotIndex] *= InvSum;
+	}
+}
+
+int		SkinInfluences::GetMaxSourceInfluencesCount() const
+{
+	int	Result = 0;
+	for ( int VertexIndex=0; VertexIndex < m_VerticesCount; VertexIndex++ )
+		Result = m_pSourceCounts[VertexIndex] > Result ? m_pSourceCounts[VertexIndex] : Result;
+
+	return	Result;
+}
+
+int		SkinInfluences::GetPrunedVerticesCount() const
+{
+	int	Result = 0;
+	for ( int VertexIndex=0; VertexIndex < m_VerticesCount; VertexIndex++ )
+		Result += m_pSourceCounts[VertexIndex] > m_InfluencesCount ? 1 : 0;
+
+	return	Result;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// SkinningKernels
+//
+void	SkinningKernels::SkinLinear( const SkinningBuffers& _Buffers, const float* _pBoneMatrices, int _StartVertex, int _EndVertex )
+{
+	int	InfluencesCount = _Buffers.InfluencesCount;
+	for ( int VertexIndex=_StartVertex; VertexIndex < _EndVertex; VertexIndex++ )
+	{
+		const unsigned short*	pIndices = _Buffers.pBoneIndices + VertexIndex * InfluencesCount;
+		const float*			pWeights = _Buffers.pBoneWeights + VertexIndex * InfluencesCount;
+
+		// Blend the rows of the bone matrices (influences are sorted so we stop at the first empty slot)
+		__m128	R0 = _mm_setzero_ps(), R1 = _mm_setzero_ps(), R2 = _mm_setzero_ps(), R3 = _mm_setzero_ps();
+		for ( int SlotIndex=0; SlotIndex < InfluencesCount && pWeights[SlotIndex] > 0.0f; SlotIndex++ )
+		{
+			const float*	pMatrix = _pBoneMatrices + 16 * pIndices[SlotIndex];
+			__m128			W = _mm_set1_ps( pWeights[SlotIndex] );
+			R0 = _mm_add_ps( R0, _mm_mul_ps( W, _mm_loadu_ps( pMatrix + 0 ) ) );
+			R1 = _mm_add_ps( R1, _mm_mul_ps( W, _mm_loadu_ps( pMatrix + 4 ) ) );
+			R2 = _mm_add_ps( R2, _mm_mul_ps( W, _mm_loadu_ps( pMatrix + 8 ) ) );
+			R3 = _mm_add_ps( R3, _mm_mul_ps( W, _mm_loadu_ps( pMatrix + 12 ) ) );
+		}
+		if ( pWeights[0] <= 0.0f )
+		{	// Unskinned vertices are left untouched
+			R0 = _mm_set_ps( 0, 0, 0, 1 );
+			R1 = _mm_set_ps( 0, 0, 1, 0 );
+			R2 = _mm_set_ps( 0, 1, 0, 0 );
+			R3 = _mm_set_ps( 1, 0, 0, 0 );
+		}
+
+		const float*	pPosition = _Buffers.pPositions + 3 * VertexIndex;
+		__m128	P = _mm_add_ps(	_mm_add_ps( _mm_mul_ps( _mm_set1_ps( pPosition[0] ), R0 ), _mm_mul_ps( _mm_set1_ps( pPosition[1] ), R1 ) ),
+								_mm_add_ps( _mm_mul_ps( _mm_set1_ps( pPosition[2] ), R2 ), R3 ) );
+		Store3( _Buffers.pSkinnedPositions + 3 * VertexIndex, P );
+
+		if ( _Buffers.pNormals == NULL )
+			continue;
+
+		const float*	pNormal = _Buffers.pNormals + 3 * VertexIndex;
+		__m128	N = _mm_add_ps(	_mm_add_ps( _mm_mul_ps( _mm_set1_ps( pNormal[0] ), R0 ), _mm_mul_ps( _mm_set1_ps( pNormal[1] ), R1 ) ),
+								_mm_mul_ps( _mm_set1_ps( pNormal[2] ), R2 ) );
+		Store3( _Buffers.pSkinnedNormals + 3 * VertexIndex, Normalize3( N ) );
+	}
+}
+
+void	SkinningKernels::SkinDualQuaternion( const SkinningBuffers& _Buffers, const float* _pDualQuaternions, int _StartVertex, int _EndVertex )
+{
+	const __m128	Two = _mm_set1_ps( 2.0f );
+	const __m128	Zero = _mm_setzero_ps();
+
+	int	InfluencesCount = _Buffers.InfluencesCount;
+	for ( int VertexIndex=_StartVertex; VertexIndex < _EndVertex; VertexIndex++ )
+	{
+		const unsigned short*	pIndices = _Buffers.pBoneIndices + VertexIndex * InfluencesCount;
+		const float*			pWeights = _Buffers.pBoneWeights + VertexIndex * InfluencesCount;
+
+		// Blend the dual quaternions, making sure they all lie in the same hemisphere as the first one
+		__m128	Real = _mm_set_ps( 1, 0, 0, 0 ), Dual = Zero;
+		if ( pWeights[0] > 0.0f )
+		{
+			const float*	pFirst = _pDualQuaternions + 8 * pIndices[0];
+			__m128			FirstReal = _mm_loadu_ps( pFirst );
+
+			Real = Dual = Zero;
+			for ( int SlotIndex=0; SlotIndex < InfluencesCount && pWeights[SlotIndex] > 0.0f; SlotIndex++ )
+			{
+				const float*	pDQ = _pDualQuaternions + 8 * pIndices[SlotIndex];
+				__m128			QReal = _mm_loadu_ps( pDQ );
+				__m128			QDual = _mm_loadu_ps( pDQ + 4 );
+
+				__m128	Sign = _mm_and_ps( _mm_cmplt_ps( Dot4( FirstReal, QReal ), Zero ), _mm_set1_ps( -0.0f ) );
+				__m128	W = _mm_xor_ps( _mm_set1_ps( pWeights[SlotIndex] ), Sign );
+				Real = _mm_add_ps( Real, _mm_mul_ps( W, QReal ) );
+				Dual = _mm_add_ps( Dual, _mm_mul_ps( W, QDual ) );
+			}
+
+			__m128	InvLength = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( Dot4( Real, Real ) ) );
+			Real = _mm_mul_ps( Real, InvLength );
+			Dual = _mm_mul_ps( Dual, InvLength );
+		}
+
+		__m128	RealW = _mm_shuffle_ps( Real, Real, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		__m128	DualW = _mm_shuffle_ps( Dual, Dual, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+
+		// Translation = 2 * (Real.w * Dual.xyz - Dual.w * Real.xyz + Real.xyz x Dual.xyz)
+		__m128	Translation = _mm_mul_ps( Two, _mm_add_ps( _mm_sub_ps( _mm_mul_ps( RealW, Dual ), _mm_mul_ps( DualW, Real ) ), Cross( Real, Dual ) ) );
+
+		// Rotate : v' = v + 2 * Real.xyz x (Real.xyz x v + Real.w * v)
+		__m128	P = Load3( _Buffers.pPositions + 3 * VertexIndex );
+		__m128	RotatedP = _mm_add_ps( P, _mm_mul_ps( Two, Cross( Real, _mm_add_ps( Cross( Real, P ), _mm_mul_ps( RealW, P ) ) ) ) );
+		Store3( _Buffers.pSkinnedPositions + 3 * VertexIndex, _mm_add_ps( RotatedP, Translation ) );
+
+		if ( _Buffers.pNormals == NULL )
+			continue;
+
+		__m128	N = Load3( _Buffers.pNormals + 3 * VertexIndex );
+		__m128	RotatedN = _mm_add_ps( N, _mm_mul_ps( Two, Cross( Real, _mm_add_ps( Cross( Real, N ), _mm_mul_ps( RealW, N ) ) ) ) );
+		Store3( _Buffers.pSkinnedNormals + 3 * VertexIndex, RotatedN );
+	}
+}
+
+void	SkinningKernels::ConvertToDualQuaternions( const float* _pBoneMatrices, int _BonesCount, float* _pDualQuaternions )
+{
+	for ( int BoneIndex=0; BoneIndex < _BonesCount; BoneIndex++ )
+	{
+		const float*	M = _pBoneMatrices + 16 * BoneIndex;
+		float*			pDQ = _pDualQuaternions + 8 * BoneIndex;
+
+		// Extract the rotation quaternion (matrices are row-vector so the usual column-vector formulas use the transposed indices)
+		float	m00 = M[0], m01 = M[1], m02 = M[2];
+		float	m10 = M[4], m11 = M[5], m12 = M[6];
+		float	m20 = M[8], m21 = M[9], m22 = M[10];
+		float	x, y, z, w;
+		float	Trace = m00 + m11 + m22;
+		if ( Trace > 0.0f )
+		{
+			float	s = 0.5f / (float) sqrt( Trace + 1.0f );
+			w = 0.25f / s;
+			x = (m12 - m21) * s;
+			y = (m20 - m02) * s;
+			z = (m01 - m10) * s;
+		}
+		else if ( m00 > m11 && m00 > m22 )
+		{
+			float	s = 2.0f * (float) sqrt( 1.0f + m00 - m11 - m22 );
+			w = (m12 - m21) / s;
+			x = 0.25f * s;
+			y = (m10 + m01) / s;
+			z = (m20 + m02) / s;
+		}
+		else if ( m11 > m22 )
+		{
+			float	s = 2.0f * (float) sqrt( 1.0f + m11 - m00 - m22 );
+			w = (m20 - m02) / s;
+			x = (m10 + m01) / s;
+			y = 0.25f * s;
+			z = (m21 + m12) / s;
+		}
+		else
+		{
+			float	s = 2.0f * (float) sqrt( 1.0f + m22 - m00 - m11 );
+			w = (m01 - m10) / s;
+			x = (m20 + m02) / s;
+			y = (m21 + m12) / s;
+			z = 0.25f * s;
+		}
+
+		float	InvLength = 1.0f / (float) sqrt( x*x + y*y + z*z + w*w );
+		x *= InvLength; y *= InvLength; z *= InvLength; w *= InvLength;
+
+		// Dual part = 0.5 * Translation * Real
+		float	tx = M[12], ty = M[13], tz = M[14];
+		pDQ[0] = x;
+		pDQ[1] = y;
+		pDQ[2] = z;
+		pDQ[3] = w;
+		pDQ[4] = 0.5f * (w * tx + (ty * z - tz * y));
+		pDQ[5] = 0.5f * (w * ty + (tz * x - tx * z));
+		pDQ[6] = 0.5f * (w * tz + (tx * y - ty * x));
+		pDQ[7] = -0.5f * (tx * x + ty * y + tz * z);
+	}
+}
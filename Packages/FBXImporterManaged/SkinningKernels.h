@@ -0,0 +1,87 @@
+// Contains the native skin influences accumulator and the CPU skinning kernels
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Accumulates the bone influences of each vertex, keeping only the most important ones
+	// Influences are kept sorted by decreasing weight in a fixed amount of slots per vertex.
+	//
+	class	SkinInfluences
+	{
+	protected:	// FIELDS
+
+		int					m_VerticesCount;
+		int					m_InfluencesCount;		// Slots per vertex (typically 4 or 8)
+
+		unsigned short*		m_pBoneIndices;			// VerticesCount * InfluencesCount bone indices
+		float*				m_pBoneWeights;			// VerticesCount * InfluencesCount bone weights (0 for unused slots)
+		int*				m_pSourceCounts;		// The amount of influences submitted for each vertex
+
+	public:		// PROPERTIES
+
+		int						GetVerticesCount() const	{ return m_VerticesCount; }
+		int						GetInfluencesCount() const	{ return m_InfluencesCount; }
+		const unsigned short*	GetBoneIndices() const		{ return m_pBoneIndices; }
+		const float*			GetBoneWeights() const		{ return m_pBoneWeights; }
+
+		// Gets the maximum amount of influences submitted for a single vertex
+		int		GetMaxSourceInfluencesCount() const;
+
+		// Gets the amount of vertices that had more influences than slots
+		int		GetPrunedVerticesCount() const;
+
+	public:		// METHODS
+
+		SkinInfluences( int _VerticesCount, int _InfluencesCount );
+		~SkinInfluences();
+
+		// Adds the influence of a bone on a vertex (a bone already influencing the vertex gets its weight increased)
+		void	Add( int _VertexIndex, int _BoneIndex, float _Weight );
+
+		// Renormalizes the kept weights of each vertex so they sum to 1
+		void	Normalize();
+
+	private:
+		SkinInfluences( const SkinInfluences& );
+		SkinInfluences&	operator=( const SkinInfluences& );
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// The CPU skinning kernels
+	// Positions & normals are packed as 3 floats per vertex, bone indices & weights as InfluencesCount values per vertex.
+	// Kernels process a range of vertices so the caller can dispatch ranges on several threads.
+	//
+	// Bone matrices are 4x4 matrices (16 floats) using the row-vector convention (translation in the last row),
+	//	transforming bind-pose mesh space positions into skinned positions.
+	// Dual quaternions are 8 floats per bone: the real part (x,y,z,w) then the dual part (x,y,z,w).
+	//
+	struct	SkinningBuffers
+	{
+		int						InfluencesCount;
+		const unsigned short*	pBoneIndices;
+		const float*			pBoneWeights;
+
+		const float*			pPositions;
+		const float*			pNormals;		// Optional
+		float*					pSkinnedPositions;
+		float*					pSkinnedNormals;	// Optional
+	};
+
+	class	SkinningKernels
+	{
+	public:
+
+		// Linear blend skinning of vertices [_StartVertex,_EndVertex[
+		// NOTE: Normals are transformed by the blended matrix, which is only exact for rigid & uniformly scaled bones
+		static void	SkinLinear( const SkinningBuffers& _Buffers, const float* _pBoneMatrices, int _StartVertex, int _EndVertex );
+
+		// Dual quaternion skinning of vertices [_StartVertex,_EndVertex[
+		// NOTE: Bones are assumed rigid, scale is not supported
+		static void	SkinDualQuaternion( const SkinningBuffers& _Buffers, const float* _pDualQuaternions, int _StartVertex, int _EndVertex );
+
+		// Converts rigid bone matrices into dual quaternions
+		static void	ConvertToDualQuaternions( const float* _pBoneMatrices, int _BonesCount, float* _pDualQuaternions );
+	};
+}
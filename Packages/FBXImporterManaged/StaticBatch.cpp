@@ -0,0 +1,86 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "StaticBatch.h"
+#include "NodeMesh.h"
+
+using namespace	FBXImporter;
+
+StaticBatch::StaticBatch( Object^ _Material, int _CellX, int _CellY, int _CellZ, WMath::Point^ _Origin, VertexBufferLayout^ _Layout, List<Piece^>^ _Pieces )
+	: m_Material( _Material ), m_CellX( _CellX ), m_CellY( _CellY ), m_CellZ( _CellZ ), m_Origin( _Origin ), m_Layout( _Layout )
+{
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Lay the pieces out one after the other
+	m_VerticesCount = 0;
+	m_IndicesCount = 0;
+	m_Ranges = gcnew cli::array<Range^>( _Pieces->Count );
+	for ( int PieceIndex=0; PieceIndex < _Pieces->Count; PieceIndex++ )
+	{
+		Piece^	P = _Pieces[PieceIndex];
+
+		Range^	R = gcnew Range();
+		R->Node = P->Mesh;
+		R->IndexStart = m_IndicesCount;
+		R->IndexCount = P->Buffer->IndicesCount;
+		R->BaseVertex = m_VerticesCount;
+		R->VerticesCount = P->Buffer->VerticesCount;
+		R->BoundingBox = P->BoundingBox;
+		m_Ranges[PieceIndex] = R;
+
+		m_VerticesCount += R->VerticesCount;
+		m_IndicesCount += R->IndexCount;
+
+		if ( PieceIndex == 0 )
+			m_BBox = gcnew WMath::BoundingBox( P->BoundingBox->m_Min->x, P->BoundingBox->m_Min->y, P->BoundingBox->m_Min->z, P->BoundingBox->m_Max->x, P->BoundingBox->m_Max->y, P->BoundingBox->m_Max->z );
+		else
+		{
+			m_BBox->m_Min->x = Math::Min( m_BBox->m_Min->x, P->BoundingBox->m_Min->x );
+			m_BBox->m_Min->y = Math::Min( m_BBox->m_Min->y, P->BoundingBox->m_Min->y );
+			m_BBox->m_Min->z = Math::Min( m_BBox->m_Min->z, P->BoundingBox->m_Min->z );
+			m_BBox->m_Max->x = Math::Max( m_BBox->m_Max->x, P->BoundingBox->m_Max->x );
+			m_BBox->m_Max->y = Math::Max( m_BBox->m_Max->y, P->BoundingBox->m_Max->y );
+			m_BBox->m_Max->z = Math::Max( m_BBox->m_Max->z, P->BoundingBox->m_Max->z );
+		}
+	}
+	m_IndexSize = m_VerticesCount <= 65536 ? 2 : 4;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Concatenate the streams
+	m_Streams = gcnew cli::array<cli::array<unsigned char>^>( m_Layout->StreamsCount );
+	for ( int StreamIndex=0; StreamIndex < m_Streams->Length; StreamIndex++ )
+	{
+		int	Stride = m_Layout->GetStride( StreamIndex );
+		m_Streams[StreamIndex] = gcnew cli::array<unsigned char>( m_VerticesCount * Stride );
+		for ( int PieceIndex=0; PieceIndex < _Pieces->Count; PieceIndex++ )
+		{
+			cli::array<unsigned char>^	Source = _Pieces[PieceIndex]->Buffer->Streams[StreamIndex];
+			System::Buffer::BlockCopy( Source, 0, m_Streams[StreamIndex], m_Ranges[PieceIndex]->BaseVertex * Stride, Source->Length );
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Concatenate the indices, offset by the base vertex of their range
+	m_Indices = gcnew cli::array<unsigned char>( m_IndicesCount * m_IndexSize );
+	if ( m_IndicesCount == 0 )
+		return;
+
+	pin_ptr<unsigned char>	pTarget = &m_Indices[0];
+	for ( int PieceIndex=0; PieceIndex < _Pieces->Count; PieceIndex++ )
+	{
+		VertexBuffer^	Source = _Pieces[PieceIndex]->Buffer;
+		Range^			R = m_Ranges[PieceIndex];
+		if ( R->IndexCount == 0 )
+			continue;
+
+		pin_ptr<unsigned char>	pSource = &Source->Indices[0];
+		for ( int Index=0; Index < R->IndexCount; Index++ )
+		{
+			unsigned int	VertexIndex = R->BaseVertex + (Source->IndexSize == 2 ? ((unsigned short*) pSource)[Index] : ((unsigned int*) pSource)[Index]);
+			if ( m_IndexSize == 2 )
+				((unsigned short*) pTarget)[R->IndexStart + Index] = (unsigned short) VertexIndex;
+			else
+				((unsigned int*) pTarget)[R->IndexStart + Index] = VertexIndex;
+		}
+	}
+}
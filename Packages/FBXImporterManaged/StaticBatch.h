@@ -0,0 +1,169 @@
+// Contains a batch of static meshes merged at import time
+//
+#pragma managed
+#pragma once
+
+#include "VertexBuffer.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	ref class	NodeMesh;
+
+	//////////////////////////////////////////////////////////////////////////
+	// The triangles of several static meshes sharing a material & a spatial cell, merged into a single vertex & index buffer
+	//	so they're drawn with a single call
+	// Vertices are pre-transformed into the space of the cell: Position = (WorldPosition - Origin) * Layout->PositionScale,
+	//	normals & tangents being expressed in world space. Indices already include the base vertex of each range.
+	//
+	// Ranges maps every range of indices back to the node it comes from, with its bounding box, for picking & culling.
+	// A batch only exceeds the maximum amount of vertices when a single mesh range does.
+	//
+	public ref class	StaticBatch
+	{
+	public:		// NESTED TYPES
+
+		[System::Diagnostics::DebuggerDisplayAttribute( "{Node} Start={IndexStart} Count={IndexCount}" )]
+		ref class	Range
+		{
+		public:
+
+			NodeMesh^				Node;			// The node the triangles come from
+			int						IndexStart;
+			int						IndexCount;
+			int						BaseVertex;		// The first vertex of the range in the batch
+			int						VerticesCount;
+			WMath::BoundingBox^		BoundingBox;	// The bounds of the range in the space of the batch
+		};
+
+	internal:
+
+		// A material range of a mesh encoded in the space of its cell, waiting to be appended to a batch
+		ref class	Piece
+		{
+		public:
+
+			NodeMesh^				Mesh;
+			Object^					Material;
+			VertexBuffer^			Buffer;
+			WMath::BoundingBox^		BoundingBox;
+		};
+
+	protected:	// FIELDS
+
+		Object^									m_Material;
+		int										m_CellX;
+		int										m_CellY;
+		int										m_CellZ;
+		WMath::Point^							m_Origin;
+		VertexBufferLayout^						m_Layout;
+
+		int										m_VerticesCount;
+		cli::array<cli::array<unsigned char>^>^	m_Streams;
+
+		int										m_IndicesCount;
+		int										m_IndexSize;
+		cli::array<unsigned char>^				m_Indices;
+
+		cli::array<Range^>^						m_Ranges;
+		WMath::BoundingBox^						m_BBox;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the material shared by all the triangles of the batch (null for triangles without material)" )]
+		//
+		property Object^					Material
+		{
+			Object^						get()	{ return m_Material; }
+		}
+
+		[DescriptionAttribute( "Gets the coordinates of the cell the batch belongs to (i.e. the world position divided by the cell size)" )]
+		//
+		property int						CellX
+		{
+			int							get()	{ return m_CellX; }
+		}
+
+		property int						CellY
+		{
+			int							get()	{ return m_CellY; }
+		}
+
+		property int						CellZ
+		{
+			int							get()	{ return m_CellZ; }
+		}
+
+		[DescriptionAttribute( "Gets the world position of the center of the cell, which is the origin of the batch's vertices" )]
+		//
+		property WMath::Point^				Origin
+		{
+			WMath::Point^				get()	{ return m_Origin; }
+		}
+
+		property VertexBufferLayout^		Layout
+		{
+			VertexBufferLayout^			get()	{ return m_Layout; }
+		}
+
+		property int						VerticesCount
+		{
+			int							get()	{ return m_VerticesCount; }
+		}
+
+		[DescriptionAttribute( "Gets the encoded vertices of each stream of the layout" )]
+		//
+		property cli::array<cli::array<unsigned char>^>^	Streams
+		{
+			cli::array<cli::array<unsigned char>^>^	get()	{ return m_Streams; }
+		}
+
+		property int						IndicesCount
+		{
+			int							get()	{ return m_IndicesCount; }
+		}
+
+		[DescriptionAttribute( "Gets the size of an index (2 bytes whenever the batch has at most 65536 vertices, 4 bytes otherwise)" )]
+		//
+		property int						IndexSize
+		{
+			int							get()	{ return m_IndexSize; }
+		}
+
+		[DescriptionAttribute( "Gets the indices (IndexSize bytes per index, little endian)" )]
+		//
+		property cli::array<unsigned char>^	Indices
+		{
+			cli::array<unsigned char>^	get()	{ return m_Indices; }
+		}
+
+		[DescriptionAttribute( "Gets the range of indices of each merged mesh, in the order they were appended" )]
+		//
+		property cli::array<Range^>^		Ranges
+		{
+			cli::array<Range^>^			get()	{ return m_Ranges; }
+		}
+
+		[DescriptionAttribute( "Gets the bounds of the batch in the space of its vertices" )]
+		//
+		property WMath::BoundingBox^		BoundingBox
+		{
+			WMath::BoundingBox^			get()	{ return m_BBox; }
+		}
+
+		[DescriptionAttribute( "Gets the size of the encoded vertices & indices (in bytes)" )]
+		//
+		property __int64					EncodedSize
+		{
+			__int64						get()	{ return (__int64) m_VerticesCount * m_Layout->VertexSize + (__int64) m_IndicesCount * m_IndexSize; }
+		}
+
+	internal:	// METHODS
+
+		// Concatenates the vertices & indices of the pieces, which must share the material, the cell & the layout
+		StaticBatch( Object^ _Material, int _CellX, int _CellY, int _CellZ, WMath::Point^ _Origin, VertexBufferLayout^ _Layout, List<Piece^>^ _Pieces );
+	};
+}
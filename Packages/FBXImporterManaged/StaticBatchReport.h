@@ -0,0 +1,89 @@
+// Contains the report of the static batching stage
+//
+#pragma managed
+#pragma once
+
+#include "StaticBatch.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Reports how many draw calls the static batches replace
+	// Every material range of a mesh is counted as one draw call before batching, every batch as one draw call after.
+	//
+	public ref class	StaticBatchReport
+	{
+	protected:	// FIELDS
+
+		int					m_BatchedMeshesCount;
+		int					m_SkippedMeshesCount;
+		int					m_RangesCount;
+		float				m_CellSize;
+		List<StaticBatch^>^	m_Batches;
+		double				m_Milliseconds;
+
+	public:		// PROPERTIES
+
+		// Gets the amount of static meshes merged into batches
+		property int		BatchedMeshesCount
+		{
+			int		get()	{ return m_BatchedMeshesCount; }
+		}
+
+		// Gets the amount of meshes left out because they're animated (or have an animated ancestor), skinned or morphed
+		property int		SkippedMeshesCount
+		{
+			int		get()	{ return m_SkippedMeshesCount; }
+		}
+
+		// Gets the amount of draw calls of the batched meshes without batching (one per material range of each mesh)
+		property int		DrawCallsBefore
+		{
+			int		get()	{ return m_RangesCount; }
+		}
+
+		// Gets the amount of draw calls of the batches
+		property int		DrawCallsAfter
+		{
+			int		get()	{ return m_Batches->Count; }
+		}
+
+		property float		CellSize
+		{
+			float	get()	{ return m_CellSize; }
+		}
+
+		property int		VerticesCount
+		{
+			int		get()	{ int Result = 0; for each ( StaticBatch^ B in m_Batches ) Result += B->VerticesCount; return Result; }
+		}
+
+		property __int64	EncodedSize
+		{
+			__int64	get()	{ __int64 Result = 0; for each ( StaticBatch^ B in m_Batches ) Result += B->EncodedSize; return Result; }
+		}
+
+		// Gets the time spent batching (in milliseconds)
+		property double		Milliseconds
+		{
+			double	get()	{ return m_Milliseconds; }
+		}
+
+	public:		// METHODS
+
+		StaticBatchReport( int _BatchedMeshesCount, int _SkippedMeshesCount, int _RangesCount, float _CellSize, List<StaticBatch^>^ _Batches, double _Milliseconds )
+			: m_BatchedMeshesCount( _BatchedMeshesCount ), m_SkippedMeshesCount( _SkippedMeshesCount ), m_RangesCount( _RangesCount ), m_CellSize( _CellSize ), m_Batches( _Batches ), m_Milliseconds( _Milliseconds )
+		{
+		}
+
+		virtual String^	ToString() override
+		{
+			return	String::Format( "{0} static meshes merged into {1} batches of cell size {2} ({3} draw calls => {4}, {5:F1}x fewer), {6} vertices, {7:F1} KB, {8} meshes left unbatched, {9:F1} ms",
+				m_BatchedMeshesCount, m_Batches->Count, m_CellSize, m_RangesCount, m_Batches->Count, m_Batches->Count > 0 ? (double) m_RangesCount / m_Batches->Count : 0.0,
+				VerticesCount, EncodedSize / 1024.0, m_SkippedMeshesCount, m_Milliseconds );
+		}
+	};
+}
@@ -0,0 +1,275 @@
+// Contains the string table used to intern strings during import and the arena used to marshal strings to native code
+//
+#pragma managed
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Import-scoped string table
+	// Names like "Lcl Translation" are repeated thousands of times in a scene so we only create a single managed string for each of them.
+	// Native to managed conversions are cached by pointer first (the cheapest), then by content.
+	//
+	// The table is made current for the duration of its scope (use stack semantics) and Helpers::GetString() uses the current table if any.
+	//
+	public ref class	StringTable
+	{
+	protected:	// FIELDS
+
+		[ThreadStaticAttribute]
+		static StringTable^					ms_Current;
+
+		StringTable^						m_Previous;		// The table that was current before us
+
+		Dictionary<String^,String^>^		m_Interned;		// Interned managed strings
+		Dictionary<IntPtr,String^>^			m_Pointer2String;	// Native pointer => last string converted from that pointer
+		Dictionary<int,List<String^>^>^		m_Hash2Strings;	// Native content hash => strings with that hash
+
+		int									m_ConversionsCount;
+		int									m_CreatedStringsCount;
+
+	public:		// PROPERTIES
+
+		// Gets the current string table (or null if none)
+		static property StringTable^	Current
+		{
+			StringTable^	get()	{ return ms_Current; }
+		}
+
+		// Gets the amount of native strings converted through that table
+		property int		ConversionsCount
+		{
+			int				get()	{ return m_ConversionsCount; }
+		}
+
+		// Gets the amount of managed strings actually created by that table
+		property int		CreatedStringsCount
+		{
+			int				get()	{ return m_CreatedStringsCount; }
+		}
+
+	public:		// METHODS
+
+		StringTable()
+		{
+			m_Interned = gcnew Dictionary<String^,String^>();
+			m_Pointer2String = gcnew Dictionary<IntPtr,String^>();
+			m_Hash2Strings = gcnew Dictionary<int,List<String^>^>();
+
+			m_Previous = ms_Current;
+			ms_Current = this;
+		}
+
+		~StringTable()
+		{
+			if ( ms_Current == this )
+				ms_Current = m_Previous;
+		}
+
+		// Interns a managed string
+		String^		Intern( String^ _String )
+		{
+			if ( _String == nullptr )
+				return	nullptr;
+
+			String^	Result = nullptr;
+			if ( m_Interned->TryGetValue( _String, Result ) )
+				return	Result;
+
+			m_Interned->Add( _String, _String );
+			return	_String;
+		}
+
+		// Gets the managed string for a native ANSI string
+		String^		GetString( const char* _pString )
+		{
+			if ( _pString == NULL )
+				return	nullptr;
+
+			m_ConversionsCount++;
+
+			// 1] Check the pointer (native strings are usually stored once and read several times)
+			String^	Result = nullptr;
+			IntPtr	Pointer( (void*) _pString );
+			if ( m_Pointer2String->TryGetValue( Pointer, Result ) && Matches( Result, _pString ) )
+				return	Result;
+
+			// 2] Check the content
+			int		Hash = ComputeHash( _pString );
+			List<String^>^	Strings = nullptr;
+			if ( m_Hash2Strings->TryGetValue( Hash, Strings ) )
+			{
+				for ( int StringIndex=0; StringIndex < Strings->Count; StringIndex++ )
+					if ( Matches( Strings[StringIndex], _pString ) )
+					{
+						Result = Strings[StringIndex];
+						break;
+					}
+			}
+			else
+			{
+				Strings = gcnew List<String^>( 1 );
+				m_Hash2Strings->Add( Hash, Strings );
+			}
+
+			// 3] Create a brand new string
+			if ( Result == nullptr )
+			{
+				Result = Intern( System::Runtime::InteropServices::Marshal::PtrToStringAnsi( Pointer ) );
+				Strings->Add( Result );
+				m_CreatedStringsCount++;
+			}
+
+			m_Pointer2String[Pointer] = Result;
+
+			return	Result;
+		}
+
+		// Compares a managed string against a native ANSI string without allocating anything
+		static bool	Matches( String^ _String, const char* _pString )
+		{
+			if ( _String == nullptr || _pString == NULL )
+				return	_String == nullptr && _pString == NULL;
+
+			int	Length = _String->Length;
+			for ( int CharIndex=0; CharIndex < Length; CharIndex++ )
+			{
+				unsigned char	C = (unsigned char) _pString[CharIndex];
+				if ( C > 127 )	// Non-ASCII characters depend on the code page, use the slow path
+					return	System::Runtime::InteropServices::Marshal::PtrToStringAnsi( IntPtr( (void*) _pString ) ) == _String;
+				if ( C == '\0' || C != _String[CharIndex] )
+					return	false;
+			}
+
+			return	_pString[Length] == '\0';
+		}
+
+	protected:
+
+		// FNV-1a hash of the native string
+		static int	ComputeHash( const char* _pString )
+		{
+			unsigned int	Hash = 2166136261U;
+			for ( const unsigned char* p=(const unsigned char*) _pString; *p != '\0'; p++ )
+				Hash = (Hash ^ *p) * 16777619U;
+
+			return	(int) Hash;
+		}
+	};
+
+	// A native chunk of memory the marshal arena allocates strings from
+	struct	MarshalArenaChunk
+	{
+		MarshalArenaChunk*	pNext;
+		int					Size;
+		int					Used;
+		// Chunk data follow...
+
+		char*	GetData()	{ return reinterpret_cast<char*>( this + 1 ); }
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Import-scoped arena for managed to native string conversions
+	// All the strings marshaled while the arena is current are released at once when the arena is disposed of.
+	// The arena is made current for the duration of its scope (use stack semantics) and Helpers::FromString() requires a current arena.
+	//
+	public ref class	MarshalArena
+	{
+	protected:	// NESTED TYPES
+
+		literal int			DEFAULT_CHUNK_SIZE = 16384;
+
+	protected:	// FIELDS
+
+		[ThreadStaticAttribute]
+		static MarshalArena^	ms_Current;
+
+		MarshalArena^			m_Previous;
+
+		MarshalArenaChunk*		m_pChunks;		// Linked list of chunks, most recent first
+		int						m_AllocatedBytes;
+
+	public:		// PROPERTIES
+
+		// Gets the current arena (or null if none)
+		static property MarshalArena^	Current
+		{
+			MarshalArena^	get()	{ return ms_Current; }
+		}
+
+		// Gets the amount of bytes allocated by the arena
+		property int		AllocatedBytes
+		{
+			int				get()	{ return m_AllocatedBytes; }
+		}
+
+	public:		// METHODS
+
+		MarshalArena() : m_pChunks( NULL ), m_AllocatedBytes( 0 )
+		{
+			m_Previous = ms_Current;
+			ms_Current = this;
+		}
+
+		~MarshalArena()
+		{
+			if ( ms_Current == this )
+				ms_Current = m_Previous;
+
+			this->!MarshalArena();
+		}
+
+		!MarshalArena()
+		{
+			while ( m_pChunks != NULL )
+			{
+				MarshalArenaChunk*	pNext = m_pChunks->pNext;
+				delete[] reinterpret_cast<char*>( m_pChunks );
+				m_pChunks = pNext;
+			}
+		}
+
+		// Converts a managed string into a native ANSI string living as long as the arena
+		const char*		FromString( String^ _String )
+		{
+			if ( _String == nullptr )
+				return	NULL;
+
+			System::Text::Encoding^	Encoding = System::Text::Encoding::Default;
+			cli::array<wchar_t>^	Chars = _String->ToCharArray();
+			int		ByteCount = _String->Length > 0 ? Encoding->GetByteCount( Chars ) : 0;
+			char*	pResult = Allocate( ByteCount + 1 );
+			if ( ByteCount > 0 )
+			{
+				pin_ptr<wchar_t>	pChars = &Chars[0];
+				Encoding->GetBytes( pChars, Chars->Length, reinterpret_cast<unsigned char*>( pResult ), ByteCount );
+			}
+			pResult[ByteCount] = '\0';
+
+			return	pResult;
+		}
+
+		// Allocates a native block of memory living as long as the arena
+		char*	Allocate( int _Size )
+		{
+			if ( m_pChunks == NULL || m_pChunks->Used + _Size > m_pChunks->Size )
+			{	// Allocate a new chunk
+				int		ChunkSize = _Size > DEFAULT_CHUNK_SIZE ? _Size : DEFAULT_CHUNK_SIZE;
+				MarshalArenaChunk*	pChunk = reinterpret_cast<MarshalArenaChunk*>( new char[sizeof(MarshalArenaChunk) + ChunkSize] );
+				pChunk->pNext = m_pChunks;
+				pChunk->Size = ChunkSize;
+				pChunk->Used = 0;
+				m_pChunks = pChunk;
+			}
+
+			char*	pResult = m_pChunks->GetData() + m_pChunks->Used;
+			m_pChunks->Used += _Size;
+			m_AllocatedBytes += _Size;
+
+			return	pResult;
+		}
+	};
+}
@@ -0,0 +1,279 @@
+// Native normal & tangent space generator
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <math.h>
+#include <string.h>
+#include "TangentSpaceGenerator.h"
+
+using namespace	FBXImporter;
+
+static const float	DEGENERATE_LENGTH = 1e-12f;
+static const float	DEGENERATE_UV_AREA = 1e-20f;
+
+// Polynomial approximation of acos() (Abramowitz & Stegun 4.4.45, absolute error < 7e-5) that is more than enough for weights
+static inline float	FastAcos( float _x )
+{
+	float	x = fabsf( _x );
+	if ( x > 1.0f )
+		x = 1.0f;
+	float	Result = sqrtf( 1.0f - x ) * (1.5707288f + x * (-0.2121144f + x * (0.0742610f + x * -0.0187293f)));
+	return	_x >= 0.0f ? Result : 3.14159265f - Result;
+}
+
+static inline void	Cross( const float* a, const float* b, float* _pResult )
+{
+	_pResult[0] = a[1] * b[2] - a[2] * b[1];
+	_pResult[1] = a[2] * b[0] - a[0] * b[2];
+	_pResult[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static inline float	Dot( const float* a, const float* b )
+{
+	return	a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Normalizes the vector and returns false if it's too small to be normalized
+static inline bool	Normalize( float* _pVector )
+{
+	float	SqLength = Dot( _pVector, _pVector );
+	if ( SqLength < DEGENERATE_LENGTH )
+		return	false;
+
+	float	InvLength = 1.0f / sqrtf( SqLength );
+	_pVector[0] *= InvLength;
+	_pVector[1] *= InvLength;
+	_pVector[2] *= InvLength;
+	return	true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TangentSpaceGenerator
+//
+TangentSpaceGenerator::TangentSpaceGenerator( const float* _pPositions, int _VerticesCount, const int* _pIndices, int _TrianglesCount, const float* _pUVs, const int* _pSmoothingGroups, const float* _pSourceNormals )
+	: m_VerticesCount( _VerticesCount )
+	, m_TrianglesCount( _TrianglesCount )
+	, m_pPositions( _pPositions )
+	, m_pIndices( _pIndices )
+	, m_pUVs( _pUVs )
+	, m_pSmoothingGroups( _pSmoothingGroups )
+	, m_pSourceNormals( _pSourceNormals )
+	, m_pFaceTangents( NULL )
+	, m_pFaceSigns( NULL )
+	, m_pTangents( NULL )
+	, m_pBinormals( NULL )
+{
+	m_pVertexCornerOffsets = new int[_VerticesCount+1];
+	m_pVertexCorners = new int[3*_TrianglesCount];
+
+	m_pFaceNormals = new float[3*_TrianglesCount];
+	m_pCornerAngles = new float[3*_TrianglesCount];
+	m_pNormals = new float[9*_TrianglesCount];
+	if ( _pUVs != NULL )
+	{
+		m_pFaceTangents = new float[3*_TrianglesCount];
+		m_pFaceSigns = new float[_TrianglesCount];
+		m_pTangents = new float[9*_TrianglesCount];
+		m_pBinormals = new float[9*_TrianglesCount];
+	}
+
+	BuildAdjacency();
+}
+
+TangentSpaceGenerator::~TangentSpaceGenerator()
+{
+	delete[] m_pVertexCornerOffsets;
+	delete[] m_pVertexCorners;
+	delete[] m_pFaceNormals;
+	delete[] m_pCornerAngles;
+	delete[] m_pNormals;
+	delete[] m_pFaceTangents;
+	delete[] m_pFaceSigns;
+	delete[] m_pTangents;
+	delete[] m_pBinormals;
+}
+
+void	TangentSpaceGenerator::BuildAdjacency()
+{
+	memset( m_pVertexCornerOffsets, 0, (m_VerticesCount+1) * sizeof(int) );
+	for ( int CornerIndex=0; CornerIndex < 3*m_TrianglesCount; CornerIndex++ )
+		m_pVertexCornerOffsets[m_pIndices[CornerIndex]+1]++;
+	for ( int VertexIndex=0; VertexIndex < m_VerticesCount; VertexIndex++ )
+		m_pVertexCornerOffsets[VertexIndex+1] += m_pVertexCornerOffsets[VertexIndex];
+
+	// Fill using the offsets as cursors then shift them back
+	for ( int CornerIndex=0; CornerIndex < 3*m_TrianglesCount; CornerIndex++ )
+		m_pVertexCorners[m_pVertexCornerOffsets[m_pIndices[CornerIndex]]++] = CornerIndex;
+	for ( int VertexIndex=m_VerticesCount; VertexIndex > 0; VertexIndex-- )
+		m_pVertexCornerOffsets[VertexIndex] = m_pVertexCornerOffsets[VertexIndex-1];
+	m_pVertexCornerOffsets[0] = 0;
+}
+
+void	TangentSpaceGenerator::ComputeFaces( int _FirstTriangle, int _TrianglesCount )
+{
+	for ( int TriangleIndex=_FirstTriangle; TriangleIndex < _FirstTriangle+_TrianglesCount; TriangleIndex++ )
+	{
+		const float*	P[3] =
+		{
+			m_pPositions + 3 * m_pIndices[3*TriangleIndex+0],
+			m_pPositions + 3 * m_pIndices[3*TriangleIndex+1],
+			m_pPositions + 3 * m_pIndices[3*TriangleIndex+2],
+		};
+
+		// 1] Face normal
+		float	Edge0[3] = { P[1][0] - P[0][0], P[1][1] - P[0][1], P[1][2] - P[0][2] };
+		float	Edge1[3] = { P[2][0] - P[0][0], P[2][1] - P[0][1], P[2][2] - P[0][2] };
+		float*	pFaceNormal = m_pFaceNormals + 3*TriangleIndex;
+		Cross( Edge0, Edge1, pFaceNormal );
+		if ( !Normalize( pFaceNormal ) )
+			pFaceNormal[0] = pFaceNormal[1] = pFaceNormal[2] = 0.0f;	// Degenerate faces don't contribute
+
+		// 2] Corner angles
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+		{
+			const float*	P0 = P[CornerIndex];
+			const float*	P1 = P[(CornerIndex+1)%3];
+			const float*	P2 = P[(CornerIndex+2)%3];
+			float	D0[3] = { P1[0] - P0[0], P1[1] - P0[1], P1[2] - P0[2] };
+			float	D1[3] = { P2[0] - P0[0], P2[1] - P0[1], P2[2] - P0[2] };
+			m_pCornerAngles[3*TriangleIndex+CornerIndex] = Normalize( D0 ) && Normalize( D1 ) ? FastAcos( Dot( D0, D1 ) ) : 0.0f;
+		}
+
+		if ( m_pUVs == NULL )
+			continue;
+
+		// 3] Face tangent (U gradient) & UV orientation
+		const float*	pUV = m_pUVs + 6*TriangleIndex;
+		float	s1 = pUV[2] - pUV[0], t1 = pUV[3] - pUV[1];
+		float	s2 = pUV[4] - pUV[0], t2 = pUV[5] - pUV[1];
+		float	SignedArea = s1 * t2 - s2 * t1;
+
+		float*	pFaceTangent = m_pFaceTangents + 3*TriangleIndex;
+		pFaceTangent[0] = t2 * Edge0[0] - t1 * Edge1[0];
+		pFaceTangent[1] = t2 * Edge0[1] - t1 * Edge1[1];
+		pFaceTangent[2] = t2 * Edge0[2] - t1 * Edge1[2];
+		if ( fabsf( SignedArea ) < DEGENERATE_UV_AREA || !Normalize( pFaceTangent ) )
+			pFaceTangent[0] = pFaceTangent[1] = pFaceTangent[2] = 0.0f;
+		else if ( SignedArea < 0.0f )
+		{	// The gradient was computed without dividing by the signed area
+			pFaceTangent[0] = -pFaceTangent[0];
+			pFaceTangent[1] = -pFaceTangent[1];
+			pFaceTangent[2] = -pFaceTangent[2];
+		}
+
+		m_pFaceSigns[TriangleIndex] = SignedArea < 0.0f ? -1.0f : 1.0f;
+	}
+}
+
+void	TangentSpaceGenerator::ComputeVertices( int _FirstVertex, int _VerticesCount )
+{
+	for ( int VertexIndex=_FirstVertex; VertexIndex < _FirstVertex+_VerticesCount; VertexIndex++ )
+	{
+		int	CornersStart = m_pVertexCornerOffsets[VertexIndex];
+		int	CornersEnd = m_pVertexCornerOffsets[VertexIndex+1];
+
+		//////////////////////////////////////////////////////////////////////////
+		// 1] Normals
+		for ( int i=CornersStart; i < CornersEnd; i++ )
+		{
+			int		Corner = m_pVertexCorners[i];
+			int		Triangle = Corner / 3;
+			float*	pNormal = m_pNormals + 3*Corner;
+
+			if ( m_pSourceNormals != NULL )
+			{
+				pNormal[0] = m_pSourceNormals[3*Corner+0];
+				pNormal[1] = m_pSourceNormals[3*Corner+1];
+				pNormal[2] = m_pSourceNormals[3*Corner+2];
+				if ( !Normalize( pNormal ) )
+					memcpy( pNormal, m_pFaceNormals + 3*Triangle, 3*sizeof(float) );
+				continue;
+			}
+
+			int	SmoothingGroups = m_pSmoothingGroups != NULL ? m_pSmoothingGroups[Triangle] : 0;
+			pNormal[0] = pNormal[1] = pNormal[2] = 0.0f;
+			for ( int j=CornersStart; j < CornersEnd; j++ )
+			{
+				int	OtherCorner = m_pVertexCorners[j];
+				int	OtherTriangle = OtherCorner / 3;
+				if ( OtherTriangle != Triangle && m_pSmoothingGroups != NULL && (m_pSmoothingGroups[OtherTriangle] & SmoothingGroups) == 0 )
+					continue;	// Doesn't share any smoothing group with us
+
+				float			Weight = m_pCornerAngles[OtherCorner];
+				const float*	pFaceNormal = m_pFaceNormals + 3*OtherTriangle;
+				pNormal[0] += Weight * pFaceNormal[0];
+				pNormal[1] += Weight * pFaceNormal[1];
+				pNormal[2] += Weight * pFaceNormal[2];
+			}
+
+			if ( !Normalize( pNormal ) )
+			{	// Only degenerate faces around that corner...
+				memcpy( pNormal, m_pFaceNormals + 3*Triangle, 3*sizeof(float) );
+				if ( !Normalize( pNormal ) )
+				{
+					pNormal[0] = pNormal[1] = 0.0f;
+					pNormal[2] = 1.0f;
+				}
+			}
+		}
+
+		if ( m_pUVs == NULL )
+			continue;
+
+		//////////////////////////////////////////////////////////////////////////
+		// 2] Tangents & binormals, averaged among the corners sharing our normal, UV & UV orientation
+		for ( int i=CornersStart; i < CornersEnd; i++ )
+		{
+			int				Corner = m_pVertexCorners[i];
+			int				Triangle = Corner / 3;
+			const float*	pNormal = m_pNormals + 3*Corner;
+			const float*	pUV = m_pUVs + 2*Corner;
+			float			Sign = m_pFaceSigns[Triangle];
+			float*			pTangent = m_pTangents + 3*Corner;
+
+			pTangent[0] = pTangent[1] = pTangent[2] = 0.0f;
+			for ( int j=CornersStart; j < CornersEnd; j++ )
+			{
+				int				OtherCorner = m_pVertexCorners[j];
+				int				OtherTriangle = OtherCorner / 3;
+				const float*	pOtherNormal = m_pNormals + 3*OtherCorner;
+				const float*	pOtherUV = m_pUVs + 2*OtherCorner;
+				if ( m_pFaceSigns[OtherTriangle] != Sign
+					|| pOtherUV[0] != pUV[0] || pOtherUV[1] != pUV[1]
+					|| pOtherNormal[0] != pNormal[0] || pOtherNormal[1] != pNormal[1] || pOtherNormal[2] != pNormal[2] )
+					continue;	// Not the same MikkTSpace vertex
+
+				// Project the face tangent on the normal's plane
+				const float*	pFaceTangent = m_pFaceTangents + 3*OtherTriangle;
+				float			NdotT = Dot( pNormal, pFaceTangent );
+				float			Projected[3] = { pFaceTangent[0] - NdotT * pNormal[0], pFaceTangent[1] - NdotT * pNormal[1], pFaceTangent[2] - NdotT * pNormal[2] };
+				if ( !Normalize( Projected ) )
+					continue;
+
+				float	Weight = m_pCornerAngles[OtherCorner];
+				pTangent[0] += Weight * Projected[0];
+				pTangent[1] += Weight * Projected[1];
+				pTangent[2] += Weight * Projected[2];
+			}
+
+			if ( !Normalize( pTangent ) )
+			{	// Degenerate UVs: use any vector orthogonal to the normal
+				float	Axis[3] = { 0.0f, 0.0f, 0.0f };
+				Axis[fabsf( pNormal[0] ) < 0.9f ? 0 : 1] = 1.0f;
+				float	AdotN = Dot( Axis, pNormal );
+				pTangent[0] = Axis[0] - AdotN * pNormal[0];
+				pTangent[1] = Axis[1] - AdotN * pNormal[1];
+				pTangent[2] = Axis[2] - AdotN * pNormal[2];
+				Normalize( pTangent );
+			}
+
+			float*	pBinormal = m_pBinormals + 3*Corner;
+			Cross( pNormal, pTangent, pBinormal );
+			pBinormal[0] *= Sign;
+			pBinormal[1] *= Sign;
+			pBinormal[2] *= Sign;
+		}
+	}
+}
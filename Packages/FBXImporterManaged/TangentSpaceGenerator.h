@@ -0,0 +1,86 @@
+// Contains the native normal & tangent space generator
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Generates per-corner normals, tangents & binormals from flat position, index & UV arrays
+	//
+	// Normals are the angle-weighted average of the normals of the faces sharing a control point and at least one smoothing group
+	//	(a face with no smoothing group is flat). Without smoothing groups, all the faces are smooth.
+	//
+	// Tangents follow the MikkTSpace conventions (http://www.mikktspace.com) so normal maps baked with the usual tools match:
+	//	_ Face tangents are the U gradients projected on the corner normals, then averaged with angle weights among corners sharing
+	//		the same control point, normal, UV & UV orientation (i.e. UV seams and mirrored UVs split tangents)
+	//	_ Binormals are Sign * Cross( Normal, Tangent ), Sign being -1 for faces with mirrored UVs
+	//
+	// The work is split into 2 stages that can each be run in parallel chunks:
+	//	1] ComputeFaces() processes a range of triangles
+	//	2] ComputeVertices() processes a range of control points, writing the corners that reference them
+	// All the chunks of the first stage must be complete before starting the second one.
+	//
+	class	TangentSpaceGenerator
+	{
+	protected:	// FIELDS
+
+		int					m_VerticesCount;
+		int					m_TrianglesCount;
+
+		// Inputs
+		const float*		m_pPositions;		// 3 floats per control point
+		const int*			m_pIndices;			// 3 control points per triangle
+		const float*		m_pUVs;				// 2 floats per corner (optional)
+		const int*			m_pSmoothingGroups;	// 1 bit mask per triangle (optional)
+		const float*		m_pSourceNormals;	// 3 floats per corner (optional, normals are then only normalized)
+
+		// Corners adjacency
+		int*				m_pVertexCornerOffsets;	// Offset of each control point's corners in the adjacency array (+1 to get the end)
+		int*				m_pVertexCorners;		// The corners referencing each control point
+
+		// Per-face data
+		float*				m_pFaceNormals;		// 3 floats per face
+		float*				m_pFaceTangents;	// 3 floats per face (normalized U gradient, null for degenerate UVs)
+		float*				m_pFaceSigns;		// 1 float per face (+1 or -1 for mirrored UVs)
+		float*				m_pCornerAngles;	// 1 float per corner
+
+		// Outputs (3 floats per corner)
+		float*				m_pNormals;
+		float*				m_pTangents;
+		float*				m_pBinormals;
+
+	public:		// PROPERTIES
+
+		int				GetVerticesCount() const	{ return m_VerticesCount; }
+		int				GetTrianglesCount() const	{ return m_TrianglesCount; }
+		bool			HasTangents() const			{ return m_pUVs != NULL; }
+
+		const float*	GetNormals() const			{ return m_pNormals; }
+		const float*	GetTangents() const			{ return m_pTangents; }
+		const float*	GetBinormals() const		{ return m_pBinormals; }
+
+	public:		// METHODS
+
+		// The input arrays must remain valid until the generator is destroyed
+		// _pUVs, 2 floats per corner (NULL to only generate normals)
+		// _pSmoothingGroups, 1 mask per triangle (NULL if all the faces are smooth)
+		// _pSourceNormals, 3 floats per corner (NULL to generate normals)
+		TangentSpaceGenerator( const float* _pPositions, int _VerticesCount, const int* _pIndices, int _TrianglesCount, const float* _pUVs, const int* _pSmoothingGroups, const float* _pSourceNormals );
+		~TangentSpaceGenerator();
+
+		// Stage 1: computes the normals, tangents & corner angles of a range of faces
+		void	ComputeFaces( int _FirstTriangle, int _TrianglesCount );
+
+		// Stage 2: computes the normals, tangents & binormals of the corners referencing a range of control points
+		void	ComputeVertices( int _FirstVertex, int _VerticesCount );
+
+	protected:
+
+		// Builds the corners adjacency of each control point (counting sort)
+		void	BuildAdjacency();
+
+	private:
+		TangentSpaceGenerator( const TangentSpaceGenerator& );
+		TangentSpaceGenerator&	operator=( const TangentSpaceGenerator& );
+	};
+}
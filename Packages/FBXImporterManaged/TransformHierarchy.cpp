@@ -0,0 +1,210 @@
+// Native flattened transform hierarchy
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <string.h>
+#include <float.h>
+#include <xmmintrin.h>
+#include "TransformHierarchy.h"
+
+using namespace	FBXImporter;
+
+static const float	IDENTITY[16] =
+{
+	1.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 1.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 1.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 1.0f,
+};
+
+static const union { unsigned int i[4]; float f[4]; }	ABS_MASK = { { 0x7FFFFFFFU, 0x7FFFFFFFU, 0x7FFFFFFFU, 0x7FFFFFFFU } };
+
+// Computes _pResult = _pA * _pB (row-vector convention, _pResult must not alias _pA)
+static inline void	MultiplyMatrices( const float* _pA, const float* _pB, float* _pResult )
+{
+	__m128	B0 = _mm_loadu_ps( _pB+0 );
+	__m128	B1 = _mm_loadu_ps( _pB+4 );
+	__m128	B2 = _mm_loadu_ps( _pB+8 );
+	__m128	B3 = _mm_loadu_ps( _pB+12 );
+	for ( int RowIndex=0; RowIndex < 4; RowIndex++ )
+	{
+		const float*	pRow = _pA + 4*RowIndex;
+		__m128	Row = _mm_mul_ps( _mm_set1_ps( pRow[0] ), B0 );
+				Row = _mm_add_ps( Row, _mm_mul_ps( _mm_set1_ps( pRow[1] ), B1 ) );
+				Row = _mm_add_ps( Row, _mm_mul_ps( _mm_set1_ps( pRow[2] ), B2 ) );
+				Row = _mm_add_ps( Row, _mm_mul_ps( _mm_set1_ps( pRow[3] ), B3 ) );
+		_mm_storeu_ps( _pResult + 4*RowIndex, Row );
+	}
+}
+
+// Computes the AABB of a transformed AABB using its center & extents
+static inline void	TransformBounds( const float* _pBounds, const float* _pMatrix, float* _pResult )
+{
+	if ( _pBounds[0] > _pBounds[3] )
+	{	// Empty bounds stay empty
+		_pResult[0] = _pResult[1] = _pResult[2] = FLT_MAX;
+		_pResult[3] = _pResult[4] = _pResult[5] = -FLT_MAX;
+		return;
+	}
+
+	__m128	Row0 = _mm_loadu_ps( _pMatrix+0 );
+	__m128	Row1 = _mm_loadu_ps( _pMatrix+4 );
+	__m128	Row2 = _mm_loadu_ps( _pMatrix+8 );
+	__m128	Row3 = _mm_loadu_ps( _pMatrix+12 );
+	__m128	Abs = _mm_loadu_ps( ABS_MASK.f );
+
+	float	Center[3] = { 0.5f * (_pBounds[0] + _pBounds[3]), 0.5f * (_pBounds[1] + _pBounds[4]), 0.5f * (_pBounds[2] + _pBounds[5]) };
+	float	Extents[3] = { 0.5f * (_pBounds[3] - _pBounds[0]), 0.5f * (_pBounds[4] - _pBounds[1]), 0.5f * (_pBounds[5] - _pBounds[2]) };
+
+	__m128	WorldCenter = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( Center[0] ), Row0 ), _mm_mul_ps( _mm_set1_ps( Center[1] ), Row1 ) ), _mm_add_ps( _mm_mul_ps( _mm_set1_ps( Center[2] ), Row2 ), Row3 ) );
+	__m128	WorldExtents = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( Extents[0] ), _mm_and_ps( Row0, Abs ) ), _mm_mul_ps( _mm_set1_ps( Extents[1] ), _mm_and_ps( Row1, Abs ) ) ), _mm_mul_ps( _mm_set1_ps( Extents[2] ), _mm_and_ps( Row2, Abs ) ) );
+
+	float	pMin[4], pMax[4];
+	_mm_storeu_ps( pMin, _mm_sub_ps( WorldCenter, WorldExtents ) );
+	_mm_storeu_ps( pMax, _mm_add_ps( WorldCenter, WorldExtents ) );
+	_pResult[0] = pMin[0];	_pResult[1] = pMin[1];	_pResult[2] = pMin[2];
+	_pResult[3] = pMax[0];	_pResult[4] = pMax[1];	_pResult[5] = pMax[2];
+}
+
+TransformHierarchy::TransformHierarchy( const int* _pParents, int _NodesCount )
+	: m_NodesCount( _NodesCount )
+	, m_DirtyCount( _NodesCount )
+{
+	m_pParents = new int[_NodesCount+1];
+	m_pSubtreeEnds = new int[_NodesCount+1];
+	m_pLocals = new float[16*_NodesCount+1];
+	m_pWorlds = new float[16*_NodesCount+1];
+	m_pGeometryOffsets = new float[16*_NodesCount+1];
+	m_pLocalBounds = new float[6*_NodesCount+1];
+	m_pWorldBounds = new float[6*_NodesCount+1];
+	m_pGenerations = new int[_NodesCount+1];
+	m_pDirty = new unsigned char[_NodesCount+1];
+
+	memcpy( m_pParents, _pParents, _NodesCount*sizeof(int) );
+	for ( int NodeIndex=0; NodeIndex < _NodesCount; NodeIndex++ )
+	{
+		memcpy( m_pLocals + 16*NodeIndex, IDENTITY, 16*sizeof(float) );
+		memcpy( m_pWorlds + 16*NodeIndex, IDENTITY, 16*sizeof(float) );
+		m_pGenerations[NodeIndex] = 0;
+		m_pDirty[NodeIndex] = 1;
+		SetBounds( NodeIndex, NULL, NULL, NULL );
+	}
+
+	// Subtree ends are propagated backward: a node's subtree ends where its last descendant's subtree ends
+	for ( int NodeIndex=0; NodeIndex < _NodesCount; NodeIndex++ )
+		m_pSubtreeEnds[NodeIndex] = NodeIndex+1;
+	for ( int NodeIndex=_NodesCount-1; NodeIndex >= 0; NodeIndex-- )
+	{
+		int	Parent = m_pParents[NodeIndex];
+		if ( Parent >= 0 && m_pSubtreeEnds[NodeIndex] > m_pSubtreeEnds[Parent] )
+			m_pSubtreeEnds[Parent] = m_pSubtreeEnds[NodeIndex];
+	}
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+	delete[] m_pParents;
+	delete[] m_pSubtreeEnds;
+	delete[] m_pLocals;
+	delete[] m_pWorlds;
+	delete[] m_pGeometryOffsets;
+	delete[] m_pLocalBounds;
+	delete[] m_pWorldBounds;
+	delete[] m_pGenerations;
+	delete[] m_pDirty;
+}
+
+void	TransformHierarchy::SetLocal( int _Index, const float* _pLocal )
+{
+	memcpy( m_pLocals + 16*_Index, _pLocal, 16*sizeof(float) );
+	MarkDirty( _Index );
+}
+
+void	TransformHierarchy::SetLocals( const int* _pIndices, int _Count, const float* _pLocals )
+{
+	for ( int i=0; i < _Count; i++ )
+		SetLocal( _pIndices[i], _pLocals + 16*i );
+}
+
+void	TransformHierarchy::SetBounds( int _Index, const float* _pMin, const float* _pMax, const float* _pGeometryOffset )
+{
+	float*	pBounds = m_pLocalBounds + 6*_Index;
+	if ( _pMin != NULL && _pMax != NULL )
+	{
+		memcpy( pBounds+0, _pMin, 3*sizeof(float) );
+		memcpy( pBounds+3, _pMax, 3*sizeof(float) );
+	}
+	else
+	{
+		pBounds[0] = pBounds[1] = pBounds[2] = FLT_MAX;
+		pBounds[3] = pBounds[4] = pBounds[5] = -FLT_MAX;
+	}
+
+	memcpy( m_pGeometryOffsets + 16*_Index, _pGeometryOffset != NULL ? _pGeometryOffset : IDENTITY, 16*sizeof(float) );
+	MarkDirty( _Index );
+}
+
+void	TransformHierarchy::MarkDirty( int _Index )
+{
+	if ( m_pDirty[_Index] )
+		return;
+
+	m_pDirty[_Index] = 1;
+	m_DirtyCount++;
+}
+
+int		TransformHierarchy::Update()
+{
+	if ( m_DirtyCount == 0 )
+		return	0;
+
+	int	UpdatedCount = 0;
+	int	NodeIndex = 0;
+	while ( NodeIndex < m_NodesCount )
+	{
+		if ( !m_pDirty[NodeIndex] )
+		{
+			NodeIndex++;
+			continue;
+		}
+
+		// Recompute the whole subtree, which is stored contiguously right after the node
+		int	SubtreeEnd = m_pSubtreeEnds[NodeIndex];
+		for ( int SubtreeIndex=NodeIndex; SubtreeIndex < SubtreeEnd; SubtreeIndex++ )
+		{
+			ComputeWorld( SubtreeIndex );
+			m_pDirty[SubtreeIndex] = 0;
+		}
+
+		UpdatedCount += SubtreeEnd - NodeIndex;
+		NodeIndex = SubtreeEnd;
+	}
+
+	m_DirtyCount = 0;
+
+	return	UpdatedCount;
+}
+
+void	TransformHierarchy::ComputeWorld( int _Index )
+{
+	float*	pWorld = m_pWorlds + 16*_Index;
+	int		Parent = m_pParents[_Index];
+	if ( Parent >= 0 )
+		MultiplyMatrices( m_pLocals + 16*_Index, m_pWorlds + 16*Parent, pWorld );
+	else
+		memcpy( pWorld, m_pLocals + 16*_Index, 16*sizeof(float) );
+
+	const float*	pLocalBounds = m_pLocalBounds + 6*_Index;
+	if ( pLocalBounds[0] <= pLocalBounds[3] )
+	{
+		float	pGeometryToWorld[16];
+		MultiplyMatrices( m_pGeometryOffsets + 16*_Index, pWorld, pGeometryToWorld );
+		TransformBounds( pLocalBounds, pGeometryToWorld, m_pWorldBounds + 6*_Index );
+	}
+	else
+		TransformBounds( pLocalBounds, pWorld, m_pWorldBounds + 6*_Index );
+
+	m_pGenerations[_Index]++;
+}
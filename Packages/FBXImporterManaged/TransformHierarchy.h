@@ -0,0 +1,78 @@
+// Contains the native flattened transform hierarchy
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A hierarchy of transforms stored as flat arrays in depth-first order
+	// Parents always come before their children and the descendants of a node are stored right after it, up to its subtree end.
+	//
+	// Matrices are 16 floats in row-vector convention (i.e. translation in the 4th row) and World = Local * ParentWorld.
+	// A node may have local bounds with a geometry offset (e.g. a mesh pivot), its world bounds being the AABB of the
+	//	local bounds transformed by GeometryOffset * World.
+	//
+	// Changing a local transform only flags the node as dirty. Update() then recomputes the world transforms & bounds
+	//	of the dirty subtrees in a single forward sweep, leaving the rest of the hierarchy untouched.
+	//
+	class	TransformHierarchy
+	{
+	protected:	// FIELDS
+
+		int					m_NodesCount;
+		int*				m_pParents;			// Index of each node's parent (-1 for roots)
+		int*				m_pSubtreeEnds;		// Index following the last descendant of each node
+		float*				m_pLocals;			// 16 floats per node
+		float*				m_pWorlds;			// 16 floats per node
+		float*				m_pGeometryOffsets;	// 16 floats per node
+		float*				m_pLocalBounds;		// 6 floats per node (Min & Max, empty if Min > Max)
+		float*				m_pWorldBounds;		// 6 floats per node
+		int*				m_pGenerations;		// Incremented each time the world transform of a node is recomputed
+		unsigned char*		m_pDirty;
+		int					m_DirtyCount;
+
+	public:		// PROPERTIES
+
+		int				GetNodesCount() const				{ return m_NodesCount; }
+		bool			IsDirty() const						{ return m_DirtyCount > 0; }
+		int				GetParent( int _Index ) const		{ return m_pParents[_Index]; }
+		int				GetSubtreeEnd( int _Index ) const	{ return m_pSubtreeEnds[_Index]; }
+		int				GetGeneration( int _Index ) const	{ return m_pGenerations[_Index]; }
+		const float*	GetLocal( int _Index ) const		{ return m_pLocals + 16*_Index; }
+		const float*	GetWorld( int _Index ) const		{ return m_pWorlds + 16*_Index; }
+		const float*	GetWorldBounds( int _Index ) const	{ return m_pWorldBounds + 6*_Index; }
+		const float*	GetWorlds() const					{ return m_pWorlds; }
+
+	public:		// METHODS
+
+		// _pParents gives the parent of each node which must have a lower index than the node itself, subtrees being contiguous
+		// All the transforms are initialized to identity, without bounds, and flagged as dirty
+		TransformHierarchy( const int* _pParents, int _NodesCount );
+		~TransformHierarchy();
+
+		// Sets the local transform of a node and flags it as dirty
+		void	SetLocal( int _Index, const float* _pLocal );
+
+		// Sets the local transforms of a list of nodes (16 floats per node) and flags them as dirty
+		void	SetLocals( const int* _pIndices, int _Count, const float* _pLocals );
+
+		// Sets the local bounds of a node (NULL to remove them) and the geometry offset to apply first (NULL for identity)
+		void	SetBounds( int _Index, const float* _pMin, const float* _pMax, const float* _pGeometryOffset );
+
+		// Flags a node as dirty so its subtree gets recomputed on the next update
+		void	MarkDirty( int _Index );
+
+		// Recomputes the world transforms & bounds of all the dirty subtrees
+		// Returns the amount of nodes that were recomputed
+		int		Update();
+
+	protected:
+
+		// Computes the world transform and bounds of a node whose parent is up to date
+		void	ComputeWorld( int _Index );
+
+	private:
+		TransformHierarchy( const TransformHierarchy& );
+		TransformHierarchy&	operator=( const TransformHierarchy& );
+	};
+}
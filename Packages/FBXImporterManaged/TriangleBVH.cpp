@@ -0,0 +1,793 @@
+// Native triangle BVH
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <math.h>
+#include <string.h>
+#include <float.h>
+#include <xmmintrin.h>
+#include "TriangleBVH.h"
+
+using namespace	FBXImporter;
+
+static const float	TRAVERSAL_COST = 1.0f;		// Cost of a node traversal relative to a triangle test
+static const float	DEGENERATE_DETERMINANT = 1e-12f;
+static const float	LARGE_INVERSE = 1e30f;		// Used instead of infinity for null direction components to avoid NaNs in slab tests
+
+// Masks used to ignore the 4th lane of the nodes' Min & Max (which contains the node's indices)
+static const union { unsigned int i[4]; float f[4]; }	XYZ_MASK = { { 0xFFFFFFFFU, 0xFFFFFFFFU, 0xFFFFFFFFU, 0 } };
+static const union { unsigned int i[4]; float f[4]; }	W_INFINITY = { { 0xFF800000U, 0xFF800000U, 0xFF800000U, 0x7F800000U } };	// -inf, -inf, -inf, +inf
+static const union { unsigned int i[4]; float f[4]; }	ABS_MASK = { { 0x7FFFFFFFU, 0x7FFFFFFFU, 0x7FFFFFFFU, 0x7FFFFFFFU } };
+
+static inline float	SafeInverse( float _Value )
+{
+	if ( fabsf( _Value ) > 1e-30f )
+		return	1.0f / _Value;
+	return	_Value >= 0.0f ? LARGE_INVERSE : -LARGE_INVERSE;
+}
+
+static inline float	HalfArea( const float* _pMin, const float* _pMax )
+{
+	float	dx = _pMax[0] - _pMin[0];
+	float	dy = _pMax[1] - _pMin[1];
+	float	dz = _pMax[2] - _pMin[2];
+	return	dx * dy + dy * dz + dz * dx;
+}
+
+static inline void	GrowBounds( float* _pMin, float* _pMax, const float* _pOtherMin, const float* _pOtherMax )
+{
+	for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+	{
+		if ( _pOtherMin[ComponentIndex] < _pMin[ComponentIndex] )	_pMin[ComponentIndex] = _pOtherMin[ComponentIndex];
+		if ( _pOtherMax[ComponentIndex] > _pMax[ComponentIndex] )	_pMax[ComponentIndex] = _pOtherMax[ComponentIndex];
+	}
+}
+
+static inline float	HorizontalMax( __m128 _v )
+{
+	__m128	a = _mm_max_ps( _v, _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+			a = _mm_max_ps( a, _mm_shuffle_ps( a, a, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	return	_mm_cvtss_f32( a );
+}
+
+static inline float	HorizontalMin( __m128 _v )
+{
+	__m128	a = _mm_min_ps( _v, _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+			a = _mm_min_ps( a, _mm_shuffle_ps( a, a, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	return	_mm_cvtss_f32( a );
+}
+
+static inline __m128	Select( __m128 _Mask, __m128 _a, __m128 _b )
+{
+	return	_mm_or_ps( _mm_and_ps( _Mask, _a ), _mm_andnot_ps( _Mask, _b ) );
+}
+
+// Returns the entry distance of a single ray into a node or FLT_MAX if the node is missed (or further than _MaxDistance)
+static inline float	IntersectNode( const BVHNode& _Node, __m128 _Origin, __m128 _InvDirection, float _MaxDistance )
+{
+	__m128	Mask = _mm_loadu_ps( XYZ_MASK.f );
+	__m128	Min = _mm_and_ps( _mm_loadu_ps( _Node.Min ), Mask );
+	__m128	Max = _mm_and_ps( _mm_loadu_ps( _Node.Max ), Mask );
+	__m128	t0 = _mm_mul_ps( _mm_sub_ps( Min, _Origin ), _InvDirection );
+	__m128	t1 = _mm_mul_ps( _mm_sub_ps( Max, _Origin ), _InvDirection );
+
+	// The 4th lane yields 0 which clamps the entry distance to the ray's origin, and is replaced by +inf for the exit distance
+	float	Near = HorizontalMax( _mm_min_ps( t0, t1 ) );
+	float	Far = HorizontalMin( _mm_max_ps( _mm_max_ps( t0, t1 ), _mm_loadu_ps( W_INFINITY.f ) ) );
+	if ( Far > _MaxDistance )
+		Far = _MaxDistance;
+
+	return	Near <= Far ? Near : FLT_MAX;
+}
+
+// Möller-Trumbore test of a single ray against a precomputed triangle (Vertex0, Edge1, Edge2)
+static inline bool	IntersectTriangle( const float* _pTriangle, const float* _pOrigin, const float* _pDirection, float _MaxDistance, float& _Distance, float& _U, float& _V )
+{
+	const float*	V0 = _pTriangle;
+	const float*	E1 = _pTriangle + 3;
+	const float*	E2 = _pTriangle + 6;
+
+	float	P[3] = { _pDirection[1] * E2[2] - _pDirection[2] * E2[1], _pDirection[2] * E2[0] - _pDirection[0] * E2[2], _pDirection[0] * E2[1] - _pDirection[1] * E2[0] };
+	float	Det = E1[0] * P[0] + E1[1] * P[1] + E1[2] * P[2];
+	if ( fabsf( Det ) < DEGENERATE_DETERMINANT )
+		return	false;
+	float	InvDet = 1.0f / Det;
+
+	float	S[3] = { _pOrigin[0] - V0[0], _pOrigin[1] - V0[1], _pOrigin[2] - V0[2] };
+	float	U = InvDet * (S[0] * P[0] + S[1] * P[1] + S[2] * P[2]);
+	if ( U < 0.0f || U > 1.0f )
+		return	false;
+
+	float	Q[3] = { S[1] * E1[2] - S[2] * E1[1], S[2] * E1[0] - S[0] * E1[2], S[0] * E1[1] - S[1] * E1[0] };
+	float	V = InvDet * (_pDirection[0] * Q[0] + _pDirection[1] * Q[1] + _pDirection[2] * Q[2]);
+	if ( V < 0.0f || U + V > 1.0f )
+		return	false;
+
+	float	t = InvDet * (E2[0] * Q[0] + E2[1] * Q[1] + E2[2] * Q[2]);
+	if ( t < 0.0f || t >= _MaxDistance )
+		return	false;
+
+	_Distance = t;
+	_U = U;
+	_V = V;
+	return	true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// TriangleBVH
+//
+TriangleBVH::TriangleBVH( const float* _pVertices, int _VerticesCount, const int* _pIndices, int _TrianglesCount )
+	: m_VerticesCount( _VerticesCount )
+	, m_TrianglesCount( _TrianglesCount )
+	, m_pCentroids( NULL )
+	, m_pTriangleBounds( NULL )
+	, m_pBuildNodes( NULL )
+	, m_TopNodesCount( 0 )
+	, m_TopNodesCapacity( 0 )
+	, m_pTasks( NULL )
+	, m_TasksCount( 0 )
+	, m_pNodes( NULL )
+	, m_NodesCount( 0 )
+	, m_Depth( 0 )
+	, m_pTriangles( NULL )
+{
+	m_pVertices = new float[3*_VerticesCount+1];
+	memcpy( m_pVertices, _pVertices, 3*_VerticesCount*sizeof(float) );
+	m_pIndices = new int[3*_TrianglesCount+1];
+	memcpy( m_pIndices, _pIndices, 3*_TrianglesCount*sizeof(int) );
+
+	m_pTriangleOrder = new int[_TrianglesCount+1];
+	for ( int TriangleIndex=0; TriangleIndex < _TrianglesCount; TriangleIndex++ )
+		m_pTriangleOrder[TriangleIndex] = TriangleIndex;
+}
+
+TriangleBVH::~TriangleBVH()
+{
+	delete[] m_pVertices;
+	delete[] m_pIndices;
+	delete[] m_pTriangleOrder;
+	delete[] m_pCentroids;
+	delete[] m_pTriangleBounds;
+	delete[] m_pBuildNodes;
+	delete[] m_pTasks;
+	delete[] m_pNodes;
+	delete[] m_pTriangles;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Building
+//
+int	TriangleBVH::BeginBuild( int _TasksCount )
+{
+	if ( _TasksCount < 1 )
+		_TasksCount = 1;
+
+	m_TasksCount = 0;
+	m_TopNodesCount = 0;
+	if ( m_TrianglesCount == 0 )
+		return	0;
+
+	// Compute the bounds & centroids of all the triangles
+	m_pCentroids = new float[3*m_TrianglesCount];
+	m_pTriangleBounds = new float[6*m_TrianglesCount];
+	for ( int TriangleIndex=0; TriangleIndex < m_TrianglesCount; TriangleIndex++ )
+	{
+		float*	pMin = m_pTriangleBounds + 6*TriangleIndex;
+		float*	pMax = pMin + 3;
+		for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+		{
+			float	a = m_pVertices[3*m_pIndices[3*TriangleIndex+0]+ComponentIndex];
+			float	b = m_pVertices[3*m_pIndices[3*TriangleIndex+1]+ComponentIndex];
+			float	c = m_pVertices[3*m_pIndices[3*TriangleIndex+2]+ComponentIndex];
+			pMin[ComponentIndex] = a < b ? (a < c ? a : c) : (b < c ? b : c);
+			pMax[ComponentIndex] = a > b ? (a > c ? a : c) : (b > c ? b : c);
+			m_pCentroids[3*TriangleIndex+ComponentIndex] = 0.5f * (pMin[ComponentIndex] + pMax[ComponentIndex]);
+		}
+	}
+
+	// The top of the tree has at most 2*_TasksCount-1 nodes, subtrees get 2 slots per triangle after that
+	m_TopNodesCapacity = 2 * _TasksCount;
+	m_pBuildNodes = new BVHNode[m_TopNodesCapacity + 2*m_TrianglesCount];
+	m_pTasks = new BuildTask[_TasksCount];
+
+	// Split the largest range until we get enough of them
+	m_pTasks[0].NodeIndex = 0;
+	m_pTasks[0].FirstTriangle = 0;
+	m_pTasks[0].TrianglesCount = m_TrianglesCount;
+	m_pTasks[0].Depth = 1;
+	m_TasksCount = 1;
+	m_TopNodesCount = 1;
+	ComputeNodeBounds( m_pBuildNodes[0], 0, m_TrianglesCount );
+
+	while ( m_TasksCount < _TasksCount )
+	{
+		int	LargestTaskIndex = -1;
+		for ( int TaskIndex=0; TaskIndex < m_TasksCount; TaskIndex++ )
+			if ( m_pTasks[TaskIndex].TrianglesCount >= MIN_SUBTREE_SIZE && (LargestTaskIndex < 0 || m_pTasks[TaskIndex].TrianglesCount > m_pTasks[LargestTaskIndex].TrianglesCount) )
+				LargestTaskIndex = TaskIndex;
+		if ( LargestTaskIndex < 0 )
+			break;	// All the remaining ranges are too small to be worth it
+
+		BuildTask&	Task = m_pTasks[LargestTaskIndex];
+		BVHNode&	Node = m_pBuildNodes[Task.NodeIndex];
+		int			LeftCount = Split( Task.FirstTriangle, Task.TrianglesCount, Node );
+
+		int	ChildIndex = m_TopNodesCount;
+		m_TopNodesCount += 2;
+		Node.FirstChildOrTriangle = ChildIndex;
+		Node.TrianglesCount = 0;
+		ComputeNodeBounds( m_pBuildNodes[ChildIndex+0], Task.FirstTriangle, LeftCount );
+		ComputeNodeBounds( m_pBuildNodes[ChildIndex+1], Task.FirstTriangle + LeftCount, Task.TrianglesCount - LeftCount );
+
+		BuildTask&	RightTask = m_pTasks[m_TasksCount++];
+		RightTask.NodeIndex = ChildIndex+1;
+		RightTask.FirstTriangle = Task.FirstTriangle + LeftCount;
+		RightTask.TrianglesCount = Task.TrianglesCount - LeftCount;
+		RightTask.Depth = Task.Depth + 1;
+
+		Task.NodeIndex = ChildIndex;
+		Task.TrianglesCount = LeftCount;
+		Task.Depth++;
+	}
+
+	return	m_TasksCount;
+}
+
+void	TriangleBVH::BuildSubtree( int _TaskIndex )
+{
+	// Each subtree allocates its nodes in the 2 slots per triangle reserved for its range so subtrees never overlap
+	int	NextNode = m_TopNodesCapacity + 2 * m_pTasks[_TaskIndex].FirstTriangle;
+	Subdivide( m_pBuildNodes, m_pTasks[_TaskIndex], NextNode );
+}
+
+void	TriangleBVH::EndBuild()
+{
+	delete[] m_pNodes;
+	m_pNodes = NULL;
+	m_NodesCount = 0;
+	m_Depth = 0;
+
+	if ( m_TrianglesCount > 0 )
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// Lay the nodes out in depth-first order
+		m_pNodes = new BVHNode[2*m_TrianglesCount];
+		m_pNodes[0] = m_pBuildNodes[0];
+		m_NodesCount = 1;
+
+		int*	pStack = new int[3*MAX_DEPTH*2];	// Sparse index, compact index & depth
+		int		StackSize = 0;
+		pStack[StackSize++] = 0;
+		pStack[StackSize++] = 0;
+		pStack[StackSize++] = 1;
+		while ( StackSize > 0 )
+		{
+			int	Depth = pStack[--StackSize];
+			int	CompactIndex = pStack[--StackSize];
+			int	SparseIndex = pStack[--StackSize];
+			if ( Depth > m_Depth )
+				m_Depth = Depth;
+
+			const BVHNode&	Source = m_pBuildNodes[SparseIndex];
+			if ( Source.IsLeaf() )
+				continue;
+
+			int	SparseChild = Source.FirstChildOrTriangle;
+			int	CompactChild = m_NodesCount;
+			m_NodesCount += 2;
+			m_pNodes[CompactChild+0] = m_pBuildNodes[SparseChild+0];
+			m_pNodes[CompactChild+1] = m_pBuildNodes[SparseChild+1];
+			m_pNodes[CompactIndex].FirstChildOrTriangle = CompactChild;
+
+			// Push the right child first so the left subtree directly follows its parent's children
+			pStack[StackSize++] = SparseChild+1;
+			pStack[StackSize++] = CompactChild+1;
+			pStack[StackSize++] = Depth+1;
+			pStack[StackSize++] = SparseChild+0;
+			pStack[StackSize++] = CompactChild+0;
+			pStack[StackSize++] = Depth+1;
+		}
+		delete[] pStack;
+
+		//////////////////////////////////////////////////////////////////////////
+		// Store the triangles in leaf order
+		m_pTriangles = new float[9*m_TrianglesCount];
+		RefitTriangles( 0, m_TrianglesCount );
+	}
+
+	delete[] m_pCentroids;
+	delete[] m_pTriangleBounds;
+	delete[] m_pBuildNodes;
+	delete[] m_pTasks;
+	m_pCentroids = NULL;
+	m_pTriangleBounds = NULL;
+	m_pBuildNodes = NULL;
+	m_pTasks = NULL;
+}
+
+void	TriangleBVH::ComputeNodeBounds( BVHNode& _Node, int _FirstTriangle, int _TrianglesCount ) const
+{
+	_Node.Min[0] = _Node.Min[1] = _Node.Min[2] = FLT_MAX;
+	_Node.Max[0] = _Node.Max[1] = _Node.Max[2] = -FLT_MAX;
+	for ( int i=_FirstTriangle; i < _FirstTriangle+_TrianglesCount; i++ )
+	{
+		const float*	pBounds = m_pTriangleBounds + 6*m_pTriangleOrder[i];
+		GrowBounds( _Node.Min, _Node.Max, pBounds, pBounds+3 );
+	}
+}
+
+int	TriangleBVH::Split( int _FirstTriangle, int _TrianglesCount, const BVHNode& _Node )
+{
+	if ( _TrianglesCount <= 1 )
+		return	0;
+
+	int*	pOrder = m_pTriangleOrder + _FirstTriangle;
+
+	// 1] Compute the bounds of the centroids
+	float	CentroidMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float	CentroidMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for ( int i=0; i < _TrianglesCount; i++ )
+	{
+		const float*	pCentroid = m_pCentroids + 3*pOrder[i];
+		GrowBounds( CentroidMin, CentroidMax, pCentroid, pCentroid );
+	}
+
+	// 2] Find the best binned split on every axis
+	float	BestCost = FLT_MAX;
+	int		BestAxis = -1;
+	int		BestBin = 0;
+	for ( int Axis=0; Axis < 3; Axis++ )
+	{
+		float	Extent = CentroidMax[Axis] - CentroidMin[Axis];
+		if ( Extent <= 0.0f )
+			continue;
+
+		float	BinsMin[BINS_COUNT][3];
+		float	BinsMax[BINS_COUNT][3];
+		int		BinsCount[BINS_COUNT];
+		for ( int BinIndex=0; BinIndex < BINS_COUNT; BinIndex++ )
+		{
+			BinsMin[BinIndex][0] = BinsMin[BinIndex][1] = BinsMin[BinIndex][2] = FLT_MAX;
+			BinsMax[BinIndex][0] = BinsMax[BinIndex][1] = BinsMax[BinIndex][2] = -FLT_MAX;
+			BinsCount[BinIndex] = 0;
+		}
+
+		float	Scale = BINS_COUNT * 0.99999f / Extent;
+		for ( int i=0; i < _TrianglesCount; i++ )
+		{
+			int		BinIndex = (int) ((m_pCentroids[3*pOrder[i]+Axis] - CentroidMin[Axis]) * Scale);
+			BinIndex = BinIndex < 0 ? 0 : (BinIndex >= BINS_COUNT ? BINS_COUNT-1 : BinIndex);
+
+			const float*	pBounds = m_pTriangleBounds + 6*pOrder[i];
+			GrowBounds( BinsMin[BinIndex], BinsMax[BinIndex], pBounds, pBounds+3 );
+			BinsCount[BinIndex]++;
+		}
+
+		// Sweep from the right to accumulate the right areas, then from the left to evaluate each split plane
+		float	RightAreas[BINS_COUNT];
+		int		RightCounts[BINS_COUNT];
+		float	SweepMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float	SweepMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		int		SweepCount = 0;
+		for ( int BinIndex=BINS_COUNT-1; BinIndex > 0; BinIndex-- )
+		{
+			GrowBounds( SweepMin, SweepMax, BinsMin[BinIndex], BinsMax[BinIndex] );
+			SweepCount += BinsCount[BinIndex];
+			RightAreas[BinIndex] = SweepCount > 0 ? HalfArea( SweepMin, SweepMax ) : 0.0f;
+			RightCounts[BinIndex] = SweepCount;
+		}
+
+		SweepMin[0] = SweepMin[1] = SweepMin[2] = FLT_MAX;
+		SweepMax[0] = SweepMax[1] = SweepMax[2] = -FLT_MAX;
+		SweepCount = 0;
+		for ( int BinIndex=0; BinIndex < BINS_COUNT-1; BinIndex++ )
+		{
+			GrowBounds( SweepMin, SweepMax, BinsMin[BinIndex], BinsMax[BinIndex] );
+			SweepCount += BinsCount[BinIndex];
+			if ( SweepCount == 0 || RightCounts[BinIndex+1] == 0 )
+				continue;
+
+			float	Cost = SweepCount * HalfArea( SweepMin, SweepMax ) + RightCounts[BinIndex+1] * RightAreas[BinIndex+1];
+			if ( Cost < BestCost )
+			{
+				BestCost = Cost;
+				BestAxis = Axis;
+				BestBin = BinIndex;
+			}
+		}
+	}
+
+	// 3] Compare with the cost of a leaf
+	float	NodeArea = HalfArea( _Node.Min, _Node.Max );
+	float	LeafCost = _TrianglesCount * NodeArea;
+	float	SplitCost = TRAVERSAL_COST * NodeArea + BestCost;
+	if ( _TrianglesCount <= MAX_LEAF_SIZE && (BestAxis < 0 || SplitCost >= LeafCost) )
+		return	0;
+
+	if ( BestAxis < 0 )
+		return	_TrianglesCount / 2;	// All the centroids are at the same place: any split will do
+
+	// 4] Partition
+	float	Scale = BINS_COUNT * 0.99999f / (CentroidMax[BestAxis] - CentroidMin[BestAxis]);
+	int		Left = 0;
+	int		Right = _TrianglesCount - 1;
+	while ( Left <= Right )
+	{
+		int	BinIndex = (int) ((m_pCentroids[3*pOrder[Left]+BestAxis] - CentroidMin[BestAxis]) * Scale);
+		if ( BinIndex <= BestBin )
+			Left++;
+		else
+		{
+			int	Temp = pOrder[Left];
+			pOrder[Left] = pOrder[Right];
+			pOrder[Right--] = Temp;
+		}
+	}
+
+	if ( Left == 0 || Left == _TrianglesCount )
+		return	_TrianglesCount / 2;
+
+	return	Left;
+}
+
+void	TriangleBVH::Subdivide( BVHNode* _pNodes, const BuildTask& _Root, int& _NextNode )
+{
+	BuildTask*	pStack = new BuildTask[MAX_DEPTH+1];
+	int			StackSize = 0;
+	pStack[StackSize++] = _Root;
+
+	while ( StackSize > 0 )
+	{
+		BuildTask	Task = pStack[--StackSize];
+		BVHNode&	Node = _pNodes[Task.NodeIndex];
+		ComputeNodeBounds( Node, Task.FirstTriangle, Task.TrianglesCount );
+
+		int	LeftCount = Task.Depth < MAX_DEPTH-1 ? Split( Task.FirstTriangle, Task.TrianglesCount, Node ) : 0;
+		if ( LeftCount == 0 )
+		{	// Make a leaf
+			Node.FirstChildOrTriangle = Task.FirstTriangle;
+			Node.TrianglesCount = Task.TrianglesCount;
+			continue;
+		}
+
+		int	ChildIndex = _NextNode;
+		_NextNode += 2;
+		Node.FirstChildOrTriangle = ChildIndex;
+		Node.TrianglesCount = 0;
+
+		BuildTask&	Right = pStack[StackSize++];
+		Right.NodeIndex = ChildIndex+1;
+		Right.FirstTriangle = Task.FirstTriangle + LeftCount;
+		Right.TrianglesCount = Task.TrianglesCount - LeftCount;
+		Right.Depth = Task.Depth + 1;
+
+		BuildTask&	Left = pStack[StackSize++];
+		Left.NodeIndex = ChildIndex;
+		Left.FirstTriangle = Task.FirstTriangle;
+		Left.TrianglesCount = LeftCount;
+		Left.Depth = Task.Depth + 1;
+	}
+
+	delete[] pStack;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Refitting
+//
+void	TriangleBVH::UpdateVertices( const float* _pVertices, int _FirstVertex, int _VerticesCount )
+{
+	memcpy( m_pVertices + 3*_FirstVertex, _pVertices, 3*_VerticesCount*sizeof(float) );
+}
+
+void	TriangleBVH::RefitTriangles( int _FirstTriangle, int _TrianglesCount )
+{
+	for ( int i=_FirstTriangle; i < _FirstTriangle+_TrianglesCount; i++ )
+	{
+		const int*		pIndices = m_pIndices + 3*m_pTriangleOrder[i];
+		const float*	V0 = m_pVertices + 3*pIndices[0];
+		const float*	V1 = m_pVertices + 3*pIndices[1];
+		const float*	V2 = m_pVertices + 3*pIndices[2];
+		float*			pTriangle = m_pTriangles + 9*i;
+		for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+		{
+			pTriangle[0+ComponentIndex] = V0[ComponentIndex];
+			pTriangle[3+ComponentIndex] = V1[ComponentIndex] - V0[ComponentIndex];
+			pTriangle[6+ComponentIndex] = V2[ComponentIndex] - V0[ComponentIndex];
+		}
+	}
+}
+
+void	TriangleBVH::RefitNodes()
+{
+	// Children are always stored after their parent so a reverse sweep is bottom-up
+	for ( int NodeIndex=m_NodesCount-1; NodeIndex >= 0; NodeIndex-- )
+	{
+		BVHNode&	Node = m_pNodes[NodeIndex];
+		if ( Node.IsLeaf() )
+		{
+			Node.Min[0] = Node.Min[1] = Node.Min[2] = FLT_MAX;
+			Node.Max[0] = Node.Max[1] = Node.Max[2] = -FLT_MAX;
+			for ( int i=Node.FirstChildOrTriangle; i < Node.FirstChildOrTriangle+Node.TrianglesCount; i++ )
+			{
+				const float*	pTriangle = m_pTriangles + 9*i;
+				for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+				{
+					float	a = pTriangle[ComponentIndex];
+					float	b = a + pTriangle[3+ComponentIndex];
+					float	c = a + pTriangle[6+ComponentIndex];
+					float	Min = a < b ? (a < c ? a : c) : (b < c ? b : c);
+					float	Max = a > b ? (a > c ? a : c) : (b > c ? b : c);
+					if ( Min < Node.Min[ComponentIndex] )	Node.Min[ComponentIndex] = Min;
+					if ( Max > Node.Max[ComponentIndex] )	Node.Max[ComponentIndex] = Max;
+				}
+			}
+		}
+		else
+		{
+			const BVHNode&	Left = m_pNodes[Node.FirstChildOrTriangle];
+			const BVHNode&	Right = m_pNodes[Node.FirstChildOrTriangle+1];
+			for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+			{
+				Node.Min[ComponentIndex] = Left.Min[ComponentIndex] < Right.Min[ComponentIndex] ? Left.Min[ComponentIndex] : Right.Min[ComponentIndex];
+				Node.Max[ComponentIndex] = Left.Max[ComponentIndex] > Right.Max[ComponentIndex] ? Left.Max[ComponentIndex] : Right.Max[ComponentIndex];
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Queries
+//
+bool	TriangleBVH::IntersectClosest( const float* _pOrigin, const float* _pDirection, float _MaxDistance, BVHHit& _Hit ) const
+{
+	_Hit.TriangleIndex = -1;
+	_Hit.Distance = _MaxDistance;
+	if ( m_NodesCount == 0 )
+		return	false;
+
+	__m128	Origin = _mm_setr_ps( _pOrigin[0], _pOrigin[1], _pOrigin[2], 0.0f );
+	__m128	InvDirection = _mm_setr_ps( SafeInverse( _pDirection[0] ), SafeInverse( _pDirection[1] ), SafeInverse( _pDirection[2] ), 0.0f );
+
+	int		StackNodes[MAX_DEPTH];
+	float	StackDistances[MAX_DEPTH];
+	int		StackSize = 0;
+
+	int	NodeIndex = 0;
+	if ( IntersectNode( m_pNodes[0], Origin, InvDirection, _MaxDistance ) == FLT_MAX )
+		return	false;
+
+	int	HitPosition = -1;
+	while ( true )
+	{
+		const BVHNode&	Node = m_pNodes[NodeIndex];
+		if ( Node.IsLeaf() )
+		{
+			for ( int i=Node.FirstChildOrTriangle; i < Node.FirstChildOrTriangle+Node.TrianglesCount; i++ )
+				if ( IntersectTriangle( m_pTriangles + 9*i, _pOrigin, _pDirection, _Hit.Distance, _Hit.Distance, _Hit.U, _Hit.V ) )
+					HitPosition = i;
+		}
+		else
+		{	// Visit the nearest child first
+			int		Child0 = Node.FirstChildOrTriangle;
+			int		Child1 = Child0 + 1;
+			float	Distance0 = IntersectNode( m_pNodes[Child0], Origin, InvDirection, _Hit.Distance );
+			float	Distance1 = IntersectNode( m_pNodes[Child1], Origin, InvDirection, _Hit.Distance );
+			if ( Distance1 < Distance0 )
+			{
+				int		TempIndex = Child0;		Child0 = Child1;		Child1 = TempIndex;
+				float	TempDistance = Distance0;	Distance0 = Distance1;	Distance1 = TempDistance;
+			}
+			if ( Distance0 != FLT_MAX )
+			{
+				if ( Distance1 != FLT_MAX )
+				{
+					StackNodes[StackSize] = Child1;
+					StackDistances[StackSize++] = Distance1;
+				}
+				NodeIndex = Child0;
+				continue;
+			}
+		}
+
+		// Pop the next node that is still closer than the current hit
+		do
+		{
+			if ( StackSize == 0 )
+			{
+				if ( HitPosition >= 0 )
+					_Hit.TriangleIndex = m_pTriangleOrder[HitPosition];
+				return	HitPosition >= 0;
+			}
+			StackSize--;
+		} while ( StackDistances[StackSize] > _Hit.Distance );
+		NodeIndex = StackNodes[StackSize];
+	}
+}
+
+bool	TriangleBVH::IntersectAny( const float* _pOrigin, const float* _pDirection, float _MaxDistance ) const
+{
+	if ( m_NodesCount == 0 )
+		return	false;
+
+	__m128	Origin = _mm_setr_ps( _pOrigin[0], _pOrigin[1], _pOrigin[2], 0.0f );
+	__m128	InvDirection = _mm_setr_ps( SafeInverse( _pDirection[0] ), SafeInverse( _pDirection[1] ), SafeInverse( _pDirection[2] ), 0.0f );
+
+	int		Stack[MAX_DEPTH];
+	int		StackSize = 0;
+	Stack[StackSize++] = 0;
+	while ( StackSize > 0 )
+	{
+		const BVHNode&	Node = m_pNodes[Stack[--StackSize]];
+		if ( IntersectNode( Node, Origin, InvDirection, _MaxDistance ) == FLT_MAX )
+			continue;
+
+		if ( Node.IsLeaf() )
+		{
+			float	Distance, U, V;
+			for ( int i=Node.FirstChildOrTriangle; i < Node.FirstChildOrTriangle+Node.TrianglesCount; i++ )
+				if ( IntersectTriangle( m_pTriangles + 9*i, _pOrigin, _pDirection, _MaxDistance, Distance, U, V ) )
+					return	true;
+		}
+		else
+		{
+			Stack[StackSize++] = Node.FirstChildOrTriangle+1;
+			Stack[StackSize++] = Node.FirstChildOrTriangle;
+		}
+	}
+
+	return	false;
+}
+
+int	TriangleBVH::IntersectPacket( const float* _pOrigins, const float* _pDirections, float _MaxDistance, BVHHit* _pHits ) const
+{
+	for ( int RayIndex=0; RayIndex < 4; RayIndex++ )
+	{
+		_pHits[RayIndex].TriangleIndex = -1;
+		_pHits[RayIndex].Distance = _MaxDistance;
+	}
+	if ( m_NodesCount == 0 )
+		return	0;
+
+	__m128	Ox = _mm_loadu_ps( _pOrigins+0 );
+	__m128	Oy = _mm_loadu_ps( _pOrigins+4 );
+	__m128	Oz = _mm_loadu_ps( _pOrigins+8 );
+	__m128	Dx = _mm_loadu_ps( _pDirections+0 );
+	__m128	Dy = _mm_loadu_ps( _pDirections+4 );
+	__m128	Dz = _mm_loadu_ps( _pDirections+8 );
+
+	float	pInvDirections[12];
+	for ( int i=0; i < 12; i++ )
+		pInvDirections[i] = SafeInverse( _pDirections[i] );
+	__m128	Ix = _mm_loadu_ps( pInvDirections+0 );
+	__m128	Iy = _mm_loadu_ps( pInvDirections+4 );
+	__m128	Iz = _mm_loadu_ps( pInvDirections+8 );
+
+	__m128	Zero = _mm_setzero_ps();
+	__m128	One = _mm_set1_ps( 1.0f );
+	__m128	Epsilon = _mm_set1_ps( DEGENERATE_DETERMINANT );
+	__m128	AbsMask = _mm_loadu_ps( ABS_MASK.f );
+
+	__m128	BestT = _mm_set1_ps( _MaxDistance );
+	__m128	BestU = Zero;
+	__m128	BestV = Zero;
+	int		BestPositions[4] = { -1, -1, -1, -1 };
+
+	int		StackNodes[MAX_DEPTH];
+	float	StackDistances[MAX_DEPTH];
+	int		StackSize = 0;
+	StackNodes[StackSize] = 0;
+	StackDistances[StackSize++] = 0.0f;
+
+	while ( StackSize > 0 )
+	{
+		StackSize--;
+		if ( StackDistances[StackSize] > HorizontalMax( BestT ) )
+			continue;	// All the rays already hit something closer
+
+		const BVHNode&	Node = m_pNodes[StackNodes[StackSize]];
+		if ( Node.IsLeaf() )
+		{
+			for ( int i=Node.FirstChildOrTriangle; i < Node.FirstChildOrTriangle+Node.TrianglesCount; i++ )
+			{
+				const float*	pTriangle = m_pTriangles + 9*i;
+				__m128	V0x = _mm_set1_ps( pTriangle[0] ), V0y = _mm_set1_ps( pTriangle[1] ), V0z = _mm_set1_ps( pTriangle[2] );
+				__m128	E1x = _mm_set1_ps( pTriangle[3] ), E1y = _mm_set1_ps( pTriangle[4] ), E1z = _mm_set1_ps( pTriangle[5] );
+				__m128	E2x = _mm_set1_ps( pTriangle[6] ), E2y = _mm_set1_ps( pTriangle[7] ), E2z = _mm_set1_ps( pTriangle[8] );
+
+				// P = D x E2
+				__m128	Px = _mm_sub_ps( _mm_mul_ps( Dy, E2z ), _mm_mul_ps( Dz, E2y ) );
+				__m128	Py = _mm_sub_ps( _mm_mul_ps( Dz, E2x ), _mm_mul_ps( Dx, E2z ) );
+				__m128	Pz = _mm_sub_ps( _mm_mul_ps( Dx, E2y ), _mm_mul_ps( Dy, E2x ) );
+				__m128	Det = _mm_add_ps( _mm_add_ps( _mm_mul_ps( E1x, Px ), _mm_mul_ps( E1y, Py ) ), _mm_mul_ps( E1z, Pz ) );
+				__m128	Valid = _mm_cmpgt_ps( _mm_and_ps( Det, AbsMask ), Epsilon );
+				__m128	InvDet = _mm_div_ps( One, Select( Valid, Det, One ) );
+
+				// S = O - V0
+				__m128	Sx = _mm_sub_ps( Ox, V0x );
+				__m128	Sy = _mm_sub_ps( Oy, V0y );
+				__m128	Sz = _mm_sub_ps( Oz, V0z );
+				__m128	U = _mm_mul_ps( InvDet, _mm_add_ps( _mm_add_ps( _mm_mul_ps( Sx, Px ), _mm_mul_ps( Sy, Py ) ), _mm_mul_ps( Sz, Pz ) ) );
+
+				// Q = S x E1
+				__m128	Qx = _mm_sub_ps( _mm_mul_ps( Sy, E1z ), _mm_mul_ps( Sz, E1y ) );
+				__m128	Qy = _mm_sub_ps( _mm_mul_ps( Sz, E1x ), _mm_mul_ps( Sx, E1z ) );
+				__m128	Qz = _mm_sub_ps( _mm_mul_ps( Sx, E1y ), _mm_mul_ps( Sy, E1x ) );
+				__m128	V = _mm_mul_ps( InvDet, _mm_add_ps( _mm_add_ps( _mm_mul_ps( Dx, Qx ), _mm_mul_ps( Dy, Qy ) ), _mm_mul_ps( Dz, Qz ) ) );
+				__m128	T = _mm_mul_ps( InvDet, _mm_add_ps( _mm_add_ps( _mm_mul_ps( E2x, Qx ), _mm_mul_ps( E2y, Qy ) ), _mm_mul_ps( E2z, Qz ) ) );
+
+				Valid = _mm_and_ps( Valid, _mm_cmpge_ps( U, Zero ) );
+				Valid = _mm_and_ps( Valid, _mm_cmpge_ps( V, Zero ) );
+				Valid = _mm_and_ps( Valid, _mm_cmple_ps( _mm_add_ps( U, V ), One ) );
+				Valid = _mm_and_ps( Valid, _mm_cmpge_ps( T, Zero ) );
+				Valid = _mm_and_ps( Valid, _mm_cmplt_ps( T, BestT ) );
+
+				int	HitMask = _mm_movemask_ps( Valid );
+				if ( HitMask == 0 )
+					continue;
+
+				BestT = Select( Valid, T, BestT );
+				BestU = Select( Valid, U, BestU );
+				BestV = Select( Valid, V, BestV );
+				for ( int RayIndex=0; RayIndex < 4; RayIndex++ )
+					if ( HitMask & (1 << RayIndex) )
+						BestPositions[RayIndex] = i;
+			}
+			continue;
+		}
+
+		// Test both children against the 4 rays
+		int		Children[2] = { Node.FirstChildOrTriangle, Node.FirstChildOrTriangle+1 };
+		float	Distances[2];
+		for ( int ChildIndex=0; ChildIndex < 2; ChildIndex++ )
+		{
+			const BVHNode&	Child = m_pNodes[Children[ChildIndex]];
+			__m128	t0x = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( Child.Min[0] ), Ox ), Ix );
+			__m128	t1x = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( Child.Max[0] ), Ox ), Ix );
+			__m128	t0y = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( Child.Min[1] ), Oy ), Iy );
+			__m128	t1y = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( Child.Max[1] ), Oy ), Iy );
+			__m128	t0z = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( Child.Min[2] ), Oz ), Iz );
+			__m128	t1z = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( Child.Max[2] ), Oz ), Iz );
+			__m128	Near = _mm_max_ps( _mm_max_ps( _mm_min_ps( t0x, t1x ), _mm_min_ps( t0y, t1y ) ), _mm_max_ps( _mm_min_ps( t0z, t1z ), Zero ) );
+			__m128	Far = _mm_min_ps( _mm_min_ps( _mm_max_ps( t0x, t1x ), _mm_max_ps( t0y, t1y ) ), _mm_min_ps( _mm_max_ps( t0z, t1z ), BestT ) );
+			__m128	Hit = _mm_cmple_ps( Near, Far );
+
+			// Order by the nearest entry among the rays that hit the child
+			Distances[ChildIndex] = _mm_movemask_ps( Hit ) != 0 ? HorizontalMin( Select( Hit, Near, _mm_set1_ps( FLT_MAX ) ) ) : FLT_MAX;
+		}
+
+		int	Near = Distances[1] < Distances[0] ? 1 : 0;
+		int	Far = 1 - Near;
+		if ( Distances[Far] != FLT_MAX )
+		{
+			StackNodes[StackSize] = Children[Far];
+			StackDistances[StackSize++] = Distances[Far];
+		}
+		if ( Distances[Near] != FLT_MAX )
+		{
+			StackNodes[StackSize] = Children[Near];
+			StackDistances[StackSize++] = Distances[Near];
+		}
+	}
+
+	float	pT[4], pU[4], pV[4];
+	_mm_storeu_ps( pT, BestT );
+	_mm_storeu_ps( pU, BestU );
+	_mm_storeu_ps( pV, BestV );
+
+	int	Result = 0;
+	for ( int RayIndex=0; RayIndex < 4; RayIndex++ )
+	{
+		if ( BestPositions[RayIndex] < 0 )
+			continue;
+
+		_pHits[RayIndex].Distance = pT[RayIndex];
+		_pHits[RayIndex].U = pU[RayIndex];
+		_pHits[RayIndex].V = pV[RayIndex];
+		_pHits[RayIndex].TriangleIndex = m_pTriangleOrder[BestPositions[RayIndex]];
+		Result |= 1 << RayIndex;
+	}
+
+	return	Result;
+}
@@ -0,0 +1,147 @@
+// Contains the native triangle BVH used for CPU ray queries
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// A BVH node (32 bytes, 2 nodes per cache line)
+	// Interior nodes have TrianglesCount = 0 and their 2 children are stored next to each other at index FirstChildOrTriangle
+	// Leaves reference TrianglesCount triangles starting at FirstChildOrTriangle in the BVH's triangle order
+	//
+	struct	BVHNode
+	{
+		float	Min[3];
+		int		FirstChildOrTriangle;
+		float	Max[3];
+		int		TrianglesCount;
+
+		bool	IsLeaf() const	{ return TrianglesCount > 0; }
+	};
+
+	// The result of a ray query
+	struct	BVHHit
+	{
+		float	Distance;		// Distance along the ray (in units of the ray direction's length)
+		float	U, V;			// Barycentric coordinates of the hit relative to vertices 1 & 2
+		int		TriangleIndex;	// Index of the hit triangle in the original triangle list (-1 if nothing was hit)
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// A bounding volume hierarchy over a triangle list
+	//
+	// Building uses a binned SAH. It's split into 3 stages so the bulk of the work can be run in parallel:
+	//	1] BeginBuild() splits the top of the tree serially until enough independent subtrees are available
+	//	2] BuildSubtree() builds each of these subtrees (can be called concurrently for different subtrees)
+	//	3] EndBuild() lays the nodes out in depth-first order, children pairs being always contiguous
+	//
+	// Triangles are stored in leaf order as precomputed (Vertex0, Edge1, Edge2) for the Möller-Trumbore test.
+	// When the vertices move (e.g. animated transforms), UpdateVertices() followed by RefitTriangles() & RefitNodes()
+	//	update the bounds without rebuilding the topology.
+	//
+	// Queries use SSE: single rays test node slabs with 4-wide operations, packets trace 4 rays at once in SoA.
+	//
+	class	TriangleBVH
+	{
+	public:		// NESTED TYPES
+
+		static const int	BINS_COUNT = 16;
+		static const int	MAX_LEAF_SIZE = 8;
+		static const int	MAX_DEPTH = 64;
+		static const int	MIN_SUBTREE_SIZE = 1024;	// Ranges smaller than this are never split serially by BeginBuild()
+
+	protected:
+
+		struct	BuildTask
+		{
+			int		NodeIndex;
+			int		FirstTriangle;
+			int		TrianglesCount;
+			int		Depth;			// Depth of the node (the root has depth 1)
+		};
+
+	protected:	// FIELDS
+
+		int					m_VerticesCount;
+		int					m_TrianglesCount;
+		float*				m_pVertices;		// 3 floats per vertex (world space)
+		int*				m_pIndices;			// 3 vertex indices per original triangle
+
+		// Build data
+		int*				m_pTriangleOrder;	// Original index of the triangle in N-th position
+		float*				m_pCentroids;		// 3 floats per original triangle
+		float*				m_pTriangleBounds;	// 6 floats per original triangle
+		BVHNode*			m_pBuildNodes;		// Sparse nodes: the top of the tree first, then 2 slots per triangle for the subtrees
+		int					m_TopNodesCount;
+		int					m_TopNodesCapacity;
+		BuildTask*			m_pTasks;
+		int					m_TasksCount;
+
+		// Final data
+		BVHNode*			m_pNodes;
+		int					m_NodesCount;
+		int					m_Depth;
+		float*				m_pTriangles;		// 9 floats per triangle, in leaf order: Vertex0, Edge1, Edge2
+
+	public:		// PROPERTIES
+
+		int				GetTrianglesCount() const	{ return m_TrianglesCount; }
+		int				GetVerticesCount() const	{ return m_VerticesCount; }
+		int				GetNodesCount() const		{ return m_NodesCount; }
+		int				GetDepth() const			{ return m_Depth; }
+		const BVHNode*	GetNodes() const			{ return m_pNodes; }
+		int				GetTasksCount() const		{ return m_TasksCount; }
+
+	public:		// METHODS
+
+		// The vertices & indices are copied
+		TriangleBVH( const float* _pVertices, int _VerticesCount, const int* _pIndices, int _TrianglesCount );
+		~TriangleBVH();
+
+		// Stage 1: splits the top of the tree until there are at least _TasksCount subtrees to build (or they're all too small)
+		// Returns the amount of subtrees to build
+		int		BeginBuild( int _TasksCount );
+
+		// Stage 2: builds one of the subtrees
+		void	BuildSubtree( int _TaskIndex );
+
+		// Stage 3: compacts the nodes & stores the triangles in leaf order
+		void	EndBuild();
+
+		// Replaces a range of vertices (the topology must stay the same)
+		void	UpdateVertices( const float* _pVertices, int _FirstVertex, int _VerticesCount );
+
+		// Refit stage 1: updates the leaf-ordered triangles of a range (can be called concurrently for different ranges)
+		void	RefitTriangles( int _FirstTriangle, int _TrianglesCount );
+
+		// Refit stage 2: recomputes all the node bounds bottom-up
+		void	RefitNodes();
+
+		// Finds the closest hit along a ray in [0,_MaxDistance]
+		bool	IntersectClosest( const float* _pOrigin, const float* _pDirection, float _MaxDistance, BVHHit& _Hit ) const;
+
+		// Tells if anything is hit along a ray in [0,_MaxDistance] (stops at the first hit found)
+		bool	IntersectAny( const float* _pOrigin, const float* _pDirection, float _MaxDistance ) const;
+
+		// Finds the closest hits of a packet of 4 rays given in SoA (4 x, then 4 y, then 4 z)
+		// Rays should be coherent (e.g. neighbor pixels) for the packet to be efficient
+		// Returns the mask of rays that hit something
+		int		IntersectPacket( const float* _pOrigins, const float* _pDirections, float _MaxDistance, BVHHit* _pHits ) const;
+
+	protected:
+
+		void	ComputeNodeBounds( BVHNode& _Node, int _FirstTriangle, int _TrianglesCount ) const;
+
+		// Finds the best SAH split of a range and partitions it
+		// Returns the amount of triangles in the left part (0 if the range should be a leaf)
+		int		Split( int _FirstTriangle, int _TrianglesCount, const BVHNode& _Node );
+
+		// Builds the subtree of a range iteratively, allocating its nodes from _NextNode
+		// Nodes reaching MAX_DEPTH become leaves regardless of their size
+		void	Subdivide( BVHNode* _pNodes, const BuildTask& _Root, int& _NextNode );
+
+	private:
+		TriangleBVH( const TriangleBVH& );
+		TriangleBVH&	operator=( const TriangleBVH& );
+	};
+}
@@ -0,0 +1,101 @@
+// This is the main DLL file.
+
+#include "stdafx.h"
+
+#include "VertexBuffer.h"
+#include "NodeMesh.h"
+
+using namespace	FBXImporter;
+
+VertexBuffer::VertexBuffer( NodeMesh^ _Owner, VertexBufferLayout^ _Layout, cli::array<cli::array<float>^>^ _Sources, int _CornersCount, List<Object^>^ _Materials, cli::array<int>^ _RangeStarts )
+	: m_Owner( _Owner ), m_Layout( _Layout )
+{
+	VertexLayout	Layout;
+	_Layout->ToNative( Layout );
+
+	int	AttributesCount = Layout.GetAttributesCount();
+	if ( _Sources->Length != AttributesCount )
+		throw gcnew Exception( "Expected one source per layout attribute !" );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Copy the sources into native memory then encode & weld the corners
+	const float*	ppSources[VertexLayout::MAX_ATTRIBUTES];
+	for ( int AttributeIndex=0; AttributeIndex < AttributesCount; AttributeIndex++ )
+	{
+		ppSources[AttributeIndex] = NULL;
+		if ( _Sources[AttributeIndex] != nullptr && _Sources[AttributeIndex]->Length != _CornersCount * VertexLayout::GetSourceComponentsCount( Layout.GetAttribute( AttributeIndex ).Semantic ) )
+			throw gcnew Exception( "Source #" + AttributeIndex + " doesn't have the expected amount of values !" );
+	}
+
+	VertexEncoder*	pEncoder = new VertexEncoder( Layout );
+	try
+	{
+		for ( int AttributeIndex=0; AttributeIndex < AttributesCount; AttributeIndex++ )
+			if ( _Sources[AttributeIndex] != nullptr && _Sources[AttributeIndex]->Length > 0 )
+			{
+				float*	pSource = new float[_Sources[AttributeIndex]->Length];
+				ppSources[AttributeIndex] = pSource;
+				System::Runtime::InteropServices::Marshal::Copy( _Sources[AttributeIndex], 0, IntPtr( pSource ), _Sources[AttributeIndex]->Length );
+			}
+
+		pEncoder->Encode( ppSources, _CornersCount );
+
+		//////////////////////////////////////////////////////////////////////////
+		// 2] Copy the streams & indices
+		m_VerticesCount = pEncoder->GetVerticesCount();
+		m_Streams = gcnew cli::array<cli::array<unsigned char>^>( Layout.GetStreamsCount() );
+		for ( int StreamIndex=0; StreamIndex < m_Streams->Length; StreamIndex++ )
+		{
+			int	Size = m_VerticesCount * Layout.GetStride( StreamIndex );
+			m_Streams[StreamIndex] = gcnew cli::array<unsigned char>( Size );
+			if ( Size > 0 )
+				System::Runtime::InteropServices::Marshal::Copy( IntPtr( (void*) pEncoder->GetStream( StreamIndex ) ), m_Streams[StreamIndex], 0, Size );
+		}
+
+		m_IndicesCount = pEncoder->GetIndicesCount();
+		m_IndexSize = pEncoder->GetIndexSize();
+		m_Indices = gcnew cli::array<unsigned char>( m_IndicesCount * m_IndexSize );
+		if ( m_IndicesCount > 0 )
+		{
+			pin_ptr<unsigned char>	pIndices = &m_Indices[0];
+			pEncoder->GetIndices( pIndices );
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// 3] Report the errors
+		m_Errors = gcnew cli::array<AttributeError^>( AttributesCount );
+		for ( int AttributeIndex=0; AttributeIndex < AttributesCount; AttributeIndex++ )
+		{
+			const VertexLayout::Attribute&	A = Layout.GetAttribute( AttributeIndex );
+
+			AttributeError^	Error = gcnew AttributeError();
+			Error->Semantic = (VertexBufferLayout::SEMANTIC) A.Semantic;
+			Error->SemanticIndex = A.SemanticIndex;
+			Error->Format = (VertexBufferLayout::FORMAT) A.Format;
+			Error->Missing = _Sources[AttributeIndex] == nullptr;
+			Error->MaxError = pEncoder->GetError( AttributeIndex ).MaxError;
+			Error->RMSError = pEncoder->GetError( AttributeIndex ).RMSError;
+			Error->OverflowsCount = pEncoder->GetError( AttributeIndex ).OverflowsCount;
+			m_Errors[AttributeIndex] = Error;
+		}
+	}
+	finally
+	{
+		for ( int AttributeIndex=0; AttributeIndex < AttributesCount; AttributeIndex++ )
+			delete[] ppSources[AttributeIndex];
+		delete pEncoder;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 4] Build the sub-meshes from the material ranges
+	int	RangesCount = _RangeStarts->Length - 1;
+	m_SubMeshes = gcnew cli::array<SubMesh^>( RangesCount );
+	for ( int RangeIndex=0; RangeIndex < RangesCount; RangeIndex++ )
+	{
+		SubMesh^	SM = gcnew SubMesh();
+		SM->Material = _Materials->Count > 0 ? _Materials[RangeIndex] : nullptr;
+		SM->IndexStart = 3 * _RangeStarts[RangeIndex];
+		SM->IndexCount = 3 * (_RangeStarts[RangeIndex+1] - _RangeStarts[RangeIndex]);
+		m_SubMeshes[RangeIndex] = SM;
+	}
+}
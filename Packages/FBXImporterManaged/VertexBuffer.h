@@ -0,0 +1,146 @@
+// Contains the GPU-ready vertex & index buffers of a mesh
+//
+#pragma managed
+#pragma once
+
+#include "VertexBufferLayout.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	ref class	NodeMesh;
+
+	//////////////////////////////////////////////////////////////////////////
+	// The vertex & index buffers of a mesh, encoded in the formats of a VertexBufferLayout
+	// The buffers are in their final form and can be uploaded as-is :
+	//	_ Streams holds the vertices of each stream of the layout (VerticesCount * GetStride( StreamIndex ) bytes)
+	//	_ Indices holds IndicesCount indices of IndexSize bytes (16-bit whenever the amount of vertices allows it)
+	//	_ SubMeshes gives the range of indices of each material (triangles are grouped by material, keeping their order)
+	//
+	// The encoding error of each attribute is measured by decoding every triangle corner back and comparing it with its source.
+	//
+	public ref class	VertexBuffer
+	{
+	public:		// NESTED TYPES
+
+		[System::Diagnostics::DebuggerDisplayAttribute( "Start={IndexStart} Count={IndexCount}" )]
+		ref class	SubMesh
+		{
+		public:
+
+			Object^		Material;		// The material of the triangles (null if the mesh has no material)
+			int			IndexStart;
+			int			IndexCount;
+		};
+
+		[System::Diagnostics::DebuggerDisplayAttribute( "{Semantic}{SemanticIndex} {Format} Max={MaxError} RMS={RMSError} Missing={Missing} Overflows={OverflowsCount}" )]
+		ref class	AttributeError
+		{
+		public:
+
+			VertexBufferLayout::SEMANTIC	Semantic;
+			int								SemanticIndex;
+			VertexBufferLayout::FORMAT		Format;
+			bool							Missing;	// True if the mesh has no such attribute and default values were encoded instead
+			float							MaxError;	// The largest absolute difference of a component (directions are compared once normalized)
+			float							RMSError;
+			int								OverflowsCount;	// The amount of corners with a component out of the range of a half format, clamped to +/-65504
+		};
+
+	protected:	// FIELDS
+
+		NodeMesh^								m_Owner;
+		VertexBufferLayout^						m_Layout;
+
+		int										m_VerticesCount;
+		cli::array<cli::array<unsigned char>^>^	m_Streams;
+
+		int										m_IndicesCount;
+		int										m_IndexSize;
+		cli::array<unsigned char>^				m_Indices;
+
+		cli::array<SubMesh^>^					m_SubMeshes;
+		cli::array<AttributeError^>^			m_Errors;
+
+	public:		// PROPERTIES
+
+		[DescriptionAttribute( "Gets the mesh the buffers were emitted from" )]
+		//
+		property NodeMesh^					Owner
+		{
+			NodeMesh^					get()	{ return m_Owner; }
+		}
+
+		property VertexBufferLayout^		Layout
+		{
+			VertexBufferLayout^			get()	{ return m_Layout; }
+		}
+
+		property int						VerticesCount
+		{
+			int							get()	{ return m_VerticesCount; }
+		}
+
+		[DescriptionAttribute( "Gets the encoded vertices of each stream of the layout" )]
+		//
+		property cli::array<cli::array<unsigned char>^>^	Streams
+		{
+			cli::array<cli::array<unsigned char>^>^	get()	{ return m_Streams; }
+		}
+
+		property int						IndicesCount
+		{
+			int							get()	{ return m_IndicesCount; }
+		}
+
+		[DescriptionAttribute( "Gets the size of an index (2 or 4 bytes)" )]
+		//
+		property int						IndexSize
+		{
+			int							get()	{ return m_IndexSize; }
+		}
+
+		[DescriptionAttribute( "Gets the indices (IndexSize bytes per index, little endian)" )]
+		//
+		property cli::array<unsigned char>^	Indices
+		{
+			cli::array<unsigned char>^	get()	{ return m_Indices; }
+		}
+
+		property cli::array<SubMesh^>^		SubMeshes
+		{
+			cli::array<SubMesh^>^		get()	{ return m_SubMeshes; }
+		}
+
+		[DescriptionAttribute( "Gets the encoding error of each attribute of the layout" )]
+		//
+		property cli::array<AttributeError^>^	Errors
+		{
+			cli::array<AttributeError^>^	get()	{ return m_Errors; }
+		}
+
+		[DescriptionAttribute( "Gets the size of the encoded vertices & indices (in bytes)" )]
+		//
+		property __int64					EncodedSize
+		{
+			__int64						get()	{ return (__int64) m_VerticesCount * m_Layout->VertexSize + (__int64) m_IndicesCount * m_IndexSize; }
+		}
+
+		[DescriptionAttribute( "Gets the size the same vertices would take as floats with 32-bit indices (in bytes)" )]
+		//
+		property __int64					FloatSize
+		{
+			__int64						get()	{ return (__int64) m_VerticesCount * m_Layout->FloatVertexSize + 4 * (__int64) m_IndicesCount; }
+		}
+
+	public:		// METHODS
+
+		// Encodes & welds the corners of a triangle list
+		// _Sources, the values of each layout attribute for each corner (VertexLayout::GetSourceComponentsCount() floats per corner), null for missing attributes
+		// _Materials & _RangeStarts, the material of each range of triangles & the start of each range (plus the end of the last one)
+		VertexBuffer( NodeMesh^ _Owner, VertexBufferLayout^ _Layout, cli::array<cli::array<float>^>^ _Sources, int _CornersCount, List<Object^>^ _Materials, cli::array<int>^ _RangeStarts );
+	};
+}
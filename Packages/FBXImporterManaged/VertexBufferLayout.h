@@ -0,0 +1,204 @@
+// Contains the declarative layout of the GPU-ready vertex buffers emitted at import time
+//
+#pragma managed
+#pragma once
+
+#include "VertexEncoder.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+using namespace System::ComponentModel;
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Describes the attributes of the emitted vertices, their formats & the streams they are stored in
+	// Attributes are packed in declaration order within their stream: a single stream gives interleaved vertices, several
+	//	streams give separate buffers (e.g. positions alone for depth-only passes).
+	//
+	// Every semantic only accepts the formats that make sense for its data :
+	//	_ POSITION	FLOAT3, HALF4
+	//	_ NORMAL	FLOAT3, OCTAHEDRAL16, UNORM10_10_10_2
+	//	_ TANGENT	FLOAT4, UNORM10_10_10_2 (w = +1 or -1 is the handedness of the tangent space, i.e. the sign of the binormal)
+	//	_ BINORMAL	FLOAT3, OCTAHEDRAL16, UNORM10_10_10_2
+	//	_ UV		FLOAT2, HALF2, UNORM16_2
+	//	_ COLOR		FLOAT4, HALF4, UNORM8_4
+	//
+	public ref class	VertexBufferLayout
+	{
+	public:		// NESTED TYPES
+
+		enum class	SEMANTIC
+		{
+			POSITION,
+			NORMAL,
+			TANGENT,
+			BINORMAL,
+			UV,
+			COLOR,
+		};
+
+		enum class	FORMAT
+		{
+			FLOAT2,
+			FLOAT3,
+			FLOAT4,
+			HALF2,
+			HALF4,
+			UNORM16_2,
+			UNORM8_4,
+			OCTAHEDRAL16,		// 2 snorm16 (the unit vector projected on the octahedron, the lower half being folded over the upper half)
+			UNORM10_10_10_2,	// Decoded with v*2-1, the 2 bits of alpha holding the handedness of tangents (0 = -1, 3 = +1)
+		};
+
+		[System::Diagnostics::DebuggerDisplayAttribute( "{Semantic}{SemanticIndex} {Format} Stream={Stream} Offset={Offset}" )]
+		ref class	Attribute
+		{
+		public:
+
+			SEMANTIC	Semantic;
+			int			SemanticIndex;	// The index of the layer element it's read from (e.g. the UV set)
+			FORMAT		Format;
+			int			Stream;
+			int			Offset;			// The offset of the attribute within a vertex of its stream (in bytes)
+			int			Size;			// The size of the attribute (in bytes)
+		};
+
+	protected:	// FIELDS
+
+		List<Attribute^>^	m_Attributes;
+		cli::array<int>^	m_Strides;
+		int					m_StreamsCount;
+
+		bool				m_bFlipUVs;
+		float				m_PositionScale;
+
+	public:		// PROPERTIES
+
+		property cli::array<Attribute^>^	Attributes
+		{
+			cli::array<Attribute^>^	get()	{ return m_Attributes->ToArray(); }
+		}
+
+		property int		StreamsCount
+		{
+			int		get()	{ return m_StreamsCount; }
+		}
+
+		[DescriptionAttribute( "Gets the size of a vertex in all the streams (in bytes)" )]
+		//
+		property int		VertexSize
+		{
+			int		get()	{ int Result = 0; for ( int StreamIndex=0; StreamIndex < m_StreamsCount; StreamIndex++ ) Result += m_Strides[StreamIndex]; return Result; }
+		}
+
+		[DescriptionAttribute( "Gets the size the same attributes would take as floats (in bytes)" )]
+		//
+		property int		FloatVertexSize
+		{
+			int		get()	{ int Result = 0; for each ( Attribute^ A in m_Attributes ) Result += 4 * VertexLayout::GetSourceComponentsCount( (VertexLayout::SEMANTIC) A->Semantic ); return Result; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the V complement of UVs (V' = 1-V) so textures are addressed from their top-left corner like the scene loader does" )]
+		//
+		property bool		FlipUVs
+		{
+			bool	get()	{ return m_bFlipUVs; }
+			void	set( bool _Value )	{ m_bFlipUVs = _Value; }
+		}
+
+		[DescriptionAttribute( "Gets or sets the scale applied to positions before they're encoded (e.g. 0.01 to convert centimeters into meters)" )]
+		//
+		property float		PositionScale
+		{
+			float	get()	{ return m_PositionScale; }
+			void	set( float _Value )
+			{
+				if ( _Value <= 0.0f )
+					throw gcnew Exception( "The position scale must be strictly positive !" );
+				m_PositionScale = _Value;
+			}
+		}
+
+		// Gets the default layout: a single interleaved stream of 28 bytes (against 72 bytes for the same attributes as floats)
+		//	Position FLOAT3, Normal OCTAHEDRAL16, Tangent UNORM10_10_10_2, UV #0 HALF2, Color #0 UNORM8_4
+		static property VertexBufferLayout^	Default
+		{
+			VertexBufferLayout^	get()
+			{
+				VertexBufferLayout^	Result = gcnew VertexBufferLayout();
+				Result->Add( SEMANTIC::POSITION, 0, FORMAT::FLOAT3, 0 );
+				Result->Add( SEMANTIC::NORMAL, 0, FORMAT::OCTAHEDRAL16, 0 );
+				Result->Add( SEMANTIC::TANGENT, 0, FORMAT::UNORM10_10_10_2, 0 );
+				Result->Add( SEMANTIC::UV, 0, FORMAT::HALF2, 0 );
+				Result->Add( SEMANTIC::COLOR, 0, FORMAT::UNORM8_4, 0 );
+				return	Result;
+			}
+		}
+
+	public:		// METHODS
+
+		VertexBufferLayout()
+		{
+			m_Attributes = gcnew List<Attribute^>();
+			m_Strides = gcnew cli::array<int>( VertexLayout::MAX_STREAMS );
+			m_StreamsCount = 0;
+			m_bFlipUVs = true;
+			m_PositionScale = 1.0f;
+		}
+
+		// Appends an attribute at the end of its stream
+		void	Add( SEMANTIC _Semantic, int _SemanticIndex, FORMAT _Format, int _Stream )
+		{
+			if ( !VertexLayout::IsSupported( (VertexLayout::SEMANTIC) _Semantic, (VertexLayout::FORMAT) _Format ) )
+				throw gcnew Exception( "Format " + _Format.ToString() + " is not supported for " + _Semantic.ToString() + " attributes !" );
+			if ( _Stream < 0 || _Stream >= VertexLayout::MAX_STREAMS )
+				throw gcnew Exception( "The stream index must be in [0," + (VertexLayout::MAX_STREAMS-1) + "] !" );
+			if ( _SemanticIndex < 0 )
+				throw gcnew Exception( "The semantic index must be positive !" );
+			if ( m_Attributes->Count >= VertexLayout::MAX_ATTRIBUTES )
+				throw gcnew Exception( "A layout can't have more than " + VertexLayout::MAX_ATTRIBUTES + " attributes !" );
+
+			Attribute^	A = gcnew Attribute();
+			A->Semantic = _Semantic;
+			A->SemanticIndex = _SemanticIndex;
+			A->Format = _Format;
+			A->Stream = _Stream;
+			A->Offset = m_Strides[_Stream];
+			A->Size = VertexLayout::GetFormatSize( (VertexLayout::FORMAT) _Format );
+			m_Attributes->Add( A );
+
+			m_Strides[_Stream] += A->Size;
+			m_StreamsCount = Math::Max( m_StreamsCount, _Stream+1 );
+		}
+
+		// Gets the size of a vertex in the given stream (in bytes)
+		int		GetStride( int _StreamIndex )
+		{
+			return	m_Strides[_StreamIndex];
+		}
+
+		virtual String^	ToString() override
+		{
+			System::Text::StringBuilder^	Result = gcnew System::Text::StringBuilder();
+			for ( int StreamIndex=0; StreamIndex < m_StreamsCount; StreamIndex++ )
+			{
+				Result->AppendFormat( "{0}Stream #{1} ({2} bytes):", StreamIndex > 0 ? " " : "", StreamIndex, m_Strides[StreamIndex] );
+				for each ( Attribute^ A in m_Attributes )
+					if ( A->Stream == StreamIndex )
+						Result->AppendFormat( " {0}{1} {2}", A->Semantic, A->SemanticIndex, A->Format );
+			}
+
+			return	Result->ToString();
+		}
+
+	internal:
+
+		// Fills the native layout used by the encoder
+		void	ToNative( VertexLayout& _Layout )
+		{
+			for each ( Attribute^ A in m_Attributes )
+				_Layout.AddAttribute( (VertexLayout::SEMANTIC) A->Semantic, A->SemanticIndex, (VertexLayout::FORMAT) A->Format, A->Stream );
+		}
+	};
+}
@@ -0,0 +1,131 @@
+// Contains the report of the vertex buffer emission stage
+//
+#pragma managed
+#pragma once
+
+#include "VertexBuffer.h"
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Reports the size of the emitted vertex buffers against their float equivalent, and the encoding error of each attribute
+	//
+	public ref class	VertexBufferReport
+	{
+	public:		// NESTED TYPES
+
+		[System::Diagnostics::DebuggerDisplayAttribute( "{MeshName} Vertices={VerticesCount} {EncodedSize}/{FloatSize} bytes" )]
+		ref class	MeshEntry
+		{
+		public:
+
+			String^			MeshName;
+			int				CornersCount;		// The amount of triangle corners before welding
+			int				VerticesCount;
+			int				IndexSize;
+			__int64			EncodedSize;
+			__int64			FloatSize;
+
+			cli::array<VertexBuffer::AttributeError^>^	Errors;
+		};
+
+	protected:	// FIELDS
+
+		VertexBufferLayout^	m_Layout;
+		List<MeshEntry^>^	m_Entries;
+
+	public:		// PROPERTIES
+
+		property VertexBufferLayout^		Layout
+		{
+			VertexBufferLayout^	get()	{ return m_Layout; }
+		}
+
+		property cli::array<MeshEntry^>^	Entries
+		{
+			cli::array<MeshEntry^>^	get()	{ return m_Entries->ToArray(); }
+		}
+
+		property int		VerticesCount
+		{
+			int		get()	{ int Result = 0; for each ( MeshEntry^ E in m_Entries ) Result += E->VerticesCount; return Result; }
+		}
+
+		// Gets the size of all the encoded vertices & indices (in bytes)
+		property __int64	EncodedSize
+		{
+			__int64	get()	{ __int64 Result = 0; for each ( MeshEntry^ E in m_Entries ) Result += E->EncodedSize; return Result; }
+		}
+
+		// Gets the size the same vertices would take as floats with 32-bit indices (in bytes)
+		property __int64	FloatSize
+		{
+			__int64	get()	{ __int64 Result = 0; for each ( MeshEntry^ E in m_Entries ) Result += E->FloatSize; return Result; }
+		}
+
+		// Gets the amount of meshes whose indices fit in 16 bits
+		property int		ShortIndicesMeshesCount
+		{
+			int		get()	{ int Result = 0; for each ( MeshEntry^ E in m_Entries ) Result += E->IndexSize == 2 ? 1 : 0; return Result; }
+		}
+
+	public:		// METHODS
+
+		VertexBufferReport( VertexBufferLayout^ _Layout )
+		{
+			m_Layout = _Layout;
+			m_Entries = gcnew List<MeshEntry^>();
+		}
+
+		[System::ComponentModel::BrowsableAttribute( false )]
+		void	AddEntry( MeshEntry^ _Entry )
+		{
+			m_Entries->Add( _Entry );
+		}
+
+		// Gets the amount of meshes with corners out of the range of a half format (clamped to +/-65504, positions should use FLOAT3 or a smaller PositionScale)
+		property int		OverflowMeshesCount
+		{
+			int		get()	{ int Result = 0; for each ( MeshEntry^ E in m_Entries ) for each ( VertexBuffer::AttributeError^ Error in E->Errors ) if ( Error->OverflowsCount > 0 ) { Result++; break; } return Result; }
+		}
+
+		// Gets the largest error of an attribute of the layout over all the meshes that have it
+		float	GetMaxError( int _AttributeIndex )
+		{
+			float	Result = 0.0f;
+			for each ( MeshEntry^ E in m_Entries )
+				if ( !E->Errors[_AttributeIndex]->Missing )
+					Result = Math::Max( Result, E->Errors[_AttributeIndex]->MaxError );
+
+			return	Result;
+		}
+
+		virtual String^	ToString() override
+		{
+			System::Text::StringBuilder^	Result = gcnew System::Text::StringBuilder();
+			Result->AppendFormat( "{0} meshes, {1} vertices, {2:F1} KB encoded against {3:F1} KB as floats ({4:F2}x smaller), {5} meshes with 16-bit indices, {6} meshes out of the half range\n",
+				m_Entries->Count, VerticesCount, EncodedSize / 1024.0, FloatSize / 1024.0, EncodedSize > 0 ? (double) FloatSize / EncodedSize : 0.0, ShortIndicesMeshesCount, OverflowMeshesCount );
+			Result->AppendFormat( "  Layout {0}\n", m_Layout );
+
+			cli::array<VertexBufferLayout::Attribute^>^	Attributes = m_Layout->Attributes;
+			for ( int AttributeIndex=0; AttributeIndex < Attributes->Length; AttributeIndex++ )
+				Result->AppendFormat( "  {0}{1} {2}\tmax error {3:G4}\n", Attributes[AttributeIndex]->Semantic, Attributes[AttributeIndex]->SemanticIndex, Attributes[AttributeIndex]->Format, GetMaxError( AttributeIndex ) );
+
+			for each ( MeshEntry^ E in m_Entries )
+			{
+				Result->AppendFormat( "  {0}\tcorners {1}\tvertices {2}\tindices {3}-bit\t{4} -> {5} bytes", E->MeshName, E->CornersCount, E->VerticesCount, 8 * E->IndexSize, E->FloatSize, E->EncodedSize );
+				for each ( VertexBuffer::AttributeError^ Error in E->Errors )
+					if ( Error->Missing )
+						Result->AppendFormat( "\t{0}{1} missing", Error->Semantic, Error->SemanticIndex );
+					else if ( Error->OverflowsCount > 0 )
+						Result->AppendFormat( "\t{0}{1} {2} corners clamped to the half range", Error->Semantic, Error->SemanticIndex, Error->OverflowsCount );
+				Result->Append( "\n" );
+			}
+
+			return	Result->ToString();
+		}
+	};
+}
@@ -0,0 +1,247 @@
+// Native vertex cache optimizer
+//
+#include "stdafx.h"
+
+#pragma unmanaged
+
+#include <math.h>
+#include "VertexCacheOptimizer.h"
+
+using namespace	FBXImporter;
+
+// Forsyth's scoring constants
+static const float	CACHE_DECAY_POWER = 1.5f;
+static const float	LAST_TRIANGLE_SCORE = 0.75f;
+static const float	VALENCE_BOOST_SCALE = 2.0f;
+static const float	VALENCE_BOOST_POWER = 0.5f;
+
+//////////////////////////////////////////////////////////////////////////
+// VertexCacheOptimizer
+//
+VertexCacheOptimizer::VertexCacheOptimizer( int _VerticesCount, int _CacheSize ) : m_VerticesCount( _VerticesCount )
+{
+	m_CacheSize = _CacheSize < 4 ? 4 : (_CacheSize > MAX_CACHE_SIZE ? MAX_CACHE_SIZE : _CacheSize);
+
+	m_pRemainingValences = new int[3 * _VerticesCount];
+	m_pTriangleOffsets = m_pRemainingValences + _VerticesCount;
+	m_pCachePositions = m_pTriangleOffsets + _VerticesCount;
+	m_pScores = new float[_VerticesCount];
+
+	// Build the scoring tables
+	for ( int CachePosition=0; CachePosition < m_CacheSize; CachePosition++ )
+	{
+		if ( CachePosition < 3 )
+			m_CacheScores[CachePosition] = LAST_TRIANGLE_SCORE;	// The vertices of the last triangle get a fixed score so the next triangle doesn't favor one of its edges
+		else
+			m_CacheScores[CachePosition] = powf( 1.0f - (float) (CachePosition - 3) / (m_CacheSize - 3), CACHE_DECAY_POWER );
+	}
+
+	m_ValenceScores[0] = 0.0f;
+	for ( int Valence=1; Valence < 64; Valence++ )
+		m_ValenceScores[Valence] = VALENCE_BOOST_SCALE * powf( (float) Valence, -VALENCE_BOOST_POWER );
+}
+
+VertexCacheOptimizer::~VertexCacheOptimizer()
+{
+	delete[] m_pRemainingValences;
+	delete[] m_pScores;
+}
+
+float	VertexCacheOptimizer::ComputeVertexScore( int _CachePosition, int _RemainingValence ) const
+{
+	if ( _RemainingValence == 0 )
+		return	-1.0f;	// No triangle needs that vertex anymore
+
+	float	Score = _CachePosition >= 0 && _CachePosition < m_CacheSize ? m_CacheScores[_CachePosition] : 0.0f;
+
+	// Boost vertices with few remaining triangles so lone triangles are not left behind
+	Score += _RemainingValence < 64 ? m_ValenceScores[_RemainingValence] : VALENCE_BOOST_SCALE * powf( (float) _RemainingValence, -VALENCE_BOOST_POWER );
+
+	return	Score;
+}
+
+void	VertexCacheOptimizer::OptimizeTriangleOrder( const int* _pIndices, int _TrianglesCount, int* _pTriangleOrder )
+{
+	if ( _TrianglesCount == 0 )
+		return;
+
+	int	IndicesCount = 3 * _TrianglesCount;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Build the vertex => triangles adjacency of the range
+	for ( int Index=0; Index < IndicesCount; Index++ )
+	{
+		int	VertexIndex = _pIndices[Index];
+		m_pRemainingValences[VertexIndex] = 0;
+		m_pTriangleOffsets[VertexIndex] = -1;
+		m_pCachePositions[VertexIndex] = -1;
+	}
+	for ( int Index=0; Index < IndicesCount; Index++ )
+		m_pRemainingValences[_pIndices[Index]]++;
+
+	// Store the end offset of each vertex's list first, the lists are then filled backward so offsets end up at the start of the lists
+	int	AdjacencyOffset = 0;
+	for ( int Index=0; Index < IndicesCount; Index++ )
+	{
+		int	VertexIndex = _pIndices[Index];
+		if ( m_pTriangleOffsets[VertexIndex] >= 0 )
+			continue;
+
+		AdjacencyOffset += m_pRemainingValences[VertexIndex];
+		m_pTriangleOffsets[VertexIndex] = AdjacencyOffset;
+	}
+
+	int*	pAdjacency = new int[IndicesCount];
+	for ( int Index=0; Index < IndicesCount; Index++ )
+		pAdjacency[--m_pTriangleOffsets[_pIndices[Index]]] = Index / 3;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Compute the initial scores
+	for ( int Index=0; Index < IndicesCount; Index++ )
+	{
+		int	VertexIndex = _pIndices[Index];
+		m_pScores[VertexIndex] = ComputeVertexScore( -1, m_pRemainingValences[VertexIndex] );
+	}
+
+	float*	pTriangleScores = new float[_TrianglesCount];
+	bool*	pEmitted = new bool[_TrianglesCount];
+	int		BestTriangle = 0;
+	for ( int TriangleIndex=0; TriangleIndex < _TrianglesCount; TriangleIndex++ )
+	{
+		const int*	pTriangle = _pIndices + 3 * TriangleIndex;
+		pTriangleScores[TriangleIndex] = m_pScores[pTriangle[0]] + m_pScores[pTriangle[1]] + m_pScores[pTriangle[2]];
+		pEmitted[TriangleIndex] = false;
+		if ( pTriangleScores[TriangleIndex] > pTriangleScores[BestTriangle] )
+			BestTriangle = TriangleIndex;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Emit triangles one by one, always picking the best scoring triangle among the ones using cached vertices
+	int		pCache[MAX_CACHE_SIZE+3];
+	int		pNewCache[MAX_CACHE_SIZE+3];
+	int		CacheCount = 0;
+	int		InputCursor = 0;	// When no cached vertex leads anywhere, we restart from the next triangle in input order
+
+	for ( int OutputIndex=0; OutputIndex < _TrianglesCount; OutputIndex++ )
+	{
+		if ( BestTriangle < 0 )
+		{	// Dead end
+			while ( pEmitted[InputCursor] )
+				InputCursor++;
+			BestTriangle = InputCursor;
+		}
+
+		_pTriangleOrder[OutputIndex] = BestTriangle;
+		pEmitted[BestTriangle] = true;
+
+		// Remove the triangle from the lists of its vertices & push them in front of the cache
+		const int*	pTriangle = _pIndices + 3 * BestTriangle;
+		int			NewCacheCount = 0;
+		for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+		{
+			int		VertexIndex = pTriangle[CornerIndex];
+			int*	pTriangles = pAdjacency + m_pTriangleOffsets[VertexIndex];
+			int		Valence = m_pRemainingValences[VertexIndex];
+			for ( int AdjacentIndex=0; AdjacentIndex < Valence; AdjacentIndex++ )
+				if ( pTriangles[AdjacentIndex] == BestTriangle )
+				{
+					pTriangles[AdjacentIndex] = pTriangles[Valence-1];
+					break;
+				}
+			m_pRemainingValences[VertexIndex]--;
+
+			if ( (CornerIndex < 1 || VertexIndex != pTriangle[0]) && (CornerIndex < 2 || VertexIndex != pTriangle[1]) )
+				pNewCache[NewCacheCount++] = VertexIndex;	// (degenerate triangles don't push the same vertex twice)
+		}
+
+		for ( int CacheIndex=0; CacheIndex < CacheCount; CacheIndex++ )
+		{
+			int	VertexIndex = pCache[CacheIndex];
+			if ( VertexIndex != pTriangle[0] && VertexIndex != pTriangle[1] && VertexIndex != pTriangle[2] )
+				pNewCache[NewCacheCount++] = VertexIndex;
+		}
+
+		// Update the scores of the cached vertices & their triangles (vertices pushed out of the cache are updated one last time)
+		BestTriangle = -1;
+		float	BestScore = -1.0f;
+		for ( int CacheIndex=0; CacheIndex < NewCacheCount; CacheIndex++ )
+		{
+			int		VertexIndex = pNewCache[CacheIndex];
+			int		CachePosition = CacheIndex < m_CacheSize ? CacheIndex : -1;
+			m_pCachePositions[VertexIndex] = CachePosition;
+
+			float	Score = ComputeVertexScore( CachePosition, m_pRemainingValences[VertexIndex] );
+			float	DeltaScore = Score - m_pScores[VertexIndex];
+			m_pScores[VertexIndex] = Score;
+
+			const int*	pTriangles = pAdjacency + m_pTriangleOffsets[VertexIndex];
+			int			Valence = m_pRemainingValences[VertexIndex];
+			for ( int AdjacentIndex=0; AdjacentIndex < Valence; AdjacentIndex++ )
+			{
+				int	TriangleIndex = pTriangles[AdjacentIndex];
+				pTriangleScores[TriangleIndex] += DeltaScore;
+				if ( CachePosition >= 0 && pTriangleScores[TriangleIndex] > BestScore )
+				{
+					BestScore = pTriangleScores[TriangleIndex];
+					BestTriangle = TriangleIndex;
+				}
+			}
+		}
+
+		CacheCount = NewCacheCount < m_CacheSize ? NewCacheCount : m_CacheSize;
+		for ( int CacheIndex=0; CacheIndex < CacheCount; CacheIndex++ )
+			pCache[CacheIndex] = pNewCache[CacheIndex];
+	}
+
+	delete[] pEmitted;
+	delete[] pTriangleScores;
+	delete[] pAdjacency;
+}
+
+VertexCacheStatistics	VertexCacheOptimizer::Simulate( const int* _pIndices, int _TrianglesCount, int _VerticesCount, int _CacheSize )
+{
+	VertexCacheStatistics	Result;
+	Result.TrianglesCount = _TrianglesCount;
+	Result.VerticesCount = 0;
+	Result.MissesCount = 0;
+
+	// A vertex is in the FIFO if it was inserted less than CacheSize misses ago
+	int*	pInsertionStamps = new int[_VerticesCount];
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+		pInsertionStamps[VertexIndex] = -1;
+
+	for ( int Index=0; Index < 3 * _TrianglesCount; Index++ )
+	{
+		int	VertexIndex = _pIndices[Index];
+		int	Stamp = pInsertionStamps[VertexIndex];
+		if ( Stamp >= 0 && Result.MissesCount - Stamp < _CacheSize )
+			continue;	// Hit
+
+		if ( Stamp < 0 )
+			Result.VerticesCount++;
+
+		pInsertionStamps[VertexIndex] = Result.MissesCount++;
+	}
+
+	delete[] pInsertionStamps;
+
+	return	Result;
+}
+
+int		VertexCacheOptimizer::BuildVertexFetchRemap( const int* _pIndices, int _IndicesCount, int _VerticesCount, int* _pRemap )
+{
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+		_pRemap[VertexIndex] = -1;
+
+	int	NextVertexIndex = 0;
+	for ( int Index=0; Index < _IndicesCount; Index++ )
+		if ( _pRemap[_pIndices[Index]] < 0 )
+			_pRemap[_pIndices[Index]] = NextVertexIndex++;
+
+	int	ReferencedVerticesCount = NextVertexIndex;
+	for ( int VertexIndex=0; VertexIndex < _VerticesCount; VertexIndex++ )
+		if ( _pRemap[VertexIndex] < 0 )
+			_pRemap[VertexIndex] = NextVertexIndex++;
+
+	return	ReferencedVerticesCount;
+}
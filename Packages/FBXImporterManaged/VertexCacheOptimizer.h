@@ -0,0 +1,77 @@
+// Contains the native post-transform vertex cache & vertex fetch optimizer
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Statistics of a simulated post-transform vertex cache
+	//	ACMR = Average Cache Miss Ratio = transformed vertices / triangles (0.5 is ideal for large regular meshes, 3 is the worst case)
+	//	ATVR = Average Transformed Vertex Ratio = transformed vertices / unique vertices (1 is ideal)
+	//
+	struct	VertexCacheStatistics
+	{
+		int		TrianglesCount;
+		int		VerticesCount;		// Unique vertices referenced by the triangles
+		int		MissesCount;		// Vertices transformed (i.e. cache misses)
+
+		float	GetACMR() const		{ return TrianglesCount > 0 ? (float) MissesCount / TrianglesCount : 0.0f; }
+		float	GetATVR() const		{ return VerticesCount > 0 ? (float) MissesCount / VerticesCount : 0.0f; }
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Reorders triangles to maximize post-transform vertex cache hits, using Tom Forsyth's linear-speed algorithm
+	//	(http://home.comcast.net/~tom_forsyth/papers/fast_vert_cache_opt.html)
+	// Then reorders vertices in the order they are first referenced so fetching them is as linear as possible.
+	//
+	// Indices are given as 3 vertex indices per triangle. Triangle ranges (e.g. one per material) are optimized
+	//	independently so the triangles never leave their range.
+	//
+	class	VertexCacheOptimizer
+	{
+	protected:	// NESTED TYPES
+
+		static const int	MAX_CACHE_SIZE = 64;
+
+	protected:	// FIELDS
+
+		int		m_VerticesCount;
+		int		m_CacheSize;
+
+		// Per-vertex working data
+		int*	m_pRemainingValences;	// Amount of triangles not emitted yet that use the vertex
+		int*	m_pTriangleOffsets;		// Offset of the vertex's triangles in the adjacency array
+		int*	m_pCachePositions;		// Position of the vertex in the simulated LRU cache (-1 if not in cache)
+		float*	m_pScores;
+
+		// Scoring tables (indexed by cache position & valence)
+		float	m_CacheScores[MAX_CACHE_SIZE];
+		float	m_ValenceScores[64];
+
+	public:		// METHODS
+
+		VertexCacheOptimizer( int _VerticesCount, int _CacheSize );
+		~VertexCacheOptimizer();
+
+		// Reorders the triangles of a range
+		// _pIndices, the 3*_TrianglesCount indices of the range
+		// _pTriangleOrder, receives the new order of the triangles (i.e. the index in the range of the triangle to draw in N-th position)
+		void	OptimizeTriangleOrder( const int* _pIndices, int _TrianglesCount, int* _pTriangleOrder );
+
+		// Simulates a FIFO vertex cache of the given size (the usual hardware policy) and returns the statistics
+		static VertexCacheStatistics	Simulate( const int* _pIndices, int _TrianglesCount, int _VerticesCount, int _CacheSize );
+
+		// Builds the vertex remap table that sorts vertices by first use
+		// _pRemap receives the new index of each old vertex (vertices that are never referenced are moved at the end, keeping their relative order)
+		// Returns the amount of referenced vertices
+		static int		BuildVertexFetchRemap( const int* _pIndices, int _IndicesCount, int _VerticesCount, int* _pRemap );
+
+	protected:
+
+		float	ComputeVertexScore( int _CachePosition, int _RemainingValence ) const;
+
+	private:
+		VertexCacheOptimizer( const VertexCacheOptimizer& );
+		VertexCacheOptimizer&	operator=( const VertexCacheOptimizer& );
+	};
+}
@@ -0,0 +1,98 @@
+// Contains the report of the vertex cache optimization stage
+//
+#pragma managed
+#pragma once
+
+using namespace System;
+using namespace System::Collections::Generic;
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Reports the simulated post-transform vertex cache efficiency of each mesh before and after optimization
+	//	ACMR = Average Cache Miss Ratio = transformed vertices / triangles (lower is better, 3 is the worst case)
+	//	ATVR = Average Transformed Vertex Ratio = transformed vertices / unique vertices (1 is ideal)
+	//
+	public ref class	VertexCacheReport
+	{
+	public:		// NESTED TYPES
+
+		[System::Diagnostics::DebuggerDisplayAttribute( "{MeshName} ACMR={ACMRBefore}->{ACMRAfter} ATVR={ATVRBefore}->{ATVRAfter}" )]
+		ref class	MeshEntry
+		{
+		public:
+
+			String^		MeshName;
+			int			TrianglesCount;
+			int			VerticesCount;
+			int			RangesCount;		// Amount of material sub-ranges optimized independently
+			bool		VerticesReordered;	// False if the control points could not be reordered (e.g. the mesh has blend shapes)
+
+			float		ACMRBefore;
+			float		ACMRAfter;
+			float		ATVRBefore;
+			float		ATVRAfter;
+		};
+
+	protected:	// FIELDS
+
+		int					m_CacheSize;
+		List<MeshEntry^>^	m_Entries;
+
+	public:		// PROPERTIES
+
+		// Gets the size of the simulated FIFO cache
+		property int		CacheSize
+		{
+			int		get()	{ return m_CacheSize; }
+		}
+
+		property cli::array<MeshEntry^>^	Entries
+		{
+			cli::array<MeshEntry^>^	get()	{ return m_Entries->ToArray(); }
+		}
+
+		property int		TrianglesCount
+		{
+			int		get()	{ int Result = 0; for each ( MeshEntry^ E in m_Entries ) Result += E->TrianglesCount; return Result; }
+		}
+
+		// Gets the ACMR of all the meshes, before optimization
+		property float		ACMRBefore
+		{
+			float	get()	{ float Result = 0.0f; for each ( MeshEntry^ E in m_Entries ) Result += E->ACMRBefore * E->TrianglesCount; return TrianglesCount > 0 ? Result / TrianglesCount : 0.0f; }
+		}
+
+		// Gets the ACMR of all the meshes, after optimization
+		property float		ACMRAfter
+		{
+			float	get()	{ float Result = 0.0f; for each ( MeshEntry^ E in m_Entries ) Result += E->ACMRAfter * E->TrianglesCount; return TrianglesCount > 0 ? Result / TrianglesCount : 0.0f; }
+		}
+
+	public:		// METHODS
+
+		VertexCacheReport( int _CacheSize )
+		{
+			m_CacheSize = _CacheSize;
+			m_Entries = gcnew List<MeshEntry^>();
+		}
+
+		[System::ComponentModel::BrowsableAttribute( false )]
+		void	AddEntry( MeshEntry^ _Entry )
+		{
+			m_Entries->Add( _Entry );
+		}
+
+		virtual String^	ToString() override
+		{
+			System::Text::StringBuilder^	Result = gcnew System::Text::StringBuilder();
+			Result->AppendFormat( "{0} meshes, {1} triangles, cache size {2}, ACMR {3:G4} -> {4:G4}\n", m_Entries->Count, TrianglesCount, m_CacheSize, ACMRBefore, ACMRAfter );
+
+			for each ( MeshEntry^ E in m_Entries )
+				Result->AppendFormat( "  {0}\ttriangles {1}\tvertices {2}\tranges {3}\tACMR {4:G4} -> {5:G4}\tATVR {6:G4} -> {7:G4}{8}\n",
+					E->MeshName, E->TrianglesCount, E->VerticesCount, E->RangesCount, E->ACMRBefore, E->ACMRAfter, E->ATVRBefore, E->ATVRAfter, E->VerticesReordered ? "" : "\t(vertices not reordered)" );
+
+			return	Result->ToString();
+		}
+	};
+}
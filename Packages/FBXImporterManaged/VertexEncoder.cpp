@@ -0,0 +1,619 @@
+// Native vertex layout & encoder
+// Packs triangle corners into the formats of a VertexLayout with SSE2 then welds identical vertices through a hash table
+//
+#ifdef _MANAGED
+#pragma unmanaged
+#endif
+
+#include <math.h>
+#include <string.h>
+#include <emmintrin.h>
+
+#include "VertexEncoder.h"
+
+using namespace	FBXImporter;
+
+//////////////////////////////////////////////////////////////////////////
+// VertexLayout
+//
+VertexLayout::VertexLayout() : m_AttributesCount( 0 ), m_StreamsCount( 0 )
+{
+	for ( int StreamIndex=0; StreamIndex < MAX_STREAMS; StreamIndex++ )
+		m_pStrides[StreamIndex] = 0;
+}
+
+int		VertexLayout::GetVertexSize() const
+{
+	int	Result = 0;
+	for ( int StreamIndex=0; StreamIndex < m_StreamsCount; StreamIndex++ )
+		Result += m_pStrides[StreamIndex];
+
+	return	Result;
+}
+
+bool	VertexLayout::AddAttribute( SEMANTIC _Semantic, int _SemanticIndex, FORMAT _Format, int _Stream )
+{
+	if ( !IsSupported( _Semantic, _Format ) || m_AttributesCount >= MAX_ATTRIBUTES || _Stream < 0 || _Stream >= MAX_STREAMS || _SemanticIndex < 0 )
+		return	false;
+
+	Attribute&	A = m_pAttributes[m_AttributesCount++];
+	A.Semantic = _Semantic;
+	A.SemanticIndex = _SemanticIndex;
+	A.Format = _Format;
+	A.Stream = _Stream;
+	A.Offset = m_pStrides[_Stream];
+
+	m_pStrides[_Stream] += GetFormatSize( _Format );
+	if ( _Stream >= m_StreamsCount )
+		m_StreamsCount = _Stream + 1;
+
+	return	true;
+}
+
+int		VertexLayout::GetFormatSize( FORMAT _Format )
+{
+	switch ( _Format )
+	{
+	case FORMAT_FLOAT2:				return 8;
+	case FORMAT_FLOAT3:				return 12;
+	case FORMAT_FLOAT4:				return 16;
+	case FORMAT_HALF4:				return 8;
+	default:						return 4;
+	}
+}
+
+int		VertexLayout::GetSourceComponentsCount( SEMANTIC _Semantic )
+{
+	switch ( _Semantic )
+	{
+	case SEMANTIC_TANGENT:
+	case SEMANTIC_COLOR:			return 4;
+	case SEMANTIC_UV:				return 2;
+	default:						return 3;
+	}
+}
+
+bool	VertexLayout::IsSupported( SEMANTIC _Semantic, FORMAT _Format )
+{
+	switch ( _Semantic )
+	{
+	case SEMANTIC_POSITION:			return _Format == FORMAT_FLOAT3 || _Format == FORMAT_HALF4;
+	case SEMANTIC_NORMAL:
+	case SEMANTIC_BINORMAL:			return _Format == FORMAT_FLOAT3 || _Format == FORMAT_OCTAHEDRAL16 || _Format == FORMAT_UNORM10_10_10_2;
+	case SEMANTIC_TANGENT:			return _Format == FORMAT_FLOAT4 || _Format == FORMAT_UNORM10_10_10_2;
+	case SEMANTIC_UV:				return _Format == FORMAT_FLOAT2 || _Format == FORMAT_HALF2 || _Format == FORMAT_UNORM16_2;
+	case SEMANTIC_COLOR:			return _Format == FORMAT_FLOAT4 || _Format == FORMAT_HALF4 || _Format == FORMAT_UNORM8_4;
+	default:						return false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SIMD helpers
+//
+namespace
+{
+	const float	HALF_MAX = 65504.0f;
+
+	// Transposes 4 corners of _ComponentsCount floats into one register per component (missing components are 0)
+	void	LoadCorners( const float* _pSource, int _ComponentsCount, __m128* _pComponents )
+	{
+		switch ( _ComponentsCount )
+		{
+		case 2:
+			{
+				__m128	A = _mm_loadu_ps( _pSource+0 );	// x0 y0 x1 y1
+				__m128	B = _mm_loadu_ps( _pSource+4 );	// x2 y2 x3 y3
+				_pComponents[0] = _mm_shuffle_ps( A, B, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+				_pComponents[1] = _mm_shuffle_ps( A, B, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+				_pComponents[2] = _mm_setzero_ps();
+				_pComponents[3] = _mm_setzero_ps();
+				break;
+			}
+		case 3:
+			{
+				__m128	A = _mm_loadu_ps( _pSource+0 );	// x0 y0 z0 x1
+				__m128	B = _mm_loadu_ps( _pSource+4 );	// y1 z1 x2 y2
+				__m128	C = _mm_loadu_ps( _pSource+8 );	// z2 x3 y3 z3
+				_pComponents[0] = _mm_shuffle_ps( _mm_shuffle_ps( A, B, _MM_SHUFFLE( 0, 0, 3, 0 ) ), _mm_shuffle_ps( B, C, _MM_SHUFFLE( 0, 1, 0, 2 ) ), _MM_SHUFFLE( 2, 0, 1, 0 ) );
+				_pComponents[1] = _mm_shuffle_ps( _mm_shuffle_ps( A, B, _MM_SHUFFLE( 3, 0, 0, 1 ) ), _mm_shuffle_ps( B, C, _MM_SHUFFLE( 0, 2, 3, 0 ) ), _MM_SHUFFLE( 2, 1, 2, 0 ) );
+				_pComponents[2] = _mm_shuffle_ps( _mm_shuffle_ps( A, B, _MM_SHUFFLE( 0, 1, 0, 2 ) ), _mm_shuffle_ps( C, C, _MM_SHUFFLE( 3, 0, 0, 0 ) ), _MM_SHUFFLE( 3, 0, 2, 0 ) );
+				_pComponents[3] = _mm_setzero_ps();
+				break;
+			}
+		default:
+			{
+				_pComponents[0] = _mm_loadu_ps( _pSource+0 );
+				_pComponents[1] = _mm_loadu_ps( _pSource+4 );
+				_pComponents[2] = _mm_loadu_ps( _pSource+8 );
+				_pComponents[3] = _mm_loadu_ps( _pSource+12 );
+				_MM_TRANSPOSE4_PS( _pComponents[0], _pComponents[1], _pComponents[2], _pComponents[3] );
+				break;
+			}
+		}
+	}
+
+	// Converts 4 floats into halves (in the low 16 bits of each lane), rounding to nearest even
+	// Overflows & infinities are clamped to the largest half, NaNs stay NaNs & tiny values give denormals (after F. Giesen's float_to_half_SSE2)
+	__m128i	FloatToHalf( __m128 _Value )
+	{
+		const __m128i	SIGN_MASK = _mm_set1_epi32( 0x80000000 );
+		const __m128i	F16_MAX = _mm_set1_epi32( (127 + 16) << 23 );				// Every float >= this rounds to infinity
+		const __m128i	NAN_BIT = _mm_set1_epi32( 0x200 );
+		const __m128i	INFINITY_AS_F16 = _mm_set1_epi32( 0x7C00 );
+		const __m128i	MIN_NORMAL = _mm_set1_epi32( (127 - 14) << 23 );			// The smallest float giving a normalized half
+		const __m128i	SUBNORMAL_MAGIC = _mm_set1_epi32( ((127 - 15) + (23 - 10) + 1) << 23 );
+		const __m128i	NORMAL_BIAS = _mm_set1_epi32( 0xFFF - ((127 - 15) << 23) );	// Adjusts the exponent & adds the mantissa rounding
+
+		__m128	Sign = _mm_and_ps( _mm_castsi128_ps( SIGN_MASK ), _Value );
+		__m128	Abs = _mm_min_ps( _mm_set1_ps( HALF_MAX ), _mm_xor_ps( _Value, Sign ) );	// NaNs are returned as the 2nd operand
+		__m128i	AbsBits = _mm_castps_si128( Abs );
+
+		__m128	bIsNaN = _mm_cmpunord_ps( Abs, Abs );
+		__m128i	bIsRegular = _mm_cmpgt_epi32( F16_MAX, AbsBits );
+		__m128i	InfinityOrNaN = _mm_or_si128( _mm_and_si128( _mm_castps_si128( bIsNaN ), NAN_BIT ), INFINITY_AS_F16 );
+		__m128i	bIsSubnormal = _mm_cmpgt_epi32( MIN_NORMAL, AbsBits );
+
+		// Subnormal results: let the float addition round the mantissa
+		__m128i	Subnormal = _mm_sub_epi32( _mm_castps_si128( _mm_add_ps( Abs, _mm_castsi128_ps( SUBNORMAL_MAGIC ) ) ), SUBNORMAL_MAGIC );
+
+		// Normal results: bias towards rounding up when the half mantissa is odd
+		__m128i	MantissaOdd = _mm_srai_epi32( _mm_slli_epi32( AbsBits, 31 - 13 ), 31 );
+		__m128i	Normal = _mm_srli_epi32( _mm_sub_epi32( _mm_add_epi32( AbsBits, NORMAL_BIAS ), MantissaOdd ), 13 );
+
+		__m128i	NonSpecial = _mm_or_si128( _mm_and_si128( Subnormal, bIsSubnormal ), _mm_andnot_si128( bIsSubnormal, Normal ) );
+		__m128i	Result = _mm_or_si128( _mm_and_si128( NonSpecial, bIsRegular ), _mm_andnot_si128( bIsRegular, InfinityOrNaN ) );
+
+		return	_mm_and_si128( _mm_or_si128( Result, _mm_srli_epi32( _mm_castps_si128( Sign ), 16 ) ), _mm_set1_epi32( 0xFFFF ) );
+	}
+
+	// Converts 4 floats into unsigned normalized integers of the given maximum (values are clamped to [0,1])
+	__m128i	FloatToUNorm( __m128 _Value, float _Max )
+	{
+		_Value = _mm_min_ps( _mm_max_ps( _Value, _mm_setzero_ps() ), _mm_set1_ps( 1.0f ) );
+		return	_mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( _Value, _mm_set1_ps( _Max ) ), _mm_set1_ps( 0.5f ) ) );
+	}
+
+	// Normalizes 4 vectors (null vectors stay null)
+	void	Normalize( __m128& _X, __m128& _Y, __m128& _Z )
+	{
+		__m128	SquareLength = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _X, _X ), _mm_mul_ps( _Y, _Y ) ), _mm_mul_ps( _Z, _Z ) );
+		__m128	InvLength = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( _mm_max_ps( SquareLength, _mm_set1_ps( 1e-30f ) ) ) );
+		_X = _mm_mul_ps( _X, InvLength );
+		_Y = _mm_mul_ps( _Y, InvLength );
+		_Z = _mm_mul_ps( _Z, InvLength );
+	}
+
+	// Encodes 4 source corners into 4 (or 8 for 8 bytes formats) packed dwords
+	void	EncodeCorners( VertexLayout::SEMANTIC _Semantic, VertexLayout::FORMAT _Format, const float* _pSource, unsigned int* _pPacked )
+	{
+		int		ComponentsCount = VertexLayout::GetSourceComponentsCount( _Semantic );
+		__m128	pComponents[4];
+		LoadCorners( _pSource, ComponentsCount, pComponents );
+
+		__m128i	Low = _mm_setzero_si128(), High = _mm_setzero_si128();
+		switch ( _Format )
+		{
+		case VertexLayout::FORMAT_HALF2:
+			Low = _mm_or_si128( FloatToHalf( pComponents[0] ), _mm_slli_epi32( FloatToHalf( pComponents[1] ), 16 ) );
+			break;
+
+		case VertexLayout::FORMAT_HALF4:
+			{
+				// Positions get w = 1
+				__m128	W = _Semantic == VertexLayout::SEMANTIC_POSITION ? _mm_set1_ps( 1.0f ) : pComponents[3];
+				__m128i	XY = _mm_or_si128( FloatToHalf( pComponents[0] ), _mm_slli_epi32( FloatToHalf( pComponents[1] ), 16 ) );
+				__m128i	ZW = _mm_or_si128( FloatToHalf( pComponents[2] ), _mm_slli_epi32( FloatToHalf( W ), 16 ) );
+				Low = _mm_unpacklo_epi32( XY, ZW );
+				High = _mm_unpackhi_epi32( XY, ZW );
+				break;
+			}
+
+		case VertexLayout::FORMAT_UNORM16_2:
+			Low = _mm_or_si128( FloatToUNorm( pComponents[0], 65535.0f ), _mm_slli_epi32( FloatToUNorm( pComponents[1], 65535.0f ), 16 ) );
+			break;
+
+		case VertexLayout::FORMAT_UNORM8_4:
+			Low = _mm_or_si128( _mm_or_si128( FloatToUNorm( pComponents[0], 255.0f ), _mm_slli_epi32( FloatToUNorm( pComponents[1], 255.0f ), 8 ) ),
+								_mm_or_si128( _mm_slli_epi32( FloatToUNorm( pComponents[2], 255.0f ), 16 ), _mm_slli_epi32( FloatToUNorm( pComponents[3], 255.0f ), 24 ) ) );
+			break;
+
+		case VertexLayout::FORMAT_OCTAHEDRAL16:
+			{
+				const __m128	SIGN_MASK = _mm_castsi128_ps( _mm_set1_epi32( 0x80000000 ) );
+				const __m128	ONE = _mm_set1_ps( 1.0f );
+
+				// Project on the octahedron |x|+|y|+|z| = 1
+				__m128	AbsX = _mm_andnot_ps( SIGN_MASK, pComponents[0] );
+				__m128	AbsY = _mm_andnot_ps( SIGN_MASK, pComponents[1] );
+				__m128	AbsZ = _mm_andnot_ps( SIGN_MASK, pComponents[2] );
+				__m128	InvSum = _mm_div_ps( ONE, _mm_max_ps( _mm_add_ps( _mm_add_ps( AbsX, AbsY ), AbsZ ), _mm_set1_ps( 1e-30f ) ) );
+				__m128	X = _mm_mul_ps( pComponents[0], InvSum );
+				__m128	Y = _mm_mul_ps( pComponents[1], InvSum );
+
+				// Fold the lower hemisphere over the diagonals
+				__m128	FoldedX = _mm_or_ps( _mm_sub_ps( ONE, _mm_andnot_ps( SIGN_MASK, Y ) ), _mm_and_ps( SIGN_MASK, X ) );
+				__m128	FoldedY = _mm_or_ps( _mm_sub_ps( ONE, _mm_andnot_ps( SIGN_MASK, X ) ), _mm_and_ps( SIGN_MASK, Y ) );
+				__m128	bLower = _mm_cmplt_ps( pComponents[2], _mm_setzero_ps() );
+				X = _mm_or_ps( _mm_and_ps( bLower, FoldedX ), _mm_andnot_ps( bLower, X ) );
+				Y = _mm_or_ps( _mm_and_ps( bLower, FoldedY ), _mm_andnot_ps( bLower, Y ) );
+
+				// Store as snorm16
+				const __m128	SCALE = _mm_set1_ps( 32767.0f );
+				__m128i	SX = _mm_cvtps_epi32( _mm_mul_ps( _mm_min_ps( _mm_max_ps( X, _mm_set1_ps( -1.0f ) ), ONE ), SCALE ) );
+				__m128i	SY = _mm_cvtps_epi32( _mm_mul_ps( _mm_min_ps( _mm_max_ps( Y, _mm_set1_ps( -1.0f ) ), ONE ), SCALE ) );
+				Low = _mm_or_si128( _mm_and_si128( SX, _mm_set1_epi32( 0xFFFF ) ), _mm_slli_epi32( SY, 16 ) );
+				break;
+			}
+
+		case VertexLayout::FORMAT_UNORM10_10_10_2:
+			{
+				__m128	X = pComponents[0], Y = pComponents[1], Z = pComponents[2];
+				Normalize( X, Y, Z );
+
+				const __m128	HALF = _mm_set1_ps( 0.5f );
+				__m128i	PX = FloatToUNorm( _mm_add_ps( _mm_mul_ps( X, HALF ), HALF ), 1023.0f );
+				__m128i	PY = FloatToUNorm( _mm_add_ps( _mm_mul_ps( Y, HALF ), HALF ), 1023.0f );
+				__m128i	PZ = FloatToUNorm( _mm_add_ps( _mm_mul_ps( Z, HALF ), HALF ), 1023.0f );
+
+				// The handedness of tangents is stored as 0 (-1) or 3 (+1)
+				__m128i	PW = _mm_set1_epi32( 3 );
+				if ( ComponentsCount == 4 )
+					PW = _mm_andnot_si128( _mm_castps_si128( _mm_cmplt_ps( pComponents[3], _mm_setzero_ps() ) ), PW );
+
+				Low = _mm_or_si128( _mm_or_si128( PX, _mm_slli_epi32( PY, 10 ) ), _mm_or_si128( _mm_slli_epi32( PZ, 20 ), _mm_slli_epi32( PW, 30 ) ) );
+				break;
+			}
+
+		default:
+			break;
+		}
+
+		_mm_storeu_si128( (__m128i*) _pPacked, Low );
+		if ( VertexLayout::GetFormatSize( _Format ) == 8 )
+			_mm_storeu_si128( (__m128i*) (_pPacked+4), High );
+	}
+
+	float	HalfToFloat( unsigned short _Value )
+	{
+		unsigned int	Sign = (_Value & 0x8000) << 16;
+		unsigned int	Exponent = (_Value >> 10) & 0x1F;
+		unsigned int	Mantissa = _Value & 0x3FF;
+
+		float	Result;
+		if ( Exponent == 0 )
+			Result = Mantissa * (1.0f / 16777216.0f);	// Denormal: mantissa * 2^-24
+		else
+		{
+			unsigned int	Bits = Exponent == 31 ? (0x7F800000 | (Mantissa << 13)) : (((Exponent + 112) << 23) | (Mantissa << 13));
+			memcpy( &Result, &Bits, 4 );
+		}
+
+		return	Sign != 0 ? -Result : Result;
+	}
+
+	void	NormalizeScalar( float* _pVector )
+	{
+		float	Length = sqrtf( _pVector[0]*_pVector[0] + _pVector[1]*_pVector[1] + _pVector[2]*_pVector[2] );
+		float	InvLength = Length > 1e-15f ? 1.0f / Length : 0.0f;
+		_pVector[0] *= InvLength;
+		_pVector[1] *= InvLength;
+		_pVector[2] *= InvLength;
+	}
+
+	unsigned int	HashBytes( const unsigned char* _pBytes, int _Size )
+	{
+		unsigned int	Hash = 2166136261U;		// FNV-1a
+		for ( int Index=0; Index < _Size; Index++ )
+			Hash = (Hash ^ _pBytes[Index]) * 16777619U;
+
+		return	Hash;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// VertexEncoder
+//
+VertexEncoder::VertexEncoder( const VertexLayout& _Layout ) : m_Layout( _Layout ), m_CornersCount( 0 ), m_VerticesCount( 0 ), m_pIndices( NULL )
+{
+	int	Offset = 0;
+	for ( int StreamIndex=0; StreamIndex < VertexLayout::MAX_STREAMS; StreamIndex++ )
+	{
+		m_ppStreams[StreamIndex] = NULL;
+		m_pStreamOffsets[StreamIndex] = Offset;
+		Offset += StreamIndex < m_Layout.GetStreamsCount() ? m_Layout.GetStride( StreamIndex ) : 0;
+	}
+	for ( int AttributeIndex=0; AttributeIndex < VertexLayout::MAX_ATTRIBUTES; AttributeIndex++ )
+	{
+		m_pErrors[AttributeIndex].MaxError = 0.0f;
+		m_pErrors[AttributeIndex].RMSError = 0.0f;
+	}
+}
+
+VertexEncoder::~VertexEncoder()
+{
+	Release();
+}
+
+void	VertexEncoder::Release()
+{
+	for ( int StreamIndex=0; StreamIndex < VertexLayout::MAX_STREAMS; StreamIndex++ )
+	{
+		delete[] m_ppStreams[StreamIndex];
+		m_ppStreams[StreamIndex] = NULL;
+	}
+	delete[] m_pIndices;
+	m_pIndices = NULL;
+	m_CornersCount = 0;
+	m_VerticesCount = 0;
+}
+
+void	VertexEncoder::Encode( const float* const* _ppSources, int _CornersCount )
+{
+	Release();
+
+	int	AttributesCount = m_Layout.GetAttributesCount();
+	int	StreamsCount = m_Layout.GetStreamsCount();
+	int	CornerSize = m_Layout.GetVertexSize();
+	m_CornersCount = _CornersCount;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Encode every corner as a full vertex (all the streams one after the other)
+	unsigned char*	pCorners = new unsigned char[CornerSize * (_CornersCount > 0 ? _CornersCount : 1)];
+	const float*	ppSources[VertexLayout::MAX_ATTRIBUTES];
+	float*			ppDefaults[VertexLayout::MAX_ATTRIBUTES];
+	for ( int AttributeIndex=0; AttributeIndex < AttributesCount; AttributeIndex++ )
+	{
+		const VertexLayout::Attribute&	A = m_Layout.GetAttribute( AttributeIndex );
+		int	ComponentsCount = VertexLayout::GetSourceComponentsCount( A.Semantic );
+
+		ppSources[AttributeIndex] = _ppSources[AttributeIndex];
+		ppDefaults[AttributeIndex] = NULL;
+		if ( ppSources[AttributeIndex] == NULL )
+		{
+			// Missing attributes are encoded from default values so the layout stays the same for every mesh
+			float	pDefault[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			if ( A.Semantic == VertexLayout::SEMANTIC_COLOR )
+				pDefault[0] = pDefault[1] = pDefault[2] = pDefault[3] = 1.0f;
+			else if ( A.Semantic == VertexLayout::SEMANTIC_TANGENT )
+				pDefault[3] = 1.0f;
+
+			ppDefaults[AttributeIndex] = new float[ComponentsCount * (_CornersCount > 0 ? _CornersCount : 1)];
+			for ( int CornerIndex=0; CornerIndex < _CornersCount; CornerIndex++ )
+				memcpy( ppDefaults[AttributeIndex] + ComponentsCount * CornerIndex, pDefault, ComponentsCount * sizeof(float) );
+			ppSources[AttributeIndex] = ppDefaults[AttributeIndex];
+		}
+
+		EncodeAttribute( A.Semantic, A.Format, ppSources[AttributeIndex], _CornersCount, pCorners + m_pStreamOffsets[A.Stream] + A.Offset, CornerSize );
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Weld corners with identical encodings through an open addressing hash table
+	int	TableSize = 16;
+	while ( TableSize < 2 * _CornersCount )
+		TableSize <<= 1;
+
+	int*	pTable = new int[TableSize];
+	int*	pVertexCorners = new int[_CornersCount > 0 ? _CornersCount : 1];	// The first corner of each vertex
+	for ( int SlotIndex=0; SlotIndex < TableSize; SlotIndex++ )
+		pTable[SlotIndex] = -1;
+
+	m_pIndices = new unsigned int[_CornersCount > 0 ? _CornersCount : 1];
+	for ( int CornerIndex=0; CornerIndex < _CornersCount; CornerIndex++ )
+	{
+		const unsigned char*	pCorner = pCorners + CornerSize * CornerIndex;
+		int	SlotIndex = HashBytes( pCorner, CornerSize ) & (TableSize-1);
+		for ( ;; )
+		{
+			int	VertexIndex = pTable[SlotIndex];
+			if ( VertexIndex < 0 )
+			{
+				VertexIndex = m_VerticesCount++;
+				pVertexCorners[VertexIndex] = CornerIndex;
+				pTable[SlotIndex] = VertexIndex;
+				m_pIndices[CornerIndex] = VertexIndex;
+				break;
+			}
+			if ( memcmp( pCorners + CornerSize * pVertexCorners[VertexIndex], pCorner, CornerSize ) == 0 )
+			{
+				m_pIndices[CornerIndex] = VertexIndex;
+				break;
+			}
+			SlotIndex = (SlotIndex + 1) & (TableSize-1);
+		}
+	}
+	delete[] pTable;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Split the unique vertices into their streams
+	for ( int StreamIndex=0; StreamIndex < StreamsCount; StreamIndex++ )
+	{
+		int	Stride = m_Layout.GetStride( StreamIndex );
+		m_ppStreams[StreamIndex] = new unsigned char[Stride * (m_VerticesCount > 0 ? m_VerticesCount : 1)];
+		for ( int VertexIndex=0; VertexIndex < m_VerticesCount; VertexIndex++ )
+			memcpy( m_ppStreams[StreamIndex] + Stride * VertexIndex, pCorners + CornerSize * pVertexCorners[VertexIndex] + m_pStreamOffsets[StreamIndex], Stride );
+	}
+	delete[] pVertexCorners;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 4] Measure the encoding errors
+	MeasureErrors( ppSources, pCorners, CornerSize );
+
+	for ( int AttributeIndex=0; AttributeIndex < AttributesCount; AttributeIndex++ )
+		delete[] ppDefaults[AttributeIndex];
+	delete[] pCorners;
+}
+
+void	VertexEncoder::GetIndices( void* _pIndices ) const
+{
+	if ( GetIndexSize() == 4 )
+	{
+		memcpy( _pIndices, m_pIndices, m_CornersCount * sizeof(unsigned int) );
+		return;
+	}
+
+	unsigned short*	pIndices = (unsigned short*) _pIndices;
+	for ( int CornerIndex=0; CornerIndex < m_CornersCount; CornerIndex++ )
+		pIndices[CornerIndex] = (unsigned short) m_pIndices[CornerIndex];
+}
+
+void	VertexEncoder::MeasureErrors( const float* const* _ppSources, const unsigned char* _pCorners, int _CornerSize )
+{
+	for ( int AttributeIndex=0; AttributeIndex < m_Layout.GetAttributesCount(); AttributeIndex++ )
+	{
+		const VertexLayout::Attribute&	A = m_Layout.GetAttribute( AttributeIndex );
+		int		ComponentsCount = VertexLayout::GetSourceComponentsCount( A.Semantic );
+		bool	bDirection = A.Format == VertexLayout::FORMAT_OCTAHEDRAL16 || A.Format == VertexLayout::FORMAT_UNORM10_10_10_2;
+		bool	bHalf = A.Format == VertexLayout::FORMAT_HALF2 || A.Format == VertexLayout::FORMAT_HALF4;
+
+		double	SumSquares = 0.0;
+		int		ValuesCount = 0;
+		float	MaxError = 0.0f;
+		int		OverflowsCount = 0;
+		for ( int CornerIndex=0; CornerIndex < m_CornersCount; CornerIndex++ )
+		{
+			float	pSource[4], pDecoded[4];
+			memcpy( pSource, _ppSources[AttributeIndex] + ComponentsCount * CornerIndex, ComponentsCount * sizeof(float) );
+			DecodeAttribute( A.Semantic, A.Format, _pCorners + _CornerSize * CornerIndex + m_pStreamOffsets[A.Stream] + A.Offset, pDecoded );
+
+			if ( bHalf )
+				for ( int ComponentIndex=0; ComponentIndex < ComponentsCount; ComponentIndex++ )
+					if ( fabsf( pSource[ComponentIndex] ) > HALF_MAX )
+					{
+						OverflowsCount++;
+						break;
+					}
+
+			if ( bDirection )
+			{
+				NormalizeScalar( pSource );
+				if ( A.Semantic == VertexLayout::SEMANTIC_TANGENT )
+					pSource[3] = pSource[3] < 0.0f ? -1.0f : 1.0f;
+			}
+
+			for ( int ComponentIndex=0; ComponentIndex < ComponentsCount; ComponentIndex++ )
+			{
+				float	Error = fabsf( pDecoded[ComponentIndex] - pSource[ComponentIndex] );
+				if ( Error != Error )
+					continue;	// NaNs are encoded as such
+				MaxError = Error > MaxError ? Error : MaxError;
+				SumSquares += Error * Error;
+				ValuesCount++;
+			}
+		}
+
+		m_pErrors[AttributeIndex].MaxError = MaxError;
+		m_pErrors[AttributeIndex].RMSError = ValuesCount > 0 ? (float) sqrt( SumSquares / ValuesCount ) : 0.0f;
+		m_pErrors[AttributeIndex].OverflowsCount = OverflowsCount;
+	}
+}
+
+void	VertexEncoder::EncodeAttribute( VertexLayout::SEMANTIC _Semantic, VertexLayout::FORMAT _Format, const float* _pSource, int _Count, unsigned char* _pTarget, int _TargetStride )
+{
+	int	ComponentsCount = VertexLayout::GetSourceComponentsCount( _Semantic );
+	int	FormatSize = VertexLayout::GetFormatSize( _Format );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Float formats are copied as-is
+	if ( _Format == VertexLayout::FORMAT_FLOAT2 || _Format == VertexLayout::FORMAT_FLOAT3 || _Format == VertexLayout::FORMAT_FLOAT4 )
+	{
+		for ( int Index=0; Index < _Count; Index++, _pSource+=ComponentsCount, _pTarget+=_TargetStride )
+			memcpy( _pTarget, _pSource, FormatSize );
+		return;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Other formats are encoded 4 values at a time, the last values going through a padded copy of the source
+	int				DwordsCount = FormatSize / 4;
+	unsigned int	pPacked[8];
+	for ( int Index=0; Index < _Count; Index+=4 )
+	{
+		int	BlockCount = _Count - Index < 4 ? _Count - Index : 4;
+		if ( BlockCount == 4 )
+			EncodeCorners( _Semantic, _Format, _pSource + ComponentsCount * Index, pPacked );
+		else
+		{
+			float	pPadded[16];
+			memset( pPadded, 0, sizeof(pPadded) );
+			memcpy( pPadded, _pSource + ComponentsCount * Index, BlockCount * ComponentsCount * sizeof(float) );
+			EncodeCorners( _Semantic, _Format, pPadded, pPacked );
+		}
+
+		// 8 bytes formats hold (xy0, zw0, xy1, zw1) then (xy2, zw2, xy3, zw3)
+		for ( int BlockIndex=0; BlockIndex < BlockCount; BlockIndex++ )
+			memcpy( _pTarget + _TargetStride * (Index + BlockIndex), pPacked + DwordsCount * BlockIndex, FormatSize );
+	}
+}
+
+void	VertexEncoder::DecodeAttribute( VertexLayout::SEMANTIC _Semantic, VertexLayout::FORMAT _Format, const unsigned char* _pSource, float* _pValue )
+{
+	int	ComponentsCount = VertexLayout::GetSourceComponentsCount( _Semantic );
+	for ( int ComponentIndex=0; ComponentIndex < 4; ComponentIndex++ )
+		_pValue[ComponentIndex] = 0.0f;
+
+	unsigned int	Packed;
+	memcpy( &Packed, _pSource, 4 );
+
+	switch ( _Format )
+	{
+	case VertexLayout::FORMAT_FLOAT2:
+	case VertexLayout::FORMAT_FLOAT3:
+	case VertexLayout::FORMAT_FLOAT4:
+		memcpy( _pValue, _pSource, VertexLayout::GetFormatSize( _Format ) );
+		break;
+
+	case VertexLayout::FORMAT_HALF2:
+	case VertexLayout::FORMAT_HALF4:
+		{
+			unsigned short	pHalves[4];
+			memcpy( pHalves, _pSource, VertexLayout::GetFormatSize( _Format ) );
+			int	HalvesCount = _Format == VertexLayout::FORMAT_HALF2 ? 2 : (ComponentsCount < 4 ? ComponentsCount : 4);
+			for ( int ComponentIndex=0; ComponentIndex < HalvesCount; ComponentIndex++ )
+				_pValue[ComponentIndex] = HalfToFloat( pHalves[ComponentIndex] );
+			break;
+		}
+
+	case VertexLayout::FORMAT_UNORM16_2:
+		_pValue[0] = (Packed & 0xFFFF) / 65535.0f;
+		_pValue[1] = (Packed >> 16) / 65535.0f;
+		break;
+
+	case VertexLayout::FORMAT_UNORM8_4:
+		for ( int ComponentIndex=0; ComponentIndex < 4; ComponentIndex++ )
+			_pValue[ComponentIndex] = ((Packed >> (8*ComponentIndex)) & 0xFF) / 255.0f;
+		break;
+
+	case VertexLayout::FORMAT_OCTAHEDRAL16:
+		{
+			float	X = (short) (Packed & 0xFFFF) / 32767.0f;
+			float	Y = (short) (Packed >> 16) / 32767.0f;
+			X = X < -1.0f ? -1.0f : X;
+			Y = Y < -1.0f ? -1.0f : Y;
+
+			float	Z = 1.0f - fabsf( X ) - fabsf( Y );
+			if ( Z < 0.0f )
+			{
+				float	UnfoldedX = (1.0f - fabsf( Y )) * (X < 0.0f ? -1.0f : 1.0f);
+				float	UnfoldedY = (1.0f - fabsf( X )) * (Y < 0.0f ? -1.0f : 1.0f);
+				X = UnfoldedX;
+				Y = UnfoldedY;
+			}
+			_pValue[0] = X;
+			_pValue[1] = Y;
+			_pValue[2] = Z;
+			NormalizeScalar( _pValue );
+			break;
+		}
+
+	case VertexLayout::FORMAT_UNORM10_10_10_2:
+		_pValue[0] = 2.0f * ((Packed & 0x3FF) / 1023.0f) - 1.0f;
+		_pValue[1] = 2.0f * (((Packed >> 10) & 0x3FF) / 1023.0f) - 1.0f;
+		_pValue[2] = 2.0f * (((Packed >> 20) & 0x3FF) / 1023.0f) - 1.0f;
+		NormalizeScalar( _pValue );
+		if ( ComponentsCount == 4 )
+			_pValue[3] = (Packed >> 30) >= 2 ? 1.0f : -1.0f;
+		break;
+
+	default:
+		break;
+	}
+}
@@ -0,0 +1,174 @@
+// Contains the native declarative vertex layout and the SIMD encoder welding triangle corners into compressed GPU-ready vertex buffers
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Describes the attributes of a vertex, their storage format and the stream they are stored in
+	// Attributes are packed in declaration order within their stream, so a single stream gives an interleaved buffer
+	//	and one stream per attribute gives planar buffers.
+	//
+	// Every semantic only supports the formats that make sense for its data (cf. IsSupported()) :
+	//	_ POSITION	FLOAT3, HALF4 (w = 1)
+	//	_ NORMAL	FLOAT3, OCTAHEDRAL16, UNORM10_10_10_2
+	//	_ TANGENT	FLOAT4, UNORM10_10_10_2 (w is the handedness of the tangent space, stored in the 2 bits of the alpha channel)
+	//	_ BINORMAL	FLOAT3, OCTAHEDRAL16, UNORM10_10_10_2
+	//	_ UV		FLOAT2, HALF2, UNORM16_2 (clamped to [0,1])
+	//	_ COLOR		FLOAT4, HALF4, UNORM8_4 (clamped to [0,1])
+	//
+	// Half formats clamp their components to the largest half (+/-65504) instead of overflowing into infinities, the clamped
+	//	corners being counted in the encoder's AttributeError.
+	//
+	// Direction formats (octahedral & 10:10:10:2) store normalized vectors: a shader decodes UNORM10_10_10_2 with v*2-1
+	//	and OCTAHEDRAL16 (2 snorm16) by unfolding the octahedron, both then renormalize.
+	//
+	class	VertexLayout
+	{
+	public:		// NESTED TYPES
+
+		enum	SEMANTIC
+		{
+			SEMANTIC_POSITION,
+			SEMANTIC_NORMAL,
+			SEMANTIC_TANGENT,
+			SEMANTIC_BINORMAL,
+			SEMANTIC_UV,
+			SEMANTIC_COLOR,
+			SEMANTICS_COUNT,
+		};
+
+		enum	FORMAT
+		{
+			FORMAT_FLOAT2,
+			FORMAT_FLOAT3,
+			FORMAT_FLOAT4,
+			FORMAT_HALF2,
+			FORMAT_HALF4,
+			FORMAT_UNORM16_2,
+			FORMAT_UNORM8_4,
+			FORMAT_OCTAHEDRAL16,		// 2 snorm16, the unit vector projected on the octahedron then unfolded onto the z=0 plane
+			FORMAT_UNORM10_10_10_2,
+			FORMATS_COUNT,
+		};
+
+		struct	Attribute
+		{
+			SEMANTIC	Semantic;
+			int			SemanticIndex;	// The index of the layer element (e.g. the UV set)
+			FORMAT		Format;
+			int			Stream;
+			int			Offset;			// Offset of the attribute within a vertex of its stream (in bytes)
+		};
+
+		static const int	MAX_ATTRIBUTES = 16;
+		static const int	MAX_STREAMS = 4;
+
+	protected:	// FIELDS
+
+		int			m_AttributesCount;
+		Attribute	m_pAttributes[MAX_ATTRIBUTES];
+		int			m_pStrides[MAX_STREAMS];
+		int			m_StreamsCount;
+
+	public:		// PROPERTIES
+
+		int					GetAttributesCount() const					{ return m_AttributesCount; }
+		const Attribute&	GetAttribute( int _AttributeIndex ) const	{ return m_pAttributes[_AttributeIndex]; }
+		int					GetStreamsCount() const						{ return m_StreamsCount; }
+		int					GetStride( int _StreamIndex ) const			{ return m_pStrides[_StreamIndex]; }
+
+		// Gets the size of a vertex in all the streams (in bytes)
+		int					GetVertexSize() const;
+
+	public:		// METHODS
+
+		VertexLayout();
+
+		// Appends an attribute at the end of its stream
+		// Returns false if the format is not supported for the semantic, or if there are too many attributes or streams
+		bool		AddAttribute( SEMANTIC _Semantic, int _SemanticIndex, FORMAT _Format, int _Stream );
+
+		// Gets the size of an attribute of the given format (in bytes)
+		static int	GetFormatSize( FORMAT _Format );
+
+		// Gets the amount of floats the encoder expects per corner for a semantic
+		//	(3 for positions, normals & binormals, 4 for tangents (w = handedness) & colors, 2 for UVs)
+		static int	GetSourceComponentsCount( SEMANTIC _Semantic );
+
+		static bool	IsSupported( SEMANTIC _Semantic, FORMAT _Format );
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Encodes triangle corners into the attribute formats of a layout, welds identical encoded vertices and builds
+	//	the vertex streams & the index list
+	// Corners are encoded 4 at a time with SSE2, then welded by hashing their encoded bytes so corners only differing below
+	//	the precision of the formats end up in the same vertex. Vertices are stored in the order they're first used, which
+	//	keeps the order of a vertex cache optimized triangle list.
+	//
+	// The encoding error of each attribute is measured by decoding every corner back, direction formats being compared with
+	//	the normalized source vectors.
+	//
+	class	VertexEncoder
+	{
+	public:		// NESTED TYPES
+
+		struct	AttributeError
+		{
+			float	MaxError;		// The largest absolute difference of a component, over all the corners
+			float	RMSError;		// The root mean square of the component differences
+			int		OverflowsCount;	// The amount of corners with a component out of the range of a half format (i.e. clamped)
+		};
+
+	protected:	// FIELDS
+
+		VertexLayout		m_Layout;
+		int					m_pStreamOffsets[VertexLayout::MAX_STREAMS];	// Offset of each stream in an encoded corner
+
+		int					m_CornersCount;
+		int					m_VerticesCount;
+		unsigned char*		m_ppStreams[VertexLayout::MAX_STREAMS];
+		unsigned int*		m_pIndices;
+		AttributeError		m_pErrors[VertexLayout::MAX_ATTRIBUTES];
+
+	public:		// PROPERTIES
+
+		const VertexLayout&		GetLayout() const							{ return m_Layout; }
+		int						GetVerticesCount() const					{ return m_VerticesCount; }
+		int						GetIndicesCount() const						{ return m_CornersCount; }
+
+		// Indices are 16-bit whenever the amount of vertices allows it
+		int						GetIndexSize() const						{ return m_VerticesCount <= 65536 ? 2 : 4; }
+
+		const unsigned char*	GetStream( int _StreamIndex ) const			{ return m_ppStreams[_StreamIndex]; }
+		const AttributeError&	GetError( int _AttributeIndex ) const		{ return m_pErrors[_AttributeIndex]; }
+
+	public:		// METHODS
+
+		VertexEncoder( const VertexLayout& _Layout );
+		~VertexEncoder();
+
+		// Encodes & welds the corners of a triangle list
+		// _ppSources, one array per layout attribute holding GetSourceComponentsCount() floats per corner, or NULL to use
+		//	default values (0, except for colors which default to white and tangents whose handedness defaults to +1)
+		void	Encode( const float* const* _ppSources, int _CornersCount );
+
+		// Copies the indices as GetIndexSize() bytes integers
+		void	GetIndices( void* _pIndices ) const;
+
+		// Encodes an array of source values into an attribute format (values are written every _TargetStride bytes)
+		static void	EncodeAttribute( VertexLayout::SEMANTIC _Semantic, VertexLayout::FORMAT _Format, const float* _pSource, int _Count, unsigned char* _pTarget, int _TargetStride );
+
+		// Decodes a single value back into GetSourceComponentsCount() floats (directions are renormalized)
+		static void	DecodeAttribute( VertexLayout::SEMANTIC _Semantic, VertexLayout::FORMAT _Format, const unsigned char* _pSource, float* _pValue );
+
+	protected:
+
+		void	Release();
+		void	MeasureErrors( const float* const* _ppSources, const unsigned char* _pCorners, int _CornerSize );
+
+	private:
+		VertexEncoder( const VertexEncoder& );
+		VertexEncoder&	operator=( const VertexEncoder& );
+	};
+}
@@ -0,0 +1,145 @@
+// Native transform of triangle corner attributes
+// Transforms positions, normals & tangents by an affine matrix with SSE and restores the winding of mirrored triangles
+//
+#ifdef _MANAGED
+#pragma unmanaged
+#endif
+
+#include <math.h>
+#include <string.h>
+#include <emmintrin.h>
+
+#include "VertexTransform.h"
+
+using namespace	FBXImporter;
+
+namespace
+{
+	// Transforms a direction by the rows of a 3x3 matrix (stored as 3 rows of 4 floats) then renormalizes it
+	inline void	TransformDirection( const __m128* _pRows, float* _pDirection )
+	{
+		__m128	Result = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( _pDirection[0] ), _pRows[0] ), _mm_mul_ps( _mm_set1_ps( _pDirection[1] ), _pRows[1] ) ), _mm_mul_ps( _mm_set1_ps( _pDirection[2] ), _pRows[2] ) );
+
+		float	pResult[4];
+		_mm_storeu_ps( pResult, Result );
+
+		float	SquareLength = pResult[0]*pResult[0] + pResult[1]*pResult[1] + pResult[2]*pResult[2];
+		float	InvLength = SquareLength > 1e-30f ? 1.0f / sqrtf( SquareLength ) : 0.0f;
+		_pDirection[0] = InvLength * pResult[0];
+		_pDirection[1] = InvLength * pResult[1];
+		_pDirection[2] = InvLength * pResult[2];
+	}
+}
+
+VertexTransform::VertexTransform( const float* _pMatrix )
+{
+	memcpy( m_pMatrix, _pMatrix, 16*sizeof(float) );
+
+	// With row vectors, the inverse transpose of the 3x3 matrix is the matrix of the cofactors (r1 x r2, r2 x r0, r0 x r1) divided by the determinant
+	// Normals are renormalized afterward so only the sign of the determinant matters
+	const float*	pRow0 = m_pMatrix + 0;
+	const float*	pRow1 = m_pMatrix + 4;
+	const float*	pRow2 = m_pMatrix + 8;
+	const float*	ppRows[3][2] = { { pRow1, pRow2 }, { pRow2, pRow0 }, { pRow0, pRow1 } };
+	for ( int RowIndex=0; RowIndex < 3; RowIndex++ )
+	{
+		const float*	pA = ppRows[RowIndex][0];
+		const float*	pB = ppRows[RowIndex][1];
+		m_pNormalMatrix[3*RowIndex+0] = pA[1] * pB[2] - pA[2] * pB[1];
+		m_pNormalMatrix[3*RowIndex+1] = pA[2] * pB[0] - pA[0] * pB[2];
+		m_pNormalMatrix[3*RowIndex+2] = pA[0] * pB[1] - pA[1] * pB[0];
+	}
+
+	float	Determinant = pRow0[0] * m_pNormalMatrix[0] + pRow0[1] * m_pNormalMatrix[1] + pRow0[2] * m_pNormalMatrix[2];
+	m_bMirrored = Determinant < 0.0f;
+	if ( m_bMirrored )
+		for ( int Index=0; Index < 9; Index++ )
+			m_pNormalMatrix[Index] = -m_pNormalMatrix[Index];
+}
+
+void	VertexTransform::TransformPositions( float* _pPositions, int _Count, float* _pMin, float* _pMax ) const
+{
+	__m128	Row0 = _mm_loadu_ps( m_pMatrix+0 );
+	__m128	Row1 = _mm_loadu_ps( m_pMatrix+4 );
+	__m128	Row2 = _mm_loadu_ps( m_pMatrix+8 );
+	__m128	Row3 = _mm_loadu_ps( m_pMatrix+12 );
+
+	float	pMin[4] = { _pMin[0], _pMin[1], _pMin[2], 0.0f };
+	float	pMax[4] = { _pMax[0], _pMax[1], _pMax[2], 0.0f };
+	__m128	Min = _mm_loadu_ps( pMin );
+	__m128	Max = _mm_loadu_ps( pMax );
+
+	for ( int Index=0; Index < _Count; Index++, _pPositions+=3 )
+	{
+		__m128	Result = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( _pPositions[0] ), Row0 ), _mm_mul_ps( _mm_set1_ps( _pPositions[1] ), Row1 ) ), _mm_add_ps( _mm_mul_ps( _mm_set1_ps( _pPositions[2] ), Row2 ), Row3 ) );
+		Min = _mm_min_ps( Min, Result );
+		Max = _mm_max_ps( Max, Result );
+
+		float	pResult[4];
+		_mm_storeu_ps( pResult, Result );
+		_pPositions[0] = pResult[0];
+		_pPositions[1] = pResult[1];
+		_pPositions[2] = pResult[2];
+	}
+
+	_mm_storeu_ps( pMin, Min );
+	_mm_storeu_ps( pMax, Max );
+	memcpy( _pMin, pMin, 3*sizeof(float) );
+	memcpy( _pMax, pMax, 3*sizeof(float) );
+}
+
+void	VertexTransform::TransformNormals( float* _pNormals, int _Count ) const
+{
+	__m128	pRows[3];
+	for ( int RowIndex=0; RowIndex < 3; RowIndex++ )
+	{
+		float	pRow[4] = { m_pNormalMatrix[3*RowIndex+0], m_pNormalMatrix[3*RowIndex+1], m_pNormalMatrix[3*RowIndex+2], 0.0f };
+		pRows[RowIndex] = _mm_loadu_ps( pRow );
+	}
+
+	for ( int Index=0; Index < _Count; Index++, _pNormals+=3 )
+		TransformDirection( pRows, _pNormals );
+}
+
+void	VertexTransform::TransformTangents( float* _pTangents, int _Count, int _ComponentsCount ) const
+{
+	__m128	pRows[3];
+	for ( int RowIndex=0; RowIndex < 3; RowIndex++ )
+		pRows[RowIndex] = _mm_loadu_ps( m_pMatrix + 4*RowIndex );
+
+	for ( int Index=0; Index < _Count; Index++, _pTangents+=_ComponentsCount )
+	{
+		TransformDirection( pRows, _pTangents );
+		if ( _ComponentsCount > 3 && m_bMirrored )
+			_pTangents[3] = -_pTangents[3];
+	}
+}
+
+void	VertexTransform::Multiply( const float* _pA, const float* _pB, float* _pResult )
+{
+	__m128	B0 = _mm_loadu_ps( _pB+0 );
+	__m128	B1 = _mm_loadu_ps( _pB+4 );
+	__m128	B2 = _mm_loadu_ps( _pB+8 );
+	__m128	B3 = _mm_loadu_ps( _pB+12 );
+	for ( int RowIndex=0; RowIndex < 4; RowIndex++ )
+	{
+		const float*	pRow = _pA + 4*RowIndex;
+		__m128	Row = _mm_mul_ps( _mm_set1_ps( pRow[0] ), B0 );
+				Row = _mm_add_ps( Row, _mm_mul_ps( _mm_set1_ps( pRow[1] ), B1 ) );
+				Row = _mm_add_ps( Row, _mm_mul_ps( _mm_set1_ps( pRow[2] ), B2 ) );
+				Row = _mm_add_ps( Row, _mm_mul_ps( _mm_set1_ps( pRow[3] ), B3 ) );
+		_mm_storeu_ps( _pResult + 4*RowIndex, Row );
+	}
+}
+
+void	VertexTransform::FlipWinding( float* _pValues, int _TrianglesCount, int _ComponentsCount )
+{
+	float	pTemp[4];
+	int		Size = _ComponentsCount * sizeof(float);
+	for ( int TriangleIndex=0; TriangleIndex < _TrianglesCount; TriangleIndex++, _pValues+=3*_ComponentsCount )
+	{
+		memcpy( pTemp, _pValues + _ComponentsCount, Size );
+		memcpy( _pValues + _ComponentsCount, _pValues + 2*_ComponentsCount, Size );
+		memcpy( _pValues + 2*_ComponentsCount, pTemp, Size );
+	}
+}
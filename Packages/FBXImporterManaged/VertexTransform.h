@@ -0,0 +1,50 @@
+// Contains the native transform of triangle corner attributes used to pre-transform static batches
+//
+#pragma once
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Transforms the attributes of triangle corners, as gathered for the VertexEncoder, by an affine matrix
+	// Matrices are 16 floats in row-vector convention (i.e. translation in the 4th row), like the TransformHierarchy's.
+	//
+	//	_ Positions are transformed by the full matrix
+	//	_ Normals are transformed by the inverse transpose of the upper 3x3 matrix so they stay orthogonal to the surface
+	//	_ Tangents & binormals are transformed by the upper 3x3 matrix
+	//	_ Directions are renormalized (zero directions stay zero) and the handedness of tangents is flipped by mirroring matrices
+	//
+	// A mirroring matrix (negative determinant) also flips the winding of the triangles, which must be restored with FlipWinding().
+	//
+	class	VertexTransform
+	{
+	protected:	// FIELDS
+
+		float	m_pMatrix[16];
+		float	m_pNormalMatrix[9];		// The cofactors of the upper 3x3 matrix, signed by its determinant
+		bool	m_bMirrored;
+
+	public:		// PROPERTIES
+
+		const float*	GetMatrix() const		{ return m_pMatrix; }
+		bool			IsMirrored() const		{ return m_bMirrored; }
+
+	public:		// METHODS
+
+		VertexTransform( const float* _pMatrix );
+
+		// Transforms 3 floats per position and grows the given bounds (Min then Max, 3 floats each) with the results
+		void	TransformPositions( float* _pPositions, int _Count, float* _pMin, float* _pMax ) const;
+
+		// Transforms 3 floats per normal
+		void	TransformNormals( float* _pNormals, int _Count ) const;
+
+		// Transforms _ComponentsCount floats per tangent or binormal (3, or 4 for tangents whose w is the handedness)
+		void	TransformTangents( float* _pTangents, int _Count, int _ComponentsCount ) const;
+
+		// Multiplies 2 matrices: Result = A * B (i.e. A is applied first), the result may not alias the operands
+		static void	Multiply( const float* _pA, const float* _pB, float* _pResult );
+
+		// Swaps the 2nd & 3rd corners of each triangle of an attribute (_ComponentsCount floats per corner)
+		static void	FlipWinding( float* _pValues, int _TrianglesCount, int _ComponentsCount );
+	};
+}
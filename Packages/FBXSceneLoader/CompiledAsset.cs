@@ -0,0 +1,514 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+
+namespace Nuaj.Cirrus.FBX
+{
+	/// <summary>
+	/// A preprocessed scene asset written by the CompiledAssetWriter (usually through the FBXBatchConverter tool)
+	///
+	/// The asset is memory-mapped rather than read: only the small node, mesh, material & animation tables are
+	///  parsed when it is opened, the vertex & index buffers are used right from the mapped view and can be uploaded
+	///  to the GPU as is (they're stored in their final interleaved & compressed layout, see VertexLayout & VertexStride).
+	///
+	/// Use it at startup like this :
+	/// 1) Open the asset (this only maps the file and parses the tables)
+	/// 2) Create the vertex & index buffers from VerticesPointer/VerticesSize & IndicesPointer/IndicesSize
+	/// 3) Dispose of the asset once the buffers are created (the pointers are invalid afterward)
+	/// </summary>
+	/// <remarks>
+	/// File layout (little endian, every section starts on an ALIGNMENT boundary) :
+	///	_ Header : Magic, Version, 16 bytes source hash, sections count, reserved
+	///	_ Section table : Type, Stride, Offset, Size for each section
+	///	_ Sections : NODES, MESHES, MATERIALS, ANIMATIONS & VERTEX_LAYOUT tables then the VERTICES & INDICES buffers
+	///	The stride of the VERTICES section is the size of a vertex, the stride of the INDICES section is 2 when every mesh
+	///	 has less than 65536 vertices and 4 otherwise.
+	/// </remarks>
+	public class	CompiledAsset : IDisposable
+	{
+		#region CONSTANTS
+
+		public const uint	MAGIC = 0x4153434E;		// "NCSA"
+		public const int	VERSION = 2;
+		public const int	ALIGNMENT = 16;
+		public const int	HEADER_SIZE = 32;
+		public const int	SECTION_ENTRY_SIZE = 24;
+		public const int	SOURCE_HASH_SIZE = 16;
+
+		/// <summary>
+		/// The amount of floats stored per animated node and per frame : Px, Py, Pz, Rx, Ry, Rz, Sx, Sy, Sz
+		/// </summary>
+		public const int	ANIMATION_VALUES_PER_NODE = 9;
+
+		#endregion
+
+		#region NESTED TYPES
+
+		public enum	SECTION_TYPE
+		{
+			NODES = 1,
+			MESHES,
+			MATERIALS,
+			ANIMATIONS,
+			VERTICES,
+			INDICES,
+			VERTEX_LAYOUT,
+		}
+
+		/// <summary>
+		/// The semantics of the vertex attributes (same values as FBXImporter.VertexBufferLayout.SEMANTIC)
+		/// </summary>
+		public enum	VERTEX_SEMANTIC
+		{
+			POSITION,
+			NORMAL,
+			TANGENT,
+			BINORMAL,
+			UV,
+			COLOR,
+		}
+
+		/// <summary>
+		/// The formats of the vertex attributes (same values as FBXImporter.VertexBufferLayout.FORMAT)
+		/// </summary>
+		public enum	VERTEX_FORMAT
+		{
+			FLOAT2,
+			FLOAT3,
+			FLOAT4,
+			HALF2,
+			HALF4,
+			UNORM16_2,
+			UNORM8_4,
+			OCTAHEDRAL16,		// 2 snorm16 (the unit vector projected on the octahedron, the lower half being folded over the upper half)
+			UNORM10_10_10_2,	// Decoded with v*2-1, the 2 bits of alpha holding the handedness of tangents (0 = -1, 3 = +1)
+		}
+
+		public enum	NODE_TYPE
+		{
+			NODE,
+			MESH,
+			CAMERA,
+			LIGHT,
+		}
+
+		public struct	Section
+		{
+			public SECTION_TYPE	Type;
+			public int			Stride;		// The size of an element for buffer sections, 0 for tables
+			public long			Offset;		// The offset of the section from the start of the file
+			public long			Size;
+		}
+
+		[System.Diagnostics.DebuggerDisplay( "Name={Name} Type={Type} Parent={ParentIndex}" )]
+		public class	Node
+		{
+			public string			Name;
+			public int				ParentIndex = -1;
+			public NODE_TYPE		Type = NODE_TYPE.NODE;
+			public SharpDX.Matrix	Local2Parent = SharpDX.Matrix.Identity;
+			public bool				Visible = true;
+
+			// Mesh nodes only
+			public int				MeshIndex = -1;					// Instances share the mesh of their master
+			public SharpDX.Matrix	Pivot = SharpDX.Matrix.Identity;	// The geometric transform applied to the mesh only (i.e. not inherited by children)
+		}
+
+		[System.Diagnostics.DebuggerDisplay( "{Semantic}{SemanticIndex} {Format} Offset={Offset}" )]
+		public class	VertexAttribute
+		{
+			public VERTEX_SEMANTIC		Semantic;
+			public int					SemanticIndex;	// The UV set, color set, etc.
+			public VERTEX_FORMAT		Format;
+			public int					Offset;			// The offset of the attribute within a vertex (in bytes)
+		}
+
+		[System.Diagnostics.DebuggerDisplay( "Material={MaterialIndex} Start={IndexStart} Count={IndexCount}" )]
+		public class	SubMesh
+		{
+			public int				MaterialIndex;
+			public int				IndexStart;		// The first index of the sub-mesh, relative to the mesh's IndexOffset
+			public int				IndexCount;
+		}
+
+		[System.Diagnostics.DebuggerDisplay( "Name={Name} Vertices={VerticesCount} Indices={IndicesCount}" )]
+		public class	Mesh
+		{
+			public string				Name;
+			public SharpDX.BoundingBox	BBox;
+			public int					VertexOffset;	// The first vertex of the mesh in the vertex buffer (indices are relative to that vertex)
+			public int					VerticesCount;
+			public int					IndexOffset;	// The first index of the mesh in the index buffer
+			public int					IndicesCount;
+			public SubMesh[]			SubMeshes;
+		}
+
+		[System.Diagnostics.DebuggerDisplay( "Name={Name} Type={Type}" )]
+		public class	Material
+		{
+			public string				Name;
+			public string				Type;			// "Phong", "Lambert" or "Default"
+			public SharpDX.Vector3		DiffuseColor = SharpDX.Vector3.One;
+			public float				DiffuseFactor = 1.0f;
+			public SharpDX.Vector3		EmissiveColor = SharpDX.Vector3.Zero;
+			public float				EmissiveFactor = 0.0f;
+			public SharpDX.Vector3		SpecularColor = SharpDX.Vector3.Zero;
+			public float				SpecularFactor = 0.0f;
+			public float				Shininess = 0.0f;
+			public float				Opacity = 1.0f;
+			public Dictionary<string,string>	Textures = new Dictionary<string,string>();	// Material property name => relative texture file name
+		}
+
+		#endregion
+
+		#region FIELDS
+
+		protected FileInfo					m_FileName = null;
+		protected MemoryMappedFile			m_File = null;
+		protected MemoryMappedViewAccessor	m_View = null;
+		protected IntPtr					m_pBase = IntPtr.Zero;
+
+		protected byte[]					m_SourceHash = null;
+		protected Dictionary<SECTION_TYPE,Section>	m_Sections = new Dictionary<SECTION_TYPE,Section>();
+
+		protected Node[]					m_Nodes = new Node[0];
+		protected Mesh[]					m_Meshes = new Mesh[0];
+		protected Material[]				m_Materials = new Material[0];
+		protected VertexAttribute[]			m_VertexLayout = new VertexAttribute[0];
+
+		// Animation (sampled at a fixed rate for all the animated nodes)
+		protected float						m_AnimationSampleRate = 0.0f;
+		protected int						m_AnimationFramesCount = 0;
+		protected int[]						m_AnimatedNodes = new int[0];
+		protected long						m_AnimationValuesOffset = 0;
+
+		#endregion
+
+		#region PROPERTIES
+
+		public FileInfo		FileName			{ get { return m_FileName; } }
+
+		/// <summary>
+		/// Gets the hash of the source file & conversion settings the asset was built from
+		/// </summary>
+		public byte[]		SourceHash			{ get { return m_SourceHash; } }
+
+		public Node[]		Nodes				{ get { return m_Nodes; } }
+		public Mesh[]		Meshes				{ get { return m_Meshes; } }
+		public Material[]	Materials			{ get { return m_Materials; } }
+
+		/// <summary>
+		/// Gets the attributes of an interleaved vertex
+		/// </summary>
+		public VertexAttribute[]	VertexLayout	{ get { return m_VertexLayout; } }
+
+		/// <summary>
+		/// Gets the pointer to the interleaved vertices in the mapped view (valid until the asset is disposed of)
+		/// </summary>
+		public IntPtr		VerticesPointer		{ get { return GetSectionPointer( SECTION_TYPE.VERTICES ); } }
+		public long			VerticesSize		{ get { return GetSectionSize( SECTION_TYPE.VERTICES ); } }
+		public int			VertexStride		{ get { return GetSectionStride( SECTION_TYPE.VERTICES ); } }
+		public int			VerticesCount		{ get { return VertexStride > 0 ? (int) (VerticesSize / VertexStride) : 0; } }
+
+		/// <summary>
+		/// Gets the pointer to the 16-bits or 32-bits indices (see IndexStride) in the mapped view (valid until the asset is disposed of)
+		/// </summary>
+		public IntPtr		IndicesPointer		{ get { return GetSectionPointer( SECTION_TYPE.INDICES ); } }
+		public long			IndicesSize			{ get { return GetSectionSize( SECTION_TYPE.INDICES ); } }
+		public int			IndexStride			{ get { return GetSectionStride( SECTION_TYPE.INDICES ); } }
+		public int			IndicesCount		{ get { return IndexStride > 0 ? (int) (IndicesSize / IndexStride) : 0; } }
+
+		public float		AnimationSampleRate		{ get { return m_AnimationSampleRate; } }
+		public int			AnimationFramesCount	{ get { return m_AnimationFramesCount; } }
+
+		/// <summary>
+		/// Gets the indices of the animated nodes, in the order their values are stored in each frame
+		/// </summary>
+		public int[]		AnimatedNodes		{ get { return m_AnimatedNodes; } }
+
+		#endregion
+
+		#region METHODS
+
+		/// <summary>
+		/// Maps an asset and parses its tables
+		/// </summary>
+		/// <param name="_FileName"></param>
+		public	CompiledAsset( FileInfo _FileName )
+		{
+			if ( _FileName == null || !_FileName.Exists )
+				throw new Exception( "Compiled asset \"" + _FileName + "\" does not exist !" );
+
+			m_FileName = _FileName;
+			try
+			{
+				m_File = MemoryMappedFile.CreateFromFile( _FileName.FullName, FileMode.Open, null, 0, MemoryMappedFileAccess.Read );
+				m_View = m_File.CreateViewAccessor( 0, 0, MemoryMappedFileAccess.Read );
+				m_pBase = m_View.SafeMemoryMappedViewHandle.DangerousGetHandle();
+
+				ReadHeader();
+				ReadTables();
+			}
+			catch ( Exception _e )
+			{
+				Dispose();
+				throw new Exception( "Failed to open compiled asset \"" + _FileName.FullName + "\" !", _e );
+			}
+		}
+
+		/// <summary>
+		/// Reads the values of all the animated nodes for the given frame
+		/// </summary>
+		/// <param name="_FrameIndex"></param>
+		/// <param name="_Values">An array of at least ANIMATION_VALUES_PER_NODE * AnimatedNodes.Length floats</param>
+		public void		ReadAnimationFrame( int _FrameIndex, float[] _Values )
+		{
+			if ( _FrameIndex < 0 || _FrameIndex >= m_AnimationFramesCount )
+				throw new Exception( "Animation frame index out of range !" );
+
+			int		ValuesCount = ANIMATION_VALUES_PER_NODE * m_AnimatedNodes.Length;
+			long	Offset = m_AnimationValuesOffset + (long) _FrameIndex * ValuesCount * sizeof(float);
+			m_View.ReadArray<float>( Offset, _Values, 0, ValuesCount );
+		}
+
+		/// <summary>
+		/// Gets the pointer to the start of a section in the mapped view (IntPtr.Zero if the asset has no such section)
+		/// </summary>
+		public IntPtr	GetSectionPointer( SECTION_TYPE _Type )
+		{
+			Section	S;
+			if ( !m_Sections.TryGetValue( _Type, out S ) )
+				return IntPtr.Zero;
+
+			return new IntPtr( m_pBase.ToInt64() + S.Offset );
+		}
+
+		public long		GetSectionSize( SECTION_TYPE _Type )
+		{
+			Section	S;
+			return m_Sections.TryGetValue( _Type, out S ) ? S.Size : 0;
+		}
+
+		public int		GetSectionStride( SECTION_TYPE _Type )
+		{
+			Section	S;
+			return m_Sections.TryGetValue( _Type, out S ) ? S.Stride : 0;
+		}
+
+		/// <summary>
+		/// Reads the source hash of an existing asset without mapping it
+		/// </summary>
+		/// <param name="_FileName"></param>
+		/// <returns>The hash or null if the file doesn't exist or is not a valid asset of the current version</returns>
+		public static byte[]	ReadSourceHash( FileInfo _FileName )
+		{
+			if ( !_FileName.Exists || _FileName.Length < HEADER_SIZE )
+				return null;
+
+			try
+			{
+				using ( FileStream S = _FileName.OpenRead() )
+					using ( BinaryReader R = new BinaryReader( S ) )
+					{
+						if ( R.ReadUInt32() != MAGIC || R.ReadInt32() != VERSION )
+							return null;
+
+						return R.ReadBytes( SOURCE_HASH_SIZE );
+					}
+			}
+			catch ( IOException )
+			{
+				return null;
+			}
+		}
+
+		protected void	ReadHeader()
+		{
+			if ( m_View.Capacity < HEADER_SIZE )
+				throw new Exception( "File is too small !" );
+			if ( m_View.ReadUInt32( 0 ) != MAGIC )
+				throw new Exception( "Not a compiled asset !" );
+			int	Version = m_View.ReadInt32( 4 );
+			if ( Version != VERSION )
+				throw new Exception( "Unsupported version " + Version + " (expected " + VERSION + "), the asset must be converted again !" );
+
+			m_SourceHash = new byte[SOURCE_HASH_SIZE];
+			m_View.ReadArray<byte>( 8, m_SourceHash, 0, SOURCE_HASH_SIZE );
+
+			int	SectionsCount = m_View.ReadInt32( 8 + SOURCE_HASH_SIZE );
+			for ( int SectionIndex=0; SectionIndex < SectionsCount; SectionIndex++ )
+			{
+				long	EntryOffset = HEADER_SIZE + SectionIndex * SECTION_ENTRY_SIZE;
+
+				Section	S = new Section();
+				S.Type = (SECTION_TYPE) m_View.ReadInt32( EntryOffset + 0 );
+				S.Stride = m_View.ReadInt32( EntryOffset + 4 );
+				S.Offset = m_View.ReadInt64( EntryOffset + 8 );
+				S.Size = m_View.ReadInt64( EntryOffset + 16 );
+				if ( S.Offset < 0 || S.Size < 0 || S.Offset + S.Size > m_View.Capacity )
+					throw new Exception( "Section " + S.Type + " lies outside of the file !" );
+
+				m_Sections[S.Type] = S;
+			}
+		}
+
+		protected void	ReadTables()
+		{
+			using ( BinaryReader R = OpenSection( SECTION_TYPE.NODES ) )
+				if ( R != null )
+				{
+					m_Nodes = new Node[R.ReadInt32()];
+					for ( int NodeIndex=0; NodeIndex < m_Nodes.Length; NodeIndex++ )
+					{
+						Node	N = new Node();
+						N.Name = R.ReadString();
+						N.ParentIndex = R.ReadInt32();
+						N.Type = (NODE_TYPE) R.ReadByte();
+						N.Visible = R.ReadBoolean();
+						N.Local2Parent = ReadMatrix( R );
+						if ( N.Type == NODE_TYPE.MESH )
+						{
+							N.MeshIndex = R.ReadInt32();
+							N.Pivot = ReadMatrix( R );
+						}
+						m_Nodes[NodeIndex] = N;
+					}
+				}
+
+			using ( BinaryReader R = OpenSection( SECTION_TYPE.MESHES ) )
+				if ( R != null )
+				{
+					m_Meshes = new Mesh[R.ReadInt32()];
+					for ( int MeshIndex=0; MeshIndex < m_Meshes.Length; MeshIndex++ )
+					{
+						Mesh	M = new Mesh();
+						M.Name = R.ReadString();
+						M.BBox = new SharpDX.BoundingBox( ReadVector3( R ), ReadVector3( R ) );
+						M.VertexOffset = R.ReadInt32();
+						M.VerticesCount = R.ReadInt32();
+						M.IndexOffset = R.ReadInt32();
+						M.IndicesCount = R.ReadInt32();
+						M.SubMeshes = new SubMesh[R.ReadInt32()];
+						for ( int SubMeshIndex=0; SubMeshIndex < M.SubMeshes.Length; SubMeshIndex++ )
+						{
+							SubMesh	SM = new SubMesh();
+							SM.MaterialIndex = R.ReadInt32();
+							SM.IndexStart = R.ReadInt32();
+							SM.IndexCount = R.ReadInt32();
+							M.SubMeshes[SubMeshIndex] = SM;
+						}
+						m_Meshes[MeshIndex] = M;
+					}
+				}
+
+			using ( BinaryReader R = OpenSection( SECTION_TYPE.MATERIALS ) )
+				if ( R != null )
+				{
+					m_Materials = new Material[R.ReadInt32()];
+					for ( int MaterialIndex=0; MaterialIndex < m_Materials.Length; MaterialIndex++ )
+					{
+						Material	M = new Material();
+						M.Name = R.ReadString();
+						M.Type = R.ReadString();
+						M.DiffuseColor = ReadVector3( R );
+						M.DiffuseFactor = R.ReadSingle();
+						M.EmissiveColor = ReadVector3( R );
+						M.EmissiveFactor = R.ReadSingle();
+						M.SpecularColor = ReadVector3( R );
+						M.SpecularFactor = R.ReadSingle();
+						M.Shininess = R.ReadSingle();
+						M.Opacity = R.ReadSingle();
+						int	TexturesCount = R.ReadInt32();
+						for ( int TextureIndex=0; TextureIndex < TexturesCount; TextureIndex++ )
+						{
+							string	PropertyName = R.ReadString();
+							M.Textures[PropertyName] = R.ReadString();
+						}
+						m_Materials[MaterialIndex] = M;
+					}
+				}
+
+			using ( BinaryReader R = OpenSection( SECTION_TYPE.VERTEX_LAYOUT ) )
+				if ( R != null )
+				{
+					m_VertexLayout = new VertexAttribute[R.ReadInt32()];
+					for ( int AttributeIndex=0; AttributeIndex < m_VertexLayout.Length; AttributeIndex++ )
+					{
+						VertexAttribute	A = new VertexAttribute();
+						A.Semantic = (VERTEX_SEMANTIC) R.ReadInt32();
+						A.SemanticIndex = R.ReadInt32();
+						A.Format = (VERTEX_FORMAT) R.ReadInt32();
+						A.Offset = R.ReadInt32();
+						m_VertexLayout[AttributeIndex] = A;
+					}
+				}
+
+			Section	AnimationSection;
+			if ( m_Sections.TryGetValue( SECTION_TYPE.ANIMATIONS, out AnimationSection ) )
+				using ( BinaryReader R = OpenSection( SECTION_TYPE.ANIMATIONS ) )
+				{
+					m_AnimationSampleRate = R.ReadSingle();
+					m_AnimationFramesCount = R.ReadInt32();
+					m_AnimatedNodes = new int[R.ReadInt32()];
+					for ( int AnimatedNodeIndex=0; AnimatedNodeIndex < m_AnimatedNodes.Length; AnimatedNodeIndex++ )
+						m_AnimatedNodes[AnimatedNodeIndex] = R.ReadInt32();
+
+					// Frames follow, aligned
+					long	ValuesOffset = AlignOffset( R.BaseStream.Position );
+					m_AnimationValuesOffset = AnimationSection.Offset + ValuesOffset;
+
+					long	ExpectedSize = (long) m_AnimationFramesCount * m_AnimatedNodes.Length * ANIMATION_VALUES_PER_NODE * sizeof(float);
+					if ( ValuesOffset + ExpectedSize > AnimationSection.Size )
+						throw new Exception( "Truncated animation section !" );
+				}
+		}
+
+		protected BinaryReader	OpenSection( SECTION_TYPE _Type )
+		{
+			Section	S;
+			if ( !m_Sections.TryGetValue( _Type, out S ) )
+				return null;
+
+			return new BinaryReader( m_File.CreateViewStream( S.Offset, S.Size, MemoryMappedFileAccess.Read ), Encoding.UTF8 );
+		}
+
+		protected static SharpDX.Vector3	ReadVector3( BinaryReader _Reader )
+		{
+			return new SharpDX.Vector3( _Reader.ReadSingle(), _Reader.ReadSingle(), _Reader.ReadSingle() );
+		}
+
+		protected static SharpDX.Matrix		ReadMatrix( BinaryReader _Reader )
+		{
+			SharpDX.Matrix	Result = new SharpDX.Matrix();
+			Result.Row1 = new SharpDX.Vector4( _Reader.ReadSingle(), _Reader.ReadSingle(), _Reader.ReadSingle(), _Reader.ReadSingle() );
+			Result.Row2 = new SharpDX.Vector4( _Reader.ReadSingle(), _Reader.ReadSingle(), _Reader.ReadSingle(), _Reader.ReadSingle() );
+			Result.Row3 = new SharpDX.Vector4( _Reader.ReadSingle(), _Reader.ReadSingle(), _Reader.ReadSingle(), _Reader.ReadSingle() );
+			Result.Row4 = new SharpDX.Vector4( _Reader.ReadSingle(), _Reader.ReadSingle(), _Reader.ReadSingle(), _Reader.ReadSingle() );
+			return Result;
+		}
+
+		public static long	AlignOffset( long _Offset )
+		{
+			return (_Offset + ALIGNMENT - 1) & ~(long) (ALIGNMENT - 1);
+		}
+
+		#region IDisposable Members
+
+		public void Dispose()
+		{
+			m_pBase = IntPtr.Zero;
+			if ( m_View != null )
+				m_View.Dispose();
+			m_View = null;
+			if ( m_File != null )
+				m_File.Dispose();
+			m_File = null;
+		}
+
+		#endregion
+
+		#endregion
+	}
+}
@@ -0,0 +1,517 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using System.IO;
+
+using WMath;
+
+namespace Nuaj.Cirrus.FBX
+{
+	/// <summary>
+	/// Converts a loaded FBX scene into a CompiledAsset
+	///
+	/// Meshes are written from the vertex buffers emitted by the importer (see ImportOptions.EmitVertexBuffers), which are already
+	///  welded, encoded in their final interleaved layout & grouped by material into sub-meshes, all the meshes sharing the same
+	///  vertex & index buffers. Indices are written as 16-bits when every mesh allows it. Instanced meshes (see ImportOptions.DetectInstances)
+	///  share the mesh of their master. Animations are sampled at a fixed rate for all the animated nodes.
+	/// </summary>
+	public class	CompiledAssetWriter
+	{
+		#region FIELDS
+
+		protected float								m_ScaleFactor = 1.0f;
+		protected float								m_AnimationSampleRate = 30.0f;
+
+		protected List<CompiledAsset.Node>			m_Nodes = new List<CompiledAsset.Node>();
+		protected List<CompiledAsset.Mesh>			m_Meshes = new List<CompiledAsset.Mesh>();
+		protected List<CompiledAsset.Material>		m_Materials = new List<CompiledAsset.Material>();
+		protected Dictionary<FBXImporter.Material,int>	m_Material2Index = new Dictionary<FBXImporter.Material,int>();
+		protected Dictionary<FBXImporter.NodeMesh,int>	m_FBXMesh2Index = new Dictionary<FBXImporter.NodeMesh,int>();
+		protected Dictionary<FBXImporter.Node,int>		m_FBXNode2Index = new Dictionary<FBXImporter.Node,int>();
+
+		protected FBXImporter.VertexBufferLayout	m_VertexLayout = null;
+		protected List<FBXImporter.VertexBuffer>	m_VertexBuffers = new List<FBXImporter.VertexBuffer>();
+		protected MemoryStream						m_Vertices = new MemoryStream();
+		protected int								m_VerticesCount = 0;
+		protected int								m_IndicesCount = 0;
+
+		protected int								m_AnimationFramesCount = 0;
+		protected int[]								m_AnimatedNodes = new int[0];
+		protected float[]							m_AnimationValues = new float[0];
+
+		#endregion
+
+		#region PROPERTIES
+
+		public int		NodesCount				{ get { return m_Nodes.Count; } }
+		public int		MeshesCount				{ get { return m_Meshes.Count; } }
+		public int		MaterialsCount			{ get { return m_Materials.Count; } }
+		public int		VerticesCount			{ get { return m_VerticesCount; } }
+		public int		VertexStride			{ get { return m_VertexLayout != null ? m_VertexLayout.VertexSize : 0; } }
+		public int		IndexStride				{ get { return m_VertexBuffers.TrueForAll( VB => VB.IndexSize == 2 ) ? 2 : 4; } }
+		public int		TrianglesCount			{ get { return m_IndicesCount / 3; } }
+		public int		AnimatedNodesCount		{ get { return m_AnimatedNodes.Length; } }
+		public int		AnimationFramesCount	{ get { return m_AnimationFramesCount; } }
+
+		#endregion
+
+		#region METHODS
+
+		/// <summary>
+		/// Builds the asset data from a loaded scene (the scene can be disposed of afterward)
+		/// </summary>
+		/// <param name="_Scene">The scene to convert, loaded with ImportOptions.EmitVertexBuffers and a single stream layout whose PositionScale is the scale factor</param>
+		/// <param name="_ScaleFactor">The scale factor to apply to positions & translations (see SceneLoader.Load())</param>
+		/// <param name="_AnimationSampleRate">The amount of animation frames per second (0 to skip animations)</param>
+		public	CompiledAssetWriter( FBXImporter.Scene _Scene, float _ScaleFactor, float _AnimationSampleRate )
+		{
+			m_ScaleFactor = _ScaleFactor;
+			m_AnimationSampleRate = _AnimationSampleRate;
+
+			foreach ( FBXImporter.Material Material in _Scene.Materials )
+				AddMaterial( Material );
+
+			if ( _Scene.RootNode != null )
+				AddNode( _Scene.RootNode, -1 );
+
+			if ( m_AnimationSampleRate > 0.0f )
+				SampleAnimations( _Scene );
+		}
+
+		/// <summary>
+		/// Writes the asset
+		/// The asset is written to a temporary file first then moved in place so a game never maps a partially written asset.
+		/// </summary>
+		/// <param name="_FileName">The target file</param>
+		/// <param name="_SourceHash">The hash of the source file & conversion settings (CompiledAsset.SOURCE_HASH_SIZE bytes)</param>
+		/// <returns>The size of the written file</returns>
+		public long		Write( FileInfo _FileName, byte[] _SourceHash )
+		{
+			if ( _SourceHash == null || _SourceHash.Length != CompiledAsset.SOURCE_HASH_SIZE )
+				throw new Exception( "Invalid source hash !" );
+
+			// Build the sections
+			List<KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]>>	Sections = new List<KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]>>();
+			Sections.Add( new KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]>( CompiledAsset.SECTION_TYPE.NODES, BuildNodesSection() ) );
+			Sections.Add( new KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]>( CompiledAsset.SECTION_TYPE.MESHES, BuildMeshesSection() ) );
+			Sections.Add( new KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]>( CompiledAsset.SECTION_TYPE.MATERIALS, BuildMaterialsSection() ) );
+			Sections.Add( new KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]>( CompiledAsset.SECTION_TYPE.VERTEX_LAYOUT, BuildVertexLayoutSection() ) );
+			if ( m_AnimatedNodes.Length > 0 )
+				Sections.Add( new KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]>( CompiledAsset.SECTION_TYPE.ANIMATIONS, BuildAnimationsSection() ) );
+			Sections.Add( new KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]>( CompiledAsset.SECTION_TYPE.VERTICES, m_Vertices.ToArray() ) );
+			Sections.Add( new KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]>( CompiledAsset.SECTION_TYPE.INDICES, BuildIndicesSection() ) );
+
+			if ( !_FileName.Directory.Exists )
+				_FileName.Directory.Create();
+
+			FileInfo	TempFileName = new FileInfo( _FileName.FullName + ".tmp" );
+			using ( FileStream S = TempFileName.Create() )
+				using ( BinaryWriter W = new BinaryWriter( S, Encoding.UTF8 ) )
+				{
+					// Header
+					W.Write( CompiledAsset.MAGIC );
+					W.Write( CompiledAsset.VERSION );
+					W.Write( _SourceHash );
+					W.Write( Sections.Count );
+					W.Write( (int) 0 );
+
+					// Section table
+					long	Offset = CompiledAsset.AlignOffset( CompiledAsset.HEADER_SIZE + Sections.Count * CompiledAsset.SECTION_ENTRY_SIZE );
+					foreach ( KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]> Section in Sections )
+					{
+						int	Stride = 0;
+						if ( Section.Key == CompiledAsset.SECTION_TYPE.VERTICES )
+							Stride = VertexStride;
+						else if ( Section.Key == CompiledAsset.SECTION_TYPE.INDICES )
+							Stride = IndexStride;
+
+						W.Write( (int) Section.Key );
+						W.Write( Stride );
+						W.Write( Offset );
+						W.Write( (long) Section.Value.Length );
+						Offset = CompiledAsset.AlignOffset( Offset + Section.Value.Length );
+					}
+
+					// Sections
+					foreach ( KeyValuePair<CompiledAsset.SECTION_TYPE,byte[]> Section in Sections )
+					{
+						Pad( W );
+						W.Write( Section.Value );
+					}
+					Pad( W );
+				}
+
+			if ( _FileName.Exists )
+				_FileName.Delete();
+			TempFileName.MoveTo( _FileName.FullName );
+			_FileName.Refresh();
+
+			return _FileName.Length;
+		}
+
+		#region Scene Conversion
+
+		protected void	AddMaterial( FBXImporter.Material _Material )
+		{
+			CompiledAsset.Material	M = new CompiledAsset.Material();
+			M.Name = _Material.Name;
+			M.Type = "Default";
+
+			if ( _Material is FBXImporter.MaterialLambert )
+			{
+				FBXImporter.MaterialLambert	Lambert = _Material as FBXImporter.MaterialLambert;
+				M.Type = "Lambert";
+				M.DiffuseColor = ConvertPoint( Lambert.DiffuseColor );
+				M.DiffuseFactor = Lambert.DiffuseFactor;
+				M.EmissiveColor = ConvertPoint( Lambert.EmissiveColor );
+				M.EmissiveFactor = Lambert.EmissiveFactor;
+			}
+			if ( _Material is FBXImporter.MaterialPhong )
+			{
+				FBXImporter.MaterialPhong	Phong = _Material as FBXImporter.MaterialPhong;
+				M.Type = "Phong";
+				M.SpecularColor = ConvertPoint( Phong.SpecularColor );
+				M.SpecularFactor = Phong.SpecularFactor;
+				M.Shininess = Phong.Shininess;
+			}
+
+			FBXImporter.ObjectProperty	OpacityProperty = _Material.FindProperty( "Opacity" );
+			if ( OpacityProperty != null && OpacityProperty.Value is double )
+				M.Opacity = (float) (double) OpacityProperty.Value;
+
+			// Keep the first texture of every textured property
+			foreach ( FBXImporter.ObjectProperty Property in _Material.Properties )
+				if ( Property.Textures != null && Property.Textures.Length > 0 )
+					M.Textures[Property.Name] = Property.Textures[0].RelativeFileName;
+
+			m_Material2Index[_Material] = m_Materials.Count;
+			m_Materials.Add( M );
+		}
+
+		protected void	AddNode( FBXImporter.Node _FBXNode, int _ParentIndex )
+		{
+			CompiledAsset.Node	N = new CompiledAsset.Node();
+			N.Name = _FBXNode.Name;
+			N.ParentIndex = _ParentIndex;
+			N.Visible = _FBXNode.Visible;
+			N.Local2Parent = ConvertMatrix( _FBXNode.LocalTransform );
+
+			if ( _FBXNode is FBXImporter.NodeMesh )
+			{
+				FBXImporter.NodeMesh	Mesh = _FBXNode as FBXImporter.NodeMesh;
+				N.Type = CompiledAsset.NODE_TYPE.MESH;
+				N.MeshIndex = AddMesh( Mesh.InstanceOf != null ? Mesh.InstanceOf : Mesh );
+				N.Pivot = ConvertMatrix( Mesh.Pivot );
+			}
+			else if ( _FBXNode is FBXImporter.NodeCamera )
+				N.Type = CompiledAsset.NODE_TYPE.CAMERA;
+			else if ( _FBXNode is FBXImporter.NodeLight )
+				N.Type = CompiledAsset.NODE_TYPE.LIGHT;
+
+			int	NodeIndex = m_Nodes.Count;
+			m_FBXNode2Index[_FBXNode] = NodeIndex;
+			m_Nodes.Add( N );
+
+			foreach ( FBXImporter.Node Child in _FBXNode.Children )
+				AddNode( Child, NodeIndex );
+		}
+
+		/// <summary>
+		/// Appends the emitted vertex buffer of a mesh to the buffers
+		/// </summary>
+		/// <returns>The index of the mesh</returns>
+		protected int	AddMesh( FBXImporter.NodeMesh _FBXMesh )
+		{
+			int	Result;
+			if ( m_FBXMesh2Index.TryGetValue( _FBXMesh, out Result ) )
+				return Result;	// Already added by another instance
+
+			//////////////////////////////////////////////////////////////////////////
+			// 1] Check the emitted buffer can be written as is
+			FBXImporter.VertexBuffer	VB = _FBXMesh.VertexBuffers;
+			if ( VB == null && _FBXMesh.Triangles.Length > 0 )
+				throw new Exception( "Mesh \"" + _FBXMesh.Name + "\" has no vertex buffer, the scene must be loaded with ImportOptions.EmitVertexBuffers !" );
+
+			if ( VB != null )
+			{
+				if ( VB.Layout.StreamsCount != 1 )
+					throw new Exception( "Compiled assets only support single stream vertex layouts !" );
+				if ( Math.Abs( VB.Layout.PositionScale - m_ScaleFactor ) > 1e-6f * m_ScaleFactor )
+					throw new Exception( "The position scale of the vertex layout doesn't match the scale factor !" );
+				if ( m_VertexLayout == null )
+					m_VertexLayout = VB.Layout;
+				else if ( VB.Layout != m_VertexLayout && VB.Layout.ToString() != m_VertexLayout.ToString() )
+					throw new Exception( "All the meshes must share the same vertex layout !" );
+			}
+
+			//////////////////////////////////////////////////////////////////////////
+			// 2] Append the vertices & keep the indices until we know their stride
+			CompiledAsset.Mesh	M = new CompiledAsset.Mesh();
+			M.Name = _FBXMesh.Name;
+			M.BBox = new SharpDX.BoundingBox( m_ScaleFactor * ConvertPoint( _FBXMesh.BoundingBox.m_Min ), m_ScaleFactor * ConvertPoint( _FBXMesh.BoundingBox.m_Max ) );
+			M.VertexOffset = m_VerticesCount;
+			M.IndexOffset = m_IndicesCount;
+			M.SubMeshes = new CompiledAsset.SubMesh[0];
+
+			if ( VB != null )
+			{
+				m_Vertices.Write( VB.Streams[0], 0, VB.Streams[0].Length );
+				m_VertexBuffers.Add( VB );
+
+				M.VerticesCount = VB.VerticesCount;
+				M.IndicesCount = VB.IndicesCount;
+
+				FBXImporter.VertexBuffer.SubMesh[]	SubMeshes = VB.SubMeshes;
+				M.SubMeshes = new CompiledAsset.SubMesh[SubMeshes.Length];
+				for ( int SubMeshIndex=0; SubMeshIndex < SubMeshes.Length; SubMeshIndex++ )
+				{
+					CompiledAsset.SubMesh	SM = new CompiledAsset.SubMesh();
+					FBXImporter.Material	Material = SubMeshes[SubMeshIndex].Material as FBXImporter.Material;
+					if ( Material == null || !m_Material2Index.TryGetValue( Material, out SM.MaterialIndex ) )
+						SM.MaterialIndex = -1;
+					SM.IndexStart = SubMeshes[SubMeshIndex].IndexStart;
+					SM.IndexCount = SubMeshes[SubMeshIndex].IndexCount;
+					M.SubMeshes[SubMeshIndex] = SM;
+				}
+			}
+
+			m_VerticesCount += M.VerticesCount;
+			m_IndicesCount += M.IndicesCount;
+
+			Result = m_Meshes.Count;
+			m_FBXMesh2Index[_FBXMesh] = Result;
+			m_Meshes.Add( M );
+
+			return Result;
+		}
+
+		/// <summary>
+		/// Samples the P, R & S tracks of all the animated nodes at the sample rate
+		/// </summary>
+		protected void	SampleAnimations( FBXImporter.Scene _Scene )
+		{
+			using ( FBXImporter.AnimationEvaluator Evaluator = new FBXImporter.AnimationEvaluator( _Scene ) )
+			{
+				FBXImporter.Node[]	AnimatedNodes = Evaluator.Nodes;
+				if ( AnimatedNodes.Length == 0 )
+					return;
+
+				float	Duration = 0.0f;
+				List<int>	NodeIndices = new List<int>();
+				foreach ( FBXImporter.Node Node in AnimatedNodes )
+				{
+					int	NodeIndex;
+					if ( !m_FBXNode2Index.TryGetValue( Node, out NodeIndex ) )
+						NodeIndex = -1;	// Not part of the hierarchy
+					NodeIndices.Add( NodeIndex );
+					Duration = Math.Max( Duration, Node.AnimationDuration );
+				}
+
+				m_AnimatedNodes = NodeIndices.ToArray();
+				m_AnimationFramesCount = 1 + (int) Math.Ceiling( Duration * m_AnimationSampleRate );
+
+				int		ValuesCount = Evaluator.ValuesCount;
+				float[]	Frame = new float[ValuesCount];
+				m_AnimationValues = new float[m_AnimationFramesCount * ValuesCount];
+				for ( int FrameIndex=0; FrameIndex < m_AnimationFramesCount; FrameIndex++ )
+				{
+					Evaluator.Evaluate( FrameIndex / m_AnimationSampleRate, Frame );
+
+					// Positions are scaled like the rest of the scene
+					for ( int ValueIndex=0; ValueIndex < ValuesCount; ValueIndex += CompiledAsset.ANIMATION_VALUES_PER_NODE )
+					{
+						Frame[ValueIndex+0] *= m_ScaleFactor;
+						Frame[ValueIndex+1] *= m_ScaleFactor;
+						Frame[ValueIndex+2] *= m_ScaleFactor;
+					}
+					Array.Copy( Frame, 0, m_AnimationValues, FrameIndex * ValuesCount, ValuesCount );
+				}
+			}
+		}
+
+		#endregion
+
+		#region Sections Serialization
+
+		protected byte[]	BuildNodesSection()
+		{
+			MemoryStream	S = new MemoryStream();
+			BinaryWriter	W = new BinaryWriter( S, Encoding.UTF8 );
+			W.Write( m_Nodes.Count );
+			foreach ( CompiledAsset.Node N in m_Nodes )
+			{
+				W.Write( N.Name != null ? N.Name : "" );
+				W.Write( N.ParentIndex );
+				W.Write( (byte) N.Type );
+				W.Write( N.Visible );
+				WriteMatrix( W, N.Local2Parent );
+				if ( N.Type == CompiledAsset.NODE_TYPE.MESH )
+				{
+					W.Write( N.MeshIndex );
+					WriteMatrix( W, N.Pivot );
+				}
+			}
+			W.Flush();
+			return S.ToArray();
+		}
+
+		protected byte[]	BuildMeshesSection()
+		{
+			MemoryStream	S = new MemoryStream();
+			BinaryWriter	W = new BinaryWriter( S, Encoding.UTF8 );
+			W.Write( m_Meshes.Count );
+			foreach ( CompiledAsset.Mesh M in m_Meshes )
+			{
+				W.Write( M.Name != null ? M.Name : "" );
+				WriteVector3( W, M.BBox.Minimum );
+				WriteVector3( W, M.BBox.Maximum );
+				W.Write( M.VertexOffset );
+				W.Write( M.VerticesCount );
+				W.Write( M.IndexOffset );
+				W.Write( M.IndicesCount );
+				W.Write( M.SubMeshes.Length );
+				foreach ( CompiledAsset.SubMesh SM in M.SubMeshes )
+				{
+					W.Write( SM.MaterialIndex );
+					W.Write( SM.IndexStart );
+					W.Write( SM.IndexCount );
+				}
+			}
+			W.Flush();
+			return S.ToArray();
+		}
+
+		protected byte[]	BuildMaterialsSection()
+		{
+			MemoryStream	S = new MemoryStream();
+			BinaryWriter	W = new BinaryWriter( S, Encoding.UTF8 );
+			W.Write( m_Materials.Count );
+			foreach ( CompiledAsset.Material M in m_Materials )
+			{
+				W.Write( M.Name != null ? M.Name : "" );
+				W.Write( M.Type );
+				WriteVector3( W, M.DiffuseColor );
+				W.Write( M.DiffuseFactor );
+				WriteVector3( W, M.EmissiveColor );
+				W.Write( M.EmissiveFactor );
+				WriteVector3( W, M.SpecularColor );
+				W.Write( M.SpecularFactor );
+				W.Write( M.Shininess );
+				W.Write( M.Opacity );
+				W.Write( M.Textures.Count );
+				foreach ( KeyValuePair<string,string> Texture in M.Textures )
+				{
+					W.Write( Texture.Key );
+					W.Write( Texture.Value != null ? Texture.Value : "" );
+				}
+			}
+			W.Flush();
+			return S.ToArray();
+		}
+
+		protected byte[]	BuildVertexLayoutSection()
+		{
+			MemoryStream	S = new MemoryStream();
+			BinaryWriter	W = new BinaryWriter( S, Encoding.UTF8 );
+			FBXImporter.VertexBufferLayout.Attribute[]	Attributes = m_VertexLayout != null ? m_VertexLayout.Attributes : new FBXImporter.VertexBufferLayout.Attribute[0];
+			W.Write( Attributes.Length );
+			foreach ( FBXImporter.VertexBufferLayout.Attribute A in Attributes )
+			{
+				W.Write( (int) A.Semantic );
+				W.Write( A.SemanticIndex );
+				W.Write( (int) A.Format );
+				W.Write( A.Offset );
+			}
+			W.Flush();
+			return S.ToArray();
+		}
+
+		/// <summary>
+		/// Concatenates the indices of all the meshes, 16-bit indices being widened to 32-bits if any mesh needs them
+		/// (indices are local to their mesh, see CompiledAsset.Mesh.VertexOffset)
+		/// </summary>
+		protected byte[]	BuildIndicesSection()
+		{
+			int				Stride = IndexStride;
+			MemoryStream	S = new MemoryStream( m_IndicesCount * Stride );
+			BinaryWriter	W = new BinaryWriter( S );
+			foreach ( FBXImporter.VertexBuffer VB in m_VertexBuffers )
+			{
+				byte[]	Indices = VB.Indices;
+				if ( VB.IndexSize == Stride )
+					W.Write( Indices );
+				else
+					for ( int IndexIndex=0; IndexIndex < VB.IndicesCount; IndexIndex++ )
+						W.Write( (int) BitConverter.ToUInt16( Indices, 2 * IndexIndex ) );
+			}
+			W.Flush();
+			return S.ToArray();
+		}
+
+		protected byte[]	BuildAnimationsSection()
+		{
+			MemoryStream	S = new MemoryStream();
+			BinaryWriter	W = new BinaryWriter( S, Encoding.UTF8 );
+			W.Write( m_AnimationSampleRate );
+			W.Write( m_AnimationFramesCount );
+			W.Write( m_AnimatedNodes.Length );
+			foreach ( int NodeIndex in m_AnimatedNodes )
+				W.Write( NodeIndex );
+
+			// Frames are aligned so they can be read in place
+			Pad( W );
+			foreach ( float Value in m_AnimationValues )
+				W.Write( Value );
+			W.Flush();
+			return S.ToArray();
+		}
+
+		protected static void	Pad( BinaryWriter _Writer )
+		{
+			_Writer.Flush();
+			long	Position = _Writer.BaseStream.Position;
+			long	Aligned = CompiledAsset.AlignOffset( Position );
+			for ( ; Position < Aligned; Position++ )
+				_Writer.Write( (byte) 0 );
+		}
+
+		protected static void	WriteVector3( BinaryWriter _Writer, SharpDX.Vector3 _Value )
+		{
+			_Writer.Write( _Value.X );
+			_Writer.Write( _Value.Y );
+			_Writer.Write( _Value.Z );
+		}
+
+		protected static void	WriteMatrix( BinaryWriter _Writer, SharpDX.Matrix _Value )
+		{
+			for ( int Row=0; Row < 4; Row++ )
+				for ( int Column=0; Column < 4; Column++ )
+					_Writer.Write( _Value[Row,Column] );
+		}
+
+		protected static SharpDX.Vector3	ConvertPoint( Point _Value )
+		{
+			return new SharpDX.Vector3( _Value.x, _Value.y, _Value.z );
+		}
+
+		protected SharpDX.Matrix	ConvertMatrix( Matrix4x4 _Value )
+		{
+			SharpDX.Matrix	Result = new SharpDX.Matrix();
+			for ( int Row=0; Row < 3; Row++ )
+				for ( int Column=0; Column < 4; Column++ )
+					Result[Row,Column] = _Value.m[Row,Column];
+
+			// Translations are scaled like the rest of the scene
+			Result[3,0] = m_ScaleFactor * _Value.m[3,0];
+			Result[3,1] = m_ScaleFactor * _Value.m[3,1];
+			Result[3,2] = m_ScaleFactor * _Value.m[3,2];
+			Result[3,3] = _Value.m[3,3];
+
+			return Result;
+		}
+
+		#endregion
+
+		#endregion
+	}
+}
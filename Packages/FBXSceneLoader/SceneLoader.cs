@@ -1299,8 +1299,10 @@ namespace Nuaj.Cirrus.FBX
 
 
 				//////////////////////////////////////////////////////////////////////////
-				// Generate missing data
-				BuildTangentSpace( Faces, TSAvailability, m_Owner.m_bGenerateTangentSpace );
+				// Generate missing data (the importer already generates it natively when asked to, in which case we have nothing left to do)
+				TANGENT_SPACE_AVAILABILITY	RequiredTS = m_Owner.m_bGenerateTangentSpace ? TANGENT_SPACE_AVAILABILITY.FULL : TANGENT_SPACE_AVAILABILITY.NORMAL;
+				if ( (TSAvailability & RequiredTS) != RequiredTS )
+					BuildTangentSpace( Faces, TSAvailability, m_Owner.m_bGenerateTangentSpace );
 
 
 				//////////////////////////////////////////////////////////////////////////
@@ -2410,6 +2412,7 @@ namespace Nuaj.Cirrus.FBX
 			try
 			{
 				FBXScene = new FBXImporter.Scene();
+				FBXScene.Options.GenerateTangentSpace = m_bGenerateTangentSpace;
 				FBXScene.Load( _FileName.FullName );
 
 				// Process materials
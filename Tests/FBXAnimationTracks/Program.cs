@@ -0,0 +1,134 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+
+namespace FBXAnimationTracks
+{
+	/// <summary>
+	/// Imports AnimatedNull.fbx and checks its animation tracks evaluate to the curves written in the file, with and without compression
+	///
+	/// Usage : FBXAnimationTracks [FileName]
+	/// Returns 0 if every check passed, 1 otherwise.
+	/// </summary>
+	static class Program
+	{
+		const float	TOLERANCE = 1e-4f;
+		const float	COMPRESSION_TOLERANCE = 1e-3f;
+
+		static int	ms_FailuresCount = 0;
+
+		static int Main( string[] _Args )
+		{
+			string	FileName = _Args.Length > 0 ? _Args[0] : Path.Combine( AppDomain.CurrentDomain.BaseDirectory, "AnimatedNull.fbx" );
+
+			try
+			{
+				CheckScene( FileName, false, false );
+				CheckScene( FileName, true, false );
+				CheckScene( FileName, false, true );
+				CheckScene( FileName, true, true );
+			}
+			catch ( Exception _e )
+			{
+				Console.WriteLine( "An error occurred : " + _e.Message );
+				return 2;
+			}
+
+			Console.WriteLine( ms_FailuresCount == 0 ? "All checks passed." : ms_FailuresCount + " checks failed !" );
+			return ms_FailuresCount == 0 ? 0 : 1;
+		}
+
+		/// <summary>
+		/// Loads the scene and evaluates the tracks of the animated null, either with the SDK scene alive or once detached from the SDK
+		/// </summary>
+		static void	CheckScene( string _FileName, bool _bDetach, bool _bCompress )
+		{
+			string	Context = (_bDetach ? "detached" : "attached") + (_bCompress ? " & compressed" : "");
+			float	Tolerance = _bCompress ? COMPRESSION_TOLERANCE : TOLERANCE;
+
+			using ( FBXImporter.Scene Scene = new FBXImporter.Scene() )
+			{
+				Scene.Options.TargetAxisSystem = FBXImporter.ImportOptions.TARGET_AXIS_SYSTEM.Y_UP_RIGHT_HANDED;	// Same as the file, tracks are not converted
+				Scene.Options.DetachFromSDK = _bDetach;
+				Scene.Options.CompressAnimations = _bCompress;
+				Scene.Options.AnimationSampleRate = 30.0f;
+				Scene.Options.PositionTolerance = COMPRESSION_TOLERANCE;
+				Scene.Options.RotationTolerance = COMPRESSION_TOLERANCE;
+				Scene.LoadFile( _FileName );
+
+				FBXImporter.Node	Null = Scene.FindNode( "AnimatedNull" );
+				if ( !Check( Null != null, Context + " : the node was imported" ) )
+					return;
+				if ( !Check( Null.IsPRSAnimated && Null.AnimationTracksPosition != null && Null.AnimationTracksRotation != null, Context + " : the node has P & R tracks" ) )
+					return;
+
+				FBXImporter.AnimationTrack[]	P = Null.AnimationTracksPosition;
+				FBXImporter.AnimationTrack[]	R = Null.AnimationTracksRotation;
+
+				// The stepped track must be compressed as well (its keys lie on frames)
+				if ( _bCompress )
+					Check( P[1].IsCompressed, Context + " : the stepped track " + P[1].Name + " was compressed" );
+
+				// The tracks must go through their keys
+				foreach ( FBXImporter.AnimationTrack Track in new FBXImporter.AnimationTrack[] { P[0], P[1], P[2], R[0] } )
+					foreach ( FBXImporter.AnimationTrack.AnimationKey K in Track.Keys )
+						CheckValue( Track.Evaluate( K.Time ), K.Value, Tolerance, Context + " : key of track " + Track.Name + " at " + K.Time + "s" );
+
+				// And reproduce the curves between the keys
+				float[]	Times = { 0.0f, 0.25f, 0.5f, 0.75f, 0.999f, 1.0f, 1.001f, 1.5f, 2.0f };
+				foreach ( float Time in Times )
+				{
+					CheckValue( P[0].Evaluate( Time ), ExpectedPx( Time ), Tolerance, Context + " : linear Px at " + Time + "s" );
+					CheckValue( P[1].Evaluate( Time ), ExpectedPy( Time ), Tolerance, Context + " : stepped Py at " + Time + "s" );
+					CheckValue( P[2].Evaluate( Time ), ExpectedPz( Time ), Tolerance, Context + " : linear Pz at " + Time + "s" );
+					CheckValue( R[0].Evaluate( Time ), ExpectedRx( Time ), Tolerance, Context + " : linear Rx (in radians) at " + Time + "s" );
+				}
+
+				// The batched evaluator must return the same values
+				using ( FBXImporter.AnimationEvaluator Evaluator = new FBXImporter.AnimationEvaluator( Scene ) )
+				{
+					int	NodeIndex = Array.IndexOf( Evaluator.Nodes, Null );
+					if ( !Check( NodeIndex >= 0, Context + " : the evaluator animates the node" ) )
+						return;
+
+					float[]	Results = new float[Evaluator.ValuesCount];
+					foreach ( float Time in Times )
+					{
+						Evaluator.Evaluate( Time, Results );
+
+						int	Offset = FBXImporter.AnimationEvaluator.VALUES_PER_NODE * NodeIndex;
+						CheckValue( Results[Offset+0], ExpectedPx( Time ), Tolerance, Context + " : evaluated Px at " + Time + "s" );
+						CheckValue( Results[Offset+1], ExpectedPy( Time ), Tolerance, Context + " : evaluated Py at " + Time + "s" );
+						CheckValue( Results[Offset+2], ExpectedPz( Time ), Tolerance, Context + " : evaluated Pz at " + Time + "s" );
+						CheckValue( Results[Offset+3], ExpectedRx( Time ), Tolerance, Context + " : evaluated Rx at " + Time + "s" );
+						CheckValue( Results[Offset+6], 1.0f, Tolerance, Context + " : evaluated Sx (no scale track) at " + Time + "s" );
+					}
+				}
+			}
+		}
+
+		#region Curves written in AnimatedNull.fbx
+
+		static float	ExpectedPx( float _Time )	{ return _Time <= 1.0f ? 10.0f * _Time : 10.0f * (2.0f - _Time); }
+		static float	ExpectedPy( float _Time )	{ return _Time < 1.0f ? 2.0f : 4.0f; }
+		static float	ExpectedPz( float _Time )	{ return -1.5f * _Time; }
+		static float	ExpectedRx( float _Time )	{ return 0.5f * (float) Math.PI * Math.Min( 1.0f, _Time ); }
+
+		#endregion
+
+		static bool	Check( bool _bCondition, string _Description )
+		{
+			if ( _bCondition )
+				return true;
+
+			Console.WriteLine( "FAILED : " + _Description );
+			ms_FailuresCount++;
+			return false;
+		}
+
+		static bool	CheckValue( float _Value, float _Expected, float _Tolerance, string _Description )
+		{
+			return Check( Math.Abs( _Value - _Expected ) <= _Tolerance, _Description + " (got " + _Value + ", expected " + _Expected + ")" );
+		}
+	}
+}
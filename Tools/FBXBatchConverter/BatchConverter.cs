@@ -0,0 +1,330 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using System.IO;
+using System.Threading;
+using System.Diagnostics;
+
+using Nuaj.Cirrus.FBX;
+
+namespace FBXBatchConverter
+{
+	/// <summary>
+	/// Converts all the FBX files of a directory tree into compiled assets, in parallel
+	///
+	/// Each worker owns a queue of files (dealt largest first) and steals from the other queues once its own is empty.
+	/// Each worker also owns its FBX scene, reused from one file to the next, so concurrent loads never share SDK objects.
+	/// An asset is skipped when the hash stored in its header matches the hash of its source file & of the conversion settings.
+	/// </summary>
+	public class	BatchConverter
+	{
+		#region CONSTANTS
+
+		public const string	ASSET_EXTENSION = ".asset";
+
+		#endregion
+
+		#region NESTED TYPES
+
+		public enum	STATUS
+		{
+			PENDING,
+			CONVERTED,
+			UP_TO_DATE,
+			FAILED,
+		}
+
+		[DebuggerDisplay( "{SourceFile.Name} {Status}" )]
+		public class	Job
+		{
+			public FileInfo		SourceFile;
+			public FileInfo		TargetFile;
+			public STATUS		Status = STATUS.PENDING;
+			public string		Error;
+			public int			WorkerIndex;
+			public bool			Stolen;
+
+			// Report
+			public long			SourceSize;
+			public long			TargetSize;
+			public int			VerticesCount;
+			public int			TrianglesCount;
+			public int			MeshesCount;
+			public int			MaterialsCount;
+			public int			AnimationFramesCount;
+			public double		HashMilliseconds;
+			public double		LoadMilliseconds;
+			public double		BuildMilliseconds;
+			public double		WriteMilliseconds;
+
+			public double		TotalMilliseconds	{ get { return HashMilliseconds + LoadMilliseconds + BuildMilliseconds + WriteMilliseconds; } }
+		}
+
+		#endregion
+
+		#region FIELDS
+
+		protected DirectoryInfo		m_SourceDirectory = null;
+		protected DirectoryInfo		m_TargetDirectory = null;
+		protected int				m_WorkersCount = Environment.ProcessorCount;
+		protected float				m_ScaleFactor = 1.0f;
+		protected float				m_AnimationSampleRate = 30.0f;
+		protected bool				m_bForce = false;
+
+		protected List<Job>			m_Jobs = new List<Job>();
+		protected WorkStealingQueue<Job>[]	m_Queues = null;
+		protected double			m_TotalMilliseconds = 0.0;
+
+		#endregion
+
+		#region PROPERTIES
+
+		public int		WorkersCount			{ get { return m_WorkersCount; } set { m_WorkersCount = Math.Max( 1, value ); } }
+		public float	ScaleFactor				{ get { return m_ScaleFactor; } set { m_ScaleFactor = value; } }
+		public float	AnimationSampleRate		{ get { return m_AnimationSampleRate; } set { m_AnimationSampleRate = Math.Max( 0.0f, value ); } }
+
+		/// <summary>
+		/// True to convert every file, even those whose asset is up to date
+		/// </summary>
+		public bool		Force					{ get { return m_bForce; } set { m_bForce = value; } }
+
+		public Job[]	Jobs					{ get { return m_Jobs.ToArray(); } }
+		public double	TotalMilliseconds		{ get { return m_TotalMilliseconds; } }
+
+		#endregion
+
+		#region METHODS
+
+		public	BatchConverter( DirectoryInfo _SourceDirectory, DirectoryInfo _TargetDirectory )
+		{
+			m_SourceDirectory = _SourceDirectory;
+			m_TargetDirectory = _TargetDirectory;
+		}
+
+		/// <summary>
+		/// Converts all the FBX files found in the source directory tree
+		/// </summary>
+		/// <returns>The amount of failed conversions</returns>
+		public int		Convert()
+		{
+			if ( !m_SourceDirectory.Exists )
+				throw new Exception( "Source directory \"" + m_SourceDirectory.FullName + "\" does not exist !" );
+
+			Stopwatch	Watch = Stopwatch.StartNew();
+
+			//////////////////////////////////////////////////////////////////////////
+			// 1] Collect the files, largest first
+			m_Jobs.Clear();
+			string	SourceRoot = m_SourceDirectory.FullName.TrimEnd( Path.DirectorySeparatorChar ) + Path.DirectorySeparatorChar;
+			foreach ( FileInfo SourceFile in m_SourceDirectory.GetFiles( "*.fbx", SearchOption.AllDirectories ) )
+			{
+				string	RelativeName = SourceFile.FullName.Substring( SourceRoot.Length );
+
+				Job	J = new Job();
+				J.SourceFile = SourceFile;
+				J.TargetFile = new FileInfo( Path.Combine( m_TargetDirectory.FullName, Path.ChangeExtension( RelativeName, ASSET_EXTENSION ) ) );
+				J.SourceSize = SourceFile.Length;
+				m_Jobs.Add( J );
+			}
+			m_Jobs.Sort( ( a, b ) => b.SourceSize.CompareTo( a.SourceSize ) );
+
+			//////////////////////////////////////////////////////////////////////////
+			// 2] Deal them to the workers' queues
+			int	WorkersCount = Math.Max( 1, Math.Min( m_WorkersCount, m_Jobs.Count ) );
+			m_Queues = new WorkStealingQueue<Job>[WorkersCount];
+			for ( int WorkerIndex=0; WorkerIndex < WorkersCount; WorkerIndex++ )
+				m_Queues[WorkerIndex] = new WorkStealingQueue<Job>();
+			for ( int JobIndex=0; JobIndex < m_Jobs.Count; JobIndex++ )
+				m_Queues[JobIndex % WorkersCount].Push( m_Jobs[JobIndex] );
+
+			//////////////////////////////////////////////////////////////////////////
+			// 3] Run the workers
+			Thread[]	Workers = new Thread[WorkersCount];
+			for ( int WorkerIndex=0; WorkerIndex < WorkersCount; WorkerIndex++ )
+			{
+				int	Index = WorkerIndex;
+				Workers[WorkerIndex] = new Thread( () => WorkerLoop( Index ) );
+				Workers[WorkerIndex].Name = "FBX Converter #" + WorkerIndex;
+				Workers[WorkerIndex].Start();
+			}
+			foreach ( Thread Worker in Workers )
+				Worker.Join();
+
+			m_TotalMilliseconds = Watch.Elapsed.TotalMilliseconds;
+
+			int	FailedCount = 0;
+			foreach ( Job J in m_Jobs )
+				if ( J.Status == STATUS.FAILED )
+					FailedCount++;
+
+			return FailedCount;
+		}
+
+		/// <summary>
+		/// Writes the per-asset timing & size report (tab-separated, one line per asset)
+		/// </summary>
+		/// <param name="_ReportFile"></param>
+		public void		WriteReport( FileInfo _ReportFile )
+		{
+			using ( StreamWriter W = new StreamWriter( _ReportFile.FullName, false, Encoding.UTF8 ) )
+			{
+				W.WriteLine( "Source\tStatus\tWorker\tStolen\tSource KB\tAsset KB\tMeshes\tMaterials\tVertices\tTriangles\tFrames\tHash ms\tLoad ms\tBuild ms\tWrite ms\tTotal ms\tError" );
+				foreach ( Job J in m_Jobs )
+					W.WriteLine( string.Format( "{0}\t{1}\t{2}\t{3}\t{4:F1}\t{5:F1}\t{6}\t{7}\t{8}\t{9}\t{10}\t{11:F1}\t{12:F1}\t{13:F1}\t{14:F1}\t{15:F1}\t{16}",
+						J.SourceFile.FullName, J.Status, J.WorkerIndex, J.Stolen ? 1 : 0,
+						J.SourceSize / 1024.0, J.TargetSize / 1024.0,
+						J.MeshesCount, J.MaterialsCount, J.VerticesCount, J.TrianglesCount, J.AnimationFramesCount,
+						J.HashMilliseconds, J.LoadMilliseconds, J.BuildMilliseconds, J.WriteMilliseconds, J.TotalMilliseconds,
+						J.Error != null ? J.Error.Replace( '\t', ' ' ).Replace( "\r", "" ).Replace( '\n', ' ' ) : "" ) );
+
+				W.WriteLine();
+				W.WriteLine( GetSummary() );
+			}
+		}
+
+		public string	GetSummary()
+		{
+			int		ConvertedCount = 0, UpToDateCount = 0, FailedCount = 0, StolenCount = 0;
+			long	SourceSize = 0, TargetSize = 0;
+			foreach ( Job J in m_Jobs )
+			{
+				switch ( J.Status )
+				{
+					case STATUS.CONVERTED:
+						ConvertedCount++;
+						SourceSize += J.SourceSize;
+						TargetSize += J.TargetSize;
+						break;
+					case STATUS.UP_TO_DATE:	UpToDateCount++; break;
+					case STATUS.FAILED:		FailedCount++; break;
+				}
+				if ( J.Stolen )
+					StolenCount++;
+			}
+
+			return string.Format( "{0} files in {1:F1} s with {2} workers ({3} jobs stolen) : {4} converted ({5:F1} MB => {6:F1} MB), {7} up to date, {8} failed",
+				m_Jobs.Count, m_TotalMilliseconds / 1000.0, m_Queues != null ? m_Queues.Length : 0, StolenCount,
+				ConvertedCount, SourceSize / (1024.0 * 1024.0), TargetSize / (1024.0 * 1024.0), UpToDateCount, FailedCount );
+		}
+
+		protected void	WorkerLoop( int _WorkerIndex )
+		{
+			FBXImporter.Scene	Scene = new FBXImporter.Scene();
+			try
+			{
+				Scene.Options.GenerateTangentSpace = true;
+				Scene.Options.DetectInstances = true;
+				Scene.Options.EmitVertexBuffers = true;	// The writer copies the encoded buffers as is
+				Scene.Options.VertexLayout.PositionScale = m_ScaleFactor;
+
+				while ( true )
+				{
+					// Take our own jobs first then steal from the others
+					bool	bStolen = false;
+					Job		J = m_Queues[_WorkerIndex].TryPop();
+					for ( int Offset=1; J == null && Offset < m_Queues.Length; Offset++ )
+					{
+						J = m_Queues[(_WorkerIndex + Offset) % m_Queues.Length].TrySteal();
+						bStolen = J != null;
+					}
+					if ( J == null )
+						return;	// No new jobs are ever queued so there's nothing left anywhere
+
+					J.WorkerIndex = _WorkerIndex;
+					J.Stolen = bStolen;
+					ConvertFile( Scene, J );
+
+					lock ( this )
+						Console.WriteLine( "[{0}] {1} {2} ({3:F1} ms){4}", _WorkerIndex, J.Status, J.SourceFile.Name, J.TotalMilliseconds, J.Error != null ? " " + J.Error : "" );
+				}
+			}
+			finally
+			{
+				Scene.Dispose();
+			}
+		}
+
+		protected void	ConvertFile( FBXImporter.Scene _Scene, Job _Job )
+		{
+			Stopwatch	Watch = Stopwatch.StartNew();
+			try
+			{
+				//////////////////////////////////////////////////////////////////////////
+				// 1] Skip the file if its asset was built from the same contents & settings
+				byte[]	SourceHash = ComputeSourceHash( _Job.SourceFile );
+				_Job.HashMilliseconds = Watch.Elapsed.TotalMilliseconds;
+				if ( !m_bForce && HashEquals( CompiledAsset.ReadSourceHash( _Job.TargetFile ), SourceHash ) )
+				{
+					_Job.TargetSize = _Job.TargetFile.Length;
+					_Job.Status = STATUS.UP_TO_DATE;
+					return;
+				}
+
+				//////////////////////////////////////////////////////////////////////////
+				// 2] Load
+				Watch.Restart();
+				_Scene.Load( _Job.SourceFile.FullName );
+				_Job.LoadMilliseconds = Watch.Elapsed.TotalMilliseconds;
+
+				//////////////////////////////////////////////////////////////////////////
+				// 3] Build the buffers & tables
+				Watch.Restart();
+				CompiledAssetWriter	Writer = new CompiledAssetWriter( _Scene, m_ScaleFactor, m_AnimationSampleRate );
+				_Job.MeshesCount = Writer.MeshesCount;
+				_Job.MaterialsCount = Writer.MaterialsCount;
+				_Job.VerticesCount = Writer.VerticesCount;
+				_Job.TrianglesCount = Writer.TrianglesCount;
+				_Job.AnimationFramesCount = Writer.AnimationFramesCount;
+				_Job.BuildMilliseconds = Watch.Elapsed.TotalMilliseconds;
+
+				//////////////////////////////////////////////////////////////////////////
+				// 4] Write
+				Watch.Restart();
+				_Job.TargetSize = Writer.Write( _Job.TargetFile, SourceHash );
+				_Job.WriteMilliseconds = Watch.Elapsed.TotalMilliseconds;
+
+				_Job.Status = STATUS.CONVERTED;
+			}
+			catch ( Exception _e )
+			{
+				_Job.Status = STATUS.FAILED;
+				_Job.Error = _e.Message + (_e.InnerException != null ? " (" + _e.InnerException.Message + ")" : "");
+			}
+		}
+
+		/// <summary>
+		/// Hashes the contents of the source file along with the format version & the conversion settings
+		/// </summary>
+		protected byte[]	ComputeSourceHash( FileInfo _SourceFile )
+		{
+			using ( System.Security.Cryptography.MD5 Hasher = System.Security.Cryptography.MD5.Create() )
+			{
+				byte[]	Settings = Encoding.UTF8.GetBytes( string.Format( System.Globalization.CultureInfo.InvariantCulture, "v{0} scale={1} fps={2}", CompiledAsset.VERSION, m_ScaleFactor, m_AnimationSampleRate ) );
+				Hasher.TransformBlock( Settings, 0, Settings.Length, null, 0 );
+
+				using ( FileStream S = _SourceFile.OpenRead() )
+				{
+					byte[]	Buffer = new byte[1 << 20];
+					int		ReadCount;
+					while ( (ReadCount = S.Read( Buffer, 0, Buffer.Length )) > 0 )
+						Hasher.TransformBlock( Buffer, 0, ReadCount, null, 0 );
+				}
+				Hasher.TransformFinalBlock( new byte[0], 0, 0 );
+
+				return Hasher.Hash;
+			}
+		}
+
+		protected static bool	HashEquals( byte[] _A, byte[] _B )
+		{
+			if ( _A == null || _B == null || _A.Length != _B.Length )
+				return false;
+			for ( int i=0; i < _A.Length; i++ )
+				if ( _A[i] != _B[i] )
+					return false;
+			return true;
+		}
+
+		#endregion
+	}
+}
@@ -0,0 +1,68 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+using System.IO;
+using System.Globalization;
+
+namespace FBXBatchConverter
+{
+	/// <summary>
+	/// Converts a directory tree of FBX files into compiled assets the game only needs to memory-map (see Nuaj.Cirrus.FBX.CompiledAsset)
+	///
+	/// Usage : FBXBatchConverter SourceDirectory TargetDirectory [-workers N] [-scale F] [-fps F] [-force] [-report File]
+	///	_ workers, the amount of files converted in parallel (defaults to the amount of processors)
+	///	_ scale, the scale factor applied to positions (e.g. 0.01 to convert centimeters into meters)
+	///	_ fps, the animation sample rate (0 to skip animations)
+	///	_ force, converts every file even if its asset is up to date
+	///	_ report, the per-asset timing & size report (defaults to ConversionReport.txt in the target directory)
+	/// </summary>
+	static class Program
+	{
+		static int Main( string[] _Args )
+		{
+			if ( _Args.Length < 2 )
+			{
+				Console.WriteLine( "Usage : FBXBatchConverter SourceDirectory TargetDirectory [-workers N] [-scale F] [-fps F] [-force] [-report File]" );
+				return 2;
+			}
+
+			try
+			{
+				DirectoryInfo	SourceDirectory = new DirectoryInfo( _Args[0] );
+				DirectoryInfo	TargetDirectory = new DirectoryInfo( _Args[1] );
+				BatchConverter	Converter = new BatchConverter( SourceDirectory, TargetDirectory );
+				FileInfo		ReportFile = new FileInfo( Path.Combine( TargetDirectory.FullName, "ConversionReport.txt" ) );
+
+				for ( int ArgIndex=2; ArgIndex < _Args.Length; ArgIndex++ )
+				{
+					switch ( _Args[ArgIndex].ToLower() )
+					{
+						case "-workers":	Converter.WorkersCount = int.Parse( _Args[++ArgIndex] ); break;
+						case "-scale":		Converter.ScaleFactor = float.Parse( _Args[++ArgIndex], CultureInfo.InvariantCulture ); break;
+						case "-fps":		Converter.AnimationSampleRate = float.Parse( _Args[++ArgIndex], CultureInfo.InvariantCulture ); break;
+						case "-force":		Converter.Force = true; break;
+						case "-report":		ReportFile = new FileInfo( _Args[++ArgIndex] ); break;
+						default:
+							throw new Exception( "Unknown argument \"" + _Args[ArgIndex] + "\" !" );
+					}
+				}
+
+				int	FailedCount = Converter.Convert();
+
+				if ( !ReportFile.Directory.Exists )
+					ReportFile.Directory.Create();
+				Converter.WriteReport( ReportFile );
+
+				Console.WriteLine( Converter.GetSummary() );
+				Console.WriteLine( "Report written to \"" + ReportFile.FullName + "\"" );
+
+				return FailedCount > 0 ? 1 : 0;
+			}
+			catch ( Exception _e )
+			{
+				Console.WriteLine( "An error occurred : " + _e.Message );
+				return 2;
+			}
+		}
+	}
+}
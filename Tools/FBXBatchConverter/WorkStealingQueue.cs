@@ -0,0 +1,83 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Text;
+
+namespace FBXBatchConverter
+{
+	/// <summary>
+	/// A job queue owned by a single worker that other workers can steal from once their own queue is empty
+	/// The owner takes jobs from the front while thieves take them from the back, so they only contend on the last job.
+	/// Jobs are whole files (i.e. milliseconds to seconds of work) so a lock per queue costs nothing compared to a lock-free deque.
+	/// </summary>
+	public class	WorkStealingQueue<T> where T : class
+	{
+		#region FIELDS
+
+		protected LinkedList<T>		m_Jobs = new LinkedList<T>();
+		protected int				m_StolenCount = 0;
+
+		#endregion
+
+		#region PROPERTIES
+
+		public int		Count
+		{
+			get { lock ( m_Jobs ) return m_Jobs.Count; }
+		}
+
+		/// <summary>
+		/// Gets the amount of jobs other workers stole from that queue
+		/// </summary>
+		public int		StolenCount
+		{
+			get { return m_StolenCount; }
+		}
+
+		#endregion
+
+		#region METHODS
+
+		public void		Push( T _Job )
+		{
+			lock ( m_Jobs )
+				m_Jobs.AddLast( _Job );
+		}
+
+		/// <summary>
+		/// Takes the next job of the owner
+		/// </summary>
+		/// <returns>The job or null if the queue is empty</returns>
+		public T		TryPop()
+		{
+			lock ( m_Jobs )
+			{
+				if ( m_Jobs.Count == 0 )
+					return null;
+
+				T	Job = m_Jobs.First.Value;
+				m_Jobs.RemoveFirst();
+				return Job;
+			}
+		}
+
+		/// <summary>
+		/// Steals the last job of the queue
+		/// </summary>
+		/// <returns>The job or null if the queue is empty</returns>
+		public T		TrySteal()
+		{
+			lock ( m_Jobs )
+			{
+				if ( m_Jobs.Count == 0 )
+					return null;
+
+				T	Job = m_Jobs.Last.Value;
+				m_Jobs.RemoveLast();
+				m_StolenCount++;
+				return Job;
+			}
+		}
+
+		#endregion
+	}
+}
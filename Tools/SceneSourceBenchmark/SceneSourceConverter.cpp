@@ -0,0 +1,580 @@
+// Native scene source converter
+// Triangulates, sorts by material & welds the meshes of any SceneSource, then samples its animations
+//
+#ifdef _MANAGED
+#pragma unmanaged
+#endif
+
+#include <math.h>
+#include <string.h>
+#include "SceneSourceConverter.h"
+
+using namespace	FBXImporter;
+
+static const float	DEG2RAD = 3.14159265358979f / 180.0f;
+static const int	MIN_WELD_TABLE_SIZE = 256;
+
+static int	NextPowerOf2( int _Value )
+{
+	int	Result = 1;
+	while ( Result < _Value )
+		Result <<= 1;
+	return Result;
+}
+
+// FNV-1a over the bits of the vertex
+static unsigned int	HashVertex( const float* _pVertex, int _Stride )
+{
+	const unsigned int*	pWords = reinterpret_cast<const unsigned int*>( _pVertex );
+	unsigned int		Hash = 2166136261U;
+	for ( int WordIndex=0; WordIndex < _Stride; WordIndex++ )
+	{
+		Hash ^= pWords[WordIndex];
+		Hash *= 16777619U;
+	}
+
+	// Low bits index the table so fold the high bits in
+	return Hash ^ (Hash >> 15);
+}
+
+SceneSourceConverter::SceneSourceConverter( int _Attributes, float _AnimationSampleRate ) :
+	m_Attributes( _Attributes ),
+	m_AnimationSampleRate( _AnimationSampleRate ),
+	m_pVertices( NULL ), m_VerticesCount( 0 ), m_VerticesCapacity( 0 ),
+	m_pIndices( NULL ), m_IndicesCount( 0 ), m_IndicesCapacity( 0 ),
+	m_pMeshes( NULL ), m_MeshesCount( 0 ),
+	m_pSubMeshes( NULL ), m_SubMeshesCount( 0 ), m_SubMeshesCapacity( 0 ),
+	m_pAnimatedNodes( NULL ), m_pAnimationValues( NULL ), m_FramesCount( 0 ),
+	m_pWeldTable( NULL ), m_WeldTableSize( 0 )
+{
+	m_VertexStride = 3;
+	if ( m_Attributes & ATTRIBUTE_NORMAL )		m_VertexStride += 3;
+	if ( m_Attributes & ATTRIBUTE_TANGENT )		m_VertexStride += 3;
+	if ( m_Attributes & ATTRIBUTE_BINORMAL )	m_VertexStride += 3;
+	if ( m_Attributes & ATTRIBUTE_UV0 )			m_VertexStride += 2;
+	if ( m_Attributes & ATTRIBUTE_UV1 )			m_VertexStride += 2;
+	if ( m_Attributes & ATTRIBUTE_COLOR )		m_VertexStride += 4;
+
+	memset( &m_Statistics, 0, sizeof(Statistics) );
+}
+
+SceneSourceConverter::~SceneSourceConverter()
+{
+	Clear();
+}
+
+void	SceneSourceConverter::Clear()
+{
+	delete[] m_pVertices;
+	m_pVertices = NULL;
+	m_VerticesCount = m_VerticesCapacity = 0;
+
+	delete[] m_pIndices;
+	m_pIndices = NULL;
+	m_IndicesCount = m_IndicesCapacity = 0;
+
+	delete[] m_pMeshes;
+	m_pMeshes = NULL;
+	m_MeshesCount = 0;
+
+	delete[] m_pSubMeshes;
+	m_pSubMeshes = NULL;
+	m_SubMeshesCount = m_SubMeshesCapacity = 0;
+
+	delete[] m_pAnimatedNodes;
+	m_pAnimatedNodes = NULL;
+	delete[] m_pAnimationValues;
+	m_pAnimationValues = NULL;
+	m_FramesCount = 0;
+
+	delete[] m_pWeldTable;
+	m_pWeldTable = NULL;
+	m_WeldTableSize = 0;
+
+	memset( &m_Statistics, 0, sizeof(Statistics) );
+}
+
+void	SceneSourceConverter::Convert( const SceneSource& _Source )
+{
+	Clear();
+
+	m_Statistics.NodesCount = _Source.GetNodesCount();
+	m_Statistics.MaterialsCount = _Source.GetMaterialsCount();
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Convert the meshes
+	SourceNode	Node;
+	int			MeshesCount = 0;
+	for ( int NodeIndex=0; NodeIndex < m_Statistics.NodesCount; NodeIndex++ )
+	{
+		_Source.GetNode( NodeIndex, Node );
+		if ( Node.Type == SourceNode::TYPE_MESH )
+			MeshesCount++;
+	}
+
+	m_pMeshes = new Mesh[MeshesCount];
+	for ( int NodeIndex=0; NodeIndex < m_Statistics.NodesCount; NodeIndex++ )
+	{
+		_Source.GetNode( NodeIndex, Node );
+		if ( Node.Type == SourceNode::TYPE_MESH )
+			ConvertMesh( _Source, NodeIndex, m_pMeshes[m_MeshesCount++] );
+	}
+
+	// The table is only needed while welding
+	delete[] m_pWeldTable;
+	m_pWeldTable = NULL;
+	m_WeldTableSize = 0;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Sample the animations
+	if ( m_AnimationSampleRate > 0.0f )
+		ConvertAnimations( _Source );
+
+	m_Statistics.MeshesCount = m_MeshesCount;
+	m_Statistics.VerticesCount = m_VerticesCount;
+	m_Statistics.VertexBytes = (long long) m_VerticesCount * m_VertexStride * sizeof(float);
+	m_Statistics.IndexBytes = (long long) m_IndicesCount * sizeof(unsigned int);
+	m_Statistics.AnimationBytes = (long long) m_Statistics.AnimatedNodesCount * m_FramesCount * ANIMATION_VALUES_PER_FRAME * sizeof(float);
+}
+
+void	SceneSourceConverter::ConvertMesh( const SceneSource& _Source, int _NodeIndex, Mesh& _Mesh )
+{
+	SourceMesh	SrcMesh;
+	_Source.GetMesh( _NodeIndex, SrcMesh );
+
+	SourceNode	Node;
+	_Source.GetNode( _NodeIndex, Node );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 1] Read the geometry
+	float*	pPositions = new float[3 * SrcMesh.ControlPointsCount];
+	int*	pPolygonSizes = new int[SrcMesh.PolygonsCount];
+	int*	pPolygonVertices = new int[SrcMesh.PolygonVerticesCount];
+	_Source.GetControlPoints( _NodeIndex, pPositions );
+	_Source.GetPolygons( _NodeIndex, pPolygonSizes, pPolygonVertices );
+	m_AxisConversion.TransformVectors( pPositions, SrcMesh.ControlPointsCount );
+
+	ResolvedElement	pElements[MAX_ATTRIBUTES];
+	ResolvedElement	Materials;
+	int				ElementsCount = ResolveElements( _Source, _NodeIndex, SrcMesh.LayerElementsCount, pElements, Materials );
+
+	//////////////////////////////////////////////////////////////////////////
+	// 2] Triangulate polygons as fans
+	int	TrianglesCount = 0;
+	for ( int PolygonIndex=0; PolygonIndex < SrcMesh.PolygonsCount; PolygonIndex++ )
+		if ( pPolygonSizes[PolygonIndex] > 2 )
+			TrianglesCount += pPolygonSizes[PolygonIndex] - 2;
+
+	int*	pTriangleCorners = new int[3 * TrianglesCount];	// Polygon vertex index of each corner
+	int*	pTrianglePolygons = new int[TrianglesCount];
+
+	// Reflections turn the triangles inside out so their winding is reversed
+	int	Corner1 = m_AxisConversion.FlipsWinding() ? 2 : 1;
+	int	Corner2 = 3 - Corner1;
+
+	int	TriangleIndex = 0;
+	int	PolygonVertexOffset = 0;
+	for ( int PolygonIndex=0; PolygonIndex < SrcMesh.PolygonsCount; PolygonIndex++ )
+	{
+		int	PolySize = pPolygonSizes[PolygonIndex];
+		for ( int FanIndex=0; FanIndex < PolySize-2; FanIndex++ )
+		{
+			pTriangleCorners[3*TriangleIndex+0] = PolygonVertexOffset;
+			pTriangleCorners[3*TriangleIndex+Corner1] = PolygonVertexOffset + 1 + FanIndex;
+			pTriangleCorners[3*TriangleIndex+Corner2] = PolygonVertexOffset + 2 + FanIndex;
+			pTrianglePolygons[TriangleIndex++] = PolygonIndex;
+		}
+		PolygonVertexOffset += PolySize;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// 3] Group triangles by material slot (counting sort, keeping the original order within a slot)
+	int		SlotsCount = Node.MaterialsCount > 0 ? Node.MaterialsCount : 1;
+	int*	pSlotStarts = new int[SlotsCount+1];
+	int*	pTriangleSlots = new int[TrianglesCount];
+	memset( pSlotStarts, 0, (SlotsCount+1) * sizeof(int) );
+
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+	{
+		int	Slot = 0;
+		if ( Materials.pIndices != NULL )
+		{
+			int	MapIndex = 0;
+			switch ( Materials.Mapping )
+			{
+			case SourceLayerElement::MAPPING_BY_POLYGON:		MapIndex = pTrianglePolygons[TriangleIndex]; break;
+			case SourceLayerElement::MAPPING_BY_POLYGON_VERTEX:	MapIndex = pTriangleCorners[3*TriangleIndex]; break;
+			case SourceLayerElement::MAPPING_BY_CONTROL_POINT:	MapIndex = pPolygonVertices[pTriangleCorners[3*TriangleIndex]]; break;
+			default:											MapIndex = 0; break;
+			}
+			Slot = Materials.pIndices[MapIndex];
+			if ( Slot < 0 || Slot >= SlotsCount )
+				Slot = 0;
+		}
+		pTriangleSlots[TriangleIndex] = Slot;
+		pSlotStarts[Slot+1]++;
+	}
+	for ( int SlotIndex=0; SlotIndex < SlotsCount; SlotIndex++ )
+		pSlotStarts[SlotIndex+1] += pSlotStarts[SlotIndex];
+
+	int*	pSortedTriangles = new int[TrianglesCount];
+	int*	pSlotCursors = new int[SlotsCount];
+	memcpy( pSlotCursors, pSlotStarts, SlotsCount * sizeof(int) );
+	for ( int TriangleIndex=0; TriangleIndex < TrianglesCount; TriangleIndex++ )
+		pSortedTriangles[pSlotCursors[pTriangleSlots[TriangleIndex]]++] = TriangleIndex;
+
+	//////////////////////////////////////////////////////////////////////////
+	// 4] Build & weld the vertices of every corner
+	_Mesh.NodeIndex = _NodeIndex;
+	_Mesh.FirstVertex = m_VerticesCount;
+	_Mesh.FirstSubMesh = m_SubMeshesCount;
+	_Mesh.SubMeshesCount = 0;
+
+	ReserveIndices( m_IndicesCount + 3 * TrianglesCount );
+	ReserveVertices( m_VerticesCount + SrcMesh.ControlPointsCount );	// A good guess for smooth meshes
+	ResizeWeldTable( NextPowerOf2( 2 * (SrcMesh.ControlPointsCount > MIN_WELD_TABLE_SIZE ? SrcMesh.ControlPointsCount : MIN_WELD_TABLE_SIZE) ), _Mesh.FirstVertex );
+
+	float*	pVertex = new float[m_VertexStride];
+	for ( int SlotIndex=0; SlotIndex < SlotsCount; SlotIndex++ )
+	{
+		int	FirstIndex = m_IndicesCount;
+		for ( int SortedIndex=pSlotStarts[SlotIndex]; SortedIndex < pSlotStarts[SlotIndex+1]; SortedIndex++ )
+		{
+			int	TriangleIndex = pSortedTriangles[SortedIndex];
+			for ( int CornerIndex=0; CornerIndex < 3; CornerIndex++ )
+			{
+				BuildVertex( pPositions, pPolygonVertices, pElements, ElementsCount, pTrianglePolygons[TriangleIndex], pTriangleCorners[3*TriangleIndex+CornerIndex], pVertex );
+				m_pIndices[m_IndicesCount++] = WeldVertex( pVertex, _Mesh.FirstVertex ) - _Mesh.FirstVertex;
+			}
+		}
+
+		if ( m_IndicesCount == FirstIndex )
+			continue;	// Unused slot
+
+		ReserveSubMeshes( m_SubMeshesCount + 1 );
+		SubMesh&	S = m_pSubMeshes[m_SubMeshesCount++];
+		S.MaterialIndex = _Source.GetNodeMaterial( _NodeIndex, SlotIndex );
+		S.FirstIndex = FirstIndex;
+		S.IndicesCount = m_IndicesCount - FirstIndex;
+		_Mesh.SubMeshesCount++;
+	}
+	_Mesh.VerticesCount = m_VerticesCount - _Mesh.FirstVertex;
+
+	m_Statistics.ControlPointsCount += SrcMesh.ControlPointsCount;
+	m_Statistics.PolygonsCount += SrcMesh.PolygonsCount;
+	m_Statistics.TrianglesCount += TrianglesCount;
+
+	delete[] pVertex;
+	delete[] pSlotCursors;
+	delete[] pSortedTriangles;
+	delete[] pTriangleSlots;
+	delete[] pSlotStarts;
+	delete[] pTrianglePolygons;
+	delete[] pTriangleCorners;
+	for ( int ElementIndex=0; ElementIndex < ElementsCount; ElementIndex++ )
+	{
+		delete[] pElements[ElementIndex].pValues;
+		delete[] pElements[ElementIndex].pIndices;
+	}
+	delete[] Materials.pIndices;
+	delete[] pPolygonVertices;
+	delete[] pPolygonSizes;
+	delete[] pPositions;
+}
+
+int		SceneSourceConverter::ResolveElements( const SceneSource& _Source, int _NodeIndex, int _LayerElementsCount, ResolvedElement* _pElements, ResolvedElement& _Materials )
+{
+	static const int						ATTRIBUTES[MAX_ATTRIBUTES] = { ATTRIBUTE_NORMAL, ATTRIBUTE_TANGENT, ATTRIBUTE_BINORMAL, ATTRIBUTE_UV0, ATTRIBUTE_UV1, ATTRIBUTE_COLOR };
+	static const SourceLayerElement::TYPE	TYPES[MAX_ATTRIBUTES] = { SourceLayerElement::TYPE_NORMAL, SourceLayerElement::TYPE_TANGENT, SourceLayerElement::TYPE_BINORMAL, SourceLayerElement::TYPE_UV, SourceLayerElement::TYPE_UV, SourceLayerElement::TYPE_VERTEX_COLOR };
+	static const int						CHANNELS[MAX_ATTRIBUTES] = { 0, 0, 0, 0, 1, 0 };
+	static const int						SIZES[MAX_ATTRIBUTES] = { 3, 3, 3, 2, 2, 4 };
+
+	SourceLayerElement*	pSourceElements = new SourceLayerElement[_LayerElementsCount > 0 ? _LayerElementsCount : 1];
+	for ( int ElementIndex=0; ElementIndex < _LayerElementsCount; ElementIndex++ )
+		_Source.GetLayerElement( _NodeIndex, ElementIndex, pSourceElements[ElementIndex] );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Vertex attributes
+	int	ElementsCount = 0;
+	int	Offset = 3;
+	for ( int AttributeIndex=0; AttributeIndex < MAX_ATTRIBUTES; AttributeIndex++ )
+	{
+		if ( (m_Attributes & ATTRIBUTES[AttributeIndex]) == 0 )
+			continue;
+
+		ResolvedElement&	Element = _pElements[ElementsCount++];
+		memset( &Element, 0, sizeof(ResolvedElement) );
+		Element.Offset = Offset;
+		Element.Size = SIZES[AttributeIndex];
+		Offset += Element.Size;
+
+		for ( int ElementIndex=0; ElementIndex < _LayerElementsCount; ElementIndex++ )
+		{
+			const SourceLayerElement&	Source = pSourceElements[ElementIndex];
+			if ( Source.Type != TYPES[AttributeIndex] || Source.Channel != CHANNELS[AttributeIndex] )
+				continue;
+
+			Element.Mapping = Source.Mapping;
+			Element.Reference = Source.Reference;
+			Element.ComponentsCount = Source.ComponentsCount;
+			Element.pValues = new float[Source.ValuesCount * Source.ComponentsCount];
+			Element.pIndices = Source.Reference == SourceLayerElement::REFERENCE_INDEX_TO_DIRECT ? new int[Source.IndicesCount] : NULL;
+			_Source.GetLayerElementData( _NodeIndex, ElementIndex, Element.pValues, Element.pIndices );
+			if ( Element.ComponentsCount == 3 )
+				m_AxisConversion.TransformVectors( Element.pValues, Source.ValuesCount );	// Normals, tangents & binormals
+			break;
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Materials
+	memset( &_Materials, 0, sizeof(ResolvedElement) );
+	for ( int ElementIndex=0; ElementIndex < _LayerElementsCount; ElementIndex++ )
+	{
+		const SourceLayerElement&	Source = pSourceElements[ElementIndex];
+		if ( Source.Type != SourceLayerElement::TYPE_MATERIAL || Source.IndicesCount == 0 )
+			continue;
+
+		_Materials.Mapping = Source.Mapping;
+		_Materials.Reference = Source.Reference;
+		_Materials.pIndices = new int[Source.IndicesCount];
+		_Source.GetLayerElementData( _NodeIndex, ElementIndex, NULL, _Materials.pIndices );
+		break;
+	}
+
+	delete[] pSourceElements;
+
+	return ElementsCount;
+}
+
+void	SceneSourceConverter::BuildVertex( const float* _pPositions, const int* _pPolygonVertices, const ResolvedElement* _pElements, int _ElementsCount, int _PolygonIndex, int _PolygonVertexIndex, float* _pVertex ) const
+{
+	int	ControlPointIndex = _pPolygonVertices[_PolygonVertexIndex];
+	_pVertex[0] = _pPositions[3*ControlPointIndex+0];
+	_pVertex[1] = _pPositions[3*ControlPointIndex+1];
+	_pVertex[2] = _pPositions[3*ControlPointIndex+2];
+
+	for ( int ElementIndex=0; ElementIndex < _ElementsCount; ElementIndex++ )
+	{
+		const ResolvedElement&	Element = _pElements[ElementIndex];
+		float*					pTarget = _pVertex + Element.Offset;
+
+		int	CopyCount = 0;
+		if ( Element.pValues != NULL )
+		{
+			int	MapIndex = 0;
+			switch ( Element.Mapping )
+			{
+			case SourceLayerElement::MAPPING_BY_CONTROL_POINT:	MapIndex = ControlPointIndex; break;
+			case SourceLayerElement::MAPPING_BY_POLYGON_VERTEX:	MapIndex = _PolygonVertexIndex; break;
+			case SourceLayerElement::MAPPING_BY_POLYGON:		MapIndex = _PolygonIndex; break;
+			default:											MapIndex = 0; break;
+			}
+			if ( Element.pIndices != NULL )
+				MapIndex = Element.pIndices[MapIndex];
+
+			CopyCount = Element.ComponentsCount < Element.Size ? Element.ComponentsCount : Element.Size;
+			const float*	pSource = Element.pValues + Element.ComponentsCount * MapIndex;
+			for ( int ComponentIndex=0; ComponentIndex < CopyCount; ComponentIndex++ )
+				pTarget[ComponentIndex] = pSource[ComponentIndex];
+		}
+
+		// Missing components default to 0 except for colors that default to opaque white
+		float	Default = Element.Size == 4 ? 1.0f : 0.0f;
+		for ( int ComponentIndex=CopyCount; ComponentIndex < Element.Size; ComponentIndex++ )
+			pTarget[ComponentIndex] = Default;
+	}
+}
+
+int		SceneSourceConverter::WeldVertex( const float* _pVertex, int _FirstVertex )
+{
+	unsigned int	Mask = m_WeldTableSize - 1;
+	unsigned int	Slot = HashVertex( _pVertex, m_VertexStride ) & Mask;
+	size_t			VertexSize = m_VertexStride * sizeof(float);
+	while ( m_pWeldTable[Slot] != -1 )
+	{
+		int	VertexIndex = m_pWeldTable[Slot];
+		if ( memcmp( m_pVertices + m_VertexStride * VertexIndex, _pVertex, VertexSize ) == 0 )
+			return VertexIndex;	// Found an identical vertex
+		Slot = (Slot + 1) & Mask;
+	}
+
+	// Append a new vertex
+	ReserveVertices( m_VerticesCount + 1 );
+	int	VertexIndex = m_VerticesCount++;
+	memcpy( m_pVertices + m_VertexStride * VertexIndex, _pVertex, VertexSize );
+	m_pWeldTable[Slot] = VertexIndex;
+
+	// Keep the table at most half full
+	if ( 2 * (m_VerticesCount - _FirstVertex) > m_WeldTableSize )
+		ResizeWeldTable( 2 * m_WeldTableSize, _FirstVertex );
+
+	return VertexIndex;
+}
+
+void	SceneSourceConverter::ResizeWeldTable( int _Size, int _FirstVertex )
+{
+	if ( _Size > m_WeldTableSize )
+	{
+		delete[] m_pWeldTable;
+		m_pWeldTable = new int[_Size];
+		m_WeldTableSize = _Size;
+	}
+	memset( m_pWeldTable, 0xFF, m_WeldTableSize * sizeof(int) );
+
+	// Re-insert the vertices of the current mesh
+	unsigned int	Mask = m_WeldTableSize - 1;
+	for ( int VertexIndex=_FirstVertex; VertexIndex < m_VerticesCount; VertexIndex++ )
+	{
+		unsigned int	Slot = HashVertex( m_pVertices + m_VertexStride * VertexIndex, m_VertexStride ) & Mask;
+		while ( m_pWeldTable[Slot] != -1 )
+			Slot = (Slot + 1) & Mask;
+		m_pWeldTable[Slot] = VertexIndex;
+	}
+}
+
+void	SceneSourceConverter::ConvertAnimations( const SceneSource& _Source )
+{
+	float	Duration = _Source.GetAnimationDuration();
+	if ( Duration <= 0.0f )
+		return;
+
+	m_FramesCount = 1 + (int) floor( Duration * m_AnimationSampleRate + 1e-3f );
+
+	int	NodesCount = _Source.GetNodesCount();
+	int	AnimatedNodesCount = 0;
+	for ( int NodeIndex=0; NodeIndex < NodesCount; NodeIndex++ )
+		if ( _Source.GetCurvesCount( NodeIndex ) > 0 )
+			AnimatedNodesCount++;
+
+	m_pAnimatedNodes = new int[AnimatedNodesCount];
+	m_pAnimationValues = new float[AnimatedNodesCount * m_FramesCount * ANIMATION_VALUES_PER_FRAME];
+
+	int		KeysCapacity = 0;
+	float*	pTimes = NULL;
+	float*	pValues = NULL;
+
+	SourceNode	Node;
+	SourceCurve	Curve;
+	for ( int NodeIndex=0; NodeIndex < NodesCount; NodeIndex++ )
+	{
+		int	CurvesCount = _Source.GetCurvesCount( NodeIndex );
+		if ( CurvesCount == 0 )
+			continue;
+
+		int		AnimatedIndex = m_Statistics.AnimatedNodesCount++;
+		float*	pFrames = m_pAnimationValues + AnimatedIndex * m_FramesCount * ANIMATION_VALUES_PER_FRAME;
+		m_pAnimatedNodes[AnimatedIndex] = NodeIndex;
+
+		// Channels that are not animated keep the static transform
+		_Source.GetNode( NodeIndex, Node );
+		for ( int FrameIndex=0; FrameIndex < m_FramesCount; FrameIndex++ )
+		{
+			float*	pFrame = pFrames + FrameIndex * ANIMATION_VALUES_PER_FRAME;
+			for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+			{
+				pFrame[0+ComponentIndex] = Node.Translation[ComponentIndex];
+				pFrame[3+ComponentIndex] = DEG2RAD * Node.Rotation[ComponentIndex];
+				pFrame[6+ComponentIndex] = Node.Scaling[ComponentIndex];
+			}
+		}
+
+		// Sample the curves
+		for ( int CurveIndex=0; CurveIndex < CurvesCount; CurveIndex++ )
+		{
+			_Source.GetCurve( NodeIndex, CurveIndex, Curve );
+			if ( Curve.KeysCount == 0 )
+				continue;
+
+			if ( Curve.KeysCount > KeysCapacity )
+			{
+				delete[] pTimes;
+				delete[] pValues;
+				KeysCapacity = Curve.KeysCount;
+				pTimes = new float[KeysCapacity];
+				pValues = new float[KeysCapacity];
+			}
+			_Source.GetCurveKeys( NodeIndex, CurveIndex, pTimes, pValues );
+
+			float	Factor = Curve.Channel >= SourceCurve::CHANNEL_ROTATION_X && Curve.Channel <= SourceCurve::CHANNEL_ROTATION_Z ? DEG2RAD : 1.0f;
+			int		Cursor = 0;
+			for ( int FrameIndex=0; FrameIndex < m_FramesCount; FrameIndex++ )
+			{
+				float	Time = FrameIndex / m_AnimationSampleRate;
+				while ( Cursor < Curve.KeysCount-1 && pTimes[Cursor+1] <= Time )
+					Cursor++;
+
+				float	Value = pValues[Cursor];
+				if ( Cursor < Curve.KeysCount-1 && Time > pTimes[Cursor] )
+				{
+					float	t = (Time - pTimes[Cursor]) / (pTimes[Cursor+1] - pTimes[Cursor]);
+					Value += t * (pValues[Cursor+1] - pValues[Cursor]);
+				}
+
+				pFrames[FrameIndex * ANIMATION_VALUES_PER_FRAME + Curve.Channel] = Factor * Value;
+			}
+		}
+
+		m_AxisConversion.TransformFrames( pFrames, m_FramesCount );
+	}
+
+	delete[] pTimes;
+	delete[] pValues;
+
+	m_Statistics.FramesCount = m_FramesCount;
+}
+
+void	SceneSourceConverter::ReserveVertices( int _Count )
+{
+	if ( _Count <= m_VerticesCapacity )
+		return;
+
+	int	Capacity = 2 * m_VerticesCapacity;
+	if ( Capacity < _Count )
+		Capacity = _Count;
+	if ( Capacity < 1024 )
+		Capacity = 1024;
+
+	float*	pVertices = new float[Capacity * m_VertexStride];
+	if ( m_pVertices != NULL )
+		memcpy( pVertices, m_pVertices, m_VerticesCount * m_VertexStride * sizeof(float) );
+	delete[] m_pVertices;
+	m_pVertices = pVertices;
+	m_VerticesCapacity = Capacity;
+}
+
+void	SceneSourceConverter::ReserveIndices( int _Count )
+{
+	if ( _Count <= m_IndicesCapacity )
+		return;
+
+	int	Capacity = 2 * m_IndicesCapacity;
+	if ( Capacity < _Count )
+		Capacity = _Count;
+
+	unsigned int*	pIndices = new unsigned int[Capacity];
+	if ( m_pIndices != NULL )
+		memcpy( pIndices, m_pIndices, m_IndicesCount * sizeof(unsigned int) );
+	delete[] m_pIndices;
+	m_pIndices = pIndices;
+	m_IndicesCapacity = Capacity;
+}
+
+void	SceneSourceConverter::ReserveSubMeshes( int _Count )
+{
+	if ( _Count <= m_SubMeshesCapacity )
+		return;
+
+	int	Capacity = 2 * m_SubMeshesCapacity;
+	if ( Capacity < _Count )
+		Capacity = _Count;
+	if ( Capacity < 16 )
+		Capacity = 16;
+
+	SubMesh*	pSubMeshes = new SubMesh[Capacity];
+	if ( m_pSubMeshes != NULL )
+		memcpy( pSubMeshes, m_pSubMeshes, m_SubMeshesCount * sizeof(SubMesh) );
+	delete[] m_pSubMeshes;
+	m_pSubMeshes = pSubMeshes;
+	m_SubMeshesCapacity = Capacity;
+}
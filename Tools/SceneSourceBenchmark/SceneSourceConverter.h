@@ -0,0 +1,173 @@
+// Contains the native conversion of a scene source into welded vertex & index buffers and sampled animations
+//
+#pragma once
+
+#include "SceneSource.h"
+#include "AxisConversion.h"
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Converts any scene source into GPU-ready data, without depending on the FBX SDK, to benchmark the native kernels :
+	//	_ Polygons are triangulated as fans (they are assumed to be convex, like NodeMesh does)
+	//	_ Layer elements are resolved for every triangle corner according to their mapping & reference modes
+	//	_ Corners with identical attributes are welded into unique vertices & triangles are grouped by material
+	//	_ Animation curves are sampled at a fixed rate into P, R & S values
+	//	_ Positions, normals, tangents, binormals & animations are converted by the axis conversion (none by default), reversing
+	//		the winding of the triangles when it changes the handedness
+	//
+	// Vertices are arrays of floats: the position followed by the requested attributes in the order of VERTEX_ATTRIBUTE.
+	// Attributes missing from a mesh are written with default values (zero vectors & UVs, white colors).
+	//
+	// NOTE: This is NOT the importer's path: imported scenes are read from the SDK by Scene & NodeMesh, so the timings of the
+	//	benchmark only measure this converter on synthetic & mesh file sources, not the import of FBX files.
+	//
+	class	SceneSourceConverter
+	{
+	public:		// NESTED TYPES
+
+		enum	VERTEX_ATTRIBUTE
+		{
+			ATTRIBUTE_NORMAL	= 0x01,		// 3 floats
+			ATTRIBUTE_TANGENT	= 0x02,		// 3 floats
+			ATTRIBUTE_BINORMAL	= 0x04,		// 3 floats
+			ATTRIBUTE_UV0		= 0x08,		// 2 floats
+			ATTRIBUTE_UV1		= 0x10,		// 2 floats
+			ATTRIBUTE_COLOR		= 0x20,		// 4 floats
+		};
+
+		static const int	ANIMATION_VALUES_PER_FRAME = 9;	// Translation, rotation (radians) & scaling
+
+		struct	Mesh
+		{
+			int		NodeIndex;
+			int		FirstVertex;
+			int		VerticesCount;
+			int		FirstSubMesh;
+			int		SubMeshesCount;
+		};
+
+		// A range of triangles sharing a material, indices are relative to the first vertex of the mesh
+		struct	SubMesh
+		{
+			int		MaterialIndex;		// Scene material (-1 if none)
+			int		FirstIndex;
+			int		IndicesCount;
+		};
+
+		struct	Statistics
+		{
+			int			NodesCount;
+			int			MeshesCount;
+			int			MaterialsCount;
+			int			ControlPointsCount;
+			int			PolygonsCount;
+			int			TrianglesCount;
+			int			VerticesCount;		// After welding
+			int			AnimatedNodesCount;
+			int			FramesCount;
+			long long	VertexBytes;
+			long long	IndexBytes;
+			long long	AnimationBytes;
+		};
+
+	protected:
+
+		// A layer element resolved for a vertex attribute
+		struct	ResolvedElement
+		{
+			float*		pValues;
+			int*		pIndices;
+			int			Mapping;
+			int			Reference;
+			int			ComponentsCount;	// Components available in the element
+			int			Offset;				// Offset of the attribute in the vertex
+			int			Size;				// Floats of the attribute
+		};
+
+		static const int	MAX_ATTRIBUTES = 6;
+
+	protected:	// FIELDS
+
+		int					m_Attributes;
+		int					m_VertexStride;		// In floats
+		float				m_AnimationSampleRate;
+		AxisConversion		m_AxisConversion;
+
+		float*				m_pVertices;
+		int					m_VerticesCount;
+		int					m_VerticesCapacity;
+		unsigned int*		m_pIndices;
+		int					m_IndicesCount;
+		int					m_IndicesCapacity;
+
+		Mesh*				m_pMeshes;
+		int					m_MeshesCount;
+		SubMesh*			m_pSubMeshes;
+		int					m_SubMeshesCount;
+		int					m_SubMeshesCapacity;
+
+		int*				m_pAnimatedNodes;
+		float*				m_pAnimationValues;	// FramesCount * ANIMATION_VALUES_PER_FRAME values per animated node
+		int					m_FramesCount;
+
+		// Welding hash table (indices of vertices, -1 for empty slots)
+		int*				m_pWeldTable;
+		int					m_WeldTableSize;	// Power of 2
+
+		Statistics			m_Statistics;
+
+	public:		// PROPERTIES
+
+		int					GetVertexStride() const			{ return m_VertexStride; }
+		const float*		GetVertices() const				{ return m_pVertices; }
+		int					GetVerticesCount() const		{ return m_VerticesCount; }
+		const unsigned int*	GetIndices() const				{ return m_pIndices; }
+		int					GetIndicesCount() const			{ return m_IndicesCount; }
+		const Mesh*			GetMeshes() const				{ return m_pMeshes; }
+		int					GetMeshesCount() const			{ return m_MeshesCount; }
+		const SubMesh*		GetSubMeshes() const			{ return m_pSubMeshes; }
+		int					GetSubMeshesCount() const		{ return m_SubMeshesCount; }
+		const int*			GetAnimatedNodes() const		{ return m_pAnimatedNodes; }
+		const float*		GetAnimationValues() const		{ return m_pAnimationValues; }
+		int					GetAnimatedNodesCount() const	{ return m_Statistics.AnimatedNodesCount; }
+		int					GetFramesCount() const			{ return m_FramesCount; }
+		const Statistics&	GetStatistics() const			{ return m_Statistics; }
+
+		// Sets the conversion applied by the next conversions
+		void				SetAxisConversion( const AxisConversion& _AxisConversion )	{ m_AxisConversion = _AxisConversion; }
+
+	public:		// METHODS
+
+		// _Attributes, a combination of VERTEX_ATTRIBUTE flags
+		// _AnimationSampleRate, in frames per second (0 to skip animations)
+		SceneSourceConverter( int _Attributes, float _AnimationSampleRate );
+		~SceneSourceConverter();
+
+		// Converts the whole source, replacing the result of any previous conversion
+		void	Convert( const SceneSource& _Source );
+
+		// Releases the result of the last conversion
+		void	Clear();
+
+	protected:
+
+		void	ConvertMesh( const SceneSource& _Source, int _NodeIndex, Mesh& _Mesh );
+		void	ConvertAnimations( const SceneSource& _Source );
+
+		int		ResolveElements( const SceneSource& _Source, int _NodeIndex, int _LayerElementsCount, ResolvedElement* _pElements, ResolvedElement& _Materials );
+		void	BuildVertex( const float* _pPositions, const int* _pPolygonVertices, const ResolvedElement* _pElements, int _ElementsCount, int _PolygonIndex, int _PolygonVertexIndex, float* _pVertex ) const;
+
+		// Returns the index of an existing identical vertex of the current mesh or appends a new one
+		int		WeldVertex( const float* _pVertex, int _FirstVertex );
+		void	ResizeWeldTable( int _Size, int _FirstVertex );
+
+		void	ReserveVertices( int _Count );
+		void	ReserveIndices( int _Count );
+		void	ReserveSubMeshes( int _Count );
+
+	private:
+		SceneSourceConverter( const SceneSourceConverter& );
+		SceneSourceConverter&	operator=( const SceneSourceConverter& );
+	};
+}
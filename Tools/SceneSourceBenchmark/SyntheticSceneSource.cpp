@@ -0,0 +1,524 @@
+// Native synthetic scene generator
+// Builds meshes, hierarchies, materials & animation curves deterministically from a description, without any file
+//
+#ifdef _MANAGED
+#pragma unmanaged
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "SyntheticSceneSource.h"
+
+using namespace	FBXImporter;
+
+static const float	TWO_PI = 6.283185307f;
+static const float	DISPLACEMENT_AMPLITUDE = 0.25f;
+static const float	DISPLACEMENT_FREQUENCY_X = 0.37f;
+static const float	DISPLACEMENT_FREQUENCY_Y = 0.23f;
+static const float	NODES_SPACING = 10.0f;
+
+// Hashes an integer into a well distributed integer (Thomas Wang's 32-bit mix)
+static unsigned int	HashInteger( unsigned int _Value )
+{
+	_Value = (_Value ^ 61) ^ (_Value >> 16);
+	_Value *= 9;
+	_Value ^= _Value >> 4;
+	_Value *= 0x27D4EB2D;
+	_Value ^= _Value >> 15;
+	return _Value;
+}
+
+SyntheticSceneSource::SyntheticSceneSource( const SyntheticSceneDesc& _Desc ) : m_Desc( _Desc ), m_LayerElementsCount( 0 )
+{
+	// Sanitize the description
+	if ( m_Desc.MeshesCount < 0 )
+		m_Desc.MeshesCount = 0;
+	if ( m_Desc.TrianglesCount < m_Desc.MeshesCount )
+		m_Desc.TrianglesCount = m_Desc.MeshesCount;	// At least a triangle per mesh
+	if ( m_Desc.NodesCount < m_Desc.MeshesCount + 1 )
+		m_Desc.NodesCount = m_Desc.MeshesCount + 1;
+	if ( m_Desc.AnimatedNodesCount > m_Desc.NodesCount - 1 )
+		m_Desc.AnimatedNodesCount = m_Desc.NodesCount - 1;
+	if ( m_Desc.MaterialsCount < 1 )
+		m_Desc.MaterialsCount = 1;
+	if ( m_Desc.MaterialsPerMeshCount < 1 )
+		m_Desc.MaterialsPerMeshCount = 1;
+	if ( m_Desc.MaterialsPerMeshCount > m_Desc.MaterialsCount )
+		m_Desc.MaterialsPerMeshCount = m_Desc.MaterialsCount;
+	if ( m_Desc.UVChannelsCount > 4 )
+		m_Desc.UVChannelsCount = 4;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Build the names
+	m_pNodeNames = new char[NAME_LENGTH * m_Desc.NodesCount];
+	for ( int NodeIndex=0; NodeIndex < m_Desc.NodesCount; NodeIndex++ )
+	{
+		char*	pName = m_pNodeNames + NAME_LENGTH * NodeIndex;
+		if ( NodeIndex == 0 )
+			sprintf( pName, "Root" );
+		else if ( IsMesh( NodeIndex ) )
+			sprintf( pName, "Mesh%d", NodeIndex-1 );
+		else
+			sprintf( pName, "Node%d", NodeIndex );
+	}
+
+	m_pMaterialNames = new char[NAME_LENGTH * m_Desc.MaterialsCount];
+	for ( int MaterialIndex=0; MaterialIndex < m_Desc.MaterialsCount; MaterialIndex++ )
+		sprintf( m_pMaterialNames + NAME_LENGTH * MaterialIndex, "Material%d", MaterialIndex );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Build the layer elements shared by all the meshes
+	if ( m_Desc.bNormals )
+		AddLayerElement( SourceLayerElement::TYPE_NORMAL, 0, 3, m_Desc.NormalsMapping, m_Desc.Reference );
+	if ( m_Desc.bTangents )
+	{
+		AddLayerElement( SourceLayerElement::TYPE_TANGENT, 0, 3, m_Desc.NormalsMapping, m_Desc.Reference );
+		AddLayerElement( SourceLayerElement::TYPE_BINORMAL, 0, 3, m_Desc.NormalsMapping, m_Desc.Reference );
+	}
+	for ( int UVChannelIndex=0; UVChannelIndex < m_Desc.UVChannelsCount; UVChannelIndex++ )
+		AddLayerElement( SourceLayerElement::TYPE_UV, UVChannelIndex, 2, m_Desc.UVsMapping, m_Desc.Reference );
+	if ( m_Desc.bColors )
+		AddLayerElement( SourceLayerElement::TYPE_VERTEX_COLOR, 0, 4, m_Desc.UVsMapping, m_Desc.Reference );
+
+	// Materials are always indexed
+	if ( m_Desc.MaterialsPerMeshCount > 1 )
+		AddLayerElement( SourceLayerElement::TYPE_MATERIAL, 0, 0, SourceLayerElement::MAPPING_BY_POLYGON, SourceLayerElement::REFERENCE_INDEX_TO_DIRECT );
+	else
+		AddLayerElement( SourceLayerElement::TYPE_MATERIAL, 0, 0, SourceLayerElement::MAPPING_ALL_SAME, SourceLayerElement::REFERENCE_INDEX_TO_DIRECT );
+}
+
+SyntheticSceneSource::~SyntheticSceneSource()
+{
+	delete[] m_pNodeNames;
+	delete[] m_pMaterialNames;
+}
+
+void	SyntheticSceneSource::AddLayerElement( SourceLayerElement::TYPE _Type, int _Channel, int _ComponentsCount, SourceLayerElement::MAPPING _Mapping, SourceLayerElement::REFERENCE _Reference )
+{
+	SourceLayerElement&	Element = m_pLayerElements[m_LayerElementsCount++];
+	Element.Type = _Type;
+	Element.Mapping = _Mapping;
+	Element.Reference = _Reference;
+	Element.Channel = _Channel;
+	Element.ComponentsCount = _ComponentsCount;
+	Element.ValuesCount = 0;	// Depend on the mesh
+	Element.IndicesCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Nodes
+//
+// Every NODES_PER_GROUP-th node is a group parented to the root and the nodes that follow are its children,
+//	which keeps the depth-first order. The first nodes after the root hold the meshes.
+//
+int		SyntheticSceneSource::GetNodesCount() const
+{
+	return m_Desc.NodesCount;
+}
+
+void	SyntheticSceneSource::GetNode( int _NodeIndex, SourceNode& _Node ) const
+{
+	_Node.pName = m_pNodeNames + NAME_LENGTH * _NodeIndex;
+	_Node.Type = IsMesh( _NodeIndex ) ? SourceNode::TYPE_MESH : SourceNode::TYPE_GENERIC;
+	_Node.MaterialsCount = IsMesh( _NodeIndex ) ? m_Desc.MaterialsPerMeshCount : 0;
+
+	_Node.Rotation[0] = _Node.Rotation[1] = _Node.Rotation[2] = 0.0f;
+	_Node.Scaling[0] = _Node.Scaling[1] = _Node.Scaling[2] = 1.0f;
+
+	if ( _NodeIndex == 0 )
+	{
+		_Node.ParentIndex = -1;
+		_Node.Translation[0] = _Node.Translation[1] = _Node.Translation[2] = 0.0f;
+		return;
+	}
+
+	int	IndexInGroup = (_NodeIndex-1) % NODES_PER_GROUP;
+	if ( IndexInGroup == 0 )
+	{	// Groups are laid out on a grid
+		int	GroupIndex = (_NodeIndex-1) / NODES_PER_GROUP;
+		_Node.ParentIndex = 0;
+		_Node.Translation[0] = NODES_SPACING * (GroupIndex & 0x1F);
+		_Node.Translation[1] = NODES_SPACING * (GroupIndex >> 5);
+		_Node.Translation[2] = 0.0f;
+	}
+	else
+	{	// Children are stacked above their group
+		_Node.ParentIndex = _NodeIndex - IndexInGroup;
+		_Node.Translation[0] = 0.0f;
+		_Node.Translation[1] = 0.0f;
+		_Node.Translation[2] = (float) IndexInGroup;
+	}
+}
+
+int		SyntheticSceneSource::GetNodeMaterial( int _NodeIndex, int _SlotIndex ) const
+{
+	if ( !IsMesh( _NodeIndex ) || _SlotIndex < 0 || _SlotIndex >= m_Desc.MaterialsPerMeshCount )
+		return -1;
+
+	return (_NodeIndex - 1 + _SlotIndex) % m_Desc.MaterialsCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Materials
+int		SyntheticSceneSource::GetMaterialsCount() const
+{
+	return m_Desc.MaterialsCount;
+}
+
+void	SyntheticSceneSource::GetMaterial( int _MaterialIndex, SourceMaterial& _Material ) const
+{
+	unsigned int	Hash = HashInteger( m_Desc.Seed ^ (0x9E3779B9 * (_MaterialIndex+1)) );
+
+	_Material.pName = m_pMaterialNames + NAME_LENGTH * _MaterialIndex;
+	_Material.DiffuseColor[0] = ((Hash >> 0) & 0xFF) / 255.0f;
+	_Material.DiffuseColor[1] = ((Hash >> 8) & 0xFF) / 255.0f;
+	_Material.DiffuseColor[2] = ((Hash >> 16) & 0xFF) / 255.0f;
+	_Material.DiffuseFactor = 1.0f;
+	_Material.EmissiveColor[0] = _Material.EmissiveColor[1] = _Material.EmissiveColor[2] = 0.0f;
+	_Material.EmissiveFactor = 0.0f;
+	_Material.SpecularColor[0] = _Material.SpecularColor[1] = _Material.SpecularColor[2] = 1.0f;
+	_Material.SpecularFactor = 0.5f;
+	_Material.Shininess = 4.0f + ((Hash >> 24) & 0x3F);
+	_Material.Opacity = 1.0f;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Meshes
+void	SyntheticSceneSource::GetMeshLayout( int _NodeIndex, MeshLayout& _Layout ) const
+{
+	int	MeshIndex = _NodeIndex - 1;
+
+	// Split the triangles evenly, the first meshes get the remainder
+	_Layout.TrianglesCount = m_Desc.TrianglesCount / m_Desc.MeshesCount + (MeshIndex < m_Desc.TrianglesCount % m_Desc.MeshesCount ? 1 : 0);
+
+	// A cell holds a quad or 2 triangles, the last cell may hold a single triangle
+	int	CellsCount = (_Layout.TrianglesCount + 1) / 2;
+	_Layout.CellsX = (int) ceil( sqrt( (double) CellsCount ) );
+	_Layout.CellsY = (CellsCount + _Layout.CellsX - 1) / _Layout.CellsX;
+
+	bool	bOddTriangle = (_Layout.TrianglesCount & 1) != 0;
+	if ( m_Desc.bQuads )
+	{
+		_Layout.PolygonsCount = CellsCount;
+		_Layout.PolygonVerticesCount = bOddTriangle ? 4 * (CellsCount-1) + 3 : 4 * CellsCount;
+	}
+	else
+	{
+		_Layout.PolygonsCount = _Layout.TrianglesCount;
+		_Layout.PolygonVerticesCount = 3 * _Layout.TrianglesCount;
+	}
+
+	_Layout.Phase = (HashInteger( m_Desc.Seed + 0x3C6EF372 * (MeshIndex+1) ) & 0xFFFF) * (TWO_PI / 65536.0f);
+}
+
+int		SyntheticSceneSource::GetPolygonMaterialSlot( int _PolygonIndex ) const
+{
+	return HashInteger( m_Desc.Seed ^ _PolygonIndex ) % m_Desc.MaterialsPerMeshCount;
+}
+
+void	SyntheticSceneSource::GetMesh( int _NodeIndex, SourceMesh& _Mesh ) const
+{
+	if ( !IsMesh( _NodeIndex ) )
+	{
+		memset( &_Mesh, 0, sizeof(SourceMesh) );
+		return;
+	}
+
+	MeshLayout	Layout;
+	GetMeshLayout( _NodeIndex, Layout );
+
+	_Mesh.ControlPointsCount = (Layout.CellsX+1) * (Layout.CellsY+1);
+	_Mesh.PolygonsCount = Layout.PolygonsCount;
+	_Mesh.PolygonVerticesCount = Layout.PolygonVerticesCount;
+	_Mesh.LayerElementsCount = m_LayerElementsCount;
+}
+
+void	SyntheticSceneSource::GetControlPoints( int _NodeIndex, float* _pPositions ) const
+{
+	MeshLayout	Layout;
+	GetMeshLayout( _NodeIndex, Layout );
+
+	for ( int Y=0; Y <= Layout.CellsY; Y++ )
+		for ( int X=0; X <= Layout.CellsX; X++ )
+		{
+			*_pPositions++ = (float) X;
+			*_pPositions++ = (float) Y;
+			*_pPositions++ = DISPLACEMENT_AMPLITUDE * sinf( DISPLACEMENT_FREQUENCY_X * X + Layout.Phase ) * cosf( DISPLACEMENT_FREQUENCY_Y * Y + Layout.Phase );
+		}
+}
+
+void	SyntheticSceneSource::FillPolygonVertices( const MeshLayout& _Layout, int* _pPolygonSizes, int* _pPolygonVertices ) const
+{
+	int	Stride = _Layout.CellsX + 1;
+	int	TrianglesLeft = _Layout.TrianglesCount;
+	for ( int CellIndex=0; TrianglesLeft > 0; CellIndex++ )
+	{
+		int	X = CellIndex % _Layout.CellsX;
+		int	Y = CellIndex / _Layout.CellsX;
+		int	V00 = Stride * Y + X;
+		int	V10 = V00 + 1;
+		int	V11 = V10 + Stride;
+		int	V01 = V00 + Stride;
+
+		if ( TrianglesLeft == 1 )
+		{	// Last odd triangle
+			if ( _pPolygonSizes != NULL )
+				*_pPolygonSizes++ = 3;
+			*_pPolygonVertices++ = V00;
+			*_pPolygonVertices++ = V10;
+			*_pPolygonVertices++ = V11;
+			TrianglesLeft = 0;
+		}
+		else if ( m_Desc.bQuads )
+		{
+			if ( _pPolygonSizes != NULL )
+				*_pPolygonSizes++ = 4;
+			*_pPolygonVertices++ = V00;
+			*_pPolygonVertices++ = V10;
+			*_pPolygonVertices++ = V11;
+			*_pPolygonVertices++ = V01;
+			TrianglesLeft -= 2;
+		}
+		else
+		{
+			if ( _pPolygonSizes != NULL )
+			{
+				*_pPolygonSizes++ = 3;
+				*_pPolygonSizes++ = 3;
+			}
+			*_pPolygonVertices++ = V00;
+			*_pPolygonVertices++ = V10;
+			*_pPolygonVertices++ = V11;
+			*_pPolygonVertices++ = V00;
+			*_pPolygonVertices++ = V11;
+			*_pPolygonVertices++ = V01;
+			TrianglesLeft -= 2;
+		}
+	}
+}
+
+void	SyntheticSceneSource::GetPolygons( int _NodeIndex, int* _pPolygonSizes, int* _pPolygonVertices ) const
+{
+	MeshLayout	Layout;
+	GetMeshLayout( _NodeIndex, Layout );
+	FillPolygonVertices( Layout, _pPolygonSizes, _pPolygonVertices );
+}
+
+void	SyntheticSceneSource::GetLayerElement( int _NodeIndex, int _ElementIndex, SourceLayerElement& _Element ) const
+{
+	MeshLayout	Layout;
+	GetMeshLayout( _NodeIndex, Layout );
+
+	_Element = m_pLayerElements[_ElementIndex];
+
+	int	MappedCount = 0;
+	switch ( _Element.Mapping )
+	{
+	case SourceLayerElement::MAPPING_BY_CONTROL_POINT:	MappedCount = (Layout.CellsX+1) * (Layout.CellsY+1); break;
+	case SourceLayerElement::MAPPING_BY_POLYGON_VERTEX:	MappedCount = Layout.PolygonVerticesCount; break;
+	case SourceLayerElement::MAPPING_BY_POLYGON:		MappedCount = Layout.PolygonsCount; break;
+	case SourceLayerElement::MAPPING_ALL_SAME:			MappedCount = 1; break;
+	}
+
+	if ( _Element.Type == SourceLayerElement::TYPE_MATERIAL )
+	{	// Indices into the material slots
+		_Element.ValuesCount = 0;
+		_Element.IndicesCount = MappedCount;
+	}
+	else if ( _Element.Reference == SourceLayerElement::REFERENCE_DIRECT )
+	{
+		_Element.ValuesCount = MappedCount;
+		_Element.IndicesCount = 0;
+	}
+	else
+	{	// Polygon vertices index the values of their control point (i.e. the usual layout of UVs in FBX files)
+		_Element.ValuesCount = _Element.Mapping == SourceLayerElement::MAPPING_BY_POLYGON_VERTEX ? (Layout.CellsX+1) * (Layout.CellsY+1) : MappedCount;
+		_Element.IndicesCount = MappedCount;
+	}
+}
+
+void	SyntheticSceneSource::ComputeValue( const MeshLayout& _Layout, const SourceLayerElement& _Element, int _ControlPointIndex, float* _pValue ) const
+{
+	int		X = _ControlPointIndex % (_Layout.CellsX+1);
+	int		Y = _ControlPointIndex / (_Layout.CellsX+1);
+	float	U = (float) X / _Layout.CellsX;
+	float	V = (float) Y / _Layout.CellsY;
+
+	// Derivatives of the displacement
+	float	dZdX = DISPLACEMENT_AMPLITUDE * DISPLACEMENT_FREQUENCY_X * cosf( DISPLACEMENT_FREQUENCY_X * X + _Layout.Phase ) * cosf( DISPLACEMENT_FREQUENCY_Y * Y + _Layout.Phase );
+	float	dZdY = -DISPLACEMENT_AMPLITUDE * DISPLACEMENT_FREQUENCY_Y * sinf( DISPLACEMENT_FREQUENCY_X * X + _Layout.Phase ) * sinf( DISPLACEMENT_FREQUENCY_Y * Y + _Layout.Phase );
+
+	switch ( _Element.Type )
+	{
+	case SourceLayerElement::TYPE_NORMAL:
+		{
+			float	InvLength = 1.0f / sqrtf( dZdX*dZdX + dZdY*dZdY + 1.0f );
+			_pValue[0] = -dZdX * InvLength;
+			_pValue[1] = -dZdY * InvLength;
+			_pValue[2] = InvLength;
+		}
+		break;
+
+	case SourceLayerElement::TYPE_TANGENT:
+		{
+			float	InvLength = 1.0f / sqrtf( 1.0f + dZdX*dZdX );
+			_pValue[0] = InvLength;
+			_pValue[1] = 0.0f;
+			_pValue[2] = dZdX * InvLength;
+		}
+		break;
+
+	case SourceLayerElement::TYPE_BINORMAL:
+		{
+			float	InvLength = 1.0f / sqrtf( 1.0f + dZdY*dZdY );
+			_pValue[0] = 0.0f;
+			_pValue[1] = InvLength;
+			_pValue[2] = dZdY * InvLength;
+		}
+		break;
+
+	case SourceLayerElement::TYPE_UV:
+		_pValue[0] = U * (1 + _Element.Channel);
+		_pValue[1] = V * (1 + _Element.Channel);
+		break;
+
+	case SourceLayerElement::TYPE_VERTEX_COLOR:
+		_pValue[0] = U;
+		_pValue[1] = V;
+		_pValue[2] = 0.5f;
+		_pValue[3] = 1.0f;
+		break;
+
+	default:
+		break;
+	}
+}
+
+void	SyntheticSceneSource::GetLayerElementData( int _NodeIndex, int _ElementIndex, float* _pValues, int* _pIndices ) const
+{
+	MeshLayout	Layout;
+	GetMeshLayout( _NodeIndex, Layout );
+
+	SourceLayerElement	Element;
+	GetLayerElement( _NodeIndex, _ElementIndex, Element );
+
+	//////////////////////////////////////////////////////////////////////////
+	// Materials only have slot indices
+	if ( Element.Type == SourceLayerElement::TYPE_MATERIAL )
+	{
+		for ( int PolygonIndex=0; PolygonIndex < Element.IndicesCount; PolygonIndex++ )
+			_pIndices[PolygonIndex] = Element.Mapping == SourceLayerElement::MAPPING_ALL_SAME ? 0 : GetPolygonMaterialSlot( PolygonIndex );
+		return;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Values of indexed polygon vertices are stored per control point, the indices being the polygon vertices themselves
+	if ( Element.Mapping == SourceLayerElement::MAPPING_BY_POLYGON_VERTEX && Element.Reference == SourceLayerElement::REFERENCE_INDEX_TO_DIRECT )
+	{
+		FillPolygonVertices( Layout, NULL, _pIndices );
+		for ( int ValueIndex=0; ValueIndex < Element.ValuesCount; ValueIndex++ )
+			ComputeValue( Layout, Element, ValueIndex, _pValues + Element.ComponentsCount * ValueIndex );
+		return;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Other elements store a value per mapped item, the control point of each value depending on the mapping
+	int*	pControlPoints = NULL;
+	switch ( Element.Mapping )
+	{
+	case SourceLayerElement::MAPPING_BY_POLYGON_VERTEX:
+		pControlPoints = new int[Layout.PolygonVerticesCount];
+		FillPolygonVertices( Layout, NULL, pControlPoints );
+		break;
+
+	case SourceLayerElement::MAPPING_BY_POLYGON:
+		{	// Use the first vertex of each polygon
+			int*	pPolygonVertices = new int[Layout.PolygonVerticesCount];
+			int*	pPolygonSizes = new int[Layout.PolygonsCount];
+			FillPolygonVertices( Layout, pPolygonSizes, pPolygonVertices );
+
+			pControlPoints = new int[Layout.PolygonsCount];
+			int	PolygonVertexOffset = 0;
+			for ( int PolygonIndex=0; PolygonIndex < Layout.PolygonsCount; PolygonIndex++ )
+			{
+				pControlPoints[PolygonIndex] = pPolygonVertices[PolygonVertexOffset];
+				PolygonVertexOffset += pPolygonSizes[PolygonIndex];
+			}
+
+			delete[] pPolygonSizes;
+			delete[] pPolygonVertices;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	for ( int ValueIndex=0; ValueIndex < Element.ValuesCount; ValueIndex++ )
+	{
+		int	ControlPointIndex = ValueIndex;
+		if ( Element.Mapping == SourceLayerElement::MAPPING_ALL_SAME )
+			ControlPointIndex = 0;
+		else if ( pControlPoints != NULL )
+			ControlPointIndex = pControlPoints[ValueIndex];
+
+		ComputeValue( Layout, Element, ControlPointIndex, _pValues + Element.ComponentsCount * ValueIndex );
+	}
+
+	// Direct indices for indexed elements
+	for ( int IndexIndex=0; IndexIndex < Element.IndicesCount; IndexIndex++ )
+		_pIndices[IndexIndex] = IndexIndex;
+
+	delete[] pControlPoints;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Animation
+//
+// Animated nodes get a translation along X & Y and a full turn around Z
+//
+float	SyntheticSceneSource::GetAnimationDuration() const
+{
+	return m_Desc.AnimatedNodesCount > 0 && m_Desc.AnimationKeysCount > 0 ? m_Desc.AnimationDuration : 0.0f;
+}
+
+int		SyntheticSceneSource::GetCurvesCount( int _NodeIndex ) const
+{
+	return IsAnimated( _NodeIndex ) ? CURVES_PER_NODE : 0;
+}
+
+// Animated nodes move in their XY plane & make a full turn around an axis picked from their hash
+void	SyntheticSceneSource::GetCurve( int _NodeIndex, int _CurveIndex, SourceCurve& _Curve ) const
+{
+	static const SourceCurve::CHANNEL	ROTATION_CHANNELS[3] = { SourceCurve::CHANNEL_ROTATION_X, SourceCurve::CHANNEL_ROTATION_Y, SourceCurve::CHANNEL_ROTATION_Z };
+
+	switch ( _CurveIndex )
+	{
+	case 0:	_Curve.Channel = SourceCurve::CHANNEL_TRANSLATION_X; break;
+	case 1:	_Curve.Channel = SourceCurve::CHANNEL_TRANSLATION_Y; break;
+	default:_Curve.Channel = ROTATION_CHANNELS[(HashInteger( m_Desc.Seed + _NodeIndex ) >> 16) % 3]; break;
+	}
+	_Curve.KeysCount = m_Desc.AnimationKeysCount;
+}
+
+void	SyntheticSceneSource::GetCurveKeys( int _NodeIndex, int _CurveIndex, float* _pTimes, float* _pValues ) const
+{
+	SourceNode	Node;
+	GetNode( _NodeIndex, Node );
+
+	float	Phase = (HashInteger( m_Desc.Seed + _NodeIndex ) & 0xFFFF) * (TWO_PI / 65536.0f);
+	int		KeysCount = m_Desc.AnimationKeysCount;
+	for ( int KeyIndex=0; KeyIndex < KeysCount; KeyIndex++ )
+	{
+		float	t = KeysCount > 1 ? (float) KeyIndex / (KeysCount-1) : 0.0f;
+		_pTimes[KeyIndex] = t * m_Desc.AnimationDuration;
+
+		switch ( _CurveIndex )
+		{
+		case 0:	_pValues[KeyIndex] = Node.Translation[0] + sinf( TWO_PI * t + Phase ); break;
+		case 1:	_pValues[KeyIndex] = Node.Translation[1] + cosf( TWO_PI * t + Phase ); break;
+		case 2:	_pValues[KeyIndex] = 360.0f * t; break;
+		}
+	}
+}
@@ -0,0 +1,128 @@
+// Contains the deterministic synthetic scene source the benchmark feeds to the scene source converter
+//
+#pragma once
+
+#include "SceneSource.h"
+
+namespace FBXImporter
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Describes the scene to generate
+	//
+	struct	SyntheticSceneDesc
+	{
+		int		NodesCount;					// Total amount of nodes, including the root (at least MeshesCount + 1)
+		int		MeshesCount;
+		int		TrianglesCount;				// Total amount of triangles, split evenly among the meshes
+		bool	bQuads;						// Generate quads (triangulated by the converter) rather than triangles
+
+		bool	bNormals;
+		bool	bTangents;					// Tangents & binormals
+		int		UVChannelsCount;
+		bool	bColors;
+		SourceLayerElement::MAPPING		NormalsMapping;		// Also used by tangents & binormals
+		SourceLayerElement::MAPPING		UVsMapping;			// Also used by colors
+		SourceLayerElement::REFERENCE	Reference;
+
+		int		MaterialsCount;				// Scene materials
+		int		MaterialsPerMeshCount;		// Material slots of each mesh, assigned per polygon
+
+		int		AnimatedNodesCount;
+		int		AnimationKeysCount;			// Keys per curve (3 curves per animated node: X & Y translations & a rotation around an axis depending on the node)
+		float	AnimationDuration;			// In seconds
+
+		unsigned int	Seed;
+
+		SyntheticSceneDesc() :
+			NodesCount( 2 ), MeshesCount( 1 ), TrianglesCount( 1000 ), bQuads( true ),
+			bNormals( true ), bTangents( false ), UVChannelsCount( 1 ), bColors( false ),
+			NormalsMapping( SourceLayerElement::MAPPING_BY_CONTROL_POINT ),
+			UVsMapping( SourceLayerElement::MAPPING_BY_POLYGON_VERTEX ),
+			Reference( SourceLayerElement::REFERENCE_INDEX_TO_DIRECT ),
+			MaterialsCount( 1 ), MaterialsPerMeshCount( 1 ),
+			AnimatedNodesCount( 0 ), AnimationKeysCount( 0 ), AnimationDuration( 1.0f ),
+			Seed( 1 )
+		{}
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Generates a scene of displaced grid meshes on demand
+	// Nothing but names is stored: every call recomputes its data from the description, so the same description always
+	//	gives the same scene and sources of millions of triangles cost no memory.
+	//
+	class	SyntheticSceneSource : public SceneSource
+	{
+	protected:	// NESTED TYPES
+
+		// The layout of the grid of a mesh
+		struct	MeshLayout
+		{
+			int		TrianglesCount;
+			int		CellsX;					// Grid cells (a cell holds a quad or 2 triangles)
+			int		CellsY;
+			int		PolygonsCount;
+			int		PolygonVerticesCount;
+			float	Phase;					// Seeds the displacement
+		};
+
+		static const int	MAX_LAYER_ELEMENTS = 16;
+		static const int	NAME_LENGTH = 32;
+		static const int	NODES_PER_GROUP = 8;
+		static const int	CURVES_PER_NODE = 3;
+
+	protected:	// FIELDS
+
+		SyntheticSceneDesc	m_Desc;
+		char*				m_pNodeNames;
+		char*				m_pMaterialNames;
+
+		int					m_LayerElementsCount;
+		SourceLayerElement	m_pLayerElements[MAX_LAYER_ELEMENTS];	// Every mesh has the same layer elements
+
+	public:		// METHODS
+
+		SyntheticSceneSource( const SyntheticSceneDesc& _Desc );
+		virtual ~SyntheticSceneSource();
+
+		const SyntheticSceneDesc&	GetDesc() const		{ return m_Desc; }
+
+		// SceneSource implementation
+		virtual int		GetNodesCount() const;
+		virtual void	GetNode( int _NodeIndex, SourceNode& _Node ) const;
+		virtual int		GetNodeMaterial( int _NodeIndex, int _SlotIndex ) const;
+
+		virtual int		GetMaterialsCount() const;
+		virtual void	GetMaterial( int _MaterialIndex, SourceMaterial& _Material ) const;
+
+		virtual void	GetMesh( int _NodeIndex, SourceMesh& _Mesh ) const;
+		virtual void	GetControlPoints( int _NodeIndex, float* _pPositions ) const;
+		virtual void	GetPolygons( int _NodeIndex, int* _pPolygonSizes, int* _pPolygonVertices ) const;
+		virtual void	GetLayerElement( int _NodeIndex, int _ElementIndex, SourceLayerElement& _Element ) const;
+		virtual void	GetLayerElementData( int _NodeIndex, int _ElementIndex, float* _pValues, int* _pIndices ) const;
+
+		virtual float	GetAnimationDuration() const;
+		virtual int		GetCurvesCount( int _NodeIndex ) const;
+		virtual void	GetCurve( int _NodeIndex, int _CurveIndex, SourceCurve& _Curve ) const;
+		virtual void	GetCurveKeys( int _NodeIndex, int _CurveIndex, float* _pTimes, float* _pValues ) const;
+
+	protected:
+
+		bool	IsMesh( int _NodeIndex ) const		{ return _NodeIndex >= 1 && _NodeIndex <= m_Desc.MeshesCount; }
+		bool	IsAnimated( int _NodeIndex ) const	{ return _NodeIndex >= 1 && _NodeIndex <= m_Desc.AnimatedNodesCount && m_Desc.AnimationKeysCount > 0; }
+
+		void	GetMeshLayout( int _NodeIndex, MeshLayout& _Layout ) const;
+		int		GetPolygonMaterialSlot( int _PolygonIndex ) const;
+
+		// Writes the control point index of each polygon vertex (and the size of each polygon if _pPolygonSizes is not NULL)
+		void	FillPolygonVertices( const MeshLayout& _Layout, int* _pPolygonSizes, int* _pPolygonVertices ) const;
+
+		// Computes the value of an element at a control point
+		void	ComputeValue( const MeshLayout& _Layout, const SourceLayerElement& _Element, int _ControlPointIndex, float* _pValue ) const;
+
+		void	AddLayerElement( SourceLayerElement::TYPE _Type, int _Channel, int _ComponentsCount, SourceLayerElement::MAPPING _Mapping, SourceLayerElement::REFERENCE _Reference );
+
+	private:
+		SyntheticSceneSource( const SyntheticSceneSource& );
+		SyntheticSceneSource&	operator=( const SyntheticSceneSource& );
+	};
+}
@@ -0,0 +1,428 @@
+// Benchmarks the SDK-independent kernels on synthetic scenes & mesh files
+// Builds without the FBX SDK or the CLR (use the Makefile on Linux) so it can run on headless build machines.
+// The scene source converter & the synthetic source only live here: the timings don't cover the import of FBX files,
+//	which are read from the SDK by Scene & NodeMesh, only the mesh file parser, the axis conversion & the vertex encoder are shared with the importer.
+//
+// Usage: SceneSourceBenchmark [-max <triangles>] [-runs <count>] [-target <zup|yup|dx>]
+//		  SceneSourceBenchmark -file <OBJ or PLY file> [-threads <count>] [-chunk <MB>] [-target <zup|yup|dx>]
+//		  SceneSourceBenchmark -encoder [-max <triangles>] [-runs <count>]
+//
+// Sources are considered Y-Up right-handed (like OBJ & PLY files) and converted into the target axis system (none by default).
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <pthread.h>
+#endif
+
+#include "SyntheticSceneSource.h"
+#include "SceneSourceConverter.h"
+#include "MeshFileSource.h"
+#include "VertexEncoder.h"
+
+using namespace	FBXImporter;
+
+static double	GetTime()
+{
+#ifdef _WIN32
+	LARGE_INTEGER	Frequency, Counter;
+	QueryPerformanceFrequency( &Frequency );
+	QueryPerformanceCounter( &Counter );
+	return double( Counter.QuadPart ) / Frequency.QuadPart;
+#else
+	timespec	Time;
+	clock_gettime( CLOCK_MONOTONIC, &Time );
+	return Time.tv_sec + 1e-9 * Time.tv_nsec;
+#endif
+}
+
+// A configuration of layer elements to benchmark
+struct	Configuration
+{
+	const char*						pName;
+	SourceLayerElement::MAPPING		NormalsMapping;
+	SourceLayerElement::MAPPING		UVsMapping;
+	SourceLayerElement::REFERENCE	Reference;
+	bool							bTangents;
+	int								UVChannelsCount;
+	bool							bColors;
+	int								Attributes;
+};
+
+static const Configuration	ms_pConfigurations[] =
+{
+	{ "Positions only",			SourceLayerElement::MAPPING_BY_CONTROL_POINT,	SourceLayerElement::MAPPING_BY_CONTROL_POINT,	SourceLayerElement::REFERENCE_DIRECT,			false, 0, false, 0 },
+	{ "N+UV by control point",	SourceLayerElement::MAPPING_BY_CONTROL_POINT,	SourceLayerElement::MAPPING_BY_CONTROL_POINT,	SourceLayerElement::REFERENCE_DIRECT,			false, 1, false, SceneSourceConverter::ATTRIBUTE_NORMAL | SceneSourceConverter::ATTRIBUTE_UV0 },
+	{ "N+UV by polygon vertex",	SourceLayerElement::MAPPING_BY_CONTROL_POINT,	SourceLayerElement::MAPPING_BY_POLYGON_VERTEX,	SourceLayerElement::REFERENCE_INDEX_TO_DIRECT,	false, 1, false, SceneSourceConverter::ATTRIBUTE_NORMAL | SceneSourceConverter::ATTRIBUTE_UV0 },
+	{ "Full vertex",			SourceLayerElement::MAPPING_BY_POLYGON_VERTEX,	SourceLayerElement::MAPPING_BY_POLYGON_VERTEX,	SourceLayerElement::REFERENCE_INDEX_TO_DIRECT,	true,  2, true,  0x3F },
+};
+
+static const int	CONFIGURATIONS_COUNT = sizeof(ms_pConfigurations) / sizeof(ms_pConfigurations[0]);
+
+// Reads the whole source through the interface without converting anything, to separate the cost of the source from the cost of the conversion
+static long long	FetchSource( const SceneSource& _Source )
+{
+	long long	BytesCount = 0;
+	for ( int NodeIndex=0; NodeIndex < _Source.GetNodesCount(); NodeIndex++ )
+	{
+		SourceMesh	Mesh;
+		_Source.GetMesh( NodeIndex, Mesh );
+		if ( Mesh.ControlPointsCount == 0 )
+			continue;
+
+		float*	pPositions = new float[3*Mesh.ControlPointsCount];
+		int*	pPolygonSizes = new int[Mesh.PolygonsCount];
+		int*	pPolygonVertices = new int[Mesh.PolygonVerticesCount];
+		_Source.GetControlPoints( NodeIndex, pPositions );
+		_Source.GetPolygons( NodeIndex, pPolygonSizes, pPolygonVertices );
+		BytesCount += 3*Mesh.ControlPointsCount * sizeof(float) + (Mesh.PolygonsCount + Mesh.PolygonVerticesCount) * sizeof(int);
+		delete[] pPolygonVertices;
+		delete[] pPolygonSizes;
+		delete[] pPositions;
+
+		for ( int ElementIndex=0; ElementIndex < Mesh.LayerElementsCount; ElementIndex++ )
+		{
+			SourceLayerElement	Element;
+			_Source.GetLayerElement( NodeIndex, ElementIndex, Element );
+
+			float*	pValues = new float[Element.ComponentsCount * Element.ValuesCount + 1];
+			int*	pIndices = new int[Element.IndicesCount + 1];
+			_Source.GetLayerElementData( NodeIndex, ElementIndex, pValues, pIndices );
+			BytesCount += Element.ComponentsCount * Element.ValuesCount * sizeof(float) + Element.IndicesCount * sizeof(int);
+			delete[] pIndices;
+			delete[] pValues;
+		}
+	}
+
+	return BytesCount;
+}
+
+// A thread parsing a chunk of a mesh file
+struct	ParseJob
+{
+	MeshFileSource*	pSource;
+	int				ChunkIndex;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI	ParseThread( void* _pJob )
+#else
+static void*		ParseThread( void* _pJob )
+#endif
+{
+	ParseJob*	pJob = (ParseJob*) _pJob;
+	pJob->pSource->ParseChunk( pJob->ChunkIndex );
+	return	0;
+}
+
+// Parses a mesh file with batches of _ThreadsCount chunks parsed concurrently (as the importer does) & reports the throughput
+static int	BenchmarkFile( const char* _pFileName, int _ThreadsCount, int _ChunkSize, const AxisConversion& _AxisConversion )
+{
+	MeshFileSource	Source;
+
+	double	StartTime = GetTime();
+	if ( !Source.Open( _pFileName, _ChunkSize ) )
+	{
+		printf( "%s\n", Source.GetError() );
+		return 1;
+	}
+	double	OpenTime = GetTime() - StartTime;
+
+	ParseJob*	pJobs = new ParseJob[_ThreadsCount];
+	double		CommitTime = 0.0;
+	StartTime = GetTime();
+	for ( int FirstChunk=0; FirstChunk < Source.GetChunksCount(); FirstChunk += _ThreadsCount )
+	{
+		int	JobsCount = Source.GetChunksCount() - FirstChunk < _ThreadsCount ? Source.GetChunksCount() - FirstChunk : _ThreadsCount;
+
+#ifdef _WIN32
+		HANDLE		pThreads[64];
+#else
+		pthread_t	pThreads[64];
+#endif
+		for ( int JobIndex=0; JobIndex < JobsCount; JobIndex++ )
+		{
+			pJobs[JobIndex].pSource = &Source;
+			pJobs[JobIndex].ChunkIndex = FirstChunk + JobIndex;
+#ifdef _WIN32
+			pThreads[JobIndex] = CreateThread( NULL, 0, ParseThread, &pJobs[JobIndex], 0, NULL );
+#else
+			pthread_create( &pThreads[JobIndex], NULL, ParseThread, &pJobs[JobIndex] );
+#endif
+		}
+		for ( int JobIndex=0; JobIndex < JobsCount; JobIndex++ )
+		{
+#ifdef _WIN32
+			WaitForSingleObject( pThreads[JobIndex], INFINITE );
+			CloseHandle( pThreads[JobIndex] );
+#else
+			pthread_join( pThreads[JobIndex], NULL );
+#endif
+		}
+
+		double	CommitStartTime = GetTime();
+		for ( int JobIndex=0; JobIndex < JobsCount; JobIndex++ )
+			if ( !Source.CommitChunk( FirstChunk + JobIndex ) )
+			{
+				printf( "%s\n", Source.GetError() );
+				delete[] pJobs;
+				return 1;
+			}
+		CommitTime += GetTime() - CommitStartTime;
+	}
+	double	ParseTime = GetTime() - StartTime;
+	delete[] pJobs;
+
+	StartTime = GetTime();
+	if ( !Source.Finalize() )
+	{
+		printf( "%s\n", Source.GetError() );
+		return 1;
+	}
+	double	FinalizeTime = GetTime() - StartTime;
+
+	SceneSourceConverter	Converter( SceneSourceConverter::ATTRIBUTE_NORMAL | SceneSourceConverter::ATTRIBUTE_UV0 | SceneSourceConverter::ATTRIBUTE_COLOR, 0.0f );
+	Converter.SetAxisConversion( _AxisConversion );
+	StartTime = GetTime();
+	Converter.Convert( Source );
+	double	ConvertTime = GetTime() - StartTime;
+
+	double	MegaBytes = Source.GetFileSize() / (1024.0 * 1024.0);
+	double	TotalTime = OpenTime + ParseTime + FinalizeTime;
+	printf( "%s: %.1f MB, %d chunks, %d threads\n", _pFileName, MegaBytes, Source.GetChunksCount(), _ThreadsCount );
+	printf( "  %d vertices, %d polygons, %d meshes, %d materials\n", Source.GetVerticesCount(), Source.GetPolygonsCount(), Source.GetNodesCount()-1, Source.GetMaterialsCount() );
+	printf( "  Open %.1f ms, parse %.1f ms (commit %.1f ms), finalize %.1f ms\n", 1000.0 * OpenTime, 1000.0 * ParseTime, 1000.0 * CommitTime, 1000.0 * FinalizeTime );
+	printf( "  Parse throughput %.1f MB/s (%.1f MB/s including finalization)\n", MegaBytes / ParseTime, MegaBytes / TotalTime );
+	printf( "  Conversion %.1f ms, %d triangles, %d vertices\n", 1000.0 * ConvertTime, Converter.GetStatistics().TrianglesCount, Converter.GetStatistics().VerticesCount );
+
+	return 0;
+}
+
+// Encodes the corners of a tessellated sphere with the default vertex layout (P FLOAT3, N OCTAHEDRAL16, T UNORM10_10_10_2, UV HALF2, C UNORM8_4)
+static int	BenchmarkEncoder( int _MaxTrianglesCount, int _RunsCount )
+{
+	VertexLayout	Layout;
+	Layout.AddAttribute( VertexLayout::SEMANTIC_POSITION, 0, VertexLayout::FORMAT_FLOAT3, 0 );
+	Layout.AddAttribute( VertexLayout::SEMANTIC_NORMAL, 0, VertexLayout::FORMAT_OCTAHEDRAL16, 0 );
+	Layout.AddAttribute( VertexLayout::SEMANTIC_TANGENT, 0, VertexLayout::FORMAT_UNORM10_10_10_2, 0 );
+	Layout.AddAttribute( VertexLayout::SEMANTIC_UV, 0, VertexLayout::FORMAT_HALF2, 0 );
+	Layout.AddAttribute( VertexLayout::SEMANTIC_COLOR, 0, VertexLayout::FORMAT_UNORM8_4, 0 );
+
+	const int	FloatVertexSize = 4 * (3 + 3 + 4 + 2 + 4);
+
+	printf( "%10s %10s %12s %12s %10s %10s %10s %10s\n", "Triangles", "Vertices", "Encode (ms)", "MCorners/s", "Ratio", "N error", "T error", "UV error" );
+	for ( int TrianglesCount=1000; TrianglesCount <= _MaxTrianglesCount; TrianglesCount *= 10 )
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// 1] Build the corners of a sphere of Rings x Sectors quads
+		int		Sectors = 2;
+		while ( 2 * Sectors * (Sectors / 2) < TrianglesCount )
+			Sectors += 2;
+		int		Rings = Sectors / 2;
+		int		CornersCount = 6 * Rings * Sectors;
+
+		float*	pPositions = new float[3*CornersCount];
+		float*	pNormals = new float[3*CornersCount];
+		float*	pTangents = new float[4*CornersCount];
+		float*	pUVs = new float[2*CornersCount];
+		float*	pColors = new float[4*CornersCount];
+		static const int	pQuadCorners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+		for ( int CornerIndex=0; CornerIndex < CornersCount; CornerIndex++ )
+		{
+			int		QuadIndex = CornerIndex / 6;
+			int		Sector = QuadIndex % Sectors + pQuadCorners[CornerIndex % 6][0];
+			int		Ring = QuadIndex / Sectors + pQuadCorners[CornerIndex % 6][1];
+			float	U = (float) Sector / Sectors;
+			float	V = (float) Ring / Rings;
+			float	Phi = 6.2831853f * U;
+			float	Theta = 3.1415927f * V;
+
+			float*	pN = pNormals + 3*CornerIndex;
+			pN[0] = sinf( Theta ) * cosf( Phi );
+			pN[1] = cosf( Theta );
+			pN[2] = sinf( Theta ) * sinf( Phi );
+			for ( int ComponentIndex=0; ComponentIndex < 3; ComponentIndex++ )
+				pPositions[3*CornerIndex+ComponentIndex] = 100.0f * pN[ComponentIndex];
+
+			float*	pT = pTangents + 4*CornerIndex;
+			pT[0] = -sinf( Phi );
+			pT[1] = 0.0f;
+			pT[2] = cosf( Phi );
+			pT[3] = 1.0f;
+
+			pUVs[2*CornerIndex+0] = U;
+			pUVs[2*CornerIndex+1] = V;
+
+			float*	pC = pColors + 4*CornerIndex;
+			pC[0] = U; pC[1] = V; pC[2] = 0.5f; pC[3] = 1.0f;
+		}
+
+		const float*	ppSources[] = { pPositions, pNormals, pTangents, pUVs, pColors };
+
+		//////////////////////////////////////////////////////////////////////////
+		// 2] Keep the best of several runs
+		VertexEncoder	Encoder( Layout );
+		double			BestTime = 1e30;
+		for ( int RunIndex=0; RunIndex < _RunsCount; RunIndex++ )
+		{
+			double	StartTime = GetTime();
+			Encoder.Encode( ppSources, CornersCount );
+			double	Time = GetTime() - StartTime;
+			if ( Time < BestTime )
+				BestTime = Time;
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+		// 3] Report the size of the welded vertices & indices against floats with 32-bit indices
+		double	EncodedSize = (double) Encoder.GetVerticesCount() * Layout.GetVertexSize() + (double) CornersCount * Encoder.GetIndexSize();
+		double	FloatSize = (double) Encoder.GetVerticesCount() * FloatVertexSize + 4.0 * CornersCount;
+		printf( "%10d %10d %12.2f %12.2f %9.2fx %10.2g %10.2g %10.2g\n",
+			CornersCount / 3,
+			Encoder.GetVerticesCount(),
+			1000.0 * BestTime,
+			CornersCount / (1e6 * BestTime),
+			FloatSize / EncodedSize,
+			Encoder.GetError( 1 ).MaxError,
+			Encoder.GetError( 2 ).MaxError,
+			Encoder.GetError( 3 ).MaxError );
+
+		delete[] pPositions;
+		delete[] pNormals;
+		delete[] pTangents;
+		delete[] pUVs;
+		delete[] pColors;
+
+		if ( TrianglesCount > _MaxTrianglesCount / 10 )
+			break;	// Avoid overflowing
+	}
+
+	return 0;
+}
+
+int	main( int _ArgumentsCount, char** _ppArguments )
+{
+	int			MaxTrianglesCount = 10000000;
+	int			RunsCount = 3;
+	const char*	pFileName = NULL;
+	bool		bEncoder = false;
+	int			ThreadsCount = 4;
+	int			ChunkSizeMB = MeshFileSource::DEFAULT_CHUNK_SIZE >> 20;
+	const AxisConversion::AxisSystem*	pTarget = &AxisConversion::Y_UP_RIGHT_HANDED;
+	for ( int ArgumentIndex=1; ArgumentIndex < _ArgumentsCount; ArgumentIndex++ )
+	{
+		if ( !strcmp( _ppArguments[ArgumentIndex], "-max" ) && ArgumentIndex+1 < _ArgumentsCount )
+			MaxTrianglesCount = atoi( _ppArguments[++ArgumentIndex] );
+		else if ( !strcmp( _ppArguments[ArgumentIndex], "-runs" ) && ArgumentIndex+1 < _ArgumentsCount )
+			RunsCount = atoi( _ppArguments[++ArgumentIndex] );
+		else if ( !strcmp( _ppArguments[ArgumentIndex], "-file" ) && ArgumentIndex+1 < _ArgumentsCount )
+			pFileName = _ppArguments[++ArgumentIndex];
+		else if ( !strcmp( _ppArguments[ArgumentIndex], "-encoder" ) )
+			bEncoder = true;
+		else if ( !strcmp( _ppArguments[ArgumentIndex], "-threads" ) && ArgumentIndex+1 < _ArgumentsCount )
+			ThreadsCount = atoi( _ppArguments[++ArgumentIndex] );
+		else if ( !strcmp( _ppArguments[ArgumentIndex], "-chunk" ) && ArgumentIndex+1 < _ArgumentsCount )
+			ChunkSizeMB = atoi( _ppArguments[++ArgumentIndex] );
+		else if ( !strcmp( _ppArguments[ArgumentIndex], "-target" ) && ArgumentIndex+1 < _ArgumentsCount && !strcmp( _ppArguments[ArgumentIndex+1], "zup" ) )
+			pTarget = &AxisConversion::Z_UP_RIGHT_HANDED, ArgumentIndex++;
+		else if ( !strcmp( _ppArguments[ArgumentIndex], "-target" ) && ArgumentIndex+1 < _ArgumentsCount && !strcmp( _ppArguments[ArgumentIndex+1], "yup" ) )
+			pTarget = &AxisConversion::Y_UP_RIGHT_HANDED, ArgumentIndex++;
+		else if ( !strcmp( _ppArguments[ArgumentIndex], "-target" ) && ArgumentIndex+1 < _ArgumentsCount && !strcmp( _ppArguments[ArgumentIndex+1], "dx" ) )
+			pTarget = &AxisConversion::Y_UP_LEFT_HANDED, ArgumentIndex++;
+		else
+		{
+			printf( "Usage: %s [-max <triangles>] [-runs <count>] [-target <zup|yup|dx>]\n", _ppArguments[0] );
+			printf( "       %s -file <OBJ or PLY file> [-threads <count>] [-chunk <MB>] [-target <zup|yup|dx>]\n", _ppArguments[0] );
+			printf( "       %s -encoder [-max <triangles>] [-runs <count>]\n", _ppArguments[0] );
+			return 1;
+		}
+	}
+	AxisConversion	Conversion( AxisConversion::Y_UP_RIGHT_HANDED, *pTarget );
+	if ( RunsCount < 1 )
+		RunsCount = 1;
+	if ( ThreadsCount < 1 || ThreadsCount > 64 )
+		ThreadsCount = ThreadsCount < 1 ? 1 : 64;
+	if ( ChunkSizeMB < 1 || ChunkSizeMB > 1024 )
+		ChunkSizeMB = ChunkSizeMB < 1 ? 1 : 1024;
+
+	if ( bEncoder )
+		return BenchmarkEncoder( MaxTrianglesCount, RunsCount );
+	if ( pFileName != NULL )
+		return BenchmarkFile( pFileName, ThreadsCount, ChunkSizeMB << 20, Conversion );
+
+	printf( "%-24s %10s %10s %12s %12s %12s %10s\n", "Configuration", "Triangles", "Vertices", "Fetch (ms)", "Convert (ms)", "MTris/s", "MB/s" );
+
+	for ( int ConfigurationIndex=0; ConfigurationIndex < CONFIGURATIONS_COUNT; ConfigurationIndex++ )
+	{
+		const Configuration&	Config = ms_pConfigurations[ConfigurationIndex];
+		for ( int TrianglesCount=1000; TrianglesCount <= MaxTrianglesCount; TrianglesCount *= 10 )
+		{
+			//////////////////////////////////////////////////////////////////////////
+			// 1] Describe a scene of 16 meshes with a few animated nodes
+			SyntheticSceneDesc	Desc;
+			Desc.MeshesCount = 16;
+			Desc.NodesCount = 32;
+			Desc.TrianglesCount = TrianglesCount;
+			Desc.bNormals = Config.Attributes != 0;
+			Desc.bTangents = Config.bTangents;
+			Desc.UVChannelsCount = Config.UVChannelsCount;
+			Desc.bColors = Config.bColors;
+			Desc.NormalsMapping = Config.NormalsMapping;
+			Desc.UVsMapping = Config.UVsMapping;
+			Desc.Reference = Config.Reference;
+			Desc.MaterialsCount = 8;
+			Desc.MaterialsPerMeshCount = 4;
+			Desc.AnimatedNodesCount = 8;
+			Desc.AnimationKeysCount = 100;
+			Desc.AnimationDuration = 4.0f;
+
+			SyntheticSceneSource	Source( Desc );
+			SceneSourceConverter	Converter( Config.Attributes, 30.0f );
+			Converter.SetAxisConversion( Conversion );
+
+			//////////////////////////////////////////////////////////////////////////
+			// 2] Keep the best of several runs
+			double	BestFetchTime = 1e30;
+			double	BestConvertTime = 1e30;
+			for ( int RunIndex=0; RunIndex < RunsCount; RunIndex++ )
+			{
+				double	StartTime = GetTime();
+				FetchSource( Source );
+				double	FetchTime = GetTime() - StartTime;
+				if ( FetchTime < BestFetchTime )
+					BestFetchTime = FetchTime;
+
+				StartTime = GetTime();
+				Converter.Convert( Source );
+				double	ConvertTime = GetTime() - StartTime;
+				if ( ConvertTime < BestConvertTime )
+					BestConvertTime = ConvertTime;
+			}
+
+			//////////////////////////////////////////////////////////////////////////
+			// 3] Report
+			const SceneSourceConverter::Statistics&	Stats = Converter.GetStatistics();
+			double	OutputMegaBytes = (Stats.VertexBytes + Stats.IndexBytes + Stats.AnimationBytes) / (1024.0 * 1024.0);
+			printf( "%-24s %10d %10d %12.2f %12.2f %12.2f %10.1f\n",
+				Config.pName,
+				Stats.TrianglesCount,
+				Stats.VerticesCount,
+				1000.0 * BestFetchTime,
+				1000.0 * BestConvertTime,
+				Stats.TrianglesCount / (1e6 * BestConvertTime),
+				OutputMegaBytes / BestConvertTime );
+
+			Converter.Clear();
+
+			if ( TrianglesCount > MaxTrianglesCount / 10 )
+				break;	// Avoid overflowing
+		}
+	}
+
+	return 0;
+}